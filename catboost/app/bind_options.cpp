@@ -85,13 +85,13 @@ inline static TVector<TVector<int>> ParseIndexSetsLine(const TStringBuf indicesL
 inline static void BindPoolLoadParams(NLastGetopt::TOpts* parser, NCatboostOptions::TPoolLoadParams* loadParamsPtr) {
     BindDsvPoolFormatParams(parser, &(loadParamsPtr->DsvPoolFormatParams));
 
-    parser->AddLongOption('f', "learn-set", "learn set path")
+    parser->AddLongOption('f', "learn-set", "learn set path. quantized:// pools can contain only numeric features")
         .RequiredArgument("[SCHEME://]PATH")
         .Handler1T<TStringBuf>([loadParamsPtr](const TStringBuf& str) {
             loadParamsPtr->LearnSetPath = TPathWithScheme(str, "dsv");
         });
 
-    parser->AddLongOption('t', "test-set", "path to one or more test sets")
+    parser->AddLongOption('t', "test-set", "path to one or more test sets. quantized:// pools can contain only numeric features")
         .RequiredArgument("[SCHEME://]PATH[,[SCHEME://]PATH...]")
         .Handler1T<TStringBuf>([loadParamsPtr](const TStringBuf& str) {
             for (const auto& path : StringSplitter(str).Split(',').SkipEmpty()) {
@@ -278,6 +278,12 @@ static void BindOutputParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
             (*plainJsonPtr)["profile_log"] = name;
         });
 
+    parser.AddLongOption("trace-file", "file to write a timeline of training stages in Chrome trace format (about:tracing, Perfetto)")
+        .RequiredArgument("file")
+        .Handler1T<TString>([plainJsonPtr](const TString& name) {
+            (*plainJsonPtr)["trace_file"] = name;
+        });
+
     parser.AddLongOption("trace-log", "path for trace log")
         .RequiredArgument("file")
         .Handler1T<TString>([](const TString& name) {
@@ -324,7 +330,7 @@ static void BindOutputParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
         (*plainJsonPtr)["metric_period"] = period;
     });
 
-    parser.AddLongOption("snapshot-file", "use progress file for restoring progress after crashes")
+    parser.AddLongOption("snapshot-file", "use progress file for restoring progress after crashes or continuing training on a learn set with appended objects (Plain boosting type only)")
         .RequiredArgument("PATH")
         .Handler1T<TString>([plainJsonPtr](const TString& path) {
             (*plainJsonPtr)["save_snapshot"] = true;
@@ -581,6 +587,16 @@ static void BindTreeParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* pla
                 (*plainJsonPtr)["dev_score_calc_obj_block_size"] = size;
             });
 
+    parser.AddLongOption("dev-compact-score-cache",
+                         "CPU only. Store score statistics cached between tree levels in single precision"
+                         " to halve memory usage and bandwidth."
+                         "Changing this parameter can affect results"
+                         " due to numerical accuracy differences")
+            .NoArgument()
+            .Handler0([plainJsonPtr]() {
+                (*plainJsonPtr)["dev_compact_score_cache"] = true;
+            });
+
     parser.AddLongOption("random-strength")
         .RequiredArgument("float")
         .Handler1T<float>([plainJsonPtr](float randomStrength) {
@@ -817,6 +833,24 @@ static void BindDataProcessingParams(NLastGetopt::TOpts* parserPtr, NJson::TJson
             (*plainJsonPtr)["allow_const_label"] = true;
         });
 
+    parser.AddLongOption("dev-exclusive-features-bundling",
+                         "CPU only. Store sparse float features that never have non-default values"
+                         " for the same object together and select splits for them at once."
+                         " Speeds up training on wide sparse datasets")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["dev_exclusive_features_bundling"] = true;
+        });
+
+    parser.AddLongOption("dev-border-selection-sketch-size",
+                         "Build borders for Median and GreedyLogSum border types from mergeable quantile sketches"
+                         " of this size over all objects instead of sorting all feature values."
+                         " Bounds memory used for border selection on large datasets. 0 - disabled")
+        .RequiredArgument("int")
+        .Handler1T<ui32>([plainJsonPtr](const ui32 sketchSize) {
+            (*plainJsonPtr)["dev_border_selection_sketch_size"] = sketchSize;
+        });
+
     parser.AddLongOption("classes-count", "number of classes")
         .RequiredArgument("int")
         .Handler1T<int>([plainJsonPtr](const int classesCount) {
@@ -899,6 +933,39 @@ static void BindSystemParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
                 (*plainJsonPtr)["used_ram_limit"] = param;
             });
 
+    parser.AddLongOption("online-ctr-cache-size", "CPU only. Memory budget for online ctrs cached between iterations,"
+                         " least valuable ctrs are evicted when it is exceeded.\nAllowed suffixes: GB, MB, KB in different cases")
+            .RequiredArgument("SIZE")
+            .Handler1T<TString>([plainJsonPtr](const TString& param) {
+                (*plainJsonPtr)["online_ctr_cache_size"] = param;
+            });
+
+    parser.AddLongOption("online-ctr-cache-policy", "CPU only. Online ctr cache eviction policy: LRU or LFU")
+            .RequiredArgument("POLICY")
+            .Handler1T<TString>([plainJsonPtr](const TString& param) {
+                (*plainJsonPtr)["online_ctr_cache_policy"] = param;
+            });
+
+    parser.AddLongOption("online-ctr-cache-spill-dir", "CPU only. Directory to spill evicted online ctrs to"
+                         " instead of dropping them (requires --online-ctr-cache-size)")
+            .RequiredArgument("PATH")
+            .Handler1T<TString>([plainJsonPtr](const TString& param) {
+                (*plainJsonPtr)["online_ctr_cache_spill_dir"] = param;
+            });
+
+    parser.AddLongOption("work-stealing", "CPU only. Split parallel loops into per-thread parts, idle threads steal"
+                         " work from other threads' parts")
+            .NoArgument()
+            .Handler0([plainJsonPtr]() {
+                (*plainJsonPtr)["work_stealing"] = true;
+            });
+
+    parser.AddLongOption("thread-pinning", "CPU only. Pin worker threads to cpus, socket by socket (Linux only)")
+            .NoArgument()
+            .Handler0([plainJsonPtr]() {
+                (*plainJsonPtr)["thread_pinning"] = true;
+            });
+
     parser
             .AddLongOption("gpu-ram-part")
             .RequiredArgument("double")
@@ -41,7 +41,7 @@ static void ApplyOnRawFeatures(
     const int approxesDimension = model.ObliviousTrees.ApproxDimension;
     int consecutiveSubsetBegin = GetConsecutiveSubsetBegin(*rawObjectsData);
 
-    const auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx, TVector<TMaybe<TPackedBinaryIndex>>*) -> const float* {
+    const auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx, TMaybe<TPackedBinaryIndex>*) -> const float* {
         return GetRawFeatureDataBeginPtr(
             *rawObjectsData,
             consecutiveSubsetBegin,
@@ -88,48 +88,44 @@ static void ApplyOnQuantizedFeatures(
     TLocalExecutor* executor)
 {
     const int approxesDimension = model.ObliviousTrees.ApproxDimension;
-    int consecutiveSubsetBegin = GetConsecutiveSubsetBegin(quantizedObjectsData);
-
-    auto floatBinsRemap = GetFloatFeaturesBordersRemap(model, *quantizedObjectsData.GetQuantizedFeaturesInfo().Get());
-
-    auto getFeatureDataBeginPtr = [&](ui32 featureIdx, TVector<TMaybe<TPackedBinaryIndex>>* packedIdx) -> const ui8* {
-        (*packedIdx)[featureIdx] = quantizedObjectsData.GetFloatFeatureToPackedBinaryIndex(TFeatureIdx<EFeatureType::Float>(featureIdx));
-        if (!(*packedIdx)[featureIdx].Defined()) {
-            return GetQuantizedForCpuFloatFeatureDataBeginPtr(
-                quantizedObjectsData,
-                consecutiveSubsetBegin,
-                featureIdx);
-        } else {
-            return (**quantizedObjectsData.GetBinaryFeaturesPack((*packedIdx)[featureIdx]->PackIdx).GetSrc()).Data();
-        }
-    };
+    const auto& quantizedFeaturesInfo = *quantizedObjectsData.GetQuantizedFeaturesInfo();
+    const auto floatBinsRemap = GetFloatFeaturesBordersRemap(model, quantizedFeaturesInfo);
+    const auto catPerfectHashRemap = GetCatFeaturesPerfectHashToHashRemap(model, quantizedFeaturesInfo);
 
     const auto applyOnBlock = [&](int blockId) {
         const int blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
         const int blockLastIdx = Min(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
         const int blockSize = blockLastIdx - blockFirstIdx;
 
-        TVector<TConstArrayRef<ui8>> repackedFeatures;
+        TVector<TConstArrayRef<ui8>> repackedBinFeatures;
+        TVector<TConstArrayRef<ui32>> repackedCatFeatures;
         TVector<TMaybe<TPackedBinaryIndex>> packedIndexes;
-        GetRepackedFeatures(
+        TVector<TVector<ui8>> unpackedFloatFeatures;
+        GetRepackedQuantizedFeatures(
+            model,
+            quantizedObjectsData,
+            columnReorderMap,
             blockFirstIdx,
             blockLastIdx,
-            model.ObliviousTrees.GetFlatFeatureVectorExpectedSize(),
-            columnReorderMap,
-            getFeatureDataBeginPtr,
-            *quantizedObjectsData.GetFeaturesLayout(),
-            &repackedFeatures,
-            &packedIndexes);
+            &repackedBinFeatures,
+            &repackedCatFeatures,
+            &packedIndexes,
+            &unpackedFloatFeatures);
 
         constexpr bool isQuantized = true;
         CalcGeneric<isQuantized>(
             model,
-            [&floatBinsRemap, &repackedFeatures, &packedIndexes](const TFloatFeature& floatFeature, size_t index) -> ui8 {
-                return QuantizedFeaturesFloatAccessor(floatBinsRemap, repackedFeatures, packedIndexes, floatFeature, index);
+            [&floatBinsRemap, &repackedBinFeatures, &packedIndexes](const TFloatFeature& floatFeature, size_t index) -> ui8 {
+                return QuantizedFeaturesFloatAccessor(floatBinsRemap, repackedBinFeatures, packedIndexes, floatFeature, index);
             },
-            [](const TCatFeature&, size_t) -> ui32 {
-                Y_ASSERT("Quantized datasets with categorical features are not currently supported");
-                return 0;
+            [&] (const TCatFeature& catFeature, size_t index) -> ui32 {
+                return QuantizedFeaturesCatAccessor(
+                    catPerfectHashRemap,
+                    repackedBinFeatures,
+                    repackedCatFeatures,
+                    packedIndexes,
+                    catFeature,
+                    index);
             },
             blockSize,
             begin,
@@ -246,6 +242,79 @@ TVector<double> ApplyModel(const TFullModel& model,
     return ApplyModelMulti(model, objectsData, verbose, predictionType, begin, end, threadCount)[0];
 }
 
+template <class TCatFeaturesRow>
+static TVector<TVector<double>> ApplyModelMultiOnFeatureRowsImpl(
+    const TFullModel& model,
+    TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+    TConstArrayRef<TCatFeaturesRow> catFeatures,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount)
+{
+    const size_t docCount = Max(floatFeatures.size(), catFeatures.size());
+    const size_t approxesDimension = model.ObliviousTrees.ApproxDimension;
+    end = end == 0 ? model.GetTreeCount() : Min<int>(end, model.GetTreeCount());
+
+    THolder<TLocalExecutor> executor;
+    if (threadCount > 1 && docCount >= 2 * FORMULA_EVALUATION_BLOCK_SIZE) {
+        executor = MakeHolder<TLocalExecutor>();
+        executor->RunAdditionalThreads(threadCount - 1);
+    }
+
+    TVector<double> approxesFlat;
+    approxesFlat.yresize(docCount * approxesDimension);
+    if (catFeatures.empty() && model.ObliviousTrees.CatFeatures.empty()) {
+        // without categorical features float feature rows are flat feature rows
+        model.CalcFlat(floatFeatures, begin, end, approxesFlat, executor.Get());
+    } else {
+        model.Calc(floatFeatures, catFeatures, begin, end, approxesFlat, executor.Get());
+    }
+
+    TVector<TVector<double>> approxes(approxesDimension);
+    if (approxesDimension == 1) { //shortcut
+        approxes[0].swap(approxesFlat);
+    } else {
+        for (size_t dim = 0; dim < approxesDimension; ++dim) {
+            approxes[dim].yresize(docCount);
+            for (size_t doc = 0; doc < docCount; ++doc) {
+                approxes[dim][doc] = approxesFlat[approxesDimension * doc + dim];
+            };
+        }
+    }
+
+    if (predictionType == EPredictionType::InternalRawFormulaVal) {
+        //shortcut
+        return approxes;
+    } else {
+        return PrepareEvalForInternalApprox(predictionType, model, approxes, executor.Get());
+    }
+}
+
+TVector<TVector<double>> ApplyModelMultiOnFeatureRows(
+    const TFullModel& model,
+    TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+    TConstArrayRef<TConstArrayRef<int>> catFeatures,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount)
+{
+    return ApplyModelMultiOnFeatureRowsImpl(model, floatFeatures, catFeatures, predictionType, begin, end, threadCount);
+}
+
+TVector<TVector<double>> ApplyModelMultiOnFeatureRows(
+    const TFullModel& model,
+    TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+    TConstArrayRef<TVector<TStringBuf>> catFeatures,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount)
+{
+    return ApplyModelMultiOnFeatureRowsImpl(model, floatFeatures, catFeatures, predictionType, begin, end, threadCount);
+}
+
 
 void TModelCalcerOnPool::ApplyModelMulti(
     const EPredictionType predictionType,
@@ -308,7 +377,7 @@ void TModelCalcerOnPool::InitForRawFeatures(
     const ui32 consecutiveSubsetBegin = GetConsecutiveSubsetBegin(rawObjectsData);
     const auto& featuresLayout = *rawObjectsData.GetFeaturesLayout();
 
-    auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx, TVector<TMaybe<TPackedBinaryIndex>>*) -> const float* {
+    auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx, TMaybe<TPackedBinaryIndex>*) -> const float* {
         return GetRawFeatureDataBeginPtr(
             rawObjectsData,
             consecutiveSubsetBegin,
@@ -348,36 +417,45 @@ void TModelCalcerOnPool::InitForQuantizedFeatures(
     const NPar::TLocalExecutor::TExecRangeParams& blockParams,
     NPar::TLocalExecutor* executor)
 {
-    const ui32 consecutiveSubsetBegin = GetConsecutiveSubsetBegin(quantizedObjectsData);
-    const auto& featuresLayout = *quantizedObjectsData.GetFeaturesLayout();
+    const auto& quantizedFeaturesInfo = *quantizedObjectsData.GetQuantizedFeaturesInfo();
+    const auto floatBinsRemap = GetFloatFeaturesBordersRemap(model, quantizedFeaturesInfo);
+    const auto catPerfectHashRemap = GetCatFeaturesPerfectHashToHashRemap(model, quantizedFeaturesInfo);
 
     executor->ExecRange([&](int blockId) {
         const int blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
         const int blockLastIdx = Min(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
 
-        auto floatBinsRemap = GetFloatFeaturesBordersRemap(model, *quantizedObjectsData.GetQuantizedFeaturesInfo().Get());
-
-        TVector<TConstArrayRef<ui8>> repackedFeatures;
+        TVector<TConstArrayRef<ui8>> repackedBinFeatures;
+        TVector<TConstArrayRef<ui32>> repackedCatFeatures;
         TVector<TMaybe<TPackedBinaryIndex>> packedIndexes;
-        GetRepackedFeatures(
+        TVector<TVector<ui8>> unpackedFloatFeatures;
+        GetRepackedQuantizedFeatures(
+            model,
+            quantizedObjectsData,
+            columnReorderMap,
             blockFirstIdx,
             blockLastIdx,
-            model.ObliviousTrees.GetFlatFeatureVectorExpectedSize(),
-            columnReorderMap,
-            [&quantizedObjectsData, &consecutiveSubsetBegin](ui32 featureIdx, TVector<TMaybe<TPackedBinaryIndex>>* packedIdx) -> const ui8* {
-                return  GetFeatureDataBeginPtr(quantizedObjectsData, featureIdx, consecutiveSubsetBegin, packedIdx);
-            },
-            featuresLayout,
-            &repackedFeatures,
-            &packedIndexes);
+            &repackedBinFeatures,
+            &repackedCatFeatures,
+            &packedIndexes,
+            &unpackedFloatFeatures);
 
         ui64 docCount = ui64(blockLastIdx - blockFirstIdx);
         ThreadCalcers[blockId] = MakeHolder<TFeatureCachedTreeEvaluator>(
             model,
-            [&floatBinsRemap, &repackedFeatures, &packedIndexes](const TFloatFeature& floatFeature, size_t index) -> ui8 {
-                return QuantizedFeaturesFloatAccessor(floatBinsRemap, repackedFeatures, packedIndexes, floatFeature, index);
+            [&floatBinsRemap, &repackedBinFeatures, &packedIndexes](const TFloatFeature& floatFeature, size_t index) -> ui8 {
+                return QuantizedFeaturesFloatAccessor(floatBinsRemap, repackedBinFeatures, packedIndexes, floatFeature, index);
             },
-            docCount);
+            docCount,
+            [&] (const TCatFeature& catFeature, size_t index) -> ui32 {
+                return QuantizedFeaturesCatAccessor(
+                    catPerfectHashRemap,
+                    repackedBinFeatures,
+                    repackedCatFeatures,
+                    packedIndexes,
+                    catFeature,
+                    index);
+            });
     }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
@@ -7,7 +7,9 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/ptr.h>
+#include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 
 namespace NCB {
@@ -52,6 +54,31 @@ TVector<double> ApplyModel(
     int end = 0,
     int threadCount = 1);
 
+/*
+ * Apply model to objects given as feature rows without creating objects data provider.
+ * floatFeatures rows are indexed by float feature index, catFeatures rows by categorical feature index,
+ * catFeatures can be empty if model has no categorical features.
+ * Executor threads are created only if there are enough objects for parallel evaluation, so this is
+ * cheap for small batches.
+ */
+TVector<TVector<double>> ApplyModelMultiOnFeatureRows(
+    const TFullModel& model,
+    TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+    TConstArrayRef<TConstArrayRef<int>> catFeatures, // hashed
+    const EPredictionType predictionType = EPredictionType::RawFormulaVal,
+    int begin = 0,
+    int end = 0,
+    int threadCount = 1);
+
+TVector<TVector<double>> ApplyModelMultiOnFeatureRows(
+    const TFullModel& model,
+    TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+    TConstArrayRef<TVector<TStringBuf>> catFeatures,
+    const EPredictionType predictionType = EPredictionType::RawFormulaVal,
+    int begin = 0,
+    int end = 0,
+    int threadCount = 1);
+
 /*
  * Tradeoff memory for speed
  * Don't use if you need to compute model only once and on all features
@@ -15,6 +15,8 @@
 #include <catboost/libs/logging/profile_info.h>
 #include <catboost/libs/options/enum_helpers.h>
 
+#include <library/chromium_trace/interface.h>
+
 #include <util/generic/ymath.h>
 
 template <bool StoreExpApprox, int VectorWidth>
@@ -643,15 +645,17 @@ void CalcLeafValues(
     const NCB::TTrainingForCPUDataProviders& data,
     const IDerCalcer& error,
     const TFold& fold,
-    const TSplitTree& tree,
+    const TTreeStructure& tree,
     TLearnContext* ctx,
     TVector<TVector<double>>* leafDeltas,
     TVector<TIndexType>* indices
 ) {
+    CHROMIUM_TRACE_SCOPE("Calc leaf values");
+
     *indices = BuildIndices(fold, tree, data.Learn, data.Test, ctx->LocalExecutor);
     const int approxDimension = ctx->LearnProgress.AveragingFold.GetApproxDimension();
     Y_VERIFY(fold.GetLearnSampleCount() == data.Learn->GetObjectCount());
-    const int leafCount = tree.GetLeafCount();
+    const int leafCount = GetLeafCount(tree);
     if (approxDimension == 1) {
         CalcLeafValuesSimple(leafCount, error, fold, *indices, ctx, leafDeltas);
     } else {
@@ -664,14 +668,16 @@ void CalcApproxForLeafStruct(
     const NCB::TTrainingForCPUDataProviders& data,
     const IDerCalcer& error,
     const TFold& fold,
-    const TSplitTree& tree,
+    const TTreeStructure& tree,
     ui64 randomSeed,
     TLearnContext* ctx,
     TVector<TVector<TVector<double>>>* approxesDelta // [bodyTailId][approxDim][docIdxInPermuted]
 ) {
+    CHROMIUM_TRACE_SCOPE("Calc approx for leaf struct");
+
     const TVector<TIndexType> indices = BuildIndices(fold, tree, data.Learn, data.Test, ctx->LocalExecutor);
     const int approxDimension = ctx->LearnProgress.ApproxDimension;
-    const int leafCount = tree.GetLeafCount();
+    const int leafCount = GetLeafCount(tree);
     TVector<ui64> randomSeeds;
     if (approxDimension == 1) {
         randomSeeds = GenRandUI64Vector(fold.BodyTailArr.ysize(), randomSeed);
@@ -1,5 +1,7 @@
 #include "approx_updater_helpers.h"
 
+#include <library/chromium_trace/interface.h>
+
 #include <util/generic/cast.h>
 
 using namespace NCB;
@@ -60,6 +62,8 @@ void UpdateAvrgApprox(
     TLearnProgress* learnProgress,
     NPar::TLocalExecutor* localExecutor
 ) {
+    CHROMIUM_TRACE_SCOPE("Update averaging approx");
+
     if (storeExpApprox) {
         ::UpdateAvrgApprox<true>(learnSampleCount, indices, treeDelta, testData, learnProgress, localExecutor);
     } else {
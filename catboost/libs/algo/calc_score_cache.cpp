@@ -30,9 +30,32 @@ TVector<TBucketStats, TPoolAllocator>& TBucketStatsCache::GetStats(const TSplitE
     return *splitStats;
 }
 
+TVector<TCompactBucketStats, TPoolAllocator>& TBucketStatsCache::GetCompactStats(const TSplitEnsemble& splitEnsemble, int splitStatsCount, bool* areStatsDirty) {
+    TVector<TCompactBucketStats, TPoolAllocator>* splitStats;
+    with_lock(Lock) {
+        if (CompactStats.contains(splitEnsemble) && CompactStats[splitEnsemble] != nullptr) {
+            splitStats = CompactStats[splitEnsemble].Get();
+            Y_ASSERT(splitStats->ysize() >= splitStatsCount);
+            *areStatsDirty = false;
+        } else {
+            splitStats = new TVector<TCompactBucketStats, TPoolAllocator>(MemoryPool.Get());
+            splitStats->yresize(MaxBodyTailCount * ApproxDimension * splitStatsCount);
+            CompactStats[splitEnsemble] = splitStats;
+            *areStatsDirty = true;
+        }
+    }
+    return *splitStats;
+}
+
+void TBucketStatsCache::Erase(const TSplitEnsemble& splitEnsemble) {
+    Stats.erase(splitEnsemble);
+    CompactStats.erase(splitEnsemble);
+}
+
 void TBucketStatsCache::GarbageCollect() {
     if (MemoryPool->MemoryWaste() > InitialSize) { // limit memory overhead
         Stats.clear();
+        CompactStats.clear();
         MemoryPool->Clear();
     }
 }
@@ -52,6 +75,39 @@ TVector<TBucketStats> TBucketStatsCache::GetStatsInUse(int segmentCount,
     return stats;
 }
 
+void TBucketStatsCache::LoadCompactStats(int segmentCount,
+    int segmentSize,
+    int statsCount,
+    const TVector<TCompactBucketStats, TPoolAllocator>& cachedStats,
+    int dstSegmentSize,
+    TArrayRef<TBucketStats> stats
+) {
+    Y_ASSERT(statsCount <= dstSegmentSize);
+    for (int segmentIdx : xrange(segmentCount)) {
+        const auto* srcBegin = &cachedStats[segmentIdx * segmentSize];
+        auto* dstBegin = &stats[segmentIdx * dstSegmentSize];
+        for (int statIdx : xrange(statsCount)) {
+            dstBegin[statIdx] = srcBegin[statIdx].Get();
+        }
+    }
+}
+
+void TBucketStatsCache::StoreCompactStats(int segmentCount,
+    int segmentSize,
+    int srcSegmentSize,
+    TConstArrayRef<TBucketStats> stats,
+    TVector<TCompactBucketStats, TPoolAllocator>* cachedStats
+) {
+    Y_ASSERT(srcSegmentSize <= segmentSize);
+    for (int segmentIdx : xrange(segmentCount)) {
+        const auto* srcBegin = &stats[segmentIdx * srcSegmentSize];
+        auto* dstBegin = &(*cachedStats)[segmentIdx * segmentSize];
+        for (int statIdx : xrange(srcSegmentSize)) {
+            dstBegin[statIdx].Set(srcBegin[statIdx]);
+        }
+    }
+}
+
 void TCalcScoreFold::TVectorSlicing::Create(const NPar::TLocalExecutor::TExecRangeParams& docBlockParams) {
     Total = docBlockParams.LastId;
     Slices.yresize(docBlockParams.GetBlockCount());
@@ -336,7 +392,15 @@ void TCalcScoreFold::SelectBlockFromFold(const TFoldType& fold, TSlice srcBlock,
 
 void TCalcScoreFold::SelectSmallestSplitSide(int curDepth, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor) {
     SetSmallestSideControl(curDepth, fold.DocCount, fold.Indices, localExecutor);
+    SelectByControl(fold, /*indexMask*/ 1 << (curDepth - 1), localExecutor);
+}
+
+void TCalcScoreFold::SelectLeaves(TConstArrayRef<bool> isLeafSelected, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor) {
+    SetLeavesControl(isLeafSelected, fold.DocCount, fold.Indices, localExecutor);
+    SelectByControl(fold, /*indexMask*/ 0, localExecutor);
+}
 
+void TCalcScoreFold::SelectByControl(const TCalcScoreFold& fold, TIndexType indexMask, NPar::TLocalExecutor* localExecutor) {
     TVectorSlicing srcBlocks;
     TVectorSlicing dstBlocks;
     int blockCount = 0;
@@ -361,8 +425,7 @@ void TCalcScoreFold::SelectSmallestSplitSide(int curDepth, const TCalcScoreFold&
         const auto srcControlRef = srcBlock.GetConstRef(Control);
         const auto srcIndicesRef = srcBlock.GetConstRef(fold.Indices);
         const auto dstBlock = dstBlocks.Slices[blockIdx];
-        const TIndexType splitWeight = 1 << (curDepth - 1);
-        SetElements(srcControlRef, srcBlock.GetConstRef(TVector<TIndexType>()), [=](const TIndexType*, size_t i) { return srcIndicesRef[i] | splitWeight; }, dstBlock.GetRef(Indices), &ignored);
+        SetElements(srcControlRef, srcBlock.GetConstRef(TVector<TIndexType>()), [=](const TIndexType*, size_t i) { return srcIndicesRef[i] | indexMask; }, dstBlock.GetRef(Indices), &ignored);
         SetElements(srcControlRef, srcBlock.GetConstRef(fold.IndexInFold), GetElement<ui32>, dstBlock.GetRef(IndexInFold), &ignored);
         SelectBlockFromFold(fold, srcBlock, dstBlock);
     }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
@@ -490,6 +553,18 @@ void TCalcScoreFold::SetSmallestSideControl(int curDepth, int docCount, const TU
     }
 }
 
+void TCalcScoreFold::SetLeavesControl(TConstArrayRef<bool> isLeafSelected, int docCount, const TUnsizedVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, docCount);
+    blockParams.SetBlockSize(4000);
+
+    const TIndexType* indicesData = GetDataPtr(indices);
+    const bool* isLeafSelectedData = isLeafSelected.data();
+    bool* controlData = GetDataPtr(Control);
+    localExecutor->ExecRange([=](int docIdx) {
+        controlData[docIdx] = isLeafSelectedData[indicesData[docIdx]];
+    }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 void TCalcScoreFold::SetSampledControl(int docCount, ESamplingUnit samplingUnit, const TVector<TQueryInfo>& queriesInfo, TRestorableFastRng64* rand) {
     if (BernoulliSampleRate == 1.0f || IsPairwiseScoring) {
         Fill(Control.begin(), Control.end(), true);
@@ -643,3 +718,46 @@ void TStats3D::Add(const TStats3D& stats3D) {
         Stats[statIdx].Add(stats3D.Stats[statIdx]);
     }
 }
+
+void TStats3D::UpdateWithLeafSplits(TConstArrayRef<TLeafSplitInfo> leafSplits, const TStats3D& smallerChildrenStats) {
+    const int newMaxLeafCount = smallerChildrenStats.MaxLeafCount;
+    CB_ENSURE(
+        smallerChildrenStats.BucketCount == BucketCount
+        && smallerChildrenStats.SplitEnsembleSpec == SplitEnsembleSpec
+        && newMaxLeafCount >= MaxLeafCount,
+        "SplitEnsembleSpec and bucket counts must match, leaf count can't decrease"
+    );
+    const int segmentCount = Stats.ysize() / (BucketCount * MaxLeafCount);
+    const int newSegmentSize = BucketCount * newMaxLeafCount;
+    CB_ENSURE(smallerChildrenStats.Stats.ysize() == segmentCount * newSegmentSize, "Dimension and fold counts must match");
+
+    if (newMaxLeafCount > MaxLeafCount) {
+        const int segmentSize = BucketCount * MaxLeafCount;
+        TVector<TBucketStats> extendedStats(segmentCount * newSegmentSize, TBucketStats{0, 0, 0, 0});
+        for (int segmentIdx : xrange(segmentCount)) {
+            const auto* srcBegin = Stats.data() + segmentIdx * segmentSize;
+            Copy(srcBegin, srcBegin + segmentSize, extendedStats.data() + segmentIdx * newSegmentSize);
+        }
+        Stats.swap(extendedStats);
+        MaxLeafCount = newMaxLeafCount;
+    }
+
+    for (int segmentIdx : xrange(segmentCount)) {
+        TBucketStats* stats = Stats.data() + segmentIdx * newSegmentSize;
+        const TBucketStats* smallerStats = smallerChildrenStats.Stats.data() + segmentIdx * newSegmentSize;
+        for (const auto& leafSplit : leafSplits) {
+            const int smallerLeaf = leafSplit.IsNewLeafSmaller ? leafSplit.NewLeaf : leafSplit.Leaf;
+            const int largerLeaf = leafSplit.IsNewLeafSmaller ? leafSplit.Leaf : leafSplit.NewLeaf;
+            TBucketStats* parentStats = stats + leafSplit.Leaf * BucketCount;
+            TBucketStats* smallerChildStats = stats + smallerLeaf * BucketCount;
+            TBucketStats* largerChildStats = stats + largerLeaf * BucketCount;
+            const TBucketStats* calculatedStats = smallerStats + smallerLeaf * BucketCount;
+            for (int bucketIdx : xrange(BucketCount)) {
+                TBucketStats largerStats = parentStats[bucketIdx];
+                largerStats.Remove(calculatedStats[bucketIdx]);
+                smallerChildStats[bucketIdx] = calculatedStats[bucketIdx];
+                largerChildStats[bucketIdx] = largerStats;
+            }
+        }
+    }
+}
@@ -83,6 +83,29 @@ struct TBucketStats {
 
 static_assert(std::is_pod<TBucketStats>::value, "TBucketStats must be pod to avoid memory initialization in yresize");
 
+/* Single precision storage for TBucketStats in TBucketStatsCache.
+ * Statistics are accumulated in TBucketStats and rounded only when they are stored to the cache.
+ */
+struct TCompactBucketStats {
+    float SumWeightedDelta;
+    float SumWeight;
+    float SumDelta;
+    float Count;
+
+    inline void Set(const TBucketStats& stats) {
+        SumWeightedDelta = (float)stats.SumWeightedDelta;
+        SumWeight = (float)stats.SumWeight;
+        SumDelta = (float)stats.SumDelta;
+        Count = (float)stats.Count;
+    }
+
+    inline TBucketStats Get() const {
+        return TBucketStats{SumWeightedDelta, SumWeight, SumDelta, Count};
+    }
+};
+
+static_assert(std::is_pod<TCompactBucketStats>::value, "TCompactBucketStats must be pod to avoid memory initialization in yresize");
+
 inline static int CountNonCtrBuckets(
     const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo,
     ui32 oneHotMaxSize
@@ -108,27 +131,66 @@ inline static int CountNonCtrBuckets(
 
 struct TBucketStatsCache {
     THashMap<TSplitEnsemble, THolder<TVector<TBucketStats, TPoolAllocator>>> Stats;
-    inline void Create(const TVector<TFold>& folds, int bucketCount, int depth) {
+    THashMap<TSplitEnsemble, THolder<TVector<TCompactBucketStats, TPoolAllocator>>> CompactStats;
+    inline void Create(const TVector<TFold>& folds, int bucketCount, int depth, bool useCompactStorage = false) {
         ApproxDimension = folds[0].GetApproxDimension();
         MaxBodyTailCount = GetMaxBodyTailCount(folds);
-        InitialSize = sizeof(TBucketStats) * bucketCount * (1U << depth) * ApproxDimension * MaxBodyTailCount;
+        UseCompactStorage = useCompactStorage;
+        const size_t statsSize = UseCompactStorage ? sizeof(TCompactBucketStats) : sizeof(TBucketStats);
+        InitialSize = statsSize * bucketCount * (1U << depth) * ApproxDimension * MaxBodyTailCount;
         if (InitialSize == 0) {
             InitialSize = NSystemInfo::GetPageSize();
         }
         MemoryPool = new TMemoryPool(InitialSize);
     }
+    inline bool IsCompact() const {
+        return UseCompactStorage;
+    }
     TVector<TBucketStats, TPoolAllocator>& GetStats(const TSplitEnsemble& splitEnsemble, int statsCount, bool* areStatsDirty);
+    TVector<TCompactBucketStats, TPoolAllocator>& GetCompactStats(const TSplitEnsemble& splitEnsemble, int statsCount, bool* areStatsDirty);
+    void Erase(const TSplitEnsemble& splitEnsemble);
+    // predicate must accept (const TSplitEnsemble&) param
+    template <typename TPredicate>
+    void EraseIf(TPredicate predicate) {
+        EraseIfImpl(predicate, &Stats);
+        EraseIfImpl(predicate, &CompactStats);
+    }
     void GarbageCollect();
     static TVector<TBucketStats> GetStatsInUse(int segmentCount,
         int segmentSize,
         int statsCount,
         const TVector<TBucketStats, TPoolAllocator>& cachedStats);
+    // copies first statsCount stats of each cached segment to stats with segments of dstSegmentSize
+    static void LoadCompactStats(int segmentCount,
+        int segmentSize,
+        int statsCount,
+        const TVector<TCompactBucketStats, TPoolAllocator>& cachedStats,
+        int dstSegmentSize,
+        TArrayRef<TBucketStats> stats);
+    // copies stats with segments of srcSegmentSize to the beginning of each cached segment
+    static void StoreCompactStats(int segmentCount,
+        int segmentSize,
+        int srcSegmentSize,
+        TConstArrayRef<TBucketStats> stats,
+        TVector<TCompactBucketStats, TPoolAllocator>* cachedStats);
+private:
+    template <typename TPredicate, typename TStatsMap>
+    static void EraseIfImpl(TPredicate predicate, TStatsMap* stats) {
+        for (auto it = stats->begin(); it != stats->end();) {
+            if (predicate(it->first)) {
+                stats->erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
 private:
     THolder<TMemoryPool> MemoryPool;
     TAdaptiveLock Lock;
     size_t InitialSize = 0;
     int MaxBodyTailCount = 0;
     int ApproxDimension = 0;
+    bool UseCompactStorage = false;
 };
 
 struct TCalcScoreFold {
@@ -217,6 +279,8 @@ struct TCalcScoreFold {
 
     void Create(const TVector<TFold>& folds, bool isPairwiseScoring, int defaultCalcStatsObjBlockSize, float sampleRate = 1.0f);
     void SelectSmallestSplitSide(int curDepth, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor);
+    // select documents from leaves with isLeafSelected[leafIdx] set, leaf indices are kept as is
+    void SelectLeaves(TConstArrayRef<bool> isLeafSelected, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor);
     void Sample(const TFold& fold, ESamplingUnit samplingUnit, const TVector<TIndexType>& indices, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor, bool isCoinFlipping = true);
     void UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
     int GetDocCount() const;
@@ -238,7 +302,9 @@ private:
     using TSlice = TVectorSlicing::TSlice;
     template <typename TFoldType>
     void SelectBlockFromFold(const TFoldType& fold, TSlice srcBlock, TSlice dstBlock);
+    void SelectByControl(const TCalcScoreFold& fold, TIndexType indexMask, NPar::TLocalExecutor* localExecutor);
     void SetSmallestSideControl(int curDepth, int docCount, const TUnsizedVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
+    void SetLeavesControl(TConstArrayRef<bool> isLeafSelected, int docCount, const TUnsizedVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
     void SetSampledControl(int docCount, ESamplingUnit samplingUnit, const TVector<TQueryInfo>& queriesInfo, TRestorableFastRng64* rand);
     void SetControlNoZeroWeighted(int docCount, const float* sampleWeights, ESamplingUnit samplingUnit);
 
@@ -267,6 +333,13 @@ private:
 };
 
 
+// Split of a non-symmetric tree leaf: documents of Leaf with true split value are moved to NewLeaf
+struct TLeafSplitInfo {
+    int Leaf = 0;
+    int NewLeaf = 0;
+    bool IsNewLeafSmaller = false; // NewLeaf has fewer sampled documents than Leaf after the split
+};
+
 struct TStats3D {
     TVector<TBucketStats> Stats; // [bodyTail & approxDim][leaf][bucket]
     int BucketCount = 0;
@@ -276,6 +349,13 @@ struct TStats3D {
 
     void Add(const TStats3D& stats3D);
 
+    /* Update stats after leaf splits without a pass over all documents of split leaves.
+     * smallerChildrenStats must be calculated on documents of the smaller children only,
+     * stats of larger children are obtained by subtraction from their parents.
+     * Stats are extended to smallerChildrenStats.MaxLeafCount leaves if needed.
+     */
+    void UpdateWithLeafSplits(TConstArrayRef<TLeafSplitInfo> leafSplits, const TStats3D& smallerChildrenStats);
+
     SAVELOAD(Stats, BucketCount, MaxLeafCount, SplitEnsembleSpec);
 };
 
@@ -8,6 +8,8 @@
 #include <catboost/libs/data_new/util.h>
 #include <catboost/libs/options/cat_feature_options.h>
 
+#include <library/binsaver/bin_saver.h>
+
 #include <util/generic/array_ref.h>
 
 
@@ -19,6 +21,7 @@ struct TCtrInfo {
     TVector<float> Priors;
 
     Y_SAVELOAD_DEFINE(Type, BorderCount, TargetClassifierIdx, Priors);
+    SAVELOAD(Type, BorderCount, TargetClassifierIdx, Priors);
 };
 
 inline int GetTargetBorderCount(const TCtrInfo& ctrInfo, ui32 targetClassesCount) {
@@ -56,6 +59,7 @@ public:
     }
 
     Y_SAVELOAD_DEFINE(TargetClassifiers, SimpleCtrs, PerFeatureCtrs, TreeCtrs)
+    SAVELOAD(TargetClassifiers, SimpleCtrs, PerFeatureCtrs, TreeCtrs);
 
 private:
     TVector<TTargetClassifier> TargetClassifiers;
@@ -2,6 +2,8 @@
 
 #include <util/generic/xrange.h>
 
+#include <type_traits>
+
 template <int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta>
 void IDerCalcer::CalcDersRangeImpl(
     int start,
@@ -107,6 +109,194 @@ void IDerCalcer::CalcDersRange(
     }
 }
 
+template <class TFunc>
+static void DispatchBool(bool value, TFunc&& func) {
+    if (value) {
+        func(std::true_type());
+    } else {
+        func(std::false_type());
+    }
+}
+
+template <class TError>
+template <int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta, bool HasWeights>
+void TDerCalcerWithInlinedDers<TError>::CalcDersRangeImpl(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) const {
+    Y_ASSERT(UseExpApprox == GetIsExpApprox());
+    Y_ASSERT(HasDelta == (approxDeltas != nullptr));
+    Y_ASSERT(HasWeights == (weights != nullptr));
+    Y_ASSERT(UseTDers == (ders != nullptr) && (ders != nullptr) == (firstDers == nullptr));
+    Y_ASSERT(MaxDerivativeOrder <= (int)GetMaxSupportedDerivativeOrder());
+    const TError& error = static_cast<const TError&>(*this);
+#pragma clang loop vectorize_width(4) interleave_count(2)
+    for (int i = start; i < start + count; ++i) {
+        double updatedApprox = approxes[i];
+        if (HasDelta) {
+            updatedApprox = UpdateApprox<UseExpApprox>(updatedApprox, approxDeltas[i]);
+        }
+        const double weight = HasWeights ? weights[i] : 1.0;
+        const double der1 = error.TError::CalcDer(updatedApprox, targets[i]);
+        if (UseTDers) {
+            ders[i].Der1 = HasWeights ? der1 * weight : der1;
+        } else {
+            firstDers[i] = HasWeights ? der1 * weight : der1;
+        }
+        if (MaxDerivativeOrder >= 2) {
+            const double der2 = error.TError::CalcDer2(updatedApprox, targets[i]);
+            ders[i].Der2 = HasWeights ? der2 * weight : der2;
+        }
+        if (MaxDerivativeOrder >= 3) {
+            const double der3 = error.TError::CalcDer3(updatedApprox, targets[i]);
+            ders[i].Der3 = HasWeights ? der3 * weight : der3;
+        }
+    }
+}
+
+template <class TError>
+void TDerCalcerWithInlinedDers<TError>::CalcDersRangeInlined(
+    int start,
+    int count,
+    int maxDerivativeOrder,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) const {
+    DispatchBool(GetIsExpApprox(), [&](auto useExpApprox) {
+        DispatchBool(approxDeltas != nullptr, [&](auto hasDelta) {
+            DispatchBool(weights != nullptr, [&](auto hasWeights) {
+                constexpr bool UseExpApprox = decltype(useExpApprox)::value;
+                constexpr bool HasDelta = decltype(hasDelta)::value;
+                constexpr bool HasWeights = decltype(hasWeights)::value;
+                if (ders == nullptr) {
+                    Y_ASSERT(maxDerivativeOrder == 1);
+                    CalcDersRangeImpl<1, false, UseExpApprox, HasDelta, HasWeights>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+                    return;
+                }
+                switch (maxDerivativeOrder) {
+                    case 1:
+                        return CalcDersRangeImpl<1, true, UseExpApprox, HasDelta, HasWeights>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+                    case 2:
+                        return CalcDersRangeImpl<2, true, UseExpApprox, HasDelta, HasWeights>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+                    case 3:
+                        return CalcDersRangeImpl<3, true, UseExpApprox, HasDelta, HasWeights>(start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+                    default:
+                        Y_ASSERT(false);
+                }
+            });
+        });
+    });
+}
+
+template <class TError>
+void TDerCalcerWithInlinedDers<TError>::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* firstDers
+) const {
+    CalcDersRangeInlined(start, count, /*maxDerivativeOrder*/ 1, approxes, approxDeltas, targets, weights, /*ders*/ nullptr, firstDers);
+}
+
+template <class TError>
+void TDerCalcerWithInlinedDers<TError>::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    const int maxDerivativeOrder = calcThirdDer ? 3 : Min(GetMaxSupportedDerivativeOrder(), 2u);
+    CalcDersRangeInlined(start, count, maxDerivativeOrder, approxes, approxDeltas, targets, weights, ders, /*firstDers*/ nullptr);
+}
+
+template class TDerCalcerWithInlinedDers<TRMSEError>;
+template class TDerCalcerWithInlinedDers<TQuantileError>;
+template class TDerCalcerWithInlinedDers<TLqError>;
+template class TDerCalcerWithInlinedDers<TLogLinQuantileError>;
+template class TDerCalcerWithInlinedDers<TMAPError>;
+template class TDerCalcerWithInlinedDers<TPoissonError>;
+
+void IDerCalcer::CalcFirstDerMultiRange(
+    int start,
+    int count,
+    const TVector<TVector<double>>& approx,
+    const float* targets,
+    const float* weights,
+    TVector<TVector<double>>* firstDers
+) const {
+    const int approxDimension = approx.ysize();
+    TVector<double> curApprox(approxDimension);
+    TVector<double> curDer(approxDimension);
+    for (int i = start; i < start + count; ++i) {
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            curApprox[dim] = approx[dim][i];
+        }
+        CalcDersMulti(curApprox, targets[i], weights ? weights[i] : 1, &curDer, nullptr);
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            (*firstDers)[dim][i] = curDer[dim];
+        }
+    }
+}
+
+void TMultiClassError::CalcFirstDerMultiRange(
+    int start,
+    int count,
+    const TVector<TVector<double>>& approx,
+    const float* targets,
+    const float* weights,
+    TVector<TVector<double>>* firstDers
+) const {
+    // softmax is calculated for blocks of objects, so that exp is vectorized over the whole block
+    constexpr int BlockSize = 128;
+    const int approxDimension = approx.ysize();
+    TVector<double> expApprox; // [objectIdx in block][dim]
+    expApprox.yresize(Min(BlockSize, count) * approxDimension);
+    for (int blockStart = start; blockStart < start + count; blockStart += BlockSize) {
+        const int blockEnd = Min(blockStart + BlockSize, start + count);
+        for (int i = blockStart; i < blockEnd; ++i) {
+            double* objectExpApprox = expApprox.data() + (i - blockStart) * approxDimension;
+            double maxApprox = approx[0][i];
+            for (int dim = 1; dim < approxDimension; ++dim) {
+                maxApprox = Max(maxApprox, approx[dim][i]);
+            }
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                objectExpApprox[dim] = approx[dim][i] - maxApprox;
+            }
+        }
+        FastExpInplace(expApprox.data(), (blockEnd - blockStart) * approxDimension);
+        for (int i = blockStart; i < blockEnd; ++i) {
+            const double* objectExpApprox = expApprox.data() + (i - blockStart) * approxDimension;
+            double sumExpApprox = 0;
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                sumExpApprox += objectExpApprox[dim];
+            }
+            const int targetClass = static_cast<int>(targets[i]);
+            const double weight = weights ? weights[i] : 1;
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                const double der = (dim == targetClass) - objectExpApprox[dim] / sumExpApprox;
+                (*firstDers)[dim][i] = der * weight;
+            }
+        }
+    }
+}
+
 namespace {
     template <int Capacity>
     class TExpForwardView {
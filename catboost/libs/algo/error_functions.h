@@ -88,6 +88,16 @@ public:
         CB_ENSURE(false, "Not implemented");
     }
 
+    // weighted first derivatives for objects [start, start + count), approx and firstDers are [dim][objectIdx]
+    virtual void CalcFirstDerMultiRange(
+        int start,
+        int count,
+        const TVector<TVector<double>>& approx,
+        const float* targets,
+        const float* weights,
+        TVector<TVector<double>>* firstDers
+    ) const;
+
     virtual void CalcDersForQueries(
         int /*queryStartIndex*/,
         int /*queryEndIndex*/,
@@ -144,6 +154,61 @@ private:
     ) const;
 };
 
+// Base for per-object errors with derivatives that depend only on approx and target.
+// Range methods call TError::CalcDer* non-virtually, so that derivative calculation is inlined
+// and vectorized, weights are applied in the same pass.
+template <class TError>
+class TDerCalcerWithInlinedDers : public IDerCalcer {
+public:
+    using IDerCalcer::IDerCalcer;
+
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* firstDers
+    ) const override;
+
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
+
+private:
+    template <int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta, bool HasWeights>
+    void CalcDersRangeImpl(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders,
+        double* firstDers
+    ) const;
+
+    void CalcDersRangeInlined(
+        int start,
+        int count,
+        int maxDerivativeOrder,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders,
+        double* firstDers
+    ) const;
+};
+
 class TCrossEntropyError final : public IDerCalcer {
 public:
     explicit TCrossEntropyError(bool isExpApprox)
@@ -173,13 +238,15 @@ public:
     ) const override;
 };
 
-class TRMSEError final : public IDerCalcer {
+class TRMSEError final : public TDerCalcerWithInlinedDers<TRMSEError> {
+    friend class TDerCalcerWithInlinedDers<TRMSEError>;
+
 public:
     static constexpr double RMSE_DER2 = -1.0;
     static constexpr double RMSE_DER3 = 0.0;
 
     explicit TRMSEError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlinedDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
@@ -198,21 +265,23 @@ private:
     }
 };
 
-class TQuantileError final : public IDerCalcer {
+class TQuantileError final : public TDerCalcerWithInlinedDers<TQuantileError> {
+    friend class TDerCalcerWithInlinedDers<TQuantileError>;
+
 public:
     static constexpr double QUANTILE_DER2_AND_DER3 = 0.0;
 
     const double Alpha;
 
     explicit TQuantileError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlinedDers(isExpApprox)
     , Alpha(0.5)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
     TQuantileError(double alpha, bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlinedDers(isExpApprox)
     , Alpha(alpha)
     {
         Y_ASSERT(Alpha > -1e-6 && Alpha < 1.0 + 1e-6);
@@ -233,12 +302,14 @@ private:
     }
 };
 
-class TLqError final : public IDerCalcer {
+class TLqError final : public TDerCalcerWithInlinedDers<TLqError> {
+    friend class TDerCalcerWithInlinedDers<TLqError>;
+
 public:
     const double Q;
 
     TLqError(double q, bool isExpApprox)
-    : IDerCalcer(isExpApprox, /*maxDerivativeOrder*/ q >= 2 ?  3 : 1)
+    : TDerCalcerWithInlinedDers(isExpApprox, /*maxDerivativeOrder*/ q >= 2 ?  3 : 1)
     , Q(q)
     {
         Y_ASSERT(Q >= 1);
@@ -263,21 +334,23 @@ private:
     }
 };
 
-class TLogLinQuantileError final : public IDerCalcer {
+class TLogLinQuantileError final : public TDerCalcerWithInlinedDers<TLogLinQuantileError> {
+    friend class TDerCalcerWithInlinedDers<TLogLinQuantileError>;
+
 public:
     static constexpr double QUANTILE_DER2_AND_DER3 = 0.0;
 
     const double Alpha;
 
     explicit TLogLinQuantileError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlinedDers(isExpApprox)
     , Alpha(0.5)
     {
         CB_ENSURE(isExpApprox == true, "Approx format does not match");
     }
 
     TLogLinQuantileError(double alpha, bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlinedDers(isExpApprox)
     , Alpha(alpha)
     {
         Y_ASSERT(Alpha > -1e-6 && Alpha < 1.0 + 1e-6);
@@ -298,12 +371,14 @@ private:
     }
 };
 
-class TMAPError final : public IDerCalcer {
+class TMAPError final : public TDerCalcerWithInlinedDers<TMAPError> {
+    friend class TDerCalcerWithInlinedDers<TMAPError>;
+
 public:
     static constexpr double MAPE_DER2_AND_DER3 = 0.0;
 
     explicit TMAPError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlinedDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
@@ -322,10 +397,12 @@ private:
     }
 };
 
-class TPoissonError final : public IDerCalcer {
+class TPoissonError final : public TDerCalcerWithInlinedDers<TPoissonError> {
+    friend class TDerCalcerWithInlinedDers<TPoissonError>;
+
 public:
     explicit TPoissonError(bool isExpApprox)
-    : IDerCalcer(isExpApprox)
+    : TDerCalcerWithInlinedDers(isExpApprox)
     {
         CB_ENSURE(isExpApprox == true, "Approx format does not match");
     }
@@ -352,6 +429,15 @@ public:
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
+    void CalcFirstDerMultiRange(
+        int start,
+        int count,
+        const TVector<TVector<double>>& approx,
+        const float* targets,
+        const float* weights,
+        TVector<TVector<double>>* firstDers
+    ) const override;
+
     void CalcDersMulti(
         const TVector<double>& approx,
         float target,
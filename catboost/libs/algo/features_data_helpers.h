@@ -27,12 +27,27 @@ namespace NCB {
         ui32 consecutiveSubsetBegin,
         ui32 flatFeatureIdx)
     {
-        const auto featuresLayout = *quantizedObjectsData.GetFeaturesLayout();
+        const auto& featuresLayout = *quantizedObjectsData.GetFeaturesLayout();
         CB_ENSURE_INTERNAL(
             featuresLayout.GetExternalFeatureType(flatFeatureIdx) == EFeatureType::Float,
             "Mismatched feature type"
         );
-        return quantizedObjectsData.GetFloatFeatureRawSrcData(flatFeatureIdx) + consecutiveSubsetBegin;
+        return quantizedObjectsData.GetFloatFeatureRawSrcData(
+            featuresLayout.GetInternalFeatureIdx(flatFeatureIdx)) + consecutiveSubsetBegin;
+    }
+
+    inline const ui32* GetQuantizedForCpuCatFeatureDataBeginPtr(
+        const TQuantizedForCPUObjectsDataProvider& quantizedObjectsData,
+        ui32 consecutiveSubsetBegin,
+        ui32 flatFeatureIdx)
+    {
+        const auto& featuresLayout = *quantizedObjectsData.GetFeaturesLayout();
+        CB_ENSURE_INTERNAL(
+            featuresLayout.GetExternalFeatureType(flatFeatureIdx) == EFeatureType::Categorical,
+            "Mismatched feature type"
+        );
+        return quantizedObjectsData.GetCatFeatureRawSrcData(
+            featuresLayout.GetInternalFeatureIdx(flatFeatureIdx)) + consecutiveSubsetBegin;
     }
 
     template <class TDataProvidersTemplate>
@@ -53,7 +68,7 @@ namespace NCB {
         const TFloatFeature& floatFeature,
         size_t index)
     {
-        auto& packIdx = packedIndexes[floatFeature.FeatureIndex];
+        auto& packIdx = packedIndexes[floatFeature.FlatFeatureIndex];
         if (packIdx.Defined()) {
             TBinaryFeaturesPack bitIdx = packIdx->BitIdx;
             ui8 binaryFeatureValue = (repackedFeatures[floatFeature.FlatFeatureIndex][index] >> bitIdx) & 1;
@@ -62,4 +77,23 @@ namespace NCB {
             return floatBinsRemap[floatFeature.FlatFeatureIndex][repackedFeatures[floatFeature.FlatFeatureIndex][index]];
         }
     }
+
+    // returns hashed value, binary packed categorical features are stored in repackedBinFeatures
+    inline ui32 QuantizedFeaturesCatAccessor(
+        const TVector<TVector<ui32>>& catPerfectHashRemap,
+        TConstArrayRef<TConstArrayRef<ui8>> repackedBinFeatures,
+        TConstArrayRef<TConstArrayRef<ui32>> repackedCatFeatures,
+        const TVector<TMaybe<TPackedBinaryIndex>>& packedIndexes,
+        const TCatFeature& catFeature,
+        size_t index)
+    {
+        auto& packIdx = packedIndexes[catFeature.FlatFeatureIndex];
+        if (packIdx.Defined()) {
+            TBinaryFeaturesPack bitIdx = packIdx->BitIdx;
+            ui8 binaryFeatureValue = (repackedBinFeatures[catFeature.FlatFeatureIndex][index] >> bitIdx) & 1;
+            return catPerfectHashRemap[catFeature.FlatFeatureIndex][binaryFeatureValue];
+        } else {
+            return catPerfectHashRemap[catFeature.FlatFeatureIndex][repackedCatFeatures[catFeature.FlatFeatureIndex][index]];
+        }
+    }
 }
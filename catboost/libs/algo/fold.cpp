@@ -7,6 +7,8 @@
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 
+#include <library/chromium_trace/interface.h>
+
 #include <util/generic/cast.h>
 
 
@@ -58,13 +60,25 @@ static void InitPermutationData(
     bool shuffle,
     ui32 permuteBlockSize,
     TRestorableFastRng64* rand,
+    TConstArrayRef<ui32> permutationPrefix,
     TFold* fold
 ) {
     const ui32 learnSampleCount = learnData.GetObjectCount();
     const auto& featuresArraySubsetIndexing = learnData.ObjectsData->GetFeaturesArraySubsetIndexing();
 
     TMaybe<ui32> consecutiveSubsetBegin = featuresArraySubsetIndexing.GetConsecutiveSubsetBegin();
-    if (shuffle) {
+    if (shuffle && !permutationPrefix.empty()) {
+        // blocks of the prefix are not aligned to the blocks of all objects
+        fold->PermutationBlockSize = 1;
+        if (consecutiveSubsetBegin) {
+            fold->FeaturesSubsetBegin = *consecutiveSubsetBegin;
+        }
+        fold->LearnPermutation = ExtendPermutation(learnData.ObjectsGrouping, permutationPrefix);
+        fold->LearnPermutationFeaturesSubset = Compose(
+            featuresArraySubsetIndexing,
+            fold->LearnPermutation->GetObjectsIndexing()
+        );
+    } else if (shuffle) {
         if (consecutiveSubsetBegin) {
             fold->PermutationBlockSize = learnData.ObjectsGrouping->IsTrivial() ? permuteBlockSize : 1;
             fold->FeaturesSubsetBegin = *consecutiveSubsetBegin;
@@ -121,12 +135,14 @@ TFold TFold::BuildDynamicFold(
     TRestorableFastRng64& rand,
     NPar::TLocalExecutor* localExecutor
 ) {
+    CHROMIUM_TRACE_SCOPE("Build dynamic fold");
+
     const ui32 learnSampleCount = learnData.GetObjectCount();
 
     TFold ff;
     ff.SampleWeights.resize(learnSampleCount, 1);
 
-    InitPermutationData(learnData, shuffle, permuteBlockSize, &rand, &ff);
+    InitPermutationData(learnData, shuffle, permuteBlockSize, &rand, /*permutationPrefix*/ {}, &ff);
 
     ff.AssignTarget(learnData.TargetData->GetTarget(), targetClassifiers);
     ff.SetWeights(GetWeights(*learnData.TargetData), learnSampleCount);
@@ -202,14 +218,17 @@ TFold TFold::BuildPlainFold(
     bool storeExpApproxes,
     bool hasPairwiseWeights,
     TRestorableFastRng64& rand,
-    NPar::TLocalExecutor* localExecutor
+    NPar::TLocalExecutor* localExecutor,
+    TConstArrayRef<ui32> permutationPrefix
 ) {
+    CHROMIUM_TRACE_SCOPE("Build plain fold");
+
     const ui32 learnSampleCount = learnData.GetObjectCount();
 
     TFold ff;
     ff.SampleWeights.resize(learnSampleCount, 1);
 
-    InitPermutationData(learnData, shuffle, permuteBlockSize, &rand, &ff);
+    InitPermutationData(learnData, shuffle, permuteBlockSize, &rand, permutationPrefix, &ff);
 
     ff.AssignTarget(learnData.TargetData->GetTarget(), targetClassifiers);
     ff.SetWeights(GetWeights(*learnData.TargetData), learnSampleCount);
@@ -249,13 +268,14 @@ TFold TFold::BuildPlainFold(
 
 void TFold::DropEmptyCTRs() {
     TVector<TProjection> emptyProjections;
+    // spilled ctrs are kept to be read back from disk
     for (auto& projCtr : OnlineSingleCtrs) {
-        if (projCtr.second.Feature.empty()) {
+        if (projCtr.second.Feature.empty() && projCtr.second.SpillFile.empty()) {
             emptyProjections.emplace_back(projCtr.first);
         }
     }
     for (auto& projCtr : OnlineCTR) {
-        if (projCtr.second.Feature.empty()) {
+        if (projCtr.second.Feature.empty() && projCtr.second.SpillFile.empty()) {
             emptyProjections.emplace_back(projCtr.first);
         }
     }
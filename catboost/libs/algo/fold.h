@@ -99,6 +99,16 @@ struct TFold {
 
     void DropEmptyCTRs();
 
+    template <class TCallback>
+    void ForEachCtr(TCallback&& callback) {
+        for (auto& [proj, ctr] : OnlineSingleCtrs) {
+            callback(proj, &ctr);
+        }
+        for (auto& [proj, ctr] : OnlineCTR) {
+            callback(proj, &ctr);
+        }
+    }
+
     const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&> GetAllCtrs() const {
         return std::tie(OnlineSingleCtrs, OnlineCTR);
     }
@@ -143,6 +153,9 @@ struct TFold {
         NPar::TLocalExecutor* localExecutor
     );
 
+    /* if shuffle and permutationPrefix is not empty, the permutation starts with permutationPrefix
+     * and the rest of objects follow in their original order (rand is not used then)
+     */
     static TFold BuildPlainFold(
         const NCB::TTrainingForCPUDataProvider& learnData,
         const TVector<TTargetClassifier>& targetClassifiers,
@@ -152,7 +165,8 @@ struct TFold {
         bool storeExpApproxes,
         bool hasPairwiseWeights,
         TRestorableFastRng64& rand,
-        NPar::TLocalExecutor* localExecutor
+        NPar::TLocalExecutor* localExecutor,
+        TConstArrayRef<ui32> permutationPrefix = {}
     );
 
     double GetSumWeight() const { return SumWeight; }
@@ -11,10 +11,13 @@
 #include <catboost/libs/logging/profile_info.h>
 #include <catboost/libs/helpers/interrupt.h>
 #include <catboost/libs/helpers/query_info_helper.h>
+#include <catboost/libs/helpers/restorable_rng.h>
 
 #include <library/dot_product/dot_product.h>
 #include <library/fast_log/fast_log.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/bitops.h>
 #include <util/generic/cast.h>
 #include <util/generic/xrange.h>
 #include <util/string/builder.h>
@@ -30,7 +33,21 @@ using namespace NCB;
 
 constexpr size_t MAX_ONLINE_CTR_FEATURES = 50;
 
-void TrimOnlineCTRcache(const TVector<TFold*>& folds) {
+// the cache budget is shared by all folds
+static void ShrinkOnlineCtrCache(TLearnContext* ctx) {
+    TVector<TFold*> allFolds;
+    for (auto& fold : ctx->LearnProgress.Folds) {
+        allFolds.push_back(&fold);
+    }
+    allFolds.push_back(&ctx->LearnProgress.AveragingFold);
+    ctx->OnlineCtrCache.Shrink(allFolds);
+}
+
+void TrimOnlineCTRcache(const TVector<TFold*>& folds, TLearnContext* ctx) {
+    if (ctx && ctx->OnlineCtrCache.HasSizeLimit()) {
+        ShrinkOnlineCtrCache(ctx);
+        return;
+    }
     for (auto& fold : folds) {
         fold->TrimOnlineCTR(MAX_ONLINE_CTR_FEATURES);
     }
@@ -159,7 +176,7 @@ static void CompressCandidatesWithBinaryFeatures(const TQuantizedForCPUObjectsDa
 
     for (auto& candSubList : *candList) {
         const auto& splitEnsemble = candSubList.Candidates[0].SplitEnsemble;
-        Y_ASSERT(!splitEnsemble.IsBinarySplitsPack);
+        Y_ASSERT(splitEnsemble.Type == ESplitEnsembleType::OneFeature);
         const auto& splitCandidate = splitEnsemble.SplitCandidate;
 
         TMaybe<TPackedBinaryIndex> maybePackedBinaryIndex;
@@ -187,6 +204,42 @@ static void CompressCandidatesWithBinaryFeatures(const TQuantizedForCPUObjectsDa
 }
 
 
+/* Replaces candidates for float features that are parts of exclusive features bundles with one candidate
+ * per bundle. Must be called after CompressCandidatesWithBinaryFeatures.
+ */
+static void CompressCandidatesWithExclusiveFeatureBundles(
+    const TQuantizedForCPUObjectsDataProvider& learnObjectsData,
+    TCandidateList* candList
+) {
+    const ui32 bundlesCount = SafeIntegerCast<ui32>(learnObjectsData.GetExclusiveFeatureBundlesSize());
+    if (!bundlesCount) {
+        return;
+    }
+
+    TCandidateList updatedCandList;
+    updatedCandList.reserve(candList->size());
+
+    for (auto& candSubList : *candList) {
+        const auto& splitEnsemble = candSubList.Candidates[0].SplitEnsemble;
+        if (splitEnsemble.IsSplitOfType(ESplitType::FloatFeature)
+            && learnObjectsData.GetFloatFeatureToExclusiveBundleIndex(
+                TFloatFeatureIdx(splitEnsemble.SplitCandidate.FeatureIdx)))
+        {
+            continue;
+        }
+        updatedCandList.push_back(std::move(candSubList));
+    }
+
+    for (auto bundleIdx : xrange(bundlesCount)) {
+        TCandidateInfo candidate;
+        candidate.SplitEnsemble = TSplitEnsemble{TExclusiveFeaturesBundleRef{bundleIdx}};
+        updatedCandList.emplace_back(TCandidatesInfoList(candidate));
+    }
+
+    std::swap(*candList, updatedCandList);
+}
+
+
 static void SelectCandidatesAndCleanupStatsFromPrevTree(TLearnContext* ctx,
                                                         TCandidateList* candList,
                                                         TVector<TBinaryFeaturesPack>* perPackMasks,
@@ -199,7 +252,7 @@ static void SelectCandidatesAndCleanupStatsFromPrevTree(TLearnContext* ctx,
         const auto& splitEnsemble = candSubList.Candidates[0].SplitEnsemble;
 
         bool addCandSubListToResult;
-        if (splitEnsemble.IsBinarySplitsPack) {
+        if (splitEnsemble.Type == ESplitEnsembleType::BinarySplits) {
             const ui32 packIdx = splitEnsemble.BinarySplitsPack.PackIdx;
             TBinaryFeaturesPack& perPackMask = (*perPackMasks)[packIdx];
             for (size_t idxInPack : xrange(sizeof(TBinaryFeaturesPack) * CHAR_BIT)) {
@@ -219,7 +272,7 @@ static void SelectCandidatesAndCleanupStatsFromPrevTree(TLearnContext* ctx,
         if (addCandSubListToResult) {
             updatedCandList.push_back(std::move(candSubList));
         } else if (ctx->UseTreeLevelCaching()) {
-            statsFromPrevTree->Stats.erase(splitEnsemble);
+            statsFromPrevTree->Erase(splitEnsemble);
         }
     }
 
@@ -273,7 +326,7 @@ static void DropStatsForProjection(const TFold& fold,
                 TSplitCandidate splitCandidate;
                 splitCandidate.Type = ESplitType::OnlineCtr;
                 splitCandidate.Ctr = TCtr(proj, ctrIdx, border, prior, ctrMeta.BorderCount);
-                statsFromPrevTree->Stats.erase(TSplitEnsemble(std::move(splitCandidate)));
+                statsFromPrevTree->Erase(TSplitEnsemble(std::move(splitCandidate)));
             }
         }
     }
@@ -307,8 +360,9 @@ static void AddSimpleCtrs(const TQuantizedForCPUObjectsDataProvider& learnObject
     );
 }
 
+template <typename TTree>
 static void AddTreeCtrs(const TQuantizedForCPUObjectsDataProvider& learnObjectsData,
-                        const TSplitTree& currentTree,
+                        const TTree& currentTree,
                         TFold* fold,
                         TLearnContext* ctx,
                         TBucketStatsCache* statsFromPrevTree,
@@ -362,17 +416,12 @@ static void AddTreeCtrs(const TQuantizedForCPUObjectsDataProvider& learnObjectsD
         );
     }
     if (ctx->UseTreeLevelCaching()) {
-        THashSet<TSplitEnsemble> candidatesToErase;
-        for (auto& [splitEnsemble, value] : statsFromPrevTree->Stats) {
-            if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
-                if (!addedProjHash.contains(splitEnsemble.SplitCandidate.Ctr.Projection)) {
-                    candidatesToErase.insert(splitEnsemble);
-                }
+        statsFromPrevTree->EraseIf(
+            [&] (const TSplitEnsemble& splitEnsemble) {
+                return splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)
+                    && !addedProjHash.contains(splitEnsemble.SplitCandidate.Ctr.Projection);
             }
-        }
-        for (const auto& splitEnsemble : candidatesToErase) {
-            statsFromPrevTree->Stats.erase(splitEnsemble);
-        }
+        );
     }
 }
 
@@ -449,7 +498,7 @@ static void CalcBestScore(const TTrainingForCPUDataProviders& data,
 
         if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
             const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
-            if (fold->GetCtrRef(proj).Feature.empty()) {
+            if (!ctx->OnlineCtrCache.Acquire(&fold->GetCtrRef(proj))) {
                 ComputeOnlineCTRs(data,
                                   *fold,
                                   proj,
@@ -497,14 +546,82 @@ static void CalcBestScore(const TTrainingForCPUDataProviders& data,
     }, 0, candList.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
-void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
-                        double modelLength,
-                        TProfileInfo& profile,
-                        TFold* fold,
-                        TLearnContext* ctx,
-                        TSplitTree* resSplitTree) {
+static size_t CalcMaxFeatureValueCount(const TFold& fold, const TCandidateList& candList) {
+    size_t maxFeatureValueCount = 1;
+    for (const auto& candidate : candList) {
+        const auto& splitEnsemble = candidate.Candidates[0].SplitEnsemble;
+        if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
+            const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
+            maxFeatureValueCount = Max(maxFeatureValueCount, fold.GetCtr(proj).GetMaxUniqueValueCount());
+        }
+    }
+    return maxFeatureValueCount;
+}
+
+static void SelectBestCandidate(
+    const TCandidateList& candList,
+    size_t maxFeatureValueCount,
+    TFold* fold,
+    TLearnContext* ctx,
+    double* bestScore,
+    const TCandidateInfo** bestSplitCandidate) {
+
+    for (const auto& subList : candList) {
+        for (const auto& candidate : subList.Candidates) {
+            double score = candidate.BestScore.GetInstance(ctx->Rand);
+            // CATBOOST_INFO_LOG << BuildDescription(ctx->Layout, candidate.SplitCandidate) << " = " << score << "\t";
+
+            const auto& splitEnsemble = candidate.SplitEnsemble;
+            if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
+                TProjection projection = splitEnsemble.SplitCandidate.Ctr.Projection;
+                ECtrType ctrType =
+                    ctx->CtrsHelper.GetCtrInfo(projection)[splitEnsemble.SplitCandidate.Ctr.CtrIdx].Type;
+
+                if (!ctx->LearnProgress.UsedCtrSplits.contains(std::make_pair(ctrType, projection)) &&
+                    score != MINIMAL_SCORE)
+                {
+                    score *= pow(
+                        1 + fold->GetCtrRef(projection).GetUniqueValueCountForType(ctrType) / static_cast<double>(maxFeatureValueCount),
+                        -ctx->Params.ObliviousTreeOptions->ModelSizeReg.Get()
+                    );
+                }
+            }
+            if (score > *bestScore) {
+                *bestScore = score;
+                *bestSplitCandidate = &candidate;
+            }
+        }
+    }
+}
+
+static double CalcScoreStDev(const TFold& fold, int learnSampleCount, double modelLength, const TLearnContext& ctx) {
+    return ctx.Params.ObliviousTreeOptions->RandomStrength
+        * CalcDerivativesStDevFromZero(fold, ctx.Params.BoostingOptions->BoostingType)
+        * CalcDerivativesStDevFromZeroMultiplier(learnSampleCount, modelLength);
+}
+
+static TVector<TProjection> GetOnlineCtrProjections(const TCandidateList& candList) {
+    TVector<TProjection> projections;
+    for (const auto& candidate : candList) {
+        const auto& splitEnsemble = candidate.Candidates[0].SplitEnsemble;
+        if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
+            const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
+            if (!IsIn(projections, proj)) {
+                projections.push_back(proj);
+            }
+        }
+    }
+    return projections;
+}
+
+static void GreedyTensorSearchOblivious(const TTrainingForCPUDataProviders& data,
+                                        double modelLength,
+                                        TProfileInfo& profile,
+                                        TFold* fold,
+                                        TLearnContext* ctx,
+                                        TSplitTree* resSplitTree) {
     TSplitTree currentSplitTree;
-    TrimOnlineCTRcache({fold});
+    TrimOnlineCTRcache({fold}, ctx);
 
     ui32 learnSampleCount = data.Learn->ObjectsData->GetObjectCount();
     ui32 testSampleCount = data.GetTestSampleCount();
@@ -540,6 +657,9 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             ctx,
             &candList);
         CompressCandidatesWithBinaryFeatures(*data.Learn->ObjectsData, &candList, &perPackMasks);
+        if (!isPairwiseScoring) {
+            CompressCandidatesWithExclusiveFeatureBundles(*data.Learn->ObjectsData, &candList);
+        }
         SelectCandidatesAndCleanupStatsFromPrevTree(ctx, &candList, &perPackMasks, &ctx->PrevTreeLevelStats);
 
         AddSimpleCtrs(*data.Learn->ObjectsData, fold, ctx, &ctx->PrevTreeLevelStats, &candList);
@@ -559,11 +679,10 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
         }
         profile.AddOperation(TStringBuilder() << "Bootstrap, depth " << curDepth);
 
-        const auto scoreStDev =
-            ctx->Params.ObliviousTreeOptions->RandomStrength
-            * CalcDerivativesStDevFromZero(*fold, ctx->Params.BoostingOptions->BoostingType)
-            * CalcDerivativesStDevFromZeroMultiplier(learnSampleCount, modelLength);
+        const auto scoreStDev = CalcScoreStDev(*fold, learnSampleCount, modelLength, *ctx);
         if (!ctx->Params.SystemOptions->IsSingleHost()) {
+            MapCalcOnlineCtrs(data, GetOnlineCtrProjections(candList), ctx);
+            profile.AddOperation(TStringBuilder() << "Calc online ctrs on workers, depth " << curDepth);
             if (isPairwiseScoring) {
                 MapRemotePairwiseCalcScore(scoreStDev, perPackMasks, &candList, ctx);
             } else {
@@ -586,47 +705,20 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
                 ctx);
         }
 
-        size_t maxFeatureValueCount = 1;
-        for (const auto& candidate : candList) {
-            const auto& splitEnsemble = candidate.Candidates[0].SplitEnsemble;
-            if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
-                const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
-                maxFeatureValueCount = Max(maxFeatureValueCount, fold->GetCtrRef(proj).GetMaxUniqueValueCount());
-            }
-        }
+        // in distributed mode master folds have no learn online ctrs, unique values counts are kept in averaging fold
+        TFold* ctrsFold = ctx->Params.SystemOptions->IsSingleHost() ? fold : &ctx->LearnProgress.AveragingFold;
+        const size_t maxFeatureValueCount = CalcMaxFeatureValueCount(*ctrsFold, candList);
 
         fold->DropEmptyCTRs();
+        if (ctx->OnlineCtrCache.HasSizeLimit()) {
+            ShrinkOnlineCtrCache(ctx);
+        }
         CheckInterrupted(); // check after long-lasting operation
         profile.AddOperation(TStringBuilder() << "Calc scores " << curDepth);
 
         const TCandidateInfo* bestSplitCandidate = nullptr;
         double bestScore = MINIMAL_SCORE;
-        for (const auto& subList : candList) {
-            for (const auto& candidate : subList.Candidates) {
-                double score = candidate.BestScore.GetInstance(ctx->Rand);
-                // CATBOOST_INFO_LOG << BuildDescription(ctx->Layout, candidate.SplitCandidate) << " = " << score << "\t";
-
-                const auto& splitEnsemble = candidate.SplitEnsemble;
-                if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
-                    TProjection projection = splitEnsemble.SplitCandidate.Ctr.Projection;
-                    ECtrType ctrType =
-                        ctx->CtrsHelper.GetCtrInfo(projection)[splitEnsemble.SplitCandidate.Ctr.CtrIdx].Type;
-
-                    if (!ctx->LearnProgress.UsedCtrSplits.contains(std::make_pair(ctrType, projection)) &&
-                        score != MINIMAL_SCORE)
-                    {
-                        score *= pow(
-                            1 + fold->GetCtrRef(projection).GetUniqueValueCountForType(ctrType) / static_cast<double>(maxFeatureValueCount),
-                            -ctx->Params.ObliviousTreeOptions->ModelSizeReg.Get()
-                        );
-                    }
-                }
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestSplitCandidate = &candidate;
-                }
-            }
-        }
+        SelectBestCandidate(candList, maxFeatureValueCount, ctrsFold, ctx, &bestScore, &bestSplitCandidate);
         // CATBOOST_INFO_LOG << Endl;
         if (bestScore == MINIMAL_SCORE) {
             break;
@@ -642,9 +734,10 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
         }
         TSplit bestSplit = bestSplitCandidate->GetBestSplit(*data.Learn->ObjectsData);
 
-        if (bestSplit.Type == ESplitType::OnlineCtr) {
+        // in distributed mode learn ctrs of the best split are already computed on workers by MapCalcOnlineCtrs
+        if (bestSplit.Type == ESplitType::OnlineCtr && ctx->Params.SystemOptions->IsSingleHost()) {
             const auto& proj = bestSplit.Ctr.Projection;
-            if (fold->GetCtrRef(proj).Feature.empty()) {
+            if (!ctx->OnlineCtrCache.Acquire(&fold->GetCtrRef(proj))) {
                 ComputeOnlineCTRs(data,
                                   *fold,
                                   proj,
@@ -665,7 +758,6 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
                 }
             }
         } else {
-            Y_ASSERT(bestSplit.Type != ESplitType::OnlineCtr);
             MapSetIndices(bestSplit, ctx);
         }
         currentSplitTree.AddSplit(bestSplit);
@@ -687,3 +779,302 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
     }
     *resSplitTree = std::move(currentSplitTree);
 }
+
+static void CalcBestScoresForLeaves(
+    const TTrainingForCPUDataProviders& data,
+    int statsDepth,
+    TConstArrayRef<int> leaves,
+    TConstArrayRef<ui64> leafRandSeeds,
+    double scoreStDev,
+    TConstArrayRef<TBinaryFeaturesPack> perPackMasks,
+    int baseCandidateCount,
+    TConstArrayRef<TLeafSplitInfo> lastSplits,
+    bool areLeafStatsActual,
+    const TCandidateList& candList,
+    THashMap<TSplitEnsemble, TStats3D>* leafStats, // stats of base candidates from previous step, can be nullptr
+    TFold* fold,
+    TLearnContext* ctx,
+    TVector<TCandidateList>* leafCandLists) {
+
+    const TFlatPairsInfo pairs;
+    const bool isRoot = lastSplits.empty();
+    leafCandLists->assign(leaves.size(), TCandidateList(candList.size()));
+    ctx->LocalExecutor->ExecRange([&](int id) {
+        const auto& candidate = candList[id];
+        const bool useLeafStats = leafStats && id < baseCandidateCount;
+
+        const auto& splitEnsemble = candidate.Candidates[0].SplitEnsemble;
+        if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
+            const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
+            if (!ctx->OnlineCtrCache.Acquire(&fold->GetCtrRef(proj))) {
+                ComputeOnlineCTRs(data,
+                                  *fold,
+                                  proj,
+                                  ctx,
+                                  &fold->GetCtrRef(proj));
+            }
+        }
+        TVector<TVector<TVector<double>>> leafAllScores(leaves.size(), TVector<TVector<double>>(candidate.Candidates.size()));
+        ctx->LocalExecutor->ExecRange([&](int oneCandidate) {
+            const auto& splitEnsemble = candidate.Candidates[oneCandidate].SplitEnsemble;
+            const auto calcStats = [&] (const TCalcScoreFold& docs, TStats3D* stats3d) {
+                CalcStatsAndScores(*data.Learn->ObjectsData,
+                                   fold->GetAllCtrs(),
+                                   docs,
+                                   /*prevLevelData*/docs,
+                                   fold,
+                                   pairs,
+                                   ctx->Params,
+                                   splitEnsemble,
+                                   statsDepth,
+                                   /*useTreeLevelCaching*/false,
+                                   ctx->LocalExecutor,
+                                   &ctx->PrevTreeLevelStats,
+                                   stats3d,
+                                   /*pairwiseStats*/nullptr,
+                                   /*scoreBins*/nullptr);
+            };
+
+            TStats3D localStats;
+            TStats3D* stats3d = &localStats;
+            if (useLeafStats) {
+                stats3d = &leafStats->at(splitEnsemble);
+                if (isRoot || !areLeafStatsActual) {
+                    calcStats(ctx->SampledDocs, stats3d);
+                } else {
+                    TStats3D smallerChildrenStats;
+                    calcStats(ctx->SmallestSplitSideDocs, &smallerChildrenStats);
+                    stats3d->UpdateWithLeafSplits(lastSplits, smallerChildrenStats);
+                }
+            } else {
+                calcStats(isRoot ? ctx->SampledDocs : ctx->NewLeavesDocs, stats3d);
+            }
+            for (auto leafPos : xrange(leaves.size())) {
+                CalcScoresForLeaf(*stats3d, leaves[leafPos], *fold, ctx->Params, &leafAllScores[leafPos][oneCandidate]);
+            }
+        }, NPar::TLocalExecutor::TExecRangeParams(0, candidate.Candidates.ysize())
+         , NPar::TLocalExecutor::WAIT_COMPLETE);
+        if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr) && candidate.ShouldDropCtrAfterCalc) {
+            fold->GetCtrRef(splitEnsemble.SplitCandidate.Ctr.Projection).Feature.clear();
+        }
+        for (auto leafPos : xrange(leaves.size())) {
+            auto& leafCandidate = (*leafCandLists)[leafPos][id];
+            leafCandidate = candidate;
+            SetBestScore(leafRandSeeds[leafPos] + id, leafAllScores[leafPos], scoreStDev, perPackMasks, &leafCandidate.Candidates);
+        }
+    }, 0, candList.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+/* Grows a non-symmetric tree: each step evaluates leaves created by the previous step and
+ * splits either all of them (Levelwise) or the single leaf with the best score (Lossguide).
+ * Scores of leaves that were not split are kept, so lossguide evaluates every leaf once.
+ */
+static void GreedyTensorSearchNonSymmetric(const TTrainingForCPUDataProviders& data,
+                                           double modelLength,
+                                           TProfileInfo& profile,
+                                           TFold* fold,
+                                           TLearnContext* ctx,
+                                           TNonSymmetricTreeStructure* resTree) {
+    CB_ENSURE(ctx->Params.SystemOptions->IsSingleHost(), "Non-symmetric trees are supported only in single host mode");
+
+    TNonSymmetricTreeStructure currentTree;
+    TrimOnlineCTRcache({fold}, ctx);
+
+    const ui32 learnSampleCount = data.Learn->ObjectsData->GetObjectCount();
+    const ui32 testSampleCount = data.GetTestSampleCount();
+    TVector<TIndexType> indices(learnSampleCount); // leaf indices, always for all documents
+    CATBOOST_INFO_LOG << "\n";
+
+    Bootstrap(ctx->Params, indices, fold, &ctx->SampledDocs, ctx->LocalExecutor, &ctx->Rand);
+    profile.AddOperation("Bootstrap");
+
+    const auto& treeOptions = ctx->Params.ObliviousTreeOptions.Get();
+    const bool isLossguide = treeOptions.GrowingPolicy == EGrowingPolicy::Lossguide;
+    const int maxDepth = treeOptions.MaxDepth;
+    const int maxLeafCount = isLossguide ? (int)treeOptions.MaxLeavesCount : (1 << maxDepth);
+    const auto scoreStDev = CalcScoreStDev(*fold, learnSampleCount, modelLength, *ctx);
+
+    // candidates that don't depend on the tree structure are selected once per tree
+    TCandidateList baseCandList;
+    TVector<TBinaryFeaturesPack> perPackMasks;
+    AddFloatFeatures(
+        *data.Learn->ObjectsData,
+        &baseCandList);
+    AddOneHotFeatures(
+        *data.Learn->ObjectsData,
+        ctx,
+        &baseCandList);
+    CompressCandidatesWithBinaryFeatures(*data.Learn->ObjectsData, &baseCandList, &perPackMasks);
+    if (!IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction())) {
+        CompressCandidatesWithExclusiveFeatureBundles(*data.Learn->ObjectsData, &baseCandList);
+    }
+    SelectCandidatesAndCleanupStatsFromPrevTree(ctx, &baseCandList, &perPackMasks, &ctx->PrevTreeLevelStats);
+    AddSimpleCtrs(*data.Learn->ObjectsData, fold, ctx, &ctx->PrevTreeLevelStats, &baseCandList);
+
+    THashMap<TSplitEnsemble, TStats3D> leafStats;
+    if (ctx->ReuseLeafStats()) {
+        for (const auto& candSubList : baseCandList) {
+            for (const auto& candidate : candSubList.Candidates) {
+                leafStats[candidate.SplitEnsemble];
+            }
+        }
+    }
+    bool areLeafStatsActual = false;
+
+    TVector<int> leafDepths = {0};
+    TVector<double> leafBestScores = {MINIMAL_SCORE};
+    TVector<TSplit> leafBestSplits(1);
+    TVector<int> leavesToEvaluate = {0};
+    TVector<TLeafSplitInfo> lastSplits;
+
+    for (int step = 0; ; ++step) {
+        if (!leavesToEvaluate.empty()) {
+            TCandidateList candList = baseCandList;
+            AddTreeCtrs(*data.Learn->ObjectsData, currentTree, fold, ctx, &ctx->PrevTreeLevelStats, &candList);
+
+            auto IsInCache = [&fold](const TProjection& proj) -> bool {return fold->GetCtrRef(proj).Feature.empty();};
+            auto cpuUsedRamLimit = ParseMemorySizeDescription(ctx->Params.SystemOptions->CpuUsedRamLimit.Get());
+            SelectCtrsToDropAfterCalc(cpuUsedRamLimit, learnSampleCount + testSampleCount, ctx->Params.SystemOptions->NumThreads, IsInCache, &candList);
+
+            const int leafCount = currentTree.GetLeafCount();
+            const int statsDepth = leafCount > 1 ? GetValueBitCount(leafCount - 1) : 0;
+            TVector<TCandidateList> leafCandLists;
+            CalcBestScoresForLeaves(
+                data,
+                statsDepth,
+                leavesToEvaluate,
+                GenRandUI64Vector(leavesToEvaluate.ysize(), ctx->Rand.GenRand()),
+                scoreStDev,
+                perPackMasks,
+                baseCandList.ysize(),
+                lastSplits,
+                areLeafStatsActual,
+                candList,
+                ctx->ReuseLeafStats() ? &leafStats : nullptr,
+                fold,
+                ctx,
+                &leafCandLists);
+            areLeafStatsActual = true;
+
+            const size_t maxFeatureValueCount = CalcMaxFeatureValueCount(*fold, candList);
+
+            fold->DropEmptyCTRs();
+            if (ctx->OnlineCtrCache.HasSizeLimit()) {
+                ShrinkOnlineCtrCache(ctx);
+            }
+            CheckInterrupted(); // check after long-lasting operation
+            profile.AddOperation(TStringBuilder() << "Calc scores, step " << step);
+
+            for (auto leafPos : xrange(leavesToEvaluate.size())) {
+                const TCandidateInfo* bestSplitCandidate = nullptr;
+                double bestScore = MINIMAL_SCORE;
+                SelectBestCandidate(leafCandLists[leafPos], maxFeatureValueCount, fold, ctx, &bestScore, &bestSplitCandidate);
+                const int leaf = leavesToEvaluate[leafPos];
+                leafBestScores[leaf] = bestScore;
+                if (bestSplitCandidate != nullptr) {
+                    leafBestSplits[leaf] = bestSplitCandidate->GetBestSplit(*data.Learn->ObjectsData);
+                }
+            }
+        } else {
+            areLeafStatsActual = false;
+        }
+
+        TVector<int> leavesToSplit;
+        if (isLossguide) {
+            const auto bestLeaf = MaxElement(leafBestScores.begin(), leafBestScores.end()) - leafBestScores.begin();
+            if (currentTree.GetLeafCount() < maxLeafCount && leafBestScores[bestLeaf] != MINIMAL_SCORE) {
+                leavesToSplit.push_back(bestLeaf);
+            }
+        } else {
+            for (int leaf : leavesToEvaluate) {
+                if (leafBestScores[leaf] != MINIMAL_SCORE) {
+                    leavesToSplit.push_back(leaf);
+                }
+            }
+        }
+        if (leavesToSplit.empty()) {
+            break;
+        }
+
+        TVector<int> leafSplitNodes(currentTree.GetLeafCount(), -1);
+        lastSplits.clear();
+        for (int leaf : leavesToSplit) {
+            const TSplit& split = leafBestSplits[leaf];
+            if (split.Type == ESplitType::OnlineCtr) {
+                const auto& proj = split.Ctr.Projection;
+                ECtrType ctrType = ctx->CtrsHelper.GetCtrInfo(proj)[split.Ctr.CtrIdx].Type;
+                ctx->LearnProgress.UsedCtrSplits.insert(std::make_pair(ctrType, proj));
+                if (!ctx->OnlineCtrCache.Acquire(&fold->GetCtrRef(proj))) {
+                    ComputeOnlineCTRs(data,
+                                      *fold,
+                                      proj,
+                                      ctx,
+                                      &fold->GetCtrRef(proj));
+                }
+            }
+            CATBOOST_INFO_LOG << BuildDescription(*ctx->Layout, split) << " score " << leafBestScores[leaf] << "\n";
+
+            TLeafSplitInfo& leafSplit = lastSplits.emplace_back();
+            leafSplit.Leaf = leaf;
+            leafSplit.NewLeaf = currentTree.GetLeafCount();
+            leafSplitNodes[leaf] = currentTree.Nodes.ysize();
+            currentTree.SplitLeaf(leaf, split);
+        }
+
+        UpdateIndicesWithLeafSplits(currentTree, leafSplitNodes, *data.Learn->ObjectsData, *fold, &indices, ctx->LocalExecutor);
+        ctx->SampledDocs.UpdateIndices(indices, ctx->LocalExecutor);
+
+        const int leafCount = currentTree.GetLeafCount();
+        TVector<int> sampledDocCounts(leafCount, 0);
+        for (auto docIdx : xrange(ctx->SampledDocs.GetDocCount())) {
+            ++sampledDocCounts[ctx->SampledDocs.Indices[docIdx]];
+        }
+
+        leafDepths.resize(leafCount);
+        leafBestScores.resize(leafCount, MINIMAL_SCORE);
+        leafBestSplits.resize(leafCount);
+        leavesToEvaluate.clear();
+        TVector<bool> isNewLeaf(leafCount, false);
+        TVector<bool> isSmallerChild(leafCount, false);
+        for (auto& leafSplit : lastSplits) {
+            leafSplit.IsNewLeafSmaller = sampledDocCounts[leafSplit.NewLeaf] < sampledDocCounts[leafSplit.Leaf];
+            isSmallerChild[leafSplit.IsNewLeafSmaller ? leafSplit.NewLeaf : leafSplit.Leaf] = true;
+
+            const int depth = leafDepths[leafSplit.Leaf] + 1;
+            for (int leaf : {leafSplit.Leaf, leafSplit.NewLeaf}) {
+                leafDepths[leaf] = depth;
+                leafBestScores[leaf] = MINIMAL_SCORE;
+                if (depth < maxDepth) {
+                    leavesToEvaluate.push_back(leaf);
+                    isNewLeaf[leaf] = true;
+                }
+            }
+        }
+        if (!leavesToEvaluate.empty()) {
+            ctx->NewLeavesDocs.SelectLeaves(isNewLeaf, ctx->SampledDocs, ctx->LocalExecutor);
+            if (ctx->ReuseLeafStats() && areLeafStatsActual) {
+                ctx->SmallestSplitSideDocs.SelectLeaves(isSmallerChild, ctx->SampledDocs, ctx->LocalExecutor);
+            }
+        }
+
+        profile.AddOperation(TStringBuilder() << "Select best splits, step " << step);
+    }
+    *resTree = std::move(currentTree);
+}
+
+void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
+                        double modelLength,
+                        TProfileInfo& profile,
+                        TFold* fold,
+                        TLearnContext* ctx,
+                        TTreeStructure* resTreeStructure) {
+    if (ctx->Params.ObliviousTreeOptions->GrowingPolicy == EGrowingPolicy::ObliviousTree) {
+        TSplitTree splitTree;
+        GreedyTensorSearchOblivious(data, modelLength, profile, fold, ctx, &splitTree);
+        *resTreeStructure = std::move(splitTree);
+    } else {
+        TNonSymmetricTreeStructure nonSymmetricTree;
+        GreedyTensorSearchNonSymmetric(data, modelLength, profile, fold, ctx, &nonSymmetricTree);
+        *resTreeStructure = std::move(nonSymmetricTree);
+    }
+}
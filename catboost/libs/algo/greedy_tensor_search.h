@@ -2,16 +2,18 @@
 
 #include "fold.h"
 #include "learn_context.h"
+#include "split.h"
 
 #include <catboost/libs/data_new/data_provider.h>
 
 #include <util/generic/vector.h>
 
-void TrimOnlineCTRcache(const TVector<TFold*>& folds);
+// ctx is nullptr on distributed workers, they do not use online ctr cache size limit
+void TrimOnlineCTRcache(const TVector<TFold*>& folds, TLearnContext* ctx = nullptr);
 
 void GreedyTensorSearch(const NCB::TTrainingForCPUDataProviders& data,
                         double modelLength,
                         TProfileInfo& profile,
                         TFold* fold,
                         TLearnContext* ctx,
-                        TSplitTree* resSplitTree);
+                        TTreeStructure* resTreeStructure);
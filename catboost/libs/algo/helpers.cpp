@@ -3,6 +3,7 @@
 #include <catboost/libs/distributed/master.h>
 #include <catboost/libs/logging/logging.h>
 
+#include <library/chromium_trace/interface.h>
 #include <library/malloc/api/malloc.h>
 
 #include <functional>
@@ -86,6 +87,8 @@ void CalcErrors(
     bool calcErrorTrackerMetric,
     TLearnContext* ctx
 ) {
+    CHROMIUM_TRACE_SCOPE("Calc errors");
+
     if (trainingDataProviders.Learn->GetObjectCount() > 0) {
         ctx->LearnProgress.MetricsAndTimeHistory.LearnMetricsHistory.emplace_back();
         if (calcAllMetrics) {
@@ -19,11 +19,10 @@
 using namespace NCB;
 
 
-static bool GetCtrSplit(const TSplit& split, int idxPermuted, const TOnlineCTR& ctr) {
-    ui8 ctrValue = ctr.Feature[split.Ctr.CtrIdx]
-                              [split.Ctr.TargetBorderIdx]
-                              [split.Ctr.PriorIdx]
-                              [idxPermuted];
+// ctrValues is an accessor to online ctr values, see TOnlineCTR::VisitValues
+template <class TCtrValues>
+static inline bool GetCtrSplit(const TSplit& split, int idxPermuted, TCtrValues ctrValues) {
+    ui8 ctrValue = ctrValues[idxPermuted];
     return ctrValue > split.BinBorder;
 }
 
@@ -31,11 +30,20 @@ static inline ui8 GetFeatureSplitIdx(const TSplit& split) {
     return split.BinBorder;
 }
 
-static inline const ui8* GetFloatHistogram(
+/* f is called with an accessor to float feature values (see VisitFloatFeatureRawSrcData)
+ * or with nullptr if the feature is binary packed
+ */
+template <class TFunc>
+static inline void VisitFloatHistogram(
     const TSplit& split,
-    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider) {
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    TFunc&& f) {
 
-    return *(*objectsDataProvider.GetNonPackedFloatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc();
+    if (objectsDataProvider.IsFeaturePackedBinary(TFloatFeatureIdx((ui32)split.FeatureIdx))) {
+        f((const ui8*)nullptr);
+    } else {
+        objectsDataProvider.VisitFloatFeatureRawSrcData((ui32)split.FeatureIdx, f);
+    }
 }
 
 static inline const ui32* GetRemappedCatFeatures(
@@ -45,10 +53,11 @@ static inline const ui32* GetRemappedCatFeatures(
     return *(*objectsDataProvider.GetNonPackedCatFeature((ui32)split.FeatureIdx))->GetArrayData().GetSrc();
 }
 
-template <typename TCount, typename TCmpOp, int vectorWidth>
+// THistogram is a pointer or an accessor to bit-packed values (TPackedQuantizedValuesRef)
+template <typename THistogram, typename TCmpOp, int vectorWidth>
 inline void BuildIndicesKernel(
     const ui32* permutation,
-    const TCount* histogram,
+    THistogram histogram,
     TCmpOp cmpOp,
     int level,
     TIndexType* indices) {
@@ -58,10 +67,10 @@ inline void BuildIndicesKernel(
     const ui32 perm1 = permutation[1];
     const ui32 perm2 = permutation[2];
     const ui32 perm3 = permutation[3];
-    const TCount hist0 = histogram[perm0];
-    const TCount hist1 = histogram[perm1];
-    const TCount hist2 = histogram[perm2];
-    const TCount hist3 = histogram[perm3];
+    const auto hist0 = histogram[perm0];
+    const auto hist1 = histogram[perm1];
+    const auto hist2 = histogram[perm2];
+    const auto hist3 = histogram[perm3];
     const TIndexType idx0 = indices[0];
     const TIndexType idx1 = indices[1];
     const TIndexType idx2 = indices[2];
@@ -73,12 +82,12 @@ inline void BuildIndicesKernel(
 }
 
 
-template <typename TCount, typename TCmpOp>
+template <typename THistogram, typename TCmpOp>
 inline void OfflineCtrBlock(
     const NPar::TLocalExecutor::TExecRangeParams& params,
     int blockIdx,
     const ui32* permutation,
-    const TCount* histogram,
+    THistogram histogram,
     TCmpOp cmpOp,
     int level,
     TIndexType* indices) {
@@ -88,7 +97,7 @@ inline void OfflineCtrBlock(
     constexpr int vectorWidth = 4;
     int doc;
     for (doc = blockStart; doc + vectorWidth <= nextBlockStart; doc += vectorWidth) {
-        BuildIndicesKernel<TCount, TCmpOp, vectorWidth>(permutation + doc, histogram, cmpOp, level, indices + doc);
+        BuildIndicesKernel<THistogram, TCmpOp, vectorWidth>(permutation + doc, histogram, cmpOp, level, indices + doc);
     }
     for (; doc < nextBlockStart; ++doc) {
         const int idxOriginal = permutation[doc];
@@ -96,13 +105,13 @@ inline void OfflineCtrBlock(
     }
 }
 
-template <typename TCount, class TCmpOp>
+template <typename THistogram, class TCmpOp>
 inline void OfflineCtrBlock(
     const NPar::TLocalExecutor::TExecRangeParams& params,
     int blockIdx,
     TMaybe<TPackedBinaryIndex> maybeBinaryIndex,
     const ui32* permutation,
-    const TCount* histogram, // can be nullptr if maybeBinaryIndex
+    THistogram histogram, // can be nullptr if maybeBinaryIndex
     std::function<TPackedBinaryFeaturesArraySubset(ui32)>&& getBinaryFeaturesPack,
     TCmpOp cmpOp,
     int level,
@@ -155,39 +164,47 @@ void SetPermutedIndices(
     TIndexType* indicesData = indices->data();
     if (split.Type == ESplitType::FloatFeature) {
         auto floatFeatureIdx = TFloatFeatureIdx((ui32)split.FeatureIdx);
-
-        const ui8* histogram = nullptr;
         auto maybeBinaryIndex = objectsDataProvider.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx);
-        if (!maybeBinaryIndex) {
-            histogram = GetFloatHistogram(split, objectsDataProvider);
-        }
 
-        localExecutor->ExecRange(
-            [&](int blockIdx) {
-                OfflineCtrBlock(
-                    blockParams,
-                    blockIdx,
-                    maybeBinaryIndex,
-                    fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
-                    histogram,
-                    [&] (ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
-                    [splitIdx = GetFeatureSplitIdx(split)] (ui8 bucket) {
-                        return IsTrueHistogram(bucket, splitIdx);
+        VisitFloatHistogram(
+            split,
+            objectsDataProvider,
+            [&] (auto histogramRef) {
+                localExecutor->ExecRange(
+                    [&](int blockIdx) {
+                        OfflineCtrBlock(
+                            blockParams,
+                            blockIdx,
+                            maybeBinaryIndex,
+                            fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
+                            histogramRef,
+                            [&] (ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
+                            [splitIdx = GetFeatureSplitIdx(split)] (ui8 bucket) {
+                                return IsTrueHistogram(bucket, splitIdx);
+                            },
+                            splitWeight,
+                            indicesData);
                     },
-                    splitWeight,
-                    indicesData);
-            },
-            0,
-            blockParams.GetBlockCount(),
-            NPar::TLocalExecutor::WAIT_COMPLETE);
+                    0,
+                    blockParams.GetBlockCount(),
+                    NPar::TLocalExecutor::WAIT_COMPLETE);
+            }
+        );
     } else if (split.Type == ESplitType::OnlineCtr) {
         auto& ctr = fold.GetCtr(split.Ctr.Projection);
-        localExecutor->ExecRange(
-            [&] (int i) {
-                indicesData[i] += GetCtrSplit(split, i, ctr) * splitWeight;
-            },
-            blockParams,
-            NPar::TLocalExecutor::WAIT_COMPLETE);
+        ctr.VisitValues(
+            split.Ctr.CtrIdx,
+            split.Ctr.TargetBorderIdx,
+            split.Ctr.PriorIdx,
+            [&] (auto ctrValues) {
+                localExecutor->ExecRange(
+                    [&] (int i) {
+                        indicesData[i] += GetCtrSplit(split, i, ctrValues) * splitWeight;
+                    },
+                    blockParams,
+                    NPar::TLocalExecutor::WAIT_COMPLETE);
+            }
+        );
     } else {
         Y_ASSERT(split.Type == ESplitType::OneHotFeature);
 
@@ -220,6 +237,131 @@ void SetPermutedIndices(
     }
 }
 
+namespace {
+    // Split of a non-symmetric tree node with pointers to data needed to evaluate it
+    struct TNodeSplitData {
+        ESplitType Type = ESplitType::FloatFeature;
+        ui32 SplitIdx = 0;
+        const ui8* FloatHistogram = nullptr;
+        ui32 FloatHistogramBitsPerKey = CHAR_BIT;
+        const TExclusiveFeaturesBundleValue* FloatFeaturesBundle = nullptr;
+        TBoundsInBundle BoundsInBundle;
+        const ui32* RemappedCatHistogram = nullptr;
+        const TBinaryFeaturesPack* BinaryFeaturesPacks = nullptr;
+        ui8 BitIdx = 0;
+        const ui8* CtrValues = nullptr;
+        ui32 CtrValuesBitsPerKey = CHAR_BIT;
+    };
+}
+
+static TNodeSplitData GetNodeSplitData(
+    const TSplit& split,
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TOnlineCTR* onlineCtr) {
+
+    TNodeSplitData splitData;
+    splitData.Type = split.Type;
+    splitData.SplitIdx = (ui32)split.BinBorder;
+
+    TMaybe<TPackedBinaryIndex> maybeBinaryIndex;
+    if (split.Type == ESplitType::FloatFeature) {
+        const auto floatFeatureIdx = TFloatFeatureIdx((ui32)split.FeatureIdx);
+        maybeBinaryIndex = objectsDataProvider.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx);
+        auto maybeBundleIndex = objectsDataProvider.GetFloatFeatureToExclusiveBundleIndex(floatFeatureIdx);
+        if (maybeBundleIndex) {
+            splitData.FloatFeaturesBundle
+                = (**objectsDataProvider.GetExclusiveFeaturesBundle(maybeBundleIndex->BundleIdx).GetSrc()).data();
+            splitData.BoundsInBundle
+                = objectsDataProvider.GetExclusiveFeatureBundlesMetaData()[maybeBundleIndex->BundleIdx]
+                    .Parts[maybeBundleIndex->InBundleIdx].Bounds;
+        } else if (!maybeBinaryIndex) {
+            splitData.FloatHistogram
+                = (*objectsDataProvider.GetNonPackedFloatFeature(*floatFeatureIdx))->GetRawSrcData();
+            splitData.FloatHistogramBitsPerKey = objectsDataProvider.GetFloatFeatureBitsPerKey(*floatFeatureIdx);
+        }
+    } else if (split.Type == ESplitType::OneHotFeature) {
+        maybeBinaryIndex = objectsDataProvider.GetCatFeatureToPackedBinaryIndex(TCatFeatureIdx((ui32)split.FeatureIdx));
+        if (!maybeBinaryIndex) {
+            splitData.RemappedCatHistogram = GetRemappedCatFeatures(split, objectsDataProvider);
+        }
+    } else {
+        Y_ASSERT(split.Type == ESplitType::OnlineCtr);
+        Y_ASSERT(onlineCtr != nullptr);
+        splitData.CtrValues = onlineCtr->GetRawValues(split.Ctr.CtrIdx, split.Ctr.TargetBorderIdx, split.Ctr.PriorIdx);
+        splitData.CtrValuesBitsPerKey = onlineCtr->BitsPerKey[split.Ctr.CtrIdx];
+    }
+    if (maybeBinaryIndex) {
+        splitData.BinaryFeaturesPacks
+            = (**objectsDataProvider.GetBinaryFeaturesPack(maybeBinaryIndex->PackIdx).GetSrc()).data();
+        splitData.BitIdx = maybeBinaryIndex->BitIdx;
+    }
+    return splitData;
+}
+
+// permutation is used for features data, online ctrs are indexed by doc + docOffset
+static inline bool IsTrueSplit(const TNodeSplitData& splitData, const ui32* permutation, int doc, int docOffset) {
+    if (splitData.Type == ESplitType::OnlineCtr) {
+        return GetQuantizedValue(splitData.CtrValues, splitData.CtrValuesBitsPerKey, doc + docOffset) > splitData.SplitIdx;
+    }
+    const ui32 idxOriginal = permutation[doc];
+    if (splitData.BinaryFeaturesPacks != nullptr) {
+        const ui8 bit = (splitData.BinaryFeaturesPacks[idxOriginal] >> splitData.BitIdx) & 1;
+        return splitData.Type == ESplitType::FloatFeature ?
+            IsTrueHistogram(bit, (ui8)splitData.SplitIdx)
+            : IsTrueOneHotFeature(bit, splitData.SplitIdx);
+    }
+    if (splitData.FloatFeaturesBundle != nullptr) {
+        return IsTrueHistogram(
+            GetBinFromBundle(splitData.FloatFeaturesBundle[idxOriginal], splitData.BoundsInBundle),
+            (ui8)splitData.SplitIdx);
+    }
+    if (splitData.Type == ESplitType::FloatFeature) {
+        return IsTrueHistogram(
+            GetQuantizedValue(splitData.FloatHistogram, splitData.FloatHistogramBitsPerKey, idxOriginal),
+            (ui8)splitData.SplitIdx);
+    }
+    Y_ASSERT(splitData.Type == ESplitType::OneHotFeature);
+    return IsTrueOneHotFeature(splitData.RemappedCatHistogram[idxOriginal], splitData.SplitIdx);
+}
+
+void UpdateIndicesWithLeafSplits(
+    const TNonSymmetricTreeStructure& tree,
+    TConstArrayRef<int> leafSplitNodes,
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TFold& fold,
+    TVector<TIndexType>* indices,
+    NPar::TLocalExecutor* localExecutor) {
+
+    // only nodes applied now are evaluated, online ctrs of other nodes can be already dropped from fold
+    TVector<TNodeSplitData> leafSplitsData(leafSplitNodes.size());
+    for (auto leafIdx : xrange(leafSplitNodes.size())) {
+        const int nodeIdx = leafSplitNodes[leafIdx];
+        if (nodeIdx < 0) {
+            continue;
+        }
+        const auto& split = tree.Nodes[nodeIdx].Split;
+        const TOnlineCTR* onlineCtr = split.Type == ESplitType::OnlineCtr ? &fold.GetCtr(split.Ctr.Projection) : nullptr;
+        leafSplitsData[leafIdx] = GetNodeSplitData(split, objectsDataProvider, onlineCtr);
+    }
+
+    const int blockSize = 1000;
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, indices->ysize());
+    blockParams.SetBlockSize(blockSize);
+
+    const ui32* permutation = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
+    TIndexType* indicesData = indices->data();
+    localExecutor->ExecRange(
+        [&] (int doc) {
+            const TIndexType leafIdx = indicesData[doc];
+            const int nodeIdx = leafSplitNodes[leafIdx];
+            if (nodeIdx >= 0 && IsTrueSplit(leafSplitsData[leafIdx], permutation, doc, /*docOffset*/ 0)) {
+                indicesData[doc] = ~tree.Nodes[nodeIdx].Right;
+            }
+        },
+        blockParams,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 TVector<bool> GetIsLeafEmpty(int curDepth, const TVector<TIndexType>& indices) {
     TVector<bool> isLeafEmpty(1 << curDepth, true);
     for (const auto& idx : indices) {
@@ -261,6 +403,22 @@ static TVector<const TOnlineCTR*> GetOnlineCtrs(const TFold& fold, const TSplitT
     return onlineCtrs;
 }
 
+static const ui32* GetPermutation(
+    const NCB::TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<ui32>* permutationStorage) {
+
+    if (HoldsAlternative<TIndexedSubset<ui32>>(featuresArraySubsetIndexing)) {
+        return featuresArraySubsetIndexing.Get<TIndexedSubset<ui32>>().data();
+    }
+    permutationStorage->yresize(featuresArraySubsetIndexing.Size());
+    featuresArraySubsetIndexing.ParallelForEach(
+        [&](ui32 idx, ui32 srcIdx) { (*permutationStorage)[idx] = srcIdx; },
+        localExecutor
+    );
+    return permutationStorage->data();
+}
+
 static void BuildIndicesForDataset(
     const TSplitTree& tree,
     const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
@@ -271,37 +429,20 @@ static void BuildIndicesForDataset(
     NPar::TLocalExecutor* localExecutor,
     TIndexType* indices) {
 
-    const ui32* permutation = nullptr;
     TVector<ui32> permutationStorage;
-    if (HoldsAlternative<TIndexedSubset<ui32>>(featuresArraySubsetIndexing)) {
-        permutation = featuresArraySubsetIndexing.Get<TIndexedSubset<ui32>>().data();
-    } else {
-        permutationStorage.yresize(featuresArraySubsetIndexing.Size());
-        featuresArraySubsetIndexing.ParallelForEach(
-            [&](ui32 idx, ui32 srcIdx) { permutationStorage[idx] = srcIdx; },
-            localExecutor
-        );
-        permutation = permutationStorage.data();
-    }
+    const ui32* permutation = GetPermutation(featuresArraySubsetIndexing, localExecutor, &permutationStorage);
 
     const int blockSize = 1000;
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, (int)sampleCount);
     blockParams.SetBlockSize(blockSize);
 
     // precalc to avoid recalculation in each block
-    TStackVec<const ui8*> splitFloatHistograms;
-    splitFloatHistograms.yresize(tree.GetDepth());
-
     TStackVec<const ui32*> splitRemappedCatHistograms;
     splitRemappedCatHistograms.yresize(tree.GetDepth());
 
     for (auto splitIdx : xrange(tree.GetDepth())) {
         const auto& split = tree.Splits[splitIdx];
-        if (split.Type == ESplitType::FloatFeature) {
-            if (!objectsDataProvider.IsFeaturePackedBinary(TFloatFeatureIdx((ui32)split.FeatureIdx))) {
-                splitFloatHistograms[splitIdx] = GetFloatHistogram(split, objectsDataProvider);
-            }
-        } else if (split.Type == ESplitType::OneHotFeature) {
+        if (split.Type == ESplitType::OneHotFeature) {
             if (!objectsDataProvider.IsFeaturePackedBinary(TCatFeatureIdx((ui32)split.FeatureIdx))) {
                 splitRemappedCatHistograms[splitIdx] = GetRemappedCatFeatures(split, objectsDataProvider);
             }
@@ -316,26 +457,39 @@ static void BuildIndicesForDataset(
             if (split.Type == ESplitType::FloatFeature) {
                 auto floatFeatureIdx = TFloatFeatureIdx((ui32)split.FeatureIdx);
 
-                OfflineCtrBlock(
-                    blockParams,
-                    blockIdx,
-                    objectsDataProvider.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx),
-                    permutation,
-                    splitFloatHistograms[splitIdx],
-                    [&] (ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
-                    [splitIdx = GetFeatureSplitIdx(split)] (ui8 bucket) {
-                        return IsTrueHistogram(bucket, splitIdx);
-                    },
-                    splitWeight,
-                    indices);
+                VisitFloatHistogram(
+                    split,
+                    objectsDataProvider,
+                    [&] (auto histogram) {
+                        OfflineCtrBlock(
+                            blockParams,
+                            blockIdx,
+                            objectsDataProvider.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx),
+                            permutation,
+                            histogram,
+                            [&] (ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
+                            [splitIdx = GetFeatureSplitIdx(split)] (ui8 bucket) {
+                                return IsTrueHistogram(bucket, splitIdx);
+                            },
+                            splitWeight,
+                            indices);
+                    }
+                );
             } else if (split.Type == ESplitType::OnlineCtr) {
                 const TOnlineCTR& splitOnlineCtr = *onlineCtrs[splitIdx];
-                NPar::TLocalExecutor::BlockedLoopBody(
-                    blockParams,
-                    [&](int doc) {
-                        indices[doc] += GetCtrSplit(split, doc + docOffset, splitOnlineCtr) * splitWeight;
+                splitOnlineCtr.VisitValues(
+                    split.Ctr.CtrIdx,
+                    split.Ctr.TargetBorderIdx,
+                    split.Ctr.PriorIdx,
+                    [&] (auto ctrValues) {
+                        NPar::TLocalExecutor::BlockedLoopBody(
+                            blockParams,
+                            [&](int doc) {
+                                indices[doc] += GetCtrSplit(split, doc + docOffset, ctrValues) * splitWeight;
+                            }
+                        )(blockIdx);
                     }
-                )(blockIdx);
+                );
             } else {
                 Y_ASSERT(split.Type == ESplitType::OneHotFeature);
 
@@ -364,9 +518,61 @@ static void BuildIndicesForDataset(
         NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
-TVector<TIndexType> BuildIndices(
+static void BuildIndicesForDataset(
+    const TNonSymmetricTreeStructure& tree,
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const NCB::TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
+    ui32 sampleCount,
+    const TVector<const TOnlineCTR*>& onlineCtrs,
+    int docOffset,
+    NPar::TLocalExecutor* localExecutor,
+    TIndexType* indices) {
+
+    if (tree.Nodes.empty()) {
+        return;
+    }
+
+    TVector<ui32> permutationStorage;
+    const ui32* permutation = GetPermutation(featuresArraySubsetIndexing, localExecutor, &permutationStorage);
+
+    TVector<TNodeSplitData> nodesData;
+    nodesData.reserve(tree.Nodes.size());
+    for (auto nodeIdx : xrange(tree.Nodes.size())) {
+        nodesData.push_back(GetNodeSplitData(tree.Nodes[nodeIdx].Split, objectsDataProvider, onlineCtrs[nodeIdx]));
+    }
+
+    const int blockSize = 1000;
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, (int)sampleCount);
+    blockParams.SetBlockSize(blockSize);
+
+    localExecutor->ExecRange(
+        [&] (int doc) {
+            int nodeIdx = 0;
+            while (nodeIdx >= 0) {
+                const auto& node = tree.Nodes[nodeIdx];
+                nodeIdx = IsTrueSplit(nodesData[nodeIdx], permutation, doc, docOffset) ? node.Right : node.Left;
+            }
+            indices[doc] = ~nodeIdx;
+        },
+        blockParams,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+static TVector<const TOnlineCTR*> GetOnlineCtrs(const TFold& fold, const TNonSymmetricTreeStructure& tree) {
+    TVector<const TOnlineCTR*> onlineCtrs(tree.Nodes.size());
+    for (auto nodeIdx : xrange(tree.Nodes.size())) {
+        const auto& split = tree.Nodes[nodeIdx].Split;
+        if (split.Type == ESplitType::OnlineCtr) {
+            onlineCtrs[nodeIdx] = &fold.GetCtr(split.Ctr.Projection);
+        }
+    }
+    return onlineCtrs;
+}
+
+template <typename TTree>
+static TVector<TIndexType> BuildIndicesImpl(
     const TFold& fold,
-    const TSplitTree& tree,
+    const TTree& tree,
     NCB::TTrainingForCPUDataProviderPtr learnData, // can be nullptr
     TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData, // can be empty
     NPar::TLocalExecutor* localExecutor) {
@@ -409,6 +615,53 @@ TVector<TIndexType> BuildIndices(
     return indices;
 }
 
+TVector<TIndexType> BuildIndices(
+    const TFold& fold,
+    const TTreeStructure& tree,
+    NCB::TTrainingForCPUDataProviderPtr learnData, // can be nullptr
+    TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData, // can be empty
+    NPar::TLocalExecutor* localExecutor) {
+
+    return Visit(
+        [&] (const auto& treeStructure) {
+            return BuildIndicesImpl(fold, treeStructure, learnData, testData, localExecutor);
+        },
+        tree);
+}
+
+TVector<TIndexType> BuildLearnTailIndices(
+    const TFold& fold,
+    const TTreeStructure& tree,
+    const NCB::TTrainingForCPUDataProvider& learnData,
+    ui32 learnTailBegin,
+    NPar::TLocalExecutor* localExecutor) {
+
+    const auto& learnPermutation = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>();
+    CB_ENSURE_INTERNAL(learnTailBegin <= learnPermutation.size(), "Learn tail begins after the end of the fold");
+    const ui32 learnTailSampleCount = learnPermutation.size() - learnTailBegin;
+    const NCB::TFeaturesArraySubsetIndexing learnTailSubset(
+        TIndexedSubset<ui32>(learnPermutation.begin() + learnTailBegin, learnPermutation.end()));
+
+    TVector<TIndexType> indices(learnTailSampleCount);
+    if (learnTailSampleCount == 0) {
+        return indices;
+    }
+    Visit(
+        [&] (const auto& treeStructure) {
+            BuildIndicesForDataset(
+                treeStructure,
+                *learnData.ObjectsData,
+                learnTailSubset,
+                learnTailSampleCount,
+                GetOnlineCtrs(fold, treeStructure),
+                (int)learnTailBegin,
+                localExecutor,
+                indices.data());
+        },
+        tree);
+    return indices;
+}
+
 static void BinarizeRawFeatures(
     const TFullModel& model,
     const NCB::TRawObjectsDataProvider& rawObjectsData,
@@ -426,7 +679,7 @@ static void BinarizeRawFeatures(
     const ui32 consecutiveSubsetBegin = GetConsecutiveSubsetBegin(rawObjectsData);
     const auto& featuresLayout = *rawObjectsData.GetFeaturesLayout();
 
-    auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx, TVector<TMaybe<NCB::TPackedBinaryIndex>>*) -> const float* {
+    auto getFeatureDataBeginPtr = [&](ui32 flatFeatureIdx, TMaybe<NCB::TPackedBinaryIndex>*) -> const float* {
         return GetRawFeatureDataBeginPtr(
             rawObjectsData,
             consecutiveSubsetBegin,
@@ -468,41 +721,46 @@ static void AssignFeatureBins(
     CheckModelAndDatasetCompatibility(model, quantizedObjectsData, &columnReorderMap);
     auto docCount = end - start;
     result->resize(model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() * docCount);
-    auto floatBinsRemap = GetFloatFeaturesBordersRemap(model, *quantizedObjectsData.GetQuantizedFeaturesInfo().Get());
-    const ui32 consecutiveSubsetBegin = NCB::GetConsecutiveSubsetBegin(quantizedObjectsData);
+    const auto& quantizedFeaturesInfo = *quantizedObjectsData.GetQuantizedFeaturesInfo();
+    const auto floatBinsRemap = GetFloatFeaturesBordersRemap(model, quantizedFeaturesInfo);
+    const auto catPerfectHashRemap = GetCatFeaturesPerfectHashToHashRemap(model, quantizedFeaturesInfo);
 
-    auto getFeatureDataBeginPtr = [&](ui32 featureIdx, TVector<TMaybe<NCB::TPackedBinaryIndex>>* packedIdx) -> const ui8* {
-        (*packedIdx)[featureIdx] = quantizedObjectsData.GetFloatFeatureToPackedBinaryIndex(TFeatureIdx<EFeatureType::Float>(featureIdx));
-        if (!(*packedIdx)[featureIdx].Defined()) {
-            return GetQuantizedForCpuFloatFeatureDataBeginPtr(
-                    quantizedObjectsData,
-                    consecutiveSubsetBegin,
-                    featureIdx);
-        } else {
-            return (**quantizedObjectsData.GetBinaryFeaturesPack((*packedIdx)[featureIdx]->PackIdx).GetSrc()).Data();
-        }
-    };
     TVector<TConstArrayRef<ui8>> repackedBinFeatures;
+    TVector<TConstArrayRef<ui32>> repackedCatFeatures;
     TVector<TMaybe<TPackedBinaryIndex>> packedIndexes;
-    GetRepackedFeatures(
+    TVector<TVector<ui8>> unpackedFloatFeatures;
+    GetRepackedQuantizedFeatures(
+        model,
+        quantizedObjectsData,
+        columnReorderMap,
         start,
         end,
-        model.ObliviousTrees.GetFlatFeatureVectorExpectedSize(),
-        columnReorderMap,
-        getFeatureDataBeginPtr,
-        *quantizedObjectsData.GetFeaturesLayout().Get(),
         &repackedBinFeatures,
-        &packedIndexes);
+        &repackedCatFeatures,
+        &packedIndexes,
+        &unpackedFloatFeatures);
 
+    TVector<ui32> transposedHash(docCount * model.GetUsedCatFeaturesCount());
+    TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * docCount);
     AssignFeatureBins(
         model,
         [&floatBinsRemap, &repackedBinFeatures, &packedIndexes](const TFloatFeature& floatFeature, size_t index) -> ui8 {
             return QuantizedFeaturesFloatAccessor(floatBinsRemap, repackedBinFeatures, packedIndexes, floatFeature, index);
         },
-        nullptr,
+        [&] (const TCatFeature& catFeature, size_t index) -> ui32 {
+            return QuantizedFeaturesCatAccessor(
+                catPerfectHashRemap,
+                repackedBinFeatures,
+                repackedCatFeatures,
+                packedIndexes,
+                catFeature,
+                index);
+        },
         0,
-        end - start,
-        *result);
+        docCount,
+        *result,
+        transposedHash,
+        ctrs);
 }
 
 TVector<ui8> GetModelCompatibleQuantizedFeatures(
@@ -551,19 +809,138 @@ TVector<TIndexType> BuildIndicesForBinTree(
     return indexesVec;
 }
 
+// non-binary-packed float feature data can be referenced directly only if it is stored as separate bytes
+static bool IsFloatFeatureStoredAsBytes(
+    const NCB::TQuantizedForCPUObjectsDataProvider& quantizedObjectsData,
+    ui32 floatFeatureIdx)
+{
+    if (quantizedObjectsData.GetFloatFeatureToExclusiveBundleIndex(NCB::TFloatFeatureIdx(floatFeatureIdx))) {
+        return false;
+    }
+    return quantizedObjectsData.GetFloatFeatureBitsPerKey(floatFeatureIdx) == CHAR_BIT;
+}
+
 const ui8* GetFeatureDataBeginPtr(
     const NCB::TQuantizedForCPUObjectsDataProvider& quantizedObjectsData,
-    ui32 featureIdx,
+    ui32 flatFeatureIdx,
     int consecutiveSubsetBegin,
-    TVector<TMaybe<NCB::TPackedBinaryIndex>>* packedIdx)
+    TMaybe<NCB::TPackedBinaryIndex>* packedIdx)
 {
-    (*packedIdx)[featureIdx] = quantizedObjectsData.GetFloatFeatureToPackedBinaryIndex(NCB::TFeatureIdx<EFeatureType::Float>(featureIdx));
-    if (!(*packedIdx)[featureIdx].Defined()) {
-        return GetQuantizedForCpuFloatFeatureDataBeginPtr(
-            quantizedObjectsData,
-            consecutiveSubsetBegin,
-            featureIdx);
+    const auto& featuresLayout = *quantizedObjectsData.GetFeaturesLayout();
+    const ui32 internalFeatureIdx = featuresLayout.GetInternalFeatureIdx(flatFeatureIdx);
+    if (featuresLayout.GetExternalFeatureType(flatFeatureIdx) == EFeatureType::Float) {
+        *packedIdx = quantizedObjectsData.GetFloatFeatureToPackedBinaryIndex(
+            NCB::TFloatFeatureIdx(internalFeatureIdx));
+        if (!packedIdx->Defined()) {
+            if (!IsFloatFeatureStoredAsBytes(quantizedObjectsData, internalFeatureIdx)) {
+                return nullptr;
+            }
+            return GetQuantizedForCpuFloatFeatureDataBeginPtr(
+                quantizedObjectsData,
+                consecutiveSubsetBegin,
+                flatFeatureIdx);
+        }
+    } else {
+        *packedIdx = quantizedObjectsData.GetCatFeatureToPackedBinaryIndex(
+            NCB::TCatFeatureIdx(internalFeatureIdx));
+        if (!packedIdx->Defined()) {
+            return nullptr;
+        }
+    }
+    return (**quantizedObjectsData.GetBinaryFeaturesPack((*packedIdx)->PackIdx).GetSrc()).Data();
+}
+
+const ui32* GetCatFeatureDataBeginPtr(
+    const NCB::TQuantizedForCPUObjectsDataProvider& quantizedObjectsData,
+    ui32 flatFeatureIdx,
+    int consecutiveSubsetBegin)
+{
+    const auto& featuresLayout = *quantizedObjectsData.GetFeaturesLayout();
+    if (featuresLayout.GetExternalFeatureType(flatFeatureIdx) != EFeatureType::Categorical) {
+        return nullptr;
+    }
+    const auto catFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
+    if (quantizedObjectsData.GetCatFeatureToPackedBinaryIndex(catFeatureIdx).Defined()) {
+        return nullptr;
+    }
+    return GetQuantizedForCpuCatFeatureDataBeginPtr(
+        quantizedObjectsData,
+        consecutiveSubsetBegin,
+        flatFeatureIdx);
+}
+
+void GetRepackedQuantizedFeatures(
+    const TFullModel& model,
+    const NCB::TQuantizedForCPUObjectsDataProvider& quantizedObjectsData,
+    const THashMap<ui32, ui32>& columnReorderMap,
+    int blockFirstIdx,
+    int blockLastIdx,
+    TVector<TConstArrayRef<ui8>>* repackedBinFeatures,
+    TVector<TConstArrayRef<ui32>>* repackedCatFeatures,
+    TVector<TMaybe<NCB::TPackedBinaryIndex>>* packedIndexes,
+    TVector<TVector<ui8>>* unpackedFloatFeatures)
+{
+    const ui32 consecutiveSubsetBegin = NCB::GetConsecutiveSubsetBegin(quantizedObjectsData);
+    const auto& featuresLayout = *quantizedObjectsData.GetFeaturesLayout();
+    GetRepackedFeatures(
+        blockFirstIdx,
+        blockLastIdx,
+        model.ObliviousTrees.GetFlatFeatureVectorExpectedSize(),
+        columnReorderMap,
+        [&] (ui32 flatFeatureIdx, TMaybe<NCB::TPackedBinaryIndex>* packedIdx) -> const ui8* {
+            return GetFeatureDataBeginPtr(quantizedObjectsData, flatFeatureIdx, consecutiveSubsetBegin, packedIdx);
+        },
+        featuresLayout,
+        repackedBinFeatures,
+        packedIndexes);
+
+    /* bit-packed low-cardinality float features and parts of exclusive features bundles
+     * can't be referenced from an arbitrary object
+     */
+    unpackedFloatFeatures->clear();
+    const auto unpackFloatFeature = [&] (ui32 origIdx, ui32 sourceIdx) {
+        if (!featuresLayout.GetExternalFeaturesMetaInfo()[sourceIdx].IsAvailable ||
+            (featuresLayout.GetExternalFeatureType(sourceIdx) != EFeatureType::Float) ||
+            (*packedIndexes)[origIdx].Defined())
+        {
+            return;
+        }
+        const ui32 floatFeatureIdx = featuresLayout.GetInternalFeatureIdx(sourceIdx);
+        if (IsFloatFeatureStoredAsBytes(quantizedObjectsData, floatFeatureIdx)) {
+            return;
+        }
+        TVector<ui8>& values = unpackedFloatFeatures->emplace_back();
+        values.yresize(blockLastIdx - blockFirstIdx);
+        const ui32 srcBegin = consecutiveSubsetBegin + blockFirstIdx;
+        quantizedObjectsData.VisitFloatFeatureRawSrcData(
+            floatFeatureIdx,
+            [&] (auto srcData) {
+                for (auto i : xrange(values.size())) {
+                    values[i] = srcData[srcBegin + i];
+                }
+            }
+        );
+        (*repackedBinFeatures)[origIdx] = values;
+    };
+    if (columnReorderMap.empty()) {
+        for (auto i : xrange(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize())) {
+            unpackFloatFeature(i, i);
+        }
     } else {
-        return (**quantizedObjectsData.GetBinaryFeaturesPack((*packedIdx)[featureIdx]->PackIdx).GetSrc()).Data();
+        for (const auto& [origIdx, sourceIdx] : columnReorderMap) {
+            unpackFloatFeature(origIdx, sourceIdx);
+        }
+    }
+    if (model.HasCategoricalFeatures()) {
+        GetRepackedFeatures(
+            blockFirstIdx,
+            blockLastIdx,
+            model.ObliviousTrees.GetFlatFeatureVectorExpectedSize(),
+            columnReorderMap,
+            [&] (ui32 flatFeatureIdx, TMaybe<NCB::TPackedBinaryIndex>*) -> const ui32* {
+                return GetCatFeatureDataBeginPtr(quantizedObjectsData, flatFeatureIdx, consecutiveSubsetBegin);
+            },
+            featuresLayout,
+            repackedCatFeatures);
     }
 }
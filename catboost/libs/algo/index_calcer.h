@@ -25,13 +25,31 @@ TVector<bool> GetIsLeafEmpty(int curDepth, const TVector<TIndexType>& indices);
 
 int GetRedundantSplitIdx(const TVector<bool>& isLeafEmpty);
 
+// Moves documents of split leaves to the new leaves,
+// leafSplitNodes[leafIdx] is the index of tree node that has split the leaf or -1 if the leaf was not split
+void UpdateIndicesWithLeafSplits(
+    const TNonSymmetricTreeStructure& tree,
+    TConstArrayRef<int> leafSplitNodes,
+    const NCB::TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TFold& fold,
+    TVector<TIndexType>* indices,
+    NPar::TLocalExecutor* localExecutor);
+
 TVector<TIndexType> BuildIndices(
     const TFold& fold, // can be empty
-    const TSplitTree& tree,
+    const TTreeStructure& tree,
     NCB::TTrainingForCPUDataProviderPtr learnData, // can be nullptr
     TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData, // can be empty
     NPar::TLocalExecutor* localExecutor);
 
+// indices of learn objects at positions [learnTailBegin, learn sample count) of the fold permutation
+TVector<TIndexType> BuildLearnTailIndices(
+    const TFold& fold,
+    const TTreeStructure& tree,
+    const NCB::TTrainingForCPUDataProvider& learnData,
+    ui32 learnTailBegin,
+    NPar::TLocalExecutor* localExecutor);
+
 struct TFullModel;
 
 TVector<ui8> GetModelCompatibleQuantizedFeatures(
@@ -47,6 +65,7 @@ TVector<TIndexType> BuildIndicesForBinTree(
     const TVector<ui8>& binarizedFeatures,
     size_t treeId);
 
+// getFeatureDataBeginPtr can return nullptr for features that are stored with a different value type
 template <class TGetFeatureDataBeginPtr, class TNumType>
 static inline void GetRepackedFeatures(
     int blockFirstIdx,
@@ -64,24 +83,57 @@ static inline void GetRepackedFeatures(
         packedIndexes->resize(flatFeatureVectorExpectedSize);
     }
     const int blockSize = blockLastIdx - blockFirstIdx;
+    const auto repackFeature = [&] (ui32 origIdx, ui32 sourceIdx) {
+        if (!featuresLayout.GetExternalFeaturesMetaInfo()[sourceIdx].IsAvailable) {
+            return;
+        }
+        TMaybe<NCB::TPackedBinaryIndex> packedIdx;
+        const TNumType* featureDataBeginPtr = getFeatureDataBeginPtr(sourceIdx, &packedIdx);
+        if (featureDataBeginPtr != nullptr) {
+            (*repackedFeatures)[origIdx] = MakeArrayRef(featureDataBeginPtr + blockFirstIdx, blockSize);
+        }
+        if (packedIndexes != nullptr) {
+            (*packedIndexes)[origIdx] = packedIdx;
+        }
+    };
     if (columnReorderMap.empty()) {
         for (size_t i = 0; i < flatFeatureVectorExpectedSize; ++i) {
-            if (featuresLayout.GetExternalFeaturesMetaInfo()[i].IsAvailable) {
-                (*repackedFeatures)[i] = MakeArrayRef(getFeatureDataBeginPtr(i, packedIndexes) + blockFirstIdx, blockSize);
-            }
+            repackFeature(i, i);
         }
     } else {
         for (const auto& [origIdx, sourceIdx] : columnReorderMap) {
-            if (featuresLayout.GetExternalFeaturesMetaInfo()[sourceIdx].IsAvailable) {
-                (*repackedFeatures)[origIdx] = MakeArrayRef(getFeatureDataBeginPtr(sourceIdx, packedIndexes) + blockFirstIdx,
-                                                            blockSize);
-            }
+            repackFeature(origIdx, sourceIdx);
         }
     }
 }
 
+// returns nullptr for non-packed categorical features, their data is returned by GetCatFeatureDataBeginPtr,
+// and for bit-packed low-cardinality float features and float features in exclusive features bundles
 const ui8* GetFeatureDataBeginPtr(
     const NCB::TQuantizedForCPUObjectsDataProvider& quantizedObjectsData,
-    ui32 featureIdx,
+    ui32 flatFeatureIdx,
     int consecutiveSubsetBegin,
-    TVector<TMaybe<NCB::TPackedBinaryIndex>>* packedIdx);
+    TMaybe<NCB::TPackedBinaryIndex>* packedIdx);
+
+// returns nullptr for float and binary packed categorical features
+const ui32* GetCatFeatureDataBeginPtr(
+    const NCB::TQuantizedForCPUObjectsDataProvider& quantizedObjectsData,
+    ui32 flatFeatureIdx,
+    int consecutiveSubsetBegin);
+
+/* Features data of objects [blockFirstIdx, blockLastIdx) indexed by model flat feature index:
+ * float features and binary packs in repackedBinFeatures, non-packed categorical features
+ * (perfect hashed values) in repackedCatFeatures.
+ * Bit-packed low-cardinality and bundled float features are unpacked to unpackedFloatFeatures
+ * that must outlive repackedBinFeatures
+ */
+void GetRepackedQuantizedFeatures(
+    const TFullModel& model,
+    const NCB::TQuantizedForCPUObjectsDataProvider& quantizedObjectsData,
+    const THashMap<ui32, ui32>& columnReorderMap,
+    int blockFirstIdx,
+    int blockLastIdx,
+    TVector<TConstArrayRef<ui8>>* repackedBinFeatures,
+    TVector<TConstArrayRef<ui32>>* repackedCatFeatures,
+    TVector<TMaybe<NCB::TPackedBinaryIndex>>* packedIndexes,
+    TVector<TVector<ui8>>* unpackedFloatFeatures);
@@ -1,5 +1,8 @@
 #include "index_hash_calcer.h"
 
+#include <util/generic/cast.h>
+
+
 /// Compute reindexHash and reindex hash values in range [begin,end).
 size_t ComputeReindexHash(ui64 topSize,
                           TDenseHash<ui64, ui32>* reindexHashPtr,
@@ -74,3 +77,108 @@ size_t UpdateReindexHash(TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui
     }
     return reindexHash.Size();
 }
+
+TPartitionedReindexHash::TPartitionedReindexHash(int partCountLog2)
+    : PartCountLog2(partCountLog2)
+    , Parts(1 << partCountLog2)
+    , PartOffsets(1 << partCountLog2)
+{
+}
+
+size_t TPartitionedReindexHash::ComputeReindex(NPar::TLocalExecutor* localExecutor, ui64* begin, ui64* end) {
+    Y_ASSERT(Size == 0);
+    const size_t learnSize = end - begin;
+    const size_t partCount = Parts.size();
+
+    // objects are bucketed by part in one pass (stable within a part), so that every part then
+    // processes only its own objects in their original order
+    const size_t blockCount = partCount;
+    const auto getBlockBegin = [=] (size_t blockIdx) {
+        return learnSize * blockIdx / blockCount;
+    };
+    TVector<TVector<ui32>> bucketOffsets(blockCount, TVector<ui32>(partCount, 0)); // [blockIdx][partIdx]
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            auto& partSizes = bucketOffsets[blockIdx];
+            for (size_t i = getBlockBegin(blockIdx); i < getBlockBegin(blockIdx + 1); ++i) {
+                ++partSizes[GetPartIdx(begin[i])];
+            }
+        },
+        0,
+        SafeIntegerCast<int>(blockCount),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    TVector<ui32> partBegins(partCount + 1);
+    ui32 bucketBegin = 0;
+    for (auto partIdx : xrange(partCount)) {
+        partBegins[partIdx] = bucketBegin;
+        for (auto blockIdx : xrange(blockCount)) {
+            const ui32 bucketSize = bucketOffsets[blockIdx][partIdx];
+            bucketOffsets[blockIdx][partIdx] = bucketBegin;
+            bucketBegin += bucketSize;
+        }
+    }
+    partBegins[partCount] = bucketBegin;
+
+    TVector<ui32> objectsByPart;
+    objectsByPart.yresize(learnSize);
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            auto& offsets = bucketOffsets[blockIdx];
+            for (size_t i = getBlockBegin(blockIdx); i < getBlockBegin(blockIdx + 1); ++i) {
+                objectsByPart[offsets[GetPartIdx(begin[i])]++] = i;
+            }
+        },
+        0,
+        SafeIntegerCast<int>(blockCount),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    TVector<ui32> indicesInPart;
+    indicesInPart.yresize(learnSize);
+    localExecutor->ExecRange(
+        [&] (int partIdx) {
+            auto& part = Parts[partIdx];
+            ui32 counter = 0;
+            for (ui32 bucketIdx = partBegins[partIdx]; bucketIdx < partBegins[partIdx + 1]; ++bucketIdx) {
+                const ui32 objectIdx = objectsByPart[bucketIdx];
+                auto p = part.emplace(begin[objectIdx], counter);
+                if (p.second) {
+                    ++counter;
+                }
+                indicesInPart[objectIdx] = p.first->second;
+            }
+        },
+        0,
+        Parts.ysize(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    for (auto partIdx : xrange(Parts.size())) {
+        PartOffsets[partIdx] = Size;
+        Size += Parts[partIdx].Size();
+    }
+
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        SafeIntegerCast<ui32>(learnSize),
+        [&] (ui32 i) {
+            begin[i] = PartOffsets[GetPartIdx(begin[i])] + indicesInPart[i];
+        });
+    return Size;
+}
+
+size_t TPartitionedReindexHash::UpdateReindex(ui64* begin, ui64* end) {
+    for (ui64* hash = begin; hash != end; ++hash) {
+        const ui32 partIdx = GetPartIdx(*hash);
+        if (const auto* indexInPart = Parts[partIdx].FindPtr(*hash)) {
+            *hash = PartOffsets[partIdx] + *indexInPart;
+        } else {
+            auto p = NewValues.emplace(*hash, Size);
+            if (p.second) {
+                ++Size;
+            }
+            *hash = p.first->second;
+        }
+    }
+    return Size;
+}
@@ -7,6 +7,7 @@
 
 #include <library/containers/dense_hash/dense_hash.h>
 #include <library/containers/stack_vector/stack_vec.h>
+#include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/utility.h>
 #include <util/generic/xrange.h>
@@ -47,12 +48,39 @@ inline void ProcessFeatureForCalcHashes(
                 }
             );
         }
-    } else {
-        NCB::TConstPtrArraySubset<typename IFeatureColumn::TValueType>(
-            dynamic_cast<const NCB::TCompressedValuesHolderImpl<IFeatureColumn>*>(getFeatureColumn())
-                ->GetArrayData().GetSrc(),
+    } else if (const auto* bundlePartColumn
+                   = dynamic_cast<const NCB::TBundlePartValuesHolderImpl<IFeatureColumn>*>(getFeatureColumn()))
+    {
+        NCB::TArraySubset<const NCB::TMaybeOwningArrayHolder<NCB::TExclusiveFeaturesBundleValue>, ui32>(
+            &bundlePartColumn->GetBundleSrcData(),
             &featuresSubsetIndexing
-        ).ForEach(std::move(f));
+        ).ForEach(
+            [boundsInBundle = bundlePartColumn->GetBoundsInBundle(), f = std::move(f)] (
+                ui32 i,
+                NCB::TExclusiveFeaturesBundleValue bundleValue
+            ) {
+                f(i, (typename IFeatureColumn::TValueType)NCB::GetBinFromBundle(bundleValue, boundsInBundle));
+            }
+        );
+    } else {
+        const auto* featureColumn
+            = dynamic_cast<const NCB::TCompressedValuesHolderImpl<IFeatureColumn>*>(getFeatureColumn());
+        if (featureColumn->GetBitsPerKey() == sizeof(typename IFeatureColumn::TValueType) * CHAR_BIT) {
+            NCB::TConstPtrArraySubset<typename IFeatureColumn::TValueType>(
+                featureColumn->GetArrayData().GetSrc(),
+                &featuresSubsetIndexing
+            ).ForEach(std::move(f));
+        } else {
+            // bit-packed low-cardinality feature
+            NCB::TConstCompressedArraySubset(
+                featureColumn->GetCompressedData().GetSrc(),
+                &featuresSubsetIndexing
+            ).ForEach(
+                [f = std::move(f)] (ui32 i, ui32 featureValue) {
+                    f(i, (typename IFeatureColumn::TValueType)featureValue);
+                }
+            );
+        }
     }
 }
 
@@ -213,3 +241,30 @@ size_t ComputeReindexHash(ui64 topSize, TDenseHash<ui64, ui32>* reindexHashPtr,
 /// If a hash value is not present in reindexHash, then update reindexHash for that value.
 /// @return the size of updated reindexHash.
 size_t UpdateReindexHash(TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui64* end);
+
+/// Reindex hash for large learn sets: hash values are split into parts by value and parts are
+/// reindexed by localExecutor threads independently. Indices of one part are consecutive,
+/// so they are assigned in a different order than by ComputeReindexHash (without topSize limit).
+class TPartitionedReindexHash {
+public:
+    explicit TPartitionedReindexHash(int partCountLog2);
+
+    /// Reindex hash values in range [begin,end) of learn objects, can be called only once.
+    /// @return the size of reindexHash.
+    size_t ComputeReindex(NPar::TLocalExecutor* localExecutor, ui64* begin, ui64* end);
+
+    /// The same as UpdateReindexHash.
+    size_t UpdateReindex(ui64* begin, ui64* end);
+
+private:
+    ui32 GetPartIdx(ui64 hash) const {
+        return PartCountLog2 ? (hash * 0x9E3779B97F4A7C15ULL) >> (64 - PartCountLog2) : 0;
+    }
+
+private:
+    const int PartCountLog2;
+    TVector<TDenseHash<ui64, ui32>> Parts;
+    TVector<ui32> PartOffsets;
+    TDenseHash<ui64, ui32> NewValues; // values first seen in UpdateReindex
+    size_t Size = 0;
+};
@@ -1,6 +1,9 @@
 #include "calc_score_cache.h"
 #include "learn_context.h"
+#include "approx_updater_helpers.h"
 #include "error_functions.h"
+#include "greedy_tensor_search.h"
+#include "index_calcer.h"
 #include "online_ctr.h"
 
 #include <catboost/libs/distributed/master.h>
@@ -12,6 +15,8 @@
 #include <library/digest/md5/md5.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/bitops.h>
+#include <util/generic/cast.h>
 #include <util/generic/guid.h>
 #include <util/generic/xrange.h>
 #include <util/folder/path.h>
@@ -60,6 +65,13 @@ void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data) {
     for (const auto& testData : data.Test) {
         LearnProgress.PoolCheckSum += testData->ObjectsData->CalcFeaturesCheckSum(LocalExecutor);
     }
+    if (OutputOptions.SaveSnapshot()) {
+        LearnProgress.LearnObjectCount = data.Learn->GetObjectCount();
+        LearnProgress.LearnFeatureValuesCheckSum = data.Learn->ObjectsData->CalcFeatureValuesCheckSum(LocalExecutor);
+        for (const auto& testData : data.Test) {
+            LearnProgress.TestFeatureValuesCheckSum += testData->ObjectsData->CalcFeatureValuesCheckSum(LocalExecutor);
+        }
+    }
 
     auto lossFunction = Params.LossFunctionDescription->GetLossFunction();
     const bool hasCtrs =
@@ -167,30 +179,208 @@ void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data) {
 
     const ui32 maxBodyTailCount = Max(1, GetMaxBodyTailCount(LearnProgress.Folds));
     UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(Params, maxBodyTailCount, LearnProgress.ApproxDimension);
+    ReuseLeafStatsFlag = NeedToReuseLeafStats(Params, maxBodyTailCount, LearnProgress.ApproxDimension);
+}
+
+// layout version 1: tree structures are saved as TVector<TTreeStructure>
+static constexpr ui32 CpuProgressLayoutVersion = 1;
+
+TString GetCpuProgressLabel() {
+    return ToString(ETaskType::CPU) + "_v" + ToString(CpuProgressLayoutVersion);
+}
+
+TString GetCpuLegacyProgressLabel() {
+    return ToString(ETaskType::CPU);
 }
 
 void TLearnContext::SaveProgress() {
     if (!OutputOptions.SaveSnapshot()) {
         return;
     }
-    TProgressHelper(ToString(ETaskType::CPU)).Write(Files.SnapshotFile, [&](IOutputStream* out) {
+    TProgressHelper(GetCpuProgressLabel()).Write(Files.SnapshotFile, [&](IOutputStream* out) {
         ::SaveMany(out, Rand, LearnProgress, Profile.DumpProfileInfo());
+        LearnProgress.SaveLearnDataInfo(out);
     });
 }
 
-bool TLearnContext::TryLoadProgress() {
+// objects with new categorical values can be appended, so quantized values are compared instead of PoolCheckSum
+static bool IsLearnDataAppended(
+    const TLearnProgress& savedProgress,
+    const TLearnProgress& currentProgress,
+    const TTrainingForCPUDataProviders& data,
+    NPar::TLocalExecutor* localExecutor
+) {
+    const ui32 savedObjectCount = savedProgress.LearnObjectCount;
+    if (savedObjectCount == 0 || savedObjectCount >= data.Learn->GetObjectCount()) {
+        return false;
+    }
+    // permutations of learning folds and the averaging fold
+    if (savedProgress.FoldLearnPermutations.size() != currentProgress.Folds.size() + 1) {
+        return false;
+    }
+    for (const auto& savedPermutation : savedProgress.FoldLearnPermutations) {
+        if (savedPermutation.size() != savedObjectCount) {
+            return false;
+        }
+    }
+    if (savedProgress.TestFeatureValuesCheckSum != currentProgress.TestFeatureValuesCheckSum) {
+        return false;
+    }
+    const auto& objectsGrouping = *data.Learn->ObjectsGrouping;
+    if (objectsGrouping.GetGroup(objectsGrouping.GetGroupIdxForObject(savedObjectCount)).Begin != savedObjectCount) {
+        return false; // saved learn objects end in the middle of a group
+    }
+    const ui32 savedObjectsCheckSum = data.Learn->ObjectsData->CalcFeatureValuesPrefixCheckSum(
+        savedObjectCount,
+        localExecutor);
+    return savedObjectsCheckSum == savedProgress.LearnFeatureValuesCheckSum;
+}
+
+static bool IsPermutationExtension(TConstArrayRef<ui32> permutation, TConstArrayRef<ui32> permutationPrefix) {
+    if (!Equal(permutationPrefix.begin(), permutationPrefix.end(), permutation.begin())) {
+        return false;
+    }
+    for (auto idx : xrange(permutationPrefix.size(), permutation.size())) {
+        if (permutation[idx] != idx) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void UpdateLearnTailApprox(
+    bool storeExpApprox,
+    ui32 learnTailBegin,
+    TConstArrayRef<TIndexType> indices,
+    const TVector<TVector<double>>& expLeafValues,
+    TFold* fold,
+    NPar::TLocalExecutor* localExecutor
+) {
+    Y_ASSERT(fold->BodyTailArr.ysize() == 1);
+    auto& approx = fold->BodyTailArr[0].Approx;
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(indices.size()));
+    blockParams.SetBlockSize(10000);
+    localExecutor->ExecRange([&](int idx) {
+        for (auto dim : xrange(approx.size())) {
+            double& value = approx[dim][learnTailBegin + idx];
+            value = UpdateApprox(storeExpApprox, value, expLeafValues[dim][indices[idx]]);
+        }
+    }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+/* Saved objects keep their positions in fold permutations and appended objects follow them in their original order.
+ * Online ctrs of an object depend only on preceding objects, so approxes of saved objects are taken from the snapshot
+ * as is (including the ones of learning folds, estimated on their own permutations),
+ * and saved trees are applied only to appended objects, which get final leaf values.
+ */
+static void RestoreProgressForAppendedLearnData(
+    const TTrainingForCPUDataProviders& data,
+    TLearnProgress* savedProgress,
+    TLearnContext* ctx
+) {
+    auto& progress = ctx->LearnProgress;
+    const auto lossFunction = ctx->Params.LossFunctionDescription->GetLossFunction();
+    const bool storeExpApprox = IsStoreExpApprox(lossFunction);
+    const ui32 savedObjectCount = savedProgress->LearnObjectCount;
+    const ui32 appendedObjectCount = data.Learn->GetObjectCount() - savedObjectCount;
+
+    TVector<TFold*> allFolds;
+    TVector<const TFold*> allSavedFolds;
+    for (auto foldIdx : xrange(progress.Folds.size())) {
+        allFolds.push_back(&progress.Folds[foldIdx]);
+        allSavedFolds.push_back(&savedProgress->Folds[foldIdx]);
+    }
+    allFolds.push_back(&progress.AveragingFold);
+    allSavedFolds.push_back(&savedProgress->AveragingFold);
+
+    for (auto foldIdx : xrange(allFolds.size())) {
+        TFold* fold = allFolds[foldIdx];
+        const auto& savedPermutation = savedProgress->FoldLearnPermutations[foldIdx];
+        if (!IsPermutationExtension(fold->GetLearnPermutationArray(), savedPermutation)) {
+            *fold = TFold::BuildPlainFold(
+                *data.Learn,
+                ctx->CtrsHelper.GetTargetClassifiers(),
+                /*shuffle*/ true,
+                /*permuteBlockSize*/ 1,
+                progress.ApproxDimension,
+                storeExpApprox,
+                UsesPairsForCalculation(lossFunction),
+                ctx->Rand,
+                ctx->LocalExecutor,
+                savedPermutation
+            );
+        }
+        const auto& savedApprox = allSavedFolds[foldIdx]->BodyTailArr[0].Approx;
+        auto& approx = fold->BodyTailArr[0].Approx;
+        for (auto dim : xrange(approx.size())) {
+            CB_ENSURE(savedApprox[dim].size() == savedObjectCount, "Cannot load progress from file");
+            Copy(savedApprox[dim].begin(), savedApprox[dim].end(), approx[dim].begin());
+        }
+    }
+    for (auto dim : xrange(progress.AvrgApprox.size())) {
+        const auto& savedAvrgApprox = savedProgress->AvrgApprox[dim];
+        CB_ENSURE(savedAvrgApprox.size() == savedObjectCount, "Cannot load progress from file");
+        Copy(savedAvrgApprox.begin(), savedAvrgApprox.end(), progress.AvrgApprox[dim].begin());
+    }
+    progress.TestApprox = std::move(savedProgress->TestApprox);
+
+    for (auto treeIdx : xrange(progress.TreeStruct.size())) {
+        const auto& tree = progress.TreeStruct[treeIdx];
+        const auto& leafValues = progress.LeafValues[treeIdx];
+
+        THashSet<TProjection> seenProjections;
+        for (const auto& ctr : GetCtrSplits(tree)) {
+            if (!seenProjections.insert(ctr.Projection).second) {
+                continue;
+            }
+            ctx->LocalExecutor->ExecRange([&](int foldIdx) {
+                TFold* fold = allFolds[foldIdx];
+                if (!ctx->OnlineCtrCache.Acquire(&fold->GetCtrRef(ctr.Projection))) {
+                    ComputeOnlineCTRs(data, *fold, ctr.Projection, ctx, &fold->GetCtrRef(ctr.Projection));
+                }
+            }, 0, allFolds.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+        }
+
+        TVector<TVector<double>> expLeafValues(leafValues);
+        ExpApproxIf(storeExpApprox, &expLeafValues);
+        for (TFold* fold : allFolds) {
+            const auto indices = BuildLearnTailIndices(*fold, tree, *data.Learn, savedObjectCount, ctx->LocalExecutor);
+            UpdateLearnTailApprox(storeExpApprox, savedObjectCount, indices, expLeafValues, fold, ctx->LocalExecutor);
+            if (fold == &progress.AveragingFold) {
+                const auto learnPermutation = fold->GetLearnPermutationArray();
+                for (auto dim : xrange(leafValues.size())) {
+                    for (auto idx : xrange(appendedObjectCount)) {
+                        progress.AvrgApprox[dim][learnPermutation[savedObjectCount + idx]] += leafValues[dim][indices[idx]];
+                    }
+                }
+            }
+        }
+
+        TrimOnlineCTRcache(allFolds, ctx);
+    }
+}
+
+bool TLearnContext::TryLoadProgress(const TTrainingForCPUDataProviders& data) {
     if (!OutputOptions.SaveSnapshot() || !NFs::Exists(Files.SnapshotFile)) {
         return false;
     }
     try {
-        TProgressHelper(ToString(ETaskType::CPU)).CheckedLoad(Files.SnapshotFile, [&](TIFStream* in)
+        const TVector<TString> legacyLabels = {GetCpuLegacyProgressLabel()};
+        TProgressHelper(GetCpuProgressLabel()).CheckedLoad(Files.SnapshotFile, legacyLabels, [&](TIFStream* in, const TString& label)
         {
             // use progress copy to avoid partial deserialization of corrupted progress file
             TLearnProgress learnProgressRestored = LearnProgress;
             TProfileInfoData ProfileRestored;
 
             // fail here does nothing with real LearnProgress
-            ::LoadMany(in, Rand, learnProgressRestored, ProfileRestored);
+            ::Load(in, Rand);
+            if (label == GetCpuLegacyProgressLabel()) {
+                learnProgressRestored.LoadLegacy(in);
+            } else {
+                ::Load(in, learnProgressRestored);
+            }
+            ::Load(in, ProfileRestored);
+            learnProgressRestored.LoadLearnDataInfo(in);
 
             const bool paramsCompatible = NCatboostOptions::IsParamsCompatible(
                 learnProgressRestored.SerializedTrainParams,
@@ -201,11 +391,34 @@ bool TLearnContext::TryLoadProgress() {
             CB_ENSURE(paramsCompatible, "Saved model's params are different from current model's params");
 
             const bool poolCompatible = (learnProgressRestored.PoolCheckSum == LearnProgress.PoolCheckSum);
+            const bool isLearnDataAppended = !poolCompatible
+                && IsLearnDataAppended(learnProgressRestored, LearnProgress, data, LocalExecutor);
             CB_ENSURE(
-                poolCompatible,
+                poolCompatible || isLearnDataAppended,
                 "Current pool differs from the original pool "
                 LabeledOutput(learnProgressRestored.PoolCheckSum, LearnProgress.PoolCheckSum));
 
+            if (isLearnDataAppended) {
+                CB_ENSURE(
+                    IsPlainMode(Params.BoostingOptions->BoostingType),
+                    "Continuing training on a pool with appended objects is supported only for Plain boosting type");
+                CB_ENSURE(
+                    Params.SystemOptions->IsSingleHost(),
+                    "Continuing training on a pool with appended objects is not supported for distributed training");
+
+                LearnProgress.BestTestApprox = std::move(learnProgressRestored.BestTestApprox);
+                LearnProgress.TreeStruct = std::move(learnProgressRestored.TreeStruct);
+                LearnProgress.TreeStats = std::move(learnProgressRestored.TreeStats);
+                LearnProgress.LeafValues = std::move(learnProgressRestored.LeafValues);
+                LearnProgress.MetricsAndTimeHistory = std::move(learnProgressRestored.MetricsAndTimeHistory);
+                LearnProgress.UsedCtrSplits = std::move(learnProgressRestored.UsedCtrSplits);
+                Profile.InitProfileInfo(std::move(ProfileRestored));
+                RestoreProgressForAppendedLearnData(data, &learnProgressRestored, this);
+                CATBOOST_INFO_LOG << "Loaded progress file containing " << LearnProgress.TreeStruct.size() << " trees, "
+                    << data.Learn->GetObjectCount() - learnProgressRestored.LearnObjectCount << " learn objects were appended" << Endl;
+                return;
+            }
+
             LearnProgress = std::move(learnProgressRestored);
             Profile.InitProfileInfo(std::move(ProfileRestored));
             LearnProgress.SerializedTrainParams = ToString(Params); // substitute real
@@ -247,48 +460,123 @@ void TLearnProgress::Save(IOutputStream* s) const {
         PoolCheckSum);
 }
 
-void TLearnProgress::Load(IInputStream* s) {
-    ::Load(s, SerializedTrainParams);
+static void LoadLearnProgress(IInputStream* s, bool isLegacyLayout, TLearnProgress* learnProgress) {
+    ::Load(s, learnProgress->SerializedTrainParams);
     bool enableSaveLoadApprox;
     ::Load(s, enableSaveLoadApprox);
-    CB_ENSURE(enableSaveLoadApprox == EnableSaveLoadApprox, "Cannot load progress from file");
-    if (EnableSaveLoadApprox) {
+    CB_ENSURE(enableSaveLoadApprox == learnProgress->EnableSaveLoadApprox, "Cannot load progress from file");
+    if (learnProgress->EnableSaveLoadApprox) {
         ui64 foldCount;
         ::Load(s, foldCount);
-        CB_ENSURE(foldCount == Folds.size(), "Cannot load progress from file");
+        CB_ENSURE(foldCount == learnProgress->Folds.size(), "Cannot load progress from file");
         for (ui64 i = 0; i < foldCount; ++i) {
-            Folds[i].LoadApproxes(s);
+            learnProgress->Folds[i].LoadApproxes(s);
         }
-        AveragingFold.LoadApproxes(s);
-        ::Load(s, AvrgApprox);
+        learnProgress->AveragingFold.LoadApproxes(s);
+        ::Load(s, learnProgress->AvrgApprox);
     }
     ::LoadMany(s,
-               TestApprox,
-               BestTestApprox,
-               CatFeatures,
-               FloatFeatures,
-               ApproxDimension,
-               TreeStruct,
-               TreeStats,
-               LeafValues,
-               MetricsAndTimeHistory,
-               UsedCtrSplits,
-               PoolCheckSum);
+               learnProgress->TestApprox,
+               learnProgress->BestTestApprox,
+               learnProgress->CatFeatures,
+               learnProgress->FloatFeatures,
+               learnProgress->ApproxDimension);
+    if (isLegacyLayout) {
+        TVector<TSplitTree> splitTrees;
+        ::Load(s, splitTrees);
+        learnProgress->TreeStruct.assign(splitTrees.begin(), splitTrees.end());
+    } else {
+        ::Load(s, learnProgress->TreeStruct);
+    }
+    ::LoadMany(s,
+               learnProgress->TreeStats,
+               learnProgress->LeafValues,
+               learnProgress->MetricsAndTimeHistory,
+               learnProgress->UsedCtrSplits,
+               learnProgress->PoolCheckSum);
+}
+
+void TLearnProgress::Load(IInputStream* s) {
+    LoadLearnProgress(s, /*isLegacyLayout*/ false, this);
+}
+
+void TLearnProgress::LoadLegacy(IInputStream* s) {
+    LoadLearnProgress(s, /*isLegacyLayout*/ true, this);
+}
+
+/* fields of later versions are to be appended after the ones of earlier versions
+ * version 2: learn permutations of folds
+ */
+static constexpr ui32 LearnDataInfoVersion = 2;
+
+void TLearnProgress::SaveLearnDataInfo(IOutputStream* s) const {
+    ::SaveMany(s, LearnDataInfoVersion, LearnObjectCount, LearnFeatureValuesCheckSum, TestFeatureValuesCheckSum);
+
+    TVector<TVector<ui32>> foldLearnPermutations;
+    if (EnableSaveLoadApprox) {
+        for (const auto& fold : Folds) {
+            const auto learnPermutation = fold.GetLearnPermutationArray();
+            foldLearnPermutations.emplace_back(learnPermutation.begin(), learnPermutation.end());
+        }
+        const auto learnPermutation = AveragingFold.GetLearnPermutationArray();
+        foldLearnPermutations.emplace_back(learnPermutation.begin(), learnPermutation.end());
+    }
+    ::Save(s, foldLearnPermutations);
+}
+
+void TLearnProgress::LoadLearnDataInfo(IInputStream* s) {
+    LearnObjectCount = 0;
+    LearnFeatureValuesCheckSum = 0;
+    TestFeatureValuesCheckSum = 0;
+    FoldLearnPermutations.clear();
+    ui32 version = 0;
+    if (s->Load(&version, sizeof(version)) != sizeof(version)) {
+        return; // snapshot saved before learn data info was added
+    }
+    CB_ENSURE(version >= 1, "Unexpected snapshot learn data info version " << version);
+    ::LoadMany(s, LearnObjectCount, LearnFeatureValuesCheckSum, TestFeatureValuesCheckSum);
+    if (version >= 2) {
+        ::Load(s, FoldLearnPermutations);
+    }
 }
 
 bool TLearnContext::UseTreeLevelCaching() const {
     return UseTreeLevelCachingFlag;
 }
 
+bool TLearnContext::ReuseLeafStats() const {
+    return ReuseLeafStatsFlag;
+}
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
     ui32 approxDimension) {
 
     const ui32 maxLeafCount = 1 << params.ObliviousTreeOptions->MaxDepth;
+    // compact cache stores stats in half the memory, so twice as large caches are affordable
+    const ui32 cacheSizeMultiplier = params.ObliviousTreeOptions->DevCompactScoreCache ? 2 : 1;
     // TODO(nikitxskv): Pairwise scoring doesn't use statistics from previous tree level. Need to fix it.
     return (
+        params.ObliviousTreeOptions->GrowingPolicy == EGrowingPolicy::ObliviousTree &&
         IsSamplingPerTree(params.ObliviousTreeOptions) &&
         !IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()) &&
-        maxLeafCount * approxDimension * maxBodyTailCount < 64 * 1 * 10);
+        maxLeafCount * approxDimension * maxBodyTailCount < 64 * 1 * 10 * cacheSizeMultiplier);
+}
+
+bool NeedToReuseLeafStats(
+    const NCatboostOptions::TCatBoostOptions& params,
+    ui32 maxBodyTailCount,
+    ui32 approxDimension) {
+
+    const auto& treeOptions = params.ObliviousTreeOptions.Get();
+    if (treeOptions.GrowingPolicy == EGrowingPolicy::ObliviousTree) {
+        return false;
+    }
+    const ui32 maxLeafCount = treeOptions.GrowingPolicy == EGrowingPolicy::Lossguide ?
+        treeOptions.MaxLeavesCount.Get()
+        : 1 << treeOptions.MaxDepth;
+    // stats are kept for power of 2 leaf slots
+    const ui32 maxLeafSlotCount = maxLeafCount > 1 ? 1 << GetValueBitCount(maxLeafCount - 1) : 1;
+    return maxLeafSlotCount * approxDimension * maxBodyTailCount < 64 * 1 * 10;
 }
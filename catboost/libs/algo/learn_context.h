@@ -1,6 +1,7 @@
 #pragma once
 
 #include "online_ctr.h"
+#include "online_ctr_cache.h"
 #include "fold.h"
 #include "ctr_helper.h"
 #include "split.h"
@@ -43,7 +44,7 @@ struct TLearnProgress {
 
     TString SerializedTrainParams; // TODO(kirillovs): do something with this field
 
-    TVector<TSplitTree> TreeStruct;
+    TVector<TTreeStructure> TreeStruct;
     TVector<TTreeStats> TreeStats;
     TVector<TVector<TVector<double>>> LeafValues; // [numTree][dim][bucketId]
 
@@ -53,10 +54,33 @@ struct TLearnProgress {
 
     ui32 PoolCheckSum = 0;
 
+    // used to continue training on a pool with objects appended to the end of the learn set
+    ui32 LearnObjectCount = 0;
+    ui32 LearnFeatureValuesCheckSum = 0;
+    ui32 TestFeatureValuesCheckSum = 0;
+    /* [foldIdx][objectIdx], the averaging fold is the last,
+     * only loaded from the snapshot, saved permutations are taken from folds
+     */
+    TVector<TVector<ui32>> FoldLearnPermutations;
+
     void Save(IOutputStream* s) const;
     void Load(IInputStream* s);
+    // load progress of the legacy layout, where tree structures are saved as TVector<TSplitTree>
+    void LoadLegacy(IInputStream* s);
+
+    /* Versioned snapshot tail with LearnObjectCount, checksums and fold permutations, saved after profile info,
+     * so that snapshots without it are still loadable (fields are empty then).
+     */
+    void SaveLearnDataInfo(IOutputStream* s) const;
+    void LoadLearnDataInfo(IInputStream* s);
 };
 
+/* CPU snapshot label contains the snapshot layout version,
+ * snapshots of the legacy layout (without non-symmetric trees support) have the plain task type label.
+ */
+TString GetCpuProgressLabel();
+TString GetCpuLegacyProgressLabel();
+
 class TCommonContext : public TNonCopyable {
 public:
     TCommonContext(const NCatboostOptions::TCatBoostOptions& params,
@@ -104,7 +128,12 @@ public:
         , RootEnvironment(nullptr)
         , SharedTrainData(nullptr)
         , Profile((int)Params.BoostingOptions->IterationCount)
-        , UseTreeLevelCachingFlag(false) {
+        , OnlineCtrCache(
+            ParseMemorySizeDescription(Params.SystemOptions->OnlineCtrCacheSize.Get()),
+            Params.SystemOptions->OnlineCtrCachePolicy.Get(),
+            Params.SystemOptions->OnlineCtrCacheSpillDir.Get())
+        , UseTreeLevelCachingFlag(false)
+        , ReuseLeafStatsFlag(false) {
         LearnProgress.SerializedTrainParams = ToString(Params);
         ETaskType taskType = Params.GetTaskType();
         CB_ENSURE(taskType == ETaskType::CPU, "Error: expect learn on CPU task type, got " << taskType);
@@ -118,8 +147,9 @@ public:
     void OutputMeta();
     void InitContext(const NCB::TTrainingForCPUDataProviders& data);
     void SaveProgress();
-    bool TryLoadProgress();
+    bool TryLoadProgress(const NCB::TTrainingForCPUDataProviders& data);
     bool UseTreeLevelCaching() const;
+    bool ReuseLeafStats() const;
 
 public:
     TRestorableFastRng64 Rand;
@@ -128,17 +158,26 @@ public:
     TOutputFiles Files;
 
     TCalcScoreFold SmallestSplitSideDocs;
+    TCalcScoreFold NewLeavesDocs; // documents of leaves created by last splits of a non-symmetric tree
     TCalcScoreFold SampledDocs;
     TBucketStatsCache PrevTreeLevelStats;
     TObj<NPar::IRootEnvironment> RootEnvironment;
     TObj<NPar::IEnvironment> SharedTrainData;
     TProfileInfo Profile;
+    TOnlineCtrCache OnlineCtrCache;
 
 private:
     bool UseTreeLevelCachingFlag;
+    bool ReuseLeafStatsFlag;
 };
 
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
     ui32 approxDimension);
+
+// non-symmetric trees: keep per-leaf stats of split candidates and calculate stats only for smaller children
+bool NeedToReuseLeafStats(
+    const NCatboostOptions::TCatBoostOptions& params,
+    ui32 maxBodyTailCount,
+    ui32 approxDimension);
@@ -8,10 +8,15 @@
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
+#include <catboost/libs/index_range/index_range.h>
 #include <catboost/libs/model/model.h>
 
+#include <library/chromium_trace/interface.h>
+
 #include <util/generic/bitops.h>
+#include <util/generic/cast.h>
 #include <util/generic/utility.h>
+#include <util/generic/ymath.h>
 #include <util/system/mem_info.h>
 #include <util/thread/singleton.h>
 
@@ -81,6 +86,36 @@ void CalcNormalization(const TVector<float>& priors, TVector<float>* shift, TVec
 
 
 
+ui32 GetCtrValuesBitsPerKey(ui32 ctrBorderCount) {
+    // values are in [0, ctrBorderCount]
+    if (ctrBorderCount < (1 << 2)) {
+        return 2;
+    }
+    return ctrBorderCount < (1 << 4) ? 4 : CHAR_BIT;
+}
+
+// packs values in place in the layout read by NCB::TPackedQuantizedValuesRef
+static void PackCtrValues(ui32 bitsPerKey, TVector<ui8>* values) {
+    if (bitsPerKey == CHAR_BIT) {
+        return;
+    }
+    const size_t valuesPerByte = CHAR_BIT / bitsPerKey;
+    const size_t packedSize = CeilDiv(values->size(), valuesPerByte);
+    ui8* data = values->data();
+    for (size_t byteIdx = 0; byteIdx < packedSize; ++byteIdx) {
+        // byteIdx <= idx of the first value in byte, so values are not overwritten before they are read
+        const size_t begin = byteIdx * valuesPerByte;
+        const size_t end = Min(values->size(), begin + valuesPerByte);
+        ui8 packed = 0;
+        for (size_t idx = begin; idx < end; ++idx) {
+            Y_ASSERT(data[idx] < (1 << bitsPerKey));
+            packed |= data[idx] << ((idx - begin) * bitsPerKey);
+        }
+        data[byteIdx] = packed;
+    }
+    TVector<ui8>(values->begin(), values->begin() + packedSize).swap(*values);
+}
+
 static void UpdateGoodCount(int curCount, ECtrType ctrType, int* goodCount) {
     if (ctrType == ECtrType::Buckets) {
         *goodCount = curCount;
@@ -90,34 +125,53 @@ static void UpdateGoodCount(int curCount, ECtrType ctrType, int* goodCount) {
 }
 
 namespace {
+    /* Objects of one online ctr calculation task.
+     * Learn objects [Begin, LearnEnd) update counters, the rest of the range only reads them.
+     */
+    struct TOnlineCtrRange {
+        size_t Begin = 0;
+        size_t End = 0;
+        size_t LearnEnd = 0;
+    };
+
     // Blocked 2-stage calculation director
     class TBlockedCalcer {
     public:
-        explicit TBlockedCalcer(int blockSize)
+        explicit TBlockedCalcer(size_t blockSize)
             : BlockSize(blockSize) {
         }
         template <typename TCalc1, typename TCalc2>
-        void Calc(TCalc1 calc1, TCalc2 calc2, int docOffset, int docCount) {
-            for (int blockStart = 0; blockStart < docCount; blockStart += BlockSize) {
-                const int nextBlockStart = Min<int>(docCount, blockStart + BlockSize);
-                calc1(blockStart, nextBlockStart, docOffset);
-                calc2(blockStart, nextBlockStart, docOffset);
+        void Calc(TCalc1 calc1, TCalc2 calc2, const TOnlineCtrRange& range) {
+            const size_t learnEnd = Min(range.End, Max(range.Begin, range.LearnEnd));
+            CalcBlocks(calc1, calc2, range.Begin, learnEnd, /*isLearn*/ true);
+            CalcBlocks(calc1, calc2, learnEnd, range.End, /*isLearn*/ false);
+        }
+
+    private:
+        template <typename TCalc1, typename TCalc2>
+        void CalcBlocks(TCalc1& calc1, TCalc2& calc2, size_t begin, size_t end, bool isLearn) {
+            for (size_t blockStart = begin; blockStart < end; blockStart += BlockSize) {
+                const size_t nextBlockStart = Min(end, blockStart + BlockSize);
+                calc1(blockStart, nextBlockStart, isLearn);
+                calc2(blockStart, nextBlockStart);
             }
         }
 
     private:
-        const int BlockSize;
+        const size_t BlockSize;
     };
 }
 
-static void CalcOnlineCTRClasses(const TVector<size_t>& testOffsets,
-                                 const TVector<ui64>& enumeratedCatFeatures,
+// initialClassCounts are [leafIdx * targetClassesCount + classIdx] counts of preceding objects, empty means zeros
+static void CalcOnlineCTRClasses(const TOnlineCtrRange& range,
+                                 TConstArrayRef<ui64> enumeratedCatFeatures,
                                  size_t leafCount,
                                  const TVector<int>& permutedTargetClass,
                                  int targetClassesCount, int targetBorderCount,
                                  const TVector<float>& priors,
                                  int ctrBorderCount,
                                  ECtrType ctrType,
+                                 TConstArrayRef<int> initialClassCounts,
                                  TArray2D<TVector<ui8>>* feature) {
     TVector<float> shift;
     TVector<float> norm;
@@ -127,10 +181,19 @@ static void CalcOnlineCTRClasses(const TVector<size_t>& testOffsets,
     TVector<int> totalCountByDoc(blockSize);
     TVector<TVector<int>> goodCountByBorderByDoc(targetBorderCount, TVector<int>(blockSize));
     TBucketsView bv(leafCount, targetClassesCount);
+    if (!initialClassCounts.empty()) {
+        for (size_t leafIdx = 0; leafIdx < leafCount; ++leafIdx) {
+            auto bordersData = bv.GetBorders(leafIdx);
+            for (int classIdx = 0; classIdx < targetClassesCount; ++classIdx) {
+                bordersData[classIdx] = initialClassCounts[leafIdx * targetClassesCount + classIdx];
+                bv.GetTotal(leafIdx) += bordersData[classIdx];
+            }
+        }
+    }
 
-    auto calcGoodCounts = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-            const auto elemId = enumeratedCatFeatures[docOffset + docId];
+    auto calcGoodCounts = [&](size_t blockStart, size_t nextBlockStart, bool isLearn) {
+        for (size_t docId = blockStart; docId < nextBlockStart; ++docId) {
+            const auto elemId = enumeratedCatFeatures[docId];
 
             int goodCount = totalCountByDoc[docId - blockStart] = bv.GetTotal(elemId);
             auto bordersData = bv.GetBorders(elemId);
@@ -139,22 +202,22 @@ static void CalcOnlineCTRClasses(const TVector<size_t>& testOffsets,
                 goodCountByBorderByDoc[border][docId - blockStart] = goodCount;
             }
 
-            if (docOffset == 0) {
+            if (isLearn) {
                 ++bordersData[permutedTargetClass[docId]];
                 ++bv.GetTotal(elemId);
             }
         }
     };
 
-    auto calcCTRs = [&](int blockStart, int nextBlockStart, int docOffset) {
+    auto calcCTRs = [&](size_t blockStart, size_t nextBlockStart) {
         for (int border = 0; border < targetBorderCount; ++border) {
             for (int prior = 0; prior < priors.ysize(); ++prior) {
                 const float priorX = priors[prior];
                 const float shiftX = shift[prior];
                 const float normX = norm[prior];
                 const int* goodCountData = goodCountByBorderByDoc[border].data();
-                ui8* featureData = docOffset + (*feature)[border][prior].data();
-                for (int docId = blockStart; docId < nextBlockStart; ++docId) {
+                ui8* featureData = (*feature)[border][prior].data();
+                for (size_t docId = blockStart; docId < nextBlockStart; ++docId) {
                     featureData[docId] = CalcCTR(goodCountData[docId - blockStart], totalCountByDoc[docId - blockStart],
                                                  priorX, shiftX, normX, ctrBorderCount);
                 }
@@ -163,21 +226,16 @@ static void CalcOnlineCTRClasses(const TVector<size_t>& testOffsets,
     };
 
     TBlockedCalcer calcer(blockSize);
-    const size_t learnSampleCount = testOffsets[0];
-    calcer.Calc(calcGoodCounts, calcCTRs, 0, learnSampleCount);
-    for (size_t docOffset = learnSampleCount, testIdx = 0; testIdx < testOffsets.size() - 1; ++testIdx) {
-        const size_t testSampleCount = testOffsets[testIdx + 1] - testOffsets[testIdx];
-        calcer.Calc(calcGoodCounts, calcCTRs, docOffset, testSampleCount);
-        docOffset += testSampleCount;
-    }
+    calcer.Calc(calcGoodCounts, calcCTRs, range);
 }
 
-static void CalcOnlineCTRSimple(const TVector<size_t>& testOffsets,
-                                const TVector<ui64>& enumeratedCatFeatures,
+static void CalcOnlineCTRSimple(const TOnlineCtrRange& range,
+                                TConstArrayRef<ui64> enumeratedCatFeatures,
                                 size_t leafCount,
                                 const TVector<int>& permutedTargetClass,
                                 const TVector<float>& priors,
                                 int ctrBorderCount,
+                                TConstArrayRef<int> initialClassCounts,
                                 TArray2D<TVector<ui8>>* feature) {
     TVector<float> shift;
     TVector<float> norm;
@@ -185,27 +243,33 @@ static void CalcOnlineCTRSimple(const TVector<size_t>& testOffsets,
 
     const int blockSize = 1000;
     auto ctrArrSimple = TCtrCalcer::GetCtrHistoryArr(leafCount + blockSize);
+    if (!initialClassCounts.empty()) {
+        for (size_t leafIdx = 0; leafIdx < leafCount; ++leafIdx) {
+            ctrArrSimple[leafIdx].N[0] = initialClassCounts[leafIdx * SIMPLE_CLASSES_COUNT];
+            ctrArrSimple[leafIdx].N[1] = initialClassCounts[leafIdx * SIMPLE_CLASSES_COUNT + 1];
+        }
+    }
     auto totalCount = reinterpret_cast<int*>(ctrArrSimple.data() + leafCount);
     auto goodCount = totalCount + blockSize;
 
-    auto calcGoodCount = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-            TCtrHistory& elem = ctrArrSimple[enumeratedCatFeatures[docOffset + docId]];
+    auto calcGoodCount = [&](size_t blockStart, size_t nextBlockStart, bool isLearn) {
+        for (size_t docId = blockStart; docId < nextBlockStart; ++docId) {
+            TCtrHistory& elem = ctrArrSimple[enumeratedCatFeatures[docId]];
             goodCount[docId - blockStart] = elem.N[1];
             totalCount[docId - blockStart] = elem.N[0] + elem.N[1];
-            if (docOffset == 0) {
+            if (isLearn) {
                 ++elem.N[permutedTargetClass[docId]];
             }
         }
     };
 
-    auto calcCTRs = [&](int blockStart, int nextBlockStart, int docOffset) {
+    auto calcCTRs = [&](size_t blockStart, size_t nextBlockStart) {
         for (int prior = 0; prior < priors.ysize(); ++prior) {
             const float priorX = priors[prior];
             const float shiftX = shift[prior];
             const float normX = norm[prior];
-            ui8* featureData = docOffset + (*feature)[0][prior].data();
-            for (int docId = blockStart; docId < nextBlockStart; ++docId) {
+            ui8* featureData = (*feature)[0][prior].data();
+            for (size_t docId = blockStart; docId < nextBlockStart; ++docId) {
                 featureData[docId] = CalcCTR(goodCount[docId - blockStart], totalCount[docId - blockStart],
                                              priorX, shiftX, normX, ctrBorderCount);
             }
@@ -213,22 +277,17 @@ static void CalcOnlineCTRSimple(const TVector<size_t>& testOffsets,
     };
 
     TBlockedCalcer calcer(blockSize);
-    const size_t learnSampleCount = testOffsets[0];
-    calcer.Calc(calcGoodCount, calcCTRs, 0, learnSampleCount);
-    for (size_t docOffset = learnSampleCount, testIdx = 0; testIdx < testOffsets.size() - 1; ++testIdx) {
-        const size_t testSampleCount = testOffsets[testIdx + 1] - testOffsets[testIdx];
-        calcer.Calc(calcGoodCount, calcCTRs, docOffset, testSampleCount);
-        docOffset += testSampleCount;
-    }
+    calcer.Calc(calcGoodCount, calcCTRs, range);
 }
 
-static void CalcOnlineCTRMean(const TVector<size_t>& testOffsets,
-                              const TVector<ui64>& enumeratedCatFeatures,
+static void CalcOnlineCTRMean(const TOnlineCtrRange& range,
+                              TConstArrayRef<ui64> enumeratedCatFeatures,
                               size_t leafCount,
                               const TVector<int>& permutedTargetClass,
                               int targetBorderCount,
                               const TVector<float>& priors,
                               int ctrBorderCount,
+                              TConstArrayRef<int> initialClassCounts,
                               TArray2D<TVector<ui8>>* feature) {
     TVector<float> shift;
     TVector<float> norm;
@@ -238,25 +297,37 @@ static void CalcOnlineCTRMean(const TVector<size_t>& testOffsets,
     TVector<float> sum(blockSize);
     TVector<int> count(blockSize);
     auto ctrArrMean = TCtrCalcer::GetCtrMeanHistoryArr(leafCount);
+    if (!initialClassCounts.empty()) {
+        const int targetClassesCount = targetBorderCount + 1;
+        for (size_t leafIdx = 0; leafIdx < leafCount; ++leafIdx) {
+            int classSum = 0;
+            for (int classIdx = 0; classIdx < targetClassesCount; ++classIdx) {
+                const int classCount = initialClassCounts[leafIdx * targetClassesCount + classIdx];
+                classSum += classIdx * classCount;
+                ctrArrMean[leafIdx].Count += classCount;
+            }
+            ctrArrMean[leafIdx].Sum = static_cast<float>(classSum) / targetBorderCount;
+        }
+    }
 
-    auto calcCount = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-            TCtrMeanHistory& elem = ctrArrMean[enumeratedCatFeatures[docOffset + docId]];
+    auto calcCount = [&](size_t blockStart, size_t nextBlockStart, bool isLearn) {
+        for (size_t docId = blockStart; docId < nextBlockStart; ++docId) {
+            TCtrMeanHistory& elem = ctrArrMean[enumeratedCatFeatures[docId]];
             sum[docId - blockStart] = elem.Sum;
             count[docId - blockStart] = elem.Count;
-            if (docOffset == 0) {
+            if (isLearn) {
                 elem.Add(static_cast<float>(permutedTargetClass[docId]) / targetBorderCount);
             }
         }
     };
 
-    auto calcCTRs = [&](int blockStart, int nextBlockStart, int docOffset) {
+    auto calcCTRs = [&](size_t blockStart, size_t nextBlockStart) {
         for (int prior = 0; prior < priors.ysize(); ++prior) {
             const float priorX = priors[prior];
             const float shiftX = shift[prior];
             const float normX = norm[prior];
-            ui8* featureData = docOffset + (*feature)[0][prior].data();
-            for (int docId = blockStart; docId < nextBlockStart; ++docId) {
+            ui8* featureData = (*feature)[0][prior].data();
+            for (size_t docId = blockStart; docId < nextBlockStart; ++docId) {
                 featureData[docId] = CalcCTR(sum[docId - blockStart], count[docId - blockStart],
                                              priorX, shiftX, normX, ctrBorderCount);
             }
@@ -264,18 +335,12 @@ static void CalcOnlineCTRMean(const TVector<size_t>& testOffsets,
     };
 
     TBlockedCalcer calcer(blockSize);
-    const size_t learnSampleCount = testOffsets[0];
-    calcer.Calc(calcCount, calcCTRs, 0, learnSampleCount);
-    for (size_t docOffset = learnSampleCount, testIdx = 0; testIdx < testOffsets.size() - 1; ++testIdx) {
-        const size_t testSampleCount = testOffsets[testIdx + 1] - testOffsets[testIdx];
-        calcer.Calc(calcCount, calcCTRs, docOffset, testSampleCount);
-        docOffset += testSampleCount;
-    }
+    calcer.Calc(calcCount, calcCTRs, range);
 }
 
-static void CalcOnlineCTRCounter(const TVector<size_t>& testOffsets,
+static void CalcOnlineCTRCounter(const TOnlineCtrRange& range,
                                  const TVector<int>& counterCTRTotal,
-                                 const TVector<ui64>& enumeratedCatFeatures,
+                                 TConstArrayRef<ui64> enumeratedCatFeatures,
                                  int denominator,
                                  const TVector<float>& priors,
                                  int ctrBorderCount,
@@ -286,169 +351,184 @@ static void CalcOnlineCTRCounter(const TVector<size_t>& testOffsets,
 
     const int blockSize = 1000;
     auto ctrTotal = TCtrCalcer::GetCtrArrTotal(blockSize);
-    auto calcTotal = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-            const auto elemId = enumeratedCatFeatures[docOffset + docId];
+    auto calcTotal = [&](size_t blockStart, size_t nextBlockStart, bool /*isLearn*/) {
+        for (size_t docId = blockStart; docId < nextBlockStart; ++docId) {
+            const auto elemId = enumeratedCatFeatures[docId];
             ctrTotal[docId - blockStart] = counterCTRTotal[elemId];
         }
     };
 
-    auto calcCTRs = [&](int blockStart, int nextBlockStart, int docOffset) {
+    auto calcCTRs = [&](size_t blockStart, size_t nextBlockStart) {
         for (int prior = 0; prior < priors.ysize(); ++prior) {
             const float priorX = priors[prior];
             const float shiftX = shift[prior];
             const float normX = norm[prior];
-            ui8* featureData = docOffset + (*feature)[0][prior].data();
-            for (int docId = blockStart; docId < nextBlockStart; ++docId) {
+            ui8* featureData = (*feature)[0][prior].data();
+            for (size_t docId = blockStart; docId < nextBlockStart; ++docId) {
                 featureData[docId] = CalcCTR(ctrTotal[docId - blockStart], denominator, priorX, shiftX, normX, ctrBorderCount);
             }
         }
     };
 
     TBlockedCalcer calcer(blockSize);
-    const size_t learnSampleCount = testOffsets[0];
-    calcer.Calc(calcTotal, calcCTRs, 0, learnSampleCount);
-    for (size_t docOffset = learnSampleCount, testIdx = 0; testIdx < testOffsets.size() - 1; ++testIdx) {
-        const size_t testSampleCount = testOffsets[testIdx + 1] - testOffsets[testIdx];
-        calcer.Calc(calcTotal, calcCTRs, docOffset, testSampleCount);
-        docOffset += testSampleCount;
-    }
+    calcer.Calc(calcTotal, calcCTRs, range);
 }
 
-static inline void CountOnlineCTRTotal(const TVector<ui64>& hashArr, int sampleCount, TVector<int>* counterCTRTotal) {
-    for (int sampleIdx = 0; sampleIdx < sampleCount; ++sampleIdx) {
-        const auto elemId = hashArr[sampleIdx];
-        ++(*counterCTRTotal)[elemId];
+void CalcOnlineCtrHashes(const TQuantizedForCPUObjectsDataProvider& objectsData,
+                         const TFeaturesArraySubsetIndexing& subsetIndexing,
+                         const TProjection& proj,
+                         TArrayRef<ui64> hashes) {
+    Fill(hashes.begin(), hashes.end(), 0);
+    if (hashes.empty()) {
+        return;
     }
-}
-
-void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
-                       const TFold& fold,
-                       const TProjection& proj,
-                       const TLearnContext* ctx,
-                       TOnlineCTR* dst) {
-    const TCtrHelper& ctrHelper = ctx->CtrsHelper;
-    const auto& ctrInfo = ctrHelper.GetCtrInfo(proj);
-    dst->Feature.resize(ctrInfo.size());
-    size_t learnSampleCount = data.Learn->GetObjectCount();
-    const TVector<size_t>& testOffsets = data.CalcTestOffsets();
-    size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
-
-    const auto& quantizedFeaturesInfo = *data.Learn->ObjectsData->GetQuantizedFeaturesInfo();
-
-    using THashArr = TVector<ui64>;
-    using TRehashHash = TDenseHash<ui64, ui32>;
-    Y_STATIC_THREAD(THashArr) tlsHashArr;
-    Y_STATIC_THREAD(TRehashHash) rehashHashTlsVal;
-    TVector<ui64>& hashArr = tlsHashArr.Get();
     if (proj.IsSingleCatFeature()) {
         // Shortcut for simple ctrs
-
         auto catFeatureIdx = TCatFeatureIdx((ui32)proj.CatFeatures[0]);
-
-        Clear(&hashArr, totalSampleCount);
-        TArrayRef<ui64> hashArrView = hashArr;
-        if (learnSampleCount > 0) {
-            ProcessFeatureForCalcHashes<IQuantizedCatValuesHolder>(
-                data.Learn->ObjectsData->GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
-                fold.LearnPermutationFeaturesSubset,
-                /*processBinaryInPacks*/ false,
-                /*isBinaryFeatureEquals1*/ false, // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                [&]() { return *data.Learn->ObjectsData->GetCatFeature(*catFeatureIdx); },
-                [&](ui32 packIdx) { return data.Learn->ObjectsData->GetBinaryFeaturesPack(packIdx); },
-                [hashArrView] (ui32 i, ui32 featureValue) {
-                    hashArrView[i] = (ui64)featureValue + 1;
-                }
-            );
-        }
-        for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
-            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-
-            ProcessFeatureForCalcHashes<IQuantizedCatValuesHolder>(
-                data.Test[testIdx]->ObjectsData->GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
-                data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                /*processBinaryInPacks*/ false,
-                /*isBinaryFeatureEquals1*/ false, // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                [&]() { return *data.Test[testIdx]->ObjectsData->GetCatFeature(*catFeatureIdx); },
-                [&](ui32 packIdx) { return data.Test[testIdx]->ObjectsData->GetBinaryFeaturesPack(packIdx); },
-                [hashArrView, docOffset] (ui32 i, ui32 featureValue) {
-                    hashArrView[docOffset + i] = (ui64)featureValue + 1;
-                }
-            );
-
-            docOffset += testSampleCount;
-        }
-        rehashHashTlsVal.Get().MakeEmpty(
-            quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(proj.CatFeatures[0])).OnLearnOnly
+        ProcessFeatureForCalcHashes<IQuantizedCatValuesHolder>(
+            objectsData.GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
+            subsetIndexing,
+            /*processBinaryInPacks*/ false,
+            /*isBinaryFeatureEquals1*/ false, // unused
+            TArrayRef<TBinaryFeaturesPack>(), // unused
+            TArrayRef<TBinaryFeaturesPack>(), // unused
+            [&]() { return *objectsData.GetCatFeature(*catFeatureIdx); },
+            [&](ui32 packIdx) { return objectsData.GetBinaryFeaturesPack(packIdx); },
+            [hashes] (ui32 i, ui32 featureValue) {
+                hashes[i] = (ui64)featureValue + 1;
+            }
         );
     } else {
-        Clear(&hashArr, totalSampleCount);
         CalcHashes(
             proj,
-            *data.Learn->ObjectsData,
-            fold.LearnPermutationFeaturesSubset,
+            objectsData,
+            subsetIndexing,
             nullptr,
             /*processBinaryFeaturesInPacks*/ true,
-            &hashArr[0],
-            &hashArr[0] + learnSampleCount);
-        for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
-            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-            CalcHashes(
-                proj,
-                *data.Test[testIdx]->ObjectsData,
-                data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                nullptr,
-                /*processBinaryFeaturesInPacks*/ true,
-                &hashArr[0] + docOffset,
-                &hashArr[0] + docOffset + testSampleCount);
-            docOffset += testSampleCount;
-        }
-        size_t approxBucketsCount = 1;
-        for (auto cf : proj.CatFeatures) {
-            approxBucketsCount *= quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(cf)).OnLearnOnly;
-            if (approxBucketsCount > learnSampleCount) {
-                break;
-            }
-        }
-        rehashHashTlsVal.Get().MakeEmpty(Min(learnSampleCount, approxBucketsCount));
+            hashes.data(),
+            hashes.data() + hashes.size());
     }
-    ui64 topSize = ctx->Params.CatFeatureParams->CtrLeafCountLimit;
-    if (proj.IsSingleCatFeature() && ctx->Params.CatFeatureParams->StoreAllSimpleCtrs) {
-        topSize = Max<ui64>();
+}
+
+static inline void CountOnlineCTRTotal(TConstArrayRef<ui64> hashArr, int sampleCount, TVector<int>* counterCTRTotal) {
+    for (int sampleIdx = 0; sampleIdx < sampleCount; ++sampleIdx) {
+        const auto elemId = hashArr[sampleIdx];
+        ++(*counterCTRTotal)[elemId];
     }
-    auto leafCount = ComputeReindexHash(topSize, rehashHashTlsVal.GetPtr(), &hashArr[0], &hashArr[0] + learnSampleCount);
-    dst->CounterUniqueValuesCount = dst->UniqueValuesCount = leafCount;
+}
 
-    for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
-        const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-        leafCount = UpdateReindexHash(rehashHashTlsVal.GetPtr(), &hashArr[0] + docOffset, &hashArr[0] + docOffset + testSampleCount);
-        docOffset += testSampleCount;
+// minimal number of objects in a block of parallel online ctr calculation
+static constexpr size_t MinParallelBlockSize = 100000;
+
+static bool NeedsClassCounts(ECtrType ctrType) {
+    return ctrType != ECtrType::Counter;
+}
+
+// learn objects can be split into blocks only if the ctr state is restored exactly from class counts
+static bool CanSplitLearn(ECtrType ctrType, int targetClassesCount) {
+    // BinarizedTargetMeanValue accumulates float sums of class / targetBorderCount, they are integer only for binary targets
+    return ctrType != ECtrType::BinarizedTargetMeanValue || targetClassesCount <= SIMPLE_CLASSES_COUNT;
+}
+
+static size_t GetLearnBlockCount(size_t learnSampleCount, size_t leafCount, int maxTargetClassesCount, int threadCount) {
+    // counts of every block must not take more memory than its objects
+    const size_t countsSize = leafCount * maxTargetClassesCount;
+    return Max<size_t>(
+        1,
+        Min<size_t>(threadCount, learnSampleCount / MinParallelBlockSize, learnSampleCount / Max<size_t>(1, countsSize)));
+}
+
+/* Parallel prefix of class counts over learn blocks:
+ * [blockIdx][leafIdx * targetClassesCount + classIdx] counts of objects preceding the block,
+ * the last element contains counts of all learn objects.
+ */
+static TVector<TVector<int>> CalcBlockInitialClassCounts(const NCB::TSimpleIndexRangesGenerator<size_t>& learnBlocks,
+                                                         TConstArrayRef<ui64> hashArr,
+                                                         size_t leafCount,
+                                                         const TVector<int>& permutedTargetClass,
+                                                         int targetClassesCount,
+                                                         TConstArrayRef<int> initialClassCounts,
+                                                         NPar::TLocalExecutor* localExecutor) {
+    const size_t blockCount = learnBlocks.RangesCount();
+    const size_t countsSize = leafCount * targetClassesCount;
+    TVector<TVector<int>> blockCounts(blockCount + 1);
+    if (initialClassCounts.empty()) {
+        blockCounts[0].resize(countsSize);
+    } else {
+        blockCounts[0].assign(initialClassCounts.begin(), initialClassCounts.end());
     }
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            auto& counts = blockCounts[blockIdx + 1];
+            counts.resize(countsSize);
+            for (auto docIdx : learnBlocks.GetRange(blockIdx).Iter()) {
+                ++counts[hashArr[docIdx] * targetClassesCount + permutedTargetClass[docIdx]];
+            }
+        },
+        0,
+        SafeIntegerCast<int>(blockCount),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        SafeIntegerCast<ui32>(countsSize),
+        [&] (ui32 countIdx) {
+            for (size_t blockIdx = 1; blockIdx <= blockCount; ++blockIdx) {
+                blockCounts[blockIdx][countIdx] += blockCounts[blockIdx - 1][countIdx];
+            }
+        });
+    return blockCounts;
+}
 
-    TVector<int> counterCTRTotal;
-    int counterCTRDenominator = 0;
-    if (AnyOf(ctrInfo.begin(), ctrInfo.begin() + dst->Feature.ysize(), [] (const auto& info) { return info.Type == ECtrType::Counter; })) {
-        counterCTRTotal.resize(leafCount);
-        int sampleCount = learnSampleCount;
-        if (ctx->Params.CatFeatureParams->CounterCalcMethod == ECounterCalc::Full) {
-            dst->CounterUniqueValuesCount = leafCount;
-            sampleCount = hashArr.ysize();
+/* initialClassCounts are [targetClassifierIdx][leafIdx * targetClassesCount + classIdx], empty means zeros
+ * hashArr contains learn objects followed by test objects.
+ * Ctrs are calculated in parallel if localExecutor is not nullptr: learn objects of large folds are split into blocks
+ * starting with class counts of preceding blocks, test objects are split into blocks starting with counts of all learn.
+ */
+static void CalcOnlineCTRsForAllTypes(const TVector<TCtrInfo>& ctrInfo,
+                                      const TFold& fold,
+                                      size_t learnSampleCount,
+                                      TConstArrayRef<ui64> hashArr,
+                                      size_t leafCount,
+                                      TConstArrayRef<TVector<int>> initialClassCounts,
+                                      const TVector<int>& counterCTRTotal,
+                                      int counterCTRDenominator,
+                                      NPar::TLocalExecutor* localExecutor,
+                                      TOnlineCTR* dst) {
+    const size_t totalSampleCount = hashArr.size();
+    const int threadCount = localExecutor ? localExecutor->GetThreadCount() + 1 : 1;
+
+    int maxTargetClassesCount = 1;
+    for (const auto& info : ctrInfo) {
+        if (NeedsClassCounts(info.Type)) {
+            maxTargetClassesCount = Max(maxTargetClassesCount, fold.TargetClassesCount[info.TargetClassifierIdx]);
         }
-        CountOnlineCTRTotal(hashArr, sampleCount, &counterCTRTotal);
-        counterCTRDenominator = *MaxElement(counterCTRTotal.begin(), counterCTRTotal.end());
     }
+    const size_t learnBlockSize = Max<size_t>(
+        1,
+        CeilDiv(learnSampleCount, GetLearnBlockCount(learnSampleCount, leafCount, maxTargetClassesCount, threadCount)));
+    const NCB::TSimpleIndexRangesGenerator<size_t> learnBlocks(NCB::TIndexRange<size_t>(learnSampleCount), learnBlockSize);
+    const bool splitLearn = learnBlocks.RangesCount() > 1;
+    const NCB::TSimpleIndexRangesGenerator<size_t> testBlocks(
+        NCB::TIndexRange<size_t>(learnSampleCount, totalSampleCount),
+        Max<size_t>(learnBlockSize, CeilDiv<size_t>(totalSampleCount - learnSampleCount, threadCount)));
+
+    struct TCtrTask {
+        int CtrIdx;
+        TOnlineCtrRange Range;
+        TConstArrayRef<int> InitialClassCounts;
+    };
+    TVector<TCtrTask> tasks;
+    TVector<TVector<TVector<int>>> blockInitialClassCounts(fold.TargetClassesCount.size()); // [classifierIdx][blockIdx]
 
+    dst->BitsPerKey.yresize(dst->Feature.size());
     for (int ctrIdx = 0; ctrIdx < dst->Feature.ysize(); ++ctrIdx) {
+        dst->BitsPerKey[ctrIdx] = GetCtrValuesBitsPerKey(ctrInfo[ctrIdx].BorderCount);
         const ECtrType ctrType = ctrInfo[ctrIdx].Type;
         const ui32 classifierId = ctrInfo[ctrIdx].TargetClassifierIdx;
         int targetClassesCount = fold.TargetClassesCount[classifierId];
 
         const ui32 targetBorderCount = GetTargetBorderCount(ctrInfo[ctrIdx], targetClassesCount);
-        const ui32 ctrBorderCount = ctrInfo[ctrIdx].BorderCount;
         const auto& priors = ctrInfo[ctrIdx].Priors;
         dst->Feature[ctrIdx].SetSizes(priors.size(), targetBorderCount);
 
@@ -458,31 +538,74 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
             }
         }
 
+        const TConstArrayRef<int> classifierInitialClassCounts
+            = initialClassCounts.empty() ? TConstArrayRef<int>() : initialClassCounts[classifierId];
+
+        if (!splitLearn || !CanSplitLearn(ctrType, targetClassesCount)) {
+            tasks.push_back(TCtrTask{ctrIdx, TOnlineCtrRange{0, totalSampleCount, learnSampleCount}, classifierInitialClassCounts});
+            continue;
+        }
+        auto& blockCounts = blockInitialClassCounts[classifierId];
+        if (NeedsClassCounts(ctrType) && blockCounts.empty()) {
+            blockCounts = CalcBlockInitialClassCounts(
+                learnBlocks,
+                hashArr,
+                leafCount,
+                fold.LearnTargetClass[classifierId],
+                targetClassesCount,
+                classifierInitialClassCounts,
+                localExecutor);
+        }
+        const auto getBlockCounts = [&] (size_t blockIdx) {
+            return NeedsClassCounts(ctrType) ? TConstArrayRef<int>(blockCounts[blockIdx]) : TConstArrayRef<int>();
+        };
+        for (auto blockIdx : xrange(learnBlocks.RangesCount())) {
+            const auto block = learnBlocks.GetRange(blockIdx);
+            tasks.push_back(TCtrTask{ctrIdx, TOnlineCtrRange{block.Begin, block.End, block.End}, getBlockCounts(blockIdx)});
+        }
+        for (auto blockIdx : xrange(testBlocks.RangesCount())) {
+            const auto block = testBlocks.GetRange(blockIdx);
+            tasks.push_back(
+                TCtrTask{ctrIdx, TOnlineCtrRange{block.Begin, block.End, block.Begin}, getBlockCounts(learnBlocks.RangesCount())});
+        }
+    }
+
+    const auto calcTask = [&] (int taskIdx) {
+        const auto& task = tasks[taskIdx];
+        const int ctrIdx = task.CtrIdx;
+        const ECtrType ctrType = ctrInfo[ctrIdx].Type;
+        const ui32 classifierId = ctrInfo[ctrIdx].TargetClassifierIdx;
+        int targetClassesCount = fold.TargetClassesCount[classifierId];
+        const ui32 ctrBorderCount = ctrInfo[ctrIdx].BorderCount;
+        const auto& priors = ctrInfo[ctrIdx].Priors;
+
         if (ctrType == ECtrType::Borders && targetClassesCount == SIMPLE_CLASSES_COUNT) {
             CalcOnlineCTRSimple(
-                testOffsets,
+                task.Range,
                 hashArr,
                 leafCount,
                 fold.LearnTargetClass[classifierId],
                 priors,
                 ctrBorderCount,
+                task.InitialClassCounts,
                 &dst->Feature[ctrIdx]);
 
         } else if (ctrType == ECtrType::BinarizedTargetMeanValue) {
             CalcOnlineCTRMean(
-                testOffsets,
+                task.Range,
                 hashArr,
                 leafCount,
                 fold.LearnTargetClass[classifierId],
                 targetClassesCount - 1,
                 priors,
                 ctrBorderCount,
+                task.InitialClassCounts,
                 &dst->Feature[ctrIdx]);
 
         } else if (ctrType == ECtrType::Buckets ||
                    (ctrType == ECtrType::Borders && targetClassesCount > SIMPLE_CLASSES_COUNT)) {
             CalcOnlineCTRClasses(
-                testOffsets,
+                task.Range,
                 hashArr,
                 leafCount,
                 fold.LearnTargetClass[classifierId],
@@ -491,11 +614,12 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
                 priors,
                 ctrBorderCount,
                 ctrType,
+                task.InitialClassCounts,
                 &dst->Feature[ctrIdx]);
         } else {
             Y_ASSERT(ctrType == ECtrType::Counter);
             CalcOnlineCTRCounter(
-                testOffsets,
+                task.Range,
                 counterCTRTotal,
                 hashArr,
                 counterCTRDenominator,
@@ -503,7 +627,236 @@ void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
                 ctrBorderCount,
                 &dst->Feature[ctrIdx]);
         }
+    };
+    // values are calculated as ui8 because tasks write adjacent object ranges, then packed
+    TVector<std::pair<ui32, TVector<ui8>*>> valuesToPack;
+    for (int ctrIdx = 0; ctrIdx < dst->Feature.ysize(); ++ctrIdx) {
+        auto& ctrFeature = dst->Feature[ctrIdx];
+        for (size_t border = 0; border < ctrFeature.GetYSize(); ++border) {
+            for (size_t prior = 0; prior < ctrFeature.GetXSize(); ++prior) {
+                valuesToPack.emplace_back(dst->BitsPerKey[ctrIdx], &ctrFeature[border][prior]);
+            }
+        }
+    }
+    const auto packTask = [&] (int idx) {
+        PackCtrValues(valuesToPack[idx].first, valuesToPack[idx].second);
+    };
+
+    if (localExecutor) {
+        localExecutor->ExecRange(calcTask, 0, tasks.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+        localExecutor->ExecRange(packTask, 0, valuesToPack.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    } else {
+        for (auto taskIdx : xrange(tasks.ysize())) {
+            calcTask(taskIdx);
+        }
+        for (auto idx : xrange(valuesToPack.ysize())) {
+            packTask(idx);
+        }
+    }
+}
+
+static bool HasCounterCtrs(const TVector<TCtrInfo>& ctrInfo) {
+    return AnyOf(ctrInfo, [] (const auto& info) { return info.Type == ECtrType::Counter; });
+}
+
+void ComputeOnlineCTRs(const TTrainingForCPUDataProviders& data,
+                       const TFold& fold,
+                       const TProjection& proj,
+                       const TLearnContext* ctx,
+                       TOnlineCTR* dst) {
+    CHROMIUM_TRACE_SCOPE("Compute online CTRs");
+
+    const TCtrHelper& ctrHelper = ctx->CtrsHelper;
+    const auto& ctrInfo = ctrHelper.GetCtrInfo(proj);
+    dst->Feature.resize(ctrInfo.size());
+    size_t learnSampleCount = data.Learn->GetObjectCount();
+    size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
+
+    const auto& quantizedFeaturesInfo = *data.Learn->ObjectsData->GetQuantizedFeaturesInfo();
+
+    using THashArr = TVector<ui64>;
+    using TRehashHash = TDenseHash<ui64, ui32>;
+    Y_STATIC_THREAD(THashArr) tlsHashArr;
+    Y_STATIC_THREAD(TRehashHash) rehashHashTlsVal;
+    TVector<ui64>& hashArr = tlsHashArr.Get();
+    Clear(&hashArr, totalSampleCount);
+    CalcOnlineCtrHashes(
+        *data.Learn->ObjectsData,
+        fold.LearnPermutationFeaturesSubset,
+        proj,
+        MakeArrayRef(hashArr.data(), learnSampleCount));
+    for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
+        const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+        CalcOnlineCtrHashes(
+            *data.Test[testIdx]->ObjectsData,
+            data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
+            proj,
+            MakeArrayRef(hashArr.data() + docOffset, testSampleCount));
+        docOffset += testSampleCount;
+    }
+    ui64 topSize = ctx->Params.CatFeatureParams->CtrLeafCountLimit;
+    if (proj.IsSingleCatFeature() && ctx->Params.CatFeatureParams->StoreAllSimpleCtrs) {
+        topSize = Max<ui64>();
+    }
+    size_t leafCount = 0;
+    const int threadCount = ctx->LocalExecutor->GetThreadCount() + 1;
+    if (threadCount > 1 && topSize > learnSampleCount && learnSampleCount >= 2 * MinParallelBlockSize) {
+        TPartitionedReindexHash reindexHash(GetValueBitCount(threadCount - 1));
+        leafCount = reindexHash.ComputeReindex(ctx->LocalExecutor, &hashArr[0], &hashArr[0] + learnSampleCount);
+        dst->CounterUniqueValuesCount = dst->UniqueValuesCount = leafCount;
+        leafCount = reindexHash.UpdateReindex(&hashArr[0] + learnSampleCount, &hashArr[0] + totalSampleCount);
+    } else {
+        if (proj.IsSingleCatFeature()) {
+            rehashHashTlsVal.Get().MakeEmpty(
+                quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(proj.CatFeatures[0])).OnLearnOnly
+            );
+        } else {
+            size_t approxBucketsCount = 1;
+            for (auto cf : proj.CatFeatures) {
+                approxBucketsCount *= quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(cf)).OnLearnOnly;
+                if (approxBucketsCount > learnSampleCount) {
+                    break;
+                }
+            }
+            rehashHashTlsVal.Get().MakeEmpty(Min(learnSampleCount, approxBucketsCount));
+        }
+        leafCount = ComputeReindexHash(topSize, rehashHashTlsVal.GetPtr(), &hashArr[0], &hashArr[0] + learnSampleCount);
+        dst->CounterUniqueValuesCount = dst->UniqueValuesCount = leafCount;
+
+        for (size_t docOffset = learnSampleCount, testIdx = 0; docOffset < totalSampleCount && testIdx < data.Test.size(); ++testIdx) {
+            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+            leafCount = UpdateReindexHash(rehashHashTlsVal.GetPtr(), &hashArr[0] + docOffset, &hashArr[0] + docOffset + testSampleCount);
+            docOffset += testSampleCount;
+        }
+    }
+
+    TVector<int> counterCTRTotal;
+    int counterCTRDenominator = 0;
+    if (HasCounterCtrs(ctrInfo)) {
+        counterCTRTotal.resize(leafCount);
+        int sampleCount = learnSampleCount;
+        if (ctx->Params.CatFeatureParams->CounterCalcMethod == ECounterCalc::Full) {
+            dst->CounterUniqueValuesCount = leafCount;
+            sampleCount = hashArr.ysize();
+        }
+        CountOnlineCTRTotal(hashArr, sampleCount, &counterCTRTotal);
+        counterCTRDenominator = *MaxElement(counterCTRTotal.begin(), counterCTRTotal.end());
+    }
+
+    CalcOnlineCTRsForAllTypes(
+        ctrInfo,
+        fold,
+        learnSampleCount,
+        hashArr,
+        leafCount,
+        /*initialClassCounts*/ {},
+        counterCTRTotal,
+        counterCTRDenominator,
+        ctx->LocalExecutor,
+        dst);
+}
+
+TCtrHashClassCounts CountClassesByHash(TConstArrayRef<ui64> learnHashes, const TFold& fold) {
+    TVector<int> classCountOffsets(fold.TargetClassesCount.size() + 1, 0);
+    for (auto classifierIdx : xrange(fold.TargetClassesCount.size())) {
+        classCountOffsets[classifierIdx + 1] = classCountOffsets[classifierIdx] + fold.TargetClassesCount[classifierIdx];
+    }
+    const int totalIdx = classCountOffsets.back();
+
+    TCtrHashClassCounts classCounts;
+    for (auto docIdx : xrange(learnHashes.size())) {
+        auto& counts = classCounts[learnHashes[docIdx]];
+        if (counts.empty()) {
+            counts.resize(totalIdx + 1);
+        }
+        for (auto classifierIdx : xrange(fold.TargetClassesCount.size())) {
+            ++counts[classCountOffsets[classifierIdx] + fold.LearnTargetClass[classifierIdx][docIdx]];
+        }
+        ++counts[totalIdx];
+    }
+    return classCounts;
+}
+
+// hashes contain learnSampleCount learn objects of the part followed by objects that only read counters
+static void ComputeOnlineCTRsWithPrecedingStats(const TVector<TCtrInfo>& ctrInfo,
+                                                const TFold& fold,
+                                                const TOnlineCtrPartStats& partStats,
+                                                TConstArrayRef<ui64> hashes,
+                                                size_t learnSampleCount,
+                                                TOnlineCTR* dst,
+                                                NPar::TLocalExecutor* localExecutor) {
+    dst->Feature.resize(ctrInfo.size());
+
+    TVector<ui64> hashArr(hashes.begin(), hashes.end());
+    TDenseHash<ui64, ui32> reindexHash;
+    const size_t leafCount = UpdateReindexHash(&reindexHash, hashArr.data(), hashArr.data() + hashArr.size());
+    TVector<ui64> leafHashes(leafCount);
+    for (const auto& hashAndLeaf : reindexHash) {
+        leafHashes[hashAndLeaf.second] = hashAndLeaf.first;
+    }
+    dst->CounterUniqueValuesCount = dst->UniqueValuesCount = leafCount;
+
+    TVector<TVector<int>> initialClassCounts(fold.TargetClassesCount.size());
+    int classCountOffset = 0;
+    for (auto classifierIdx : xrange(fold.TargetClassesCount.size())) {
+        const int targetClassesCount = fold.TargetClassesCount[classifierIdx];
+        auto& classifierCounts = initialClassCounts[classifierIdx];
+        classifierCounts.resize(leafCount * targetClassesCount);
+        for (auto leafIdx : xrange(leafCount)) {
+            const auto* precedingCounts = partStats.PrecedingClassCounts.FindPtr(leafHashes[leafIdx]);
+            if (precedingCounts) {
+                Copy(
+                    precedingCounts->begin() + classCountOffset,
+                    precedingCounts->begin() + classCountOffset + targetClassesCount,
+                    classifierCounts.begin() + leafIdx * targetClassesCount);
+            }
+        }
+        classCountOffset += targetClassesCount;
+    }
+
+    TVector<int> counterCTRTotal;
+    if (HasCounterCtrs(ctrInfo)) {
+        counterCTRTotal.yresize(leafCount);
+        for (auto leafIdx : xrange(leafCount)) {
+            const int* counterTotal = partStats.CounterTotals.FindPtr(leafHashes[leafIdx]);
+            counterCTRTotal[leafIdx] = counterTotal ? *counterTotal : 0;
+        }
     }
+
+    CalcOnlineCTRsForAllTypes(
+        ctrInfo,
+        fold,
+        learnSampleCount,
+        hashArr,
+        leafCount,
+        initialClassCounts,
+        counterCTRTotal,
+        partStats.CounterDenominator,
+        localExecutor,
+        dst);
+}
+
+void ComputeOnlineCTRs(const TVector<TCtrInfo>& ctrInfo,
+                       const TFold& fold,
+                       const TOnlineCtrPartStats& partStats,
+                       TConstArrayRef<ui64> learnHashes,
+                       TOnlineCTR* dst,
+                       NPar::TLocalExecutor* localExecutor) {
+    CHROMIUM_TRACE_SCOPE("Compute online CTRs");
+
+    Y_ASSERT(fold.LearnTargetClass.empty() || fold.LearnTargetClass[0].size() == learnHashes.size());
+    ComputeOnlineCTRsWithPrecedingStats(ctrInfo, fold, partStats, learnHashes, learnHashes.size(), dst, localExecutor);
+}
+
+void ComputeTestOnlineCTRs(const TVector<TCtrInfo>& ctrInfo,
+                           const TFold& fold,
+                           const TOnlineCtrPartStats& learnStats,
+                           TConstArrayRef<ui64> testHashes,
+                           TOnlineCTR* dst,
+                           NPar::TLocalExecutor* localExecutor) {
+    CHROMIUM_TRACE_SCOPE("Compute test online CTRs");
+
+    ComputeOnlineCTRsWithPrecedingStats(ctrInfo, fold, learnStats, testHashes, /*learnSampleCount*/ 0, dst, localExecutor);
 }
 
 void CalcFinalCtrsImpl(
@@ -1,17 +1,21 @@
 #pragma once
 
+#include "ctr_helper.h"
 #include "index_hash_calcer.h"
 #include "projection.h"
 #include "target_classifier.h"
 
+#include <catboost/libs/data_new/columns.h>
 #include <catboost/libs/data_new/data_provider.h>
 #include <catboost/libs/data_new/quantized_features_info.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/model/ctr_data.h>
 #include <catboost/libs/model/online_ctr.h>
 
+#include <library/binsaver/bin_saver.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/hash.h>
 #include <util/generic/maybe.h>
 #include <util/system/types.h>
 
@@ -23,10 +27,19 @@ const int SIMPLE_CLASSES_COUNT = 2;
 
 
 struct TOnlineCTR {
-    TVector<TArray2D<TVector<ui8>>> Feature; // Feature[ctrIdx][classIdx][priorIdx][docIdx]
+    /* Ctr values do not exceed ctr border count, so values of ctr ctrIdx are stored with BitsPerKey[ctrIdx]
+     * (2, 4 or 8) bits per value, packed as in TCompressedArray. Use VisitValues or GetValue to read them.
+     */
+    TVector<TArray2D<TVector<ui8>>> Feature; // Feature[ctrIdx][classIdx][priorIdx][packed values by docIdx]
+    TVector<ui32> BitsPerKey; // [ctrIdx]
     size_t UniqueValuesCount = 0;
     size_t CounterUniqueValuesCount = 0; // Counter ctrs could have more values than other types when  counter_calc_method == Full
 
+    // usage info for TOnlineCtrCache
+    ui64 LastUseTick = 0;
+    ui64 UseCount = 0;
+    TString SpillFile; // not empty if Feature data has been saved to disk
+
     size_t GetMaxUniqueValueCount() const {
         return Max(UniqueValuesCount, CounterUniqueValuesCount);
     }
@@ -37,8 +50,24 @@ struct TOnlineCTR {
             return UniqueValuesCount;
         }
     }
+
+    const ui8* GetRawValues(int ctrIdx, int targetBorderIdx, int priorIdx) const {
+        return Feature[ctrIdx][targetBorderIdx][priorIdx].data();
+    }
+
+    // calls f with an accessor to values by docIdx, see NCB::DispatchQuantizedValuesRef
+    template <class TFunc>
+    void VisitValues(int ctrIdx, int targetBorderIdx, int priorIdx, TFunc&& f) const {
+        NCB::DispatchQuantizedValuesRef(GetRawValues(ctrIdx, targetBorderIdx, priorIdx), BitsPerKey[ctrIdx], f);
+    }
+
+    ui8 GetValue(int ctrIdx, int targetBorderIdx, int priorIdx, size_t docIdx) const {
+        return NCB::GetQuantizedValue(GetRawValues(ctrIdx, targetBorderIdx, priorIdx), BitsPerKey[ctrIdx], docIdx);
+    }
 };
 
+ui32 GetCtrValuesBitsPerKey(ui32 ctrBorderCount);
+
 using TOnlineCTRHash = THashMap<TProjection, TOnlineCTR>;
 
 inline ui8 CalcCTR(float countInClass, int totalCount, float prior, float shift, float norm, int borderCount) {
@@ -56,6 +85,48 @@ void ComputeOnlineCTRs(const NCB::TTrainingForCPUDataProviders& data,
                        const TLearnContext* ctx,
                        TOnlineCTR* dst);
 
+/**
+ * Online ctrs for learn objects split into consecutive parts (distributed training).
+ * Counts of objects by projection hash value: class counts of all target classifiers concatenated
+ * in classifier order, followed by total object count.
+ */
+using TCtrHashClassCounts = THashMap<ui64, TVector<int>>;
+
+struct TOnlineCtrPartStats {
+    TCtrHashClassCounts PrecedingClassCounts; // counts over objects of all preceding parts
+    THashMap<ui64, int> CounterTotals; // only for hash values present in the part, missing means zero
+    int CounterDenominator = 0;
+
+public:
+    SAVELOAD(PrecedingClassCounts, CounterTotals, CounterDenominator);
+};
+
+// fills hashes for objects of subsetIndexing
+void CalcOnlineCtrHashes(const NCB::TQuantizedForCPUObjectsDataProvider& objectsData,
+                         const NCB::TFeaturesArraySubsetIndexing& subsetIndexing,
+                         const TProjection& proj,
+                         TArrayRef<ui64> hashes);
+
+TCtrHashClassCounts CountClassesByHash(TConstArrayRef<ui64> learnHashes, const TFold& fold);
+
+// learnHashes are computed by CalcOnlineCtrHashes for fold permutation, part must not have test objects
+void ComputeOnlineCTRs(const TVector<TCtrInfo>& ctrInfo,
+                       const TFold& fold,
+                       const TOnlineCtrPartStats& partStats,
+                       TConstArrayRef<ui64> learnHashes,
+                       TOnlineCTR* dst,
+                       NPar::TLocalExecutor* localExecutor = nullptr);
+
+/* Online ctrs of test objects only (dst does not contain learn objects),
+ * learnStats.PrecedingClassCounts are counts over all learn objects
+ */
+void ComputeTestOnlineCTRs(const TVector<TCtrInfo>& ctrInfo,
+                           const TFold& fold,
+                           const TOnlineCtrPartStats& learnStats,
+                           TConstArrayRef<ui64> testHashes,
+                           TOnlineCTR* dst,
+                           NPar::TLocalExecutor* localExecutor = nullptr);
+
 class TCtrValueTable;
 
 
@@ -0,0 +1,199 @@
+#include "online_ctr_cache.h"
+#include "fold.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/random.h>
+#include <util/stream/file.h>
+#include <util/string/builder.h>
+#include <util/string/cast.h>
+#include <util/system/filemap.h>
+#include <util/system/getpid.h>
+
+#include <cstring>
+
+
+TOnlineCtrCache::TOnlineCtrCache(ui64 maxSize, EOnlineCtrCachePolicy policy, const TString& spillDir)
+    : MaxSize(maxSize)
+    , Policy(policy)
+{
+    if (!spillDir.empty() && HasSizeLimit()) {
+        SpillDir = TFsPath(spillDir) / (TStringBuilder() << "online_ctr_cache." << GetPID() << '.' << RandomNumber<ui64>());
+        SpillDir.MkDirs();
+    }
+}
+
+TOnlineCtrCache::~TOnlineCtrCache() {
+    if (SpillDir.IsDefined()) {
+        try {
+            SpillDir.ForceDelete();
+        } catch (...) {
+            CATBOOST_WARNING_LOG << "Failed to remove online ctr cache directory " << SpillDir << Endl;
+        }
+    }
+}
+
+bool TOnlineCtrCache::Acquire(TOnlineCTR* ctr) {
+    ctr->LastUseTick = ++Tick;
+    ++ctr->UseCount;
+    if (!ctr->Feature.empty()) {
+        ++Hits;
+        return true;
+    }
+    if (!ctr->SpillFile.empty()) {
+        LoadOnlineCtrData(ctr->SpillFile, ctr);
+        ++SpillLoads;
+        return true;
+    }
+    ++Misses;
+    return false;
+}
+
+void TOnlineCtrCache::Spill(TOnlineCTR* ctr) {
+    if (!ctr->SpillFile.empty()) {
+        return;
+    }
+    const TString fileName = (SpillDir / ("ctr_" + ToString(Spills))).GetPath();
+    SaveOnlineCtrData(*ctr, fileName);
+    ctr->SpillFile = fileName;
+    ++Spills;
+}
+
+void TOnlineCtrCache::Shrink(const TVector<TFold*>& folds) {
+    struct TEntry {
+        TOnlineCTR* Ctr;
+        ui64 Size;
+    };
+    TVector<TEntry> entries;
+    ui64 totalSize = 0;
+    for (auto* fold : folds) {
+        fold->ForEachCtr(
+            [&] (const TProjection& /*proj*/, TOnlineCTR* ctr) {
+                if (!ctr->Feature.empty()) {
+                    entries.push_back(TEntry{ctr, GetOnlineCtrDataSize(*ctr)});
+                    totalSize += entries.back().Size;
+                }
+            }
+        );
+    }
+    if (totalSize > MaxSize) {
+        if (Policy == EOnlineCtrCachePolicy::LRU) {
+            SortBy(entries, [] (const TEntry& entry) { return entry.Ctr->LastUseTick; });
+        } else {
+            SortBy(entries, [] (const TEntry& entry) { return std::make_pair(entry.Ctr->UseCount, entry.Ctr->LastUseTick); });
+        }
+        for (const auto& entry : entries) {
+            if (totalSize <= MaxSize) {
+                break;
+            }
+            if (SpillDir.IsDefined()) {
+                Spill(entry.Ctr);
+            }
+            TVector<TArray2D<TVector<ui8>>>().swap(entry.Ctr->Feature);
+            totalSize -= entry.Size;
+            ++Evictions;
+        }
+    }
+    CachedSize = totalSize;
+}
+
+TOnlineCtrCacheStats TOnlineCtrCache::GetStats() const {
+    TOnlineCtrCacheStats stats;
+    stats.Hits = Hits;
+    stats.Misses = Misses;
+    stats.SpillLoads = SpillLoads;
+    stats.Evictions = Evictions;
+    stats.Spills = Spills;
+    stats.CachedSize = CachedSize;
+    return stats;
+}
+
+TMap<TString, ui64> TOnlineCtrCache::GetCounters() const {
+    const auto stats = GetStats();
+    TMap<TString, ui64> counters = {
+        {"Online ctr cache hits", stats.Hits},
+        {"Online ctr cache misses", stats.Misses},
+        {"Online ctr cache evictions", stats.Evictions},
+        {"Online ctr cache size (bytes)", stats.CachedSize}
+    };
+    if (SpillDir.IsDefined()) {
+        counters["Online ctr cache spills"] = stats.Spills;
+        counters["Online ctr cache spill loads"] = stats.SpillLoads;
+    }
+    return counters;
+}
+
+ui64 GetOnlineCtrDataSize(const TOnlineCTR& ctr) {
+    ui64 size = 0;
+    for (const auto& ctrFeature : ctr.Feature) {
+        for (size_t y = 0; y < ctrFeature.GetYSize(); ++y) {
+            for (size_t x = 0; x < ctrFeature.GetXSize(); ++x) {
+                size += ctrFeature[y][x].capacity();
+            }
+        }
+    }
+    return size;
+}
+
+void SaveOnlineCtrData(const TOnlineCTR& ctr, const TString& fileName) {
+    TFileOutput out(fileName);
+    const auto writeSize = [&out] (ui64 size) {
+        out.Write(&size, sizeof(size));
+    };
+    // values are already bit-packed in memory, so they are saved as is
+    writeSize(ctr.Feature.size());
+    for (auto ctrIdx : xrange(ctr.Feature.size())) {
+        const auto& ctrFeature = ctr.Feature[ctrIdx];
+        writeSize(ctr.BitsPerKey[ctrIdx]);
+        writeSize(ctrFeature.GetXSize());
+        writeSize(ctrFeature.GetYSize());
+        for (size_t y = 0; y < ctrFeature.GetYSize(); ++y) {
+            for (size_t x = 0; x < ctrFeature.GetXSize(); ++x) {
+                const auto& data = ctrFeature[y][x];
+                writeSize(data.size());
+                out.Write(data.data(), data.size());
+            }
+        }
+    }
+    out.Finish();
+}
+
+void LoadOnlineCtrData(const TString& fileName, TOnlineCTR* ctr) {
+    TFileMap fileMap(fileName);
+    fileMap.Map(0, fileMap.Length());
+    const char* ptr = (const char*)fileMap.Ptr();
+    const char* const end = ptr + fileMap.MappedSize();
+    const auto skip = [&] (size_t size) {
+        CB_ENSURE_INTERNAL(size <= size_t(end - ptr), "Online ctr cache file " << fileName << " is truncated");
+        const char* data = ptr;
+        ptr += size;
+        return data;
+    };
+    const auto readSize = [&] () {
+        ui64 size;
+        memcpy(&size, skip(sizeof(size)), sizeof(size));
+        return SafeIntegerCast<size_t>(size);
+    };
+    ctr->Feature.resize(readSize());
+    ctr->BitsPerKey.yresize(ctr->Feature.size());
+    for (auto ctrIdx : xrange(ctr->Feature.size())) {
+        auto& ctrFeature = ctr->Feature[ctrIdx];
+        ctr->BitsPerKey[ctrIdx] = SafeIntegerCast<ui32>(readSize());
+        CB_ENSURE_INTERNAL(ctr->BitsPerKey[ctrIdx] <= 8, "Online ctr cache file " << fileName << " is corrupted");
+        const size_t xSize = readSize();
+        const size_t ySize = readSize();
+        ctrFeature.SetSizes(xSize, ySize);
+        for (size_t y = 0; y < ySize; ++y) {
+            for (size_t x = 0; x < xSize; ++x) {
+                auto& data = ctrFeature[y][x];
+                data.yresize(readSize());
+                memcpy(data.data(), skip(data.size()), data.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "online_ctr.h"
+
+#include <catboost/libs/options/enums.h>
+
+#include <util/folder/path.h>
+#include <util/generic/map.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/ylimits.h>
+#include <util/system/types.h>
+
+#include <atomic>
+
+
+struct TFold;
+
+struct TOnlineCtrCacheStats {
+    ui64 Hits = 0;
+    ui64 Misses = 0; // ctr had to be calculated
+    ui64 SpillLoads = 0; // ctr was read back from disk instead of being calculated
+    ui64 Evictions = 0;
+    ui64 Spills = 0;
+    ui64 CachedSize = 0; // in bytes, after the last Shrink call
+};
+
+/* Keeps online ctrs of folds within a memory budget.
+ * Ctrs data is owned by folds, the cache only tracks usage and decides what to evict.
+ * Eviction happens in Shrink that must be called only when no references to ctrs data are held
+ * (between tree levels), so the budget can be exceeded by ctrs calculated during one level.
+ * Evicted ctrs are either dropped or, if spill directory is set, written to disk once and mmapped back
+ * on the next use (ctrs data of a fold never changes, so the file is reused for subsequent evictions).
+ */
+class TOnlineCtrCache {
+public:
+    TOnlineCtrCache(ui64 maxSize, EOnlineCtrCachePolicy policy, const TString& spillDir);
+    ~TOnlineCtrCache();
+
+    bool HasSizeLimit() const {
+        return MaxSize != Max<ui64>();
+    }
+
+    /* Marks ctr as used, reads it from disk if it has been spilled.
+     * Returns false if ctr data is not available and has to be calculated.
+     * Thread-safe for different ctrs.
+     */
+    bool Acquire(TOnlineCTR* ctr);
+
+    void Shrink(const TVector<TFold*>& folds);
+
+    TOnlineCtrCacheStats GetStats() const;
+
+    // to be added to profile log
+    TMap<TString, ui64> GetCounters() const;
+
+private:
+    void Spill(TOnlineCTR* ctr);
+
+private:
+    const ui64 MaxSize;
+    const EOnlineCtrCachePolicy Policy;
+    TFsPath SpillDir; // empty if spilling is disabled
+
+    std::atomic<ui64> Tick = {0};
+    std::atomic<ui64> Hits = {0};
+    std::atomic<ui64> Misses = {0};
+    std::atomic<ui64> SpillLoads = {0};
+    ui64 Evictions = 0;
+    ui64 Spills = 0;
+    ui64 CachedSize = 0;
+};
+
+ui64 GetOnlineCtrDataSize(const TOnlineCTR& ctr);
+
+// spill file format: ctr count, then for each ctr its bits per key, sizes and packed values of every [classIdx][priorIdx] cell
+void SaveOnlineCtrData(const TOnlineCTR& ctr, const TString& fileName);
+void LoadOnlineCtrData(const TString& fileName, TOnlineCTR* ctr);
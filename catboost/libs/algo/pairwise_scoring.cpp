@@ -145,7 +145,7 @@ void CalculatePairwiseScore(
     TArray2D<double> weightSum(2 * leafCount, 2 * leafCount);
     TVector<double> derSum(2 * leafCount);
 #endif
-    if (pairwiseStats.SplitEnsembleSpec.IsBinarySplitsPack) {
+    if (pairwiseStats.SplitEnsembleSpec.Type == ESplitEnsembleType::BinarySplits) {
         const int binaryFeaturesCount = (int)GetValueBitCount(bucketCount - 1);
 
         scoreBins->yresize(binaryFeaturesCount);
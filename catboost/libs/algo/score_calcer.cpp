@@ -2,12 +2,15 @@
 
 #include "index_calcer.h"
 #include "online_predictor.h"
+#include "rand_score.h"
 
 #include <catboost/libs/data_types/pair.h>
 #include <catboost/libs/index_range/index_range.h>
 #include <catboost/libs/helpers/map_merge.h>
 #include <catboost/libs/options/defaults_helper.h>
 
+#include <library/chromium_trace/interface.h>
+
 #include <util/generic/array_ref.h>
 
 #include <type_traits>
@@ -99,11 +102,12 @@ inline static const TOnlineCTR& GetCtr(
 
 // Helper function for calculating index of leaf for each document given a new split.
 // Calculates indices when a permutation is given.
-template <typename TBucketIndexType, typename TFullIndexType>
+// bucketIndex is a pointer or an accessor to bit-packed values (TPackedQuantizedValuesRef)
+template <typename TBucketIndex, typename TFullIndexType>
 inline static void SetSingleIndex(
     const TCalcScoreFold& fold,
     const TStatsIndexer& indexer,
-    TBucketIndexType* bucketIndex,
+    TBucketIndex bucketIndex,
     const ui32* bucketIndexing, // can be nullptr for simple case, use bucketBeginOffset instead then
     const int bucketBeginOffset,
     const int permBlockSize,
@@ -159,15 +163,22 @@ inline static void BuildSingleIndex(
         const TCtr& ctr = splitEnsemble.SplitCandidate.Ctr;
         const bool simpleIndexing = fold.CtrDataPermutationBlockSize == fold.GetDocCount();
         const ui32* docInFoldIndexing = simpleIndexing ? nullptr : GetDataPtr(fold.IndexInFold);
-        SetSingleIndex(
-            fold,
-            indexer,
-            GetCtr(allCtrs, ctr.Projection).Feature[ctr.CtrIdx][ctr.TargetBorderIdx][ctr.PriorIdx].data(),
-            docInFoldIndexing,
-            0,
-            fold.CtrDataPermutationBlockSize,
-            docIndexRange,
-            singleIdx
+        GetCtr(allCtrs, ctr.Projection).VisitValues(
+            ctr.CtrIdx,
+            ctr.TargetBorderIdx,
+            ctr.PriorIdx,
+            [&] (auto bucketIndex) {
+                SetSingleIndex(
+                    fold,
+                    indexer,
+                    bucketIndex,
+                    docInFoldIndexing,
+                    0,
+                    fold.CtrDataPermutationBlockSize,
+                    docIndexRange,
+                    singleIdx
+                );
+            }
         );
     } else {
         const bool simpleIndexing = fold.NonCtrDataPermutationBlockSize == fold.GetDocCount();
@@ -177,7 +188,7 @@ inline static void BuildSingleIndex(
             : fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
         const int docInDataProviderBeginOffset = simpleIndexing ? fold.FeaturesSubsetBegin : 0;
 
-        if (splitEnsemble.IsBinarySplitsPack) {
+        if (splitEnsemble.Type == ESplitEnsembleType::BinarySplits) {
             SetSingleIndex(
                 fold,
                 indexer,
@@ -189,20 +200,37 @@ inline static void BuildSingleIndex(
                 docIndexRange,
                 singleIdx
             );
+        } else if (splitEnsemble.Type == ESplitEnsembleType::ExclusiveBundle) {
+            SetSingleIndex(
+                fold,
+                indexer,
+                (**objectsDataProvider.GetExclusiveFeaturesBundle(
+                    splitEnsemble.ExclusiveFeaturesBundleRef.BundleIdx
+                ).GetSrc()).data(),
+                docInDataProviderIndexing,
+                docInDataProviderBeginOffset,
+                fold.NonCtrDataPermutationBlockSize,
+                docIndexRange,
+                singleIdx
+            );
         } else {
             const auto& splitCandidate = splitEnsemble.SplitCandidate;
 
             if (splitCandidate.Type == ESplitType::FloatFeature) {
-                SetSingleIndex(
-                    fold,
-                    indexer,
-                    *((*objectsDataProvider.GetNonPackedFloatFeature((ui32)splitCandidate.FeatureIdx))
-                        ->GetArrayData().GetSrc()),
-                    docInDataProviderIndexing,
-                    docInDataProviderBeginOffset,
-                    fold.NonCtrDataPermutationBlockSize,
-                    docIndexRange,
-                    singleIdx
+                objectsDataProvider.VisitFloatFeatureRawSrcData(
+                    (ui32)splitCandidate.FeatureIdx,
+                    [&] (auto bucketIndex) {
+                        SetSingleIndex(
+                            fold,
+                            indexer,
+                            bucketIndex,
+                            docInDataProviderIndexing,
+                            docInDataProviderBeginOffset,
+                            fold.NonCtrDataPermutationBlockSize,
+                            docIndexRange,
+                            singleIdx
+                        );
+                    }
                 );
             } else {
                 Y_ASSERT(splitCandidate.Type == ESplitType::OneHotFeature);
@@ -396,7 +424,12 @@ static void CalcStatsImpl(
                 Min(pairCount, pairPart * partIndexRange.End)
             );
 
-            if (splitEnsemble.IsBinarySplitsPack) {
+            CB_ENSURE_INTERNAL(
+                splitEnsemble.Type != ESplitEnsembleType::ExclusiveBundle,
+                "Exclusive features bundles are not supported in pairwise scoring"
+            );
+
+            if (splitEnsemble.Type == ESplitEnsembleType::BinarySplits) {
                 const TBinaryFeaturesPack* bucketSrcData =
                     (**objectsDataProvider.GetBinaryFeaturesPack(splitEnsemble.BinarySplitsPack.PackIdx)
                         .GetSrc()).Data();
@@ -452,18 +485,25 @@ static void CalcStatsImpl(
 
                 if (splitCandidate.Type == ESplitType::OnlineCtr) {
                     const TCtr& ctr = splitCandidate.Ctr;
-                    TConstArrayRef<ui8> buckets =
-                        GetCtr(allCtrs, ctr.Projection).Feature[ctr.CtrIdx][ctr.TargetBorderIdx][ctr.PriorIdx];
-                    setOutput([buckets](ui32 docIdx) { return buckets[docIdx]; });
+                    GetCtr(allCtrs, ctr.Projection).VisitValues(
+                        ctr.CtrIdx,
+                        ctr.TargetBorderIdx,
+                        ctr.PriorIdx,
+                        [&] (auto buckets) {
+                            setOutput([buckets](ui32 docIdx) { return buckets[docIdx]; });
+                        }
+                    );
                 } else if (splitCandidate.Type == ESplitType::FloatFeature) {
-                    const ui8* bucketSrcData =
-                        *((*objectsDataProvider.GetNonPackedFloatFeature((ui32)splitCandidate.FeatureIdx))
-                            ->GetArrayData().GetSrc());
                     const ui32* bucketIndexing
                         = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
-                    setOutput(
-                        [bucketSrcData, bucketIndexing](ui32 docIdx) {
-                            return bucketSrcData[bucketIndexing[docIdx]];
+                    objectsDataProvider.VisitFloatFeatureRawSrcData(
+                        (ui32)splitCandidate.FeatureIdx,
+                        [&] (auto bucketSrcData) {
+                            setOutput(
+                                [bucketSrcData, bucketIndexing](ui32 docIdx) {
+                                    return bucketSrcData[bucketIndexing[docIdx]];
+                                }
+                            );
                         }
                     );
                 } else {
@@ -664,97 +704,141 @@ inline void UpdateScoreBin(
 
 
 
-/* This function calculates resulting sums for each split given statistics that are calculated for each bucket
- * of the histogram.
+/* Enumerates all splits of one leaf given statistics that are calculated for each bucket of the histogram,
+ * splitFunc must accept (binIdx, trueStats, falseStats) params.
  */
-template <typename TIsPlainMode>
-inline static void UpdateScoreBins(
+template <typename TSplitFunc>
+inline static void ForEachSplitOfLeaf(
     const TBucketStats* stats,
-    int leafCount,
+    int leaf,
     const TStatsIndexer& indexer,
     const TSplitEnsembleSpec& splitEnsembleSpec,
-    float l2Regularizer,
-    TIsPlainMode isPlainMode,
-    double sumAllWeights,
-    int allDocCount,
-    TVector<TScoreBin>* scoreBins
+    TSplitFunc splitFunc
 ) {
-    auto updateScoreBinClosure = [=] (
-        const TBucketStats& trueStats,
-        const TBucketStats& falseStats,
-        TScoreBin* scoreBin) {
+    if (splitEnsembleSpec.Type == ESplitEnsembleType::BinarySplits) {
+        int binaryFeaturesCount = (int)GetValueBitCount(indexer.BucketCount - 1);
+        for (int binFeatureIdx = 0; binFeatureIdx < binaryFeaturesCount; ++binFeatureIdx) {
+            TBucketStats trueStats{0, 0, 0, 0};
+            TBucketStats falseStats{0, 0, 0, 0};
 
-        UpdateScoreBin(
-            isPlainMode,
-            l2Regularizer,
-            sumAllWeights,
-            allDocCount,
-            trueStats,
-            falseStats,
-            scoreBin);
-    };
+            for (int bucketIdx = 0; bucketIdx < indexer.BucketCount; ++bucketIdx) {
+                auto& dstStats = ((bucketIdx >> binFeatureIdx) & 1) ? trueStats : falseStats;
+                dstStats.Add(stats[indexer.GetIndex(leaf, bucketIdx)]);
+            }
 
-    for (int leaf = 0; leaf < leafCount; ++leaf) {
-        if (splitEnsembleSpec.IsBinarySplitsPack) {
-            int binaryFeaturesCount = (int)GetValueBitCount(indexer.BucketCount - 1);
-            for (int binFeatureIdx = 0; binFeatureIdx < binaryFeaturesCount; ++binFeatureIdx) {
-                TBucketStats trueStats{0, 0, 0, 0};
-                TBucketStats falseStats{0, 0, 0, 0};
-
-                for (int bucketIdx = 0; bucketIdx < indexer.BucketCount; ++bucketIdx) {
-                    auto& dstStats = ((bucketIdx >> binFeatureIdx) & 1) ? trueStats : falseStats;
-                    dstStats.Add(stats[indexer.GetIndex(leaf, bucketIdx)]);
-                }
+            splitFunc(binFeatureIdx, trueStats, falseStats);
+        }
+    } else if (splitEnsembleSpec.Type == ESplitEnsembleType::ExclusiveBundle) {
+        TBucketStats allStats{0, 0, 0, 0};
 
-                updateScoreBinClosure(trueStats, falseStats, &((*scoreBins)[binFeatureIdx]));
+        for (int bucketIdx = 0; bucketIdx < indexer.BucketCount; ++bucketIdx) {
+            allStats.Add(stats[indexer.GetIndex(leaf, bucketIdx)]);
+        }
+
+        /* splits of each bundle part are "bin > splitIdx" where bins of the part are [Begin, End) in the bundle,
+         * score bins for all parts are concatenated in the order of bundle values
+         */
+        for (const auto& bundlePart : splitEnsembleSpec.ExclusiveFeaturesBundle.Parts) {
+            const int partBegin = (int)bundlePart.Bounds.Begin;
+            const int partEnd = (int)bundlePart.Bounds.End;
+
+            TBucketStats trueStats{0, 0, 0, 0};
+            for (int bucketIdx = partBegin; bucketIdx < partEnd; ++bucketIdx) {
+                trueStats.Add(stats[indexer.GetIndex(leaf, bucketIdx)]);
             }
-        } else {
-            auto splitType = splitEnsembleSpec.SplitType;
 
-            TBucketStats allStats{0, 0, 0, 0};
+            for (int splitIdx = 0; splitIdx < partEnd - partBegin; ++splitIdx) {
+                TBucketStats falseStats = allStats;
+                falseStats.Remove(trueStats);
 
-            for (int bucketIdx = 0; bucketIdx < indexer.BucketCount; ++bucketIdx) {
-                const TBucketStats& leafStats = stats[indexer.GetIndex(leaf, bucketIdx)];
-                allStats.Add(leafStats);
+                splitFunc(partBegin - 1 + splitIdx, trueStats, falseStats);
+
+                trueStats.Remove(stats[indexer.GetIndex(leaf, partBegin + splitIdx)]);
             }
+        }
+    } else {
+        auto splitType = splitEnsembleSpec.SplitType;
 
-            TBucketStats trueStats{0, 0, 0, 0};
-            TBucketStats falseStats{0, 0, 0, 0};
-            if (splitType == ESplitType::OnlineCtr || splitType == ESplitType::FloatFeature) {
-                trueStats = allStats;
-                for (int splitIdx = 0; splitIdx < indexer.BucketCount - 1; ++splitIdx) {
-                    falseStats.Add(stats[indexer.GetIndex(leaf, splitIdx)]);
-                    trueStats.Remove(stats[indexer.GetIndex(leaf, splitIdx)]);
+        TBucketStats allStats{0, 0, 0, 0};
 
-                    updateScoreBinClosure(trueStats, falseStats, &((*scoreBins)[splitIdx]));
-                }
-            } else {
-                Y_ASSERT(splitType == ESplitType::OneHotFeature);
-                falseStats = allStats;
-                for (int bucketIdx = 0; bucketIdx < indexer.BucketCount; ++bucketIdx) {
-                    if (bucketIdx > 0) {
-                        falseStats.Add(stats[indexer.GetIndex(leaf, bucketIdx - 1)]);
-                    }
-                    falseStats.Remove(stats[indexer.GetIndex(leaf, bucketIdx)]);
+        for (int bucketIdx = 0; bucketIdx < indexer.BucketCount; ++bucketIdx) {
+            const TBucketStats& leafStats = stats[indexer.GetIndex(leaf, bucketIdx)];
+            allStats.Add(leafStats);
+        }
 
-                    updateScoreBinClosure(
-                        /*trueStats*/ stats[indexer.GetIndex(leaf, bucketIdx)],
-                        falseStats,
-                        &((*scoreBins)[bucketIdx]));
+        TBucketStats trueStats{0, 0, 0, 0};
+        TBucketStats falseStats{0, 0, 0, 0};
+        if (splitType == ESplitType::OnlineCtr || splitType == ESplitType::FloatFeature) {
+            trueStats = allStats;
+            for (int splitIdx = 0; splitIdx < indexer.BucketCount - 1; ++splitIdx) {
+                falseStats.Add(stats[indexer.GetIndex(leaf, splitIdx)]);
+                trueStats.Remove(stats[indexer.GetIndex(leaf, splitIdx)]);
+
+                splitFunc(splitIdx, trueStats, falseStats);
+            }
+        } else {
+            Y_ASSERT(splitType == ESplitType::OneHotFeature);
+            falseStats = allStats;
+            for (int bucketIdx = 0; bucketIdx < indexer.BucketCount; ++bucketIdx) {
+                if (bucketIdx > 0) {
+                    falseStats.Add(stats[indexer.GetIndex(leaf, bucketIdx - 1)]);
                 }
+                falseStats.Remove(stats[indexer.GetIndex(leaf, bucketIdx)]);
+
+                splitFunc(bucketIdx, /*trueStats*/ stats[indexer.GetIndex(leaf, bucketIdx)], falseStats);
             }
         }
     }
 }
 
 
+/* This function calculates resulting sums for each split given statistics that are calculated for each bucket
+ * of the histogram.
+ */
+template <typename TIsPlainMode>
+inline static void UpdateScoreBins(
+    const TBucketStats* stats,
+    int leafCount,
+    const TStatsIndexer& indexer,
+    const TSplitEnsembleSpec& splitEnsembleSpec,
+    float l2Regularizer,
+    TIsPlainMode isPlainMode,
+    double sumAllWeights,
+    int allDocCount,
+    TVector<TScoreBin>* scoreBins
+) {
+    for (int leaf = 0; leaf < leafCount; ++leaf) {
+        ForEachSplitOfLeaf(
+            stats,
+            leaf,
+            indexer,
+            splitEnsembleSpec,
+            [=] (int binIdx, const TBucketStats& trueStats, const TBucketStats& falseStats) {
+                UpdateScoreBin(
+                    isPlainMode,
+                    l2Regularizer,
+                    sumAllWeights,
+                    allDocCount,
+                    trueStats,
+                    falseStats,
+                    &((*scoreBins)[binIdx]));
+            }
+        );
+    }
+}
+
+
 static inline int CalcScoreBinCount(
     const TSplitEnsembleSpec& splitEnsembleSpec,
     int bucketCount
 ) {
-    if (splitEnsembleSpec.IsBinarySplitsPack) {
+    if (splitEnsembleSpec.Type == ESplitEnsembleType::BinarySplits) {
         return GetValueBitCount(bucketCount - 1);
     }
+    if (splitEnsembleSpec.Type == ESplitEnsembleType::ExclusiveBundle) {
+        // each bundle part has (bins count - 1) splits, bundle value 0 is shared
+        return bucketCount - 1;
+    }
     if (splitEnsembleSpec.SplitType == ESplitType::OneHotFeature) {
         return bucketCount;
     }
@@ -832,6 +916,8 @@ void CalcStatsAndScores(
     TPairwiseStats* pairwiseStats,
     TVector<TScoreBin>* scoreBins
 ) {
+    CHROMIUM_TRACE_SCOPE("Calc stats and scores");
+
     CB_ENSURE(stats3d || pairwiseStats || scoreBins, "stats3d, pairwiseStats, and scoreBins are empty - nothing to calculate");
     CB_ENSURE(!scoreBins || initialFold, "initialFold must be non-nullptr for scoreBins calculation");
 
@@ -840,7 +926,12 @@ void CalcStatsAndScores(
     const int bucketCount = GetBucketCount(
         splitEnsemble,
         *objectsDataProvider.GetQuantizedFeaturesInfo(),
-        objectsDataProvider.GetPackedBinaryFeaturesSize()
+        objectsDataProvider.GetPackedBinaryFeaturesSize(),
+        objectsDataProvider.GetExclusiveFeatureBundlesMetaData()
+    );
+    const TSplitEnsembleSpec splitEnsembleSpec(
+        splitEnsemble,
+        objectsDataProvider.GetExclusiveFeatureBundlesMetaData()
     );
     const TStatsIndexer indexer(bucketCount);
     const int fullIndexBitCount = depth + GetValueBitCount(bucketCount - 1);
@@ -939,7 +1030,7 @@ void CalcStatsAndScores(
                 stats3d->Stats.yresize(statsCount);
                 stats3d->BucketCount = bucketCount;
                 stats3d->MaxLeafCount = 1U << depth;
-                stats3d->SplitEnsembleSpec = TSplitEnsembleSpec(splitEnsemble);
+                stats3d->SplitEnsembleSpec = splitEnsembleSpec;
 
                 extOrInSplitStats = TBucketStatsRefOptionalHolder(stats3d->Stats);
             }
@@ -949,6 +1040,54 @@ void CalcStatsAndScores(
                 splitStatsCount,
                 &extOrInSplitStats
             );
+        } else if (statsFromPrevTree->IsCompact()) {
+            const int cachedSplitStatsCount = indexer.CalcSize(treeOptions.MaxDepth);
+            bool areStatsDirty;
+            TVector<TCompactBucketStats, TPoolAllocator>& splitStatsFromCache =
+                statsFromPrevTree->GetCompactStats(splitEnsemble, cachedSplitStatsCount, &areStatsDirty); // thread-safe access
+
+            // stats for the current depth are calculated in double precision and then stored to cache
+            splitStatsCount = indexer.CalcSize(depth);
+            const int segmentCount = fold.GetBodyTailCount() * fold.GetApproxDimension();
+            TVector<TBucketStats> localStats;
+            TVector<TBucketStats>& splitStats = stats3d ? stats3d->Stats : localStats;
+            splitStats.yresize(segmentCount * splitStatsCount);
+            extOrInSplitStats = TBucketStatsRefOptionalHolder(splitStats);
+            if (depth == 0 || areStatsDirty) {
+                selectCalcStatsImpl(
+                    /*isCaching*/ std::false_type(),
+                    fold,
+                    splitStatsCount,
+                    &extOrInSplitStats
+                );
+            } else {
+                TBucketStatsCache::LoadCompactStats(
+                    segmentCount,
+                    cachedSplitStatsCount,
+                    indexer.CalcSize(depth - 1),
+                    splitStatsFromCache,
+                    splitStatsCount,
+                    splitStats
+                );
+                selectCalcStatsImpl(
+                    /*isCaching*/ std::true_type(),
+                    prevLevelData,
+                    splitStatsCount,
+                    &extOrInSplitStats
+                );
+            }
+            TBucketStatsCache::StoreCompactStats(
+                segmentCount,
+                cachedSplitStatsCount,
+                splitStatsCount,
+                splitStats,
+                &splitStatsFromCache
+            );
+            if (stats3d) {
+                stats3d->BucketCount = bucketCount;
+                stats3d->MaxLeafCount = 1U << depth;
+                stats3d->SplitEnsembleSpec = splitEnsembleSpec;
+            }
         } else {
             splitStatsCount = indexer.CalcSize(treeOptions.MaxDepth);
             bool areStatsDirty;
@@ -978,7 +1117,7 @@ void CalcStatsAndScores(
                 ).swap(stats3d->Stats);
                 stats3d->BucketCount = bucketCount;
                 stats3d->MaxLeafCount = 1U << depth;
-                stats3d->SplitEnsembleSpec = TSplitEnsembleSpec(splitEnsemble);
+                stats3d->SplitEnsembleSpec = splitEnsembleSpec;
             }
         }
         if (scoreBins) {
@@ -986,7 +1125,7 @@ void CalcStatsAndScores(
             CalculateNonPairwiseScore(
                 fold,
                 *initialFold,
-                TSplitEnsembleSpec(splitEnsemble),
+                splitEnsembleSpec,
                 isPlainMode,
                 leafCount,
                 l2Regularizer,
@@ -1040,3 +1179,79 @@ GetScoreBins(
     }
     return scoreBin;
 }
+
+
+// Calculate score numerator summand for a leaf of a non-symmetric tree
+inline static double CalcLeafDp(
+    bool isPlainMode,
+    float l2Regularizer,
+    double sumAllWeights,
+    int allDocCount,
+    const TBucketStats& leafStats
+) {
+    const double avrg = isPlainMode ?
+        CalcAverage(leafStats.SumWeightedDelta, leafStats.SumWeight, l2Regularizer, sumAllWeights, allDocCount)
+        : CalcAverage(leafStats.SumDelta, leafStats.Count, l2Regularizer, sumAllWeights, allDocCount);
+    return CountDp(avrg, leafStats);
+}
+
+void CalcScoresForLeaf(
+    const TStats3D& stats3d,
+    int leaf,
+    const TFold& initialFold,
+    const NCatboostOptions::TCatBoostOptions& fitParams,
+    TVector<double>* scores
+) {
+    const TStatsIndexer indexer(stats3d.BucketCount);
+    const int splitStatsCount = indexer.CalcSize(0) * stats3d.MaxLeafCount;
+    const int approxDimension = initialFold.GetApproxDimension();
+    const int bodyTailCount = stats3d.Stats.ysize() / (splitStatsCount * approxDimension);
+    Y_ASSERT(0 <= leaf && leaf < stats3d.MaxLeafCount);
+    Y_ASSERT(bodyTailCount > 0 && bodyTailCount <= initialFold.BodyTailArr.ysize());
+
+    const bool isPlainMode = IsPlainMode(fitParams.BoostingOptions->BoostingType);
+    const float l2Regularizer = static_cast<float>(fitParams.ObliviousTreeOptions->L2Reg);
+    const double minSamplesInLeaf = fitParams.ObliviousTreeOptions->MinSamplesInLeaf;
+
+    scores->assign(CalcScoreBinCount(stats3d.SplitEnsembleSpec, stats3d.BucketCount), 0.0);
+
+    for (int bodyTailIdx : xrange(bodyTailCount)) {
+        const double sumAllWeights = initialFold.BodyTailArr[bodyTailIdx].BodySumWeight;
+        const int docCount = initialFold.BodyTailArr[bodyTailIdx].BodyFinish;
+        for (int dim : xrange(approxDimension)) {
+            const TBucketStats* stats = GetDataPtr(stats3d.Stats)
+                + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
+
+            TBucketStats leafStats{0, 0, 0, 0};
+            for (int bucketIdx : xrange(indexer.BucketCount)) {
+                leafStats.Add(stats[indexer.GetIndex(leaf, bucketIdx)]);
+            }
+            const double leafDp = CalcLeafDp(isPlainMode, l2Regularizer, sumAllWeights, docCount, leafStats);
+
+            // the last body tail contains all sampled documents, ordered mode stores weights of body documents in Count
+            const bool checkLeafSize = minSamplesInLeaf > 0 && bodyTailIdx + 1 == bodyTailCount && dim == 0;
+            ForEachSplitOfLeaf(
+                stats,
+                leaf,
+                indexer,
+                stats3d.SplitEnsembleSpec,
+                [&] (int binIdx, const TBucketStats& trueStats, const TBucketStats& falseStats) {
+                    double& score = (*scores)[binIdx];
+                    if (score == MINIMAL_SCORE) {
+                        return;
+                    }
+                    if (checkLeafSize && (
+                        trueStats.SumWeight + trueStats.Count < minSamplesInLeaf
+                        || falseStats.SumWeight + falseStats.Count < minSamplesInLeaf))
+                    {
+                        score = MINIMAL_SCORE;
+                        return;
+                    }
+                    score += CalcLeafDp(isPlainMode, l2Regularizer, sumAllWeights, docCount, trueStats)
+                        + CalcLeafDp(isPlainMode, l2Regularizer, sumAllWeights, docCount, falseStats)
+                        - leafDp;
+                }
+            );
+        }
+    }
+}
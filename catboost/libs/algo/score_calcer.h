@@ -49,3 +49,16 @@ GetScoreBins(
     int allDocCount,
     const NCatboostOptions::TCatBoostOptions& fitParams
 );
+
+/* Scores of all splits of a split candidate for one leaf of a non-symmetric tree.
+ * Unlike symmetric tree scores these are comparable between leaves: score is the gain of
+ * the split (sum of numerator summands of new leaves minus the one of the leaf itself).
+ * Splits producing leaves with less than min_samples_in_leaf weight get MINIMAL_SCORE.
+ */
+void CalcScoresForLeaf(
+    const TStats3D& stats3d,
+    int leaf,
+    const TFold& initialFold,
+    const NCatboostOptions::TCatBoostOptions& fitParams,
+    TVector<double>* scores
+);
@@ -8,6 +8,7 @@
 #include <util/system/yassert.h>
 
 #include <climits>
+#include <functional>
 
 
 using namespace NCB;
@@ -68,9 +69,10 @@ TModelSplit TSplit::GetModelSplit(
 int GetBucketCount(
     const TSplitEnsemble& splitEnsemble,
     const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo,
-    size_t packedBinaryFeaturesCount
+    size_t packedBinaryFeaturesCount,
+    TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundlesMetaData
 ) {
-    if (splitEnsemble.IsBinarySplitsPack) {
+    if (splitEnsemble.Type == ESplitEnsembleType::BinarySplits) {
         // TBinarySplitsPack
         size_t packIdx = splitEnsemble.BinarySplitsPack.PackIdx;
         size_t startIdx = packIdx * sizeof(TBinaryFeaturesPack) * CHAR_BIT;
@@ -81,6 +83,11 @@ int GetBucketCount(
         );
         return int(1 << featuresInPackCount);
     }
+    if (splitEnsemble.Type == ESplitEnsembleType::ExclusiveBundle) {
+        return int(
+            exclusiveFeaturesBundlesMetaData[splitEnsemble.ExclusiveFeaturesBundleRef.BundleIdx].GetBinCount()
+        );
+    }
 
     // TSplitCandidate
     const auto& splitCandidate = splitEnsemble.SplitCandidate;
@@ -98,3 +105,56 @@ int GetBucketCount(
         );
     }
 }
+
+
+void TNonSymmetricTreeStructure::SplitLeaf(int leafIdx, const TSplit& split) {
+    const int leafCount = GetLeafCount();
+    Y_ASSERT(0 <= leafIdx && leafIdx < leafCount);
+
+    const int nodeIdx = Nodes.ysize();
+    for (auto& node : Nodes) {
+        if (node.Left == ~leafIdx) {
+            node.Left = nodeIdx;
+            break;
+        }
+        if (node.Right == ~leafIdx) {
+            node.Right = nodeIdx;
+            break;
+        }
+    }
+    TSplitNode& newNode = Nodes.emplace_back();
+    newNode.Split = split;
+    newNode.Left = ~leafIdx;
+    newNode.Right = ~leafCount;
+}
+
+int TNonSymmetricTreeStructure::GetDepth() const {
+    TVector<TVector<std::pair<TSplit, bool>>> leafPaths;
+    GetLeafPaths(&leafPaths);
+    int depth = 0;
+    for (const auto& path : leafPaths) {
+        depth = Max(depth, path.ysize());
+    }
+    return depth;
+}
+
+void TNonSymmetricTreeStructure::GetLeafPaths(TVector<TVector<std::pair<TSplit, bool>>>* leafPaths) const {
+    leafPaths->assign(GetLeafCount(), {});
+    if (Nodes.empty()) {
+        return;
+    }
+    TVector<std::pair<TSplit, bool>> path;
+    const std::function<void(int)> visit = [&] (int child) {
+        if (child < 0) {
+            (*leafPaths)[~child] = path;
+            return;
+        }
+        const auto& node = Nodes[child];
+        path.emplace_back(node.Split, false);
+        visit(node.Left);
+        path.back().second = true;
+        visit(node.Right);
+        path.pop_back();
+    };
+    visit(0);
+}
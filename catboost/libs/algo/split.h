@@ -2,6 +2,7 @@
 
 #include "projection.h"
 
+#include <catboost/libs/data_new/exclusive_feature_bundling.h>
 #include <catboost/libs/data_new/packed_binary_features.h>
 #include <catboost/libs/data_new/quantized_features_info.h>
 #include <catboost/libs/model/split.h>
@@ -11,6 +12,7 @@
 #include <util/digest/multi.h>
 #include <util/digest/numeric.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/variant.h>
 #include <util/generic/vector.h>
 #include <util/system/types.h>
 #include <util/str_stl.h>
@@ -114,24 +116,44 @@ public:
 };
 
 
+// splits of all features in NCB::TExclusiveFeaturesBundle
+struct TExclusiveFeaturesBundleRef {
+    ui32 BundleIdx = std::numeric_limits<ui32>::max();
+
+public:
+    bool operator==(const TExclusiveFeaturesBundleRef& other) const {
+        return BundleIdx == other.BundleIdx;
+    }
+};
+
+
+enum class ESplitEnsembleType {
+    OneFeature,
+    BinarySplits,
+    ExclusiveBundle
+};
+
+
 // could have been a TVariant but SAVELOAD is easier this way
 struct TSplitEnsemble {
     // variant switch
-    bool IsBinarySplitsPack;
+    ESplitEnsembleType Type;
 
     // variant members
     TSplitCandidate SplitCandidate;
     TBinarySplitsPack BinarySplitsPack;
+    TExclusiveFeaturesBundleRef ExclusiveFeaturesBundleRef;
 
     static constexpr size_t BinarySplitsPackHash = 118223;
+    static constexpr size_t ExclusiveBundleHash = 981490;
 
 public:
     TSplitEnsemble()
-        : IsBinarySplitsPack(false)
+        : Type(ESplitEnsembleType::OneFeature)
     {}
 
     explicit TSplitEnsemble(TSplitCandidate&& splitCandidate)
-        : IsBinarySplitsPack(false)
+        : Type(ESplitEnsembleType::OneFeature)
         , SplitCandidate(std::move(splitCandidate))
     {}
 
@@ -139,28 +161,46 @@ public:
      * consistency
      */
     explicit TSplitEnsemble(TBinarySplitsPack&& binarySplitsPack)
-        : IsBinarySplitsPack(true)
+        : Type(ESplitEnsembleType::BinarySplits)
         , BinarySplitsPack(std::move(binarySplitsPack))
     {}
 
+    explicit TSplitEnsemble(TExclusiveFeaturesBundleRef&& exclusiveFeaturesBundleRef)
+        : Type(ESplitEnsembleType::ExclusiveBundle)
+        , ExclusiveFeaturesBundleRef(std::move(exclusiveFeaturesBundleRef))
+    {}
+
     bool operator==(const TSplitEnsemble& other) const {
-        if (IsBinarySplitsPack) {
-            return other.IsBinarySplitsPack && (BinarySplitsPack == other.BinarySplitsPack);
+        if (Type != other.Type) {
+            return false;
         }
-        return !other.IsBinarySplitsPack && (SplitCandidate == other.SplitCandidate);
+        switch (Type) {
+            case ESplitEnsembleType::OneFeature:
+                return SplitCandidate == other.SplitCandidate;
+            case ESplitEnsembleType::BinarySplits:
+                return BinarySplitsPack == other.BinarySplitsPack;
+            case ESplitEnsembleType::ExclusiveBundle:
+                return ExclusiveFeaturesBundleRef == other.ExclusiveFeaturesBundleRef;
+        }
+        Y_UNREACHABLE();
     }
 
-    SAVELOAD(IsBinarySplitsPack, SplitCandidate, BinarySplitsPack);
+    SAVELOAD(Type, SplitCandidate, BinarySplitsPack, ExclusiveFeaturesBundleRef);
 
     size_t GetHash() const {
-        if (IsBinarySplitsPack) {
-            return MultiHash(BinarySplitsPackHash, BinarySplitsPack.PackIdx);
+        switch (Type) {
+            case ESplitEnsembleType::OneFeature:
+                return SplitCandidate.GetHash();
+            case ESplitEnsembleType::BinarySplits:
+                return MultiHash(BinarySplitsPackHash, BinarySplitsPack.PackIdx);
+            case ESplitEnsembleType::ExclusiveBundle:
+                return MultiHash(ExclusiveBundleHash, ExclusiveFeaturesBundleRef.BundleIdx);
         }
-        return SplitCandidate.GetHash();
+        Y_UNREACHABLE();
     }
 
     bool IsSplitOfType(ESplitType type) const {
-        return !IsBinarySplitsPack && (SplitCandidate.Type == type);
+        return (Type == ESplitEnsembleType::OneFeature) && (SplitCandidate.Type == type);
     }
 };
 
@@ -173,38 +213,57 @@ struct THash<TSplitEnsemble> {
 
 
 struct TSplitEnsembleSpec {
-    bool IsBinarySplitsPack;
-    ESplitType SplitType; // not used if IsBinarySplitsPack == true
+    ESplitEnsembleType Type;
+    ESplitType SplitType; // used only if Type == OneFeature
+    NCB::TExclusiveFeaturesBundle ExclusiveFeaturesBundle; // used only if Type == ExclusiveBundle
 
 public:
     explicit TSplitEnsembleSpec(
-        bool isBinarySplitsPack = false,
-        ESplitType splitType = ESplitType::FloatFeature
+        ESplitEnsembleType type = ESplitEnsembleType::OneFeature,
+        ESplitType splitType = ESplitType::FloatFeature,
+        NCB::TExclusiveFeaturesBundle exclusiveFeaturesBundle = NCB::TExclusiveFeaturesBundle()
     )
-        : IsBinarySplitsPack(isBinarySplitsPack)
+        : Type(type)
         , SplitType(splitType)
+        , ExclusiveFeaturesBundle(std::move(exclusiveFeaturesBundle))
     {}
 
-    explicit TSplitEnsembleSpec(const TSplitEnsemble& splitEnsemble)
-        : IsBinarySplitsPack(splitEnsemble.IsBinarySplitsPack)
+    TSplitEnsembleSpec(
+        const TSplitEnsemble& splitEnsemble,
+        TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundlesMetaData
+    )
+        : Type(splitEnsemble.Type)
         , SplitType(splitEnsemble.SplitCandidate.Type)
-    {}
+    {
+        if (Type == ESplitEnsembleType::ExclusiveBundle) {
+            ExclusiveFeaturesBundle
+                = exclusiveFeaturesBundlesMetaData[splitEnsemble.ExclusiveFeaturesBundleRef.BundleIdx];
+        }
+    }
 
-    SAVELOAD(IsBinarySplitsPack, SplitType);
+    SAVELOAD(Type, SplitType, ExclusiveFeaturesBundle);
 
     bool operator==(const TSplitEnsembleSpec& other) const {
-        if (IsBinarySplitsPack) {
-            return other.IsBinarySplitsPack;
+        if (Type != other.Type) {
+            return false;
+        }
+        switch (Type) {
+            case ESplitEnsembleType::OneFeature:
+                return SplitType == other.SplitType;
+            case ESplitEnsembleType::BinarySplits:
+                return true;
+            case ESplitEnsembleType::ExclusiveBundle:
+                return ExclusiveFeaturesBundle == other.ExclusiveFeaturesBundle;
         }
-        return !other.IsBinarySplitsPack && (SplitType == other.SplitType);
+        Y_UNREACHABLE();
     }
 
     static TSplitEnsembleSpec OneSplit(ESplitType splitType) {
-        return TSplitEnsembleSpec(false, splitType);
+        return TSplitEnsembleSpec(ESplitEnsembleType::OneFeature, splitType);
     }
 
     static TSplitEnsembleSpec BinarySplitsPack() {
-        return TSplitEnsembleSpec(true, ESplitType::FloatFeature);
+        return TSplitEnsembleSpec(ESplitEnsembleType::BinarySplits);
     }
 };
 
@@ -212,7 +271,8 @@ public:
 int GetBucketCount(
     const TSplitEnsemble& splitEnsemble,
     const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo,
-    size_t packedBinaryFeaturesCount
+    size_t packedBinaryFeaturesCount,
+    TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundlesMetaData
 );
 
 
@@ -307,6 +367,81 @@ public:
     }
 };
 
+struct TSplitNode {
+    TSplit Split;
+    // child node index if non-negative, ~leafIdx otherwise
+    int Left = -1; // split value is false
+    int Right = -1; // split value is true
+
+public:
+    SAVELOAD(Split, Left, Right);
+    Y_SAVELOAD_DEFINE(Split, Left, Right)
+};
+
+/* Tree with an individual split in each node (grown by Lossguide and Levelwise policies).
+ * Nodes are stored in the order they were added, the root is Nodes[0].
+ * Leaves are numbered in the order they appear: when a leaf is split the false side keeps its index,
+ * the true side gets index GetLeafCount() (before the split).
+ */
+struct TNonSymmetricTreeStructure {
+    TVector<TSplitNode> Nodes;
+
+public:
+    SAVELOAD(Nodes);
+    Y_SAVELOAD_DEFINE(Nodes)
+
+    void SplitLeaf(int leafIdx, const TSplit& split);
+
+    inline int GetLeafCount() const {
+        return Nodes.ysize() + 1;
+    }
+
+    int GetDepth() const;
+
+    // leafIdx -> splits on the path from the root and their values for documents in this leaf
+    void GetLeafPaths(TVector<TVector<std::pair<TSplit, bool>>>* leafPaths) const;
+
+    TVector<TBinFeature> GetBinFeatures() const {
+        TVector<TBinFeature> result;
+        for (const auto& node : Nodes) {
+            if (node.Split.Type == ESplitType::FloatFeature) {
+                result.push_back(TBinFeature{node.Split.FeatureIdx, node.Split.BinBorder});
+            }
+        }
+        return result;
+    }
+
+    TVector<TOneHotSplit> GetOneHotFeatures() const {
+        TVector<TOneHotSplit> result;
+        for (const auto& node : Nodes) {
+            if (node.Split.Type == ESplitType::OneHotFeature) {
+                result.push_back(TOneHotSplit{node.Split.FeatureIdx, node.Split.BinBorder});
+            }
+        }
+        return result;
+    }
+
+    TVector<TCtr> GetCtrSplits() const {
+        TVector<TCtr> result;
+        for (const auto& node : Nodes) {
+            if (node.Split.Type == ESplitType::OnlineCtr) {
+                result.push_back(node.Split.Ctr);
+            }
+        }
+        return result;
+    }
+};
+
+using TTreeStructure = TVariant<TSplitTree, TNonSymmetricTreeStructure>;
+
+inline int GetLeafCount(const TTreeStructure& tree) {
+    return Visit([] (const auto& treeStructure) { return treeStructure.GetLeafCount(); }, tree);
+}
+
+inline TVector<TCtr> GetCtrSplits(const TTreeStructure& tree) {
+    return Visit([] (const auto& treeStructure) { return treeStructure.GetCtrSplits(); }, tree);
+}
+
 struct TTreeStats {
     TVector<double> LeafWeightsSum;
 
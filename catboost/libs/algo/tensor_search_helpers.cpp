@@ -2,8 +2,10 @@
 #include "mvs.h"
 
 #include <catboost/libs/data_new/objects.h>
+#include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 
+#include <util/generic/cast.h>
 #include <util/generic/maybe.h>
 
 
@@ -11,20 +13,42 @@ using namespace NCB;
 
 
 TSplit TCandidateInfo::GetBestSplit(const TQuantizedForCPUObjectsDataProvider& objectsData) const {
-    if (SplitEnsemble.IsBinarySplitsPack) {
-        TPackedBinaryIndex packedBinaryIndex(SplitEnsemble.BinarySplitsPack.PackIdx, BestBinId);
-        auto featureInfo = objectsData.GetPackedBinaryFeatureSrcIndex(packedBinaryIndex);
-        TSplitCandidate splitCandidate;
-        splitCandidate.Type
-            = featureInfo.first == EFeatureType::Float ?
-                ESplitType::FloatFeature :
-                ESplitType::OneHotFeature;
-        splitCandidate.FeatureIdx = featureInfo.second;
+    switch (SplitEnsemble.Type) {
+        case ESplitEnsembleType::OneFeature:
+            return TSplit(SplitEnsemble.SplitCandidate, BestBinId);
+        case ESplitEnsembleType::BinarySplits:
+            {
+                TPackedBinaryIndex packedBinaryIndex(SplitEnsemble.BinarySplitsPack.PackIdx, BestBinId);
+                auto featureInfo = objectsData.GetPackedBinaryFeatureSrcIndex(packedBinaryIndex);
+                TSplitCandidate splitCandidate;
+                splitCandidate.Type
+                    = featureInfo.first == EFeatureType::Float ?
+                        ESplitType::FloatFeature :
+                        ESplitType::OneHotFeature;
+                splitCandidate.FeatureIdx = featureInfo.second;
 
-        return TSplit(std::move(splitCandidate), (featureInfo.first == EFeatureType::Float) ? 0 : 1);
-    } else {
-        return TSplit(SplitEnsemble.SplitCandidate, BestBinId);
+                return TSplit(std::move(splitCandidate), (featureInfo.first == EFeatureType::Float) ? 0 : 1);
+            }
+        case ESplitEnsembleType::ExclusiveBundle:
+            {
+                // score bin BestBinId corresponds to bundle value BestBinId + 1, see ForEachSplitOfLeaf
+                const auto& bundle = objectsData.GetExclusiveFeatureBundlesMetaData()[
+                    SplitEnsemble.ExclusiveFeaturesBundleRef.BundleIdx
+                ];
+                const ui32 bundleValue = SafeIntegerCast<ui32>(BestBinId + 1);
+                for (const auto& bundlePart : bundle.Parts) {
+                    if ((bundleValue >= bundlePart.Bounds.Begin) && (bundleValue < bundlePart.Bounds.End)) {
+                        TSplitCandidate splitCandidate;
+                        splitCandidate.Type = ESplitType::FloatFeature;
+                        splitCandidate.FeatureIdx = SafeIntegerCast<int>(bundlePart.FloatFeatureIdx);
+
+                        return TSplit(std::move(splitCandidate), bundleValue - bundlePart.Bounds.Begin);
+                    }
+                }
+                CB_ENSURE_INTERNAL(false, "Bin " << BestBinId << " is outside of exclusive features bundle");
+            }
     }
+    Y_UNREACHABLE();
 }
 
 
@@ -349,17 +373,12 @@ void CalcWeightedDerivatives(
             }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
         } else {
             localExecutor->ExecRange([&](int blockId) {
-                TVector<double> curApprox(approxDimension);
-                TVector<double> curDelta(approxDimension);
-                NPar::TLocalExecutor::BlockedLoopBody(blockParams, [&](int z) {
-                    for (int dim = 0; dim < approxDimension; ++dim) {
-                        curApprox[dim] = approx[dim][z];
-                    }
-                    error.CalcDersMulti(curApprox, target[z], weight.empty() ? 1 : weight[z], &curDelta, nullptr);
-                    for (int dim = 0; dim < approxDimension; ++dim) {
-                        (*weightedDerivatives)[dim][z] = curDelta[dim];
-                    }
-                })(blockId);
+                const int blockOffset = blockId * blockParams.GetBlockSize();
+                error.CalcFirstDerMultiRange(blockOffset, Min<int>(blockParams.GetBlockSize(), tailFinish - blockOffset),
+                    approx,
+                    target.data(),
+                    weight.data(),
+                    weightedDerivatives);
             }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
         }
     }
@@ -377,7 +396,7 @@ void SetBestScore(
     for (size_t subcandidateIdx = 0; subcandidateIdx < allScores.size(); ++subcandidateIdx) {
         double bestScoreInstance = MINIMAL_SCORE;
         auto& subcandidateInfo = (*subcandidates)[subcandidateIdx];
-        const bool isBinaryFeaturesPackEnsemble = subcandidateInfo.SplitEnsemble.IsBinarySplitsPack;
+        const bool isBinaryFeaturesPackEnsemble = (subcandidateInfo.SplitEnsemble.Type == ESplitEnsembleType::BinarySplits);
 
         NCB::TBinaryFeaturesPack binaryFeaturesBinMask;
         if (isBinaryFeaturesPackEnsemble) {
@@ -14,6 +14,8 @@
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/logging/profile_info.h>
 
+#include <library/chromium_trace/interface.h>
+
 TErrorTracker BuildErrorTracker(EMetricBestValue bestValueType, double bestPossibleValue, bool hasTest, const TLearnContext& ctx) {
     const auto& odOptions = ctx.Params.BoostingOptions->OverfittingDetector;
     return CreateErrorTracker(odOptions, bestPossibleValue, bestValueType, hasTest);
@@ -22,7 +24,7 @@ TErrorTracker BuildErrorTracker(EMetricBestValue bestValueType, double bestPossi
 static void UpdateLearningFold(
     const NCB::TTrainingForCPUDataProviders& data,
     const IDerCalcer& error,
-    const TSplitTree& bestSplitTree,
+    const TTreeStructure& bestTree,
     ui64 randomSeed,
     TFold* fold,
     TLearnContext* ctx
@@ -33,12 +35,14 @@ static void UpdateLearningFold(
         data,
         error,
         *fold,
-        bestSplitTree,
+        bestTree,
         randomSeed,
         ctx,
         &approxDelta
     );
 
+    CHROMIUM_TRACE_SCOPE("Update body tail approx");
+
     if (error.GetIsExpApprox()) {
         UpdateBodyTailApprox</*StoreExpApprox*/ true>(approxDelta, ctx->Params.BoostingOptions->LearningRate, ctx->LocalExecutor, fold);
     } else {
@@ -61,12 +65,13 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
 
     CheckInterrupted(); // check after long-lasting operation
 
-    TSplitTree bestSplitTree;
+    TTreeStructure bestTree;
     {
         TFold* takenFold = &ctx->LearnProgress.Folds[ctx->Rand.GenRand() % foldCount];
         const TVector<ui64> randomSeeds = GenRandUI64Vector(takenFold->BodyTailArr.ysize(), ctx->Rand.GenRand());
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             ctx->LocalExecutor->ExecRange([&](int bodyTailId) {
+                CHROMIUM_TRACE_SCOPE("Calc derivatives");
                 CalcWeightedDerivatives(*error, bodyTailId, ctx->Params, randomSeeds[bodyTailId], takenFold, ctx->LocalExecutor);
             }, 0, takenFold->BodyTailArr.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
         } else {
@@ -81,7 +86,7 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
             profile,
             takenFold,
             ctx,
-            &bestSplitTree
+            &bestTree
         );
     }
     CheckInterrupted(); // check after long-lasting operation
@@ -91,48 +96,47 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
             trainFolds.push_back(&ctx->LearnProgress.Folds[foldId]);
         }
 
-        TrimOnlineCTRcache(trainFolds);
-        TrimOnlineCTRcache({ &ctx->LearnProgress.AveragingFold });
-        {
+        // in distributed mode online ctrs of the tree are computed during tensor search by MapCalcOnlineCtrs:
+        // for learn objects on workers, for test objects on master from class counts reduced over workers
+        if (ctx->Params.SystemOptions->IsSingleHost()) {
             TVector<TFold*> allFolds = trainFolds;
             allFolds.push_back(&ctx->LearnProgress.AveragingFold);
-
-            struct TLocalJobData {
-                const NCB::TTrainingForCPUDataProviders* data;
-                TProjection Projection;
-                TFold* Fold;
-                TOnlineCTR* Ctr;
-                void DoTask(TLearnContext* ctx) {
-                    ComputeOnlineCTRs(*data, *Fold, Projection, ctx, Ctr);
-                }
-            };
-
-            TVector<TLocalJobData> parallelJobsData;
-            THashSet<TProjection> seenProjections;
-            for (const auto& split : bestSplitTree.Splits) {
-                if (split.Type != ESplitType::OnlineCtr) {
-                    continue;
-                }
-
-                const auto& proj = split.Ctr.Projection;
-                if (seenProjections.contains(proj)) {
-                    continue;
-                }
-                for (auto* foldPtr : allFolds) {
-                    if (!foldPtr->GetCtrs(proj).contains(proj) || foldPtr->GetCtr(proj).Feature.empty()) {
+            TrimOnlineCTRcache(allFolds, ctx);
+            {
+
+                struct TLocalJobData {
+                    const NCB::TTrainingForCPUDataProviders* data;
+                    TProjection Projection;
+                    TFold* Fold;
+                    TOnlineCTR* Ctr;
+                    void DoTask(TLearnContext* ctx) {
+                        if (!ctx->OnlineCtrCache.Acquire(Ctr)) {
+                            ComputeOnlineCTRs(*data, *Fold, Projection, ctx, Ctr);
+                        }
+                    }
+                };
+
+                TVector<TLocalJobData> parallelJobsData;
+                THashSet<TProjection> seenProjections;
+                for (const auto& ctr : GetCtrSplits(bestTree)) {
+                    const auto& proj = ctr.Projection;
+                    if (seenProjections.contains(proj)) {
+                        continue;
+                    }
+                    for (auto* foldPtr : allFolds) {
                         parallelJobsData.emplace_back(TLocalJobData{ &data, proj, foldPtr, &foldPtr->GetCtrRef(proj) });
                     }
+                    seenProjections.insert(proj);
                 }
-                seenProjections.insert(proj);
-            }
 
-            ctx->LocalExecutor->ExecRange([&](int taskId){
-                parallelJobsData[taskId].DoTask(ctx);
-            }, 0, parallelJobsData.size(), NPar::TLocalExecutor::WAIT_COMPLETE);
+                ctx->LocalExecutor->ExecRange([&](int taskId){
+                    parallelJobsData[taskId].DoTask(ctx);
+                }, 0, parallelJobsData.size(), NPar::TLocalExecutor::WAIT_COMPLETE);
 
+            }
+            profile.AddOperation("ComputeOnlineCTRs for tree struct (train folds and test fold)");
+            CheckInterrupted(); // check after long-lasting operation
         }
-        profile.AddOperation("ComputeOnlineCTRs for tree struct (train folds and test fold)");
-        CheckInterrupted(); // check after long-lasting operation
 
         TVector<TVector<double>> treeValues; // [dim][leafId]
         TVector<double> sumLeafWeights; // [leafId]
@@ -140,7 +144,7 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             const TVector<ui64> randomSeeds = GenRandUI64Vector(foldCount, ctx->Rand.GenRand());
             ctx->LocalExecutor->ExecRange([&](int foldId) {
-                UpdateLearningFold(data, *error, bestSplitTree, randomSeeds[foldId], trainFolds[foldId], ctx);
+                UpdateLearningFold(data, *error, bestTree, randomSeeds[foldId], trainFolds[foldId], ctx);
             }, 0, foldCount, NPar::TLocalExecutor::WAIT_COMPLETE);
 
             profile.AddOperation("CalcApprox tree struct and update tree structure approx");
@@ -151,7 +155,7 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
                 data,
                 *error,
                 ctx->LearnProgress.AveragingFold,
-                bestSplitTree,
+                bestTree,
                 ctx,
                 &treeValues,
                 &indices
@@ -173,17 +177,18 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
 
             UpdateAvrgApprox(error->GetIsExpApprox(), data.Learn->GetObjectCount(), indices, treeValues, data.Test, &ctx->LearnProgress, ctx->LocalExecutor);
         } else {
+            const auto& bestSplitTree = Get<TSplitTree>(bestTree);
             if (ctx->LearnProgress.ApproxDimension == 1) {
-                MapSetApproxesSimple(*error, bestSplitTree, data.Test, &treeValues, &sumLeafWeights, ctx);
+                MapSetApproxesSimple(*error, bestSplitTree, data, &treeValues, &sumLeafWeights, ctx);
             } else {
-                MapSetApproxesMulti(*error, bestSplitTree, data.Test, &treeValues, &sumLeafWeights, ctx);
+                MapSetApproxesMulti(*error, bestSplitTree, data, &treeValues, &sumLeafWeights, ctx);
             }
         }
 
         ctx->LearnProgress.TreeStats.emplace_back();
         ctx->LearnProgress.TreeStats.back().LeafWeightsSum = sumLeafWeights;
         ctx->LearnProgress.LeafValues.push_back(treeValues);
-        ctx->LearnProgress.TreeStruct.push_back(bestSplitTree);
+        ctx->LearnProgress.TreeStruct.push_back(std::move(bestTree));
 
         profile.AddOperation("Update final approxes");
         CheckInterrupted(); // check after long-lasting operation
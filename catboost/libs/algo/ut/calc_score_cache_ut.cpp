@@ -0,0 +1,101 @@
+#include <catboost/libs/algo/calc_score_cache.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+Y_UNIT_TEST_SUITE(TBucketStatsCacheTest) {
+    Y_UNIT_TEST(TestLoadStoreCompactStats) {
+        const int segmentCount = 3;
+        const int segmentSize = 16;
+        const int statsCount = 10;
+        TMemoryPool pool(1024);
+        TVector<TCompactBucketStats, TPoolAllocator> cachedStats(&pool);
+        cachedStats.yresize(segmentCount * segmentSize);
+
+        TVector<TBucketStats> stats(segmentCount * statsCount);
+        for (auto idx : xrange(stats.size())) {
+            stats[idx] = TBucketStats{0.5 * idx, 1.0 * idx, -0.25 * idx, 2.0 * idx};
+        }
+        TBucketStatsCache::StoreCompactStats(segmentCount, segmentSize, statsCount, stats, &cachedStats);
+
+        TVector<TBucketStats> loadedStats(segmentCount * statsCount, TBucketStats{0, 0, 0, 0});
+        TBucketStatsCache::LoadCompactStats(segmentCount, segmentSize, statsCount, cachedStats, statsCount, loadedStats);
+        for (auto idx : xrange(stats.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(loadedStats[idx].SumWeightedDelta, stats[idx].SumWeightedDelta);
+            UNIT_ASSERT_VALUES_EQUAL(loadedStats[idx].SumWeight, stats[idx].SumWeight);
+            UNIT_ASSERT_VALUES_EQUAL(loadedStats[idx].SumDelta, stats[idx].SumDelta);
+            UNIT_ASSERT_VALUES_EQUAL(loadedStats[idx].Count, stats[idx].Count);
+        }
+    }
+
+    // emulates tree level caching and compares compact cache results with stats calculated in double precision
+    Y_UNIT_TEST(TestCompactStatsAccuracy) {
+        const int docCount = 20000;
+        const int bucketCount = 32;
+        const int maxDepth = 6;
+        const auto calcSize = [=] (int depth) { return (1 << depth) * bucketCount; };
+
+        TReallyFastRng32 rng(42);
+        TVector<int> buckets(docCount);
+        TVector<double> ders(docCount);
+        TVector<double> weights(docCount);
+        TVector<int> leaves(docCount, 0);
+        for (auto doc : xrange(docCount)) {
+            buckets[doc] = rng.Uniform(bucketCount);
+            ders[doc] = rng.GenRandReal1() * 2 - 1;
+            weights[doc] = rng.GenRandReal1();
+        }
+
+        const auto addDoc = [&] (int doc, TBucketStats* stats) {
+            TBucketStats& leafStats = stats[leaves[doc] * bucketCount + buckets[doc]];
+            leafStats.SumWeightedDelta += ders[doc] * weights[doc];
+            leafStats.SumWeight += weights[doc];
+            leafStats.SumDelta += ders[doc];
+            leafStats.Count += 1;
+        };
+
+        TMemoryPool pool(1024);
+        TVector<TCompactBucketStats, TPoolAllocator> cachedStats(&pool);
+        cachedStats.yresize(calcSize(maxDepth));
+
+        for (int depth : xrange(maxDepth + 1)) {
+            if (depth > 0) {
+                for (auto doc : xrange(docCount)) {
+                    leaves[doc] |= (rng.Uniform(2) << (depth - 1));
+                }
+            }
+
+            TVector<TBucketStats> exactStats(calcSize(depth), TBucketStats{0, 0, 0, 0});
+            for (auto doc : xrange(docCount)) {
+                addDoc(doc, exactStats.data());
+            }
+
+            TVector<TBucketStats> stats(calcSize(depth), TBucketStats{0, 0, 0, 0});
+            if (depth == 0) {
+                stats = exactStats;
+            } else {
+                const int halfOfStats = calcSize(depth - 1);
+                TBucketStatsCache::LoadCompactStats(1, calcSize(maxDepth), halfOfStats, cachedStats, calcSize(depth), stats);
+                for (auto doc : xrange(docCount)) {
+                    if ((leaves[doc] >> (depth - 1)) & 1) {
+                        addDoc(doc, stats.data());
+                    }
+                }
+                for (int statIdx : xrange(halfOfStats)) {
+                    stats[statIdx].Remove(stats[statIdx + halfOfStats]);
+                }
+            }
+            TBucketStatsCache::StoreCompactStats(1, calcSize(maxDepth), calcSize(depth), stats, &cachedStats);
+
+            for (auto idx : xrange(stats.size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL(stats[idx].SumWeightedDelta, exactStats[idx].SumWeightedDelta, 1e-3);
+                UNIT_ASSERT_DOUBLES_EQUAL(stats[idx].SumWeight, exactStats[idx].SumWeight, 1e-3);
+                UNIT_ASSERT_DOUBLES_EQUAL(stats[idx].SumDelta, exactStats[idx].SumDelta, 1e-3);
+                UNIT_ASSERT_DOUBLES_EQUAL(stats[idx].Count, exactStats[idx].Count, 1e-3);
+            }
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#include <catboost/libs/algo/error_functions.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <cmath>
+
+
+// range kernels must match per-object derivative formulas within this tolerance
+static constexpr double EPS = 1e-9;
+
+namespace {
+    struct TRangeData {
+        TVector<double> Approxes;
+        TVector<double> ApproxDeltas;
+        TVector<float> Targets;
+        TVector<float> Weights;
+    };
+}
+
+static TRangeData GenerateRangeData(int count, bool isExpApprox) {
+    TReallyFastRng32 rng(17);
+    TRangeData data;
+    for (auto i : xrange(count)) {
+        Y_UNUSED(i);
+        const double approx = rng.GenRandReal1() * 4 - 2;
+        const double approxDelta = rng.GenRandReal1() - 0.5;
+        data.Approxes.push_back(isExpApprox ? std::exp(approx) : approx);
+        data.ApproxDeltas.push_back(isExpApprox ? std::exp(approxDelta) : approxDelta);
+        data.Targets.push_back(0.5f + 3 * rng.GenRandReal1());
+        data.Weights.push_back(rng.GenRandReal1());
+    }
+    return data;
+}
+
+// derFunc(approx, target) returns TDers without weights
+template <class TDerFunc>
+static void CheckDersRange(const IDerCalcer& error, bool calcThirdDer, TDerFunc&& derFunc) {
+    const int start = 3;
+    const int count = 1001;
+    const bool isExpApprox = error.GetIsExpApprox();
+    const auto data = GenerateRangeData(start + count, isExpApprox);
+    const int maxDerivativeOrder = calcThirdDer ? 3 : Min<int>(error.GetMaxSupportedDerivativeOrder(), 2);
+
+    for (bool hasDelta : {false, true}) {
+        for (bool hasWeights : {false, true}) {
+            const double* approxDeltas = hasDelta ? data.ApproxDeltas.data() : nullptr;
+            const float* weights = hasWeights ? data.Weights.data() : nullptr;
+
+            TVector<TDers> ders(start + count, TDers{0, 0, 0});
+            error.CalcDersRange(start, count, calcThirdDer, data.Approxes.data(), approxDeltas, data.Targets.data(), weights, ders.data());
+            TVector<double> firstDers(start + count, 0);
+            error.CalcFirstDerRange(start, count, data.Approxes.data(), approxDeltas, data.Targets.data(), weights, firstDers.data());
+
+            for (int i = start; i < start + count; ++i) {
+                const double approx = hasDelta ? UpdateApprox(isExpApprox, data.Approxes[i], data.ApproxDeltas[i]) : data.Approxes[i];
+                const double weight = hasWeights ? data.Weights[i] : 1.0;
+                const TDers expected = derFunc(approx, data.Targets[i]);
+                UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der1, expected.Der1 * weight, EPS);
+                UNIT_ASSERT_DOUBLES_EQUAL(firstDers[i], expected.Der1 * weight, EPS);
+                if (maxDerivativeOrder >= 2) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der2, expected.Der2 * weight, EPS);
+                }
+                if (maxDerivativeOrder >= 3) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der3, expected.Der3 * weight, EPS);
+                }
+            }
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TErrorFunctionsTest) {
+    Y_UNIT_TEST(TestRMSEDersRange) {
+        for (bool calcThirdDer : {false, true}) {
+            CheckDersRange(TRMSEError(false), calcThirdDer, [] (double approx, float target) {
+                return TDers{target - approx, -1, 0};
+            });
+        }
+    }
+
+    Y_UNIT_TEST(TestQuantileDersRange) {
+        CheckDersRange(TQuantileError(0.3, false), true, [] (double approx, float target) {
+            return TDers{target - approx > 0 ? 0.3 : -0.7, 0, 0};
+        });
+    }
+
+    Y_UNIT_TEST(TestLogLinQuantileDersRange) {
+        CheckDersRange(TLogLinQuantileError(0.3, true), true, [] (double approxExp, float target) {
+            return TDers{target - approxExp > 0 ? 0.3 * approxExp : -0.7 * approxExp, 0, 0};
+        });
+    }
+
+    Y_UNIT_TEST(TestLqDersRange) {
+        const double q = 3;
+        CheckDersRange(TLqError(q, false), true, [=] (double approx, float target) {
+            const double diff = approx - target;
+            const double sign = diff > 0 ? 1 : -1;
+            return TDers{
+                q * sign * std::pow(std::abs(diff), q - 1),
+                q * (q - 1) * std::pow(std::abs(diff), q - 2),
+                q * (q - 1) * (q - 2) * std::pow(std::abs(diff), q - 3) * sign
+            };
+        });
+        CheckDersRange(TLqError(1.5, false), false, [] (double approx, float target) {
+            return TDers{1.5 * (approx - target > 0 ? 1 : -1) * std::pow(std::abs(approx - target), 0.5), 0, 0};
+        });
+    }
+
+    Y_UNIT_TEST(TestMAPEDersRange) {
+        CheckDersRange(TMAPError(false), true, [] (double approx, float target) {
+            return TDers{target - approx > 0 ? 1 / target : -1 / target, 0, 0};
+        });
+    }
+
+    Y_UNIT_TEST(TestPoissonDersRange) {
+        CheckDersRange(TPoissonError(true), true, [] (double approxExp, float target) {
+            return TDers{target - approxExp, -approxExp, -approxExp};
+        });
+    }
+
+    Y_UNIT_TEST(TestMultiClassFirstDerRange) {
+        const int approxDimension = 5;
+        const int start = 7;
+        const int count = 300;
+        TReallyFastRng32 rng(42);
+        TVector<TVector<double>> approx(approxDimension, TVector<double>(start + count));
+        TVector<float> targets(start + count);
+        TVector<float> weights(start + count);
+        for (auto i : xrange(start + count)) {
+            for (auto dim : xrange(approxDimension)) {
+                approx[dim][i] = rng.GenRandReal1() * 10 - 5;
+            }
+            targets[i] = rng.Uniform(approxDimension);
+            weights[i] = rng.GenRandReal1();
+        }
+
+        const TMultiClassError error(false);
+        for (bool hasWeights : {false, true}) {
+            const float* weightsData = hasWeights ? weights.data() : nullptr;
+            TVector<TVector<double>> ders(approxDimension, TVector<double>(start + count, 0));
+            error.CalcFirstDerMultiRange(start, count, approx, targets.data(), weightsData, &ders);
+
+            TVector<double> curApprox(approxDimension);
+            TVector<double> curDer(approxDimension);
+            for (int i = start; i < start + count; ++i) {
+                for (auto dim : xrange(approxDimension)) {
+                    curApprox[dim] = approx[dim][i];
+                }
+                error.CalcDersMulti(curApprox, targets[i], hasWeights ? weights[i] : 1, &curDer, nullptr);
+                for (auto dim : xrange(approxDimension)) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(ders[dim][i], curDer[dim], EPS);
+                }
+            }
+        }
+    }
+}
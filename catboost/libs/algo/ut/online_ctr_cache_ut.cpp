@@ -0,0 +1,102 @@
+#include <catboost/libs/algo/fold.h>
+#include <catboost/libs/algo/online_ctr_cache.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+
+
+static TProjection MakeProjection(int catFeature) {
+    TProjection proj;
+    proj.AddCatFeature(catFeature);
+    return proj;
+}
+
+static void FillCtr(size_t dataSize, ui8 value, TOnlineCTR* ctr) {
+    ctr->Feature.resize(1);
+    ctr->BitsPerKey.assign(1, CHAR_BIT);
+    ctr->Feature[0].SetSizes(2, 1);
+    for (auto x : xrange(2)) {
+        ctr->Feature[0][0][x].assign(dataSize, value + x);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TOnlineCtrCacheTest) {
+    Y_UNIT_TEST(TestSaveLoad) {
+        TTempDir tempDir;
+        TOnlineCTR ctr;
+        FillCtr(100, 7, &ctr);
+        const TString fileName = tempDir() + "/ctr";
+        SaveOnlineCtrData(ctr, fileName);
+
+        TOnlineCTR loadedCtr;
+        LoadOnlineCtrData(fileName, &loadedCtr);
+        UNIT_ASSERT_VALUES_EQUAL(loadedCtr.Feature.size(), 1);
+        UNIT_ASSERT_EQUAL(loadedCtr.BitsPerKey, ctr.BitsPerKey);
+        UNIT_ASSERT_VALUES_EQUAL(loadedCtr.Feature[0].GetXSize(), 2);
+        UNIT_ASSERT_VALUES_EQUAL(loadedCtr.Feature[0].GetYSize(), 1);
+        for (auto x : xrange(2)) {
+            UNIT_ASSERT_EQUAL(loadedCtr.Feature[0][0][x], ctr.Feature[0][0][x]);
+        }
+    }
+
+    static void CheckEviction(EOnlineCtrCachePolicy policy, int expectedEvicted) {
+        const size_t dataSize = 1000;
+        TFold fold;
+        // each ctr takes 2 * dataSize bytes, the budget fits two of three
+        TOnlineCtrCache cache(5 * dataSize, policy, "");
+        const auto acquire = [&] (int feature) {
+            auto* ctr = &fold.GetCtrRef(MakeProjection(feature));
+            if (!cache.Acquire(ctr)) {
+                FillCtr(dataSize, feature, ctr);
+            }
+        };
+        // feature 0 is used most frequently but least recently, feature 1 is used least frequently
+        for (int feature : {0, 0, 0, 1, 2, 2}) {
+            acquire(feature);
+        }
+
+        cache.Shrink({&fold});
+        for (int feature : xrange(3)) {
+            UNIT_ASSERT_VALUES_EQUAL(fold.GetCtrRef(MakeProjection(feature)).Feature.empty(), feature == expectedEvicted);
+        }
+        const auto stats = cache.GetStats();
+        UNIT_ASSERT_VALUES_EQUAL(stats.Hits, 3);
+        UNIT_ASSERT_VALUES_EQUAL(stats.Misses, 3);
+        UNIT_ASSERT_VALUES_EQUAL(stats.Evictions, 1);
+        UNIT_ASSERT_VALUES_EQUAL(stats.CachedSize, 4 * dataSize);
+    }
+
+    Y_UNIT_TEST(TestLRU) {
+        CheckEviction(EOnlineCtrCachePolicy::LRU, 0);
+    }
+
+    Y_UNIT_TEST(TestLFU) {
+        CheckEviction(EOnlineCtrCachePolicy::LFU, 1);
+    }
+
+    Y_UNIT_TEST(TestSpill) {
+        TTempDir tempDir;
+        TFold fold;
+        TOnlineCtrCache cache(1, EOnlineCtrCachePolicy::LRU, tempDir());
+        const auto proj = MakeProjection(0);
+        UNIT_ASSERT(!cache.Acquire(&fold.GetCtrRef(proj)));
+        FillCtr(10, 3, &fold.GetCtrRef(proj));
+        const auto expectedData = fold.GetCtrRef(proj).Feature[0][0][1];
+
+        for (auto iteration : xrange(2)) {
+            Y_UNUSED(iteration);
+            cache.Shrink({&fold});
+            UNIT_ASSERT(fold.GetCtrRef(proj).Feature.empty());
+            fold.DropEmptyCTRs();
+            UNIT_ASSERT(cache.Acquire(&fold.GetCtrRef(proj)));
+            UNIT_ASSERT_EQUAL(fold.GetCtrRef(proj).Feature[0][0][1], expectedData);
+        }
+        const auto stats = cache.GetStats();
+        UNIT_ASSERT_VALUES_EQUAL(stats.Misses, 1);
+        UNIT_ASSERT_VALUES_EQUAL(stats.Evictions, 2);
+        UNIT_ASSERT_VALUES_EQUAL(stats.Spills, 1);
+        UNIT_ASSERT_VALUES_EQUAL(stats.SpillLoads, 2);
+    }
+}
@@ -0,0 +1,282 @@
+#include <catboost/libs/algo/fold.h>
+#include <catboost/libs/algo/index_hash_calcer.h>
+#include <catboost/libs/algo/online_ctr.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/hash_set.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+
+static TFold MakeFold(TConstArrayRef<int> targetClass) {
+    TFold fold;
+    fold.LearnTargetClass.assign(1, TVector<int>(targetClass.begin(), targetClass.end()));
+    fold.TargetClassesCount.assign(1, 2);
+    return fold;
+}
+
+static TVector<TCtrInfo> MakeCtrInfo() {
+    TVector<TCtrInfo> ctrInfo;
+    for (auto ctrType : {ECtrType::Borders, ECtrType::Buckets, ECtrType::BinarizedTargetMeanValue, ECtrType::Counter}) {
+        TCtrInfo info;
+        info.Type = ctrType;
+        info.BorderCount = 15;
+        info.TargetClassifierIdx = 0;
+        info.Priors = {0.0f, 0.5f, 1.0f};
+        ctrInfo.push_back(info);
+    }
+    return ctrInfo;
+}
+
+Y_UNIT_TEST_SUITE(TOnlineCtrPartsTest) {
+    Y_UNIT_TEST(TestPartsMatchWholeLearn) {
+        const size_t docCount = 1000;
+        const size_t partCount = 3;
+        TReallyFastRng32 rng(17);
+        TVector<ui64> hashes(docCount);
+        TVector<int> targetClass(docCount);
+        for (auto docIdx : xrange(docCount)) {
+            hashes[docIdx] = rng.Uniform(20) * 1000003;
+            targetClass[docIdx] = rng.Uniform(2);
+        }
+        const auto ctrInfo = MakeCtrInfo();
+
+        const TFold wholeFold = MakeFold(targetClass);
+        TOnlineCtrPartStats wholeStats;
+        for (const auto& [hash, counts] : CountClassesByHash(hashes, wholeFold)) {
+            wholeStats.CounterTotals[hash] = counts.back();
+            wholeStats.CounterDenominator = Max(wholeStats.CounterDenominator, counts.back());
+        }
+        TOnlineCTR wholeCtr;
+        ComputeOnlineCTRs(ctrInfo, wholeFold, wholeStats, hashes, &wholeCtr);
+
+        TCtrHashClassCounts precedingClassCounts;
+        for (auto partIdx : xrange(partCount)) {
+            const size_t partBegin = docCount * partIdx / partCount;
+            const size_t partEnd = docCount * (partIdx + 1) / partCount;
+            const auto partHashes = MakeArrayRef(hashes.data() + partBegin, partEnd - partBegin);
+            const TFold partFold = MakeFold(MakeArrayRef(targetClass.data() + partBegin, partEnd - partBegin));
+
+            TOnlineCtrPartStats partStats = wholeStats;
+            partStats.PrecedingClassCounts = precedingClassCounts;
+            TOnlineCTR partCtr;
+            ComputeOnlineCTRs(ctrInfo, partFold, partStats, partHashes, &partCtr);
+
+            for (auto ctrIdx : xrange(ctrInfo.size())) {
+                const auto& wholeFeature = wholeCtr.Feature[ctrIdx];
+                const auto& partFeature = partCtr.Feature[ctrIdx];
+                UNIT_ASSERT_VALUES_EQUAL(wholeFeature.GetXSize(), partFeature.GetXSize());
+                UNIT_ASSERT_VALUES_EQUAL(wholeFeature.GetYSize(), partFeature.GetYSize());
+                for (auto border : xrange(wholeFeature.GetYSize())) {
+                    for (auto prior : xrange(wholeFeature.GetXSize())) {
+                        for (auto docIdx : xrange(partBegin, partEnd)) {
+                            UNIT_ASSERT_VALUES_EQUAL(
+                                wholeCtr.GetValue(ctrIdx, border, prior, docIdx),
+                                partCtr.GetValue(ctrIdx, border, prior, docIdx - partBegin));
+                        }
+                    }
+                }
+            }
+
+            for (const auto& [hash, counts] : CountClassesByHash(partHashes, partFold)) {
+                auto& precedingCounts = precedingClassCounts[hash];
+                precedingCounts.resize(counts.size());
+                for (auto idx : xrange(counts.size())) {
+                    precedingCounts[idx] += counts[idx];
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestTestCtrsMatchAppendedLearn) {
+        const size_t learnCount = 500;
+        const size_t testCount = 30;
+        TReallyFastRng32 rng(29);
+        TVector<ui64> hashes(learnCount);
+        TVector<int> targetClass(learnCount);
+        for (auto docIdx : xrange(learnCount)) {
+            hashes[docIdx] = rng.Uniform(20) * 1000003;
+            targetClass[docIdx] = rng.Uniform(2);
+        }
+        TVector<ui64> testHashes(testCount);
+        for (auto& hash : testHashes) {
+            // some test values are not present in learn
+            hash = rng.Uniform(25) * 1000003;
+        }
+        const auto ctrInfo = MakeCtrInfo();
+
+        const TFold learnFold = MakeFold(targetClass);
+        TOnlineCtrPartStats learnStats;
+        learnStats.PrecedingClassCounts = CountClassesByHash(hashes, learnFold);
+        for (const auto& [hash, counts] : learnStats.PrecedingClassCounts) {
+            learnStats.CounterTotals[hash] = counts.back();
+        }
+        for (auto hash : testHashes) {
+            ++learnStats.CounterTotals[hash];
+        }
+        for (const auto& [hash, total] : learnStats.CounterTotals) {
+            learnStats.CounterDenominator = Max(learnStats.CounterDenominator, total);
+        }
+        TOnlineCTR testCtr;
+        ComputeTestOnlineCTRs(ctrInfo, learnFold, learnStats, testHashes, &testCtr);
+
+        // a test object gets the ctr of a learn object following all learn objects
+        TOnlineCtrPartStats appendedStats;
+        appendedStats.CounterTotals = learnStats.CounterTotals;
+        appendedStats.CounterDenominator = learnStats.CounterDenominator;
+        for (auto testIdx : xrange(testCount)) {
+            TVector<ui64> appendedHashes = hashes;
+            appendedHashes.push_back(testHashes[testIdx]);
+            TVector<int> appendedTargetClass = targetClass;
+            appendedTargetClass.push_back(0);
+            TOnlineCTR appendedCtr;
+            ComputeOnlineCTRs(ctrInfo, MakeFold(appendedTargetClass), appendedStats, appendedHashes, &appendedCtr);
+
+            for (auto ctrIdx : xrange(ctrInfo.size())) {
+                const auto& testFeature = testCtr.Feature[ctrIdx];
+                for (auto border : xrange(testFeature.GetYSize())) {
+                    for (auto prior : xrange(testFeature.GetXSize())) {
+                        UNIT_ASSERT_VALUES_EQUAL(
+                            testCtr.GetValue(ctrIdx, border, prior, testIdx),
+                            appendedCtr.GetValue(ctrIdx, border, prior, learnCount));
+                    }
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestParallelMatchesSerial) {
+        const size_t docCount = 300000;
+        TReallyFastRng32 rng(23);
+        TVector<ui64> hashes(docCount);
+        TVector<int> targetClass(docCount);
+        for (auto docIdx : xrange(docCount)) {
+            hashes[docIdx] = rng.Uniform(50) * 1000003;
+            targetClass[docIdx] = rng.Uniform(2);
+        }
+        const auto ctrInfo = MakeCtrInfo();
+        const TFold fold = MakeFold(targetClass);
+        TOnlineCtrPartStats stats;
+        for (const auto& [hash, counts] : CountClassesByHash(hashes, fold)) {
+            stats.CounterTotals[hash] = counts.back();
+            stats.CounterDenominator = Max(stats.CounterDenominator, counts.back());
+        }
+
+        TOnlineCTR serialCtr;
+        ComputeOnlineCTRs(ctrInfo, fold, stats, hashes, &serialCtr);
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TOnlineCTR parallelCtr;
+        ComputeOnlineCTRs(ctrInfo, fold, stats, hashes, &parallelCtr, &localExecutor);
+
+        for (auto ctrIdx : xrange(ctrInfo.size())) {
+            const auto& serialFeature = serialCtr.Feature[ctrIdx];
+            const auto& parallelFeature = parallelCtr.Feature[ctrIdx];
+            for (auto border : xrange(serialFeature.GetYSize())) {
+                for (auto prior : xrange(serialFeature.GetXSize())) {
+                    UNIT_ASSERT(serialFeature[border][prior] == parallelFeature[border][prior]);
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestPackedValues) {
+        const size_t docCount = 1001; // last byte of packed values is not full
+        TReallyFastRng32 rng(41);
+        TVector<ui64> hashes(docCount);
+        for (auto& hash : hashes) {
+            hash = rng.Uniform(30) * 1000003;
+        }
+        const TFold fold = MakeFold(TVector<int>(docCount, 0));
+        TOnlineCtrPartStats stats;
+        for (const auto& [hash, counts] : CountClassesByHash(hashes, fold)) {
+            stats.CounterTotals[hash] = counts.back();
+            stats.CounterDenominator = Max(stats.CounterDenominator, counts.back());
+        }
+
+        for (auto [borderCount, expectedBitsPerKey] : {std::make_pair(3u, 2u), std::make_pair(15u, 4u), std::make_pair(255u, 8u)}) {
+            TCtrInfo info;
+            info.Type = ECtrType::Counter;
+            info.BorderCount = borderCount;
+            info.TargetClassifierIdx = 0;
+            info.Priors = {0.0f, 0.5f, 1.0f};
+
+            TOnlineCTR ctr;
+            ComputeOnlineCTRs({info}, fold, stats, hashes, &ctr);
+            UNIT_ASSERT_VALUES_EQUAL(ctr.BitsPerKey[0], expectedBitsPerKey);
+
+            TVector<float> shift;
+            TVector<float> norm;
+            CalcNormalization(info.Priors, &shift, &norm);
+            for (auto prior : xrange(info.Priors.size())) {
+                UNIT_ASSERT_VALUES_EQUAL(ctr.Feature[0][0][prior].size(), CeilDiv<size_t>(docCount * expectedBitsPerKey, CHAR_BIT));
+                ctr.VisitValues(
+                    0,
+                    0,
+                    prior,
+                    [&] (auto values) {
+                        for (auto docIdx : xrange(docCount)) {
+                            const ui8 expectedValue = CalcCTR(
+                                stats.CounterTotals.at(hashes[docIdx]),
+                                stats.CounterDenominator,
+                                info.Priors[prior],
+                                shift[prior],
+                                norm[prior],
+                                borderCount);
+                            UNIT_ASSERT_VALUES_EQUAL(values[docIdx], expectedValue);
+                            UNIT_ASSERT_VALUES_EQUAL(ctr.GetValue(0, 0, prior, docIdx), expectedValue);
+                        }
+                    }
+                );
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestPartitionedReindexHash) {
+        const size_t learnCount = 10000;
+        const size_t testCount = 1000;
+        TReallyFastRng32 rng(5);
+        TVector<ui64> hashes(learnCount + testCount);
+        for (auto docIdx : xrange(hashes.size())) {
+            hashes[docIdx] = (docIdx < learnCount ? rng.Uniform(3000) : rng.Uniform(4000)) + 1;
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TVector<ui64> indices = hashes;
+        TPartitionedReindexHash reindexHash(/*partCountLog2*/ 2);
+        const size_t learnUniqueCount = reindexHash.ComputeReindex(&localExecutor, indices.data(), indices.data() + learnCount);
+        const size_t uniqueCount = reindexHash.UpdateReindex(indices.data() + learnCount, indices.data() + indices.size());
+
+        THashMap<ui64, ui64> hashToIndex;
+        THashSet<ui64> learnHashes;
+        for (auto docIdx : xrange(hashes.size())) {
+            const auto [it, inserted] = hashToIndex.emplace(hashes[docIdx], indices[docIdx]);
+            UNIT_ASSERT_VALUES_EQUAL(it->second, indices[docIdx]);
+            if (docIdx < learnCount) {
+                learnHashes.insert(hashes[docIdx]);
+                UNIT_ASSERT(indices[docIdx] < learnUniqueCount);
+            } else if (inserted) {
+                UNIT_ASSERT(indices[docIdx] >= learnUniqueCount);
+            }
+            UNIT_ASSERT(indices[docIdx] < uniqueCount);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(learnHashes.size(), learnUniqueCount);
+        UNIT_ASSERT_VALUES_EQUAL(hashToIndex.size(), uniqueCount);
+
+        // indices don't depend on the thread count
+        NPar::TLocalExecutor singleThreadExecutor;
+        TVector<ui64> singleThreadIndices = hashes;
+        TPartitionedReindexHash singleThreadReindexHash(/*partCountLog2*/ 2);
+        singleThreadReindexHash.ComputeReindex(
+            &singleThreadExecutor,
+            singleThreadIndices.data(),
+            singleThreadIndices.data() + learnCount);
+        singleThreadReindexHash.UpdateReindex(
+            singleThreadIndices.data() + learnCount,
+            singleThreadIndices.data() + singleThreadIndices.size());
+        UNIT_ASSERT_EQUAL(indices, singleThreadIndices);
+    }
+}
@@ -1,4 +1,5 @@
 
+#include <catboost/libs/algo/learn_context.h>
 #include <catboost/libs/data_new/data_provider_builders.h>
 #include <catboost/libs/train_lib/train_model.h>
 
@@ -125,4 +126,64 @@ Y_UNIT_TEST_SUITE(TTrainTest) {
             UNIT_ASSERT( Equal<float>(features[j], (**rawObjectsData.GetFloatFeature(j)).GetArrayData()) );
         }
     }
+
+    Y_UNIT_TEST(TestLoadLegacyLearnProgress) {
+        TLearnProgress progress;
+        progress.EnableSaveLoadApprox = false;
+        progress.SerializedTrainParams = "{}";
+        progress.PoolCheckSum = 42;
+        TVector<TSplitTree> splitTrees(3);
+        for (auto treeIdx : xrange(splitTrees.size())) {
+            for (auto depth : xrange(treeIdx + 1)) {
+                TSplitCandidate candidate;
+                candidate.FeatureIdx = depth;
+                splitTrees[treeIdx].AddSplit(TSplit(candidate, treeIdx * 10 + depth));
+            }
+            progress.TreeStats.emplace_back();
+            progress.LeafValues.push_back({TVector<double>(splitTrees[treeIdx].GetLeafCount(), 1.0)});
+        }
+
+        // layout of snapshots saved before non-symmetric trees were supported
+        TStringStream legacyStream;
+        ::SaveMany(&legacyStream,
+            progress.SerializedTrainParams,
+            progress.EnableSaveLoadApprox,
+            progress.TestApprox,
+            progress.BestTestApprox,
+            progress.CatFeatures,
+            progress.FloatFeatures,
+            progress.ApproxDimension,
+            splitTrees,
+            progress.TreeStats,
+            progress.LeafValues,
+            progress.MetricsAndTimeHistory,
+            progress.UsedCtrSplits,
+            progress.PoolCheckSum);
+
+        progress.TreeStruct.assign(splitTrees.begin(), splitTrees.end());
+        TStringStream stream;
+        ::Save(&stream, progress);
+
+        for (bool isLegacyLayout : {true, false}) {
+            TLearnProgress loaded;
+            loaded.EnableSaveLoadApprox = false;
+            if (isLegacyLayout) {
+                loaded.LoadLegacy(&legacyStream);
+            } else {
+                ::Load(&stream, loaded);
+            }
+            UNIT_ASSERT_VALUES_EQUAL(loaded.PoolCheckSum, progress.PoolCheckSum);
+            UNIT_ASSERT_VALUES_EQUAL(loaded.LeafValues.size(), splitTrees.size());
+            UNIT_ASSERT_VALUES_EQUAL(loaded.TreeStruct.size(), splitTrees.size());
+            for (auto treeIdx : xrange(splitTrees.size())) {
+                UNIT_ASSERT(HoldsAlternative<TSplitTree>(loaded.TreeStruct[treeIdx]));
+                const auto& splits = Get<TSplitTree>(loaded.TreeStruct[treeIdx]).Splits;
+                UNIT_ASSERT_VALUES_EQUAL(splits.size(), splitTrees[treeIdx].Splits.size());
+                for (auto depth : xrange(splits.size())) {
+                    UNIT_ASSERT(splits[depth] == splitTrees[treeIdx].Splits[depth]);
+                    UNIT_ASSERT_VALUES_EQUAL(splits[depth].BinBorder, splitTrees[treeIdx].Splits[depth].BinBorder);
+                }
+            }
+        }
+    }
 }
@@ -1,18 +1,37 @@
 #include "mode_fstr_helpers.h"
+#include "proceed_pool_in_blocks.h"
 
 #include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_util/line_data_reader.h>
 #include <catboost/libs/fstr/output_fstr.h>
 #include <catboost/libs/fstr/shap_values.h>
+#include <catboost/libs/fstr/util.h>
+#include <catboost/libs/loggers/logger.h>
 #include <catboost/libs/logging/logging.h>
+#include <catboost/libs/logging/profile_info.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/model.h>
 
 #include <util/generic/ptr.h>
 #include <util/generic/serialized_enum.h>
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
 #include <util/string/cast.h>
 #include <util/system/yassert.h>
 
 
+static void CheckCdFileForModelCatFeatures(const NCB::TAnalyticalModeCommonParams& params, const TFullModel& model) {
+    /* TODO(akhropov): there's a possibility of pool format with cat features w/o cd file in the future,
+        so these checks might become wrong and cat features spec in pool should be checked instead
+    */
+    CB_ENSURE(model.GetUsedCatFeaturesCount() == 0 || params.DsvPoolFormatParams.CdFilePath.Inited(),
+              "Model has categorical features. Specify column_description file with correct categorical features.");
+    if (model.HasCategoricalFeatures()) {
+        CB_ENSURE(params.DsvPoolFormatParams.CdFilePath.Inited(),
+                  "Model has categorical features. Specify column_description file with correct categorical features.");
+    }
+}
+
 namespace {
     class TLazyPoolLoader {
     public:
@@ -26,15 +45,7 @@ namespace {
 
         const NCB::TDataProviderPtr operator()() {
             if (!Dataset) {
-                /* TODO(akhropov): there's a possibility of pool format with cat features w/o cd file in the future,
-                    so these checks might become wrong and cat features spec in pool should be checked instead
-                */
-                CB_ENSURE(Model.GetUsedCatFeaturesCount() == 0 || Params.DsvPoolFormatParams.CdFilePath.Inited(),
-                          "Model has categorical features. Specify column_description file with correct categorical features.");
-                if (Model.HasCategoricalFeatures()) {
-                    CB_ENSURE(Params.DsvPoolFormatParams.CdFilePath.Inited(),
-                              "Model has categorical features. Specify column_description file with correct categorical features.");
-                }
+                CheckCdFileForModelCatFeatures(Params, Model);
 
                 TSetLoggingVerboseOrSilent inThisScope(false);
 
@@ -57,6 +68,69 @@ namespace {
     };
 }
 
+// shap values are calculated for pool parts of this size, so that neither the pool nor the result is kept in memory
+static constexpr ui32 SHAP_VALUES_POOL_BLOCK_SIZE = 10000;
+
+// documents count is needed in advance for progress logging
+static size_t CountDocuments(const NCB::TAnalyticalModeCommonParams& params, NPar::TLocalExecutor* localExecutor) {
+    if (NCB::TLineDataReaderFactory::Has(params.InputPath.Scheme)) {
+        return NCB::GetLineDataReader(params.InputPath, params.DsvPoolFormatParams.Format)->GetDataLineCount();
+    }
+    size_t documentCount = 0;
+    ReadAndProceedPoolInBlocks(params, SHAP_VALUES_POOL_BLOCK_SIZE, [&] (const NCB::TDataProviderPtr datasetPart) {
+        documentCount += datasetPart->GetObjectCount();
+    }, localExecutor, /*silentReading*/ true);
+    return documentCount;
+}
+
+static void CalcAndOutputShapValuesForPoolInBlocks(
+    const NCB::TAnalyticalModeCommonParams& params,
+    TFullModel* model,
+    NPar::TLocalExecutor* localExecutor
+) {
+    CheckCdFileForModelCatFeatures(params, *model);
+
+    size_t documentCount = 0;
+    if (model->ObliviousTrees.LeafWeights.empty()) {
+        // leaf weights are sums over documents, so they can be accumulated over pool parts in a separate pass
+        TVector<TVector<double>> leafWeights;
+        ReadAndProceedPoolInBlocks(params, SHAP_VALUES_POOL_BLOCK_SIZE, [&] (const NCB::TDataProviderPtr datasetPart) {
+            documentCount += datasetPart->GetObjectCount();
+            const TVector<TVector<double>> partLeafWeights = CollectLeavesStatistics(*datasetPart, *model, localExecutor);
+            if (leafWeights.empty()) {
+                leafWeights = partLeafWeights;
+                return;
+            }
+            for (auto treeIdx : xrange(leafWeights.size())) {
+                for (auto leafIdx : xrange(leafWeights[treeIdx].size())) {
+                    leafWeights[treeIdx][leafIdx] += partLeafWeights[treeIdx][leafIdx];
+                }
+            }
+        }, localExecutor, /*silentReading*/ true);
+        CB_ENSURE(!leafWeights.empty(), "no docs in pool");
+        model->ObliviousTrees.LeafWeights = std::move(leafWeights);
+    } else if (params.Verbose) {
+        documentCount = CountDocuments(params, localExecutor);
+    }
+    const TShapPreparedTrees preparedTrees = PrepareTrees(*model, nullptr, params.Verbose, localExecutor);
+
+    TImportanceLogger documentsLogger(documentCount, "documents processed", "Processing documents...", params.Verbose);
+    TProfileInfo processDocumentsProfile(documentCount);
+
+    TFileOutput out(params.OutputPath.Path);
+    ReadAndProceedPoolInBlocks(params, SHAP_VALUES_POOL_BLOCK_SIZE, [&] (const NCB::TDataProviderPtr datasetPart) {
+        CalcAndOutputShapValues(
+            *model,
+            preparedTrees,
+            *datasetPart->ObjectsData,
+            &documentsLogger,
+            &processDocumentsProfile,
+            &out,
+            localExecutor
+        );
+    }, localExecutor, /*silentReading*/ true);
+}
+
 void NCB::PrepareFstrModeParamsParser(
     NCB::TAnalyticalModeCommonParams* paramsPtr,
     NLastGetopt::TOpts* parserPtr) {
@@ -130,7 +204,7 @@ void NCB::ModeFstrSingleHost(const NCB::TAnalyticalModeCommonParams& params) {
             CalcAndOutputInteraction(model, nullptr, &params.OutputPath.Path);
             break;
         case EFstrType::ShapValues:
-            CalcAndOutputShapValues(model, *poolLoader(), params.OutputPath.Path, params.Verbose, localExecutor.Get());
+            CalcAndOutputShapValuesForPoolInBlocks(params, &model, localExecutor.Get());
             break;
         default:
             Y_ASSERT(false);
@@ -4,15 +4,32 @@
 #include <catboost/libs/data_new/loader.h>
 #include <catboost/libs/data_new/data_provider_builders.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
 #include <catboost/libs/options/analytical_mode_params.h>
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/maybe.h>
+
+// if silentReading is set, logging is disabled while the pool is read, but not in poolConsumer
 template <class TConsumer>
 inline void ReadAndProceedPoolInBlocks(const NCB::TAnalyticalModeCommonParams& params,
                                        ui32 blockSize,
                                        TConsumer&& poolConsumer,
-                                       NPar::TLocalExecutor* localExecutor) {
+                                       NPar::TLocalExecutor* localExecutor,
+                                       bool silentReading = false) {
+
+    TMaybe<TSetLoggingSilent> silentLogging;
+    if (silentReading) {
+        silentLogging.ConstructInPlace();
+    }
+    const auto proceedPoolPart = [&] (NCB::TDataProviderPtr datasetPart) {
+        silentLogging.Clear();
+        poolConsumer(std::move(datasetPart));
+        if (silentReading) {
+            silentLogging.ConstructInPlace();
+        }
+    };
 
     auto datasetLoader = NCB::GetProcessor<NCB::IDatasetLoader>(
         params.InputPath, // for choosing processor
@@ -55,15 +72,15 @@ inline void ReadAndProceedPoolInBlocks(const NCB::TAnalyticalModeCommonParams& p
         CB_ENSURE_INTERNAL(visitor, "failed cast of IDataProviderBuilder to IRawObjectsOrderDataVisitor");
 
         while (rawObjectsOrderDatasetLoader->DoBlock(visitor)) {
-            poolConsumer(dataProviderBuilder->GetResult());
+            proceedPoolPart(dataProviderBuilder->GetResult());
         }
         auto lastResult = dataProviderBuilder->GetLastResult();
         if (lastResult) {
-            poolConsumer(std::move(lastResult));
+            proceedPoolPart(std::move(lastResult));
         }
     } else {
         // pool is incompatible with block processing - process all pool as a whole
         datasetLoader->DoIfCompatible(dynamic_cast<NCB::IDatasetVisitor*>(dataProviderBuilder.Get()));
-        poolConsumer(dataProviderBuilder->GetResult());
+        proceedPoolPart(dataProviderBuilder->GetResult());
     }
 }
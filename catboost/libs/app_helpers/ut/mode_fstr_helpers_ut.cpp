@@ -0,0 +1,103 @@
+#include <catboost/libs/app_helpers/mode_fstr_helpers.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/fstr/shap_values.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/folder/path.h>
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+
+
+using namespace NCB;
+
+
+// shap values are calculated in several pool parts if pool has more documents than this
+static constexpr ui32 SHAP_VALUES_POOL_BLOCK_SIZE = 10000;
+
+static void TestShapValuesForPoolInBlocks(bool hasLeafWeights) {
+    TTempDir tempDir;
+    const TString poolPath = JoinFsPaths(tempDir.Name(), "pool.tsv");
+    const TString cdPath = JoinFsPaths(tempDir.Name(), "pool.cd");
+    const TString modelPath = JoinFsPaths(tempDir.Name(), "model.bin");
+    const TString shapValuesPath = JoinFsPaths(tempDir.Name(), "shap_values.tsv");
+
+    const ui32 objectCount = 2 * SHAP_VALUES_POOL_BLOCK_SIZE + 123;
+    const ui32 featureCount = 4;
+    {
+        TFastRng64 rng(0);
+        TOFStream pool(poolPath);
+        for (auto objectIdx : xrange(objectCount)) {
+            Y_UNUSED(objectIdx);
+            pool << rng.GenRandReal1();
+            for (auto featureIdx : xrange(featureCount)) {
+                Y_UNUSED(featureIdx);
+                pool << '\t' << rng.GenRandReal1();
+            }
+            pool << '\n';
+        }
+        TOFStream(cdPath).Write("0\tLabel\n");
+    }
+
+    NCatboostOptions::TDsvPoolFormatParams dsvPoolFormatParams;
+    dsvPoolFormatParams.CdFilePath = TPathWithScheme(cdPath);
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(3);
+
+    const TDataProviderPtr pool = ReadDataset(
+        TPathWithScheme(poolPath, "dsv"),
+        /*pairsFilePath*/ TPathWithScheme(),
+        /*groupWeightsFilePath*/ TPathWithScheme(),
+        dsvPoolFormatParams,
+        /*ignoredFeatures*/ {},
+        EObjectsOrder::Undefined,
+        &localExecutor
+    );
+    UNIT_ASSERT_VALUES_EQUAL(pool->GetObjectCount(), objectCount);
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 20);
+    params.InsertValue("depth", 4);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("train_dir", tempDir.Name());
+    TrainModel(params, nullptr, {}, {}, TDataProviders{pool, {pool}}, "", &model, {&evalResult});
+    UNIT_ASSERT(!model.ObliviousTrees.LeafWeights.empty());
+    if (!hasLeafWeights) {
+        model.ObliviousTrees.LeafWeights.clear();
+    }
+    OutputModel(model, modelPath);
+
+    // leaf weights of this pool are integer, so their sums don't depend on the order of summation
+    TStringStream expected;
+    OutputShapValuesMulti(CalcShapValuesMulti(model, *pool, /*logPeriod*/ 0, &localExecutor), &expected);
+
+    TAnalyticalModeCommonParams fstrParams;
+    fstrParams.DsvPoolFormatParams = dsvPoolFormatParams;
+    fstrParams.ModelFileName = modelPath;
+    fstrParams.OutputPath = TPathWithScheme(shapValuesPath);
+    fstrParams.Verbose = 0;
+    fstrParams.InputPath = TPathWithScheme(poolPath, "dsv");
+    fstrParams.FstrType = EFstrType::ShapValues;
+    fstrParams.ThreadCount = 4;
+    ModeFstrSingleHost(fstrParams);
+
+    UNIT_ASSERT_EQUAL(TIFStream(shapValuesPath).ReadAll(), expected.Str());
+}
+
+Y_UNIT_TEST_SUITE(TModeFstrHelpers) {
+    Y_UNIT_TEST(ShapValuesForPoolInBlocksWithLeafWeights) {
+        TestShapValuesForPoolInBlocks(/*hasLeafWeights*/ true);
+    }
+
+    Y_UNIT_TEST(ShapValuesForPoolInBlocksWithoutLeafWeights) {
+        TestShapValuesForPoolInBlocks(/*hasLeafWeights*/ false);
+    }
+}
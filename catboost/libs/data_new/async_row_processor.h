@@ -2,6 +2,7 @@
 
 #include <catboost/libs/helpers/exception.h>
 
+#include <library/chromium_trace/interface.h>
 #include <library/threading/future/future.h>
 #include <library/threading/local_executor/local_executor.h>
 
@@ -98,6 +99,8 @@ namespace NCB {
             NPar::TLocalExecutor::TExecRangeParams blockParams(0, ParseBuffer.ysize());
             blockParams.SetBlockCount(threadCount);
             LocalExecutor->ExecRangeWithThrow([this, blockParams, processFunc = std::move(processFunc)](int blockIdx) {
+                CHROMIUM_TRACE_SCOPE("Parse rows block");
+
                 const int blockOffset = blockIdx * blockParams.GetBlockSize();
                 for (int i = blockOffset; i < Min(blockOffset + blockParams.GetBlockSize(), ParseBuffer.ysize()); ++i) {
                     processFunc(ParseBuffer[i], i);
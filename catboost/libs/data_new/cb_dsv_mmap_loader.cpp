@@ -0,0 +1,274 @@
+#include "dsv_parser.h"
+#include "loader.h"
+
+#include <catboost/libs/data_util/exists_checker.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/chromium_trace/interface.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/maybe.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/stream/labeled.h>
+#include <util/string/iterator.h>
+#include <util/string/split.h>
+#include <util/system/filemap.h>
+#include <util/system/types.h>
+
+#include <cstring>
+
+
+namespace NCB {
+
+    namespace {
+
+    /* Reads dsv pools from a memory-mapped file.
+     * Data is split into newline-aligned byte ranges that are parsed in parallel directly from
+     * the mapped memory, lines are not copied. Object indices are assigned from per-range line counts,
+     * so the resulting objects order is the same as in the file.
+     */
+    class TCBDsvMmapDataLoader : public IRawObjectsOrderDatasetLoader {
+    public:
+        explicit TCBDsvMmapDataLoader(TDatasetLoaderPullArgs&& args);
+
+        void Do(IRawObjectsOrderDataVisitor* visitor) override;
+
+        bool DoBlock(IRawObjectsOrderDataVisitor* visitor) override;
+
+    private:
+        TVector<TStringBuf> SplitToChunks(TStringBuf data) const;
+
+        // returns [chunkIdx] -> idx of the first line in chunk, last element is total line count
+        TVector<ui64> CalcChunkLineOffsets(const TVector<TStringBuf>& chunks) const;
+
+        void ParseChunks(
+            const TVector<TStringBuf>& chunks,
+            const TVector<ui64>& chunkLineOffsets,
+            ui64 firstLineIdx,
+            IRawObjectsOrderDataVisitor* visitor
+        );
+
+    private:
+        TDatasetLoaderCommonArgs Args;
+        TDataMetaInfo DataMetaInfo;
+        TVector<bool> FeatureIgnored; // [flatFeatureIdx]
+        char FieldDelimiter;
+
+        TFileMap FileMap;
+        TStringBuf Data; // w/o header
+        ui64 LinesProcessed = 0; // for DoBlock
+    };
+
+
+    // same as IInputStream::ReadLine: lines are separated by '\n', trailing '\r' is removed
+    template <class TLineFunc>
+    inline void ForEachLine(TStringBuf data, TLineFunc&& lineFunc) {
+        TStringBuf line;
+        while (!data.empty()) {
+            data.NextTok('\n', line);
+            line.ChopSuffix(AsStringBuf("\r"));
+            lineFunc(line);
+        }
+    }
+
+    inline ui64 CountLines(TStringBuf data) {
+        ui64 count = 0;
+        const char* ptr = data.begin();
+        const char* const end = data.end();
+        while (const char* lineEnd = (const char*)memchr(ptr, '\n', end - ptr)) {
+            ++count;
+            ptr = lineEnd + 1;
+        }
+        return count + (ptr != end);
+    }
+
+    // returns the prefix of data with lineCount lines (or all data if it contains less lines)
+    inline TStringBuf GetLinesPrefix(TStringBuf data, ui64 lineCount) {
+        const char* ptr = data.begin();
+        const char* const end = data.end();
+        for (ui64 i = 0; (i < lineCount) && (ptr != end); ++i) {
+            const char* lineEnd = (const char*)memchr(ptr, '\n', end - ptr);
+            ptr = lineEnd ? lineEnd + 1 : end;
+        }
+        return TStringBuf(data.begin(), ptr);
+    }
+
+
+    TCBDsvMmapDataLoader::TCBDsvMmapDataLoader(TDatasetLoaderPullArgs&& args)
+        : Args(std::move(args.CommonArgs))
+        , FieldDelimiter(Args.PoolFormat.Delimiter)
+        , FileMap(args.PoolPath.Path)
+    {
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TCBDsvMmapDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TCBDsvMmapDataLoader:GroupWeightsFilePath does not exist");
+
+        CB_ENSURE(FileMap.Length() > 0, "TCBDsvMmapDataLoader: no data rows in pool");
+        FileMap.Map(0, FileMap.Length());
+        Data = TStringBuf((const char*)FileMap.Ptr(), FileMap.MappedSize());
+
+        TMaybe<TVector<TString>> headerColumns;
+        if (Args.PoolFormat.HasHeader) {
+            TStringBuf header;
+            CB_ENSURE(Data.NextTok('\n', header), "TCBDsvMmapDataLoader: no header in file");
+            header.ChopSuffix(AsStringBuf("\r"));
+            headerColumns = TVector<TString>(StringSplitter(header).Split(FieldDelimiter));
+        }
+
+        CB_ENSURE(!Data.empty(), "TCBDsvMmapDataLoader: no data rows in pool");
+        TStringBuf firstLine = Data.Before('\n');
+        firstLine.ChopSuffix(AsStringBuf("\r"));
+        const ui32 columnsCount = StringSplitter(firstLine).Split(FieldDelimiter).Count();
+
+        auto columnsDescription = TDataColumnsMetaInfo{ Args.CdProvider->GetColumnsDescription(columnsCount) };
+        auto featureIds = columnsDescription.GenerateFeatureIds(headerColumns);
+
+        DataMetaInfo = TDataMetaInfo(
+            std::move(columnsDescription),
+            Args.GroupWeightsFilePath.Inited(),
+            Args.PairsFilePath.Inited(),
+            &featureIds
+        );
+
+        ProcessIgnoredFeaturesList(Args.IgnoredFeatures, &DataMetaInfo, &FeatureIgnored);
+    }
+
+    void TCBDsvMmapDataLoader::Do(IRawObjectsOrderDataVisitor* visitor) {
+        const auto chunks = SplitToChunks(Data);
+        const auto chunkLineOffsets = CalcChunkLineOffsets(chunks);
+        const ui64 objectCount = chunkLineOffsets.back();
+        CB_ENSURE(
+            objectCount <= Max<ui32>(), "CatBoost does not support datasets with more than "
+            << Max<ui32>() << " objects"
+        );
+
+        visitor->Start(false, DataMetaInfo, (ui32)objectCount, Args.ObjectsOrder, {});
+        ParseChunks(chunks, chunkLineOffsets, /*firstLineIdx*/ 0, visitor);
+
+        SetGroupWeights(Args.GroupWeightsFilePath, (ui32)objectCount, visitor);
+        SetPairs(Args.PairsFilePath, (ui32)objectCount, visitor);
+        visitor->Finish();
+    }
+
+    bool TCBDsvMmapDataLoader::DoBlock(IRawObjectsOrderDataVisitor* visitor) {
+        CB_ENSURE(!Args.PairsFilePath.Inited(),
+                  "TCBDsvMmapDataLoader::DoBlock does not support pairs data");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited(),
+                  "TCBDsvMmapDataLoader::DoBlock does not support group weights data");
+
+        if (Data.empty()) {
+            return false;
+        }
+
+        const TStringBuf blockData = GetLinesPrefix(Data, Args.BlockSize);
+        Data.Skip(blockData.size());
+
+        const auto chunks = SplitToChunks(blockData);
+        const auto chunkLineOffsets = CalcChunkLineOffsets(chunks);
+        const ui32 blockObjectCount = (ui32)chunkLineOffsets.back();
+
+        visitor->Start(true, DataMetaInfo, blockObjectCount, Args.ObjectsOrder, {});
+        ParseChunks(chunks, chunkLineOffsets, LinesProcessed, visitor);
+        visitor->Finish();
+
+        LinesProcessed += blockObjectCount;
+        return true;
+    }
+
+    TVector<TStringBuf> TCBDsvMmapDataLoader::SplitToChunks(TStringBuf data) const {
+        // several chunks per thread for better load balancing, but not too small to be worth scheduling
+        constexpr size_t MIN_CHUNK_SIZE = 1 << 16;
+        const size_t threadCount = (size_t)Args.LocalExecutor->GetThreadCount() + 1;
+        const size_t chunkCount = Max<size_t>(1, Min(threadCount * 4, data.size() / MIN_CHUNK_SIZE));
+        const size_t chunkSize = data.size() / chunkCount;
+
+        TVector<TStringBuf> chunks;
+        chunks.reserve(chunkCount);
+        while (!data.empty()) {
+            size_t chunkEnd = Min(chunkSize, data.size());
+            if (chunkEnd < data.size()) {
+                const size_t lineEnd = data.find('\n', chunkEnd ? chunkEnd - 1 : 0);
+                chunkEnd = (lineEnd == TStringBuf::npos) ? data.size() : lineEnd + 1;
+            }
+            chunks.push_back(data.Head(chunkEnd));
+            data.Skip(chunkEnd);
+        }
+        return chunks;
+    }
+
+    TVector<ui64> TCBDsvMmapDataLoader::CalcChunkLineOffsets(const TVector<TStringBuf>& chunks) const {
+        TVector<ui64> chunkLineOffsets(chunks.size() + 1, 0);
+        Args.LocalExecutor->ExecRangeWithThrow(
+            [&](int chunkIdx) {
+                chunkLineOffsets[chunkIdx + 1] = CountLines(chunks[chunkIdx]);
+            },
+            0,
+            SafeIntegerCast<int>(chunks.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        for (auto chunkIdx : xrange(chunks.size())) {
+            chunkLineOffsets[chunkIdx + 1] += chunkLineOffsets[chunkIdx];
+        }
+        return chunkLineOffsets;
+    }
+
+    void TCBDsvMmapDataLoader::ParseChunks(
+        const TVector<TStringBuf>& chunks,
+        const TVector<ui64>& chunkLineOffsets,
+        ui64 firstLineIdx,
+        IRawObjectsOrderDataVisitor* visitor
+    ) {
+        visitor->StartNextBlock((ui32)chunkLineOffsets.back());
+
+        const auto* const featuresLayout = DataMetaInfo.FeaturesLayout.Get();
+
+        Args.LocalExecutor->ExecRangeWithThrow(
+            [&](int chunkIdx) {
+                CHROMIUM_TRACE_SCOPE("Parse chunk");
+
+                // buffers are reused for all lines in chunk, visitor copies their contents
+                TVector<float> floatFeatures;
+                floatFeatures.yresize(featuresLayout->GetFloatFeatureCount());
+
+                TVector<ui32> catFeatures;
+                catFeatures.yresize(featuresLayout->GetCatFeatureCount());
+
+                TDsvLineParser parser(
+                    FieldDelimiter,
+                    DataMetaInfo.ColumnsInfo->Columns,
+                    FeatureIgnored,
+                    featuresLayout,
+                    floatFeatures,
+                    catFeatures,
+                    visitor);
+
+                ui32 inBlockIdx = (ui32)chunkLineOffsets[chunkIdx];
+                ForEachLine(
+                    chunks[chunkIdx],
+                    [&](TStringBuf line) {
+                        if (const auto errCtx = parser.Parse(line, inBlockIdx)) {
+                            // 1-based data line number (header is not counted), same as in TCBDsvDataLoader
+                            const auto lineIdx = firstLineIdx + inBlockIdx + 1;
+                            ythrow TDsvLineParser::MakeException(errCtx.GetRef()) << "; " << LabeledOutput(lineIdx);
+                        }
+                        ++inBlockIdx;
+                    }
+                );
+            },
+            0,
+            SafeIntegerCast<int>(chunks.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+
+    TDatasetLoaderFactory::TRegistrator<TCBDsvMmapDataLoader> CBDsvMmapDataLoaderReg("mmap-dsv");
+
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "exclusive_feature_bundling.h"
 #include "features_layout.h"
 #include "packed_binary_features.h"
 
@@ -135,6 +136,67 @@ namespace NCB {
      * Quantized/prepared for quantization data
      */
 
+    /* Quantized float features with few bins are stored on CPU with 2 or 4 bits per key
+     * (see TQuantizationOptions::PackLowCardinalityFeaturesForCpu).
+     * TCompressedArray fills ui64 words starting from the lowest bits, so on little-endian architectures
+     * such data can be read bytewise without unpacking.
+     */
+    template <ui32 BitsPerKey>
+    class TPackedQuantizedValuesRef {
+        static_assert((BitsPerKey == 2) || (BitsPerKey == 4), "Only 2 and 4 bits per key are supported");
+#if defined(_big_endian_)
+        static_assert(BitsPerKey == 0, "Can't read TCompressedArray's data bytewise because of big-endian architecture");
+#endif
+
+    public:
+        explicit TPackedQuantizedValuesRef(const ui8* data)
+            : Data(data)
+        {}
+
+        ui8 operator[](size_t idx) const {
+            constexpr size_t valuesPerByte = CHAR_BIT / BitsPerKey;
+            return (Data[idx / valuesPerByte] >> (idx % valuesPerByte * BitsPerKey)) & ((1 << BitsPerKey) - 1);
+        }
+
+    private:
+        const ui8* Data;
+    };
+
+    /* Calls f with an accessor to data with bitsPerKey bits per value that supports operator[]:
+     * const ui8* if bitsPerKey == 8 or TPackedQuantizedValuesRef otherwise,
+     * so the body of f is instantiated for each storage width
+     */
+    template <class TFunc>
+    inline void DispatchQuantizedValuesRef(const ui8* data, ui32 bitsPerKey, TFunc&& f) {
+        switch (bitsPerKey) {
+            case 2:
+                f(TPackedQuantizedValuesRef<2>(data));
+                break;
+            case 4:
+                f(TPackedQuantizedValuesRef<4>(data));
+                break;
+            case 8:
+                f(data);
+                break;
+            default:
+                CB_ENSURE_INTERNAL(false, "Unsupported bits per key for quantized values: " << bitsPerKey);
+        }
+    }
+
+    // for code where dispatching on each call is cheaper than instantiating for each storage width
+    inline ui8 GetQuantizedValue(const ui8* data, ui32 bitsPerKey, size_t idx) {
+        switch (bitsPerKey) {
+            case 2:
+                return TPackedQuantizedValuesRef<2>(data)[idx];
+            case 4:
+                return TPackedQuantizedValuesRef<4>(data)[idx];
+            default:
+                Y_ASSERT(bitsPerKey == 8);
+                return data[idx];
+        }
+    }
+
+
     template <class TBase>
     class TCompressedValuesHolderImpl : public TBase {
     public:
@@ -183,6 +245,11 @@ namespace NCB {
             return SrcData.GetBitsPerKey();
         }
 
+        // data is without subset indexing, values are stored with GetBitsPerKey() bits
+        const ui8* GetRawSrcData() const {
+            return reinterpret_cast<const ui8*>(SrcDataRawPtr);
+        }
+
     private:
         TCompressedArray SrcData;
         void* SrcDataRawPtr;
@@ -256,6 +323,77 @@ namespace NCB {
     };
 
 
+    // feature that is a part of exclusive features bundle, see exclusive_feature_bundling.h
+    template <class TBase>
+    class TBundlePartValuesHolderImpl : public TBase {
+    public:
+        TBundlePartValuesHolderImpl(ui32 featureId,
+                                    NCB::TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue> srcData,
+                                    TBoundsInBundle boundsInBundle,
+                                    const TFeaturesArraySubsetIndexing* subsetIndexing)
+            : TBase(featureId, subsetIndexing->Size())
+            , SrcData(std::move(srcData))
+            , BoundsInBundle(boundsInBundle)
+            , SubsetIndexing(subsetIndexing)
+        {
+            CB_ENSURE(
+                (BoundsInBundle.Begin > 0) && (BoundsInBundle.Begin < BoundsInBundle.End),
+                "Bad BoundsInBundle [" << BoundsInBundle.Begin << ", " << BoundsInBundle.End << ')'
+            );
+            CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
+        }
+
+        THolder<TBase> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const override {
+            return MakeHolder<TBundlePartValuesHolderImpl>(
+                TBase::GetId(),
+                SrcData,
+                BoundsInBundle,
+                subsetIndexing
+            );
+        }
+
+        // in some cases non-standard T can be useful / more efficient
+        template <class T = typename TBase::TValueType>
+        TMaybeOwningArrayHolder<T> ExtractValuesT(NPar::TLocalExecutor* localExecutor) const {
+            TConstArrayRef<TExclusiveFeaturesBundleValue> srcData = *SrcData;
+
+            TVector<T> dst;
+            dst.yresize(SubsetIndexing->Size());
+
+            SubsetIndexing->ParallelForEach(
+                [&dst, srcData, boundsInBundle = BoundsInBundle] (ui32 idx, ui32 srcDataIdx) {
+                    dst[idx] = GetBinFromBundle(srcData[srcDataIdx], boundsInBundle);
+                },
+                localExecutor
+            );
+
+            return TMaybeOwningArrayHolder<T>::CreateOwning(std::move(dst));
+        }
+
+        TMaybeOwningArrayHolder<typename TBase::TValueType> ExtractValues(
+            NPar::TLocalExecutor* localExecutor
+        ) const override {
+            return ExtractValuesT<typename TBase::TValueType>(localExecutor);
+        }
+
+        TBoundsInBundle GetBoundsInBundle() const {
+            return BoundsInBundle;
+        }
+
+        // whole bundle data without subset indexing
+        const NCB::TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue>& GetBundleSrcData() const {
+            return SrcData;
+        }
+
+    private:
+        NCB::TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue> SrcData;
+        TBoundsInBundle BoundsInBundle;
+        const TFeaturesArraySubsetIndexing* SubsetIndexing;
+    };
+
+
     /* interface instead of concrete TQuantizedFloatValuesHolder because there is
      * an alternative implementation TExternalFloatValuesHolder for GPU
      */
@@ -287,6 +425,7 @@ namespace NCB {
 
     using TQuantizedFloatValuesHolder = TCompressedValuesHolderImpl<IQuantizedFloatValuesHolder>;
     using TQuantizedFloatPackedBinaryValuesHolder = TPackedBinaryValuesHolderImpl<IQuantizedFloatValuesHolder>;
+    using TQuantizedFloatBundlePartValuesHolder = TBundlePartValuesHolderImpl<IQuantizedFloatValuesHolder>;
 
     /* interface instead of concrete TQuantizedFloatValuesHolder because there is
      * an alternative implementation TExternalFloatValuesHolder for GPU
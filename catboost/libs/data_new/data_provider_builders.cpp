@@ -878,7 +878,7 @@ namespace NCB {
             Y_UNUSED(flatFeatureIdx);
             Y_UNUSED(objectOffset);
             Y_UNUSED(featuresPart);
-            CB_ENSURE(false, "Categorical features are not yet supported in serialized quantized pools");
+            CB_ENSURE(false, "Serialized quantized pools can contain only numeric features, categorical features are not supported");
         }
 
         // TRawTargetData
@@ -0,0 +1,142 @@
+#include "exclusive_feature_bundling.h"
+
+#include "columns.h"
+#include "quantized_features_info.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/bitmap.h>
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+
+
+namespace NCB {
+
+    namespace {
+        struct TSparseFeature {
+            ui32 FloatFeatureIdx = 0;
+            ui32 BinCount = 0;
+            TVector<ui32> NonDefaultObjectIndices;
+        };
+
+        struct TBundleInProgress {
+            TExclusiveFeaturesBundle Bundle;
+            TDynBitMap UsedObjects; // objects where some part of the bundle has a non-default bin
+        };
+    }
+
+
+    static bool HasConflicts(const TDynBitMap& usedObjects, TConstArrayRef<ui32> objectIndices) {
+        return AnyOf(objectIndices, [&] (ui32 objectIdx) { return usedObjects.Test(objectIdx); });
+    }
+
+
+    TVector<TExclusiveFeaturesBundle> CreateExclusiveFeatureBundles(
+        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+        TConstArrayRef<THolder<IQuantizedFloatValuesHolder>> quantizedFloatFeatures,
+        TConstArrayRef<TMaybe<TPackedBinaryIndex>> floatFeatureToPackedBinaryIndex,
+        const TExclusiveFeaturesBundlingOptions& options,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        CB_ENSURE_INTERNAL(
+            options.MaxBinsPerBundle <= (1u << (sizeof(TExclusiveFeaturesBundleValue) * CHAR_BIT)),
+            "MaxBinsPerBundle (" << options.MaxBinsPerBundle << ") does not fit into bundle values type"
+        );
+
+        TVector<ui32> candidateFeatures;
+        quantizedFeaturesInfo.GetFeaturesLayout()->IterateOverAvailableFeatures<EFeatureType::Float>(
+            [&] (TFloatFeatureIdx floatFeatureIdx) {
+                if (floatFeatureToPackedBinaryIndex[*floatFeatureIdx] || !quantizedFloatFeatures[*floatFeatureIdx]) {
+                    return;
+                }
+                // one more bundle value is needed for all default bins
+                const size_t binCount = quantizedFeaturesInfo.GetBorders(floatFeatureIdx).size() + 1;
+                if ((binCount > 1) && (binCount <= options.MaxBinsPerBundle)) {
+                    candidateFeatures.push_back(*floatFeatureIdx);
+                }
+            }
+        );
+        if (candidateFeatures.size() < 2) {
+            return {};
+        }
+
+        const ui32 objectCount = quantizedFloatFeatures[candidateFeatures[0]]->GetSize();
+        const size_t maxNonDefaultValuesCount = size_t(options.MaxNonDefaultValuesFraction * objectCount);
+
+        TVector<TMaybe<TSparseFeature>> maybeSparseFeatures(candidateFeatures.size());
+        localExecutor->ExecRangeWithThrow(
+            [&] (int candidateIdx) {
+                const ui32 floatFeatureIdx = candidateFeatures[candidateIdx];
+                const auto values = quantizedFloatFeatures[floatFeatureIdx]->ExtractValues(localExecutor);
+
+                TSparseFeature sparseFeature;
+                sparseFeature.FloatFeatureIdx = floatFeatureIdx;
+                sparseFeature.BinCount = SafeIntegerCast<ui32>(
+                    quantizedFeaturesInfo.GetBorders(TFloatFeatureIdx(floatFeatureIdx)).size() + 1
+                );
+
+                TConstArrayRef<ui8> valuesRef = *values;
+                for (auto objectIdx : xrange(objectCount)) {
+                    if (valuesRef[objectIdx]) {
+                        if (sparseFeature.NonDefaultObjectIndices.size() == maxNonDefaultValuesCount) {
+                            return;
+                        }
+                        sparseFeature.NonDefaultObjectIndices.push_back(objectIdx);
+                    }
+                }
+                maybeSparseFeatures[candidateIdx] = std::move(sparseFeature);
+            },
+            0,
+            SafeIntegerCast<int>(candidateFeatures.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        TVector<TSparseFeature> sparseFeatures;
+        for (auto& maybeSparseFeature : maybeSparseFeatures) {
+            if (maybeSparseFeature) {
+                sparseFeatures.push_back(std::move(*maybeSparseFeature));
+            }
+        }
+        StableSortBy(
+            sparseFeatures,
+            [] (const TSparseFeature& sparseFeature) { return -(i64)sparseFeature.NonDefaultObjectIndices.size(); }
+        );
+
+        TVector<TBundleInProgress> bundlesInProgress;
+        for (const auto& sparseFeature : sparseFeatures) {
+            auto bundleIt = FindIf(
+                bundlesInProgress,
+                [&] (const TBundleInProgress& bundleInProgress) {
+                    return
+                        (bundleInProgress.Bundle.GetBinCount() + sparseFeature.BinCount - 1
+                            <= options.MaxBinsPerBundle)
+                        && !HasConflicts(bundleInProgress.UsedObjects, sparseFeature.NonDefaultObjectIndices);
+                }
+            );
+            if (bundleIt == bundlesInProgress.end()) {
+                bundlesInProgress.emplace_back();
+                bundleIt = bundlesInProgress.end() - 1;
+                bundleIt->UsedObjects.Reserve(objectCount);
+            }
+            bundleIt->Bundle.Add(sparseFeature.FloatFeatureIdx, sparseFeature.BinCount);
+            for (auto objectIdx : sparseFeature.NonDefaultObjectIndices) {
+                bundleIt->UsedObjects.Set(objectIdx);
+            }
+        }
+
+        TVector<TExclusiveFeaturesBundle> result;
+        for (auto& bundleInProgress : bundlesInProgress) {
+            if (bundleInProgress.Bundle.Parts.size() > 1) {
+                result.push_back(std::move(bundleInProgress.Bundle));
+            }
+        }
+
+        CATBOOST_DEBUG_LOG << "Exclusive features bundling: " << sparseFeatures.size()
+            << " sparse float features, " << result.size() << " bundles" << Endl;
+
+        return result;
+    }
+
+}
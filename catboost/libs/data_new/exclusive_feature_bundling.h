@@ -0,0 +1,178 @@
+#pragma once
+
+#include "packed_binary_features.h"
+
+#include <library/binsaver/bin_saver.h>
+#include <library/dbg_output/dump.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+#include <util/system/yassert.h>
+
+#include <climits>
+#include <tuple>
+
+
+namespace NCB {
+
+    class IQuantizedFloatValuesHolder;
+    class TQuantizedFeaturesInfo;
+
+
+    /* Exclusive features bundling:
+     * sparse quantized float features that never have non-default (non-zero) bins for the same object
+     * are stored together in one ui8 column (bundle).
+     * Each feature (bundle part) occupies its own range of bundle values [Begin, End) for its
+     * non-default bins 1, 2, ..., so (End - Begin) == bins count - 1.
+     * Bundle value 0 means that all parts have default bin 0.
+     */
+
+    using TExclusiveFeaturesBundleValue = ui8;
+
+    struct TBoundsInBundle {
+        ui32 Begin = 0;
+        ui32 End = 0;
+
+    public:
+        TBoundsInBundle() = default;
+
+        TBoundsInBundle(ui32 begin, ui32 end)
+            : Begin(begin)
+            , End(end)
+        {}
+
+        bool operator==(const TBoundsInBundle rhs) const {
+            return std::tie(Begin, End) == std::tie(rhs.Begin, rhs.End);
+        }
+
+        SAVELOAD(Begin, End);
+
+        ui32 GetSize() const {
+            return End - Begin;
+        }
+    };
+
+    inline ui8 GetBinFromBundle(TExclusiveFeaturesBundleValue bundleValue, TBoundsInBundle bounds) {
+        return ((bundleValue >= bounds.Begin) && (bundleValue < bounds.End)) ?
+            ui8(bundleValue - bounds.Begin + 1)
+            : ui8(0);
+    }
+
+    struct TExclusiveBundlePart {
+        ui32 FloatFeatureIdx = 0;
+        TBoundsInBundle Bounds;
+
+    public:
+        TExclusiveBundlePart() = default;
+
+        TExclusiveBundlePart(ui32 floatFeatureIdx, TBoundsInBundle bounds)
+            : FloatFeatureIdx(floatFeatureIdx)
+            , Bounds(bounds)
+        {}
+
+        bool operator==(const TExclusiveBundlePart& rhs) const {
+            return (FloatFeatureIdx == rhs.FloatFeatureIdx) && (Bounds == rhs.Bounds);
+        }
+
+        SAVELOAD(FloatFeatureIdx, Bounds);
+    };
+
+    struct TExclusiveFeaturesBundle {
+        TVector<TExclusiveBundlePart> Parts; // sorted by Bounds, Bounds are adjacent
+
+    public:
+        bool operator==(const TExclusiveFeaturesBundle& rhs) const {
+            return Parts == rhs.Parts;
+        }
+
+        SAVELOAD(Parts);
+
+        // including value 0 for all default bins
+        ui32 GetBinCount() const {
+            return Parts.empty() ? 1 : Parts.back().Bounds.End;
+        }
+
+        // binCount includes default bin 0
+        void Add(ui32 floatFeatureIdx, ui32 binCount) {
+            Y_ASSERT(binCount > 1);
+            const ui32 begin = GetBinCount();
+            Parts.emplace_back(floatFeatureIdx, TBoundsInBundle(begin, begin + binCount - 1));
+        }
+    };
+
+    // 2d index: [BundleIdx][InBundleIdx]
+    struct TExclusiveBundleIndex {
+        ui32 BundleIdx = 0;
+        ui32 InBundleIdx = 0;
+
+    public:
+        // needed for BinSaver
+        explicit TExclusiveBundleIndex(ui32 bundleIdx = 0, ui32 inBundleIdx = 0)
+            : BundleIdx(bundleIdx)
+            , InBundleIdx(inBundleIdx)
+        {}
+
+        bool operator==(const TExclusiveBundleIndex rhs) const {
+            return std::tie(BundleIdx, InBundleIdx) == std::tie(rhs.BundleIdx, rhs.InBundleIdx);
+        }
+
+        SAVELOAD(BundleIdx, InBundleIdx);
+    };
+
+    /* Accessor to one feature's bins in bundle data with operator[] like TPackedQuantizedValuesRef,
+     * see TQuantizedForCPUObjectsDataProvider::VisitFloatFeatureRawSrcData
+     */
+    class TBundlePartValuesRef {
+    public:
+        TBundlePartValuesRef(const TExclusiveFeaturesBundleValue* data, TBoundsInBundle bounds)
+            : Data(data)
+            , Bounds(bounds)
+        {}
+
+        ui8 operator[](size_t idx) const {
+            return GetBinFromBundle(Data[idx], Bounds);
+        }
+
+    private:
+        const TExclusiveFeaturesBundleValue* Data;
+        TBoundsInBundle Bounds;
+    };
+
+
+    struct TExclusiveFeaturesBundlingOptions {
+        // features with a bigger share of objects with non-default bins are not bundled
+        float MaxNonDefaultValuesFraction = 0.1f;
+
+        // bundles are stored as TExclusiveFeaturesBundleValue
+        ui32 MaxBinsPerBundle = 1 << (sizeof(TExclusiveFeaturesBundleValue) * CHAR_BIT);
+    };
+
+    /* Greedily selects bundles of float features without conflicts (objects where more than one feature in
+     * a bundle has a non-default bin), features with larger non-default values counts are processed first.
+     * quantizedFloatFeatures are indexed by floatFeatureIdx and have consecutive data,
+     * features that are packed as binary or are not available are skipped.
+     * Bundles with only one feature are not returned.
+     */
+    TVector<TExclusiveFeaturesBundle> CreateExclusiveFeatureBundles(
+        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+        TConstArrayRef<THolder<IQuantizedFloatValuesHolder>> quantizedFloatFeatures,
+        TConstArrayRef<TMaybe<TPackedBinaryIndex>> floatFeatureToPackedBinaryIndex,
+        const TExclusiveFeaturesBundlingOptions& options,
+        NPar::TLocalExecutor* localExecutor
+    );
+
+}
+
+
+template <>
+struct TDumper<NCB::TExclusiveBundleIndex> {
+    template <class S>
+    static inline void Dump(S& s, const NCB::TExclusiveBundleIndex& exclusiveBundleIndex) {
+        s << "BundleIdx=" << exclusiveBundleIndex.BundleIdx
+          << ",InBundleIdx=" << exclusiveBundleIndex.InBundleIdx;
+    }
+};
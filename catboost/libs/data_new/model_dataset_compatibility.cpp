@@ -80,9 +80,6 @@ namespace NCB {
         const TObjectsDataProvider& objectsData,
         THashMap<ui32, ui32>* columnIndexesReorderMap)
     {
-        if (dynamic_cast<const TQuantizedForCPUObjectsDataProvider*>(&objectsData)) {
-            CB_ENSURE(model.GetUsedCatFeaturesCount() == 0, "Quantized datasets with categorical features are not currently supported");
-        }
         const auto& datasetFeaturesLayout = *objectsData.GetFeaturesLayout();
 
         const auto datasetCatFeatureInternalIdxToExternalIdx =
@@ -168,16 +165,19 @@ namespace NCB {
         const TFullModel& model,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo)
     {
-        TVector<TVector<ui8>> floatBinsRemap(model.ObliviousTrees.FloatFeatures.size());
+        const auto& featuresLayout = *quantizedFeaturesInfo.GetFeaturesLayout();
+        TVector<TVector<ui8>> floatBinsRemap(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
         for (const auto& feature: model.ObliviousTrees.FloatFeatures) {
             if (feature.Borders.empty()) {
                 continue;
             }
+            const auto floatFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Float>(
+                feature.FlatFeatureIndex);
             CB_ENSURE(
-                quantizedFeaturesInfo.HasBorders(NCB::TFloatFeatureIdx(feature.FlatFeatureIndex)),
+                quantizedFeaturesInfo.HasBorders(floatFeatureIdx),
                 "Feature " << feature.FlatFeatureIndex <<  ": dataset does not have border information for it"
             );
-            auto& quantizedBorders = quantizedFeaturesInfo.GetBorders(NCB::TFloatFeatureIdx(feature.FlatFeatureIndex));
+            auto& quantizedBorders = quantizedFeaturesInfo.GetBorders(floatFeatureIdx);
             ui32 poolBucketIdx = 0;
             auto addRemapBinIdx = [&] (ui8 bucketIdx) {
                 floatBinsRemap[feature.FlatFeatureIndex].push_back(bucketIdx);
@@ -204,4 +204,31 @@ namespace NCB {
         }
         return floatBinsRemap;
     }
+
+    TVector<TVector<ui32>> GetCatFeaturesPerfectHashToHashRemap(
+        const TFullModel& model,
+        const TQuantizedFeaturesInfo& quantizedFeaturesInfo)
+    {
+        const auto& featuresLayout = *quantizedFeaturesInfo.GetFeaturesLayout();
+        TVector<TVector<ui32>> catFeaturesRemap(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
+        for (const auto& feature : model.ObliviousTrees.CatFeatures) {
+            if (!feature.UsedInModel) {
+                continue;
+            }
+            const auto catFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Categorical>(
+                feature.FlatFeatureIndex);
+            const auto& perfectHash = quantizedFeaturesInfo.GetCategoricalFeaturesPerfectHash(catFeatureIdx);
+            auto& remap = catFeaturesRemap[feature.FlatFeatureIndex];
+            remap.yresize(perfectHash.size());
+            for (const auto& [hashedValue, perfectHashedValue] : perfectHash) {
+                CB_ENSURE_INTERNAL(
+                    perfectHashedValue < remap.size(),
+                    "Feature " << feature.FlatFeatureIndex << ": perfect hash value " << perfectHashedValue
+                    << " is out of range"
+                );
+                remap[perfectHashedValue] = hashedValue;
+            }
+        }
+        return catFeaturesRemap;
+    }
 }
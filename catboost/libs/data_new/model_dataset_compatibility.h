@@ -18,4 +18,8 @@ namespace NCB {
     TVector<TVector<ui8>> GetFloatFeaturesBordersRemap(  // [flatFeatureIdx][poolFeatureBin]
         const TFullModel& model,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo);
+
+    TVector<TVector<ui32>> GetCatFeaturesPerfectHashToHashRemap(  // [flatFeatureIdx][perfectHashedValue] -> hashedValue
+        const TFullModel& model,
+        const TQuantizedFeaturesInfo& quantizedFeaturesInfo);
 }
@@ -680,12 +680,14 @@ NCB::TObjectsDataProviderPtr NCB::TQuantizedObjectsDataProvider::GetSubset(
     );
 }
 
+// only first objectCount objects are used
 template <EFeatureType FeatureType, class T, class IColumn>
 static ui32 CalcFeatureValuesCheckSum(
     ui32 init,
     const TFeaturesLayout& featuresLayout,
     const TVector<THolder<IColumn>>& featuresData,
-    NPar::TLocalExecutor* localExecutor)
+    NPar::TLocalExecutor* localExecutor,
+    ui32 objectCount = Max<ui32>())
 {
     ui32 checkSum = init;
     const ui32 emptyColumnDataForCrc = 0;
@@ -696,17 +698,26 @@ static ui32 CalcFeatureValuesCheckSum(
             );
             if (compressedValuesFeatureData) {
                 if (compressedValuesFeatureData->GetBitsPerKey() == CHAR_BIT*sizeof(T)) {
-                    compressedValuesFeatureData->GetArrayData().ForEach([&](ui32 /*idx*/, T element) {
+                    compressedValuesFeatureData->GetArrayData().Find([&](ui32 idx, T element) {
+                        if (idx >= objectCount) {
+                            return true;
+                        }
                         checkSum = UpdateCheckSum(checkSum, (ui32)element);
+                        return false;
                     });
                 } else {
-                    compressedValuesFeatureData->GetCompressedData().ForEach([&](ui32 /*idx*/, ui32 element) {
+                    compressedValuesFeatureData->GetCompressedData().Find([&](ui32 idx, ui32 element) {
+                        if (idx >= objectCount) {
+                            return true;
+                        }
                         checkSum = UpdateCheckSum(checkSum, element);
+                        return false;
                     });
                 }
             } else {
                 const auto valuesFeatureData = featuresData[perTypeFeatureIdx]->ExtractValues(localExecutor);
-                for (auto element : *valuesFeatureData) {
+                const auto values = *valuesFeatureData;
+                for (auto element : values.Slice(0, Min<size_t>(values.size(), objectCount))) {
                     checkSum = UpdateCheckSum(checkSum, element);
                 }
             }
@@ -721,13 +732,13 @@ ui32 NCB::TQuantizedObjectsDataProvider::CalcFeaturesCheckSum(NPar::TLocalExecut
     ui32 checkSum = 0;
 
     checkSum = Data.QuantizedFeaturesInfo->CalcCheckSum();
-    checkSum = CalcFeatureValuesCheckSum<EFeatureType::Float, ui8>(
+    checkSum = ::CalcFeatureValuesCheckSum<EFeatureType::Float, ui8>(
         checkSum,
         *CommonData.FeaturesLayout,
         Data.FloatFeatures,
         localExecutor
     );
-    checkSum = CalcFeatureValuesCheckSum<EFeatureType::Categorical, ui32>(
+    checkSum = ::CalcFeatureValuesCheckSum<EFeatureType::Categorical, ui32>(
         checkSum,
         *CommonData.FeaturesLayout,
         Data.CatFeatures,
@@ -738,11 +749,37 @@ ui32 NCB::TQuantizedObjectsDataProvider::CalcFeaturesCheckSum(NPar::TLocalExecut
 
 }
 
+ui32 NCB::TQuantizedObjectsDataProvider::CalcFeatureValuesCheckSum(NPar::TLocalExecutor* localExecutor) const {
+    return CalcFeatureValuesPrefixCheckSum(GetObjectCount(), localExecutor);
+}
+
+ui32 NCB::TQuantizedObjectsDataProvider::CalcFeatureValuesPrefixCheckSum(
+    ui32 objectCount,
+    NPar::TLocalExecutor* localExecutor
+) const {
+    CB_ENSURE_INTERNAL(objectCount <= GetObjectCount(), "Prefix is larger than objects data");
+    ui32 checkSum = ::CalcFeatureValuesCheckSum<EFeatureType::Float, ui8>(
+        0,
+        *CommonData.FeaturesLayout,
+        Data.FloatFeatures,
+        localExecutor,
+        objectCount
+    );
+    return ::CalcFeatureValuesCheckSum<EFeatureType::Categorical, ui32>(
+        checkSum,
+        *CommonData.FeaturesLayout,
+        Data.CatFeatures,
+        localExecutor,
+        objectCount
+    );
+}
+
 template <EFeatureType FeatureType, class IColumnType>
 static void LoadFeatures(
     const TFeaturesLayout& featuresLayout,
     const TFeaturesArraySubsetIndexing* subsetIndexing,
     const TMaybe<TPackedBinaryFeaturesData*> packedBinaryFeaturesData,
+    const TMaybe<TExclusiveFeatureBundlesData*> exclusiveFeatureBundlesData,
     IBinSaver* binSaver,
     TVector<THolder<IColumnType>>* dst
 ) {
@@ -758,6 +795,12 @@ static void LoadFeatures(
         featureToPackedBinaryIndex = nullptr;
     }
 
+    // only float features can be bundled
+    TConstArrayRef<TMaybe<TExclusiveBundleIndex>> featureToBundlePart;
+    if (exclusiveFeatureBundlesData && (FeatureType == EFeatureType::Float)) {
+        featureToBundlePart = (**exclusiveFeatureBundlesData).FloatFeatureToBundlePart;
+    }
+
     dst->clear();
     dst->resize(featuresLayout.GetFeatureCount(FeatureType));
 
@@ -795,6 +838,27 @@ static void LoadFeatures(
                     packedBinaryIndex.BitIdx,
                     subsetIndexing
                 );
+            } else if (!featureToBundlePart.empty() && featureToBundlePart[*featureIdx]) {
+                const TExclusiveBundleIndex bundleIndex = *featureToBundlePart[*featureIdx];
+                const TBoundsInBundle expectedBounds = (**exclusiveFeatureBundlesData).MetaData
+                    [bundleIndex.BundleIdx].Parts[bundleIndex.InBundleIdx].Bounds;
+
+                TBoundsInBundle boundsInBundle;
+                binSaver->Add(0, &boundsInBundle);
+
+                CB_ENSURE_INTERNAL(
+                    boundsInBundle == expectedBounds,
+                    "deserialized bounds in bundle [" << boundsInBundle.Begin << ", " << boundsInBundle.End
+                    << ") are not equal to expected bounds [" << expectedBounds.Begin << ", "
+                    << expectedBounds.End << ")"
+                );
+
+                (*dst)[*featureIdx] = MakeHolder<TBundlePartValuesHolderImpl<IColumnType>>(
+                    flatFeatureIdx,
+                    (**exclusiveFeatureBundlesData).SrcData[bundleIndex.BundleIdx],
+                    boundsInBundle,
+                    subsetIndexing
+                );
             } else {
                 ui32 bitsPerKey;
                 binSaver->Add(0, &bitsPerKey);
@@ -826,6 +890,7 @@ void NCB::TQuantizedObjectsData::Load(
         *QuantizedFeaturesInfo->GetFeaturesLayout(),
         subsetIndexing,
         /*packedBinaryFeaturesData*/ Nothing(),
+        /*exclusiveFeatureBundlesData*/ Nothing(),
         binSaver,
         &FloatFeatures
     );
@@ -833,6 +898,7 @@ void NCB::TQuantizedObjectsData::Load(
         *QuantizedFeaturesInfo->GetFeaturesLayout(),
         subsetIndexing,
         /*packedBinaryFeaturesData*/ Nothing(),
+        /*exclusiveFeatureBundlesData*/ Nothing(),
         binSaver,
         &CatFeatures
     );
@@ -856,6 +922,10 @@ static void SaveFeatures(
                     = dynamic_cast<const TPackedBinaryValuesHolderImpl<IColumnType>*>(column))
             {
                 SaveMulti(binSaver, column->GetId(), column->GetSize(), packedBinaryValues->GetBitIdx());
+            } else if (auto* bundlePartValues
+                           = dynamic_cast<const TBundlePartValuesHolderImpl<IColumnType>*>(column))
+            {
+                SaveMulti(binSaver, column->GetId(), column->GetSize(), bundlePartValues->GetBoundsInBundle());
             } else {
                 // TODO(akhropov): replace by repacking (possibly in parts) to compressed array in the future
                 const auto values = column->ExtractValues(localExecutor);
@@ -1005,17 +1075,73 @@ TPackedBinaryIndex NCB::TPackedBinaryFeaturesData::AddFeature(
 }
 
 
+NCB::TExclusiveFeatureBundlesData::TExclusiveFeatureBundlesData(
+    const TFeaturesLayout& featuresLayout,
+    TVector<TExclusiveFeaturesBundle>&& metaData
+)
+    : MetaData(std::move(metaData))
+{
+    FloatFeatureToBundlePart.resize(featuresLayout.GetFloatFeatureCount());
+    for (auto bundleIdx : xrange(SafeIntegerCast<ui32>(MetaData.size()))) {
+        const auto& bundle = MetaData[bundleIdx];
+        for (auto inBundleIdx : xrange(SafeIntegerCast<ui32>(bundle.Parts.size()))) {
+            FloatFeatureToBundlePart[bundle.Parts[inBundleIdx].FloatFeatureIdx]
+                = TExclusiveBundleIndex(bundleIdx, inBundleIdx);
+        }
+    }
+    SrcData.resize(MetaData.size());
+}
+
+void NCB::TExclusiveFeatureBundlesData::Save(
+    const TArraySubsetIndexing<ui32>& subsetIndexing,
+    IBinSaver* binSaver
+) const {
+    Y_ASSERT(!binSaver->IsReading());
+
+    SaveMulti(binSaver, FloatFeatureToBundlePart, MetaData, subsetIndexing.Size());
+
+    for (const auto& srcDataElement : SrcData) {
+        const auto srcDataElementArray = *srcDataElement;
+        subsetIndexing.ForEach(
+            [&](ui32 /*idx*/, ui32 srcIdx) {
+                SaveMulti(binSaver, srcDataElementArray[srcIdx]);
+            }
+        );
+    }
+}
+
+void NCB::TExclusiveFeatureBundlesData::Load(IBinSaver* binSaver) {
+    Y_ASSERT(binSaver->IsReading());
+
+    ui32 objectCount = 0;
+    LoadMulti(binSaver, &FloatFeatureToBundlePart, &MetaData, &objectCount);
+
+    SrcData.resize(MetaData.size());
+    for (auto& srcDataElement : SrcData) {
+        TVector<TExclusiveFeaturesBundleValue> bundleData;
+        bundleData.yresize(objectCount);
+        binSaver->AddRawData(0, bundleData.data(), (i64)objectCount*sizeof(TExclusiveFeaturesBundleValue));
+
+        srcDataElement = TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue>::CreateOwning(
+            std::move(bundleData)
+        );
+    }
+}
+
+
 void NCB::TQuantizedForCPUObjectsData::Load(
     const TArraySubsetIndexing<ui32>* subsetIndexing,
     TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
     IBinSaver* binSaver
 ) {
     PackedBinaryFeaturesData.Load(binSaver);
+    ExclusiveFeatureBundlesData.Load(binSaver);
     Data.QuantizedFeaturesInfo = quantizedFeaturesInfo;
     LoadFeatures<EFeatureType::Float>(
         *(quantizedFeaturesInfo->GetFeaturesLayout()),
         subsetIndexing,
         &PackedBinaryFeaturesData,
+        &ExclusiveFeatureBundlesData,
         binSaver,
         &Data.FloatFeatures
     );
@@ -1023,6 +1149,7 @@ void NCB::TQuantizedForCPUObjectsData::Load(
         *(quantizedFeaturesInfo->GetFeaturesLayout()),
         subsetIndexing,
         &PackedBinaryFeaturesData,
+        /*exclusiveFeatureBundlesData*/ Nothing(),
         binSaver,
         &Data.CatFeatures
     );
@@ -1045,9 +1172,10 @@ NCB::TQuantizedForCPUObjectsDataProvider::TQuantizedForCPUObjectsDataProvider(
       )
 {
     if (!skipCheck) {
-        Check(data.PackedBinaryFeaturesData);
+        Check(data.PackedBinaryFeaturesData, data.ExclusiveFeatureBundlesData);
     }
     PackedBinaryFeaturesData = std::move(data.PackedBinaryFeaturesData);
+    ExclusiveFeatureBundlesData = std::move(data.ExclusiveFeatureBundlesData);
 
     CatFeatureUniqueValuesCounts.yresize(Data.CatFeatures.size());
     for (auto catFeatureIdx : xrange(Data.CatFeatures.size())) {
@@ -1067,6 +1195,7 @@ NCB::TObjectsDataProviderPtr NCB::TQuantizedForCPUObjectsDataProvider::GetSubset
     TQuantizedForCPUObjectsData subsetData;
     subsetData.Data = Data.GetSubset(subsetCommonData.SubsetIndexing.Get());
     subsetData.PackedBinaryFeaturesData = PackedBinaryFeaturesData;
+    subsetData.ExclusiveFeatureBundlesData = ExclusiveFeatureBundlesData;
 
     return MakeIntrusive<TQuantizedForCPUObjectsDataProvider>(
         objectsGroupingSubset.GetSubsetGrouping(),
@@ -1086,6 +1215,8 @@ static void MakeConsecutiveArrayFeatures(
     const TVector<THolder<IColumnType>>& src,
     const TVector<TMaybe<TPackedBinaryIndex>>& featureToPackedBinaryIndex,
     const TVector<TMaybeOwningArrayHolder<TBinaryFeaturesPack>>& newPackedBinaryFeatures,
+    TConstArrayRef<TMaybe<TExclusiveBundleIndex>> featureToBundlePart, // can be empty
+    const TVector<TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue>>& newExclusiveFeatureBundles,
     NPar::TLocalExecutor* localExecutor,
     TVector<THolder<IColumnType>>* dst
 ) {
@@ -1113,28 +1244,42 @@ static void MakeConsecutiveArrayFeatures(
                     maybePackedBinaryIndex->BitIdx,
                     newSubsetIndexing
                 );
+            } else if (!featureToBundlePart.empty() && featureToBundlePart[*featureIdx]) {
+                (*dst)[*featureIdx] = MakeHolder<TBundlePartValuesHolderImpl<IColumnType>>(
+                    srcColumn.GetId(),
+                    newExclusiveFeatureBundles[featureToBundlePart[*featureIdx]->BundleIdx],
+                    dynamic_cast<const TBundlePartValuesHolderImpl<IColumnType>&>(srcColumn).GetBoundsInBundle(),
+                    newSubsetIndexing
+                );
             } else {
                 tasks.emplace_back(
                     [&, featureIdx]() {
                         const auto& srcCompressedValuesHolder
                             = dynamic_cast<const TCompressedValuesHolderImpl<IColumnType>&>(srcColumn);
+                        const ui32 srcBitsPerKey = srcCompressedValuesHolder.GetBitsPerKey();
 
                         TVector<ui64> storage;
-                        storage.yresize(dstStorageSize);
-                        auto dstBuffer = (typename IColumnType::TValueType*)(storage.data());
-
-                        srcCompressedValuesHolder.GetArrayData().ParallelForEach(
-                            [&] (ui32 idx, typename IColumnType::TValueType value) {
-                                dstBuffer[idx] = value;
-                            },
-                            localExecutor
-                        );
+                        if (srcBitsPerKey != bitsPerKey) {
+                            // bit-packed low-cardinality features, can't be filled in parallel in place
+                            const auto values = srcCompressedValuesHolder.ExtractValues(localExecutor);
+                            storage = CompressVector<ui64>((*values).data(), objectCount, srcBitsPerKey);
+                        } else {
+                            storage.yresize(dstStorageSize);
+                            auto dstBuffer = (typename IColumnType::TValueType*)(storage.data());
+
+                            srcCompressedValuesHolder.GetArrayData().ParallelForEach(
+                                [&] (ui32 idx, typename IColumnType::TValueType value) {
+                                    dstBuffer[idx] = value;
+                                },
+                                localExecutor
+                            );
+                        }
 
                         (*dst)[*featureIdx] = MakeHolder<TCompressedValuesHolderImpl<IColumnType>>(
                             srcColumn.GetId(),
                             TCompressedArray(
                                 objectCount,
-                                bitsPerKey,
+                                srcBitsPerKey,
                                 TMaybeOwningArrayHolder<ui64>::CreateOwning(std::move(storage))
                             ),
                             newSubsetIndexing
@@ -1148,25 +1293,25 @@ static void MakeConsecutiveArrayFeatures(
     ExecuteTasksInParallel(&tasks, localExecutor);
 }
 
-static void MakeConsecutivePackedBinaryFeatures(
+// for shared data of several features: binary features packs or exclusive features bundles
+template <class T>
+static void MakeConsecutiveMultiFeaturesData(
     const NCB::TFeaturesArraySubsetIndexing& subsetIndexing,
     NPar::TLocalExecutor* localExecutor,
-    TVector<TMaybeOwningArrayHolder<TBinaryFeaturesPack>>* packedBinaryFeatures
+    TVector<TMaybeOwningArrayHolder<T>>* multiFeaturesData
 ) {
     TVector<std::function<void()>> tasks;
 
-    for (auto i : xrange(packedBinaryFeatures->size())) {
+    for (auto i : xrange(multiFeaturesData->size())) {
         tasks.emplace_back(
             [&, i] () {
-                auto& packedBinaryFeaturesPart = (*packedBinaryFeatures)[i];
-                TVector<TBinaryFeaturesPack> consecutiveData = NCB::GetSubset<TBinaryFeaturesPack>(
-                    *packedBinaryFeaturesPart,
+                auto& multiFeaturesDataPart = (*multiFeaturesData)[i];
+                TVector<T> consecutiveData = NCB::GetSubset<T>(
+                    *multiFeaturesDataPart,
                     subsetIndexing,
                     localExecutor
                 );
-                packedBinaryFeaturesPart = TMaybeOwningArrayHolder<TBinaryFeaturesPack>::CreateOwning(
-                    std::move(consecutiveData)
-                );
+                multiFeaturesDataPart = TMaybeOwningArrayHolder<T>::CreateOwning(std::move(consecutiveData));
             }
         );
     }
@@ -1186,11 +1331,16 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
         TFullSubset<ui32>(GetObjectCount())
     );
 
-    MakeConsecutivePackedBinaryFeatures(
+    MakeConsecutiveMultiFeaturesData(
         GetFeaturesArraySubsetIndexing(),
         localExecutor,
         &PackedBinaryFeaturesData.SrcData
     );
+    MakeConsecutiveMultiFeaturesData(
+        GetFeaturesArraySubsetIndexing(),
+        localExecutor,
+        &ExclusiveFeatureBundlesData.SrcData
+    );
 
     TVector<std::function<void()>> tasks;
 
@@ -1203,6 +1353,8 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
                 Data.FloatFeatures,
                 PackedBinaryFeaturesData.FloatFeatureToPackedBinaryIndex,
                 PackedBinaryFeaturesData.SrcData,
+                ExclusiveFeatureBundlesData.FloatFeatureToBundlePart,
+                ExclusiveFeatureBundlesData.SrcData,
                 localExecutor,
                 &Data.FloatFeatures
             );
@@ -1217,6 +1369,8 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
                 Data.CatFeatures,
                 PackedBinaryFeaturesData.CatFeatureToPackedBinaryIndex,
                 PackedBinaryFeaturesData.SrcData,
+                /*featureToBundlePart*/ TConstArrayRef<TMaybe<TExclusiveBundleIndex>>(),
+                ExclusiveFeatureBundlesData.SrcData,
                 localExecutor,
                 &Data.CatFeatures
             );
@@ -1236,6 +1390,8 @@ static void CheckFeaturesByType(
     const TVector<THolder<TBaseFeatureColumn>>& data,
     const TVector<TMaybe<TPackedBinaryIndex>>& featureToPackedBinaryIndex,
     const TVector<std::pair<EFeatureType, ui32>>& packedBinaryToSrcIndex,
+    TConstArrayRef<TMaybe<TExclusiveBundleIndex>> featureToBundlePart, // can be empty
+    TConstArrayRef<TExclusiveFeaturesBundle> bundlesMetaData,
     const TStringBuf featureTypeName
 ) {
     CB_ENSURE_INTERNAL(
@@ -1243,6 +1399,11 @@ static void CheckFeaturesByType(
         "Data." << featureTypeName << "Features.size() is not equal to PackedBinaryFeaturesData."
         << featureTypeName << "FeatureToPackedBinaryIndex.size()"
     );
+    CB_ENSURE_INTERNAL(
+        featureToBundlePart.empty() || (data.size() == featureToBundlePart.size()),
+        "Data." << featureTypeName << "Features.size() is not equal to ExclusiveFeatureBundlesData."
+        << featureTypeName << "FeatureToBundlePart.size()"
+    );
 
     for (auto featureIdx : xrange(data.size())) {
         auto* dataPtr = data[featureIdx].Get();
@@ -1275,6 +1436,37 @@ static void CheckFeaturesByType(
                 "packedBinaryToSrcIndex[" << linearPackedBinaryFeatureIdx << "] feature index is not "
                 << featureIdx
             );
+        } else if (!featureToBundlePart.empty() && featureToBundlePart[featureIdx]) {
+            auto requiredTypePtr = dynamic_cast<TBundlePartValuesHolderImpl<TBaseFeatureColumn>*>(dataPtr);
+            CB_ENSURE_INTERNAL(
+                requiredTypePtr,
+                "Data." << featureType << "Features[" << featureIdx << "] is not of type TQuantized"
+                << featureTypeName << "BundlePartValuesHolder"
+            );
+
+            const auto bundleIndex = *featureToBundlePart[featureIdx];
+            CB_ENSURE_INTERNAL(
+                bundleIndex.BundleIdx < bundlesMetaData.size(),
+                "bundleIdx (" << bundleIndex.BundleIdx << ") is greater than bundles count ("
+                << bundlesMetaData.size() << ')'
+            );
+            const auto& bundleParts = bundlesMetaData[bundleIndex.BundleIdx].Parts;
+            CB_ENSURE_INTERNAL(
+                bundleIndex.InBundleIdx < bundleParts.size(),
+                "inBundleIdx (" << bundleIndex.InBundleIdx << ") is greater than bundle #"
+                << bundleIndex.BundleIdx << " parts count (" << bundleParts.size() << ')'
+            );
+            const auto& bundlePart = bundleParts[bundleIndex.InBundleIdx];
+            CB_ENSURE_INTERNAL(
+                bundlePart.FloatFeatureIdx == featureIdx,
+                "bundle #" << bundleIndex.BundleIdx << " part #" << bundleIndex.InBundleIdx
+                << " feature index is not " << featureIdx
+            );
+            CB_ENSURE_INTERNAL(
+                bundlePart.Bounds == requiredTypePtr->GetBoundsInBundle(),
+                "Data." << featureType << "Features[" << featureIdx << "] bounds in bundle are not equal to"
+                " bundle #" << bundleIndex.BundleIdx << " part #" << bundleIndex.InBundleIdx << " bounds"
+            );
         } else {
             auto requiredTypePtr = dynamic_cast<TCompressedValuesHolderImpl<TBaseFeatureColumn>*>(dataPtr);
             CB_ENSURE_INTERNAL(
@@ -1282,19 +1474,39 @@ static void CheckFeaturesByType(
                 "Data." << featureType << "Features[" << featureIdx << "] is not of type TQuantized"
                 << featureTypeName << "ValuesHolder"
             );
-            requiredTypePtr->GetCompressedData().GetSrc()
-                ->template CheckIfCanBeInterpretedAsRawArray<typename TBaseFeatureColumn::TValueType>();
+            const TCompressedArray& compressedArray = *requiredTypePtr->GetCompressedData().GetSrc();
+            if ((featureType == EFeatureType::Float) && (compressedArray.GetBitsPerKey() < CHAR_BIT)) {
+                // bit-packed low-cardinality feature
+                CB_ENSURE_INTERNAL(
+                    (compressedArray.GetBitsPerKey() == 2) || (compressedArray.GetBitsPerKey() == 4),
+                    "Data." << featureType << "Features[" << featureIdx << "] has unsupported bits per key ("
+                    << compressedArray.GetBitsPerKey() << ')'
+                );
+            } else {
+                compressedArray.template CheckIfCanBeInterpretedAsRawArray<
+                    typename TBaseFeatureColumn::TValueType>();
+            }
         }
     }
 }
 
 
-void NCB::TQuantizedForCPUObjectsDataProvider::Check(const TPackedBinaryFeaturesData& packedBinaryData) const {
+void NCB::TQuantizedForCPUObjectsDataProvider::Check(
+    const TPackedBinaryFeaturesData& packedBinaryData,
+    const TExclusiveFeatureBundlesData& exclusiveFeatureBundlesData
+) const {
+    CB_ENSURE_INTERNAL(
+        exclusiveFeatureBundlesData.MetaData.size() == exclusiveFeatureBundlesData.SrcData.size(),
+        "ExclusiveFeatureBundlesData: MetaData.size() is not equal to SrcData.size()"
+    );
+
     CheckFeaturesByType(
         EFeatureType::Float,
         Data.FloatFeatures,
         packedBinaryData.FloatFeatureToPackedBinaryIndex,
         packedBinaryData.PackedBinaryToSrcIndex,
+        exclusiveFeatureBundlesData.FloatFeatureToBundlePart,
+        exclusiveFeatureBundlesData.MetaData,
         "Float"
     );
     CheckFeaturesByType(
@@ -1302,6 +1514,8 @@ void NCB::TQuantizedForCPUObjectsDataProvider::Check(const TPackedBinaryFeatures
         Data.CatFeatures,
         packedBinaryData.CatFeatureToPackedBinaryIndex,
         packedBinaryData.PackedBinaryToSrcIndex,
+        /*featureToBundlePart*/ TConstArrayRef<TMaybe<TExclusiveBundleIndex>>(),
+        exclusiveFeatureBundlesData.MetaData,
         "Cat"
     );
 }
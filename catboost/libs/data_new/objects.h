@@ -381,6 +381,14 @@ namespace NCB {
 
         ui32 CalcFeaturesCheckSum(NPar::TLocalExecutor* localExecutor) const;
 
+        /* checksum of quantized feature values only,
+         * unlike CalcFeaturesCheckSum it does not change if objects with new categorical values are added
+         */
+        ui32 CalcFeatureValuesCheckSum(NPar::TLocalExecutor* localExecutor) const;
+
+        // CalcFeatureValuesCheckSum of the first objectCount objects without making a subset
+        ui32 CalcFeatureValuesPrefixCheckSum(ui32 objectCount, NPar::TLocalExecutor* localExecutor) const;
+
     protected:
         friend class TObjectsSerialization;
 
@@ -424,9 +432,36 @@ namespace NCB {
         = TArraySubset<const TMaybeOwningArrayHolder<TBinaryFeaturesPack>, ui32>;
 
 
+    // see exclusive_feature_bundling.h
+    struct TExclusiveFeatureBundlesData {
+        // lookups, empty if there are no bundles
+        TVector<TMaybe<TExclusiveBundleIndex>> FloatFeatureToBundlePart; // [floatFeatureIdx]
+        TVector<TExclusiveFeaturesBundle> MetaData; // [bundleIdx]
+
+        // shared source data, apply SubsetIndexing
+        TVector<TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue>> SrcData; // [bundleIdx][objectIdx]
+
+    public:
+        TExclusiveFeatureBundlesData() = default;
+
+        // does not init data in SrcData elements, it has to be filled later if necessary
+        TExclusiveFeatureBundlesData(
+            const TFeaturesLayout& featuresLayout,
+            TVector<TExclusiveFeaturesBundle>&& metaData
+        );
+
+        void Save(const TArraySubsetIndexing<ui32>& subsetIndexing, IBinSaver* binSaver) const;
+        void Load(IBinSaver* binSaver);
+    };
+
+    using TExclusiveFeaturesBundleArraySubset
+        = TArraySubset<const TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue>, ui32>;
+
+
     struct TQuantizedForCPUObjectsData {
         TQuantizedObjectsData Data;
         TPackedBinaryFeaturesData PackedBinaryFeaturesData;
+        TExclusiveFeatureBundlesData ExclusiveFeatureBundlesData;
 
     public:
         void Load(
@@ -475,6 +510,11 @@ namespace NCB {
                 "Called TQuantizedForCPUObjectsDataProvider::GetFloatFeature for binary packed float feature #"
                 << floatFeatureIdx
             );
+            CB_ENSURE_INTERNAL(
+                !GetFloatFeatureToExclusiveBundleIndex(TFloatFeatureIdx(floatFeatureIdx)),
+                "Called TQuantizedForCPUObjectsDataProvider::GetFloatFeature for bundled float feature #"
+                << floatFeatureIdx
+            );
             return MakeMaybeData(
                 // checked above that this cast is safe
                 static_cast<const TQuantizedFloatValuesHolder*>(
@@ -483,11 +523,37 @@ namespace NCB {
             );
         }
 
+        // 8 or, for bit-packed low-cardinality features, 2 or 4
+        ui32 GetFloatFeatureBitsPerKey(ui32 floatFeatureIdx) const {
+            return (*GetNonPackedFloatFeature(floatFeatureIdx))->GetBitsPerKey();
+        }
+
         // low-level function, data is without subset indexing, apply external subset indexing!
+        // only for features stored with 8 bits per key
         const ui8* GetFloatFeatureRawSrcData(ui32 floatFeatureIdx) const {
             return *((*GetNonPackedFloatFeature(floatFeatureIdx))->GetArrayData().GetSrc());
         }
 
+        /* low-level function, data is without subset indexing, apply external subset indexing!
+         * f is called with an accessor to values stored with any bits per key, see DispatchQuantizedValuesRef,
+         * or to a part of an exclusive features bundle (TBundlePartValuesRef)
+         */
+        template <class TFunc>
+        void VisitFloatFeatureRawSrcData(ui32 floatFeatureIdx, TFunc&& f) const {
+            if (auto maybeBundleIndex = GetFloatFeatureToExclusiveBundleIndex(TFloatFeatureIdx(floatFeatureIdx))) {
+                f(
+                    TBundlePartValuesRef(
+                        (**GetExclusiveFeaturesBundle(maybeBundleIndex->BundleIdx).GetSrc()).data(),
+                        ExclusiveFeatureBundlesData.MetaData[maybeBundleIndex->BundleIdx]
+                            .Parts[maybeBundleIndex->InBundleIdx].Bounds
+                    )
+                );
+                return;
+            }
+            const auto* floatFeature = *GetNonPackedFloatFeature(floatFeatureIdx);
+            DispatchQuantizedValuesRef(floatFeature->GetRawSrcData(), floatFeature->GetBitsPerKey(), f);
+        }
+
         TMaybeData<const TQuantizedCatValuesHolder*> GetNonPackedCatFeature(ui32 catFeatureIdx) const {
             CB_ENSURE_INTERNAL(
                 !PackedBinaryFeaturesData.CatFeatureToPackedBinaryIndex[catFeatureIdx],
@@ -555,20 +621,50 @@ namespace NCB {
             return PackedBinaryFeaturesData.PackedBinaryToSrcIndex[packedBinaryIndex.GetLinearIdx()];
         }
 
+
+        size_t GetExclusiveFeatureBundlesSize() const {
+            return ExclusiveFeatureBundlesData.MetaData.size();
+        }
+
+        TConstArrayRef<TExclusiveFeaturesBundle> GetExclusiveFeatureBundlesMetaData() const {
+            return ExclusiveFeatureBundlesData.MetaData;
+        }
+
+        TExclusiveFeaturesBundleArraySubset GetExclusiveFeaturesBundle(ui32 bundleIdx) const {
+            return TExclusiveFeaturesBundleArraySubset(
+                &ExclusiveFeatureBundlesData.SrcData[bundleIdx],
+                CommonData.SubsetIndexing.Get()
+            );
+        }
+
+        TMaybe<TExclusiveBundleIndex> GetFloatFeatureToExclusiveBundleIndex(
+            TFloatFeatureIdx floatFeatureIdx
+        ) const {
+            if (ExclusiveFeatureBundlesData.FloatFeatureToBundlePart.empty()) {
+                return Nothing();
+            }
+            return ExclusiveFeatureBundlesData.FloatFeatureToBundlePart[*floatFeatureIdx];
+        }
+
     protected:
         friend class TObjectsSerialization;
 
     protected:
         void SaveDataNonSharedPart(IBinSaver* binSaver) const {
             PackedBinaryFeaturesData.Save(*CommonData.SubsetIndexing, binSaver);
+            ExclusiveFeatureBundlesData.Save(*CommonData.SubsetIndexing, binSaver);
             Data.SaveNonSharedPart(binSaver);
         }
 
     private:
-        void Check(const TPackedBinaryFeaturesData& packedBinaryData) const;
+        void Check(
+            const TPackedBinaryFeaturesData& packedBinaryData,
+            const TExclusiveFeatureBundlesData& exclusiveFeatureBundlesData
+        ) const;
 
     private:
         TPackedBinaryFeaturesData PackedBinaryFeaturesData;
+        TExclusiveFeatureBundlesData ExclusiveFeatureBundlesData;
 
         // store directly instead of looking up in Data.QuantizedFeaturesInfo for runtime efficiency
         TVector<TCatFeatureUniqueValuesCounts> CatFeatureUniqueValuesCounts; // [catFeatureIdx]
@@ -263,6 +263,70 @@ TObjectsGroupingSubset NCB::Shuffle(
 }
 
 
+TObjectsGroupingSubset NCB::ExtendPermutation(
+    TObjectsGroupingPtr objectsGrouping,
+    TConstArrayRef<ui32> objectsPermutationPrefix
+) {
+    const ui32 objectCount = objectsGrouping->GetObjectCount();
+    const ui32 prefixSize = SafeIntegerCast<ui32>(objectsPermutationPrefix.size());
+    CB_ENSURE_INTERNAL(prefixSize <= objectCount, "Permutation prefix is longer than object count");
+
+    TIndexedSubset<ui32> indices;
+    indices.yresize(objectCount);
+    Copy(objectsPermutationPrefix.begin(), objectsPermutationPrefix.end(), indices.begin());
+    std::iota(indices.begin() + prefixSize, indices.end(), prefixSize);
+
+    if (objectsGrouping->IsTrivial()) {
+        return TObjectsGroupingSubset(
+            objectsGrouping,
+            TArraySubsetIndexing<ui32>(std::move(indices)),
+            EObjectsOrder::RandomShuffled
+        );
+    }
+
+    const TConstArrayRef<TGroupBounds> srcGroupsBounds = objectsGrouping->GetNonTrivialGroups();
+
+    TIndexedSubset<ui32> groupPermute;
+    groupPermute.reserve(objectsGrouping->GetGroupCount());
+    TVector<TGroupBounds> dstGroupBounds;
+    dstGroupBounds.reserve(objectsGrouping->GetGroupCount());
+
+    // objects of each group are consecutive in the prefix
+    ui32 idxInResult = 0;
+    while (idxInResult < prefixSize) {
+        const ui32 groupIdx = objectsGrouping->GetGroupIdxForObject(indices[idxInResult]);
+        const ui32 size = srcGroupsBounds[groupIdx].GetSize();
+        CB_ENSURE_INTERNAL(idxInResult + size <= prefixSize, "Permutation prefix ends in the middle of a group");
+        groupPermute.push_back(groupIdx);
+        dstGroupBounds.push_back(TGroupBounds(idxInResult, idxInResult + size));
+        idxInResult += size;
+    }
+    if (prefixSize < objectCount) {
+        const ui32 appendedGroupsBegin = objectsGrouping->GetGroupIdxForObject(prefixSize);
+        CB_ENSURE_INTERNAL(
+            srcGroupsBounds[appendedGroupsBegin].Begin == prefixSize,
+            "Permutation prefix ends in the middle of a group"
+        );
+        for (auto groupIdx : xrange(appendedGroupsBegin, objectsGrouping->GetGroupCount())) {
+            groupPermute.push_back(groupIdx);
+            dstGroupBounds.push_back(srcGroupsBounds[groupIdx]);
+        }
+    }
+    CB_ENSURE_INTERNAL(
+        groupPermute.size() == objectsGrouping->GetGroupCount(),
+        "Permutation prefix is not a permutation of the first groups"
+    );
+
+    return TObjectsGroupingSubset(
+        MakeIntrusive<TObjectsGrouping>(std::move(dstGroupBounds), true),
+        TArraySubsetIndexing<ui32>(std::move(groupPermute)),
+        EObjectsOrder::RandomShuffled,
+        MakeMaybe<TArraySubsetIndexing<ui32>>(std::move(indices)),
+        EObjectsOrder::RandomShuffled
+    );
+}
+
+
 TVector<TArraySubsetIndexing<ui32>> NCB::Split(
     const TObjectsGrouping& objectsGrouping,
     ui32 partCount,
@@ -226,6 +226,14 @@ namespace NCB {
         TRestorableFastRng64* rand
     );
 
+    /* permutation of all objects that starts with objectsPermutationPrefix (a permutation of some first groups,
+     * like the one returned by Shuffle for them), the rest of groups follow in their original order
+     */
+    TObjectsGroupingSubset ExtendPermutation(
+        TObjectsGroupingPtr objectsGrouping,
+        TConstArrayRef<ui32> objectsPermutationPrefix
+    );
+
     // returns groups (possibly trivial groups) subsets
     TVector<TArraySubsetIndexing<ui32>> Split(
         const TObjectsGrouping& objectsGrouping,
@@ -13,7 +13,9 @@
 #include <catboost/libs/quantization/utils.h>
 #include <catboost/libs/quantization_schema/quantize.h>
 
+#include <library/chromium_trace/interface.h>
 #include <library/grid_creator/binarization.h>
+#include <library/grid_creator/quantile_sketch.h>
 
 #include <util/generic/cast.h>
 #include <util/generic/maybe.h>
@@ -31,6 +33,19 @@
 
 
 namespace NCB {
+    // approximate number of objects added to one quantile sketch before merging
+    constexpr ui32 QUANTILE_SKETCH_BLOCK_SIZE = 1 << 16;
+
+
+    static bool UseQuantileSketchForBuildBorders(
+        const TQuantizationOptions& options,
+        EBorderSelectionType borderSelectionType
+    ) {
+        return options.QuantileSketchKForBuildBorders &&
+            ((borderSelectionType == EBorderSelectionType::Median) ||
+             (borderSelectionType == EBorderSelectionType::GreedyLogSum));
+    }
+
     static bool NeedToCalcBorders(const TQuantizedFeaturesInfo& quantizedFeaturesInfo) {
         bool needToCalcBorders = false;
         quantizedFeaturesInfo.GetFeaturesLayout()->IterateOverAvailableFeatures<EFeatureType::Float>(
@@ -92,7 +107,8 @@ namespace NCB {
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
         const TQuantizationOptions& options,
         bool doQuantization, // if false - only calc borders
-        bool clearSrcData
+        bool clearSrcData,
+        int threadCount
     ) {
         ui64 result = 0;
 
@@ -100,11 +116,25 @@ namespace NCB {
             auto borderSelectionType =
                 quantizedFeaturesInfo.GetFloatFeatureBinarization().BorderSelectionType;
 
-            const ui32 sampleSize = GetSampleSizeForBorderSelectionType(
-                objectCount,
-                borderSelectionType,
-                options.MaxSubsetSizeForSlowBuildBordersAlgorithms
-            );
+            ui32 sampleSize;
+            if (UseQuantileSketchForBuildBorders(options, borderSelectionType)) {
+                // sketches for blocks processed in parallel and the merged sketch
+                result += (threadCount + 2) * NSplitSelection::TQuantileSketch::CalcMaxMemoryUsage(
+                    options.QuantileSketchKForBuildBorders
+                );
+                sampleSize = Min<ui32>(
+                    objectCount,
+                    NSplitSelection::TQuantileSketch::CalcMaxStoredValuesCount(
+                        options.QuantileSketchKForBuildBorders
+                    )
+                );
+            } else {
+                sampleSize = GetSampleSizeForBorderSelectionType(
+                    objectCount,
+                    borderSelectionType,
+                    options.MaxSubsetSizeForSlowBuildBordersAlgorithms
+                );
+            }
 
             result += sizeof(float) * sampleSize; // for copying to srcFeatureValuesForBuildBorders
 
@@ -116,19 +146,87 @@ namespace NCB {
         }
 
         if (doQuantization && (options.CpuCompatibleFormat || clearSrcData)) {
-            // for storing quantized data
-            // TODO(akhropov): support other bitsPerKey. MLTOOLS-2425
+            // for storing quantized data, low-cardinality features are bit-packed after quantization
             result += sizeof(ui8) * objectCount;
+            if (options.PackLowCardinalityFeaturesForCpu) {
+                result += sizeof(ui8) * objectCount / 2;
+            }
         }
 
         return result;
     }
 
 
+    /* Sketches are built for blocks of QUANTILE_SKETCH_BLOCK_SIZE objects in parallel and merged in blocks order,
+     * so the result does not depend on the number of threads
+     */
+    static TVector<float> GetSortedSampleFromQuantileSketch(
+        const TMaybeOwningConstArraySubset<float, ui32>& srcData,
+        ui32 quantileSketchK,
+        NPar::TLocalExecutor* localExecutor,
+        bool* hasNans
+    ) {
+        TConstArrayRef<float> srcRawData = **srcData.GetSrc();
+        const TFeaturesArraySubsetIndexing& subsetIndexing = *srcData.GetSubsetIndexing();
+
+        const auto parallelUnitRanges = subsetIndexing.GetParallelUnitRanges(QUANTILE_SKETCH_BLOCK_SIZE);
+        const int blockCount = SafeIntegerCast<int>(parallelUnitRanges.RangesCount());
+
+        // limit the number of simultaneously existing sketches
+        const int blocksPerStep = localExecutor->GetThreadCount() + 1;
+
+        NSplitSelection::TQuantileSketch sketch(quantileSketchK);
+        *hasNans = false;
+
+        for (int stepBegin = 0; stepBegin < blockCount; stepBegin += blocksPerStep) {
+            const int stepEnd = Min(stepBegin + blocksPerStep, blockCount);
+
+            TVector<NSplitSelection::TQuantileSketch> blockSketches(
+                stepEnd - stepBegin,
+                NSplitSelection::TQuantileSketch(quantileSketchK)
+            );
+            TVector<ui8> blockHasNans(stepEnd - stepBegin, 0); // not TVector<bool> for parallel writes
+
+            localExecutor->ExecRangeWithThrow(
+                [&] (int blockIdx) {
+                    CHROMIUM_TRACE_SCOPE("Build quantile sketch for block");
+
+                    auto& blockSketch = blockSketches[blockIdx - stepBegin];
+                    bool blockHasNan = false;
+                    subsetIndexing.ForEachInSubRange(
+                        parallelUnitRanges.GetRange(blockIdx),
+                        [&] (ui32 /*idx*/, ui32 srcIdx) {
+                            const float value = srcRawData[srcIdx];
+                            if (IsNan(value)) {
+                                blockHasNan = true;
+                            } else {
+                                blockSketch.Add(value);
+                            }
+                        }
+                    );
+                    blockHasNans[blockIdx - stepBegin] = blockHasNan;
+                },
+                stepBegin,
+                stepEnd,
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+
+            for (auto i : xrange(blockSketches.size())) {
+                sketch.Merge(blockSketches[i]);
+                *hasNans = *hasNans || blockHasNans[i];
+            }
+        }
+
+        return sketch.GetSortedSample();
+    }
+
+
     static void CalcBordersAndNanMode(
         const TFloatValuesHolder& srcFeature,
         const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+        const TQuantizationOptions& options,
+        NPar::TLocalExecutor* localExecutor,
         ENanMode* nanMode,
         TVector<float>* borders
     ) {
@@ -145,19 +243,31 @@ namespace NCB {
 
         // does not contain nans
         TVector<float> srcFeatureValuesForBuildBorders;
-        srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+        bool srcFeatureValuesAreSorted = false;
 
         bool hasNans = false;
 
-        srcDataForBuildBorders.ForEach(
-            [&] (ui32 /*idx*/, float value) {
-                if (IsNan(value)) {
-                    hasNans = true;
-                } else {
-                    srcFeatureValuesForBuildBorders.push_back(value);
+        if (UseQuantileSketchForBuildBorders(options, binarizationOptions.BorderSelectionType)) {
+            srcFeatureValuesForBuildBorders = GetSortedSampleFromQuantileSketch(
+                srcDataForBuildBorders,
+                options.QuantileSketchKForBuildBorders,
+                localExecutor,
+                &hasNans
+            );
+            srcFeatureValuesAreSorted = true;
+        } else {
+            srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+
+            srcDataForBuildBorders.ForEach(
+                [&] (ui32 /*idx*/, float value) {
+                    if (IsNan(value)) {
+                        hasNans = true;
+                    } else {
+                        srcFeatureValuesForBuildBorders.push_back(value);
+                    }
                 }
-            }
-        );
+            );
+        }
 
         CB_ENSURE(
             (binarizationOptions.NanMode != ENanMode::Forbidden) ||
@@ -180,7 +290,9 @@ namespace NCB {
             borderSet = BestSplit(
                 srcFeatureValuesForBuildBorders,
                 nonNanValuesBorderCount,
-                binarizationOptions.BorderSelectionType
+                binarizationOptions.BorderSelectionType,
+                /*nanValueIsInfty*/ false,
+                srcFeatureValuesAreSorted
             );
 
             if (borderSet.contains(-0.0f)) { // BestSplit might add negative zeros
@@ -352,6 +464,85 @@ namespace NCB {
     }
 
 
+    static void BundleFeatures(
+        const TExclusiveFeaturesBundlingOptions& options,
+        const TFeaturesArraySubsetIndexing* quantizedDataSubsetIndexing,
+        NPar::TLocalExecutor* localExecutor,
+        TQuantizedForCPUObjectsData* quantizedObjectsData
+    ) {
+        const auto& quantizedFeaturesInfo = *quantizedObjectsData->Data.QuantizedFeaturesInfo;
+        auto& floatFeatures = quantizedObjectsData->Data.FloatFeatures;
+
+        auto& exclusiveFeatureBundlesData = quantizedObjectsData->ExclusiveFeatureBundlesData;
+        exclusiveFeatureBundlesData = TExclusiveFeatureBundlesData(
+            *quantizedFeaturesInfo.GetFeaturesLayout(),
+            CreateExclusiveFeatureBundles(
+                quantizedFeaturesInfo,
+                floatFeatures,
+                quantizedObjectsData->PackedBinaryFeaturesData.FloatFeatureToPackedBinaryIndex,
+                options,
+                localExecutor
+            )
+        );
+
+        const ui32 objectCount = quantizedDataSubsetIndexing->Size();
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int bundleIdx) {
+                const auto& bundle = exclusiveFeatureBundlesData.MetaData[bundleIdx];
+
+                TVector<TExclusiveFeaturesBundleValue> dstBundleData(objectCount, 0);
+                for (const auto& part : bundle.Parts) {
+                    const auto values = floatFeatures[part.FloatFeatureIdx]->ExtractValues(localExecutor);
+                    TConstArrayRef<ui8> valuesRef = *values;
+                    for (auto objectIdx : xrange(objectCount)) {
+                        if (valuesRef[objectIdx]) {
+                            Y_ASSERT(dstBundleData[objectIdx] == 0);
+                            dstBundleData[objectIdx]
+                                = TExclusiveFeaturesBundleValue(part.Bounds.Begin + valuesRef[objectIdx] - 1);
+                        }
+                    }
+                }
+
+                exclusiveFeatureBundlesData.SrcData[bundleIdx]
+                    = TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue>::CreateOwning(
+                        std::move(dstBundleData)
+                    );
+
+                for (const auto& part : bundle.Parts) {
+                    auto& floatFeature = floatFeatures[part.FloatFeatureIdx];
+                    floatFeature.Reset(
+                        new TQuantizedFloatBundlePartValuesHolder(
+                            floatFeature->GetId(),
+                            exclusiveFeatureBundlesData.SrcData[bundleIdx],
+                            part.Bounds,
+                            quantizedDataSubsetIndexing
+                        )
+                    );
+                }
+            },
+            0,
+            SafeIntegerCast<int>(exclusiveFeatureBundlesData.MetaData.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+
+    // quantized values are in [0, bordersCount]
+    static ui32 GetQuantizedFloatFeatureBitsPerKey(const TQuantizationOptions& options, size_t bordersCount) {
+        if (options.CpuCompatibleFormat && options.PackLowCardinalityFeaturesForCpu) {
+            if (bordersCount < 4) {
+                return 2;
+            }
+            if (bordersCount < 16) {
+                return 4;
+            }
+        }
+        // TODO(akhropov): support other bitsPerKey. MLTOOLS-2425
+        return 8;
+    }
+
+
     static void ProcessFloatFeature(
         TFloatFeatureIdx floatFeatureIdx,
         const TFloatValuesHolder& srcFeature,
@@ -364,6 +555,8 @@ namespace NCB {
         TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
         THolder<IQuantizedFloatValuesHolder>* dstQuantizedFeature // can be nullptr if generateBordersOnly
     ) {
+        CHROMIUM_TRACE_SCOPE("Quantize float feature");
+
         bool calculateNanMode = true;
         ENanMode nanMode = ENanMode::Forbidden;
 
@@ -397,6 +590,8 @@ namespace NCB {
                 srcFeature,
                 subsetForBuildBorders,
                 *quantizedFeaturesInfo,
+                options,
+                localExecutor,
                 &nanMode,
                 &calculatedBorders
             );
@@ -419,9 +614,10 @@ namespace NCB {
                 !options.PackBinaryFeaturesForCpu ||
                 (borders.size() > 1)) // binary features are binarized later by packs
             {
-                // TODO(akhropov): support other bitsPerKey. MLTOOLS-2425
-                const ui32 bitsPerKey = 8;
-                TIndexHelper<ui64> indexHelper(bitsPerKey);
+                const ui32 bitsPerKey = GetQuantizedFloatFeatureBitsPerKey(options, borders.size());
+
+                // quantize to ui8 values first, bit-pack them afterwards if bitsPerKey is smaller
+                TIndexHelper<ui64> indexHelper(CHAR_BIT);
                 TVector<ui64> quantizedDataStorage;
                 quantizedDataStorage.yresize(indexHelper.CompressedSize(srcFeatureData.Size()));
 
@@ -444,11 +640,19 @@ namespace NCB {
                     &quantizedData
                 );
 
+                if (bitsPerKey != indexHelper.GetBitsPerKey()) {
+                    quantizedDataStorage = CompressVector<ui64>(
+                        quantizedData.data(),
+                        SafeIntegerCast<ui32>(quantizedData.size()),
+                        bitsPerKey
+                    );
+                }
+
                 *dstQuantizedFeature = MakeHolder<TQuantizedFloatValuesHolder>(
                     srcFeature.GetId(),
                     TCompressedArray(
                         srcFeatureData.Size(),
-                        indexHelper.GetBitsPerKey(),
+                        bitsPerKey,
                         TMaybeOwningArrayHolder<ui64>::CreateOwning(std::move(quantizedDataStorage))
                     ),
                     dstSubsetIndexing
@@ -506,6 +710,8 @@ namespace NCB {
         TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
         THolder<IQuantizedCatValuesHolder>* dstQuantizedFeature
     ) {
+        CHROMIUM_TRACE_SCOPE("Quantize cat feature");
+
         TMaybeOwningConstArraySubset<ui32, ui32> srcFeatureData = srcFeature.GetArrayData();
 
         // TODO(akhropov): support other bitsPerKey. MLTOOLS-2425
@@ -605,6 +811,8 @@ namespace NCB {
             TRestorableFastRng64* rand,
             NPar::TLocalExecutor* localExecutor
         ) {
+            CHROMIUM_TRACE_SCOPE("Quantize");
+
             CB_ENSURE_INTERNAL(
                 options.CpuCompatibleFormat || options.GpuCompatibleFormat,
                 "TQuantizationOptions: at least one of CpuCompatibleFormat or GpuCompatibleFormat"
@@ -673,7 +881,8 @@ namespace NCB {
                     *quantizedFeaturesInfo,
                     options,
                     !calcBordersAndNanModeOnly,
-                    clearSrcObjectsData
+                    clearSrcObjectsData,
+                    localExecutor->GetThreadCount()
                 );
 
                 featuresLayout->IterateOverAvailableFeatures<EFeatureType::Float>(
@@ -785,6 +994,15 @@ namespace NCB {
                 );
             }
 
+            if (options.CpuCompatibleFormat && options.BundleExclusiveFeaturesForCpu) {
+                BundleFeatures(
+                    options.ExclusiveFeaturesBundlingOptions,
+                    subsetIndexing.Get(),
+                    localExecutor,
+                    &data->ObjectsData
+                );
+            }
+
             if (clearSrcData) {
                 data->MetaInfo = std::move(rawDataProvider->MetaInfo);
                 data->TargetData = std::move(rawDataProvider->RawTargetData.Data);
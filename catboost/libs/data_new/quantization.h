@@ -1,6 +1,7 @@
 #pragma once
 
 #include "data_provider.h"
+#include "exclusive_feature_bundling.h"
 #include "quantized_features_info.h"
 
 #include <catboost/libs/helpers/restorable_rng.h>
@@ -18,6 +19,19 @@ namespace NCB {
         ui64 CpuRamLimit = Max<ui64>();
         ui32 MaxSubsetSizeForSlowBuildBordersAlgorithms = 200000;
         bool PackBinaryFeaturesForCpu = true;
+
+        // store float features with less than 16 bins with 2 or 4 bits per value
+        bool PackLowCardinalityFeaturesForCpu = true;
+
+        // store sparse mutually exclusive float features in shared bundles, see exclusive_feature_bundling.h
+        bool BundleExclusiveFeaturesForCpu = false;
+        TExclusiveFeaturesBundlingOptions ExclusiveFeaturesBundlingOptions;
+
+        /* if > 0 borders for Median and GreedyLogSum border selection types are built from mergeable quantile
+         * sketches with this K over all objects instead of copying and sorting all feature values,
+         * see library/grid_creator/quantile_sketch.h
+         */
+        ui32 QuantileSketchKForBuildBorders = 0;
         bool AllowWriteFiles = true;
 
         // TODO(akhropov): remove after checking global tests consistency
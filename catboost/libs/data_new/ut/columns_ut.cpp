@@ -73,6 +73,55 @@ Y_UNIT_TEST_SUITE(Columns) {
     }
 
 
+    Y_UNIT_TEST(TQuantizedFloatValuesHolderWithPackedValues) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(2);
+
+        for (ui32 bitsPerKey : {2, 4}) {
+            TVector<ui8> src;
+            for (auto i : xrange(70)) {
+                src.push_back((i * 7 + i / 3) % (1 << bitsPerKey));
+            }
+
+            TCompressedArray data(
+                src.size(),
+                bitsPerKey,
+                NCB::TMaybeOwningArrayHolder<ui64>::CreateOwning(CompressVector<ui64>(src, bitsPerKey))
+            );
+
+            TFeaturesArraySubsetIndexing subsetIndexing( TIndexedSubset<ui32>{69, 6, 5, 2, 0, 33, 12} );
+
+            TQuantizedFloatValuesHolder quantizedFloatValuesHolder(3, data, &subsetIndexing);
+            UNIT_ASSERT_VALUES_EQUAL(quantizedFloatValuesHolder.GetBitsPerKey(), bitsPerKey);
+
+            TVector<ui8> expectedSubset;
+            subsetIndexing.ForEach([&] (ui32 /*idx*/, ui32 srcIdx) { expectedSubset.push_back(src[srcIdx]); });
+
+            auto values = quantizedFloatValuesHolder.ExtractValues(&localExecutor);
+            UNIT_ASSERT(Equal<ui8>(*values, expectedSubset));
+
+            TVector<ui8> readValues;
+            DispatchQuantizedValuesRef(
+                quantizedFloatValuesHolder.GetRawSrcData(),
+                quantizedFloatValuesHolder.GetBitsPerKey(),
+                [&] (auto srcData) {
+                    for (auto i : xrange(src.size())) {
+                        readValues.push_back(srcData[i]);
+                    }
+                }
+            );
+            UNIT_ASSERT(Equal<ui8>(readValues, src));
+
+            for (auto i : xrange(src.size())) {
+                UNIT_ASSERT_VALUES_EQUAL(
+                    GetQuantizedValue(quantizedFloatValuesHolder.GetRawSrcData(), bitsPerKey, i),
+                    src[i]
+                );
+            }
+        }
+    }
+
+
     Y_UNIT_TEST(TQuantizedFloatPackedBinaryValuesHolder) {
         TVector<NCB::TBinaryFeaturesPack> src = {
             0b00010001, // 0
@@ -111,4 +160,22 @@ Y_UNIT_TEST_SUITE(Columns) {
             UNIT_ASSERT(Equal<ui8>(*values, expectedFeatureValues[bitIdx]));
         }
     }
+
+    Y_UNIT_TEST(TQuantizedFloatBundlePartValuesHolder) {
+        // parts: [1, 3) and [3, 4)
+        TVector<TExclusiveFeaturesBundleValue> src = {0, 1, 3, 2, 0, 3, 1, 0};
+
+        auto storage = NCB::TMaybeOwningArrayHolder<TExclusiveFeaturesBundleValue>::CreateOwning(std::move(src));
+
+        TFeaturesArraySubsetIndexing subsetIndexing( TIndexedSubset<ui32>{6, 5, 0, 2, 3} );
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(2);
+
+        TQuantizedFloatBundlePartValuesHolder part0Holder(0, storage, TBoundsInBundle(1, 3), &subsetIndexing);
+        UNIT_ASSERT(Equal<ui8>(*part0Holder.ExtractValues(&localExecutor), TVector<ui8>{1, 0, 0, 0, 2}));
+
+        TQuantizedFloatBundlePartValuesHolder part1Holder(1, storage, TBoundsInBundle(3, 4), &subsetIndexing);
+        UNIT_ASSERT(Equal<ui8>(*part1Holder.ExtractValues(&localExecutor), TVector<ui8>{0, 1, 0, 1, 0}));
+    }
 }
@@ -0,0 +1,103 @@
+#include <catboost/libs/data_new/exclusive_feature_bundling.h>
+
+#include <catboost/libs/data_new/columns.h>
+#include <catboost/libs/data_new/quantized_features_info.h>
+#include <catboost/libs/helpers/compression.h>
+
+#include <util/generic/xrange.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(ExclusiveFeatureBundling) {
+    Y_UNIT_TEST(TExclusiveFeaturesBundle) {
+        TExclusiveFeaturesBundle bundle;
+        UNIT_ASSERT_VALUES_EQUAL(bundle.GetBinCount(), 1);
+
+        bundle.Add(/*floatFeatureIdx*/ 3, /*binCount*/ 4);
+        bundle.Add(/*floatFeatureIdx*/ 1, /*binCount*/ 2);
+
+        UNIT_ASSERT_VALUES_EQUAL(bundle.GetBinCount(), 5);
+        UNIT_ASSERT_EQUAL(bundle.Parts[0], TExclusiveBundlePart(3, TBoundsInBundle(1, 4)));
+        UNIT_ASSERT_EQUAL(bundle.Parts[1], TExclusiveBundlePart(1, TBoundsInBundle(4, 5)));
+
+        const TVector<TExclusiveFeaturesBundleValue> bundleValues = {0, 1, 2, 3, 4};
+        const TVector<ui8> expectedPart0Bins = {0, 1, 2, 3, 0};
+        const TVector<ui8> expectedPart1Bins = {0, 0, 0, 0, 1};
+
+        for (auto i : xrange(bundleValues.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(GetBinFromBundle(bundleValues[i], bundle.Parts[0].Bounds), expectedPart0Bins[i]);
+            UNIT_ASSERT_VALUES_EQUAL(GetBinFromBundle(bundleValues[i], bundle.Parts[1].Bounds), expectedPart1Bins[i]);
+        }
+    }
+
+    Y_UNIT_TEST(CreateExclusiveFeatureBundles) {
+        const TVector<TVector<ui8>> featuresBins = {
+            {1, 0, 0, 2, 0, 0, 0, 0, 0, 0}, // conflicts with feature 2 on object 0
+            {0, 1, 0, 0, 0, 0, 0, 0, 0, 1},
+            {3, 0, 0, 0, 0, 1, 2, 0, 0, 0},
+            {1, 1, 1, 1, 0, 0, 0, 0, 0, 0}  // too many non-default values
+        };
+        const TVector<TVector<float>> borders = {
+            {0.1f, 0.2f},
+            {0.5f},
+            {0.1f, 0.2f, 0.3f},
+            {0.5f}
+        };
+
+        const ui32 featureCount = featuresBins.size();
+        const ui32 objectCount = featuresBins[0].size();
+
+        TFeaturesLayout featuresLayout(featureCount, TVector<ui32>{}, TVector<TString>{}, nullptr);
+        TQuantizedFeaturesInfo quantizedFeaturesInfo(
+            featuresLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions(EBorderSelectionType::GreedyLogSum, /*discretization*/ 3)
+        );
+
+        TFeaturesArraySubsetIndexing subsetIndexing( TFullSubset<ui32>{objectCount} );
+
+        TVector<THolder<IQuantizedFloatValuesHolder>> quantizedFloatFeatures;
+        for (auto featureIdx : xrange(featureCount)) {
+            quantizedFeaturesInfo.SetBorders(TFloatFeatureIdx(featureIdx), TVector<float>(borders[featureIdx]));
+            quantizedFloatFeatures.push_back(
+                MakeHolder<TQuantizedFloatValuesHolder>(
+                    featureIdx,
+                    TCompressedArray(
+                        objectCount,
+                        CHAR_BIT,
+                        TMaybeOwningArrayHolder<ui64>::CreateOwning(
+                            CompressVector<ui64>(featuresBins[featureIdx], CHAR_BIT)
+                        )
+                    ),
+                    &subsetIndexing
+                )
+            );
+        }
+
+        TExclusiveFeaturesBundlingOptions options;
+        options.MaxNonDefaultValuesFraction = 0.3f;
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(2);
+
+        const TVector<TExclusiveFeaturesBundle> bundles = CreateExclusiveFeatureBundles(
+            quantizedFeaturesInfo,
+            quantizedFloatFeatures,
+            TVector<TMaybe<TPackedBinaryIndex>>(featureCount),
+            options,
+            &localExecutor
+        );
+
+        // feature 0 gets a bundle of its own that is not returned
+        TExclusiveFeaturesBundle expectedBundle;
+        expectedBundle.Add(2, 4);
+        expectedBundle.Add(1, 2);
+
+        UNIT_ASSERT_VALUES_EQUAL(bundles.size(), 1);
+        UNIT_ASSERT_EQUAL(bundles[0], expectedBundle);
+    }
+}
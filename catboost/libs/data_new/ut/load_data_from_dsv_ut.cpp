@@ -11,6 +11,9 @@
 #include <util/generic/fwd.h>
 #include <util/generic/maybe.h>
 #include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/xrange.h>
+#include <util/string/cast.h>
 
 #include <library/unittest/registar.h>
 
@@ -39,17 +42,22 @@ Y_UNIT_TEST_SUITE(LoadDataFromDsv) {
         NPar::TLocalExecutor localExecutor;
         localExecutor.RunAdditionalThreads(3);
 
-        TDataProviderPtr dataProvider = ReadDataset(
-            readDatasetMainParams.PoolPath,
-            readDatasetMainParams.PairsFilePath, // can be uninited
-            readDatasetMainParams.GroupWeightsFilePath, // can be uninited
-            readDatasetMainParams.DsvPoolFormatParams,
-            testCase.SrcData.IgnoredFeatures,
-            testCase.SrcData.ObjectsOrder,
-            &localExecutor
-        );
+        // memory-mapped loader must produce the same data as the default one
+        for (auto scheme : {"dsv", "mmap-dsv"}) {
+            readDatasetMainParams.PoolPath.Scheme = scheme;
+
+            TDataProviderPtr dataProvider = ReadDataset(
+                readDatasetMainParams.PoolPath,
+                readDatasetMainParams.PairsFilePath, // can be uninited
+                readDatasetMainParams.GroupWeightsFilePath, // can be uninited
+                readDatasetMainParams.DsvPoolFormatParams,
+                testCase.SrcData.IgnoredFeatures,
+                testCase.SrcData.ObjectsOrder,
+                &localExecutor
+            );
 
-        Compare<TRawObjectsDataProvider>(std::move(dataProvider), testCase.ExpectedData);
+            Compare<TRawObjectsDataProvider>(std::move(dataProvider), testCase.ExpectedData);
+        }
     }
 
 
@@ -701,4 +709,116 @@ Y_UNIT_TEST_SUITE(LoadDataFromDsv) {
             Test(testCase);
         }
     }
+
+    TDataProviderPtr ReadDatasetWithScheme(
+        const TSrcData& srcData,
+        TStringBuf scheme,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+        readDatasetMainParams.PoolPath.Scheme = scheme;
+
+        return ReadDataset(
+            readDatasetMainParams.PoolPath,
+            readDatasetMainParams.PairsFilePath,
+            readDatasetMainParams.GroupWeightsFilePath,
+            readDatasetMainParams.DsvPoolFormatParams,
+            srcData.IgnoredFeatures,
+            srcData.ObjectsOrder,
+            localExecutor
+        );
+    }
+
+    Y_UNIT_TEST(ReadDatasetErrorLineNumber) {
+        for (bool hasHeader : {false, true}) {
+            TSrcData srcData;
+            srcData.CdFileData = AsStringBuf(
+                "0\tTarget\n"
+                "1\tNum\tfloat0\n"
+            );
+            srcData.DsvFileData = hasHeader ?
+                AsStringBuf(
+                    "Target\tfloat0\n"
+                    "0\t0.1\n"
+                    "1\tbad\n"
+                ) :
+                AsStringBuf(
+                    "0\t0.1\n"
+                    "1\tbad\n"
+                );
+            srcData.DsvFileHasHeader = hasHeader;
+
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(3);
+
+            // line numbers in errors are 1-based data line numbers, the header line is not counted
+            for (auto scheme : {"dsv", "mmap-dsv"}) {
+                UNIT_ASSERT_EXCEPTION_CONTAINS(
+                    ReadDatasetWithScheme(srcData, scheme, &localExecutor),
+                    yexception,
+                    "lineIdx = 2"
+                );
+            }
+        }
+    }
+
+    // data is large enough to be split into many chunks by the memory-mapped loader
+    Y_UNIT_TEST(ReadDatasetMultipleChunks) {
+        const ui32 objectCount = 50000;
+        const ui32 badLineIdx = 43210; // 0-based data line
+
+        for (bool hasHeader : {false, true}) {
+            for (bool withBadLine : {false, true}) {
+                TString dsvFileData;
+                if (hasHeader) {
+                    dsvFileData += "Target\tfloat0\tcat0\tfloat1\n";
+                }
+                for (auto i : xrange(objectCount)) {
+                    // variable line lengths, so that chunk boundaries fall inside lines
+                    dsvFileData += ToString(i % 2);
+                    dsvFileData += '\t';
+                    dsvFileData += (withBadLine && (i == badLineIdx)) ? TString("bad") : ToString(i * 0.25f);
+                    dsvFileData += "\tc";
+                    dsvFileData += ToString((i * 7919) % 1000);
+                    dsvFileData += TString(i % 17, 'x');
+                    dsvFileData += '\t';
+                    dsvFileData += ToString((i % 113) * 0.5f);
+                    dsvFileData += '\n';
+                }
+                UNIT_ASSERT(dsvFileData.size() > 10 * (1 << 16));
+
+                TSrcData srcData;
+                srcData.CdFileData = AsStringBuf(
+                    "0\tTarget\n"
+                    "1\tNum\tfloat0\n"
+                    "2\tCateg\tcat0\n"
+                    "3\tNum\tfloat1\n"
+                );
+                srcData.DsvFileData = dsvFileData;
+                srcData.DsvFileHasHeader = hasHeader;
+
+                NPar::TLocalExecutor localExecutor;
+                localExecutor.RunAdditionalThreads(3);
+
+                if (withBadLine) {
+                    const TString expectedMessage = "lineIdx = " + ToString(badLineIdx + 1);
+                    for (auto scheme : {"dsv", "mmap-dsv"}) {
+                        UNIT_ASSERT_EXCEPTION_CONTAINS(
+                            ReadDatasetWithScheme(srcData, scheme, &localExecutor),
+                            yexception,
+                            expectedMessage
+                        );
+                    }
+                } else {
+                    auto dsvDataProvider = ReadDatasetWithScheme(srcData, "dsv", &localExecutor);
+                    auto mmapDataProvider = ReadDatasetWithScheme(srcData, "mmap-dsv", &localExecutor);
+
+                    UNIT_ASSERT_VALUES_EQUAL(mmapDataProvider->GetObjectCount(), objectCount);
+                    UNIT_ASSERT(*dsvDataProvider == *mmapDataProvider);
+                }
+            }
+        }
+    }
 }
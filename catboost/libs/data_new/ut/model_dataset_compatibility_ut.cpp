@@ -153,3 +153,63 @@ Y_UNIT_TEST_SUITE(GetFloatFeaturesBordersRemap) {
         UNIT_ASSERT(Equal<ui8>(floatBinsRemap[0], {0, 0, 0, 0, 1}));
     }
 }
+
+
+Y_UNIT_TEST_SUITE(GetCatFeaturesPerfectHashToHashRemap) {
+    Y_UNIT_TEST(Test) {
+        // features: float, cat, float, cat
+        TFeaturesLayout featuresLayout(ui32(4), TVector<ui32>{1, 3}, TVector<TString>(), nullptr);
+        TQuantizedFeaturesInfo quantizedFeaturesInfo(featuresLayout, TConstArrayRef<ui32>(), NCatboostOptions::TBinarizationOptions());
+
+        quantizedFeaturesInfo.UpdateCategoricalFeaturesPerfectHash(TCatFeatureIdx(0), {{0x12u, 1}, {0x7fu, 0}});
+        quantizedFeaturesInfo.UpdateCategoricalFeaturesPerfectHash(
+            TCatFeatureIdx(1),
+            {{0xau, 2}, {0xbu, 0}, {0xcu, 1}});
+
+        TFullModel model;
+        model.ObliviousTrees.CatFeatures = {
+            TCatFeature{true, 0, 1, ""},
+            TCatFeature{true, 1, 3, ""}
+        };
+
+        auto catFeaturesRemap = GetCatFeaturesPerfectHashToHashRemap(model, quantizedFeaturesInfo);
+
+        UNIT_ASSERT_VALUES_EQUAL(catFeaturesRemap.size(), 4);
+        UNIT_ASSERT(catFeaturesRemap[0].empty());
+        UNIT_ASSERT(Equal<ui32>(catFeaturesRemap[1], {0x7f, 0x12}));
+        UNIT_ASSERT(catFeaturesRemap[2].empty());
+        UNIT_ASSERT(Equal<ui32>(catFeaturesRemap[3], {0xb, 0xc, 0xa}));
+
+        model.ObliviousTrees.CatFeatures[0].UsedInModel = false;
+        catFeaturesRemap = GetCatFeaturesPerfectHashToHashRemap(model, quantizedFeaturesInfo);
+        UNIT_ASSERT(catFeaturesRemap[1].empty());
+        UNIT_ASSERT(Equal<ui32>(catFeaturesRemap[3], {0xb, 0xc, 0xa}));
+    }
+
+    Y_UNIT_TEST(FloatBordersRemapWithCatFeatures) {
+        bool hasNans = false;
+
+        // features: cat, float, cat, float
+        TFeaturesLayout featuresLayout(ui32(4), TVector<ui32>{0, 2}, TVector<TString>(), nullptr);
+        TQuantizedFeaturesInfo quantizedFeaturesInfo(featuresLayout, TConstArrayRef<ui32>(), NCatboostOptions::TBinarizationOptions());
+
+        quantizedFeaturesInfo.SetBorders(TFloatFeatureIdx(0), {0.f, 1.f});
+        quantizedFeaturesInfo.SetBorders(TFloatFeatureIdx(1), {0.f, 1.f, 2.f});
+
+        TFullModel model;
+        model.ObliviousTrees.FloatFeatures = {
+            TFloatFeature(hasNans, 0, 1, {1.f}),
+            TFloatFeature(hasNans, 1, 3, {0.f, 2.f})
+        };
+        model.ObliviousTrees.CatFeatures = {
+            TCatFeature{true, 0, 0, ""},
+            TCatFeature{true, 1, 2, ""}
+        };
+
+        auto floatBinsRemap = GetFloatFeaturesBordersRemap(model, quantizedFeaturesInfo);
+
+        UNIT_ASSERT_VALUES_EQUAL(floatBinsRemap.size(), 4);
+        UNIT_ASSERT(Equal<ui8>(floatBinsRemap[1], {0, 0, 1}));
+        UNIT_ASSERT(Equal<ui8>(floatBinsRemap[3], {0, 1, 1, 2}));
+    }
+}
@@ -370,4 +370,51 @@ Y_UNIT_TEST_SUITE(TObjectsGrouping) {
             );
         }
     }
+
+    Y_UNIT_TEST(ExtendPermutation) {
+        {
+            auto objectsGrouping = MakeIntrusive<TObjectsGrouping>(ui32(10));
+            auto extendedObjectsGroupingSubset = ExtendPermutation(objectsGrouping, {3, 0, 5, 1, 4, 2});
+
+            UNIT_ASSERT(
+                IndicesEqual(
+                    extendedObjectsGroupingSubset.GetGroupsIndexing(),
+                    {3, 0, 5, 1, 4, 2, 6, 7, 8, 9}
+                )
+            );
+            UNIT_ASSERT(
+                IndicesEqual(
+                    extendedObjectsGroupingSubset.GetObjectsIndexing(),
+                    {3, 0, 5, 1, 4, 2, 6, 7, 8, 9}
+                )
+            );
+        }
+        {
+            auto objectsGrouping = MakeIntrusive<TObjectsGrouping>(
+                TVector<TGroupBounds>{{0, 2}, {2, 5}, {5, 8}, {8, 9}, {9, 10}, {10, 12}}
+            );
+            auto extendedObjectsGroupingSubset = ExtendPermutation(objectsGrouping, {7, 5, 6, 1, 0, 3, 2, 4});
+
+            UNIT_ASSERT(
+                IndicesEqual(extendedObjectsGroupingSubset.GetGroupsIndexing(), {2, 0, 1, 3, 4, 5})
+            );
+            UNIT_ASSERT(
+                IndicesEqual(
+                    extendedObjectsGroupingSubset.GetObjectsIndexing(),
+                    {7, 5, 6, 1, 0, 3, 2, 4, 8, 9, 10, 11}
+                )
+            );
+            UNIT_ASSERT_EQUAL(
+                *extendedObjectsGroupingSubset.GetSubsetGrouping(),
+                TObjectsGrouping(TVector<TGroupBounds>{{0, 3}, {3, 5}, {5, 8}, {8, 9}, {9, 10}, {10, 12}})
+            );
+        }
+        {
+            auto objectsGrouping = MakeIntrusive<TObjectsGrouping>(
+                TVector<TGroupBounds>{{0, 2}, {2, 5}, {5, 8}}
+            );
+            // ends in the middle of a group
+            UNIT_ASSERT_EXCEPTION(ExtendPermutation(objectsGrouping, {1, 0, 2}), TCatBoostException);
+        }
+    }
 }
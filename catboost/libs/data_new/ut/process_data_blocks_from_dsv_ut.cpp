@@ -95,24 +95,29 @@ Y_UNIT_TEST_SUITE(ProcessDataBlocksFromDsv) {
         NPar::TLocalExecutor localExecutor;
         localExecutor.RunAdditionalThreads(3);
 
-        ui32 currentPart = 0;
-
-        ReadAndProceedPoolInBlocks(
-            readDatasetMainParams.PoolPath,
-            TDsvFormatOptions{testCase.SrcData.DsvFileHasHeader, '\t'},
-            readDatasetMainParams.DsvPoolFormatParams.CdFilePath,
-            testCase.BlockSize,
-            [&] (TDataProviderPtr dataProvider) {
-                Compare<TRawObjectsDataProvider>(
-                    std::move(dataProvider),
-                    testCase.ExpectedData[currentPart],
-                    true
-                );
-                ++currentPart;
-            },
-            &localExecutor
-        );
-        UNIT_ASSERT_VALUES_EQUAL((size_t)currentPart, testCase.ExpectedData.size());
+        // memory-mapped loader must split data to the same blocks as the default one
+        for (auto scheme : {"dsv", "mmap-dsv"}) {
+            readDatasetMainParams.PoolPath.Scheme = scheme;
+
+            ui32 currentPart = 0;
+
+            ReadAndProceedPoolInBlocks(
+                readDatasetMainParams.PoolPath,
+                TDsvFormatOptions{testCase.SrcData.DsvFileHasHeader, '\t'},
+                readDatasetMainParams.DsvPoolFormatParams.CdFilePath,
+                testCase.BlockSize,
+                [&] (TDataProviderPtr dataProvider) {
+                    Compare<TRawObjectsDataProvider>(
+                        std::move(dataProvider),
+                        testCase.ExpectedData[currentPart],
+                        true
+                    );
+                    ++currentPart;
+                },
+                &localExecutor
+            );
+            UNIT_ASSERT_VALUES_EQUAL((size_t)currentPart, testCase.ExpectedData.size());
+        }
     }
 
     static TSrcData GetNonGroupedSrcData() {
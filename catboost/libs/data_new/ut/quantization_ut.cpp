@@ -45,41 +45,46 @@ Y_UNIT_TEST_SUITE(Quantization) {
                 packBinaryFeaturesVariants.push_back(true);
             }
 
-            for (auto packBinaryFeatures : packBinaryFeaturesVariants) {
-                quantizationOptions.PackBinaryFeaturesForCpu = packBinaryFeatures;
-
-                for (auto clearSrcData : {false, true}) {
-                    TTestCase testCase = generateTestCase(packBinaryFeatures);
-
-                    TRestorableFastRng64 rand(0);
-
-                    NPar::TLocalExecutor localExecutor;
-                    localExecutor.RunAdditionalThreads(3);
-
-                    TRawDataProviderPtr rawDataProvider = MakeDataProvider<TRawObjectsDataProvider>(
-                        Nothing(),
-                        std::move(testCase.SrcData),
-                        false,
-                        &localExecutor
-                    );
-
-                    TDataProviderPtr quantizedDataProvider = Quantize(
-                        quantizationOptions,
-                        clearSrcData ? std::move(rawDataProvider) : rawDataProvider,
-                        testCase.QuantizedFeaturesInfo,
-                        &rand,
-                        &localExecutor)->CastMoveTo<TObjectsDataProvider>();
-
-                    if (quantizationOptions.CpuCompatibleFormat) {
-                        Compare<TQuantizedForCPUObjectsDataProvider>(
-                            std::move(quantizedDataProvider),
-                            testCase.ExpectedData
-                        );
-                    } else {
-                        Compare<TQuantizedObjectsDataProvider>(
-                            std::move(quantizedDataProvider),
-                            testCase.ExpectedData
+            // for small test data sketches are not compacted so borders must be the same
+            for (ui32 quantileSketchK : {0, 64}) {
+                quantizationOptions.QuantileSketchKForBuildBorders = quantileSketchK;
+
+                for (auto packBinaryFeatures : packBinaryFeaturesVariants) {
+                    quantizationOptions.PackBinaryFeaturesForCpu = packBinaryFeatures;
+
+                    for (auto clearSrcData : {false, true}) {
+                        TTestCase testCase = generateTestCase(packBinaryFeatures);
+
+                        TRestorableFastRng64 rand(0);
+
+                        NPar::TLocalExecutor localExecutor;
+                        localExecutor.RunAdditionalThreads(3);
+
+                        TRawDataProviderPtr rawDataProvider = MakeDataProvider<TRawObjectsDataProvider>(
+                            Nothing(),
+                            std::move(testCase.SrcData),
+                            false,
+                            &localExecutor
                         );
+
+                        TDataProviderPtr quantizedDataProvider = Quantize(
+                            quantizationOptions,
+                            clearSrcData ? std::move(rawDataProvider) : rawDataProvider,
+                            testCase.QuantizedFeaturesInfo,
+                            &rand,
+                            &localExecutor)->CastMoveTo<TObjectsDataProvider>();
+
+                        if (quantizationOptions.CpuCompatibleFormat) {
+                            Compare<TQuantizedForCPUObjectsDataProvider>(
+                                std::move(quantizedDataProvider),
+                                testCase.ExpectedData
+                            );
+                        } else {
+                            Compare<TQuantizedObjectsDataProvider>(
+                                std::move(quantizedDataProvider),
+                                testCase.ExpectedData
+                            );
+                        }
                     }
                 }
             }
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <catboost/libs/algo/calc_score_cache.h>
+#include <catboost/libs/algo/ctr_helper.h>
 #include <catboost/libs/algo/fold.h>
 #include <catboost/libs/algo/learn_context.h>
 #include <catboost/libs/algo/online_predictor.h>
 #include <catboost/libs/algo/pairwise_scoring.h>
+#include <catboost/libs/algo/projection.h>
 #include <catboost/libs/algo/score_bin.h>
 #include <catboost/libs/algo/target_classifier.h>
 #include <catboost/libs/data_new/data_provider.h>
@@ -62,7 +64,7 @@ namespace NCatboostDistributed {
 
     struct TTrainData : public IObjectBase {
         NCB::TTrainingForCPUDataProviderPtr TrainData;
-        TVector<TTargetClassifier> TargetClassifiers;
+        TCtrHelper CtrsHelper;
         ui64 RandomSeed;
         int ApproxDimension;
         TString StringParams;
@@ -74,7 +76,7 @@ namespace NCatboostDistributed {
     public:
         TTrainData() = default;
         TTrainData(NCB::TTrainingForCPUDataProviderPtr trainData,
-            const TVector<TTargetClassifier>& targetClassifiers,
+            const TCtrHelper& ctrsHelper,
             ui64 randomSeed,
             int approxDimension,
             const TString& stringParams,
@@ -82,7 +84,7 @@ namespace NCatboostDistributed {
             double sumAllWeights,
             EHessianType hessianType)
         : TrainData(trainData)
-        , TargetClassifiers(targetClassifiers)
+        , CtrsHelper(ctrsHelper)
         , RandomSeed(randomSeed)
         , ApproxDimension(approxDimension)
         , StringParams(stringParams)
@@ -95,7 +97,7 @@ namespace NCatboostDistributed {
         int operator&(IBinSaver& binSaver) {
             NCB::AddWithShared(&binSaver, &TrainData);
             binSaver.AddMulti(
-                TargetClassifiers,
+                CtrsHelper,
                 RandomSeed,
                 ApproxDimension,
                 StringParams,
@@ -118,6 +120,7 @@ namespace NCatboostDistributed {
         TLearnProgress Progress;
         int Depth;
         TVector<TIndexType> Indices;
+        THashMap<TProjection, TVector<ui64>> OnlineCtrHashes; // between online ctr stats and values calculation
 
         bool StoreExpApprox;
         bool UseTreeLevelCaching;
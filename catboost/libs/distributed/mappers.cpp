@@ -3,6 +3,7 @@
 #include <catboost/libs/algo/approx_calcer.h>
 #include <catboost/libs/algo/approx_calcer_multi.h>
 #include <catboost/libs/algo/error_functions.h>
+#include <catboost/libs/algo/greedy_tensor_search.h>
 #include <catboost/libs/algo/score_calcer.h>
 #include <catboost/libs/algo/learn_context.h>
 #include <catboost/libs/algo/online_ctr.h>
@@ -35,7 +36,7 @@ namespace NCatboostDistributed {
         localData.Progress.ApproxDimension = trainData->ApproxDimension;
         localData.Progress.AveragingFold = TFold::BuildPlainFold(
             *trainData->TrainData,
-            trainData->TargetClassifiers,
+            trainData->CtrsHelper.GetTargetClassifiers(),
             /*shuffle*/false,
             trainData->TrainData->GetObjectCount(),
             trainData->ApproxDimension,
@@ -79,7 +80,8 @@ namespace NCatboostDistributed {
                 CountNonCtrBuckets(
                     *(trainData->TrainData->ObjectsData->GetQuantizedFeaturesInfo()),
                     localData.Params.CatFeatureParams->OneHotMaxSize.Get()),
-                localData.Params.ObliviousTreeOptions->MaxDepth);
+                localData.Params.ObliviousTreeOptions->MaxDepth,
+                localData.Params.ObliviousTreeOptions->DevCompactScoreCache);
         }
         localData.Indices.yresize(plainFold.GetLearnSampleCount());
         localData.AllDocCount = trainData->AllDocCount;
@@ -93,7 +95,6 @@ namespace NCatboostDistributed {
         TOutput* /*unused*/
     ) const {
         NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
-        Y_ASSERT(!trainData->TrainData->MetaInfo.FeaturesLayout->GetCatFeatureCount());
 
         auto& localData = TLocalTensorSearchData::GetRef();
         Y_ASSERT(IsPlainMode(localData.Params.BoostingOptions->BoostingType));
@@ -127,6 +128,7 @@ namespace NCatboostDistributed {
                 &localData.Progress,
                 &NPar::LocalExecutor());
         }
+        TrimOnlineCTRcache({ &localData.Progress.AveragingFold });
     }
 
     void TTensorSearchStarter::DoMap(
@@ -138,6 +140,7 @@ namespace NCatboostDistributed {
         auto& localData = TLocalTensorSearchData::GetRef();
         localData.Depth = 0;
         Fill(localData.Indices.begin(), localData.Indices.end(), 0);
+        TrimOnlineCTRcache({ &localData.Progress.AveragingFold });
         if (localData.UseTreeLevelCaching) {
             localData.PrevTreeLevelStats.GarbageCollect();
         }
@@ -159,6 +162,68 @@ namespace NCatboostDistributed {
             localData.Rand.Get());
     }
 
+    void TOnlineCtrStatsCalcer::DoMap(
+        NPar::IUserContext* ctx,
+        int hostId,
+        TInput* projections,
+        TOutput* classCounts
+    ) const {
+        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        auto& localData = TLocalTensorSearchData::GetRef();
+        auto& fold = localData.Progress.AveragingFold;
+        TVector<TProjection> newProjections;
+        for (const auto& proj : projections->Data) {
+            const auto& ctrs = fold.GetCtrs(proj);
+            if (!ctrs.contains(proj) || ctrs.at(proj).Feature.empty()) {
+                newProjections.push_back(proj);
+                localData.OnlineCtrHashes[proj].yresize(fold.GetLearnSampleCount());
+            }
+        }
+        classCounts->Data.resize(newProjections.size());
+        NPar::ParallelFor(
+            0,
+            newProjections.ysize(),
+            [&] (int projIdx) {
+                const auto& proj = newProjections[projIdx];
+                auto& hashes = localData.OnlineCtrHashes.at(proj);
+                CalcOnlineCtrHashes(
+                    *trainData->TrainData->ObjectsData,
+                    fold.LearnPermutationFeaturesSubset,
+                    proj,
+                    hashes);
+                classCounts->Data[projIdx] = std::make_pair(proj, CountClassesByHash(hashes, fold));
+            });
+    }
+
+    void TOnlineCtrCalcer::DoMap(
+        NPar::IUserContext* ctx,
+        int hostId,
+        TInput* partStats,
+        TOutput* /*unused*/
+    ) const {
+        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        auto& localData = TLocalTensorSearchData::GetRef();
+        auto& fold = localData.Progress.AveragingFold;
+        TVector<TOnlineCTR*> ctrs;
+        for (const auto& [proj, stats] : partStats->Data) {
+            ctrs.push_back(&fold.GetCtrRef(proj));
+        }
+        NPar::ParallelFor(
+            0,
+            partStats->Data.ysize(),
+            [&] (int projIdx) {
+                const auto& proj = partStats->Data[projIdx].first;
+                ComputeOnlineCTRs(
+                    trainData->CtrsHelper.GetCtrInfo(proj),
+                    fold,
+                    partStats->Data[projIdx].second,
+                    localData.OnlineCtrHashes.at(proj),
+                    ctrs[projIdx],
+                    &NPar::LocalExecutor());
+            });
+        localData.OnlineCtrHashes.clear();
+    }
+
     template <typename TMapFunc, typename TInputType, typename TOutputType>
     static void MapVector(const TMapFunc mapFunc,
         const TVector<TInputType>& inputs,
@@ -379,7 +444,6 @@ namespace NCatboostDistributed {
         TInput* bestSplit,
         TOutput* /*unused*/
     ) const {
-        Y_ASSERT(bestSplit->Data.Type != ESplitType::OnlineCtr);
         auto& localData = TLocalTensorSearchData::GetRef();
         NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
         SetPermutedIndices(
@@ -695,3 +759,5 @@ REGISTER_SAVELOAD_NM_CLASS(0xd66d4d4, NCatboostDistributed, TErrorCalcer);
 
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4d6, NCatboostDistributed, TApproxReconstructor);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e0, NCatboostDistributed, TLeafWeightsGetter);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e1, NCatboostDistributed, TOnlineCtrStatsCalcer);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e2, NCatboostDistributed, TOnlineCtrCalcer);
@@ -2,6 +2,7 @@
 
 #include "data_types.h"
 
+#include <catboost/libs/algo/online_ctr.h>
 #include <catboost/libs/algo/tensor_search_helpers.h>
 
 #include <library/par/par.h>
@@ -37,6 +38,25 @@ namespace NCatboostDistributed {
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unused*/, TOutput* /*unused*/) const final;
     };
 
+    // [proj] -> class counts by hash value for projections without computed online ctrs
+    class TOnlineCtrStatsCalcer
+        : public NPar::TMapReduceCmd<
+            TEnvelope<TVector<TProjection>>,
+            TEnvelope<TVector<std::pair<TProjection, TCtrHashClassCounts>>>> {
+
+        OBJECT_NOCOPY_METHODS(TOnlineCtrStatsCalcer);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* projections, TOutput* classCounts) const final;
+    };
+    // stats aggregated over preceding workers -> online ctrs of worker fold
+    class TOnlineCtrCalcer
+        : public NPar::TMapReduceCmd<
+            TEnvelope<TVector<std::pair<TProjection, TOnlineCtrPartStats>>>,
+            TUnusedInitializedParam> {
+
+        OBJECT_NOCOPY_METHODS(TOnlineCtrCalcer);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* partStats, TOutput* /*unused*/) const final;
+    };
+
     // [cand][subcand]
     class TScoreCalcer: public NPar::TMapReduceCmd<TEnvelope<TCandidateList>, TEnvelope<TStats5D>> {
         OBJECT_NOCOPY_METHODS(TScoreCalcer);
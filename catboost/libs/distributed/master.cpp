@@ -2,6 +2,7 @@
 #include "mappers.h"
 
 #include <catboost/libs/algo/error_functions.h>
+#include <catboost/libs/algo/greedy_tensor_search.h>
 #include <catboost/libs/algo/index_calcer.h>
 #include <catboost/libs/algo/score_bin.h>
 #include <catboost/libs/algo/score_calcer.h>
@@ -48,7 +49,6 @@ void MapBuildPlainFold(NCB::TTrainingForCPUDataProviderPtr trainData, TLearnCont
     TVector<TArraySubsetIndexing<ui32>> workerParts = Split(*trainData->ObjectsGrouping, (ui32)workerCount);
 
     const ui64 randomSeed = ctx->Rand.GenRand();
-    const auto& targetClassifiers = ctx->CtrsHelper.GetTargetClassifiers();
     NJson::TJsonValue jsonParams;
     ctx->Params.Save(&jsonParams);
     const auto& metricOptions = ctx->Params.MetricOptions;
@@ -73,7 +73,7 @@ void MapBuildPlainFold(NCB::TTrainingForCPUDataProviderPtr trainData, TLearnCont
                         std::move(workerParts[workerIdx]),
                         EObjectsOrder::Ordered),
                     ctx->LocalExecutor),
-                targetClassifiers,
+                ctx->CtrsHelper,
                 randomSeed,
                 ctx->LearnProgress.ApproxDimension,
                 stringParams,
@@ -85,16 +85,49 @@ void MapBuildPlainFold(NCB::TTrainingForCPUDataProviderPtr trainData, TLearnCont
     ApplyMapper<TPlainFoldBuilder>(workerCount, ctx->SharedTrainData);
 }
 
-void MapRestoreApproxFromTreeStruct(TLearnContext* ctx) {
+static TVector<TProjection> GetUniqueCtrProjections(const TSplitTree& splitTree) {
+    TVector<TProjection> projections;
+    for (const auto& ctr : splitTree.GetCtrSplits()) {
+        if (!IsIn(projections, ctr.Projection)) {
+            projections.push_back(ctr.Projection);
+        }
+    }
+    return projections;
+}
+
+void MapRestoreApproxFromTreeStruct(const NCB::TTrainingForCPUDataProviders& data, TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    ApplyMapper<TApproxReconstructor>(
-        ctx->RootEnvironment->GetSlaveCount(),
-        ctx->SharedTrainData,
-        MakeEnvelope(std::make_pair(ctx->LearnProgress.TreeStruct, ctx->LearnProgress.LeafValues)));
+    TVector<TSplitTree> splitTrees; // only symmetric trees are supported in distributed mode
+    for (const auto& tree : ctx->LearnProgress.TreeStruct) {
+        splitTrees.push_back(Get<TSplitTree>(tree));
+    }
+    const bool hasCtrSplits = AnyOf(
+        splitTrees,
+        [] (const auto& splitTree) { return !splitTree.GetCtrSplits().empty(); });
+    if (!hasCtrSplits) {
+        ApplyMapper<TApproxReconstructor>(
+            ctx->RootEnvironment->GetSlaveCount(),
+            ctx->SharedTrainData,
+            MakeEnvelope(std::make_pair(std::move(splitTrees), ctx->LearnProgress.LeafValues)));
+        return;
+    }
+    // restore tree by tree to keep online ctr cache on workers bounded
+    for (auto treeIdx : xrange(splitTrees.size())) {
+        MapCalcOnlineCtrs(data, GetUniqueCtrProjections(splitTrees[treeIdx]), ctx);
+        ApplyMapper<TApproxReconstructor>(
+            ctx->RootEnvironment->GetSlaveCount(),
+            ctx->SharedTrainData,
+            MakeEnvelope(
+                std::make_pair(
+                    TVector<TSplitTree>{splitTrees[treeIdx]},
+                    TVector<TVector<TVector<double>>>{ctx->LearnProgress.LeafValues[treeIdx]})));
+        TrimOnlineCTRcache({ &ctx->LearnProgress.AveragingFold }); // as TApproxReconstructor does on workers
+    }
 }
 
 void MapTensorSearchStart(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    TrimOnlineCTRcache({ &ctx->LearnProgress.AveragingFold }); // as TTensorSearchStarter does on workers
     ApplyMapper<TTensorSearchStarter>(ctx->RootEnvironment->GetSlaveCount(), ctx->SharedTrainData);
 }
 
@@ -103,6 +136,170 @@ void MapBootstrap(TLearnContext* ctx) {
     ApplyMapper<TBootstrapMaker>(ctx->RootEnvironment->GetSlaveCount(), ctx->SharedTrainData);
 }
 
+static TVector<ui64> CalcTestOnlineCtrHashes(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const TProjection& projection) {
+
+    TVector<ui64> testHashes;
+    testHashes.yresize(data.GetTestSampleCount());
+    size_t docOffset = 0;
+    for (const auto& testData : data.Test) {
+        const size_t testSampleCount = testData->GetObjectCount();
+        CalcOnlineCtrHashes(
+            *testData->ObjectsData,
+            testData->ObjectsData->GetFeaturesArraySubsetIndexing(),
+            projection,
+            MakeArrayRef(testHashes.data() + docOffset, testSampleCount));
+        docOffset += testSampleCount;
+    }
+    return testHashes;
+}
+
+/* Workers hold consecutive parts of learn objects in fold order, so online ctrs of a part are the ones
+ * computed with class counts accumulated over all preceding parts.
+ * Test objects are the last part: [workerIdx] stats are followed by stats for test objects.
+ * Unique values counts are the ones of the whole dataset, as in folds of single host training.
+ */
+static TVector<TOnlineCtrPartStats> CalcOnlineCtrPartStats(
+    TConstArrayRef<ui64> testHashes,
+    const TProjection& projection,
+    const TVector<const TCtrHashClassCounts*>& classCountsFromAllWorkers,
+    const TLearnContext& ctx,
+    size_t* uniqueValuesCount,
+    size_t* counterUniqueValuesCount) {
+
+    const int workerCount = classCountsFromAllWorkers.ysize();
+    TVector<TOnlineCtrPartStats> partStats(workerCount + 1);
+    TCtrHashClassCounts precedingClassCounts;
+    for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
+        auto& workerPrecedingClassCounts = partStats[workerIdx].PrecedingClassCounts;
+        for (const auto& [hash, counts] : *classCountsFromAllWorkers[workerIdx]) {
+            auto& precedingCounts = precedingClassCounts[hash];
+            if (precedingCounts.empty()) {
+                precedingCounts.resize(counts.size());
+            } else {
+                workerPrecedingClassCounts.emplace(hash, precedingCounts);
+            }
+            for (auto idx : xrange(counts.size())) {
+                precedingCounts[idx] += counts[idx];
+            }
+        }
+    }
+    auto& testStats = partStats.back();
+    *uniqueValuesCount = *counterUniqueValuesCount = precedingClassCounts.size();
+
+    const auto& ctrInfo = ctx.CtrsHelper.GetCtrInfo(projection);
+    if (AnyOf(ctrInfo, [] (const auto& info) { return info.Type == ECtrType::Counter; })) {
+        THashMap<ui64, int> counterTotals;
+        for (const auto& [hash, counts] : precedingClassCounts) {
+            counterTotals[hash] = counts.back();
+        }
+        if (ctx.Params.CatFeatureParams->CounterCalcMethod == ECounterCalc::Full) {
+            for (auto hash : testHashes) {
+                ++counterTotals[hash];
+            }
+            *counterUniqueValuesCount = counterTotals.size();
+        }
+        int counterDenominator = 0;
+        for (const auto& [hash, total] : counterTotals) {
+            counterDenominator = Max(counterDenominator, total);
+        }
+        for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
+            partStats[workerIdx].CounterDenominator = counterDenominator;
+            for (const auto& [hash, counts] : *classCountsFromAllWorkers[workerIdx]) {
+                partStats[workerIdx].CounterTotals[hash] = counterTotals.at(hash);
+            }
+        }
+        testStats.CounterDenominator = counterDenominator;
+        for (auto hash : testHashes) {
+            if (const int* total = counterTotals.FindPtr(hash)) {
+                testStats.CounterTotals.emplace(hash, *total);
+            }
+        }
+    }
+    testStats.PrecedingClassCounts = std::move(precedingClassCounts);
+    return partStats;
+}
+
+void MapCalcOnlineCtrs(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const TVector<TProjection>& projections,
+    TLearnContext* ctx) {
+
+    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    if (projections.empty()) {
+        return;
+    }
+    const int workerCount = ctx->RootEnvironment->GetSlaveCount();
+    const auto classCountsFromAllWorkers = ApplyMapper<TOnlineCtrStatsCalcer>(
+        workerCount,
+        ctx->SharedTrainData,
+        MakeEnvelope(projections));
+    // workers execute the same sequence of commands, so their online ctr caches are identical
+    const auto& newCtrs = classCountsFromAllWorkers[0].Data;
+    for (int workerIdx = 1; workerIdx < workerCount; ++workerIdx) {
+        Y_VERIFY(classCountsFromAllWorkers[workerIdx].Data.size() == newCtrs.size());
+    }
+    if (newCtrs.empty()) {
+        return;
+    }
+
+    // master averaging fold caches online ctrs of test objects for the same projections as worker folds
+    auto& averagingFold = ctx->LearnProgress.AveragingFold;
+    TVector<TOnlineCTR*> testCtrs;
+    for (const auto& [projection, unused] : newCtrs) {
+        testCtrs.push_back(&averagingFold.GetCtrRef(projection));
+    }
+
+    // [workerIdx][projIdx]
+    TVector<TEnvelope<TVector<std::pair<TProjection, TOnlineCtrPartStats>>>> partStats(workerCount);
+    for (auto& workerPartStats : partStats) {
+        workerPartStats.Data.resize(newCtrs.size());
+    }
+    NPar::ParallelFor(
+        *ctx->LocalExecutor,
+        0,
+        newCtrs.ysize(),
+        [&] (int projIdx) {
+            const auto& projection = newCtrs[projIdx].first;
+            TVector<const TCtrHashClassCounts*> projClassCounts;
+            for (const auto& workerClassCounts : classCountsFromAllWorkers) {
+                Y_VERIFY(workerClassCounts.Data[projIdx].first == projection);
+                projClassCounts.push_back(&workerClassCounts.Data[projIdx].second);
+            }
+            const auto testHashes = CalcTestOnlineCtrHashes(data, projection);
+            size_t uniqueValuesCount = 0;
+            size_t counterUniqueValuesCount = 0;
+            auto projPartStats = CalcOnlineCtrPartStats(
+                testHashes,
+                projection,
+                projClassCounts,
+                *ctx,
+                &uniqueValuesCount,
+                &counterUniqueValuesCount);
+            for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
+                partStats[workerIdx].Data[projIdx] = std::make_pair(projection, std::move(projPartStats[workerIdx]));
+            }
+            ComputeTestOnlineCTRs(
+                ctx->CtrsHelper.GetCtrInfo(projection),
+                averagingFold,
+                projPartStats.back(),
+                testHashes,
+                testCtrs[projIdx]);
+            testCtrs[projIdx]->UniqueValuesCount = uniqueValuesCount;
+            testCtrs[projIdx]->CounterUniqueValuesCount = counterUniqueValuesCount;
+        });
+
+    NPar::TJobDescription job;
+    job.SetCurrentOperation(new TOnlineCtrCalcer());
+    for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
+        job.AddQuery(workerIdx, partStats[workerIdx]);
+    }
+    NPar::TJobExecutor exec(&job, ctx->SharedTrainData);
+    TVector<TOnlineCtrCalcer::TOutput> unused;
+    exec.GetResultVec(&unused);
+}
+
 template <typename TScoreCalcMapper, typename TGetScore>
 void MapGenericCalcScore(
     TGetScore getScore,
@@ -286,7 +483,7 @@ template <typename TApproxDefs>
 void MapSetApproxes(
     const IDerCalcer& error,
     const TSplitTree& splitTree,
-    TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData,
+    const NCB::TTrainingForCPUDataProviders& data,
     TVector<TVector<double>>* averageLeafValues,
     TVector<double>* sumLeafWeights,
     TLearnContext* ctx) {
@@ -352,18 +549,19 @@ void MapSetApproxes(
     // update learn approx and average approx
     ApplyMapper<TApproxUpdater>(workerCount, ctx->SharedTrainData, *averageLeafValues);
     // update test
+    // master averaging fold contains online ctrs of test objects only
     const auto indices = BuildIndices(
-        /*unused fold*/{ },
+        ctx->LearnProgress.AveragingFold,
         splitTree, /*learnData*/
         { },
-        testData,
+        data.Test,
         ctx->LocalExecutor);
     UpdateAvrgApprox(
         error.GetIsExpApprox(), /*learnSampleCount*/
         0,
         indices,
         *averageLeafValues,
-        testData,
+        data.Test,
         &ctx->LearnProgress,
         ctx->LocalExecutor);
 }
@@ -445,23 +643,23 @@ public:
 void MapSetApproxesSimple(
     const IDerCalcer& error,
     const TSplitTree& splitTree,
-    TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData,
+    const NCB::TTrainingForCPUDataProviders& data,
     TVector<TVector<double>>* averageLeafValues,
     TVector<double>* sumLeafWeights,
     TLearnContext* ctx) {
 
-    MapSetApproxes<TSetApproxesSimpleDefs>(error, splitTree, testData, averageLeafValues, sumLeafWeights, ctx);
+    MapSetApproxes<TSetApproxesSimpleDefs>(error, splitTree, data, averageLeafValues, sumLeafWeights, ctx);
 }
 
 void MapSetApproxesMulti(
     const IDerCalcer& error,
     const TSplitTree& splitTree,
-    TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData,
+    const NCB::TTrainingForCPUDataProviders& data,
     TVector<TVector<double>>* averageLeafValues,
     TVector<double>* sumLeafWeights,
     TLearnContext* ctx) {
 
-    MapSetApproxes<TSetApproxesMultiDefs>(error, splitTree, testData, averageLeafValues, sumLeafWeights, ctx);
+    MapSetApproxes<TSetApproxesMultiDefs>(error, splitTree, data, averageLeafValues, sumLeafWeights, ctx);
 }
 
 void MapSetDerivatives(TLearnContext* ctx) {
@@ -11,9 +11,14 @@
 void InitializeMaster(TLearnContext* ctx);
 void FinalizeMaster(TLearnContext* ctx);
 void MapBuildPlainFold(NCB::TTrainingForCPUDataProviderPtr trainData, TLearnContext* ctx);
-void MapRestoreApproxFromTreeStruct(TLearnContext* ctx);
+void MapRestoreApproxFromTreeStruct(const NCB::TTrainingForCPUDataProviders& data, TLearnContext* ctx);
 void MapTensorSearchStart(TLearnContext* ctx);
 void MapBootstrap(TLearnContext* ctx);
+// computes online ctrs of projections missing in worker folds
+void MapCalcOnlineCtrs(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const TVector<TProjection>& projections,
+    TLearnContext* ctx);
 void MapCalcScore(
     double scoreStDev,
     int depth,
@@ -54,7 +59,7 @@ TVector<typename TMapper::TOutput> ApplyMapper(
 void MapSetApproxesSimple(
     const IDerCalcer& error,
     const TSplitTree& splitTree,
-    TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData,
+    const NCB::TTrainingForCPUDataProviders& data,
     TVector<TVector<double>>* averageLeafValues,
     TVector<double>* sumLeafWeights,
     TLearnContext* ctx);
@@ -62,7 +67,7 @@ void MapSetApproxesSimple(
 void MapSetApproxesMulti(
     const IDerCalcer& error,
     const TSplitTree& splitTree,
-    TConstArrayRef<NCB::TTrainingForCPUDataProviderPtr> testData,
+    const NCB::TTrainingForCPUDataProviders& data,
     TVector<TVector<double>>* averageLeafValues,
     TVector<double>* sumLeafWeights,
     TLearnContext* ctx);
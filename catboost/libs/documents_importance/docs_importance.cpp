@@ -120,6 +120,7 @@ TDStrResult GetDocumentImportances(
     int threadCount,
     int logPeriod
 ) {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Document importance is not supported for non-symmetric trees");
     if (topSize == -1) {
         topSize = SafeIntegerCast<int>(trainData.ObjectsData->GetObjectCount());
     } else {
@@ -150,7 +150,7 @@ namespace NCB {
         if (testSetPath.Inited()) {
             if (testSetPath.Scheme == "quantized") {
                 poolColumnsPrinter = TIntrusivePtr<IPoolColumnsPrinter>(new TQuantizedPoolColumnsPrinter(testSetPath));
-            } else if (testSetPath.Scheme == "dsv" || testSetPath.Scheme == "yt-dsv") {
+            } else if (testSetPath.Scheme == "dsv" || testSetPath.Scheme == "mmap-dsv" || testSetPath.Scheme == "yt-dsv") {
                 poolColumnsPrinter = TIntrusivePtr<IPoolColumnsPrinter>(new TDSVPoolColumnsPrinter(testSetPath, testSetFormat, columnsMetaInfo));
             }
         }
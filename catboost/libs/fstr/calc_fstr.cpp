@@ -362,6 +362,7 @@ TVector<std::pair<double, TFeature>> CalcFeatureEffect(
         EFstrType type,
         NPar::TLocalExecutor* localExecutor)
 {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Feature importance is not supported for non-symmetric trees");
     type = GetFeatureImportanceType(model, bool(dataset), type);
     if (type == EFstrType::LossFunctionChange) {
         CB_ENSURE(dataset, "dataset is not provided");
@@ -453,6 +454,7 @@ TVector<double> CalcRegularFeatureEffect(
 }
 
 TVector<TInternalFeatureInteraction> CalcInternalFeatureInteraction(const TFullModel& model) {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Feature interaction is not supported for non-symmetric trees");
     if (model.GetTreeCount() == 0) {
         return TVector<TInternalFeatureInteraction>();
     }
@@ -12,6 +12,7 @@
 #include <util/generic/algorithm.h>
 #include <util/generic/utility.h>
 #include <util/generic/ymath.h>
+#include <util/stream/file.h>
 
 
 using namespace NCB;
@@ -553,6 +554,7 @@ TShapPreparedTrees PrepareTrees(
     NPar::TLocalExecutor* localExecutor,
     bool calcInternalValues
 ) {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "SHAP values are not supported for non-symmetric trees");
     WarnForComplexCtrs(model.ObliviousTrees);
 
     const size_t treeCount = model.GetTreeCount();
@@ -715,49 +717,38 @@ TVector<TVector<double>> CalcShapValues(
     return shapValues;
 }
 
-static void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapValues, TFileOutput& out) {
+void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapValues, IOutputStream* out) {
     for (const auto& shapValuesForDocument : shapValues) {
         for (const auto& shapValuesForClass : shapValuesForDocument) {
             int valuesCount = shapValuesForClass.size();
             for (int valueIdx = 0; valueIdx < valuesCount; ++valueIdx) {
-                out << shapValuesForClass[valueIdx] << (valueIdx + 1 == valuesCount ? '\n' : '\t');
+                *out << shapValuesForClass[valueIdx] << (valueIdx + 1 == valuesCount ? '\n' : '\t');
             }
         }
     }
 }
 
-void CalcAndOutputShapValues(
+void CalcShapValuesByBlocks(
     const TFullModel& model,
-    const TDataProvider& dataset,
-    const TString& outputPath,
-    int logPeriod,
+    const TShapPreparedTrees& preparedTrees,
+    const TObjectsDataProvider& objectsData,
+    TImportanceLogger* documentsLogger,
+    TProfileInfo* processDocumentsProfile,
+    const TShapValuesBlockConsumer& blockConsumer,
     NPar::TLocalExecutor* localExecutor
 ) {
-    TShapPreparedTrees preparedTrees = PrepareTrees(
-        model,
-        &dataset,
-        logPeriod,
-        localExecutor
-    );
-
-    const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
+    const size_t documentCount = objectsData.GetObjectCount();
     const size_t documentBlockSize = CB_THREAD_LIMIT; // least necessary for threading
 
-    TImportanceLogger documentsLogger(documentCount, "documents processed", "Processing documents...", logPeriod);
-
-    TProfileInfo processDocumentsProfile(documentCount);
-
-    TFileOutput out(outputPath);
+    TVector<TVector<TVector<double>>> shapValuesForBlock;
     for (size_t start = 0; start < documentCount; start += documentBlockSize) {
         size_t end = Min(start + documentBlockSize, documentCount);
-        processDocumentsProfile.StartIterationBlock();
-
-        TVector<TVector<TVector<double>>> shapValuesForBlock;
-        shapValuesForBlock.reserve(end - start);
+        processDocumentsProfile->StartIterationBlock();
 
+        shapValuesForBlock.clear();
         CalcShapValuesForDocumentBlockMulti(
             model,
-            *dataset.ObjectsData,
+            objectsData,
             preparedTrees,
             start,
             end,
@@ -765,10 +756,62 @@ void CalcAndOutputShapValues(
             &shapValuesForBlock
         );
 
-        OutputShapValuesMulti(shapValuesForBlock, out);
+        blockConsumer(start, shapValuesForBlock);
 
-        processDocumentsProfile.FinishIterationBlock(end - start);
-        auto profileResults = processDocumentsProfile.GetProfileResults();
-        documentsLogger.Log(profileResults);
+        processDocumentsProfile->FinishIterationBlock(end - start);
+        auto profileResults = processDocumentsProfile->GetProfileResults();
+        documentsLogger->Log(profileResults);
     }
 }
+
+void CalcAndOutputShapValues(
+    const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
+    const TObjectsDataProvider& objectsData,
+    TImportanceLogger* documentsLogger,
+    TProfileInfo* processDocumentsProfile,
+    IOutputStream* out,
+    NPar::TLocalExecutor* localExecutor
+) {
+    CalcShapValuesByBlocks(
+        model,
+        preparedTrees,
+        objectsData,
+        documentsLogger,
+        processDocumentsProfile,
+        [out] (size_t /*blockStart*/, const TVector<TVector<TVector<double>>>& shapValuesForBlock) {
+            OutputShapValuesMulti(shapValuesForBlock, out);
+        },
+        localExecutor
+    );
+}
+
+void CalcAndOutputShapValues(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    const TString& outputPath,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor
+) {
+    TShapPreparedTrees preparedTrees = PrepareTrees(
+        model,
+        &dataset,
+        logPeriod,
+        localExecutor
+    );
+
+    const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
+    TImportanceLogger documentsLogger(documentCount, "documents processed", "Processing documents...", logPeriod);
+    TProfileInfo processDocumentsProfile(documentCount);
+
+    TFileOutput out(outputPath);
+    CalcAndOutputShapValues(
+        model,
+        preparedTrees,
+        *dataset.ObjectsData,
+        &documentsLogger,
+        &processDocumentsProfile,
+        &out,
+        localExecutor
+    );
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/loggers/logger.h>
+#include <catboost/libs/logging/profile_info.h>
 #include <catboost/libs/model/model.h>
 
 #include <library/threading/local_executor/local_executor.h>
@@ -11,6 +13,8 @@
 #include <util/system/types.h>
 #include <util/ysaveload.h>
 
+#include <functional>
+
 
 struct TShapValue {
     int Feature = -1;
@@ -82,7 +86,41 @@ TVector<TVector<double>> CalcShapValues(
     NPar::TLocalExecutor* localExecutor
 );
 
+// shapValuesForBlock[documentIdx - blockStart][dimension][feature]
+using TShapValuesBlockConsumer = std::function<void(
+    size_t blockStart,
+    const TVector<TVector<TVector<double>>>& shapValuesForBlock
+)>;
+
+/* Calculates shap values for consecutive blocks of documents and passes each block to blockConsumer
+ * as soon as it is calculated, so that memory used doesn't depend on the number of documents.
+ * preparedTrees, documentsLogger and processDocumentsProfile can be shared by several parts
+ * of a dataset that is too large to be loaded at once.
+ */
+void CalcShapValuesByBlocks(
+    const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
+    const NCB::TObjectsDataProvider& objectsData,
+    TImportanceLogger* documentsLogger,
+    TProfileInfo* processDocumentsProfile,
+    const TShapValuesBlockConsumer& blockConsumer,
+    NPar::TLocalExecutor* localExecutor
+);
+
 // outputs for each document in order for each dimension in order an array of feature contributions
+void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapValues, IOutputStream* out);
+
+// outputs shap values in the OutputShapValuesMulti format block by block
+void CalcAndOutputShapValues(
+    const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
+    const NCB::TObjectsDataProvider& objectsData,
+    TImportanceLogger* documentsLogger,
+    TProfileInfo* processDocumentsProfile,
+    IOutputStream* out,
+    NPar::TLocalExecutor* localExecutor
+);
+
 void CalcAndOutputShapValues(
     const TFullModel& model,
     const NCB::TDataProvider& dataset,
@@ -17,6 +17,7 @@ TVector<TVector<double>> CollectLeavesStatistics(
     const NCB::TDataProvider& dataset,
     const TFullModel& model,
     NPar::TLocalExecutor* localExecutor) {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Leaves statistics are not supported for non-symmetric trees");
     TConstArrayRef<float> weights;
 
     if (const auto* modelInfoParams = MapFindPtr(model.ModelInfo, "params")) {
@@ -7,6 +7,8 @@
 #include <util/stream/output.h>
 #include <util/stream/file.h>
 #include <util/folder/path.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
 #include <util/generic/guid.h>
 #include <util/system/fs.h>
 #include <util/ysaveload.h>
@@ -81,6 +83,22 @@ public:
         reader(&input);
     }
 
+    /* Also accepts progress saved with one of `legacyLabels` (labels of earlier progress layouts),
+     * the label the progress was saved with is passed to the reader
+     */
+    template <class TReader>
+    void CheckedLoad(const TFsPath& path,
+                     const TVector<TString>& legacyLabels,
+                     TReader&& reader) {
+        TString label;
+        TIFStream input(path);
+        ::Load(&input, label);
+        CB_ENSURE(
+            Label == label || IsIn(legacyLabels, label),
+            "Error: expect " << Label << " progress. Got " << label);
+        reader(&input, label);
+    }
+
 private:
     TString Label;
     TString ExceptionMessage;
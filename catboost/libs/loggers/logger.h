@@ -194,6 +194,9 @@ public:
         for (const auto& it : profileResults.OperationToTime) {
             Stream << it.first << ": " << FloatToString(it.second, PREC_NDIGITS, 3) << " sec" << Endl;
         }
+        for (const auto& it : profileResults.Counters) {
+            Stream << it.first << ": " << it.second << Endl;
+        }
         Stream << "Passed: " << FloatToString(profileResults.CurrentTime, PREC_NDIGITS, 3) << " sec" << Endl;
         if (profileResults.IsIterationGood) {
             Stream << "\ttotal: " << HumanReadable(TDuration::Seconds(profileResults.PassedTime));
@@ -201,6 +204,7 @@ public:
         }
         PassedIterations = profileResults.PassedIterations;
         OperationToTimeInAllIterations = profileResults.OperationToTimeInAllIterations;
+        Counters = profileResults.Counters;
     }
 
     void Flush(const int currentIteration) {
@@ -227,12 +231,16 @@ private:
             *File << it.first << ": "
                 << FloatToString(it.second / PassedIterations, PREC_NDIGITS, 3) << " sec" << Endl;
         }
+        for (const auto& it : Counters) {
+            *File << it.first << ": " << it.second << Endl;
+        }
     }
 
     THolder<TOFStream> File;
     TStringStream Stream;
     int PassedIterations;
     TMap<TString, double> OperationToTimeInAllIterations;
+    TMap<TString, ui64> Counters;
 };
 
 class TJsonProfileLoggingBackend : public ILoggingBackend {
@@ -249,6 +257,12 @@ public:
         for (const auto& it : profileResults.OperationToTime) {
             times[it.first] = it.second;
         }
+        if (!profileResults.Counters.empty()) {
+            auto& counters = CurrentValue["counters"];
+            for (const auto& it : profileResults.Counters) {
+                counters[it.first] = it.second;
+            }
+        }
 
         PassedIterations = profileResults.PassedIterations;
         OperationToTimeInAllIterations = profileResults.OperationToTimeInAllIterations;
@@ -35,6 +35,7 @@ struct TProfileResults {
     int PassedIterations;
     TMap<TString, double> OperationToTime;
     TMap<TString, double> OperationToTimeInAllIterations;
+    TMap<TString, ui64> Counters; // cumulative values, e.g. cache statistics
 };
 
 struct TProfileInfoData {
@@ -102,6 +103,10 @@ public:
         OperationToTime[operation] += passedTime; // operations can be repeated in one iteration
     }
 
+    void SetCounter(const TString& name, ui64 value) {
+        Counters[name] = value;
+    }
+
     void FinishIterationBlock(int blockSize) {
         CurrentTime += Timer.PassedReset();
         OperationToTime["Iteration time"] = CurrentTime;
@@ -129,7 +134,7 @@ public:
     }
 
     TProfileResults GetProfileResults() const {
-        return {
+        TProfileResults profileResults(
             ProfileData.PassedTime,
             RemainingTime,
             IsIterationGood,
@@ -137,13 +142,16 @@ public:
             ProfileData.PassedIterations,
             OperationToTime,
             ProfileData.OperationToTimeInAllIterations
-        };
+        );
+        profileResults.Counters = Counters;
+        return profileResults;
     }
 
 private:
     static constexpr int MAX_TIME_RATIO = 100;
     TProfileInfoData ProfileData;
     TMap<TString, double> OperationToTime;
+    TMap<TString, ui64> Counters;
     THPTimer Timer;
     int InitIterations;
     bool IsIterationGood;
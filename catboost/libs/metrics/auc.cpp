@@ -1,11 +1,19 @@
 #include "auc.h"
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <catboost/libs/helpers/exception.h>
+
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 
 using NMetrics::TSample;
 
+static constexpr ui32 MinParallelSortBlockSize = 1 << 14;
+
 static double MergeAndCountInversions(TVector<TSample>* samples, TVector<TSample>* aux, ui32 lo, ui32 hi, ui32 mid) {
     double result = 0;
     ui32 left = lo;
@@ -40,10 +48,120 @@ static double SortAndCountInversions(TVector<TSample>* samples, TVector<TSample>
     return leftCount + rightCount + mergeCount;
 }
 
+static ui32 GetSortBlockSize(ui32 sampleCount, NPar::TLocalExecutor* localExecutor) {
+    if (localExecutor == nullptr || localExecutor->GetThreadCount() == 0) {
+        return Max<ui32>(sampleCount, 1);
+    }
+    const ui32 blockCount = localExecutor->GetThreadCount() + 1;
+    return Max(MinParallelSortBlockSize, (sampleCount + blockCount - 1) / blockCount);
+}
+
+// Bottom-up merge sort: sortBlock(lo, hi) sorts blocks in place, then adjacent runs are merged pairwise with
+// mergeRuns(input, output, lo, mid, hi) until one run is left. Both return counts, which are summed in fixed order,
+// so result doesn't depend on thread scheduling.
+template <class TSortBlock, class TMergeRuns>
+static double ParallelMergeSort(
+    TVector<TSample>* samples,
+    TVector<TSample>* aux,
+    NPar::TLocalExecutor* localExecutor,
+    const TSortBlock& sortBlock,
+    const TMergeRuns& mergeRuns
+) {
+    const ui32 sampleCount = samples->size();
+    const ui32 blockSize = GetSortBlockSize(sampleCount, localExecutor);
+    const ui32 blockCount = (sampleCount + blockSize - 1) / blockSize;
+    aux->yresize(sampleCount);
+    if (blockCount <= 1) {
+        return sortBlock(0, sampleCount);
+    }
+
+    TVector<double> counts(blockCount);
+    localExecutor->ExecRangeWithThrow(
+        [&](int blockIdx) {
+            const ui32 lo = blockIdx * blockSize;
+            counts[blockIdx] = sortBlock(lo, Min(lo + blockSize, sampleCount));
+        },
+        0,
+        blockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+    double result = Accumulate(counts, 0.0);
+
+    TVector<TSample>* input = samples;
+    TVector<TSample>* output = aux;
+    for (ui32 runSize = blockSize; runSize < sampleCount; runSize *= 2) {
+        const ui32 pairCount = (sampleCount + 2 * runSize - 1) / (2 * runSize);
+        counts.assign(pairCount, 0.0);
+        localExecutor->ExecRangeWithThrow(
+            [&](int pairIdx) {
+                const ui32 lo = pairIdx * 2 * runSize;
+                const ui32 mid = Min(lo + runSize, sampleCount);
+                const ui32 hi = Min(mid + runSize, sampleCount);
+                if (mid == hi) {
+                    std::copy(input->begin() + lo, input->begin() + hi, output->begin() + lo);
+                } else {
+                    counts[pairIdx] = mergeRuns(input, output, lo, mid, hi);
+                }
+            },
+            0,
+            pairCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+        result += Accumulate(counts, 0.0);
+        DoSwap(input, output);
+    }
+    if (input != samples) {
+        samples->swap(*aux);
+    }
+    return result;
+}
+
+template <class TCompare>
+static void ParallelSort(TVector<TSample>* samples, TVector<TSample>* aux, NPar::TLocalExecutor* localExecutor, const TCompare& compare) {
+    ParallelMergeSort(
+        samples,
+        aux,
+        localExecutor,
+        [&](ui32 lo, ui32 hi) {
+            Sort(samples->begin() + lo, samples->begin() + hi, compare);
+            return 0.0;
+        },
+        [&](TVector<TSample>* input, TVector<TSample>* output, ui32 lo, ui32 mid, ui32 hi) {
+            std::merge(
+                input->begin() + lo, input->begin() + mid,
+                input->begin() + mid, input->begin() + hi,
+                output->begin() + lo,
+                compare);
+            return 0.0;
+        });
+}
+
+static double ParallelSortAndCountInversions(TVector<TSample>* samples, TVector<TSample>* aux, NPar::TLocalExecutor* localExecutor) {
+    return ParallelMergeSort(
+        samples,
+        aux,
+        localExecutor,
+        [&](ui32 lo, ui32 hi) {
+            return SortAndCountInversions(samples, aux, lo, hi);
+        },
+        [](TVector<TSample>* input, TVector<TSample>* output, ui32 lo, ui32 mid, ui32 hi) {
+            return MergeAndCountInversions(input, output, lo, hi, mid);
+        });
+}
+
 double CalcAUC(TVector<TSample>* samples, double* outWeightSum, double* outPairWeightSum) {
+    TVector<TSample> aux;
+    return CalcAUC(samples, &aux, /*localExecutor*/ nullptr, outWeightSum, outPairWeightSum);
+}
+
+double CalcAUC(
+    TVector<TSample>* samples,
+    TVector<TSample>* sortBuffer,
+    NPar::TLocalExecutor* localExecutor,
+    double* outWeightSum,
+    double* outPairWeightSum
+) {
     double weightSum = 0;
     double pairWeightSum = 0;
-    Sort(samples->begin(), samples->end(), [](const TSample& left, const TSample& right) {
+    ParallelSort(samples, sortBuffer, localExecutor, [](const TSample& left, const TSample& right) {
         return left.Target < right.Target;
     });
     double accumulatedWeight = 0;
@@ -64,17 +182,88 @@ double CalcAUC(TVector<TSample>* samples, double* outWeightSum, double* outPairW
     if (pairWeightSum == 0) {
         return 0;
     }
-    TVector<TSample> aux(samples->begin(), samples->end());
-    Sort(samples->begin(), samples->end(), [](const TSample& left, const TSample& right) {
+    ParallelSort(samples, sortBuffer, localExecutor, [](const TSample& left, const TSample& right) {
         return left.Prediction < right.Prediction ||
                left.Prediction == right.Prediction && left.Target < right.Target;
     });
-    auto optimisticAUC = 1 - SortAndCountInversions(samples, &aux, 0, samples->size()) / pairWeightSum;
-    Sort(samples->begin(), samples->end(), [](const TSample& left, const TSample& right) {
+    auto optimisticAUC = 1 - ParallelSortAndCountInversions(samples, sortBuffer, localExecutor) / pairWeightSum;
+    ParallelSort(samples, sortBuffer, localExecutor, [](const TSample& left, const TSample& right) {
         return left.Prediction < right.Prediction ||
                left.Prediction == right.Prediction && left.Target > right.Target;
     });
-    auto pessimisticAUC = 1 - SortAndCountInversions(samples, &aux, 0, samples->size()) / pairWeightSum;
+    auto pessimisticAUC = 1 - ParallelSortAndCountInversions(samples, sortBuffer, localExecutor) / pairWeightSum;
     return (optimisticAUC + pessimisticAUC) / 2.0;
 }
 
+double CalcApproxAUC(TConstArrayRef<TSample> samples, ui32 binCount, NPar::TLocalExecutor* localExecutor) {
+    CB_ENSURE(binCount > 0, "AUC approximation needs at least one bin");
+    if (samples.empty()) {
+        return 0;
+    }
+    const int blockCount = localExecutor == nullptr ? 1 : localExecutor->GetThreadCount() + 1;
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, samples.size());
+    blockParams.SetBlockCount(blockCount);
+    const auto parallelFor = [&](const auto& func) {
+        if (blockParams.GetBlockCount() == 1) {
+            func(0);
+        } else {
+            localExecutor->ExecRangeWithThrow(func, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+        }
+    };
+
+    TVector<std::pair<double, double>> blockMinMax(blockParams.GetBlockCount());
+    parallelFor([&](int blockIdx) {
+        const int begin = blockIdx * blockParams.GetBlockSize();
+        const int end = Min<int>(begin + blockParams.GetBlockSize(), samples.size());
+        const auto minMax = std::minmax_element(
+            samples.begin() + begin,
+            samples.begin() + end,
+            [](const TSample& left, const TSample& right) {
+                return left.Prediction < right.Prediction;
+            });
+        blockMinMax[blockIdx] = {minMax.first->Prediction, minMax.second->Prediction};
+    });
+    double minPrediction = blockMinMax[0].first;
+    double maxPrediction = blockMinMax[0].second;
+    for (const auto& minMax : blockMinMax) {
+        minPrediction = Min(minPrediction, minMax.first);
+        maxPrediction = Max(maxPrediction, minMax.second);
+    }
+    const double scale = maxPrediction > minPrediction ? binCount / (maxPrediction - minPrediction) : 0;
+
+    // per block histograms of positive and negative weights, reduced in block order
+    TVector<TVector<double>> blockHistograms(blockParams.GetBlockCount());
+    parallelFor([&](int blockIdx) {
+        auto& histogram = blockHistograms[blockIdx];
+        histogram.assign(2 * binCount, 0);
+        const int begin = blockIdx * blockParams.GetBlockSize();
+        const int end = Min<int>(begin + blockParams.GetBlockSize(), samples.size());
+        for (int i : xrange(begin, end)) {
+            const TSample& sample = samples[i];
+            const ui32 bin = Min<ui32>(binCount - 1, (sample.Prediction - minPrediction) * scale);
+            histogram[2 * bin + (sample.Target > 0)] += sample.Weight;
+        }
+    });
+    TVector<double> histogram(2 * binCount, 0);
+    for (const auto& blockHistogram : blockHistograms) {
+        for (ui32 i : xrange(histogram.size())) {
+            histogram[i] += blockHistogram[i];
+        }
+    }
+
+    double negativeWeightSum = 0;
+    double positiveWeightSum = 0;
+    double orderedPairWeightSum = 0;
+    for (ui32 bin : xrange(binCount)) {
+        const double negativeWeight = histogram[2 * bin];
+        const double positiveWeight = histogram[2 * bin + 1];
+        orderedPairWeightSum += positiveWeight * (negativeWeightSum + negativeWeight / 2);
+        negativeWeightSum += negativeWeight;
+        positiveWeightSum += positiveWeight;
+    }
+    const double pairWeightSum = negativeWeightSum * positiveWeightSum;
+    if (pairWeightSum == 0) {
+        return 0;
+    }
+    return orderedPairWeightSum / pairWeightSum;
+}
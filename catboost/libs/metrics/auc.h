@@ -2,4 +2,30 @@
 
 #include "sample.h"
 
+#include <util/generic/fwd.h>
+#include <util/system/types.h>
+
+namespace NPar {
+    class TLocalExecutor;
+}
+
 double CalcAUC(TVector<NMetrics::TSample>* samples, double* outWeightSum = nullptr, double* outPairWeightSum = nullptr);
+
+/**
+ * Exact AUC with sorting and inversion counting split into blocks processed by localExecutor.
+ * sortBuffer is resized to samples->size() and can be reused between calls to avoid reallocations.
+ * samples are reordered.
+ */
+double CalcAUC(
+    TVector<NMetrics::TSample>* samples,
+    TVector<NMetrics::TSample>* sortBuffer,
+    NPar::TLocalExecutor* localExecutor,
+    double* outWeightSum = nullptr,
+    double* outPairWeightSum = nullptr);
+
+/**
+ * Approximate AUC for binary targets (samples with Target > 0 are positive) without sorting:
+ * predictions are bucketed into binCount equal-width bins between min and max prediction,
+ * pairs of samples in the same bin are counted as ties.
+ */
+double CalcApproxAUC(TConstArrayRef<NMetrics::TSample> samples, ui32 binCount, NPar::TLocalExecutor* localExecutor);
@@ -27,6 +27,7 @@
 #include <util/string/cast.h>
 #include <util/string/iterator.h>
 #include <util/string/printf.h>
+#include <util/system/mutex.h>
 #include <util/system/yassert.h>
 
 #include <limits>
@@ -1980,14 +1981,16 @@ void TR2Metric::GetBestValue(EMetricBestValue* valueType, float*) const {
 
 namespace {
     struct TAUCMetric: public TNonAdditiveMetric {
-        explicit TAUCMetric(double border = GetDefaultClassificationBorder())
-                : Border(border) {
+        explicit TAUCMetric(double border, ui32 approxBinCount)
+                : Border(border)
+                , ApproxBinCount("approx_bins", approxBinCount, approxBinCount != 0) {
             UseWeights.SetDefaultValue(false);
         }
 
-        explicit TAUCMetric(int positiveClass)
+        TAUCMetric(int positiveClass, ui32 approxBinCount)
             : PositiveClass(positiveClass)
-            , IsMultiClass(true) {
+            , IsMultiClass(true)
+            , ApproxBinCount("approx_bins", approxBinCount, approxBinCount != 0) {
         }
 
         TMetricHolder Eval(
@@ -2017,15 +2020,22 @@ namespace {
         int PositiveClass = 1;
         bool IsMultiClass = false;
         double Border = GetDefaultClassificationBorder();
+        // 0 means exact AUC
+        TMetricParam<ui32> ApproxBinCount;
+
+        // AUC is evaluated every iteration on the same eval set, so sort buffers are kept between calls
+        mutable TMutex BuffersLock;
+        mutable TVector<NMetrics::TSample> Samples;
+        mutable TVector<NMetrics::TSample> SortBuffer;
     };
 }
 
-THolder<IMetric> MakeBinClassAucMetric(double border) {
-    return MakeHolder<TAUCMetric>(border);
+THolder<IMetric> MakeBinClassAucMetric(double border, ui32 approxBinCount) {
+    return MakeHolder<TAUCMetric>(border, approxBinCount);
 }
 
-THolder<IMetric> MakeMultiClassAucMetric(int positiveClass) {
-    return MakeHolder<TAUCMetric>(positiveClass);
+THolder<IMetric> MakeMultiClassAucMetric(int positiveClass, ui32 approxBinCount) {
+    return MakeHolder<TAUCMetric>(positiveClass, approxBinCount);
 }
 
 TMetricHolder TAUCMetric::Eval(
@@ -2037,7 +2047,7 @@ TMetricHolder TAUCMetric::Eval(
     TConstArrayRef<TQueryInfo> /*queriesInfo*/,
     int begin,
     int end,
-    NPar::TLocalExecutor& /* executor */
+    NPar::TLocalExecutor& executor
 ) const {
     Y_ASSERT(!isExpApprox);
     Y_ASSERT((approx.size() > 1) == IsMultiClass);
@@ -2045,37 +2055,25 @@ TMetricHolder TAUCMetric::Eval(
     Y_ASSERT(approxVec.size() == target.size());
     auto weight = UseWeights ? weightIn : TConstArrayRef<float>{};
 
-    TVector<double> approxCopy(approxVec.begin() + begin, approxVec.begin() + end);
-    if (!approxDelta.empty()) {
-        for (int idx : xrange(begin, end)) {
-            approxCopy[idx - begin] += approxDelta[0][idx];
-        }
-    }
-    TVector<double> targetCopy(target.begin() + begin, target.begin() + end);
-
-    if (!IsMultiClass) {
-        for (ui32 i = 0; i < targetCopy.size(); ++i) {
-            targetCopy[i] = targetCopy[i] > Border;
+    TGuard<TMutex> guard(BuffersLock);
+    Samples.yresize(end - begin);
+    NPar::ParallelFor(executor, begin, end, [&](int idx) {
+        double targetValue = target[idx];
+        if (!IsMultiClass) {
+            targetValue = targetValue > Border;
+        } else {
+            targetValue = (targetValue == static_cast<double>(PositiveClass));
         }
-    }
+        const double prediction = approxVec[idx] + (approxDelta.empty() ? 0.0 : approxDelta[0][idx]);
+        Samples[idx - begin] = NMetrics::TSample(targetValue, prediction, weight.empty() ? 1.0 : weight[idx]);
+    });
 
-    if (approx.ysize() > 1) {
-        int positiveClass = PositiveClass;
-        ForEach(targetCopy.begin(), targetCopy.end(), [positiveClass](double& x) {
-            x = (x == static_cast<double>(positiveClass));
-        });
-    }
-
-    TVector<NMetrics::TSample> samples;
-    if (weight.empty()) {
-        samples = NMetrics::TSample::FromVectors(targetCopy, approxCopy);
+    TMetricHolder error(2);
+    if (ApproxBinCount.Get() != 0) {
+        error.Stats[0] = CalcApproxAUC(Samples, ApproxBinCount.Get(), &executor);
     } else {
-        TVector<double> weightCopy(weight.begin() + begin, weight.begin() + end);
-        samples = NMetrics::TSample::FromVectors(targetCopy, approxCopy, weightCopy);
+        error.Stats[0] = CalcAUC(&Samples, &SortBuffer, &executor);
     }
-
-    TMetricHolder error(2);
-    error.Stats[0] = CalcAUC(&samples);
     error.Stats[1] = 1.0;
     return error;
 }
@@ -2083,9 +2081,9 @@ TMetricHolder TAUCMetric::Eval(
 TString TAUCMetric::GetDescription() const {
     if (IsMultiClass) {
         const TMetricParam<int> positiveClass("class", PositiveClass, /*userDefined*/true);
-        return BuildDescription(ELossFunction::AUC, UseWeights, positiveClass);
+        return BuildDescription(ELossFunction::AUC, UseWeights, positiveClass, ApproxBinCount);
     } else {
-        return BuildDescription(ELossFunction::AUC, UseWeights, "%.3g", MakeBorderParam(Border));
+        return BuildDescription(ELossFunction::AUC, UseWeights, "%.3g", MakeBorderParam(Border), ApproxBinCount);
     }
 }
 
@@ -4076,13 +4074,15 @@ static TVector<THolder<IMetric>> CreateMetric(ELossFunction metric, TMap<TString
             break;
         }
         case ELossFunction::AUC: {
+            const ui32 approxBinCount = params.contains("approx_bins") ? FromString<ui32>(params.at("approx_bins")) : 0;
             if (approxDimension == 1) {
-                result.push_back(MakeBinClassAucMetric(border));
-                validParams = {"border"};
+                result.push_back(MakeBinClassAucMetric(border, approxBinCount));
+                validParams = {"border", "approx_bins"};
             } else {
                 for (int i = 0; i < approxDimension; ++i) {
-                    result.push_back(MakeMultiClassAucMetric(i));
+                    result.push_back(MakeMultiClassAucMetric(i, approxBinCount));
                 }
+                validParams = {"approx_bins"};
             }
             break;
         }
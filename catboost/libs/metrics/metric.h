@@ -10,6 +10,7 @@
 #include <catboost/libs/options/loss_description.h>
 #include <catboost/libs/options/metric_options.h>
 
+#include <library/chromium_trace/interface.h>
 #include <library/threading/local_executor/local_executor.h>
 #include <library/containers/2d_array/2d_array.h>
 
@@ -181,6 +182,7 @@ struct TAdditiveMetric: public TMetric {
         TVector<TMetricHolder> results(blockCount);
 #endif
         NPar::ParallelFor(executor, 0, blockCount, [&](int blockId) {
+            CHROMIUM_TRACE_SCOPE("Eval metric block");
             const int from = begin + blockId * blockSize;
             const int to = Min<int>(begin + (blockId + 1) * blockSize, end);
             Y_ASSERT(from < to);
@@ -258,8 +260,8 @@ THolder<IMetric> MakeNdcgMetric(int topSize = -1, ENdcgMetricType type = ENdcgMe
 
 THolder<IMetric> MakeQuerySoftMaxMetric();
 
-THolder<IMetric> MakeBinClassAucMetric(double border = GetDefaultClassificationBorder());
-THolder<IMetric> MakeMultiClassAucMetric(int positiveClass);
+THolder<IMetric> MakeBinClassAucMetric(double border = GetDefaultClassificationBorder(), ui32 approxBinCount = 0);
+THolder<IMetric> MakeMultiClassAucMetric(int positiveClass, ui32 approxBinCount = 0);
 
 THolder<IMetric> MakeAccuracyMetric(double border = GetDefaultClassificationBorder());
 
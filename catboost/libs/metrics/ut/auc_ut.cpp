@@ -0,0 +1,73 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/metrics/auc.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+
+
+static TVector<NMetrics::TSample> GenerateSamples(ui32 sampleCount, ui32 predictionValueCount, ui64 seed) {
+    TFastRng64 rng(seed);
+    TVector<NMetrics::TSample> samples;
+    for (ui32 i = 0; i < sampleCount; ++i) {
+        const double target = rng.Uniform(2);
+        // few distinct predictions to have many ties
+        const double prediction = rng.Uniform(predictionValueCount) + target * 0.3 * predictionValueCount;
+        samples.emplace_back(target, prediction, 1 + rng.Uniform(3));
+    }
+    return samples;
+}
+
+Y_UNIT_TEST_SUITE(AUCMetricTest) {
+Y_UNIT_TEST(ParallelAUCTest) {
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(3);
+    TVector<NMetrics::TSample> sortBuffer;
+    for (ui32 sampleCount : {0, 1, 100, 100000, 300001}) {
+        const auto samples = GenerateSamples(sampleCount, 1000, sampleCount);
+
+        auto serialSamples = samples;
+        double serialWeightSum = 0;
+        double serialPairWeightSum = 0;
+        const double serialAUC = CalcAUC(&serialSamples, &serialWeightSum, &serialPairWeightSum);
+
+        auto parallelSamples = samples;
+        double parallelWeightSum = 0;
+        double parallelPairWeightSum = 0;
+        const double parallelAUC = CalcAUC(&parallelSamples, &sortBuffer, &executor, &parallelWeightSum, &parallelPairWeightSum);
+
+        // integer weights, so all sums are exact
+        UNIT_ASSERT_VALUES_EQUAL(serialAUC, parallelAUC);
+        UNIT_ASSERT_VALUES_EQUAL(serialWeightSum, parallelWeightSum);
+        UNIT_ASSERT_VALUES_EQUAL(serialPairWeightSum, parallelPairWeightSum);
+    }
+}
+
+Y_UNIT_TEST(ApproxAUCTest) {
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(3);
+    auto samples = GenerateSamples(100000, 100, 0);
+    const double approxAUC = CalcApproxAUC(samples, 10000, &executor);
+    UNIT_ASSERT_VALUES_EQUAL(approxAUC, CalcApproxAUC(samples, 10000, nullptr));
+    // bins are narrower than distance between distinct predictions, so ties are the same as in exact AUC
+    UNIT_ASSERT_DOUBLES_EQUAL(approxAUC, CalcAUC(&samples), 1e-9);
+}
+
+Y_UNIT_TEST(AUCMetricDescriptionTest) {
+    TVector<TVector<double>> approx{{0.1, 0.4, 0.35, 0.8}};
+    TVector<float> target{0, 0, 1, 1};
+    TVector<float> weight{1, 1, 1, 1};
+
+    NPar::TLocalExecutor executor;
+    for (ui32 approxBinCount : {0, 16}) {
+        const auto metric = MakeBinClassAucMetric(GetDefaultClassificationBorder(), approxBinCount);
+        TMetricHolder score = metric->Eval(approx, target, weight, {}, 0, target.size(), executor);
+        UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(score), 0.75, 1e-9);
+    }
+    UNIT_ASSERT_VALUES_EQUAL(MakeBinClassAucMetric(GetDefaultClassificationBorder(), 16)->GetDescription(), "AUC:approx_bins=16");
+}
+}
@@ -0,0 +1,189 @@
+#include <catboost/libs/model/evaluation_isa.h>
+#include <catboost/libs/model/formula_evaluator.h>
+#include <catboost/libs/model/model.h>
+
+#include <library/testing/benchmark/bench.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+/*
+ * Evaluation of a synthetic 2000 trees model split by stage and by instruction set.
+ * Benchmarks for instruction sets not supported by current CPU do nothing.
+ */
+
+namespace {
+    constexpr ui32 FeatureCount = 100;
+    constexpr ui32 BorderCount = 64;
+    constexpr ui32 TreeCount = 2000;
+    constexpr ui32 TreeDepth = 6;
+    constexpr size_t DocCount = FORMULA_EVALUATION_BLOCK_SIZE * 8;
+
+    struct TBenchmarkData {
+        TFullModel Model;
+        TVector<TVector<float>> Features;
+        TVector<TConstArrayRef<float>> FeatureRefs;
+        TVector<ui8> BinFeatures;
+
+        TBenchmarkData() {
+            TFastRng64 rng(0);
+            for (ui32 featureIdx : xrange(FeatureCount)) {
+                TFloatFeature feature(false, featureIdx, featureIdx, {});
+                for (ui32 borderIdx : xrange(BorderCount)) {
+                    feature.Borders.push_back((float)borderIdx / BorderCount);
+                }
+                Model.ObliviousTrees.FloatFeatures.push_back(std::move(feature));
+            }
+            for (ui32 treeIdx = 0; treeIdx < TreeCount; ++treeIdx) {
+                Y_UNUSED(treeIdx);
+                TVector<int> tree;
+                for (ui32 level = 0; level < TreeDepth; ++level) {
+                    tree.push_back(rng.Uniform(FeatureCount * BorderCount));
+                }
+                Model.ObliviousTrees.AddBinTree(tree);
+                for (ui32 leaf = 0; leaf < (1u << TreeDepth); ++leaf) {
+                    Model.ObliviousTrees.LeafValues.push_back(rng.GenRandReal1());
+                }
+            }
+            Model.UpdateDynamicData();
+
+            Features.resize(DocCount, TVector<float>(FeatureCount));
+            for (auto& doc : Features) {
+                for (auto& value : doc) {
+                    value = rng.GenRandReal1();
+                }
+            }
+            FeatureRefs.assign(Features.begin(), Features.end());
+
+            BinFeatures.resize(Model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() * FORMULA_EVALUATION_BLOCK_SIZE);
+            for (auto& bin : BinFeatures) {
+                bin = rng.Uniform(BorderCount + 1);
+            }
+        }
+    };
+
+    class TIsaGuard {
+    public:
+        explicit TIsaGuard(EEvaluationIsa isa)
+            : PrevIsa(GetEvaluationIsa())
+            , Supported(IsEvaluationIsaSupported(isa))
+        {
+            if (Supported) {
+                SetEvaluationIsa(isa);
+            }
+        }
+
+        ~TIsaGuard() {
+            SetEvaluationIsa(PrevIsa);
+        }
+
+        bool IsSupported() const {
+            return Supported;
+        }
+
+    private:
+        EEvaluationIsa PrevIsa;
+        bool Supported;
+    };
+}
+
+static void BenchmarkBinarization(EEvaluationIsa isa, const NBench::NCpu::TParams& iface) {
+    TIsaGuard isaGuard(isa);
+    if (!isaGuard.IsSupported()) {
+        return;
+    }
+    const auto& data = *Singleton<TBenchmarkData>();
+    const auto& features = data.FeatureRefs;
+    TVector<ui8> result(data.Model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() * FORMULA_EVALUATION_BLOCK_SIZE);
+    TVector<ui32> transposedHash;
+    TVector<float> ctrs;
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        const size_t blockStart = (iteration % (DocCount / FORMULA_EVALUATION_BLOCK_SIZE)) * FORMULA_EVALUATION_BLOCK_SIZE;
+        BinarizeFeatures(
+            data.Model,
+            [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+                return features[index][floatFeature.FlatFeatureIndex];
+            },
+            [](const TCatFeature&, size_t) -> int {
+                return 0;
+            },
+            blockStart,
+            blockStart + FORMULA_EVALUATION_BLOCK_SIZE,
+            result,
+            transposedHash,
+            ctrs);
+        Y_DO_NOT_OPTIMIZE_AWAY(result.data());
+    }
+}
+
+static void BenchmarkCalcIndexes(EEvaluationIsa isa, const NBench::NCpu::TParams& iface) {
+    TIsaGuard isaGuard(isa);
+    if (!isaGuard.IsSupported()) {
+        return;
+    }
+    const auto& data = *Singleton<TBenchmarkData>();
+    const auto& trees = data.Model.ObliviousTrees;
+    TVector<ui32> indexes(FORMULA_EVALUATION_BLOCK_SIZE);
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        const size_t treeId = iteration % TreeCount;
+        CalcIndexes(
+            /*needXorMask*/ false,
+            data.BinFeatures.data(),
+            FORMULA_EVALUATION_BLOCK_SIZE,
+            indexes.data(),
+            trees.GetRepackedBins().data() + trees.TreeStartOffsets[treeId],
+            trees.TreeSizes[treeId]);
+        Y_DO_NOT_OPTIMIZE_AWAY(indexes.data());
+    }
+}
+
+static void BenchmarkCalcFlat(EEvaluationIsa isa, const NBench::NCpu::TParams& iface) {
+    TIsaGuard isaGuard(isa);
+    if (!isaGuard.IsSupported()) {
+        return;
+    }
+    const auto& data = *Singleton<TBenchmarkData>();
+    TVector<double> result(DocCount);
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        data.Model.CalcFlat(data.FeatureRefs, result);
+        Y_DO_NOT_OPTIMIZE_AWAY(result.data());
+    }
+}
+
+Y_CPU_BENCHMARK(BinarizeFeaturesDefault, iface) {
+    BenchmarkBinarization(EEvaluationIsa::Default, iface);
+}
+
+Y_CPU_BENCHMARK(BinarizeFeaturesAvx2, iface) {
+    BenchmarkBinarization(EEvaluationIsa::Avx2, iface);
+}
+
+Y_CPU_BENCHMARK(BinarizeFeaturesAvx512, iface) {
+    BenchmarkBinarization(EEvaluationIsa::Avx512, iface);
+}
+
+Y_CPU_BENCHMARK(CalcIndexesDefault, iface) {
+    BenchmarkCalcIndexes(EEvaluationIsa::Default, iface);
+}
+
+Y_CPU_BENCHMARK(CalcIndexesAvx2, iface) {
+    BenchmarkCalcIndexes(EEvaluationIsa::Avx2, iface);
+}
+
+Y_CPU_BENCHMARK(CalcIndexesAvx512, iface) {
+    BenchmarkCalcIndexes(EEvaluationIsa::Avx512, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlatDefault, iface) {
+    BenchmarkCalcFlat(EEvaluationIsa::Default, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlatAvx2, iface) {
+    BenchmarkCalcFlat(EEvaluationIsa::Avx2, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlatAvx512, iface) {
+    BenchmarkCalcFlat(EEvaluationIsa::Avx512, iface);
+}
@@ -3,6 +3,7 @@
 #include <catboost/libs/helpers/exception.h>
 
 #include <util/generic/set.h>
+#include <util/stream/mem.h>
 
 
 void TCtrData::Save(IOutputStream* s) const {
@@ -30,3 +31,15 @@ void TCtrData::Load(IInputStream* s) {
         LearnCtrs[ctrBase] = std::move(table);
     }
 }
+
+void TCtrData::LoadThin(TMemoryInput* s) {
+    const size_t cnt = ::LoadSize(s);
+    LearnCtrs.reserve(cnt);
+
+    for (size_t i = 0; i != cnt; ++i) {
+        TCtrValueTable table;
+        table.LoadThin(s);
+        TModelCtrBase ctrBase = table.ModelCtrBase;
+        LearnCtrs[ctrBase] = std::move(table);
+    }
+}
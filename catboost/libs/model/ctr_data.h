@@ -27,6 +27,9 @@ public:
     void Save(IOutputStream* s) const;
 
     void Load(IInputStream* s);
+
+    // tables are loaded as views into memory of `s`, see TCtrValueTable::LoadThin
+    void LoadThin(TMemoryInput* s);
 };
 
 class TCtrDataStreamWriter {
@@ -2,11 +2,13 @@
 
 #include "flatbuffers_serializer_helper.h"
 
+#include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/flatbuffers/model.fbs.h>
 
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/stream/input.h>
+#include <util/stream/mem.h>
 #include <util/stream/output.h>
 #include <util/system/compiler.h>
 #include <util/ysaveload.h>
@@ -69,3 +71,30 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     solid.CTRBlob.assign(ctrValueTable->CTRBlob()->data(),
                          ctrValueTable->CTRBlob()->data() + ctrValueTable->CTRBlob()->size());
 }
+
+void TCtrValueTable::LoadThin(TMemoryInput* in) {
+    const ui32 size = LoadSize(in);
+    CB_ENSURE(in->Avail() >= size, "Ctr value table is truncated");
+    const ui8* buf = reinterpret_cast<const ui8*>(in->Buf());
+    in->Skip(size);
+    {
+        flatbuffers::Verifier verifier(buf, size);
+        CB_ENSURE(NCatBoostFbs::VerifyTCtrValueTableBuffer(verifier), "Flatbuffers ctr value table verification failed");
+    }
+    auto ctrValueTable = flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(buf);
+    // TBucket is packed, but blob is read as 4-byte counters, and flatbuffers aligns vectors only
+    // relative to the table buffer, which may start at any offset within the model; copy in this case
+    if (reinterpret_cast<uintptr_t>(ctrValueTable->CTRBlob()->data()) % alignof(ui32) != 0) {
+        LoadSolid(const_cast<ui8*>(buf), size);
+        return;
+    }
+    Impl = TThinTable();
+    auto& thin = Get<TThinTable>(Impl);
+    ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
+    CounterDenominator = ctrValueTable->CounterDenominator();
+    TargetClassesCount = ctrValueTable->TargetClassesCount();
+    thin.IndexBuckets = MakeArrayRef(
+        reinterpret_cast<const NCatboost::TBucket*>(ctrValueTable->IndexHashRaw()->data()),
+        ctrValueTable->IndexHashRaw()->size() / sizeof(NCatboost::TBucket));
+    thin.CTRBlob = MakeArrayRef(ctrValueTable->CTRBlob()->data(), ctrValueTable->CTRBlob()->size());
+}
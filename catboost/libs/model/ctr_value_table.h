@@ -101,6 +101,12 @@ public:
 
     void LoadSolid(void* buf, size_t length);
 
+    /**
+     * Load table as a view into memory of `in`, no data is copied unless counters blob is misaligned.
+     * Memory must outlive this table and all its copies.
+     */
+    void LoadThin(TMemoryInput* in);
+
 public:
     TModelCtrBase ModelCtrBase;
     int CounterDenominator = 0;
@@ -0,0 +1,39 @@
+#include "evaluation_isa.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/system/cpu_id.h>
+#include <util/system/platform.h>
+
+#include <atomic>
+
+
+static std::atomic<EEvaluationIsa>& ActiveEvaluationIsa() {
+    static std::atomic<EEvaluationIsa> isa(GetBestSupportedEvaluationIsa());
+    return isa;
+}
+
+EEvaluationIsa GetBestSupportedEvaluationIsa() {
+#ifdef _sse2_
+    if (NX86::CachedHaveAVX512F() && NX86::CachedHaveAVX512BW()) {
+        return EEvaluationIsa::Avx512;
+    }
+    if (NX86::CachedHaveAVX() && NX86::CachedHaveAVX2()) {
+        return EEvaluationIsa::Avx2;
+    }
+#endif
+    return EEvaluationIsa::Default;
+}
+
+bool IsEvaluationIsaSupported(EEvaluationIsa isa) {
+    return static_cast<int>(isa) <= static_cast<int>(GetBestSupportedEvaluationIsa());
+}
+
+EEvaluationIsa GetEvaluationIsa() {
+    return ActiveEvaluationIsa().load(std::memory_order_relaxed);
+}
+
+void SetEvaluationIsa(EEvaluationIsa isa) {
+    CB_ENSURE(IsEvaluationIsaSupported(isa), "Instruction set " << isa << " is not supported by this CPU");
+    ActiveEvaluationIsa().store(isa, std::memory_order_relaxed);
+}
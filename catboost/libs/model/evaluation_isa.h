@@ -0,0 +1,88 @@
+#pragma once
+
+#include "repacked_bin.h"
+
+#include <util/system/types.h>
+
+#include <stddef.h>
+
+
+/**
+ * Instruction set used by model evaluation kernels (binarization and tree index calculation).
+ * Default means kernels selected at compile time (SSE2 on x86, plain C++ elsewhere), wider
+ * kernels are selected at runtime via CPUID and produce bit-identical results.
+ */
+enum class EEvaluationIsa {
+    Default /* "Default" */,
+    Avx2    /* "AVX2" */,
+    Avx512  /* "AVX512" */
+};
+
+EEvaluationIsa GetBestSupportedEvaluationIsa();
+
+bool IsEvaluationIsaSupported(EEvaluationIsa isa);
+
+EEvaluationIsa GetEvaluationIsa();
+
+/**
+ * Override runtime dispatch, e.g. to compare kernels in benchmarks and tests.
+ * Throws if isa is not supported by current CPU.
+ */
+void SetEvaluationIsa(EEvaluationIsa isa);
+
+/**
+ * Wide kernels. These are compiled with AVX2/AVX-512 codegen flags in separate translation units,
+ * so they only take raw pointers to avoid instantiating shared inline code with wider instructions.
+ * Kernels are available only in SSE2-enabled (x86) builds.
+ *
+ * BinarizeFloats*: adds binarized values for one bucket (at most MAX_VALUES_PER_BIN borders) to `result`,
+ * `values` must be already NaN-substituted.
+ *
+ * CalcIndexes*: ORs tree leaf indexes into `indexesVec`, supports trees with depth <= 16.
+ * CalcIndexesShallow*: ORs ui8 tree leaf indexes into `indexesVec`, supports trees with depth <= 8.
+ */
+void BinarizeFloatsAvx2(
+    const float* __restrict values,
+    size_t docCount,
+    const float* __restrict borders,
+    size_t borderCount,
+    ui8* __restrict result);
+
+void BinarizeFloatsAvx512(
+    const float* __restrict values,
+    size_t docCount,
+    const float* __restrict borders,
+    size_t borderCount,
+    ui8* __restrict result);
+
+void CalcIndexesAvx2(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui32* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize);
+
+void CalcIndexesAvx512(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui32* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize);
+
+void CalcIndexesShallowAvx2(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize);
+
+void CalcIndexesShallowAvx512(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize);
@@ -76,7 +76,20 @@ void CalcIndexes(
     ui32* __restrict indexesVec,
     const TRepackedBin* __restrict treeSplitsCurPtr,
     int curTreeSize) {
-    // TODO(kirillovs): add sse dispatching here
+#ifdef _sse2_
+    if (curTreeSize <= 16) {
+        switch (GetEvaluationIsa()) {
+            case EEvaluationIsa::Avx512:
+                CalcIndexesAvx512(needXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+                return;
+            case EEvaluationIsa::Avx2:
+                CalcIndexesAvx2(needXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+                return;
+            case EEvaluationIsa::Default:
+                break;
+        }
+    }
+#endif
     if (needXorMask) {
         CalcIndexesBasic<true, 0>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
     } else {
@@ -181,6 +194,27 @@ static void CalcIndexesSse(
     }
 }
 
+template <bool NeedXorMask, size_t SSEBlockCount>
+Y_FORCE_INLINE void CalcIndexesShallow(
+    EEvaluationIsa isa,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    const int curTreeSize) {
+    switch (isa) {
+        case EEvaluationIsa::Avx512:
+            CalcIndexesShallowAvx512(NeedXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            break;
+        case EEvaluationIsa::Avx2:
+            CalcIndexesShallowAvx2(NeedXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            break;
+        case EEvaluationIsa::Default:
+            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            break;
+    }
+}
+
 #endif
 
 template <typename TIndexType>
@@ -303,6 +337,7 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
     const auto treeLeafPtr = model.ObliviousTrees.LeafValues.data();
     auto firstLeafOffsetsPtr = model.ObliviousTrees.GetFirstLeafOffsets().data();
 #ifdef _sse2_
+    const EEvaluationIsa isa = GetEvaluationIsa();
     bool allTreesAreShallow = AllOf(
             model.ObliviousTrees.TreeSizes.begin() + treeStart,
             model.ObliviousTrees.TreeSizes.begin() + treeEnd,
@@ -324,13 +359,13 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
         auto treeEnd4 = treeStart + (((treeEnd - treeStart) | 0x3) ^ 0x3);
         for (size_t treeId = treeStart; treeId < treeEnd4; treeId += 4) {
             memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId]);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(isa, binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 1]);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(isa, binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 1]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 1];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 2]);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(isa, binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 2]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 2];
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 3]);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(isa, binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3, treeSplitsCurPtr, model.ObliviousTrees.TreeSizes[treeId + 3]);
             treeSplitsCurPtr += model.ObliviousTrees.TreeSizes[treeId + 3];
 
             CalculateLeafValues4<SSEBlockCount>(
@@ -357,7 +392,7 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
         memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
 #ifdef _sse2_
         if (curTreeSize <= 8) {
-            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            CalcIndexesShallow<NeedXorMask, SSEBlockCount>(isa, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
             if (IsSingleClassModel) { // single class model
                 CalculateLeafValues(docCountInBlock, treeLeafPtr + firstLeafOffsetsPtr[treeId], indexesVec, resultsPtr);
             } else { // multiclass model
@@ -367,7 +402,7 @@ Y_FORCE_INLINE void CalcTreesBlockedImpl(
 #else
         {
 #endif
-            CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVecUI32, treeSplitsCurPtr, curTreeSize);
+            CalcIndexes(NeedXorMask, binFeatures, docCountInBlock, indexesVecUI32, treeSplitsCurPtr, curTreeSize);
             if (IsSingleClassModel) { // single class model
                 CalculateLeafValues(docCountInBlock, treeLeafPtr + firstLeafOffsetsPtr[treeId], indexesVecUI32, resultsPtr);
             } else { // multiclass model
@@ -464,8 +499,116 @@ inline void CalcTreesSingleDocImpl(
     }
 }
 
+template <bool IsSingleClassModel, bool NeedXorMask>
+inline void CalcNonSymmetricTreesBlocked(
+    const TFullModel& model,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    TCalcerIndexType* __restrict indexesVec,
+    size_t treeStart,
+    size_t treeEnd,
+    double* __restrict resultsPtr)
+{
+    const auto& trees = model.ObliviousTrees;
+    const TRepackedBin* __restrict repackedBins = trees.GetRepackedBins().data();
+    const TNonSymmetricTreeStepNode* __restrict stepNodes = trees.NonSymmetricStepNodes.data();
+    const ui32* __restrict nodeIdToLeafId = trees.NonSymmetricNodeIdToLeafId.data();
+    const auto& treeDepths = trees.GetNonSymmetricTreeDepths();
+    const int approxDimension = trees.ApproxDimension;
+    for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+        std::fill(indexesVec, indexesVec + docCountInBlock, trees.TreeStartOffsets[treeId]);
+        // all documents descend one level per pass, leaf nodes have zero diffs and keep documents in place
+        for (int depth = 0; depth < treeDepths[treeId]; ++depth) {
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                const TCalcerIndexType nodeIdx = indexesVec[docId];
+                const TRepackedBin split = repackedBins[nodeIdx];
+                ui8 featureValue = binFeatures[split.FeatureIndex * docCountInBlock + docId];
+                if (NeedXorMask) {
+                    featureValue ^= split.XorMask;
+                }
+                const TNonSymmetricTreeStepNode stepNode = stepNodes[nodeIdx];
+                indexesVec[docId] = nodeIdx + (featureValue >= split.SplitIdx ? stepNode.RightSubtreeDiff : stepNode.LeftSubtreeDiff);
+            }
+        }
+        const double* treeLeafPtr = trees.GetFirstLeafPtrForTree(treeId);
+        if (IsSingleClassModel) { // single class model
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                resultsPtr[docId] += treeLeafPtr[nodeIdToLeafId[indexesVec[docId]]];
+            }
+        } else { // multiclass model
+            auto resultWritePtr = resultsPtr;
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                const double* leafValuePtr = treeLeafPtr + nodeIdToLeafId[indexesVec[docId]] * approxDimension;
+                for (int classId = 0; classId < approxDimension; ++classId) {
+                    resultWritePtr[classId] += leafValuePtr[classId];
+                }
+                resultWritePtr += approxDimension;
+            }
+        }
+    }
+}
+
+template <bool IsSingleClassModel, bool NeedXorMask>
+inline void CalcNonSymmetricTreesSingleDocImpl(
+    const TFullModel& model,
+    const ui8* __restrict binFeatures,
+    size_t,
+    TCalcerIndexType* __restrict,
+    size_t treeStart,
+    size_t treeEnd,
+    double* __restrict results)
+{
+    const auto& trees = model.ObliviousTrees;
+    const TRepackedBin* __restrict repackedBins = trees.GetRepackedBins().data();
+    const TNonSymmetricTreeStepNode* __restrict stepNodes = trees.NonSymmetricStepNodes.data();
+    double result = 0.0;
+    for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+        TCalcerIndexType nodeIdx = trees.TreeStartOffsets[treeId];
+        while (!stepNodes[nodeIdx].IsLeaf()) {
+            const TRepackedBin split = repackedBins[nodeIdx];
+            ui8 featureValue = binFeatures[split.FeatureIndex];
+            if (NeedXorMask) {
+                featureValue ^= split.XorMask;
+            }
+            nodeIdx += featureValue >= split.SplitIdx ? stepNodes[nodeIdx].RightSubtreeDiff : stepNodes[nodeIdx].LeftSubtreeDiff;
+        }
+        const double* leafValuePtr =
+            trees.GetFirstLeafPtrForTree(treeId) + trees.NonSymmetricNodeIdToLeafId[nodeIdx] * trees.ApproxDimension;
+        if (IsSingleClassModel) { // single class model
+            result += *leafValuePtr;
+        } else { // multiclass model
+            for (int classId = 0; classId < trees.ApproxDimension; ++classId) {
+                results[classId] += leafValuePtr[classId];
+            }
+        }
+    }
+    if (IsSingleClassModel) {
+        results[0] = result;
+    }
+}
+
+template <bool IsSingleClassModel, bool NeedXorMask>
+static TTreeCalcFunction GetCalcNonSymmetricTreesFunction(size_t docCountInBlock) {
+    if (docCountInBlock == 1) {
+        return CalcNonSymmetricTreesSingleDocImpl<IsSingleClassModel, NeedXorMask>;
+    } else {
+        return CalcNonSymmetricTreesBlocked<IsSingleClassModel, NeedXorMask>;
+    }
+}
+
 TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountInBlock) {
     const bool hasOneHots = !model.ObliviousTrees.OneHotFeatures.empty();
+    if (!model.ObliviousTrees.IsOblivious()) {
+        if (model.ObliviousTrees.ApproxDimension == 1) {
+            return hasOneHots
+                ? GetCalcNonSymmetricTreesFunction<true, true>(docCountInBlock)
+                : GetCalcNonSymmetricTreesFunction<true, false>(docCountInBlock);
+        } else {
+            return hasOneHots
+                ? GetCalcNonSymmetricTreesFunction<false, true>(docCountInBlock)
+                : GetCalcNonSymmetricTreesFunction<false, false>(docCountInBlock);
+        }
+    }
     if (model.ObliviousTrees.ApproxDimension == 1) {
         if (docCountInBlock == 1) {
             if (hasOneHots) {
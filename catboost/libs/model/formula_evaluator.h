@@ -1,10 +1,14 @@
 #pragma once
 
+#include "evaluation_isa.h"
 #include "model.h"
 
 #include <catboost/libs/helpers/exception.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
 #include <util/generic/hash.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
@@ -138,7 +142,7 @@ Y_FORCE_INLINE void BinarizeFloats(
 #else
 
 template <bool UseNanSubstitution, typename TFloatFeatureAccessor>
-Y_FORCE_INLINE void BinarizeFloats(
+Y_FORCE_INLINE void BinarizeFloatsSse(
     const size_t docCount,
     TFloatFeatureAccessor floatAccessor,
     const TConstArrayRef<float> borders,
@@ -227,8 +231,122 @@ Y_FORCE_INLINE void BinarizeFloats(
     result += docCount * ((borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN);
 }
 
+/**
+* Gathers feature values into a contiguous buffer and binarizes them with AVX2/AVX-512 kernels
+*/
+template <bool UseNanSubstitution, typename TFloatFeatureAccessor>
+Y_FORCE_INLINE void BinarizeFloatsWide(
+    const EEvaluationIsa isa,
+    const size_t docCount,
+    TFloatFeatureAccessor floatAccessor,
+    const TConstArrayRef<float> borders,
+    size_t start,
+    ui8*& result,
+    const float nanSubstitutionValue
+) {
+    alignas(64) float values[FORMULA_EVALUATION_BLOCK_SIZE];
+    for (size_t chunkStart = 0; chunkStart < docCount; chunkStart += FORMULA_EVALUATION_BLOCK_SIZE) {
+        const size_t chunkSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount - chunkStart);
+        for (size_t docId = 0; docId < chunkSize; ++docId) {
+            values[docId] = floatAccessor(start + chunkStart + docId);
+            if (UseNanSubstitution && IsNan(values[docId])) {
+                values[docId] = nanSubstitutionValue;
+            }
+        }
+        ui8* writePtr = result + chunkStart;
+        for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
+            const size_t blockEnd = Min(blockStart + MAX_VALUES_PER_BIN, borders.size());
+            if (isa == EEvaluationIsa::Avx512) {
+                BinarizeFloatsAvx512(values, chunkSize, borders.data() + blockStart, blockEnd - blockStart, writePtr);
+            } else {
+                BinarizeFloatsAvx2(values, chunkSize, borders.data() + blockStart, blockEnd - blockStart, writePtr);
+            }
+            writePtr += docCount;
+        }
+    }
+    result += docCount * ((borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN);
+}
+
+template <bool UseNanSubstitution, typename TFloatFeatureAccessor>
+Y_FORCE_INLINE void BinarizeFloats(
+    const size_t docCount,
+    TFloatFeatureAccessor floatAccessor,
+    const TConstArrayRef<float> borders,
+    size_t start,
+    ui8*& result,
+    const float nanSubstitutionValue = 0.0f
+) {
+    const EEvaluationIsa isa = GetEvaluationIsa();
+    if (isa != EEvaluationIsa::Default && docCount >= 32) {
+        BinarizeFloatsWide<UseNanSubstitution>(isa, docCount, floatAccessor, borders, start, result, nanSubstitutionValue);
+    } else {
+        BinarizeFloatsSse<UseNanSubstitution>(docCount, floatAccessor, borders, start, result, nanSubstitutionValue);
+    }
+}
+
 #endif
 
+/**
+* Calculates one-hot and ctr bins for documents [start, end), resultPtr must point to the first byte after float
+*  features bins of the block.
+*/
+template <typename TCatFeatureAccessor>
+inline void BinarizeCatFeaturesAndCtrs(
+    const TFullModel& model,
+    TCatFeatureAccessor catFeatureAccessor,
+    size_t start,
+    size_t end,
+    TArrayRef<ui8> result,
+    ui8*& resultPtr,
+    TVector<ui32>& transposedHash,
+    TVector<float>& ctrs
+) {
+    const auto docCount = end - start;
+    THashMap<int, int> catFeaturePackedIndexes;
+    int usedFeatureIdx = 0;
+    for (const auto& catFeature : model.ObliviousTrees.CatFeatures) {
+        if (!catFeature.UsedInModel) {
+            continue;
+        }
+        catFeaturePackedIndexes[catFeature.FeatureIndex] = usedFeatureIdx;
+        for (size_t docId = 0, writeIdx = usedFeatureIdx * docCount;
+             docId < docCount;
+             ++docId, ++writeIdx)
+        {
+            transposedHash[writeIdx] = catFeatureAccessor(catFeature, start + docId);
+        }
+        ++usedFeatureIdx;
+    }
+    Y_ASSERT(model.GetUsedCatFeaturesCount() == (size_t)usedFeatureIdx);
+    OneHotBinsFromTransposedCatFeatures(
+        model.ObliviousTrees.OneHotFeatures,
+        catFeaturePackedIndexes,
+        docCount,
+        resultPtr,
+        transposedHash
+    );
+    if (!model.ObliviousTrees.GetUsedModelCtrs().empty()) {
+        model.CtrProvider->CalcCtrs(
+            model.ObliviousTrees.GetUsedModelCtrs(),
+            result,
+            transposedHash,
+            docCount,
+            ctrs
+        );
+    }
+    for (size_t i = 0; i < model.ObliviousTrees.CtrFeatures.size(); ++i) {
+        const auto& ctr = model.ObliviousTrees.CtrFeatures[i];
+        auto ctrFloatsPtr = &ctrs[i * docCount];
+        BinarizeFloats<false>(
+            docCount,
+            [ctrFloatsPtr](size_t index) { return ctrFloatsPtr[index]; },
+            ctr.Borders,
+            0,
+            resultPtr
+        );
+    }
+}
+
 /**
 * This function binarizes
 */
@@ -283,65 +401,25 @@ inline void BinarizeFeatures(
         }
     }
     if (model.HasCategoricalFeatures()) {
-        THashMap<int, int> catFeaturePackedIndexes;
-        int usedFeatureIdx = 0;
-        for (const auto& catFeature : model.ObliviousTrees.CatFeatures) {
-            if (!catFeature.UsedInModel) {
-                continue;
-            }
-            catFeaturePackedIndexes[catFeature.FeatureIndex] = usedFeatureIdx;
-            for (size_t docId = 0, writeIdx = usedFeatureIdx * docCount;
-                 docId < docCount;
-                 ++docId, ++writeIdx)
-            {
-                transposedHash[writeIdx] = catFeatureAccessor(catFeature, start + docId);
-            }
-            ++usedFeatureIdx;
-        }
-        Y_ASSERT(model.GetUsedCatFeaturesCount() == (size_t)usedFeatureIdx);
-        OneHotBinsFromTransposedCatFeatures(
-            model.ObliviousTrees.OneHotFeatures,
-            catFeaturePackedIndexes,
-            docCount,
-            resultPtr,
-            transposedHash
-        );
-        if (!model.ObliviousTrees.GetUsedModelCtrs().empty()) {
-            model.CtrProvider->CalcCtrs(
-                model.ObliviousTrees.GetUsedModelCtrs(),
-                result,
-                transposedHash,
-                docCount,
-                ctrs
-            );
-        }
-        for (size_t i = 0; i < model.ObliviousTrees.CtrFeatures.size(); ++i) {
-            const auto& ctr = model.ObliviousTrees.CtrFeatures[i];
-            auto ctrFloatsPtr = &ctrs[i * docCount];
-            BinarizeFloats<false>(
-                docCount,
-                [ctrFloatsPtr](size_t index) { return ctrFloatsPtr[index]; },
-                ctr.Borders,
-                0,
-                resultPtr
-            );
-        }
+        BinarizeCatFeaturesAndCtrs(model, catFeatureAccessor, start, end, result, resultPtr, transposedHash, ctrs);
     }
 }
 
 /**
-* This function is for quantized pool
+* This function is for quantized pool: floatAccessor returns model bins, catAccessor returns hashed (not perfect
+*  hashed) categorical values
 */
 template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
 inline void AssignFeatureBins(
     const TFullModel& model,
     TFloatFeatureAccessor floatAccessor,
-    TCatFeatureAccessor /*catAccessor*/,
+    TCatFeatureAccessor catAccessor,
     size_t start,
     size_t end,
-    TArrayRef<ui8> result
+    TArrayRef<ui8> result,
+    TVector<ui32>& transposedHash,
+    TVector<float>& ctrs
 ) {
-    CB_ENSURE(!model.HasCategoricalFeatures(), "Quantized datasets with categorical features are not currently supported");
     ui8* resultPtr = result.data();
     for (const auto& floatFeature : model.ObliviousTrees.FloatFeatures) {
         if (!floatFeature.UsedInModel()) {
@@ -352,6 +430,14 @@ inline void AssignFeatureBins(
             resultPtr++;
         }
     }
+    if constexpr (!std::is_same_v<TCatFeatureAccessor, std::nullptr_t>) {
+        if (model.HasCategoricalFeatures()) {
+            std::fill(resultPtr, result.end(), 0);
+            BinarizeCatFeaturesAndCtrs(model, catAccessor, start, end, result, resultPtr, transposedHash, ctrs);
+        }
+    } else {
+        CB_ENSURE(!model.HasCategoricalFeatures(), "Categorical features accessor is required for this model");
+    }
 }
 
 using TCalcerIndexType = ui32;
@@ -382,18 +468,19 @@ inline X* GetAligned(X* val) {
     return val;
 }
 
-template <bool isQuantizedFeaturesData = false, typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
-inline void CalcGeneric(
+// evaluates documents [docBegin, docEnd) in blocks of blockSize, scratch buffers are local to the call
+template <bool isQuantizedFeaturesData, typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+inline void CalcGenericDocRange(
     const TFullModel& model,
     TFloatFeatureAccessor floatFeatureAccessor,
     TCatFeatureAccessor catFeaturesAccessor,
-    size_t docCount,
+    size_t blockSize,
+    size_t docBegin,
+    size_t docEnd,
     size_t treeStart,
     size_t treeEnd,
     TArrayRef<double> results
 ) {
-    size_t blockSize = FORMULA_EVALUATION_BLOCK_SIZE;
-    blockSize = Min(blockSize, docCount);
     const size_t binSlots = blockSize * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount();
     TArrayRef<ui8> binFeatures;
     TVector<ui8> binFeaturesHolder;
@@ -405,16 +492,11 @@ inline void CalcGeneric(
     }
     auto calcTrees = GetCalcTreesFunction(model, blockSize);
 
-    CB_ENSURE(
-        results.size() == docCount * model.ObliviousTrees.ApproxDimension,
-        "`results` size is insufficient: "
-        LabeledOutput(results.size(), docCount * model.ObliviousTrees.ApproxDimension));
-    std::fill(results.begin(), results.end(), 0.0);
     TVector<TCalcerIndexType> indexesVec(blockSize);
     TVector<ui32> transposedHash(blockSize * model.GetUsedCatFeaturesCount());
     TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * blockSize);
-    for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
-        const auto docCountInBlock = Min(blockSize, docCount - blockStart);
+    for (size_t blockStart = docBegin; blockStart < docEnd; blockStart += blockSize) {
+        const auto docCountInBlock = Min(blockSize, docEnd - blockStart);
         if constexpr (!isQuantizedFeaturesData) {
             BinarizeFeatures(
                 model,
@@ -433,7 +515,9 @@ inline void CalcGeneric(
                 catFeaturesAccessor,
                 blockStart,
                 blockStart + docCountInBlock,
-                binFeatures
+                binFeatures,
+                transposedHash,
+                ctrs
             );
         }
 
@@ -441,7 +525,7 @@ inline void CalcGeneric(
             model,
             binFeatures.data(),
             docCountInBlock,
-            docCount == 1 ? nullptr : indexesVec.data(),
+            blockSize == 1 ? nullptr : indexesVec.data(),
             treeStart,
             treeEnd,
             results.data() + blockStart * model.ObliviousTrees.ApproxDimension
@@ -449,6 +533,68 @@ inline void CalcGeneric(
     }
 }
 
+/**
+ * Evaluates trees [treeStart, treeEnd) on docCount documents.
+ * If executor is passed, blocks of FORMULA_EVALUATION_BLOCK_SIZE documents are split between its threads
+ *  (and the calling thread). Block boundaries don't depend on thread count, so results are bit-identical
+ *  to single-threaded evaluation.
+ */
+template <bool isQuantizedFeaturesData = false, typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+inline void CalcGeneric(
+    const TFullModel& model,
+    TFloatFeatureAccessor floatFeatureAccessor,
+    TCatFeatureAccessor catFeaturesAccessor,
+    size_t docCount,
+    size_t treeStart,
+    size_t treeEnd,
+    TArrayRef<double> results,
+    NPar::TLocalExecutor* executor = nullptr
+) {
+    size_t blockSize = FORMULA_EVALUATION_BLOCK_SIZE;
+    blockSize = Min(blockSize, docCount);
+    CB_ENSURE(
+        results.size() == docCount * model.ObliviousTrees.ApproxDimension,
+        "`results` size is insufficient: "
+        LabeledOutput(results.size(), docCount * model.ObliviousTrees.ApproxDimension));
+    std::fill(results.begin(), results.end(), 0.0);
+    const size_t blockCount = blockSize ? (docCount + blockSize - 1) / blockSize : 0;
+    if (!executor || executor->GetThreadCount() == 0 || blockCount < 2) {
+        CalcGenericDocRange<isQuantizedFeaturesData>(
+            model,
+            floatFeatureAccessor,
+            catFeaturesAccessor,
+            blockSize,
+            0,
+            docCount,
+            treeStart,
+            treeEnd,
+            results
+        );
+        return;
+    }
+    NPar::TLocalExecutor::TExecRangeParams partParams(0, SafeIntegerCast<int>(blockCount));
+    partParams.SetBlockCount(executor->GetThreadCount() + 1);
+    executor->ExecRangeWithThrow(
+        [&] (int partIdx) {
+            const size_t partFirstBlock = partIdx * partParams.GetBlockSize();
+            const size_t partLastBlock = Min<size_t>(blockCount, partFirstBlock + partParams.GetBlockSize());
+            CalcGenericDocRange<isQuantizedFeaturesData>(
+                model,
+                floatFeatureAccessor,
+                catFeaturesAccessor,
+                blockSize,
+                partFirstBlock * blockSize,
+                Min(docCount, partLastBlock * blockSize),
+                treeStart,
+                treeEnd,
+                results
+            );
+        },
+        0,
+        partParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+}
 
 /**
  * Warning: use aggressive caching. Stores all binarized features in RAM
@@ -491,11 +637,13 @@ public:
         }
     }
 
-    template <typename TFloatFeatureAccessor>
+    // for quantized features data
+    template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor = std::nullptr_t>
     TFeatureCachedTreeEvaluator(
         const TFullModel& model,
         TFloatFeatureAccessor floatFeatureAccessor,
-        size_t docCount
+        size_t docCount,
+        TCatFeatureAccessor catFeaturesAccessor = nullptr
     )
         : Model(model)
         , DocCount(docCount)
@@ -503,6 +651,8 @@ public:
         size_t blockSize = FORMULA_EVALUATION_BLOCK_SIZE;
         BlockSize = Min(blockSize, docCount);
         CalcFunction = GetCalcTreesFunction(Model, BlockSize);
+        TVector<ui32> transposedHash(blockSize * model.GetUsedCatFeaturesCount());
+        TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * blockSize);
         for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
             const auto docCountInBlock = Min(blockSize, docCount - blockStart);
             TVector<ui8> binFeatures(
@@ -510,10 +660,12 @@ public:
             AssignFeatureBins(
                 model,
                 floatFeatureAccessor,
-                nullptr,
+                catFeaturesAccessor,
                 blockStart,
                 blockStart + docCountInBlock,
-                binFeatures
+                binFeatures,
+                transposedHash,
+                ctrs
             );
             BinFeatures.push_back(std::move(binFeatures));
         }
@@ -0,0 +1,158 @@
+#include "evaluation_isa.h"
+
+#include <util/system/platform.h>
+
+#ifdef _sse2_
+
+#include <immintrin.h>
+
+
+static inline void BinarizeFloatsTail(
+    const float* __restrict values,
+    size_t docStart,
+    size_t docCount,
+    const float* __restrict borders,
+    size_t borderCount,
+    ui8* __restrict result)
+{
+    for (size_t docId = docStart; docId < docCount; ++docId) {
+        const float val = values[docId];
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            result[docId] += (ui8)(val > borders[borderId]);
+        }
+    }
+}
+
+void BinarizeFloatsAvx2(
+    const float* __restrict values,
+    size_t docCount,
+    const float* __restrict borders,
+    size_t borderCount,
+    ui8* __restrict result)
+{
+    // packs below interleave 128-bit lanes, this permutation restores document order
+    const __m256i lanesOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const size_t docCount32 = (docCount | 0x1f) ^ 0x1f;
+    for (size_t docId = 0; docId < docCount32; docId += 32) {
+        const __m256 floats0 = _mm256_loadu_ps(values + docId);
+        const __m256 floats1 = _mm256_loadu_ps(values + docId + 8);
+        const __m256 floats2 = _mm256_loadu_ps(values + docId + 16);
+        const __m256 floats3 = _mm256_loadu_ps(values + docId + 24);
+        __m256i resultVec = _mm256_setzero_si256();
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            const __m256 borderVec = _mm256_set1_ps(borders[borderId]);
+            const __m256i r0 = _mm256_castps_si256(_mm256_cmp_ps(floats0, borderVec, _CMP_GT_OQ));
+            const __m256i r1 = _mm256_castps_si256(_mm256_cmp_ps(floats1, borderVec, _CMP_GT_OQ));
+            const __m256i r2 = _mm256_castps_si256(_mm256_cmp_ps(floats2, borderVec, _CMP_GT_OQ));
+            const __m256i r3 = _mm256_castps_si256(_mm256_cmp_ps(floats3, borderVec, _CMP_GT_OQ));
+            const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(r0, r1), _mm256_packs_epi32(r2, r3));
+            // true comparisons are packed to 0xff, so subtraction increments bin
+            resultVec = _mm256_sub_epi8(resultVec, packed);
+        }
+        resultVec = _mm256_permutevar8x32_epi32(resultVec, lanesOrder);
+        __m256i* writePtr = (__m256i*)(result + docId);
+        _mm256_storeu_si256(writePtr, _mm256_add_epi8(_mm256_loadu_si256(writePtr), resultVec));
+    }
+    BinarizeFloatsTail(values, docCount32, docCount, borders, borderCount, result);
+}
+
+template <typename TIndexType>
+static inline void CalcIndexesTail(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docStart,
+    size_t docCountInBlock,
+    TIndexType* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize)
+{
+    for (int depth = 0; depth < curTreeSize; ++depth) {
+        const ui8 borderVal = treeSplitsCurPtr[depth].SplitIdx;
+        const ui8 xorMask = needXorMask ? treeSplitsCurPtr[depth].XorMask : 0;
+        const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock;
+        for (size_t docId = docStart; docId < docCountInBlock; ++docId) {
+            indexesVec[docId] |= ((binFeaturePtr[docId] ^ xorMask) >= borderVal) << depth;
+        }
+    }
+}
+
+// sets `bit` in bytes of `bins` where (features ^ xorMask) >= border
+static inline __m256i UpdateBinsAvx2(
+    bool needXorMask,
+    __m256i bins,
+    const ui8* __restrict binFeaturePtr,
+    const TRepackedBin& split,
+    ui8 bit)
+{
+    __m256i val = _mm256_loadu_si256((const __m256i*)binFeaturePtr);
+    if (needXorMask) {
+        val = _mm256_xor_si256(val, _mm256_set1_epi8((char)split.XorMask));
+    }
+    const __m256i borderVec = _mm256_set1_epi8((char)split.SplitIdx);
+    const __m256i isGreaterOrEqual = _mm256_cmpeq_epi8(_mm256_max_epu8(val, borderVec), val);
+    return _mm256_or_si256(bins, _mm256_and_si256(isGreaterOrEqual, _mm256_set1_epi8((char)bit)));
+}
+
+void CalcIndexesShallowAvx2(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize)
+{
+    const size_t docCount32 = (docCountInBlock | 0x1f) ^ 0x1f;
+    for (size_t docId = 0; docId < docCount32; docId += 32) {
+        __m256i bins = _mm256_setzero_si256();
+        for (int depth = 0; depth < curTreeSize; ++depth) {
+            const ui8* binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+            bins = UpdateBinsAvx2(needXorMask, bins, binFeaturePtr, treeSplitsCurPtr[depth], 1 << depth);
+        }
+        __m256i* writePtr = (__m256i*)(indexesVec + docId);
+        _mm256_storeu_si256(writePtr, _mm256_or_si256(_mm256_loadu_si256(writePtr), bins));
+    }
+    CalcIndexesTail(needXorMask, binFeatures, docCount32, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+}
+
+static inline void OrIndexesAvx2(__m128i lowBins, __m128i highBins, ui32* __restrict indexesPtr) {
+    const __m256i indexes = _mm256_or_si256(
+        _mm256_cvtepu8_epi32(lowBins),
+        _mm256_slli_epi32(_mm256_cvtepu8_epi32(highBins), 8));
+    __m256i* writePtr = (__m256i*)indexesPtr;
+    _mm256_storeu_si256(writePtr, _mm256_or_si256(_mm256_loadu_si256(writePtr), indexes));
+}
+
+void CalcIndexesAvx2(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui32* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize)
+{
+    const size_t docCount32 = (docCountInBlock | 0x1f) ^ 0x1f;
+    const int lowDepth = curTreeSize < 8 ? curTreeSize : 8;
+    for (size_t docId = 0; docId < docCount32; docId += 32) {
+        __m256i lowBins = _mm256_setzero_si256();
+        __m256i highBins = _mm256_setzero_si256();
+        for (int depth = 0; depth < lowDepth; ++depth) {
+            const ui8* binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+            lowBins = UpdateBinsAvx2(needXorMask, lowBins, binFeaturePtr, treeSplitsCurPtr[depth], 1 << depth);
+        }
+        for (int depth = lowDepth; depth < curTreeSize; ++depth) {
+            const ui8* binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+            highBins = UpdateBinsAvx2(needXorMask, highBins, binFeaturePtr, treeSplitsCurPtr[depth], 1 << (depth - 8));
+        }
+        const __m128i low0 = _mm256_castsi256_si128(lowBins);
+        const __m128i low1 = _mm256_extracti128_si256(lowBins, 1);
+        const __m128i high0 = _mm256_castsi256_si128(highBins);
+        const __m128i high1 = _mm256_extracti128_si256(highBins, 1);
+        OrIndexesAvx2(low0, high0, indexesVec + docId);
+        OrIndexesAvx2(_mm_srli_si128(low0, 8), _mm_srli_si128(high0, 8), indexesVec + docId + 8);
+        OrIndexesAvx2(low1, high1, indexesVec + docId + 16);
+        OrIndexesAvx2(_mm_srli_si128(low1, 8), _mm_srli_si128(high1, 8), indexesVec + docId + 24);
+    }
+    CalcIndexesTail(needXorMask, binFeatures, docCount32, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include "evaluation_isa.h"
+
+#include <util/system/platform.h>
+
+#ifdef _sse2_
+
+#include <immintrin.h>
+
+
+// last block is handled with masked loads and stores, so no scalar tails are needed
+static inline __mmask64 GetDocsMask(size_t docId, size_t docCount) {
+    const size_t restDocCount = docCount - docId;
+    return restDocCount >= 64 ? ~0ull : (1ull << restDocCount) - 1;
+}
+
+static inline __mmask16 GetSubMask(__mmask64 mask, int subBlock) {
+    return (__mmask16)(mask >> (16 * subBlock));
+}
+
+void BinarizeFloatsAvx512(
+    const float* __restrict values,
+    size_t docCount,
+    const float* __restrict borders,
+    size_t borderCount,
+    ui8* __restrict result)
+{
+    const __m512i one = _mm512_set1_epi32(1);
+    for (size_t docId = 0; docId < docCount; docId += 64) {
+        const __mmask64 docsMask = GetDocsMask(docId, docCount);
+        const __m512 floats0 = _mm512_maskz_loadu_ps(GetSubMask(docsMask, 0), values + docId);
+        const __m512 floats1 = _mm512_maskz_loadu_ps(GetSubMask(docsMask, 1), values + docId + 16);
+        const __m512 floats2 = _mm512_maskz_loadu_ps(GetSubMask(docsMask, 2), values + docId + 32);
+        const __m512 floats3 = _mm512_maskz_loadu_ps(GetSubMask(docsMask, 3), values + docId + 48);
+        const __m512i initialBins = _mm512_maskz_loadu_epi8(docsMask, result + docId);
+        __m512i bins0 = _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(initialBins, 0));
+        __m512i bins1 = _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(initialBins, 1));
+        __m512i bins2 = _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(initialBins, 2));
+        __m512i bins3 = _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(initialBins, 3));
+        for (size_t borderId = 0; borderId < borderCount; ++borderId) {
+            const __m512 borderVec = _mm512_set1_ps(borders[borderId]);
+            bins0 = _mm512_mask_add_epi32(bins0, _mm512_cmp_ps_mask(floats0, borderVec, _CMP_GT_OQ), bins0, one);
+            bins1 = _mm512_mask_add_epi32(bins1, _mm512_cmp_ps_mask(floats1, borderVec, _CMP_GT_OQ), bins1, one);
+            bins2 = _mm512_mask_add_epi32(bins2, _mm512_cmp_ps_mask(floats2, borderVec, _CMP_GT_OQ), bins2, one);
+            bins3 = _mm512_mask_add_epi32(bins3, _mm512_cmp_ps_mask(floats3, borderVec, _CMP_GT_OQ), bins3, one);
+        }
+        // truncating store, same wraparound as byte additions in other kernels
+        _mm512_mask_cvtepi32_storeu_epi8(result + docId, GetSubMask(docsMask, 0), bins0);
+        _mm512_mask_cvtepi32_storeu_epi8(result + docId + 16, GetSubMask(docsMask, 1), bins1);
+        _mm512_mask_cvtepi32_storeu_epi8(result + docId + 32, GetSubMask(docsMask, 2), bins2);
+        _mm512_mask_cvtepi32_storeu_epi8(result + docId + 48, GetSubMask(docsMask, 3), bins3);
+    }
+}
+
+// sets `bit` in bytes of `bins` where (features ^ xorMask) >= border
+static inline __m512i UpdateBinsAvx512(
+    bool needXorMask,
+    __m512i bins,
+    __mmask64 docsMask,
+    const ui8* __restrict binFeaturePtr,
+    const TRepackedBin& split,
+    ui8 bit)
+{
+    __m512i val = _mm512_maskz_loadu_epi8(docsMask, binFeaturePtr);
+    if (needXorMask) {
+        val = _mm512_xor_si512(val, _mm512_set1_epi8((char)split.XorMask));
+    }
+    const __mmask64 isGreaterOrEqual = _mm512_cmpge_epu8_mask(val, _mm512_set1_epi8((char)split.SplitIdx));
+    // each bit is set at most once per byte, so addition is equivalent to or
+    return _mm512_mask_add_epi8(bins, isGreaterOrEqual, bins, _mm512_set1_epi8((char)bit));
+}
+
+void CalcIndexesShallowAvx512(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize)
+{
+    for (size_t docId = 0; docId < docCountInBlock; docId += 64) {
+        const __mmask64 docsMask = GetDocsMask(docId, docCountInBlock);
+        __m512i bins = _mm512_setzero_si512();
+        for (int depth = 0; depth < curTreeSize; ++depth) {
+            const ui8* binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+            bins = UpdateBinsAvx512(needXorMask, bins, docsMask, binFeaturePtr, treeSplitsCurPtr[depth], 1 << depth);
+        }
+        ui8* writePtr = indexesVec + docId;
+        _mm512_mask_storeu_epi8(writePtr, docsMask, _mm512_or_si512(_mm512_maskz_loadu_epi8(docsMask, writePtr), bins));
+    }
+}
+
+static inline void OrIndexesAvx512(__m128i lowBins, __m128i highBins, __mmask16 docsMask, ui32* __restrict indexesPtr) {
+    const __m512i indexes = _mm512_or_si512(
+        _mm512_cvtepu8_epi32(lowBins),
+        _mm512_slli_epi32(_mm512_cvtepu8_epi32(highBins), 8));
+    _mm512_mask_storeu_epi32(
+        indexesPtr,
+        docsMask,
+        _mm512_or_si512(_mm512_maskz_loadu_epi32(docsMask, indexesPtr), indexes));
+}
+
+void CalcIndexesAvx512(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui32* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize)
+{
+    const int lowDepth = curTreeSize < 8 ? curTreeSize : 8;
+    for (size_t docId = 0; docId < docCountInBlock; docId += 64) {
+        const __mmask64 docsMask = GetDocsMask(docId, docCountInBlock);
+        __m512i lowBins = _mm512_setzero_si512();
+        __m512i highBins = _mm512_setzero_si512();
+        for (int depth = 0; depth < lowDepth; ++depth) {
+            const ui8* binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+            lowBins = UpdateBinsAvx512(needXorMask, lowBins, docsMask, binFeaturePtr, treeSplitsCurPtr[depth], 1 << depth);
+        }
+        for (int depth = lowDepth; depth < curTreeSize; ++depth) {
+            const ui8* binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+            highBins = UpdateBinsAvx512(needXorMask, highBins, docsMask, binFeaturePtr, treeSplitsCurPtr[depth], 1 << (depth - 8));
+        }
+        OrIndexesAvx512(
+            _mm512_extracti32x4_epi32(lowBins, 0),
+            _mm512_extracti32x4_epi32(highBins, 0),
+            GetSubMask(docsMask, 0),
+            indexesVec + docId);
+        OrIndexesAvx512(
+            _mm512_extracti32x4_epi32(lowBins, 1),
+            _mm512_extracti32x4_epi32(highBins, 1),
+            GetSubMask(docsMask, 1),
+            indexesVec + docId + 16);
+        OrIndexesAvx512(
+            _mm512_extracti32x4_epi32(lowBins, 2),
+            _mm512_extracti32x4_epi32(highBins, 2),
+            GetSubMask(docsMask, 2),
+            indexesVec + docId + 32);
+        OrIndexesAvx512(
+            _mm512_extracti32x4_epi32(lowBins, 3),
+            _mm512_extracti32x4_epi32(highBins, 3),
+            GetSubMask(docsMask, 3),
+            indexesVec + docId + 48);
+    }
+}
+
+#endif
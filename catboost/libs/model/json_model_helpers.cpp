@@ -401,6 +401,7 @@ static void GetObliviousTrees(const TJsonValue& jsonValue, TObliviousTrees* obli
 }
 
 TJsonValue ConvertModelToJson(const TFullModel& model, const TVector<TString>* featureId, const THashMap<ui32, TString>* catFeaturesHashToString) {
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Export of non-symmetric trees to JSON is not supported");
     TJsonValue jsonModel;
     TJsonValue modelInfo;
     for (const auto& key_value : model.ModelInfo) {
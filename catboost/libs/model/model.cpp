@@ -28,6 +28,7 @@
 #include <util/string/builder.h>
 #include <util/stream/buffer.h>
 #include <util/stream/file.h>
+#include <util/system/filemap.h>
 #include <util/system/fs.h>
 #include <util/stream/str.h>
 
@@ -75,6 +76,14 @@ static NJson::TJsonValue RemoveInvalidParams(const NJson::TJsonValue& params) {
     return result;
 }
 
+static void RemoveInvalidParamsFromModelInfo(TFullModel* model) {
+    if (model->ModelInfo.contains("params")) {
+        NJson::TJsonValue paramsJson = ReadTJsonValue(model->ModelInfo.at("params"));
+        paramsJson["flat_params"] = RemoveInvalidParams(paramsJson["flat_params"]);
+        model->ModelInfo["params"] = ToString<NJson::TJsonValue>(paramsJson);
+    }
+}
+
 TFullModel ReadModel(IInputStream* modelStream, EModelType format) {
     TFullModel model;
     if (format == EModelType::CatboostBinary) {
@@ -87,11 +96,7 @@ TFullModel ReadModel(IInputStream* modelStream, EModelType format) {
         CB_ENSURE(coreMLModel.ParseFromString(modelStream->ReadAll()), "coreml model deserialization failed");
         NCatboost::NCoreML::ConvertCoreMLToCatboostModel(coreMLModel, &model);
     }
-    if (model.ModelInfo.contains("params")) {
-        NJson::TJsonValue paramsJson = ReadTJsonValue(model.ModelInfo.at("params"));
-        paramsJson["flat_params"] = RemoveInvalidParams(paramsJson["flat_params"]);
-        model.ModelInfo["params"] = ToString<NJson::TJsonValue>(paramsJson);
-    }
+    RemoveInvalidParamsFromModelInfo(&model);
     return model;
 }
 
@@ -107,11 +112,52 @@ TFullModel ReadModel(const void* binaryBuffer, size_t binaryBufferSize, EModelTy
     return ReadModel(&bs, format);
 }
 
+TFullModel ReadZeroCopyModel(const void* binaryBuffer, size_t binaryBufferSize) {
+    TFullModel model;
+    model.InitNonOwning(binaryBuffer, binaryBufferSize);
+    RemoveInvalidParamsFromModelInfo(&model);
+    return model;
+}
+
+namespace {
+    class TMappedModelFile : public TThrRefBase {
+    public:
+        explicit TMappedModelFile(const TString& modelFile)
+            : FileMap(modelFile)
+        {
+            CB_ENSURE(FileMap.Length() > 0, "Model file is empty: " << modelFile);
+            FileMap.Map(0, FileMap.Length());
+        }
+
+        const void* GetData() const {
+            return FileMap.Ptr();
+        }
+
+        size_t GetSize() const {
+            return FileMap.MappedSize();
+        }
+
+    private:
+        TFileMap FileMap;
+    };
+}
+
+TFullModel ReadMappedModel(const TString& modelFile) {
+    CB_ENSURE(NFs::Exists(modelFile), "Model file doesn't exist: " << modelFile);
+    TIntrusivePtr<TMappedModelFile> mappedFile = MakeIntrusive<TMappedModelFile>(modelFile);
+    TFullModel model;
+    model.InitNonOwning(mappedFile->GetData(), mappedFile->GetSize(), mappedFile);
+    RemoveInvalidParamsFromModelInfo(&model);
+    return model;
+}
+
 void OutputModelCoreML(
     const TFullModel& model,
     const TString& modelFile,
     const NJson::TJsonValue& userParameters) {
 
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Export of non-symmetric trees to CoreML is not supported");
+
     CoreML::Specification::Model outModel;
     outModel.set_specificationversion(1);
 
@@ -142,6 +188,7 @@ void OutputModelOnnx(
         !model.HasCategoricalFeatures(),
         "ONNX-ML format export does yet not support categorical features"
     );
+    CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Export of non-symmetric trees to ONNX-ML is not supported");
 
     onnx::ModelProto outModel;
 
@@ -240,12 +287,68 @@ TFullModel DeserializeModel(const TString& serializedModel) {
     return DeserializeModel(TMemoryInput{serializedModel.data(), serializedModel.size()});
 }
 
+static void AddNonSymmetricTreeToBuilder(
+    const TObliviousTrees& trees,
+    size_t treeIdx,
+    double leafMultiplier,
+    TObliviousTreeBuilder* builder) {
+
+    const auto& binFeatures = trees.GetBinFeatures();
+    const int treeStart = trees.TreeStartOffsets[treeIdx];
+    const int treeEnd = treeStart + trees.TreeSizes[treeIdx];
+    // split nodes are numbered in their breadth-first order, leaf nodes are referenced by ~leafIdx
+    TVector<int> builderItems(trees.TreeSizes[treeIdx]);
+    TVector<TModelSplit> nodeSplits;
+    for (int nodeIdx = treeStart; nodeIdx < treeEnd; ++nodeIdx) {
+        const ui32 leafId = trees.NonSymmetricNodeIdToLeafId[nodeIdx];
+        if (leafId == Max<ui32>()) {
+            builderItems[nodeIdx - treeStart] = nodeSplits.ysize();
+            nodeSplits.push_back(binFeatures[trees.TreeSplits[nodeIdx]]);
+        } else {
+            builderItems[nodeIdx - treeStart] = ~static_cast<int>(leafId);
+        }
+    }
+    TVector<std::pair<int, int>> nodeChildren;
+    for (int nodeIdx = treeStart; nodeIdx < treeEnd; ++nodeIdx) {
+        const auto& stepNode = trees.NonSymmetricStepNodes[nodeIdx];
+        if (!stepNode.IsLeaf()) {
+            nodeChildren.emplace_back(
+                builderItems[nodeIdx - treeStart + stepNode.LeftSubtreeDiff],
+                builderItems[nodeIdx - treeStart + stepNode.RightSubtreeDiff]
+            );
+        }
+    }
+    const double* firstLeafPtr = trees.GetFirstLeafPtrForTree(treeIdx);
+    TVector<double> leafValues(firstLeafPtr, firstLeafPtr + trees.GetTreeLeafCount(treeIdx) * trees.ApproxDimension);
+    for (auto& leafValue: leafValues) {
+        leafValue *= leafMultiplier;
+    }
+    builder->AddNonSymmetricTree(
+        nodeSplits,
+        nodeChildren,
+        leafValues,
+        trees.LeafWeights.empty() ? TVector<double>() : trees.LeafWeights[treeIdx]
+    );
+}
+
+size_t TObliviousTrees::GetTreeLeafCount(size_t treeIdx) const {
+    if (IsOblivious()) {
+        return size_t(1) << TreeSizes[treeIdx];
+    }
+    const auto treeNodesLeafIds = MakeArrayRef(NonSymmetricNodeIdToLeafId).Slice(TreeStartOffsets[treeIdx], TreeSizes[treeIdx]);
+    return CountIf(treeNodesLeafIds, [] (ui32 leafId) { return leafId != Max<ui32>(); });
+}
+
 void TObliviousTrees::TruncateTrees(size_t begin, size_t end) {
     CB_ENSURE(begin <= end, "begin tree index should be not greater than end tree index.");
-    CB_ENSURE(end <= TreeSplits.size(), "end tree index should be not greater than tree count.");
+    CB_ENSURE(end <= GetTreeCount(), "end tree index should be not greater than tree count.");
     TObliviousTreeBuilder builder(FloatFeatures, CatFeatures, ApproxDimension);
     const auto& leafOffsets = MetaData->TreeFirstLeafOffsets;
     for (size_t treeIdx = begin; treeIdx < end; ++treeIdx) {
+        if (!IsOblivious()) {
+            AddNonSymmetricTreeToBuilder(*this, treeIdx, /*leafMultiplier*/ 1.0, &builder);
+            continue;
+        }
         TVector<TModelSplit> modelSplits;
         for (int splitIdx = TreeStartOffsets[treeIdx];
              splitIdx < TreeStartOffsets[treeIdx] + TreeSizes[treeIdx];
@@ -288,6 +391,10 @@ TObliviousTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
             oneTreeLeafWeights.end()
         );
     }
+    std::vector<NCatBoostFbs::TNonSymmetricTreeStepNode> fbNonSymmetricStepNodes;
+    for (const auto& stepNode : NonSymmetricStepNodes) {
+        fbNonSymmetricStepNodes.push_back(stepNode.FBSerialize());
+    }
     return NCatBoostFbs::CreateTObliviousTreesDirect(
         serializer.FlatbufBuilder,
         ApproxDimension,
@@ -299,7 +406,9 @@ TObliviousTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
         &oneHotFeaturesOffsets,
         &ctrFeaturesOffsets,
         &LeafValues,
-        &flatLeafWeights
+        &flatLeafWeights,
+        &fbNonSymmetricStepNodes,
+        &NonSymmetricNodeIdToLeafId
     );
 }
 
@@ -316,7 +425,24 @@ void TObliviousTrees::UpdateMetadata() const {
     size_t currentOffset = 0;
     for (size_t i = 0; i < TreeSizes.size(); ++i) {
         ref.TreeFirstLeafOffsets[i] = currentOffset;
-        currentOffset += (1 << TreeSizes[i]) * ApproxDimension;
+        currentOffset += GetTreeLeafCount(i) * ApproxDimension;
+    }
+    if (!IsOblivious()) {
+        ref.NonSymmetricTreeDepths.resize(TreeSizes.size());
+        TVector<int> nodeDepths(NonSymmetricStepNodes.size());
+        for (size_t treeIdx = 0; treeIdx < TreeSizes.size(); ++treeIdx) {
+            int treeDepth = 0;
+            // children always follow their parent in breadth-first layout
+            for (int nodeIdx = TreeStartOffsets[treeIdx]; nodeIdx < TreeStartOffsets[treeIdx] + TreeSizes[treeIdx]; ++nodeIdx) {
+                const auto& stepNode = NonSymmetricStepNodes[nodeIdx];
+                if (!stepNode.IsLeaf()) {
+                    nodeDepths[nodeIdx + stepNode.LeftSubtreeDiff] = nodeDepths[nodeIdx] + 1;
+                    nodeDepths[nodeIdx + stepNode.RightSubtreeDiff] = nodeDepths[nodeIdx] + 1;
+                }
+                treeDepth = Max(treeDepth, nodeDepths[nodeIdx]);
+            }
+            ref.NonSymmetricTreeDepths[treeIdx] = treeDepth;
+        }
     }
 
     for (const auto& ctrFeature : CtrFeatures) {
@@ -376,7 +502,13 @@ void TObliviousTrees::UpdateMetadata() const {
         ref.EffectiveBinFeaturesBucketCount
             += (feature.Borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
     }
-    for (const auto& binSplit : TreeSplits) {
+    for (size_t splitIdx = 0; splitIdx < TreeSplits.size(); ++splitIdx) {
+        if (!IsOblivious() && NonSymmetricStepNodes[splitIdx].IsLeaf()) {
+            // leaf nodes have no split, their bins are never used
+            ref.RepackedBins.emplace_back();
+            continue;
+        }
+        const auto binSplit = TreeSplits[splitIdx];
         const auto& feature = ref.BinFeatures[binSplit];
         const auto& featureIndex = splitIds[binSplit];
         Y_ENSURE(
@@ -405,7 +537,8 @@ void TFullModel::CalcFlat(
     TConstArrayRef<TConstArrayRef<float>> features,
     size_t treeStart,
     size_t treeEnd,
-    TArrayRef<double> results) const {
+    TArrayRef<double> results,
+    NPar::TLocalExecutor* executor) const {
 
     const auto expectedFlatVecSize = ObliviousTrees.GetFlatFeatureVectorExpectedSize();
     for (const auto& flatFeaturesVec : features) {
@@ -426,7 +559,8 @@ void TFullModel::CalcFlat(
         features.size(),
         treeStart,
         treeEnd,
-        results
+        results,
+        executor
     );
 }
 
@@ -459,7 +593,8 @@ void TFullModel::CalcFlatTransposed(
     TConstArrayRef<TConstArrayRef<float>> transposedFeatures,
     size_t treeStart,
     size_t treeEnd,
-    TArrayRef<double> results) const {
+    TArrayRef<double> results,
+    NPar::TLocalExecutor* executor) const {
 
     CB_ENSURE(
         ObliviousTrees.GetFlatFeatureVectorExpectedSize() <= transposedFeatures.size(),
@@ -476,7 +611,8 @@ void TFullModel::CalcFlatTransposed(
         transposedFeatures[0].Size(),
         treeStart,
         treeEnd,
-        results
+        results,
+        executor
     );
 }
 
@@ -485,7 +621,8 @@ void TFullModel::Calc(
     TConstArrayRef<TConstArrayRef<int>> catFeatures,
     size_t treeStart,
     size_t treeEnd,
-    TArrayRef<double> results) const {
+    TArrayRef<double> results,
+    NPar::TLocalExecutor* executor) const {
 
     if (!floatFeatures.empty() && !catFeatures.empty()) {
         CB_ENSURE(catFeatures.size() == floatFeatures.size());
@@ -524,7 +661,8 @@ void TFullModel::Calc(
         docCount,
         treeStart,
         treeEnd,
-        results
+        results,
+        executor
     );
 }
 
@@ -533,7 +671,8 @@ void TFullModel::Calc(
     TConstArrayRef<TVector<TStringBuf>> catFeatures,
     size_t treeStart,
     size_t treeEnd,
-    TArrayRef<double> results) const {
+    TArrayRef<double> results,
+    NPar::TLocalExecutor* executor) const {
 
     if (!floatFeatures.empty() && !catFeatures.empty()) {
         CB_ENSURE(catFeatures.size() == floatFeatures.size());
@@ -572,7 +711,8 @@ void TFullModel::Calc(
         docCount,
         treeStart,
         treeEnd,
-        results
+        results,
+        executor
     );
 }
 
@@ -684,32 +824,25 @@ void TFullModel::Save(IOutputStream* s) const {
     }
 }
 
-void TFullModel::Load(IInputStream* s) {
-    using namespace flatbuffers;
+// returns identifiers of model parts stored after model core
+static TVector<TString> DeserializeModelCore(const ui8* coreData, size_t coreSize, TFullModel* model) {
     using namespace NCatBoostFbs;
-    ui32 fileDescriptor;
-    ::Load(s, fileDescriptor);
-    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
-    auto coreSize = ::LoadSize(s);
-    TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
-    s->LoadOrFail(arrayHolder.Get(), coreSize);
-
     {
-        flatbuffers::Verifier verifier(arrayHolder.Get(), coreSize);
+        flatbuffers::Verifier verifier(coreData, coreSize);
         CB_ENSURE(VerifyTModelCoreBuffer(verifier), "Flatbuffers model verification failed");
     }
-    auto fbModelCore = GetTModelCore(arrayHolder.Get());
+    auto fbModelCore = GetTModelCore(coreData);
     CB_ENSURE(
         fbModelCore->FormatVersion() && fbModelCore->FormatVersion()->str() == CURRENT_CORE_FORMAT_STRING,
         "Unsupported model format: " << fbModelCore->FormatVersion()->str()
     );
     if (fbModelCore->ObliviousTrees()) {
-        ObliviousTrees.FBDeserialize(fbModelCore->ObliviousTrees());
+        model->ObliviousTrees.FBDeserialize(fbModelCore->ObliviousTrees());
     }
-    ModelInfo.clear();
+    model->ModelInfo.clear();
     if (fbModelCore->InfoMap()) {
         for (auto keyVal : *fbModelCore->InfoMap()) {
-            ModelInfo[keyVal->Key()->str()] = keyVal->Value()->str();
+            model->ModelInfo[keyVal->Key()->str()] = keyVal->Value()->str();
         }
     }
     TVector<TString> modelParts;
@@ -720,13 +853,48 @@ void TFullModel::Load(IInputStream* s) {
     }
     if (!modelParts.empty()) {
         CB_ENSURE(modelParts.size() == 1, "only single part model supported now");
+        CB_ENSURE(modelParts[0] == TStaticCtrProvider().ModelPartIdentifier(), "only static ctr models supported");
+    }
+    return modelParts;
+}
+
+void TFullModel::Load(IInputStream* s) {
+    ui32 fileDescriptor;
+    ::Load(s, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(s);
+    TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
+    s->LoadOrFail(arrayHolder.Get(), coreSize);
+
+    const TVector<TString> modelParts = DeserializeModelCore(arrayHolder.Get(), coreSize, this);
+    CtrProvider.Reset();
+    if (!modelParts.empty()) {
         CtrProvider = new TStaticCtrProvider;
-        CB_ENSURE(modelParts[0] == CtrProvider->ModelPartIdentifier(), "only static ctr models supported");
         CtrProvider->Load(s);
     }
     UpdateDynamicData();
 }
 
+void TFullModel::InitNonOwning(const void* binaryBuffer, size_t binaryBufferSize, TIntrusivePtr<TThrRefBase> dataHolder) {
+    TMemoryInput in(binaryBuffer, binaryBufferSize);
+    ui32 fileDescriptor;
+    ::Load(&in, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(&in);
+    CB_ENSURE(in.Avail() >= coreSize, "Model core is truncated");
+    const ui8* coreData = reinterpret_cast<const ui8*>(in.Buf());
+    in.Skip(coreSize);
+
+    const TVector<TString> modelParts = DeserializeModelCore(coreData, coreSize, this);
+    CtrProvider.Reset();
+    if (!modelParts.empty()) {
+        TIntrusivePtr<TStaticCtrProvider> ctrProvider = new TStaticCtrProvider;
+        ctrProvider->LoadNonOwning(&in, std::move(dataHolder));
+        CtrProvider = ctrProvider;
+    }
+    UpdateDynamicData();
+}
+
 TVector<TString> GetModelUsedFeaturesNames(const TFullModel& model) {
     TVector<int> featuresIdxs;
     TVector<TString> featuresNames;
@@ -873,6 +1041,10 @@ static void StreamModelTreesToBuilder(
     const auto& binFeatures = trees.GetBinFeatures();
     const auto& leafOffsets = trees.GetFirstLeafOffsets();
     for (size_t treeIdx = 0; treeIdx < trees.TreeSizes.size(); ++treeIdx) {
+        if (!trees.IsOblivious()) {
+            AddNonSymmetricTreeToBuilder(trees, treeIdx, leafMultiplier, builder);
+            continue;
+        }
         TVector<TModelSplit> modelSplits;
         for (int splitIdx = trees.TreeStartOffsets[treeIdx];
              splitIdx < trees.TreeStartOffsets[treeIdx] + trees.TreeSizes[treeIdx];
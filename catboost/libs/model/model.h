@@ -3,6 +3,7 @@
 #include "ctr_provider.h"
 #include "features.h"
 #include "online_ctr.h"
+#include "repacked_bin.h"
 #include "split.h"
 
 #include <catboost/libs/helpers/exception.h>
@@ -28,6 +29,40 @@
 
 class TModelPartsCachingSerializer;
 
+namespace NPar {
+    class TLocalExecutor;
+}
+
+/*!
+ * \brief Step to children of non-symmetric tree node
+ *
+ * Children are located at node index + diff, left child is for objects that don't satisfy node split.
+ * Both diffs are zero for leaf nodes.
+ */
+struct TNonSymmetricTreeStepNode {
+    ui16 LeftSubtreeDiff = 0;
+    ui16 RightSubtreeDiff = 0;
+
+public:
+    bool operator==(const TNonSymmetricTreeStepNode& other) const {
+        return std::tie(LeftSubtreeDiff, RightSubtreeDiff)
+            == std::tie(other.LeftSubtreeDiff, other.RightSubtreeDiff);
+    }
+
+    bool IsLeaf() const {
+        return LeftSubtreeDiff == 0 && RightSubtreeDiff == 0;
+    }
+
+    NCatBoostFbs::TNonSymmetricTreeStepNode FBSerialize() const {
+        return NCatBoostFbs::TNonSymmetricTreeStepNode(LeftSubtreeDiff, RightSubtreeDiff);
+    }
+
+    void FBDeserialize(const NCatBoostFbs::TNonSymmetricTreeStepNode* fbObj) {
+        LeftSubtreeDiff = fbObj->LeftSubtreeDiff();
+        RightSubtreeDiff = fbObj->RightSubtreeDiff();
+    }
+};
+
 /*!
     \brief Oblivious tree model structure
 
@@ -50,13 +85,13 @@ class TModelPartsCachingSerializer;
     - TreeSplits - holds all binary feature indexes from all the trees.
     - TreeSizes - holds tree depth.
     - TreeStartOffsets - holds offset of first tree split in TreeSplits vector
-*/
-struct TRepackedBin {
-    ui16 FeatureIndex = 0;
-    ui8 XorMask = 0;
-    ui8 SplitIdx = 0;
-};
 
+    Non-symmetric trees (trained with Depthwise or Lossguide growing policy) are stored as node arrays
+    in the same vectors: TreeSizes holds node count (including leaves) and each tree nodes are laid out
+    in breadth-first order. NonSymmetricStepNodes holds offsets from each node to its children (zero for leaves),
+    NonSymmetricNodeIdToLeafId maps leaf nodes to leaf indexes. Model contains either only oblivious or only
+    non-symmetric trees.
+*/
 struct TObliviousTrees {
 public:
     /**
@@ -96,6 +131,9 @@ public:
 
         //! Offset of first tree leaf in flat tree leafs array
         TVector<size_t> TreeFirstLeafOffsets;
+
+        //! Depth of each non-symmetric tree, empty for oblivious trees
+        TVector<int> NonSymmetricTreeDepths;
     };
 
 public:
@@ -124,6 +162,12 @@ public:
      */
     TVector<TVector<double>> LeafWeights;
 
+    //! Non-symmetric tree nodes steps, indexed like TreeSplits. Empty for oblivious trees
+    TVector<TNonSymmetricTreeStepNode> NonSymmetricStepNodes;
+
+    //! Leaf index in tree for leaf nodes and Max<ui32>() for split nodes, indexed like TreeSplits
+    TVector<ui32> NonSymmetricNodeIdToLeafId;
+
     //! Categorical features, used in model in OneHot conditions or/and in CTR feature combinations
     TVector<TCatFeature> CatFeatures;
 
@@ -149,7 +193,9 @@ public:
             CatFeatures,
             FloatFeatures,
             OneHotFeatures,
-            CtrFeatures)
+            CtrFeatures,
+            NonSymmetricStepNodes,
+            NonSymmetricNodeIdToLeafId)
           == std::tie(
             other.ApproxDimension,
             other.TreeSplits,
@@ -159,7 +205,9 @@ public:
             other.CatFeatures,
             other.FloatFeatures,
             other.OneHotFeatures,
-            other.CtrFeatures);
+            other.CtrFeatures,
+            other.NonSymmetricStepNodes,
+            other.NonSymmetricNodeIdToLeafId);
     }
 
     bool operator!=(const TObliviousTrees& other) const {
@@ -193,12 +241,30 @@ public:
         if (fbObj->LeafValues()) {
             LeafValues.assign(fbObj->LeafValues()->begin(), fbObj->LeafValues()->end());
         }
+        if (fbObj->NonSymmetricStepNodes()) {
+            NonSymmetricStepNodes.resize(fbObj->NonSymmetricStepNodes()->size());
+            for (size_t i = 0; i < NonSymmetricStepNodes.size(); ++i) {
+                NonSymmetricStepNodes[i].FBDeserialize(fbObj->NonSymmetricStepNodes()->Get(i));
+            }
+        }
+        if (fbObj->NonSymmetricNodeIdToLeafId()) {
+            NonSymmetricNodeIdToLeafId.assign(
+                fbObj->NonSymmetricNodeIdToLeafId()->begin(),
+                fbObj->NonSymmetricNodeIdToLeafId()->end()
+            );
+        }
+        CB_ENSURE(
+            NonSymmetricStepNodes.empty()
+                || (NonSymmetricStepNodes.size() == TreeSplits.size()
+                    && NonSymmetricNodeIdToLeafId.size() == TreeSplits.size()),
+            "Bad non-symmetric tree nodes count: " << NonSymmetricStepNodes.size()
+        );
         if (fbObj->LeafWeights() && fbObj->LeafWeights()->size() > 0) {
             LeafWeights.resize(TreeSizes.size());
             CB_ENSURE(fbObj->LeafWeights()->size() * ApproxDimension == LeafValues.size(), "Bad leaf weights count: " << fbObj->LeafWeights()->size());
             auto leafValIter = fbObj->LeafWeights()->begin();
             for (size_t treeId = 0; treeId < TreeSizes.size(); ++treeId) {
-                const auto treeLeafCout = (1 << TreeSizes[treeId]);
+                const auto treeLeafCout = GetTreeLeafCount(treeId);
                 LeafWeights[treeId].assign(leafValIter, leafValIter + treeLeafCout);
                 leafValIter += treeLeafCout;
             }
@@ -224,6 +290,7 @@ public:
      * @param binSplits
      */
     void AddBinTree(const TVector<int>& binSplits) {
+        Y_ASSERT(IsOblivious());
         Y_ASSERT(TreeSplits.size() == TreeSizes.size() && TreeSizes.size() == TreeStartOffsets.size());
         TreeSplits.insert(TreeSplits.end(), binSplits.begin(), binSplits.end());
         TreeSizes.push_back(binSplits.ysize());
@@ -238,6 +305,12 @@ public:
         return TreeSizes.size();
     }
 
+    bool IsOblivious() const {
+        return NonSymmetricStepNodes.empty();
+    }
+
+    size_t GetTreeLeafCount(size_t treeIdx) const;
+
     /**
      * Truncate oblivous trees to contain only trees from [begin; end) interval.
      * @param begin
@@ -283,6 +356,11 @@ public:
         return MetaData->TreeFirstLeafOffsets;
     }
 
+    const TVector<int>& GetNonSymmetricTreeDepths() const {
+        CB_ENSURE(MetaData.Defined(), "metadata should be initialized");
+        return MetaData->NonSymmetricTreeDepths;
+    }
+
     const double* GetFirstLeafPtrForTree(size_t treeIdx) const {
         CB_ENSURE(MetaData.Defined(), "metadata should be initialized");
         return &LeafValues[MetaData->TreeFirstLeafOffsets[treeIdx]];
@@ -473,6 +551,16 @@ public:
      */
     void Load(IInputStream* s);
 
+    /**
+     * Deserialize model from memory buffer without copying ctr tables: they are kept as views into
+     * `binaryBuffer`. Buffer must stay alive while `dataHolder` is alive, ownership of `dataHolder`
+     * is shared with ctr provider (pass nullptr if buffer lifetime is managed by caller).
+     * @param binaryBuffer serialized model in CatboostBinary format
+     * @param binaryBufferSize
+     * @param dataHolder
+     */
+    void InitNonOwning(const void* binaryBuffer, size_t binaryBufferSize, TIntrusivePtr<TThrRefBase> dataHolder = nullptr);
+
     //! Check if TFullModel instance has valid CTR provider.
     // If no ctr features present it will return true
     bool HasValidCtrProvider() const {
@@ -492,12 +580,15 @@ public:
      *  trees 2..5 use treeStart = 2, treeEnd = 6
      * @param[out] results Flat double vector with indexation [objectIndex * ApproxDimension + classId].
      * For single class models it is just [objectIndex]
+     * @param[in] executor If not nullptr, object blocks are evaluated in parallel on executor threads.
+     * Results don't depend on thread count.
      */
     void CalcFlatTransposed(
         TConstArrayRef<TConstArrayRef<float>> transposedFeatures,
         size_t treeStart,
         size_t treeEnd,
-        TArrayRef<double> results) const;
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor = nullptr) const;
 
     /**
      * Special interface for model evaluation on flat feature vectors. Flat here means that float features and
@@ -510,20 +601,28 @@ public:
      *  trees 2..5 use treeStart = 2, treeEnd = 6
      * @param[out] results Flat double vector with indexation [objectIndex * ApproxDimension + classId].
      * For single class models it is just [objectIndex]
+     * @param[in] executor If not nullptr, object blocks are evaluated in parallel on executor threads.
+     * Results don't depend on thread count.
      */
     void CalcFlat(
         TConstArrayRef<TConstArrayRef<float>> features,
         size_t treeStart,
         size_t treeEnd,
-        TArrayRef<double> results) const;
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor = nullptr) const;
 
     /**
      * Call CalcFlat on all model trees
      * @param features
      * @param results
+     * @param executor
      */
-    void CalcFlat(TConstArrayRef<TConstArrayRef<float>> features, TArrayRef<double> results) const {
-        CalcFlat(features, 0, ObliviousTrees.TreeSizes.size(), results);
+    void CalcFlat(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor = nullptr) const {
+
+        CalcFlat(features, 0, ObliviousTrees.TreeSizes.size(), results, executor);
     }
 
     /**
@@ -591,26 +690,30 @@ public:
      * @param[in] treeStart
      * @param[in] treeEnd
      * @param[out] results results indexation is [objectIndex * ApproxDimension + classId]
+     * @param[in] executor optional executor for parallel evaluation of object blocks
      */
     void Calc(
         TConstArrayRef<TConstArrayRef<float>> floatFeatures,
         TConstArrayRef<TConstArrayRef<int>> catFeatures,
         size_t treeStart,
         size_t treeEnd,
-        TArrayRef<double> results) const;
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor = nullptr) const;
 
     /**
      * Evaluate raw formula predictions on user data. Uses all model trees
      * @param floatFeatures
      * @param catFeatures hashed cat feature values
      * @param results results indexation is [objectIndex * ApproxDimension + classId]
+     * @param executor optional executor for parallel evaluation of object blocks
      */
     void Calc(
         TConstArrayRef<TConstArrayRef<float>> floatFeatures,
         TConstArrayRef<TConstArrayRef<int>> catFeatures,
-        TArrayRef<double> results) const {
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor = nullptr) const {
 
-        Calc(floatFeatures, catFeatures, 0, ObliviousTrees.TreeSizes.size(), results);
+        Calc(floatFeatures, catFeatures, 0, ObliviousTrees.TreeSizes.size(), results, executor);
     }
 
     /**
@@ -636,26 +739,30 @@ public:
      * @param treeStart
      * @param treeEnd
      * @param results indexation is [objectIndex * ApproxDimension + classId]
+     * @param executor optional executor for parallel evaluation of object blocks
      */
     void Calc(
         TConstArrayRef<TConstArrayRef<float>> floatFeatures,
         TConstArrayRef<TVector<TStringBuf>> catFeatures,
         size_t treeStart,
         size_t treeEnd,
-        TArrayRef<double> results) const;
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor = nullptr) const;
 
     /**
      * Evaluate raw formula predictions for objects. Uses all model trees.
      * @param floatFeatures
      * @param catFeatures vector of vector of TStringBuf with categorical features strings
      * @param results indexation is [objectIndex * ApproxDimension + classId]
+     * @param executor optional executor for parallel evaluation of object blocks
      */
     void Calc(
         TConstArrayRef<TConstArrayRef<float>> floatFeatures,
         TConstArrayRef<TVector<TStringBuf>> catFeatures,
-        TArrayRef<double> results) const {
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor = nullptr) const {
 
-        Calc(floatFeatures, catFeatures, 0, ObliviousTrees.TreeSizes.size(), results);
+        Calc(floatFeatures, catFeatures, 0, ObliviousTrees.TreeSizes.size(), results, executor);
     }
 
     /**
@@ -696,6 +803,19 @@ TFullModel ReadModel(
     size_t binaryBufferSize,
     EModelType format = EModelType::CatboostBinary);
 
+/**
+ * Read CatboostBinary model from buffer, ctr tables are not copied and reference buffer memory,
+ * so buffer must outlive returned model and all its copies.
+ */
+TFullModel ReadZeroCopyModel(const void* binaryBuffer, size_t binaryBufferSize);
+
+/**
+ * Read CatboostBinary model via read-only memory mapping of the model file. Ctr tables are kept as
+ * views into the mapping, so they are not loaded into process memory and are shared through page cache
+ * by all processes using the same model file. Mapping is released with the last model copy.
+ */
+TFullModel ReadMappedModel(const TString& modelFile);
+
 /**
  * Export model in our binary or protobuf CoreML format
  * @param model
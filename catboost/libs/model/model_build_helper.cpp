@@ -63,6 +63,7 @@ void TObliviousTreeBuilder::AddTree(const TVector<TModelSplit>& modelSplits,
                                     TConstArrayRef<double> treeLeafValues,
                                     TConstArrayRef<double> treeLeafWeights
 ) {
+    CB_ENSURE(NonSymmetricTreeNodeChildren.empty(), "Oblivious and non-symmetric trees can't be mixed in one model");
     CB_ENSURE((1u << modelSplits.size()) * ApproxDimension == treeLeafValues.size());
     LeafValues.insert(LeafValues.end(), treeLeafValues.begin(), treeLeafValues.end());
     if (!treeLeafWeights.empty()) {
@@ -71,6 +72,98 @@ void TObliviousTreeBuilder::AddTree(const TVector<TModelSplit>& modelSplits,
     Trees.emplace_back(modelSplits);
 }
 
+// lays out tree nodes and leaves in breadth-first order, returns laid out node count
+static int AddNonSymmetricTreeNodes(
+    const TVector<TModelSplit>& nodeSplits,
+    const TVector<std::pair<int, int>>& nodeChildren,
+    const THashMap<TModelSplit, int>& binFeatureIndexes,
+    TObliviousTrees* trees
+) {
+    // items are node indexes or ~leafIdx for leaves
+    TVector<int> bfsQueue = {nodeSplits.empty() ? ~0 : 0};
+    for (size_t pos = 0; pos < bfsQueue.size(); ++pos) {
+        const int item = bfsQueue[pos];
+        auto& stepNode = trees->NonSymmetricStepNodes.emplace_back();
+        if (item < 0) {
+            trees->TreeSplits.push_back(0);
+            trees->NonSymmetricNodeIdToLeafId.push_back(~item);
+            continue;
+        }
+        trees->TreeSplits.push_back(binFeatureIndexes.at(nodeSplits[item]));
+        trees->NonSymmetricNodeIdToLeafId.push_back(Max<ui32>());
+        const auto childDiff = bfsQueue.size() - pos;
+        CB_ENSURE(childDiff + 1 <= Max<ui16>(), "Non-symmetric tree is too wide");
+        stepNode.LeftSubtreeDiff = childDiff;
+        stepNode.RightSubtreeDiff = childDiff + 1;
+        bfsQueue.push_back(nodeChildren[item].first);
+        bfsQueue.push_back(nodeChildren[item].second);
+    }
+    CB_ENSURE(bfsQueue.size() == 2 * nodeSplits.size() + 1, "Some tree nodes are unreachable from the root");
+    return bfsQueue.ysize();
+}
+
+void TObliviousTreeBuilder::AddNonSymmetricTree(
+    const TVector<TModelSplit>& nodeSplits,
+    const TVector<std::pair<int, int>>& nodeChildren,
+    const TVector<TVector<double>>& treeLeafValues,
+    TConstArrayRef<double> treeLeafWeights
+) {
+    CB_ENSURE(ApproxDimension == treeLeafValues.ysize());
+    const auto leafCount = treeLeafValues.at(0).size();
+
+    TVector<double> leafValues(ApproxDimension * leafCount);
+
+    for (size_t dimension = 0; dimension < treeLeafValues.size(); ++dimension) {
+        CB_ENSURE(treeLeafValues[dimension].size() == leafCount);
+        for (size_t leafId = 0; leafId < leafCount; ++leafId) {
+            leafValues[leafId * ApproxDimension + dimension] = treeLeafValues[dimension][leafId];
+        }
+    }
+    AddNonSymmetricTree(nodeSplits, nodeChildren, leafValues, treeLeafWeights);
+}
+
+void TObliviousTreeBuilder::AddNonSymmetricTree(
+    const TVector<TModelSplit>& nodeSplits,
+    const TVector<std::pair<int, int>>& nodeChildren,
+    TConstArrayRef<double> treeLeafValues,
+    TConstArrayRef<double> treeLeafWeights
+) {
+    CB_ENSURE(
+        NonSymmetricTreeNodeChildren.size() == Trees.size(),
+        "Oblivious and non-symmetric trees can't be mixed in one model"
+    );
+    CB_ENSURE(nodeSplits.size() == nodeChildren.size(), "Each tree node should have a split");
+    const size_t nodeCount = nodeSplits.size();
+    const size_t leafCount = nodeCount + 1;
+    CB_ENSURE(leafCount * ApproxDimension == treeLeafValues.size(), "Bad leaf values count: " << treeLeafValues.size());
+    CB_ENSURE(treeLeafWeights.empty() || treeLeafWeights.size() == leafCount, "Bad leaf weights count: " << treeLeafWeights.size());
+    // every node except the root and every leaf should have exactly one parent
+    TVector<ui32> nodeParentCount(nodeCount);
+    TVector<ui32> leafParentCount(leafCount);
+    for (const auto& [left, right] : nodeChildren) {
+        for (int child : {left, right}) {
+            if (child >= 0) {
+                CB_ENSURE(child > 0 && (size_t)child < nodeCount, "Bad tree node index: " << child);
+                ++nodeParentCount[child];
+            } else {
+                CB_ENSURE((size_t)~child < leafCount, "Bad tree leaf index: " << ~child);
+                ++leafParentCount[~child];
+            }
+        }
+    }
+    CB_ENSURE(
+        AllOf(nodeParentCount.begin() + Min<size_t>(1, nodeCount), nodeParentCount.end(), [] (ui32 count) { return count == 1; })
+            && AllOf(leafParentCount, [] (ui32 count) { return count == 1; }),
+        "Tree nodes and leaves should be referenced exactly once"
+    );
+    LeafValues.insert(LeafValues.end(), treeLeafValues.begin(), treeLeafValues.end());
+    if (!treeLeafWeights.empty()) {
+        LeafWeights.push_back(TVector<double>(treeLeafWeights.begin(), treeLeafWeights.end()));
+    }
+    Trees.emplace_back(nodeSplits);
+    NonSymmetricTreeNodeChildren.emplace_back(nodeChildren);
+}
+
 TObliviousTrees TObliviousTreeBuilder::Build() {
     TSet<TModelSplit> modelSplitSet;
     for (const auto& tree : Trees) {
@@ -108,16 +201,23 @@ TObliviousTrees TObliviousTreeBuilder::Build() {
     for (auto& feature : result.CatFeatures) {
         feature.UsedInModel = false;
     }
-    for (const auto& treeStruct : Trees) {
-        for (const auto& split : treeStruct) {
-            result.TreeSplits.push_back(binFeatureIndexes.at(split));
-        }
+    for (size_t treeIdx : xrange(Trees.size())) {
+        const auto& treeStruct = Trees[treeIdx];
         if (result.TreeStartOffsets.empty()) {
             result.TreeStartOffsets.push_back(0);
         } else {
             result.TreeStartOffsets.push_back(result.TreeStartOffsets.back() + result.TreeSizes.back());
         }
-        result.TreeSizes.push_back(treeStruct.ysize());
+        if (NonSymmetricTreeNodeChildren.empty()) {
+            for (const auto& split : treeStruct) {
+                result.TreeSplits.push_back(binFeatureIndexes.at(split));
+            }
+            result.TreeSizes.push_back(treeStruct.ysize());
+        } else {
+            result.TreeSizes.push_back(
+                AddNonSymmetricTreeNodes(treeStruct, NonSymmetricTreeNodeChildren[treeIdx], binFeatureIndexes, &result)
+            );
+        }
     }
     THashSet<int> usedCatFeatureIndexes;
     for (const auto& split : modelSplitSet) {
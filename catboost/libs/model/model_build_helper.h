@@ -25,10 +25,28 @@ public:
 
         AddTree(modelSplits, treeLeafValues, TVector<double>());
     }
+    /**
+     * Add non-symmetric tree. Node 0 is the root (if there are no nodes tree consists of a single leaf).
+     * nodeChildren[i] holds (left, right) children of node i: non-negative values are node indexes,
+     *  negative values are ~leafIdx. Left child is for objects that don't satisfy the node split.
+     * Non-symmetric trees can't be mixed with oblivious trees in one model.
+     */
+    void AddNonSymmetricTree(
+        const TVector<TModelSplit>& nodeSplits,
+        const TVector<std::pair<int, int>>& nodeChildren,
+        const TVector<TVector<double>>& treeLeafValues,
+        TConstArrayRef<double> treeLeafWeights);
+    void AddNonSymmetricTree(
+        const TVector<TModelSplit>& nodeSplits,
+        const TVector<std::pair<int, int>>& nodeChildren,
+        TConstArrayRef<double> treeLeafValues,
+        TConstArrayRef<double> treeLeafWeights);
     TObliviousTrees Build();
 private:
     int ApproxDimension = 1;
     TVector<TVector<TModelSplit>> Trees;
+    //! Empty for oblivious trees, otherwise has the same size as Trees
+    TVector<TVector<std::pair<int, int>>> NonSymmetricTreeNodeChildren;
     TVector<double> LeafValues;
     TVector<TVector<double>> LeafWeights;
     TVector<TFloatFeature> FloatFeatures;
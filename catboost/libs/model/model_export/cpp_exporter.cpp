@@ -2,54 +2,187 @@
 
 #include "export_helpers.h"
 
+#include <catboost/libs/model/formula_evaluator.h>
 #include <catboost/libs/model/static_ctr_provider.h>
 
+#include <library/json/json_reader.h>
 #include <library/resource/resource.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/map.h>
 #include <util/generic/set.h>
 #include <util/string/builder.h>
 #include <util/string/cast.h>
 #include <util/stream/input.h>
+#include <util/stream/str.h>
 
 namespace NCatboost {
     using namespace NCatboostModelExportHelpers;
 
+    TCatboostModelToCppConverter::TCatboostModelToCppConverter(
+        const TString& modelFile,
+        bool addFileFormatExtension,
+        const TString& userParametersJson
+    )
+        : Out(modelFile + (addFileFormatExtension ? ".cpp" : ""))
+    {
+        if (userParametersJson.empty()) {
+            return;
+        }
+        TStringInput is(userParametersJson);
+        NJson::TJsonValue params;
+        NJson::ReadJsonTree(&is, &params);
+        for (const auto& [name, value] : params.GetMapSafe()) {
+            if (name == "cpp_fixed_tree_depth") {
+                FixedTreeDepth = value.GetBooleanSafe();
+            } else {
+                CB_ENSURE(false, "Unknown JSON user param for exporting the model to C++: " << name);
+            }
+        }
+    }
+
     /*
      * Tiny code for case when cat features not present
      */
 
-    void TCatboostModelToCppConverter::WriteApplicator() {
-        Out << "/* Model applicator */" << '\n';
-        Out << "double ApplyCatboostModel(" << '\n';
-        Out << "    const std::vector<float>& features" << '\n';
-        Out << ") {" << '\n';
-        Out << "    const struct CatboostModel& model = CatboostModelStatic;" << '\n';
+    // documents in a batch are processed in blocks with binarized features in a stack buffer of at most this size
+    static constexpr size_t MaxBatchBinaryFeaturesBufferSize = 32768;
+    static constexpr size_t MaxBatchBlockSize = 128;
+
+    static void WriteCalcLeafIndex(IOutputStream& out, ui32 depth) {
+        out << "static inline unsigned int CalcLeafIndexDepth" << depth << "(" << '\n';
+        if (depth == 0) {
+            out << "    const unsigned char*," << '\n';
+            out << "    const unsigned short*," << '\n';
+            out << "    const unsigned char*" << '\n';
+            out << ") {" << '\n';
+            out << "    return 0;" << '\n';
+            out << "}" << '\n';
+            return;
+        }
+        out << "    const unsigned char* binaryFeatures," << '\n';
+        out << "    const unsigned short* splitFeatureIndex," << '\n';
+        out << "    const unsigned char* splitIdx" << '\n';
+        out << ") {" << '\n';
+        out << "    return";
+        for (ui32 level = 0; level < depth; ++level) {
+            out << '\n' << "        ((unsigned int)(binaryFeatures[splitFeatureIndex[" << level << "]] >= splitIdx["
+                << level << "]) << " << level << ")" << (level + 1 < depth ? " |" : ";");
+        }
+        out << '\n';
+        out << "}" << '\n';
+    }
+
+    static void WriteApplyTreeToBlock(IOutputStream& out, TIndent indent, const TString& depth) {
+        out << indent++ << "for (size_t docId = 0; docId < docCount; ++docId) {" << '\n';
+        out << indent << "result[docId] += leafValuesPtr[" << '\n';
+        out << indent << "    CalcLeafIndexDepth" << depth << "(" << '\n';
+        out << indent << "        binaryFeatures + docId * BinaryFeaturesRowSize," << '\n';
+        out << indent << "        splitFeatureIndexPtr," << '\n';
+        out << indent << "        splitIdxPtr)];" << '\n';
+        out << --indent << "}" << '\n';
+    }
+
+    void TCatboostModelToCppConverter::WriteApplicator(const TFullModel& model) {
+        const auto& trees = model.ObliviousTrees;
+        const size_t binaryFeaturesRowSize = Max<size_t>(trees.GetEffectiveBinaryFeaturesBucketsCount(), 1);
+        const size_t batchBlockSize = Max<size_t>(
+            Min(MaxBatchBlockSize, MaxBatchBinaryFeaturesBufferSize / binaryFeaturesRowSize),
+            1
+        );
+
+        Out << "/* Leaf index calculation for trees of each depth in the model, unrolled */" << '\n';
+        const TSet<int> treeDepths(trees.TreeSizes.begin(), trees.TreeSizes.end());
+        for (auto depth : treeDepths) {
+            WriteCalcLeafIndex(Out, SafeIntegerCast<ui32>(depth));
+            Out << '\n';
+        }
+
+        Out << "/* Binarized features of a document are stored in a row of BinaryFeaturesRowSize buckets */" << '\n';
+        Out << "static constexpr size_t BinaryFeaturesRowSize = " << binaryFeaturesRowSize << ";" << '\n';
+        Out << "static constexpr size_t BatchBlockSize = " << batchBlockSize << ";" << '\n';
         Out << '\n';
-        Out << "    /* Binarise features */" << '\n';
-        Out << "    std::vector<unsigned char> binaryFeatures(model.BinaryFeatureCount);" << '\n';
-        Out << "    unsigned int binFeatureIndex = 0;" << '\n';
+
+        Out << "/* Binarise features: bucket value is the number of its borders that are less than the feature value */" << '\n';
+        Out << "static inline void BinarizeFloatFeatures(const float* features, unsigned char* binaryFeatures) {" << '\n';
+        Out << "    const struct CatboostModel& model = CatboostModelStatic;" << '\n';
+        Out << "    const float* borders = model.Borders;" << '\n';
         Out << "    for (unsigned int i = 0; i < model.FloatFeatureCount; ++i) {" << '\n';
-        Out << "        for(unsigned int j = 0; j < model.BorderCounts[i]; ++j) {" << '\n';
-        Out << "            binaryFeatures[binFeatureIndex] = (unsigned char)(features[i] > model.Borders[binFeatureIndex]);" << '\n';
-        Out << "            ++binFeatureIndex;" << '\n';
+        Out << "        const unsigned int borderCount = model.BorderCounts[i];" << '\n';
+        Out << "        const unsigned int lessBordersCount" << '\n';
+        Out << "            = (unsigned int)(std::lower_bound(borders, borders + borderCount, features[i]) - borders);" << '\n';
+        Out << "        for (unsigned int bucketBegin = 0; bucketBegin < borderCount; bucketBegin += " << MAX_VALUES_PER_BIN << ") {" << '\n';
+        Out << "            *binaryFeatures++ = (unsigned char)std::min(" << '\n';
+        Out << "                lessBordersCount - std::min(lessBordersCount, bucketBegin)," << '\n';
+        Out << "                " << MAX_VALUES_PER_BIN << "u);" << '\n';
         Out << "        }" << '\n';
+        Out << "        borders += borderCount;" << '\n';
         Out << "    }" << '\n';
+        Out << "}" << '\n';
         Out << '\n';
-        Out << "    /* Extract and sum values from trees */" << '\n';
-        Out << "    double result = 0.0;" << '\n';
-        Out << "    const unsigned int* treeSplitsPtr = model.TreeSplits;" << '\n';
-        Out << "    const double* leafValuesForCurrentTreePtr = model.LeafValues;" << '\n';
+
+        Out << "/* Extract and sum values from trees for a block of documents, trees are processed one by one */" << '\n';
+        Out << "static inline void ApplyTrees(const unsigned char* binaryFeatures, size_t docCount, double* result) {" << '\n';
+        Out << "    const struct CatboostModel& model = CatboostModelStatic;" << '\n';
+        Out << "    const unsigned short* splitFeatureIndexPtr = model.TreeSplitFeatureIndex;" << '\n';
+        Out << "    const unsigned char* splitIdxPtr = model.TreeSplitIdxs;" << '\n';
+        Out << "    const double* leafValuesPtr = model.LeafValues;" << '\n';
         Out << "    for (unsigned int treeId = 0; treeId < model.TreeCount; ++treeId) {" << '\n';
-        Out << "        const unsigned int currentTreeDepth = model.TreeDepth[treeId];" << '\n';
-        Out << "        unsigned int index = 0;" << '\n';
-        Out << "        for (unsigned int depth = 0; depth < currentTreeDepth; ++depth) {" << '\n';
-        Out << "            index |= (binaryFeatures[treeSplitsPtr[depth]] << depth);" << '\n';
+        if (FixedTreeDepth) {
+            const int treeDepth = *treeDepths.begin();
+            WriteApplyTreeToBlock(Out, TIndent(2), ToString(treeDepth));
+            Out << "        splitFeatureIndexPtr += " << treeDepth << ";" << '\n';
+            Out << "        splitIdxPtr += " << treeDepth << ";" << '\n';
+            Out << "        leafValuesPtr += " << (1 << treeDepth) << ";" << '\n';
+        } else {
+            Out << "        const unsigned int currentTreeDepth = model.TreeDepth[treeId];" << '\n';
+            Out << "        switch (currentTreeDepth) {" << '\n';
+            for (auto depth : treeDepths) {
+                Out << "            case " << depth << ":" << '\n';
+                WriteApplyTreeToBlock(Out, TIndent(4), ToString(depth));
+                Out << "                break;" << '\n';
+            }
+            Out << "        }" << '\n';
+            Out << "        splitFeatureIndexPtr += currentTreeDepth;" << '\n';
+            Out << "        splitIdxPtr += currentTreeDepth;" << '\n';
+            Out << "        leafValuesPtr += (1 << currentTreeDepth);" << '\n';
+        }
+        Out << "    }" << '\n';
+        Out << "}" << '\n';
+        Out << '\n';
+
+        Out << "/* Batch model applicator, no memory is allocated" << '\n';
+        Out << " * floatFeatures is a row-major matrix of docCount rows with FloatFeatureCount features," << '\n';
+        Out << " * raw formula values of documents are written to result" << '\n';
+        Out << " */" << '\n';
+        Out << "void ApplyCatboostModel(" << '\n';
+        Out << "    const float* floatFeatures," << '\n';
+        Out << "    size_t docCount," << '\n';
+        Out << "    double* result" << '\n';
+        Out << ") {" << '\n';
+        Out << "    const struct CatboostModel& model = CatboostModelStatic;" << '\n';
+        Out << '\n';
+        Out << "    unsigned char binaryFeatures[BatchBlockSize * BinaryFeaturesRowSize];" << '\n';
+        Out << "    for (size_t blockStart = 0; blockStart < docCount; blockStart += BatchBlockSize) {" << '\n';
+        Out << "        const size_t blockSize = std::min(docCount - blockStart, BatchBlockSize);" << '\n';
+        Out << "        for (size_t docId = 0; docId < blockSize; ++docId) {" << '\n';
+        Out << "            BinarizeFloatFeatures(" << '\n';
+        Out << "                floatFeatures + (blockStart + docId) * model.FloatFeatureCount," << '\n';
+        Out << "                binaryFeatures + docId * BinaryFeaturesRowSize);" << '\n';
+        Out << "            result[blockStart + docId] = 0.0;" << '\n';
         Out << "        }" << '\n';
-        Out << "        result += leafValuesForCurrentTreePtr[index];" << '\n';
-        Out << "        treeSplitsPtr += currentTreeDepth;" << '\n';
-        Out << "        leafValuesForCurrentTreePtr += (1 << currentTreeDepth);" << '\n';
+        Out << "        ApplyTrees(binaryFeatures, blockSize, result + blockStart);" << '\n';
         Out << "    }" << '\n';
+        Out << "}" << '\n';
+        Out << '\n';
+
+        Out << "/* Model applicator */" << '\n';
+        Out << "double ApplyCatboostModel(" << '\n';
+        Out << "    const std::vector<float>& features" << '\n';
+        Out << ") {" << '\n';
+        Out << "    double result = 0.0;" << '\n';
+        Out << "    ApplyCatboostModel(features.data(), 1, &result);" << '\n';
         Out << "    return result;" << '\n';
         Out << "}" << '\n';
 
@@ -66,34 +199,53 @@ namespace NCatboost {
     void TCatboostModelToCppConverter::WriteModel(const TFullModel& model) {
         CB_ENSURE(!model.HasCategoricalFeatures(), "Export of model with categorical features to cpp is not yet supported.");
         CB_ENSURE(model.ObliviousTrees.ApproxDimension == 1, "Export of MultiClassification model to cpp is not supported.");
+
+        const auto& trees = model.ObliviousTrees;
+        if (FixedTreeDepth) {
+            CB_ENSURE(
+                !trees.TreeSizes.empty()
+                    && AllOf(trees.TreeSizes, [&] (int treeSize) { return treeSize == trees.TreeSizes[0]; }),
+                "cpp_fixed_tree_depth requires all trees in the model to have the same depth"
+            );
+        }
+
         Out << "/* Model data */" << '\n';
 
         int binaryFeatureCount = GetBinaryFeatureCount(model);
+        const auto& bins = trees.GetRepackedBins();
 
-        Out << "static const struct CatboostModel {" << '\n';
+        Out << "static constexpr struct CatboostModel {" << '\n';
         Out << "    unsigned int FloatFeatureCount = " << model.GetNumFloatFeatures() << ";" << '\n';
-        Out << "    unsigned int BinaryFeatureCount = " << binaryFeatureCount << ";" << '\n';
-        Out << "    unsigned int TreeCount = " << model.ObliviousTrees.TreeSizes.size() << ";" << '\n';
+        Out << "    unsigned int BinaryFeatureCount = " << trees.GetEffectiveBinaryFeaturesBucketsCount() << ";" << '\n';
+        Out << "    unsigned int TreeCount = " << trees.TreeSizes.size() << ";" << '\n';
 
-        Out << "    unsigned int TreeDepth[" << model.ObliviousTrees.TreeSizes.size() << "] = {" << OutputArrayInitializer(model.ObliviousTrees.TreeSizes) << "};" << '\n';
-        Out << "    unsigned int TreeSplits[" << model.ObliviousTrees.TreeSplits.size() << "] = {" << OutputArrayInitializer(model.ObliviousTrees.TreeSplits) << "};" << '\n';
+        if (!FixedTreeDepth) {
+            Out << "    unsigned int TreeDepth[" << trees.TreeSizes.size() << "] = {" << OutputArrayInitializer(trees.TreeSizes) << "};" << '\n';
+        }
+        Out << "    unsigned short TreeSplitFeatureIndex[" << bins.size() << "] = {" << OutputArrayInitializer([&bins](size_t i) { return (int)bins[i].FeatureIndex; }, bins.size()) << "};" << '\n';
+        Out << "    unsigned char TreeSplitIdxs[" << bins.size() << "] = {" << OutputArrayInitializer([&bins](size_t i) { return (int)bins[i].SplitIdx; }, bins.size()) << "};" << '\n';
 
-        Out << "    unsigned int BorderCounts[" << model.ObliviousTrees.GetNumFloatFeatures() << "] = {" << OutputBorderCounts(model) << "};" << '\n';
+        Out << "    unsigned int BorderCounts[" << trees.GetNumFloatFeatures() << "] = {" << OutputBorderCounts(model) << "};" << '\n';
 
         Out << "    float Borders[" << binaryFeatureCount << "] = {" << OutputBorders(model, true) << "};" << '\n';
 
         Out << '\n';
         Out << "    /* Aggregated array of leaf values for trees. Each tree is represented by a separate line: */" << '\n';
-        Out << "    double LeafValues[" << model.ObliviousTrees.LeafValues.size() << "] = {" << OutputLeafValues(model, TIndent(1));
+        Out << "    double LeafValues[" << trees.LeafValues.size() << "] = {" << OutputLeafValues(model, TIndent(1));
         Out << "    };" << '\n';
-        Out << "} CatboostModelStatic;" << '\n';
+        Out << "} CatboostModelStatic = {};" << '\n';
         Out << '\n';
     }
 
     void TCatboostModelToCppConverter::WriteHeader(bool forCatFeatures) {
+        Out << "#include <algorithm>" << '\n';
         if (forCatFeatures) {
            Out << "#include <cassert>" << '\n';
         }
+        Out << "#include <cstddef>" << '\n';
+        if (forCatFeatures) {
+           Out << "#include <cstring>" << '\n';
+        }
         Out << "#include <string>" << '\n';
         Out << "#include <vector>" << '\n';
         if (forCatFeatures) {
@@ -279,6 +431,21 @@ namespace NCatboost {
             << OutputArrayInitializer([&model](size_t i) { return model.ObliviousTrees.OneHotFeatures[i].CatFeatureIndex; }, model.ObliviousTrees.OneHotFeatures.size())
             << "};" << '\n';
 
+        // indices in CatFeaturesIndex, precalculated to avoid the search for each document
+        TVector<size_t> oneHotCatFeaturePackedIndex;
+        for (const auto& oneHotFeature : model.ObliviousTrees.OneHotFeatures) {
+            const auto catFeatureIt = FindIf(
+                model.ObliviousTrees.CatFeatures,
+                [&oneHotFeature] (const TCatFeature& catFeature) {
+                    return catFeature.FeatureIndex == oneHotFeature.CatFeatureIndex;
+                }
+            );
+            CB_ENSURE(catFeatureIt != model.ObliviousTrees.CatFeatures.end(), "One hot feature is not in model cat features");
+            oneHotCatFeaturePackedIndex.push_back(catFeatureIt - model.ObliviousTrees.CatFeatures.begin());
+        }
+        Out << indent << "std::vector<unsigned int> OneHotCatFeaturePackedIndex = {"
+            << OutputArrayInitializer(oneHotCatFeaturePackedIndex) << "};" << '\n';
+
         Out << indent++ << "std::vector<std::vector<int>> OneHotHashValues = {" << '\n';
         comma.ResetCount(model.ObliviousTrees.OneHotFeatures.size());
         for (const auto& oneHotFeature : model.ObliviousTrees.OneHotFeatures) {
@@ -308,16 +475,28 @@ namespace NCatboost {
         Out << '\n';
 
         indent--;
-        Out << indent++ << "static std::unordered_map<std::string, int> CatFeatureHashes = {" << '\n';
+
+        // sorted by string for binary search in GetHash
+        TMap<TString, int> orderedCatFeatureHashes;
         if (catFeaturesHashToString != nullptr) {
-            TSet<int> ordered_keys;
-            for (const auto& key_value: *catFeaturesHashToString) {
-                ordered_keys.insert(key_value.first);
-            }
-            for (const auto& key_value: ordered_keys) {
-                Out << indent << "{" << catFeaturesHashToString->at(key_value).Quote() << ", "  << key_value << "},\n";
+            for (const auto& [hash, catFeatureString] : *catFeaturesHashToString) {
+                orderedCatFeatureHashes.emplace(catFeatureString, (int)hash);
             }
         }
+        Out << "struct CatFeatureHash {" << '\n';
+        Out << "    const char* String;" << '\n';
+        Out << "    int Hash;" << '\n';
+        Out << "};" << '\n';
+        Out << '\n';
+        Out << "static constexpr size_t CatFeatureHashCount = " << orderedCatFeatureHashes.size() << ";" << '\n';
+        // non-empty array with a dummy element if there are no hashes
+        Out << indent++ << "static constexpr CatFeatureHash CatFeatureHashes[" << Max<size_t>(orderedCatFeatureHashes.size(), 1) << "] = {" << '\n';
+        if (orderedCatFeatureHashes.empty()) {
+            Out << indent << "{\"\", 0}" << '\n';
+        }
+        for (const auto& [catFeatureString, hash] : orderedCatFeatureHashes) {
+            Out << indent << "{" << catFeatureString.Quote() << ", "  << hash << "},\n";
+        }
         Out << --indent << "};" << '\n';
         Out << '\n';
     }
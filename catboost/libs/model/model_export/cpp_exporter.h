@@ -12,27 +12,30 @@ namespace NCatboost {
     private:
         TOFStream Out;
 
+        /* "cpp_fixed_tree_depth" user parameter: generate code specialized for the depth shared by all trees,
+         * supported only for models without categorical features
+         */
+        bool FixedTreeDepth = false;
+
     public:
-        TCatboostModelToCppConverter(const TString& modelFile, bool addFileFormatExtension, const TString& userParametersJson)
-            : Out(modelFile + (addFileFormatExtension ? ".cpp" : ""))
-        {
-            CB_ENSURE(userParametersJson.empty(), "JSON user params for exporting the model to C++ are not supported");
-        };
+        TCatboostModelToCppConverter(const TString& modelFile, bool addFileFormatExtension, const TString& userParametersJson);
 
         void Write(const TFullModel& model, const THashMap<ui32, TString>* catFeaturesHashToString = nullptr) override {
+            CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Export of non-symmetric trees to C++ is not supported");
             if (model.HasCategoricalFeatures()) {
+                CB_ENSURE(!FixedTreeDepth, "cpp_fixed_tree_depth is not supported for models with categorical features");
                 WriteHeader(/*forCatFeatures*/true);
                 WriteModelCatFeatures(model, catFeaturesHashToString);
                 WriteApplicatorCatFeatures();
             } else {
                 WriteHeader(/*forCatFeatures*/false);
                 WriteModel(model);
-                WriteApplicator();
+                WriteApplicator(model);
             }
         }
 
     private:
-        void WriteApplicator();
+        void WriteApplicator(const TFullModel& model);
         void WriteModel(const TFullModel& model);
         void WriteHeader(bool forCatFeatures);
         void WriteCTRStructs();
@@ -20,6 +20,7 @@ namespace NCatboost {
         };
 
         void Write(const TFullModel& model, const THashMap<ui32, TString>* catFeaturesHashToString) override {
+            CB_ENSURE(model.ObliviousTrees.IsOblivious(), "Export of non-symmetric trees to Python is not supported");
             if (model.HasCategoricalFeatures()) {
                 CB_ENSURE(catFeaturesHashToString != nullptr, "need pool to output model hashes");
             }
@@ -1,7 +1,13 @@
-static int GetHash(const std::string& catFeature, const std::unordered_map<std::string, int>& catFeatureHashes) {
-    const auto keyValue = catFeatureHashes.find(catFeature);
-    if (keyValue != catFeatureHashes.end()) {
-        return keyValue->second;
+/* CatFeatureHashes are sorted by String */
+static int GetHash(const std::string& catFeature) {
+    const CatFeatureHash* catFeatureHashesEnd = CatFeatureHashes + CatFeatureHashCount;
+    const CatFeatureHash* keyValue = std::lower_bound(
+        CatFeatureHashes,
+        catFeatureHashesEnd,
+        catFeature.c_str(),
+        [](const CatFeatureHash& lhs, const char* rhs) { return std::strcmp(lhs.String, rhs) < 0; });
+    if ((keyValue != catFeatureHashesEnd) && (std::strcmp(keyValue->String, catFeature.c_str()) == 0)) {
+        return keyValue->Hash;
     } else {
         return 0x7fFFffFF;
     }
@@ -20,28 +26,24 @@ double ApplyCatboostModel(
     std::vector<unsigned char> binaryFeatures(model.BinaryFeatureCount, 0);
     unsigned int binFeatureIndex = 0;
     {
-        /* Binarize float features */
+        /* Binarize float features: the number of borders that are less than the feature value */
         for (size_t i = 0; i < model.FloatFeatureBorders.size(); ++i) {
-            for (const float border : model.FloatFeatureBorders[i]) {
-                binaryFeatures[binFeatureIndex] += (unsigned char)(floatFeatures[i] > border);
-            }
+            const std::vector<float>& borders = model.FloatFeatureBorders[i];
+            binaryFeatures[binFeatureIndex]
+                = (unsigned char)(std::lower_bound(borders.begin(), borders.end(), floatFeatures[i]) - borders.begin());
             ++binFeatureIndex;
         }
     }
 
     std::vector<int> transposedHash(model.CatFeatureCount);
     for (size_t i = 0; i < model.CatFeatureCount; ++i) {
-        transposedHash[i] = GetHash(catFeatures[i], CatFeatureHashes);
+        transposedHash[i] = GetHash(catFeatures[i]);
     }
 
     if (model.OneHotCatFeatureIndex.size() > 0) {
         /* Binarize one hot cat features */
-        std::unordered_map<int, int> catFeaturePackedIndexes;
-        for (unsigned int i = 0; i < model.CatFeatureCount; ++i) {
-            catFeaturePackedIndexes[model.CatFeaturesIndex[i]] = i;
-        };
         for (unsigned int i = 0; i < model.OneHotCatFeatureIndex.size(); ++i) {
-            const auto catIdx = catFeaturePackedIndexes.at(model.OneHotCatFeatureIndex[i]);
+            const auto catIdx = model.OneHotCatFeaturePackedIndex[i];
             const auto hash = transposedHash[catIdx];
             for (unsigned int borderIdx = 0; borderIdx < model.OneHotHashValues[i].size(); ++borderIdx) {
                 binaryFeatures[binFeatureIndex] |= (unsigned char)(hash == model.OneHotHashValues[i][borderIdx]) * (borderIdx + 1);
@@ -88,7 +88,12 @@ static void ParseFeatures(
     }
 }
 
+#ifdef BATCH_APPLY
+// models without categorical features only
+extern void ApplyCatboostModel(const float* floatFeatures, size_t docCount, double* result);
+#else
 extern double ApplyCatboostModel(const vector<float>& floatFeatures, const vector<string>& catFeatures);
+#endif
 
 int main(int argc, char *argv[]) {
     assert(argc == 4);  // main.exe test.tsv cd.tsv predictions.txt
@@ -101,11 +106,20 @@ int main(int argc, char *argv[]) {
 
     ifstream test(argv[1]);
     ofstream predictions(argv[3]);
+    predictions << "DocId" << DELIMITER << "RawFormulaVal" << endl;
+#ifdef BATCH_APPLY
+    // features of all documents in a row-major matrix, applied with one call
+    vector<float> floatFeatures;
+    vector<string> catFeatures;
+#endif
+    size_t docCount = 0;
     string line;
-    for (size_t docId = 0; getline(test, line); ++docId) {
+    for (; getline(test, line); ++docCount) {
+#ifndef BATCH_APPLY
         vector<float> floatFeatures;
         vector<string> catFeatures;
-        if (docId == 0) {
+#endif
+        if (docCount == 0) {
             // Column description may not mention all columns,
             // so the actual number of columns is not known up to this point.
             size_t columnCount = 1 + count(line.begin(), line.end(), DELIMITER);
@@ -113,13 +127,21 @@ int main(int argc, char *argv[]) {
         }
         ParseFeatures(line, floatColumns, catColumns, &floatFeatures, &catFeatures);
 
+#ifndef BATCH_APPLY
         double rawFormulaVal = ApplyCatboostModel(floatFeatures, catFeatures);
+        predictions << docCount << DELIMITER << rawFormulaVal << endl;
+#endif
+    }
 
-        if (docId == 0) {
-            predictions << "DocId" << DELIMITER << "RawFormulaVal" << endl;
-        }
-        predictions << docId << DELIMITER << rawFormulaVal << endl;
+#ifdef BATCH_APPLY
+    assert(catFeatures.empty());
+    assert(floatFeatures.size() == docCount * floatColumns.size());
+    vector<double> rawFormulaVals(docCount);
+    ApplyCatboostModel(floatFeatures.data(), docCount, rawFormulaVals.data());
+    for (size_t docId = 0; docId < docCount; ++docId) {
+        predictions << docId << DELIMITER << rawFormulaVals[docId] << endl;
     }
+#endif
 
     return 0;
 }
@@ -1,3 +1,4 @@
+import json
 import numpy as np
 import os
 import pytest
@@ -60,10 +61,13 @@ def _check_data(data1, data2, rtol=0.001):
     return np.all(np.isclose(data1, data2, rtol=rtol, equal_nan=True))
 
 
-@pytest.mark.parametrize('dataset', ['adult', 'higgs'])
-def test_cpp_export(dataset):
-    model_cpp, _, model_cbm = _get_cpp_py_cbm_model(dataset)
+# batch applies the model to the whole test set with one call of the batch API (models without cat features only)
+def _check_cpp_export(dataset, model_cpp, model_cbm, batch=False):
     _, test_path, cd_path = _get_train_test_cd_path(dataset)
+    _check_cpp_export_on_data(test_path, cd_path, model_cpp, model_cbm, batch)
+
+
+def _check_cpp_export_on_data(test_path, cd_path, model_cpp, model_cbm, batch):
 
     # form the commands we are going to run
 
@@ -74,8 +78,12 @@ def test_cpp_export(dataset):
 
     if os.name == 'posix':
         compile_cmd = ['g++', '-std=c++14', '-o', applicator_exe]
+        if batch:
+            compile_cmd += ['-DBATCH_APPLY']
     else:
         compile_cmd = ['cl.exe', '-Fe' + applicator_exe]
+        if batch:
+            compile_cmd += ['-DBATCH_APPLY']
     compile_cmd += [applicator_cpp, model_cpp]
     apply_cmd = [applicator_exe, test_path, cd_path, predictions_path]
     calc_cmd = [CATBOOST_APP_PATH, 'calc',
@@ -103,6 +111,71 @@ def test_cpp_export(dataset):
             raise
 
 
+@pytest.mark.parametrize('dataset', ['adult', 'higgs'])
+def test_cpp_export(dataset):
+    model_cpp, _, model_cbm = _get_cpp_py_cbm_model(dataset)
+    _check_cpp_export(dataset, model_cpp, model_cbm)
+
+
+def test_cpp_export_batch():
+    model_cpp, _, model_cbm = _get_cpp_py_cbm_model('higgs')
+    _check_cpp_export('higgs', model_cpp, model_cbm, batch=True)
+
+
+@pytest.mark.parametrize('batch', [False, True], ids=['batch=False', 'batch=True'])
+def test_cpp_export_fixed_tree_depth(batch):
+    train_pool, _ = _get_train_test_pool('higgs')
+    model = CatBoost({'iterations': 40, 'depth': 5, 'random_seed': 0, 'loss_function': 'Logloss'})
+    model.fit(train_pool)
+
+    model_cbm = yatest.common.test_output_path('model.cbm')
+    model.save_model(model_cbm)
+    model_cpp = yatest.common.test_output_path('model.cpp')
+    model.save_model(model_cpp, format='cpp', export_parameters={'cpp_fixed_tree_depth': True})
+
+    _check_cpp_export('higgs', model_cpp, model_cbm, batch=batch)
+
+
+# features with more than 254 borders are binarized into several buckets
+@pytest.mark.parametrize('batch', [False, True], ids=['batch=False', 'batch=True'])
+def test_cpp_export_many_borders(batch):
+    # model keeps only borders used in splits, so every border of the only feature separates values with
+    # different targets: 256 distinct values give 255 borders
+    random = np.random.RandomState(0)
+    values = np.arange(256, dtype=np.float32)
+    value_targets = random.normal(size=values.size)
+    train_pool = Pool(np.repeat(values, 20).reshape(-1, 1), label=np.repeat(value_targets, 20))
+    model = CatBoost({
+        'iterations': 1000,
+        'depth': 6,
+        'border_count': 255,
+        'random_seed': 0,
+        'loss_function': 'RMSE',
+    })
+    model.fit(train_pool)
+
+    model_cbm = yatest.common.test_output_path('model.cbm')
+    model.save_model(model_cbm)
+    model_cpp = yatest.common.test_output_path('model.cpp')
+    model.save_model(model_cpp, format='cpp')
+    model_json = yatest.common.test_output_path('model.json')
+    model.save_model(model_json, format='json')
+    with open(model_json) as f:
+        float_features = json.load(f)['features_info']['float_features']
+    assert max(len(float_feature['borders']) for float_feature in float_features) > 254
+
+    # values equal to borders are in the test set too
+    test_path = yatest.common.test_output_path('test.tsv')
+    with open(test_path, 'w') as f:
+        for value in np.concatenate([values, values + 0.5]):
+            f.write('0\t{:.9g}\n'.format(value))
+    cd_path = yatest.common.test_output_path('test.cd')
+    with open(cd_path, 'w') as f:
+        f.write('0\tTarget\n')
+
+    _check_cpp_export_on_data(test_path, cd_path, model_cpp, model_cbm, batch)
+
+
 def _predict_python(test_pool, apply_catboost_model):
     pred_python = []
     cat_feature_indices = test_pool.get_cat_feature_indices()
@@ -227,6 +227,7 @@ void TStaticCtrProvider::SetupBinFeatureIndexes(const TVector<TFloatFeature>& fl
 TIntrusivePtr<ICtrProvider> TStaticCtrProvider::Clone() const {
     TIntrusivePtr<TStaticCtrProvider> result = new TStaticCtrProvider();
     result->CtrData = CtrData;
+    result->DataHolder = DataHolder;
     return result;
 }
 
@@ -342,6 +343,13 @@ static void MergeBuckets(const TVector<const TCtrValueTable*>& tables, TCtrValue
     }
 }
 
+namespace {
+    class TDataHoldersCollection : public TThrRefBase {
+    public:
+        TVector<TIntrusivePtr<TThrRefBase>> DataHolders;
+    };
+}
+
 TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(const TVector<const TStaticCtrProvider*>& providers, ECtrTableMergePolicy mergePolicy) {
     if (providers.empty()) {
         return TIntrusivePtr<TStaticCtrProvider>();
@@ -349,8 +357,19 @@ TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(const TVector<cons
     TIntrusivePtr<TStaticCtrProvider> result = new TStaticCtrProvider();
     if (providers.size() == 1) {
         result->CtrData = providers[0]->CtrData;
+        result->DataHolder = providers[0]->DataHolder;
         return result;
     }
+    // merged tables may be views into memory of any source provider loaded with LoadNonOwning
+    TIntrusivePtr<TDataHoldersCollection> dataHolders = MakeIntrusive<TDataHoldersCollection>();
+    for (const auto& provider: providers) {
+        if (provider->DataHolder) {
+            dataHolders->DataHolders.push_back(provider->DataHolder);
+        }
+    }
+    if (!dataHolders->DataHolders.empty()) {
+        result->DataHolder = dataHolders;
+    }
     THashMap<TModelCtrBase, TVector<const TCtrValueTable*>> valuesMap;
     for (const auto& provider: providers) {
         for (const auto& [ctrBase, ctrValueTables] : provider->CtrData.LearnCtrs) {
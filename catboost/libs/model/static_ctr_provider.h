@@ -6,7 +6,9 @@
 #include <catboost/libs/helpers/exception.h>
 
 #include <util/generic/hash.h>
+#include <util/generic/ptr.h>
 #include <util/generic/utility.h>
+#include <util/stream/mem.h>
 
 #include <functional>
 
@@ -57,6 +59,17 @@ public:
 
     void Load(IInputStream* inp) override {
         ::Load(inp, CtrData);
+        DataHolder.Reset();
+    }
+
+    /**
+     * Load ctr tables as views into memory of `inp` without copying.
+     * `dataHolder` should own this memory (or be nullptr if memory is owned by caller),
+     * it is shared with clones of this provider.
+     */
+    void LoadNonOwning(TMemoryInput* inp, TIntrusivePtr<TThrRefBase> dataHolder) {
+        CtrData.LoadThin(inp);
+        DataHolder = std::move(dataHolder);
     }
 
     TString ModelPartIdentifier() const override {
@@ -73,9 +86,14 @@ public:
 
     virtual TIntrusivePtr<ICtrProvider> Clone() const override;
 
+    friend TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(
+        const TVector<const TStaticCtrProvider*>& providers,
+        ECtrTableMergePolicy mergePolicy);
+
 public:
     TCtrData CtrData;
 private:
+    TIntrusivePtr<TThrRefBase> DataHolder;
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
     THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
@@ -3,9 +3,14 @@
 #include <catboost/libs/data_new/data_provider_builders.h>
 #include <catboost/libs/model/formula_evaluator.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_build_helper.h>
 #include <catboost/libs/train_lib/train_model.h>
 
 #include <util/folder/tempdir.h>
+#include <util/generic/serialized_enum.h>
+#include <util/random/fast.h>
+
+#include <cmath>
 
 
 using namespace NCB;
@@ -73,6 +78,79 @@ static TFullModel MultiValueFloatModel() {
     return model;
 }
 
+static TFullModel NonSymmetricFloatModel() {
+    const TVector<TFloatFeature> floatFeatures = {
+        TFloatFeature{false, 0, 0, {}, ""},
+        TFloatFeature{false, 1, 1, {}, ""}
+    };
+    TObliviousTreeBuilder builder(floatFeatures, {}, 1);
+    // f0 > 0.5 ? (f1 > 0.5 ? 3 : 2) : 1
+    builder.AddNonSymmetricTree(
+        {TModelSplit(TFloatSplit{0, 0.5f}), TModelSplit(TFloatSplit{1, 0.5f})},
+        {{~0, 1}, {~1, ~2}},
+        TVector<TVector<double>>{{1., 2., 3.}},
+        TVector<double>{1., 1., 1.}
+    );
+    // single leaf
+    builder.AddNonSymmetricTree({}, {}, TVector<TVector<double>>{{10.}}, TVector<double>{3.});
+    TFullModel model;
+    model.ObliviousTrees = builder.Build();
+    model.UpdateDynamicData();
+    return model;
+}
+
+static TFullModel RandomFloatModel(ui32 featureCount, ui32 borderCount, ui32 treeCount, ui32 maxDepth) {
+    TFastRng64 rng(42);
+    TFullModel model;
+    int binFeatureCount = 0;
+    for (ui32 featureIdx : xrange(featureCount)) {
+        TFloatFeature feature(featureIdx % 2 == 0, featureIdx, featureIdx, {});
+        if (feature.HasNans) {
+            feature.NanValueTreatment = featureIdx % 4 == 0
+                ? NCatBoostFbs::ENanValueTreatment_AsFalse
+                : NCatBoostFbs::ENanValueTreatment_AsTrue;
+        }
+        for (auto i : xrange(borderCount)) {
+            feature.Borders.push_back(-1.0f + 2.0f * i / borderCount);
+        }
+        binFeatureCount += feature.Borders.size();
+        model.ObliviousTrees.FloatFeatures.push_back(std::move(feature));
+    }
+    for (ui32 treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
+        const ui32 depth = 1 + treeIdx % maxDepth;
+        TVector<int> tree;
+        for (ui32 level = 0; level < depth; ++level) {
+            tree.push_back(rng.Uniform(binFeatureCount));
+        }
+        model.ObliviousTrees.AddBinTree(tree);
+        for (ui32 leaf = 0; leaf < (1u << depth); ++leaf) {
+            model.ObliviousTrees.LeafValues.push_back(rng.GenRandReal1());
+        }
+    }
+    model.UpdateDynamicData();
+    return model;
+}
+
+static TVector<ui8> BinarizeWholeDataset(const TFullModel& model, TConstArrayRef<TConstArrayRef<float>> features) {
+    TVector<ui8> result(model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() * features.size());
+    TVector<ui32> transposedHash;
+    TVector<float> ctrs;
+    BinarizeFeatures(
+        model,
+        [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+            return features[index][floatFeature.FlatFeatureIndex];
+        },
+        [](const TCatFeature&, size_t) -> int {
+            return 0;
+        },
+        0,
+        features.size(),
+        result,
+        transposedHash,
+        ctrs);
+    return result;
+}
+
 // Deterministically train model that has only 3 categoric features.
 static TFullModel TrainCatOnlyModel() {
     TTempDir trainDir;
@@ -172,6 +250,127 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         UNIT_ASSERT_EQUAL(canonVals, result);
     }
 
+    Y_UNIT_TEST(TestNonSymmetricTrees) {
+        auto model = NonSymmetricFloatModel();
+        UNIT_ASSERT(!model.ObliviousTrees.IsOblivious());
+        UNIT_ASSERT_VALUES_EQUAL(model.GetTreeCount(), 2);
+        TVector<TVector<float>> data = {
+            {0.f, 0.f},
+            {1.f, 0.f},
+            {0.f, 1.f},
+            {1.f, 1.f}};
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+        const TVector<double> canonVals = {11., 12., 11., 13.};
+
+        TVector<double> result(features.size());
+        model.CalcFlat(features, result);
+        UNIT_ASSERT_EQUAL(canonVals, result);
+        for (size_t i = 0; i < data.size(); ++i) {
+            double singleResult = 0.;
+            model.CalcFlatSingle(data[i], MakeArrayRef(&singleResult, 1));
+            UNIT_ASSERT_VALUES_EQUAL(canonVals[i], singleResult);
+        }
+
+        TStringStream strStream;
+        model.Save(&strStream);
+        TFullModel deserializedModel;
+        deserializedModel.Load(&strStream);
+        UNIT_ASSERT_EQUAL(model, deserializedModel);
+        UNIT_ASSERT_EQUAL(model.ObliviousTrees.LeafWeights, deserializedModel.ObliviousTrees.LeafWeights);
+        deserializedModel.CalcFlat(features, result);
+        UNIT_ASSERT_EQUAL(canonVals, result);
+
+        model.Truncate(0, 1);
+        model.CalcFlat(features, result);
+        UNIT_ASSERT_EQUAL(TVector<double>({1., 2., 1., 3.}), result);
+    }
+
+    Y_UNIT_TEST(TestEvaluationIsaBitIdentical) {
+        // 11 deep trees exercise both ui8 and ui32 index paths, 1000 docs leave a non-aligned tail block
+        const auto model = RandomFloatModel(/*featureCount*/ 17, /*borderCount*/ 300, /*treeCount*/ 50, /*maxDepth*/ 11);
+        TFastRng64 rng(0);
+        TVector<TVector<float>> data(1000, TVector<float>(17));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.Uniform(10) == 0 ? std::nanf("") : (float)(rng.GenRandReal1() * 2.2 - 1.1);
+            }
+        }
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+
+        const EEvaluationIsa bestIsa = GetBestSupportedEvaluationIsa();
+        SetEvaluationIsa(EEvaluationIsa::Default);
+        TVector<double> canonResult(data.size());
+        model.CalcFlat(features, canonResult);
+        const auto canonBins = BinarizeWholeDataset(model, features);
+        for (auto isa : GetEnumAllValues<EEvaluationIsa>()) {
+            if (!IsEvaluationIsaSupported(isa)) {
+                continue;
+            }
+            SetEvaluationIsa(isa);
+            TVector<double> result(data.size());
+            model.CalcFlat(features, result);
+            UNIT_ASSERT_EQUAL_C(canonResult, result, isa);
+            UNIT_ASSERT_EQUAL_C(canonBins, BinarizeWholeDataset(model, features), isa);
+        }
+        SetEvaluationIsa(bestIsa);
+    }
+
+    Y_UNIT_TEST(TestParallelCalcIsDeterministic) {
+        const auto model = RandomFloatModel(/*featureCount*/ 10, /*borderCount*/ 50, /*treeCount*/ 30, /*maxDepth*/ 6);
+        TFastRng64 rng(0);
+        TVector<TVector<float>> data(1000, TVector<float>(10));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = (float)(rng.GenRandReal1() * 2.2 - 1.1);
+            }
+        }
+        TVector<TConstArrayRef<float>> features(data.begin(), data.end());
+        TVector<double> canonResult(data.size());
+        model.CalcFlat(features, canonResult);
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        for (size_t docCount : {1, 127, 129, 1000}) {
+            TVector<double> result(docCount);
+            model.CalcFlat(MakeArrayRef(features.data(), docCount), result, &executor);
+            UNIT_ASSERT_EQUAL_C(TVector<double>(canonResult.begin(), canonResult.begin() + docCount), result, docCount);
+        }
+    }
+
+    Y_UNIT_TEST(TestCalcIndexesIsaBitIdentical) {
+        TFastRng64 rng(0);
+        const size_t docCount = 1000;
+        const size_t featureCount = 20;
+        TVector<ui8> binFeatures(featureCount * docCount);
+        for (auto& bin : binFeatures) {
+            bin = rng.Uniform(256);
+        }
+        const EEvaluationIsa bestIsa = GetBestSupportedEvaluationIsa();
+        for (int depth : xrange(17)) {
+            TVector<TRepackedBin> splits(depth);
+            for (auto& split : splits) {
+                split.FeatureIndex = rng.Uniform(featureCount);
+                split.SplitIdx = rng.Uniform(256);
+                split.XorMask = rng.Uniform(2) ? 0xff : 0;
+            }
+            for (bool needXorMask : {false, true}) {
+                SetEvaluationIsa(EEvaluationIsa::Default);
+                TVector<ui32> canonIndexes(docCount);
+                CalcIndexes(needXorMask, binFeatures.data(), docCount, canonIndexes.data(), splits.data(), depth);
+                for (auto isa : GetEnumAllValues<EEvaluationIsa>()) {
+                    if (!IsEvaluationIsaSupported(isa)) {
+                        continue;
+                    }
+                    SetEvaluationIsa(isa);
+                    TVector<ui32> indexes(docCount);
+                    CalcIndexes(needXorMask, binFeatures.data(), docCount, indexes.data(), splits.data(), depth);
+                    UNIT_ASSERT_EQUAL_C(canonIndexes, indexes, isa << " depth " << depth);
+                }
+            }
+        }
+        SetEvaluationIsa(bestIsa);
+    }
+
     Y_UNIT_TEST(TestCatOnlyModel) {
         const auto model = TrainCatOnlyModel();
 
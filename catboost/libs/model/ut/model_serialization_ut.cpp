@@ -1,8 +1,15 @@
 #include "model_test_helpers.h"
 
+#include <catboost/libs/algo/apply.h>
+#include <catboost/libs/model/static_ctr_provider.h>
+#include <catboost/libs/train_lib/train_model.h>
+
 #include <library/unittest/registar.h>
 
+#include <util/generic/xrange.h>
+
 using namespace std;
+using namespace NCB;
 
 Y_UNIT_TEST_SUITE(TModelSerialization) {
     Y_UNIT_TEST(TestSerializeDeserializeFullModel) {
@@ -23,4 +30,101 @@ Y_UNIT_TEST_SUITE(TModelSerialization) {
         UNIT_ASSERT_EQUAL(trainedModel.ObliviousTrees.LeafValues, deserializedModel.ObliviousTrees.LeafValues);
         UNIT_ASSERT_EQUAL(trainedModel.ObliviousTrees.TreeSplits, deserializedModel.ObliviousTrees.TreeSplits);
     }
+
+    Y_UNIT_TEST(TestReadMappedModel) {
+        NJson::TJsonValue params;
+        params.InsertValue("learning_rate", 0.3);
+        params.InsertValue("iterations", 10);
+        TFullModel trainedModel;
+        TEvalResult evalResult;
+        TDataProviderPtr pool = GetAdultPool();
+        TrainModel(
+            params,
+            nullptr,
+            Nothing(),
+            Nothing(),
+            TDataProviders{pool, {pool}},
+            "",
+            &trainedModel,
+            {&evalResult});
+        UNIT_ASSERT(!trainedModel.ObliviousTrees.GetUsedModelCtrs().empty());
+        OutputModel(trainedModel, "mapped_model.cbm");
+
+        const TVector<double> expected = ApplyModel(ReadModel("mapped_model.cbm"), *(pool->ObjectsData));
+        TVector<double> mapped;
+        {
+            TFullModel mappedModel = ReadMappedModel("mapped_model.cbm");
+            UNIT_ASSERT_EQUAL(trainedModel, mappedModel);
+            UNIT_ASSERT(mappedModel.HasValidCtrProvider());
+            // clone must keep mapping alive after source model is destroyed
+            TFullModel copy = mappedModel.CopyTreeRange(0, mappedModel.GetTreeCount());
+            mappedModel = TFullModel();
+            mapped = ApplyModel(copy, *(pool->ObjectsData));
+        }
+        UNIT_ASSERT_VALUES_EQUAL(expected.size(), mapped.size());
+        for (auto i : xrange(expected.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(expected[i], mapped[i]);
+        }
+
+        TStringStream serialized;
+        trainedModel.Save(&serialized);
+        // ctr tables are referenced in place only if counters are aligned, otherwise they are copied,
+        // so each table is referenced in place for exactly one of the buffer shifts
+        THashMap<TModelCtrBase, size_t> inPlaceLoadCount;
+        for (size_t shift : xrange(sizeof(ui32))) {
+            const TString buffer = TString(shift, '\0') + serialized.Str();
+            const ui8* modelData = (const ui8*)buffer.data() + shift;
+            TFullModel zeroCopyModel = ReadZeroCopyModel(modelData, buffer.size() - shift);
+            const auto& ctrData = dynamic_cast<const TStaticCtrProvider&>(*zeroCopyModel.CtrProvider).CtrData;
+            for (const auto& ctrBaseAndTable : ctrData.LearnCtrs) {
+                const auto blob = ctrBaseAndTable.second.GetTypedArrayRefForBlobData<ui8>();
+                UNIT_ASSERT_VALUES_EQUAL(reinterpret_cast<uintptr_t>(blob.data()) % alignof(ui32), 0);
+                if (blob.data() >= modelData && blob.data() < modelData + serialized.Str().size()) {
+                    ++inPlaceLoadCount[ctrBaseAndTable.first];
+                }
+            }
+            UNIT_ASSERT_EQUAL(ApplyModel(zeroCopyModel, *(pool->ObjectsData)), expected);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(inPlaceLoadCount.size(), trainedModel.ObliviousTrees.GetUsedModelCtrBases().size());
+        for (const auto& ctrBaseAndCount : inPlaceLoadCount) {
+            UNIT_ASSERT_VALUES_EQUAL(ctrBaseAndCount.second, 1);
+        }
+    }
+
+    Y_UNIT_TEST(TestSumMappedModels) {
+        NJson::TJsonValue params;
+        params.InsertValue("learning_rate", 0.3);
+        params.InsertValue("iterations", 10);
+        TFullModel trainedModel;
+        TEvalResult evalResult;
+        TDataProviderPtr pool = GetAdultPool();
+        TrainModel(
+            params,
+            nullptr,
+            Nothing(),
+            Nothing(),
+            TDataProviders{pool, {pool}},
+            "",
+            &trainedModel,
+            {&evalResult});
+        UNIT_ASSERT(!trainedModel.ObliviousTrees.GetUsedModelCtrs().empty());
+        OutputModel(trainedModel.CopyTreeRange(0, 5), "mapped_model_part0.cbm");
+        OutputModel(trainedModel.CopyTreeRange(5, 10), "mapped_model_part1.cbm");
+
+        const TVector<double> expected = ApplyModel(trainedModel, *(pool->ObjectsData));
+        for (auto mergePolicy : {ECtrTableMergePolicy::LeaveMostDiversifiedTable, ECtrTableMergePolicy::IntersectingCountersAverage}) {
+            TFullModel summedModel;
+            {
+                // summed model must keep mappings of source models alive after they are destroyed
+                TFullModel part0 = ReadMappedModel("mapped_model_part0.cbm");
+                TFullModel part1 = ReadMappedModel("mapped_model_part1.cbm");
+                summedModel = SumModels({&part0, &part1}, {1.0, 1.0}, mergePolicy);
+            }
+            const TVector<double> summed = ApplyModel(summedModel, *(pool->ObjectsData));
+            UNIT_ASSERT_VALUES_EQUAL(expected.size(), summed.size());
+            for (auto i : xrange(expected.size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expected[i], summed[i], 1e-9);
+            }
+        }
+    }
 }
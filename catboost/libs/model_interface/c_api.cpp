@@ -3,11 +3,23 @@
 #include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/model/model.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/ptr.h>
 #include <util/generic/singleton.h>
 #include <util/stream/file.h>
 #include <util/string/builder.h>
 
-#define FULL_MODEL_PTR(x) ((TFullModel*)(x))
+#define MODEL_CALCER_PTR(x) ((TModelCalcer*)(x))
+#define FULL_MODEL_PTR(x) (&MODEL_CALCER_PTR(x)->Model)
+#define EXECUTOR_PTR(x) (MODEL_CALCER_PTR(x)->Executor.Get())
+
+
+struct TModelCalcer {
+    TFullModel Model;
+    //! Threads for batch predictions, nullptr for evaluation in calling thread
+    THolder<NPar::TLocalExecutor> Executor;
+};
 
 
 struct TErrorMessageHolder {
@@ -17,7 +29,7 @@ struct TErrorMessageHolder {
 extern "C" {
 EXPORT ModelCalcerHandle* ModelCalcerCreate() {
     try {
-        return new TFullModel;
+        return new TModelCalcer;
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
     }
@@ -31,7 +43,7 @@ EXPORT const char* GetErrorString() {
 
 EXPORT void ModelCalcerDelete(ModelCalcerHandle* modelHandle) {
     if (modelHandle != nullptr) {
-        delete FULL_MODEL_PTR(modelHandle);
+        delete MODEL_CALCER_PTR(modelHandle);
     }
 }
 
@@ -57,6 +69,23 @@ EXPORT bool LoadFullModelFromBuffer(ModelCalcerHandle* modelHandle, const void*
     return true;
 }
 
+EXPORT bool SetPredictionThreadCount(ModelCalcerHandle* modelHandle, int threadCount) {
+    try {
+        CB_ENSURE(threadCount > 0, "Thread count should be positive, got " << threadCount);
+        auto& executor = MODEL_CALCER_PTR(modelHandle)->Executor;
+        if (threadCount == 1) {
+            executor.Destroy();
+        } else {
+            executor = MakeHolder<NPar::TLocalExecutor>();
+            executor->RunAdditionalThreads(threadCount - 1);
+        }
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 EXPORT bool CalcModelPredictionFlat(ModelCalcerHandle* modelHandle, size_t docCount, const float** floatFeatures, size_t floatFeaturesSize, double* result, size_t resultSize) {
     try {
         if (docCount == 1) {
@@ -66,7 +95,7 @@ EXPORT bool CalcModelPredictionFlat(ModelCalcerHandle* modelHandle, size_t docCo
             for (size_t i = 0; i < docCount; ++i) {
                 featuresVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
             }
-            FULL_MODEL_PTR(modelHandle)->CalcFlat(featuresVec, TArrayRef<double>(result, resultSize));
+            FULL_MODEL_PTR(modelHandle)->CalcFlat(featuresVec, TArrayRef<double>(result, resultSize), EXECUTOR_PTR(modelHandle));
         }
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
@@ -90,7 +119,7 @@ EXPORT bool CalcModelPrediction(
                 catFeaturesVec[i][catFeatureIdx] = catFeatures[i][catFeatureIdx];
             }
         }
-        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize), EXECUTOR_PTR(modelHandle));
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
@@ -129,7 +158,7 @@ EXPORT bool CalcModelPredictionWithHashedCatFeatures(ModelCalcerHandle* modelHan
             floatFeaturesVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
             catFeaturesVec[i] = TConstArrayRef<int>(catFeatures[i], catFeaturesSize);
         }
-        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize), EXECUTOR_PTR(modelHandle));
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
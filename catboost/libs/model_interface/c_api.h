@@ -59,6 +59,16 @@ EXPORT bool LoadFullModelFromBuffer(
     const void* binaryBuffer,
     size_t binaryBufferSize);
 
+/**
+ * Use threadCount threads (including the calling one) for batch predictions with this model handle.
+ * Default is 1. Results don't depend on thread count.
+ * Model handle with several threads can still be used from multiple threads concurrently.
+ * @param calcer model handle
+ * @param threadCount
+ * @return false if error occured
+ */
+EXPORT bool SetPredictionThreadCount(ModelCalcerHandle* modelHandle, int threadCount);
+
 /**
  * **Use this method only if you really understand what you want.**
  * Calculate raw model predictions on flat feature vectors
@@ -421,6 +421,21 @@ void NCatboostOptions::TCatBoostOptions::Validate() const {
             LossFunctionDescription->GetLossFunction() != ELossFunction::PythonUserDefinedPerObject
             || ObliviousTreeOptions->LeavesEstimationBacktrackingType == ELeavesEstimationStepBacktracking::No,
             "Backtracking is not supported for custom loss functions on CPU");
+
+        const EGrowingPolicy growingPolicy = ObliviousTreeOptions->GrowingPolicy;
+        if (growingPolicy != EGrowingPolicy::ObliviousTree) {
+            CB_ENSURE(growingPolicy != EGrowingPolicy::Region, "Growing policy " << growingPolicy << " is supported only on GPU");
+            CB_ENSURE(!IsPairwiseScoring(lossFunction),
+                      "Growing policy " << growingPolicy << " on CPU is not supported for loss function " << lossFunction);
+            CB_ENSURE(ObliviousTreeOptions->SamplingFrequency == ESamplingFrequency::PerTree,
+                      "Growing policy " << growingPolicy << " on CPU requires sampling_frequency " << ESamplingFrequency::PerTree);
+            CB_ENSURE(SystemOptions->IsSingleHost(), "Distributed training on CPU supports only symmetric trees");
+            if (growingPolicy == EGrowingPolicy::Lossguide) {
+                const ui32 maxLeavesCount = 64;
+                CB_ENSURE(ObliviousTreeOptions->MaxLeavesCount <= maxLeavesCount,
+                          "Maximum leaves count for growing policy " << growingPolicy << " on CPU is " << maxLeavesCount);
+            }
+        }
     }
 
     ValidateCtrs(CatFeatureParams->SimpleCtrs, lossFunction, false);
@@ -482,18 +497,17 @@ void NCatboostOptions::TCatBoostOptions::SetNotSpecifiedOptionsToDefaults() {
             BoostingOptions->BoostingType = EBoostingType::Plain;
             BoostingOptions->DataPartitionType = EDataPartitionType::DocParallel;
         }
+    }
+    if (ObliviousTreeOptions->GrowingPolicy == EGrowingPolicy::Lossguide) {
+        ObliviousTreeOptions->MaxDepth.SetDefault(16);
+    }
+    if (ObliviousTreeOptions->MaxLeavesCount.IsDefault() && ObliviousTreeOptions->GrowingPolicy != EGrowingPolicy::Lossguide) {
+        const ui32 maxLeaves = 1u << ObliviousTreeOptions->MaxDepth.Get();
+        ObliviousTreeOptions->MaxLeavesCount.SetDefault(maxLeaves);
 
-        if (ObliviousTreeOptions->GrowingPolicy == EGrowingPolicy::Lossguide) {
-            ObliviousTreeOptions->MaxDepth.SetDefault(16);
-        }
-        if (ObliviousTreeOptions->MaxLeavesCount.IsDefault() && ObliviousTreeOptions->GrowingPolicy != EGrowingPolicy::Lossguide) {
-            const ui32 maxLeaves = 1u << ObliviousTreeOptions->MaxDepth.Get();
-            ObliviousTreeOptions->MaxLeavesCount.SetDefault(maxLeaves);
-
-            if (ObliviousTreeOptions->GrowingPolicy != EGrowingPolicy::Lossguide) {
-                CB_ENSURE(ObliviousTreeOptions->MaxLeavesCount == maxLeaves,
-                          "max_leaves_count options works only with lossguide tree growing");
-            }
+        if (ObliviousTreeOptions->GrowingPolicy != EGrowingPolicy::Lossguide) {
+            CB_ENSURE(ObliviousTreeOptions->MaxLeavesCount == maxLeaves,
+                      "max_leaves_count options works only with lossguide tree growing");
         }
     }
 
@@ -33,5 +33,11 @@ namespace NCatboostOptions {
         TOption<TVector<float>> ClassWeights;
         TOption<TVector<TString>> ClassNames;
         TGpuOnlyOption<EGpuCatFeaturesStorage> GpuCatFeaturesStorage;
+
+        // bundle sparse mutually exclusive float features at quantization, see data_new/exclusive_feature_bundling.h
+        TCpuOnlyOption<bool> DevExclusiveFeaturesBundling;
+
+        // if > 0 build borders from quantile sketches of this size, see library/grid_creator/quantile_sketch.h
+        TOption<ui32> DevBorderSelectionSketchSize;
     };
 }
@@ -240,6 +240,11 @@ enum class ENodeType {
     SingleHost
 };
 
+enum class EOnlineCtrCachePolicy {
+    LRU,
+    LFU
+};
+
 enum class EModelType {
     CatboostBinary /* "CatboostBinary", "cbm", "catboost" */,
     AppleCoreML    /* "AppleCoreML", "coreml"     */,
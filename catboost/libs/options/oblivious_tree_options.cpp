@@ -16,17 +16,18 @@ NCatboostOptions::TObliviousTreeLearnerOptions::TObliviousTreeLearnerOptions(ETa
       , BootstrapConfig("bootstrap", TBootstrapConfig(taskType))
       , Rsm("rsm", 1.0)
       , LeavesEstimationBacktrackingType("leaf_estimation_backtracking", ELeavesEstimationStepBacktracking::AnyImprovement)
+      , GrowingPolicy("growing_policy", EGrowingPolicy::ObliviousTree)
+      , MaxLeavesCount("max_leaves_count", 31)
+      , MinSamplesInLeaf("min_samples_in_leaf", 1)
       , SamplingFrequency("sampling_frequency", ESamplingFrequency::PerTree, taskType)
       , ModelSizeReg("model_size_reg", 0.5, taskType)
       , DevScoreCalcObjBlockSize("dev_score_calc_obj_block_size", 5000000, taskType)
+      , DevCompactScoreCache("dev_compact_score_cache", false, taskType)
       , ObservationsToBootstrap("observations_to_bootstrap", EObservationsToBootstrap::TestOnly, taskType) //it's specific for fold-based scheme, so here and not in bootstrap options
       , FoldSizeLossNormalization("fold_size_loss_normalization", false, taskType)
       , AddRidgeToTargetFunctionFlag("add_ridge_penalty_to_loss_function", false, taskType)
       , ScoreFunction("score_function", EScoreFunction::Correlation, taskType)
       , MaxCtrComplexityForBordersCaching("max_ctr_complexity_for_borders_cache", 1, taskType)
-      , GrowingPolicy("growing_policy", EGrowingPolicy::ObliviousTree, taskType)
-      , MaxLeavesCount("max_leaves_count", 31, taskType)
-      , MinSamplesInLeaf("min_samples_in_leaf", 1, taskType)
 
 {
     SamplingFrequency.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::ExceptionOnChange);
@@ -51,6 +52,7 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Load(const NJson::TJsonValu
             &LeavesEstimationBacktrackingType,
             &SamplingFrequency,
             &DevScoreCalcObjBlockSize,
+            &DevCompactScoreCache,
             &GrowingPolicy,
             &MaxLeavesCount,
             &MinSamplesInLeaf
@@ -68,6 +70,7 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Save(NJson::TJsonValue* opt
             LeavesEstimationBacktrackingType,
             MaxCtrComplexityForBordersCaching, Rsm, ObservationsToBootstrap, SamplingFrequency,
             DevScoreCalcObjBlockSize,
+            DevCompactScoreCache,
             GrowingPolicy,
             MaxLeavesCount,
             MinSamplesInLeaf
@@ -78,14 +81,14 @@ bool NCatboostOptions::TObliviousTreeLearnerOptions::operator==(const TOblivious
     return std::tie(MaxDepth, LeavesEstimationIterations, LeavesEstimationMethod, L2Reg, ModelSizeReg, RandomStrength,
             BootstrapConfig, Rsm, SamplingFrequency, ObservationsToBootstrap, FoldSizeLossNormalization,
             AddRidgeToTargetFunctionFlag, ScoreFunction, MaxCtrComplexityForBordersCaching,
-            PairwiseNonDiagReg, LeavesEstimationBacktrackingType, DevScoreCalcObjBlockSize,
+            PairwiseNonDiagReg, LeavesEstimationBacktrackingType, DevScoreCalcObjBlockSize, DevCompactScoreCache,
             GrowingPolicy, MaxLeavesCount, MinSamplesInLeaf
             ) ==
         std::tie(rhs.MaxDepth, rhs.LeavesEstimationIterations, rhs.LeavesEstimationMethod, rhs.L2Reg, rhs.ModelSizeReg,
                 rhs.RandomStrength, rhs.BootstrapConfig, rhs.Rsm, rhs.SamplingFrequency,
                 rhs.ObservationsToBootstrap, rhs.FoldSizeLossNormalization, rhs.AddRidgeToTargetFunctionFlag,
                 rhs.ScoreFunction, rhs.MaxCtrComplexityForBordersCaching, rhs.PairwiseNonDiagReg, rhs.LeavesEstimationBacktrackingType,
-                rhs.DevScoreCalcObjBlockSize, rhs.GrowingPolicy, rhs.MaxLeavesCount, rhs.MinSamplesInLeaf);
+                rhs.DevScoreCalcObjBlockSize, rhs.DevCompactScoreCache, rhs.GrowingPolicy, rhs.MaxLeavesCount, rhs.MinSamplesInLeaf);
 }
 
 bool NCatboostOptions::TObliviousTreeLearnerOptions::operator!=(const TObliviousTreeLearnerOptions& rhs) const {
@@ -102,4 +105,6 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Validate() const {
     CB_ENSURE(LeavesEstimationIterations.Get() > 0, "Leaves estimation iterations should be positive");
     CB_ENSURE(L2Reg.Get() >= 0, "L2LeafRegularizer should be >= 0, current value: " << L2Reg.Get());
     CB_ENSURE(PairwiseNonDiagReg.Get() >= 0, "PairwiseNonDiagReg should be >= 0, current value: " << PairwiseNonDiagReg.Get());
+    CB_ENSURE(MaxLeavesCount.Get() > 1, "max_leaves_count should be > 1");
+    CB_ENSURE(MinSamplesInLeaf.Get() >= 0, "min_samples_in_leaf should be >= 0, current value: " << MinSamplesInLeaf.Get());
 }
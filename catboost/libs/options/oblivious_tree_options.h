@@ -31,6 +31,9 @@ namespace NCatboostOptions {
         TOption<TBootstrapConfig> BootstrapConfig;
         TOption<float> Rsm;
         TOption<ELeavesEstimationStepBacktracking> LeavesEstimationBacktrackingType;
+        TOption<EGrowingPolicy> GrowingPolicy;
+        TOption<ui32> MaxLeavesCount;
+        TOption<double> MinSamplesInLeaf;
 
         TCpuOnlyOption<ESamplingFrequency> SamplingFrequency;
         TCpuOnlyOption<float> ModelSizeReg;
@@ -38,13 +41,14 @@ namespace NCatboostOptions {
         // changing this parameter can affect results due to numerical accuracy differences
         TCpuOnlyOption<ui32> DevScoreCalcObjBlockSize;
 
+        // store statistics cached between tree levels in single precision to halve memory usage,
+        // changing this parameter can affect results due to numerical accuracy differences
+        TCpuOnlyOption<bool> DevCompactScoreCache;
+
         TGpuOnlyOption<EObservationsToBootstrap> ObservationsToBootstrap;
         TGpuOnlyOption<bool> FoldSizeLossNormalization;
         TGpuOnlyOption<bool> AddRidgeToTargetFunctionFlag;
         TGpuOnlyOption<EScoreFunction> ScoreFunction;
         TGpuOnlyOption<ui32> MaxCtrComplexityForBordersCaching;
-        TGpuOnlyOption<EGrowingPolicy> GrowingPolicy;
-        TGpuOnlyOption<ui32> MaxLeavesCount;
-        TGpuOnlyOption<double> MinSamplesInLeaf;
     };
 }
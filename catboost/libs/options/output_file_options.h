@@ -93,6 +93,9 @@ namespace NCatboostOptions {
 
         TString GetRocOutputPath() const;
 
+        // empty if trace output is disabled
+        TString CreateTraceFullPath() const;
+
         void SetSaveSnapshotFlag(bool flag) {
             SaveSnapshotFlag.Set(flag);
         }
@@ -149,5 +152,6 @@ namespace NCatboostOptions {
         TOption<TVector<EPredictionType>> PredictionTypes;
         TOption<TVector<TString>> OutputColumns;
         TOption<TString> RocOutputPath;
+        TOption<TString> TraceFile;
     };
 }
@@ -191,6 +191,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "meta", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "json_log", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "profile_log", &outputFilesJson, &seenKeys);
+    CopyOption(plainOptions, "trace_file", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "learn_error_log", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "test_error_log", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "time_left_log", &outputFilesJson, &seenKeys);
@@ -248,6 +249,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "bayesian_matrix_reg", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "model_size_reg", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "dev_score_calc_obj_block_size", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_compact_score_cache", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "random_strength", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "leaf_estimation_method", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "growing_policy", &treeOptions, &seenKeys);
@@ -316,6 +318,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "class_names", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "class_weights", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "gpu_cat_features_storage", &dataProcessingOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_exclusive_features_bundling", &dataProcessingOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_border_selection_sketch_size", &dataProcessingOptions, &seenKeys);
 
     auto& floatFeaturesBinarization = dataProcessingOptions["float_features_binarization"];
     floatFeaturesBinarization.SetType(NJson::JSON_MAP);
@@ -338,6 +342,11 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "node_type", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "node_port", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "file_with_hosts", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "online_ctr_cache_size", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "online_ctr_cache_policy", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "online_ctr_cache_spill_dir", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "work_stealing", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "thread_pinning", &systemOptions, &seenKeys);
 
 
     //rest
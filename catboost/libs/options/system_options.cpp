@@ -17,6 +17,11 @@ TSystemOptions::TSystemOptions(ETaskType taskType)
     , NodeType("node_type", ENodeType::SingleHost, taskType)
     , FileWithHosts("file_with_hosts", "hosts.txt", taskType)
     , NodePort("node_port", GetUnusedNodePort(), taskType)
+    , OnlineCtrCacheSize("online_ctr_cache_size", {}, taskType)
+    , OnlineCtrCachePolicy("online_ctr_cache_policy", EOnlineCtrCachePolicy::LRU, taskType)
+    , OnlineCtrCacheSpillDir("online_ctr_cache_spill_dir", {}, taskType)
+    , WorkStealing("work_stealing", false, taskType)
+    , ThreadPinning("thread_pinning", false, taskType)
 {
     Devices.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
     GpuRamPart.ChangeLoadUnimplementedPolicy(ELoadUnimplementedPolicy::SkipWithWarning);
@@ -24,18 +29,23 @@ TSystemOptions::TSystemOptions(ETaskType taskType)
 }
 
 void TSystemOptions::Load(const NJson::TJsonValue& options) {
-    CheckedLoad(options, &NumThreads, &CpuUsedRamLimit, &Devices, &GpuRamPart, &PinnedMemorySize, &NodeType, &FileWithHosts, &NodePort);
+    CheckedLoad(options, &NumThreads, &CpuUsedRamLimit, &Devices, &GpuRamPart, &PinnedMemorySize, &NodeType, &FileWithHosts, &NodePort,
+                &OnlineCtrCacheSize, &OnlineCtrCachePolicy, &OnlineCtrCacheSpillDir, &WorkStealing, &ThreadPinning);
 }
 
 void TSystemOptions::Save(NJson::TJsonValue* options) const {
-    SaveFields(options, NumThreads, CpuUsedRamLimit, Devices, GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort);
+    SaveFields(options, NumThreads, CpuUsedRamLimit, Devices, GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort,
+               OnlineCtrCacheSize, OnlineCtrCachePolicy, OnlineCtrCacheSpillDir, WorkStealing, ThreadPinning);
 }
 
 bool TSystemOptions::operator==(const TSystemOptions& rhs) const {
     return std::tie(NumThreads, CpuUsedRamLimit, Devices,
-                    GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort) ==
+                    GpuRamPart, PinnedMemorySize, NodeType, FileWithHosts, NodePort,
+                    OnlineCtrCacheSize, OnlineCtrCachePolicy, OnlineCtrCacheSpillDir, WorkStealing, ThreadPinning) ==
            std::tie(rhs.NumThreads, rhs.CpuUsedRamLimit, rhs.Devices,
-                    rhs.GpuRamPart, rhs.PinnedMemorySize, rhs.NodeType, rhs.FileWithHosts, rhs.NodePort);
+                    rhs.GpuRamPart, rhs.PinnedMemorySize, rhs.NodeType, rhs.FileWithHosts, rhs.NodePort,
+                    rhs.OnlineCtrCacheSize, rhs.OnlineCtrCachePolicy, rhs.OnlineCtrCacheSpillDir,
+                    rhs.WorkStealing, rhs.ThreadPinning);
 }
 
 bool TSystemOptions::operator!=(const TSystemOptions& rhs) const {
@@ -47,6 +57,10 @@ void TSystemOptions::Validate() const {
     CB_ENSURE(GpuRamPart.GetUnchecked() > 0 && GpuRamPart.GetUnchecked() <= 1.0, "GPU ram part should be in (0, 1]");
     ParseMemorySizeDescription(CpuUsedRamLimit.Get());
     ParseMemorySizeDescription(PinnedMemorySize.GetUnchecked());
+    const ui64 onlineCtrCacheSize = ParseMemorySizeDescription(OnlineCtrCacheSize.GetUnchecked());
+    CB_ENSURE(
+        OnlineCtrCacheSpillDir.GetUnchecked().empty() || (onlineCtrCacheSize != Max<ui64>()),
+        "online_ctr_cache_spill_dir requires online_ctr_cache_size to be set");
 }
 
 bool TSystemOptions::IsMaster() const {
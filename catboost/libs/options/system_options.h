@@ -30,6 +30,13 @@ namespace NCatboostOptions {
         TCpuOnlyOption<TString> FileWithHosts;
         TCpuOnlyOption<ui32> NodePort;
 
+        TCpuOnlyOption<TString> OnlineCtrCacheSize;
+        TCpuOnlyOption<EOnlineCtrCachePolicy> OnlineCtrCachePolicy;
+        TCpuOnlyOption<TString> OnlineCtrCacheSpillDir;
+
+        TCpuOnlyOption<bool> WorkStealing;
+        TCpuOnlyOption<bool> ThreadPinning;
+
         static ui32 GetUnusedNodePort() { return 0; }
         bool IsMaster() const;
         bool IsSingleHost() const;
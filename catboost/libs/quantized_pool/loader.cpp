@@ -59,8 +59,8 @@ namespace {
             const size_t flatFeatureIdx,
             IQuantizedFeaturesDataVisitor* visitor) const;
 
-        static TLoadQuantizedPoolParameters GetLoadParameters() {
-            return {/*LockMemory*/ false, /*Precharge*/ false};
+        static TLoadQuantizedPoolParameters GetLoadParameters(NPar::TLocalExecutor* localExecutor) {
+            return {/*LockMemory*/ false, /*Precharge*/ false, localExecutor};
         }
 
     private:
@@ -103,7 +103,7 @@ static TDataMetaInfo MaybeAddArtificialFeatures(
 
 TCBQuantizedDataLoader::TCBQuantizedDataLoader(TDatasetLoaderPullArgs&& args)
     : ObjectCount(0) // inited later
-    , QuantizedPool(std::forward<TQuantizedPool>(LoadQuantizedPool(args.PoolPath.Path, GetLoadParameters())))
+    , QuantizedPool(std::forward<TQuantizedPool>(LoadQuantizedPool(args.PoolPath.Path, GetLoadParameters(args.CommonArgs.LocalExecutor))))
     , PairsPath(args.CommonArgs.PairsFilePath)
     , GroupWeightsPath(args.CommonArgs.GroupWeightsFilePath)
     , ObjectsOrder(args.CommonArgs.ObjectsOrder)
@@ -135,6 +135,19 @@ TCBQuantizedDataLoader::TCBQuantizedDataLoader(TDatasetLoaderPullArgs&& args)
 
     ProcessIgnoredFeaturesList(allIgnoredFeatures, &DataMetaInfo, &IsFeatureIgnored);
 
+    // quantization schema has no perfect hashes of categorical features, so they can't be loaded
+    const auto columnIdxToFlatIdx = GetColumnIndexToFlatIndexMap(QuantizedPool);
+    for (const auto [columnIdx, localIdx] : QuantizedPool.ColumnIndexToLocalIndex) {
+        if (QuantizedPool.ColumnTypes[localIdx] != EColumn::Categ) {
+            continue;
+        }
+        const auto* const flatFeatureIdx = columnIdxToFlatIdx.FindPtr(columnIdx);
+        CB_ENSURE(
+            flatFeatureIdx && IsFeatureIgnored[*flatFeatureIdx],
+            "Serialized quantized pools can contain only numeric features, categorical feature in column "
+            << columnIdx << " is not supported; ignore it or load the pool from dsv");
+    }
+
     DataMetaInfo = MaybeAddArtificialFeatures(
         DataMetaInfo,
         QuantizationSchemaFromProto(QuantizedPool.QuantizationSchema));
@@ -364,7 +377,7 @@ void TCBQuantizedDataLoader::AddChunk(
         } case EColumn::SampleId:
             // Are skipped in a caller
         case EColumn::Categ:
-            // TODO(yazevnul): categorical feature quantization on YT is still in progress
+            // Rejected in constructor unless ignored, quantization schema has no perfect hashes for them
         case EColumn::Auxiliary:
             // Should not be present in quantized pool
         case EColumn::Timestamp:
@@ -390,10 +403,18 @@ void TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
     const auto columnIdxToBaselineIdx = GetColumnIndexToBaselineIndexMap(QuantizedPool);
     const auto chunkRefs = GatherAndSortChunks(QuantizedPool);
 
+    // decompressed chunks are not backed by file, evicting their pages would lose data
+    const bool evictChunks = QuantizedPool.ChunkCodec.empty();
     TSequantialChunkEvictor evictor(1ULL << 24);
     for (const auto chunkRef : chunkRefs) {
-        evictor.Push(chunkRef);
-        Y_DEFER { evictor.MaybeEvict(); };
+        if (evictChunks) {
+            evictor.Push(chunkRef);
+        }
+        Y_DEFER {
+            if (evictChunks) {
+                evictor.MaybeEvict();
+            }
+        };
 
         const auto columnIdx = chunkRef.ColumnIndex;
         const auto localIdx = chunkRef.LocalIndex;
@@ -429,7 +450,9 @@ void TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
         AddChunk(*chunkRef.Description, columnType, flatFeatureIdx, baselineIdx, visitor);
     }
 
-    evictor.MaybeEvict(true);
+    if (evictChunks) {
+        evictor.MaybeEvict(true);
+    }
 
     QuantizedPool = TQuantizedPool(); // release memory
     SetGroupWeights(GroupWeightsPath, ObjectCount, visitor);
@@ -5,6 +5,7 @@
 
 #include <util/generic/deque.h>
 #include <util/generic/hash.h>
+#include <util/generic/string.h>
 #include <util/generic/vector.h>
 #include <util/memory/blob.h>
 #include <util/system/types.h>
@@ -56,6 +57,10 @@ namespace NCB {
 
         TVector<size_t> IgnoredColumnIndices;
 
+        // Name of `library/blockcodecs` codec used to compress chunks in file, empty if chunks are
+        // stored raw. Chunks in memory are always decompressed.
+        TString ChunkCodec;
+
         TVector<TBlob> Blobs;
     };
 
@@ -5,21 +5,28 @@
 #include <catboost/idl/pool/proto/metainfo.pb.h>
 #include <catboost/idl/pool/proto/quantization_schema.pb.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
 #include <catboost/libs/quantized_pool/detail.h>
 #include <catboost/libs/quantization_schema/detail.h>
 
 #include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 
+#include <library/blockcodecs/codecs.h>
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/digest/numeric.h>
 #include <util/folder/path.h>
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/array_size.h>
+#include <util/generic/buffer.h>
 #include <util/generic/deque.h>
+#include <util/generic/map.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/memory/blob.h>
 #include <util/stream/file.h>
 #include <util/stream/input.h>
@@ -27,6 +34,8 @@
 #include <util/stream/mem.h>
 #include <util/stream/output.h>
 #include <util/system/byteorder.h>
+#include <util/system/file.h>
+#include <util/system/hp_timer.h>
 #include <util/system/unaligned_mem.h>
 
 using NCB::NIdl::TPoolMetainfo;
@@ -40,7 +49,8 @@ static const size_t MagicSize = Y_ARRAY_SIZE(Magic);  // yes, with terminating z
 static const char MagicEnd[] = "CatboostQuantizedPoolEnd";
 static const size_t MagicEndSize = Y_ARRAY_SIZE(MagicEnd);  // yes, with terminating zero
 static const ui32 Version = 1;
-static const ui32 VersionHash = IntHash(Version);
+// chunks are compressed with `TPoolMetainfo.ChunkCodec`, readers of version 1 can not read them
+static const ui32 CompressedChunksVersion = 2;
 
 template <typename T>
 static TDeque<ui32> CollectAndSortKeys(const T& m) {
@@ -111,11 +121,14 @@ namespace {
     };
 }
 
+// `codec` is nullptr if chunks are stored raw
 static void WriteChunk(
     const NCB::TQuantizedPool::TChunkDescription& chunk,
+    const NBlockCodecs::ICodec* const codec,
     TCountingOutput* const output,
     TDeque<TChunkInfo>* const chunkInfos,
-    flatbuffers::FlatBufferBuilder* const builder) {
+    flatbuffers::FlatBufferBuilder* const builder,
+    TBuffer* const compressedChunk) {
 
     builder->Clear();
 
@@ -130,15 +143,21 @@ static void WriteChunk(
     AddPadding(16, output);
 
     const auto chunkOffset = output->Counter();
-    output->Write(builder->GetBufferPointer(), builder->GetSize());
-
-    chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
+    if (codec) {
+        codec->Encode(TStringBuf((const char*)builder->GetBufferPointer(), builder->GetSize()), *compressedChunk);
+        output->Write(compressedChunk->Data(), compressedChunk->Size());
+        chunkInfos->emplace_back(compressedChunk->Size(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
+    } else {
+        output->Write(builder->GetBufferPointer(), builder->GetSize());
+        chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
+    }
 }
 
-static void WriteHeader(TCountingOutput* const output) {
+static void WriteHeader(const bool hasCompressedChunks, TCountingOutput* const output) {
+    const ui32 version = hasCompressedChunks ? CompressedChunksVersion : Version;
     output->Write(Magic, MagicSize);
-    WriteLittleEndian(Version, output);
-    WriteLittleEndian(VersionHash, output);
+    WriteLittleEndian(version, output);
+    WriteLittleEndian(IntHash(version), output);
 
     const ui32 metainfoSize = 0;
     WriteLittleEndian(metainfoSize, output);
@@ -222,66 +241,82 @@ static TPoolMetainfo MakePoolMetainfo(
     return metainfo;
 }
 
+// chunks of every column in the order of column indices
+using TColumnChunkInfos = TMap<ui32, TDeque<TChunkInfo>>;
+
+// `baseOffset` is the offset of `output` start in the file, offsets in epilog are given from the beginning of file
+static void WriteEpilog(
+    const ui64 chunksOffset,
+    const TPoolMetainfo& poolMetainfo,
+    const TPoolQuantizationSchema& quantizationSchema,
+    const TColumnChunkInfos& columnChunkInfos,
+    const ui64 baseOffset,
+    TCountingOutput* const output) {
+
+    const ui64 poolMetainfoSizeOffset = baseOffset + output->Counter();
+    const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
+    WriteLittleEndian(poolMetainfoSize, output);
+    poolMetainfo.SerializeToStream(output);
+
+    const ui64 quantizationSchemaSizeOffset = baseOffset + output->Counter();
+    const ui32 quantizationSchemaSize = quantizationSchema.ByteSizeLong();
+    WriteLittleEndian(quantizationSchemaSize, output);
+    quantizationSchema.SerializeToStream(output);
+
+    const ui64 featureCountOffset = baseOffset + output->Counter();
+    const ui32 featureCount = columnChunkInfos.size();
+    WriteLittleEndian(featureCount, output);
+    for (const auto& [trueFeatureIndex, chunkInfos] : columnChunkInfos) {
+        const ui32 chunkCount = chunkInfos.size();
+
+        WriteLittleEndian(trueFeatureIndex, output);
+        WriteLittleEndian(chunkCount, output);
+        for (const auto& chunkInfo : chunkInfos) {
+            WriteLittleEndian(chunkInfo.Size, output);
+            WriteLittleEndian(chunkInfo.Offset, output);
+            WriteLittleEndian(chunkInfo.DocumentOffset, output);
+            WriteLittleEndian(chunkInfo.DocumentsInChunkCount, output);
+        }
+    }
+
+    WriteLittleEndian(chunksOffset, output);
+    WriteLittleEndian(poolMetainfoSizeOffset, output);
+    WriteLittleEndian(quantizationSchemaSizeOffset, output);
+    WriteLittleEndian(featureCountOffset, output);
+}
+
 static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
     TCountingOutput output(slave);
 
-    WriteHeader(&output);
+    const auto* const codec = pool.ChunkCodec.empty() ? nullptr : NBlockCodecs::Codec(pool.ChunkCodec);
+    WriteHeader(codec != nullptr, &output);
 
     const auto chunksOffset = output.Counter();
 
     const auto sortedTrueFeatureIndices = CollectAndSortKeys(pool.ColumnIndexToLocalIndex);
-    TDeque<TDeque<TChunkInfo>> perFeatureChunkInfos;
-    perFeatureChunkInfos.resize(pool.ColumnIndexToLocalIndex.size());
+    TColumnChunkInfos columnChunkInfos;
     {
         flatbuffers::FlatBufferBuilder builder;
+        TBuffer compressedChunk;
         for (const auto trueFeatureIndex : sortedTrueFeatureIndices) {
             const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
-            auto* const chunkInfos = &perFeatureChunkInfos[localIndex];
+            auto* const chunkInfos = &columnChunkInfos[trueFeatureIndex];
             for (const auto& chunk : pool.Chunks[localIndex]) {
-                WriteChunk(chunk, &output, chunkInfos, &builder);
+                WriteChunk(chunk, codec, &output, chunkInfos, &builder, &compressedChunk);
             }
         }
     }
 
-    const ui64 poolMetainfoSizeOffset = output.Counter();
-    {
-        const auto poolMetainfo = MakePoolMetainfo(
-            pool.ColumnIndexToLocalIndex,
-            pool.ColumnTypes,
-            pool.ColumnNames,
-            pool.DocumentCount,
-            pool.IgnoredColumnIndices);
-        const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
-        WriteLittleEndian(poolMetainfoSize, &output);
-        poolMetainfo.SerializeToStream(&output);
+    auto poolMetainfo = MakePoolMetainfo(
+        pool.ColumnIndexToLocalIndex,
+        pool.ColumnTypes,
+        pool.ColumnNames,
+        pool.DocumentCount,
+        pool.IgnoredColumnIndices);
+    if (codec) {
+        poolMetainfo.SetChunkCodec(pool.ChunkCodec);
     }
-
-    const ui64 quantizationSchemaSizeOffset = output.Counter();
-    const ui32 quantizationSchemaSize = pool.QuantizationSchema.ByteSizeLong();
-    WriteLittleEndian(quantizationSchemaSize, &output);
-    pool.QuantizationSchema.SerializeToStream(&output);
-
-    const ui64 featureCountOffset = output.Counter();
-    const ui32 featureCount = sortedTrueFeatureIndices.size();
-    WriteLittleEndian(featureCount, &output);
-    for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
-        const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
-        const ui32 chunkCount = perFeatureChunkInfos[localIndex].size();
-
-        WriteLittleEndian(trueFeatureIndex, &output);
-        WriteLittleEndian(chunkCount, &output);
-        for (const auto& chunkInfo : perFeatureChunkInfos[localIndex]) {
-            WriteLittleEndian(chunkInfo.Size, &output);
-            WriteLittleEndian(chunkInfo.Offset, &output);
-            WriteLittleEndian(chunkInfo.DocumentOffset, &output);
-            WriteLittleEndian(chunkInfo.DocumentsInChunkCount, &output);
-        }
-    }
-
-    WriteLittleEndian(chunksOffset, &output);
-    WriteLittleEndian(poolMetainfoSizeOffset, &output);
-    WriteLittleEndian(quantizationSchemaSizeOffset, &output);
-    WriteLittleEndian(featureCountOffset, &output);
+    WriteEpilog(chunksOffset, poolMetainfo, pool.QuantizationSchema, columnChunkInfos, 0, &output);
     output.Write(MagicEnd, MagicEndSize);
 }
 
@@ -294,7 +329,8 @@ static void ValidatePoolPart(const TConstArrayRef<char> blob) {
     (void)blob;
 }
 
-static void ReadHeader(TCountingInput* const input) {
+// returns format version
+static ui32 ReadHeader(TCountingInput* const input) {
     char magic[MagicSize];
     const auto magicSize = input->Load(magic, MagicSize);
     CB_ENSURE(MagicSize == magicSize);
@@ -302,11 +338,13 @@ static void ReadHeader(TCountingInput* const input) {
 
     ui32 version;
     ReadLittleEndian(&version, input);
-    CB_ENSURE(Version == version);
+    CB_ENSURE(
+        version == Version || version == CompressedChunksVersion,
+        "Unsupported quantized pool format version " << version);
 
     ui32 versionHash;
     ReadLittleEndian(&versionHash, input);
-    CB_ENSURE(VersionHash == versionHash);
+    CB_ENSURE(IntHash(version) == versionHash);
 
     ui32 metainfoSize;
     ReadLittleEndian(&metainfoSize, input);
@@ -315,6 +353,8 @@ static void ReadHeader(TCountingInput* const input) {
 
     const auto metainfoBytesSkipped = input->Skip(metainfoSize);
     CB_ENSURE(metainfoSize == metainfoBytesSkipped);
+
+    return version;
 }
 
 template <typename T>
@@ -458,11 +498,136 @@ static TEpilogOffsets ReadEpilogOffsets(const TConstArrayRef<char> blob) {
     return offsets;
 }
 
-static void CollectChunks(const TConstArrayRef<char> blob, NCB::TQuantizedPool& pool) {
-    const auto chunksOffsetByReading = [blob] {
+// Returns prefix of `blob` with the last complete version of the pool. `AppendQuantizedPool` writes `MagicEnd`
+// of the new version last, so while a pool is being appended (or if appending failed) its tail does not end with
+// `MagicEnd` and the previous version, which is left intact, is used.
+static TConstArrayRef<char> GetLastCompleteVersion(const TConstArrayRef<char> blob) {
+    for (size_t size = blob.size(); size >= MagicEndSize; --size) {
+        if (std::memcmp(MagicEnd, blob.data() + size - MagicEndSize, MagicEndSize)) {
+            continue;
+        }
+        const TConstArrayRef<char> version(blob.data(), size);
+        try {
+            ReadEpilogOffsets(version);
+            return version;
+        } catch (const TCatBoostException&) {
+            // `MagicEnd` bytes inside of chunk data
+        }
+    }
+    ythrow TCatBoostException() << "quantized pool has no complete version";
+}
+
+static TColumnChunkInfos ReadColumnChunkInfos(
+    const TConstArrayRef<char> blob,
+    const TEpilogOffsets& epilogOffsets) {
+
+    TMemoryInput epilog(
+        blob.data() + epilogOffsets.FeatureCountOffset,
+        blob.size() - epilogOffsets.FeatureCountOffset - MagicEndSize - sizeof(ui64) + 4);
+
+    TColumnChunkInfos columnChunkInfos;
+
+    ui32 featureCount;
+    ReadLittleEndian(&featureCount, &epilog);
+    for (ui32 i = 0; i < featureCount; ++i) {
+        ui32 featureIndex;
+        ReadLittleEndian(&featureIndex, &epilog);
+
+        CB_ENSURE(!columnChunkInfos.contains(featureIndex),
+            "Quantized pool should have unique feature indices, but " <<
+            LabeledOutput(featureIndex) << " is repeated.");
+        auto& chunkInfos = columnChunkInfos[featureIndex];
+
+        ui32 chunkCount;
+        ReadLittleEndian(&chunkCount, &epilog);
+        ui32 chunkSize;
+        ui64 chunkOffset;
+        ui32 docOffset;
+        ui32 docsInChunkCount;
+        const size_t featureEpilogBytes = chunkCount * (sizeof(chunkSize) + sizeof(chunkOffset) + sizeof(docOffset) + sizeof(docsInChunkCount));
+        TVector<ui8> featureEpilog(featureEpilogBytes);
+        CB_ENSURE(featureEpilogBytes == epilog.Load(featureEpilog.data(), featureEpilogBytes));
+        const auto* featureEpilogPtr = featureEpilog.data();
+        for (ui32 chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
+            ReadLittleEndian(&chunkSize, &featureEpilogPtr);
+
+            ReadLittleEndian(&chunkOffset, &featureEpilogPtr);
+            CB_ENSURE(chunkOffset >= epilogOffsets.ChunksOffset);
+            CB_ENSURE(chunkOffset < blob.size());
+
+            ReadLittleEndian(&docOffset, &featureEpilogPtr);
+
+            ReadLittleEndian(&docsInChunkCount, &featureEpilogPtr);
+
+            chunkInfos.emplace_back(chunkSize, chunkOffset, docOffset, docsInChunkCount);
+        }
+    }
+
+    return columnChunkInfos;
+}
+
+// Decompresses all chunks into one buffer (keeping 16-byte alignment of chunks) and updates chunk offsets and sizes
+// to point into it.
+static TBlob DecompressChunks(
+    const NBlockCodecs::ICodec& codec,
+    const TConstArrayRef<char> blob,
+    TColumnChunkInfos* const columnChunkInfos,
+    NPar::TLocalExecutor* const localExecutor) {
+
+    const THPTimer timer;
+
+    TVector<TChunkInfo*> chunkInfos;
+    TVector<TStringBuf> compressedChunks;
+    ui64 compressedSize = 0;
+    ui64 decompressedSize = 0;
+    for (auto& [columnIndex, columnChunks] : *columnChunkInfos) {
+        for (auto& chunkInfo : columnChunks) {
+            CB_ENSURE(chunkInfo.Offset + chunkInfo.Size <= blob.size(), "quantized pool chunk is truncated");
+            compressedChunks.emplace_back(blob.data() + chunkInfo.Offset, chunkInfo.Size);
+            compressedSize += chunkInfo.Size;
+
+            const auto chunkSize = codec.DecompressedLength(compressedChunks.back());
+            CB_ENSURE(chunkSize <= Max<ui32>(), "quantized pool chunk is too large " << LabeledOutput(chunkSize));
+            decompressedSize = RoundUpTo<ui64>(decompressedSize, 16);
+            chunkInfo.Offset = decompressedSize;
+            chunkInfo.Size = chunkSize;
+            decompressedSize += chunkSize;
+            chunkInfos.push_back(&chunkInfo);
+        }
+    }
+
+    TBuffer decompressed(decompressedSize);
+    decompressed.Resize(decompressedSize);
+    const auto decompressChunk = [&] (int chunkIdx) {
+        codec.Decompress(compressedChunks[chunkIdx], decompressed.Data() + chunkInfos[chunkIdx]->Offset);
+    };
+    if (localExecutor) {
+        NPar::ParallelFor(*localExecutor, 0, chunkInfos.size(), decompressChunk);
+    } else {
+        for (int chunkIdx : xrange(chunkInfos.ysize())) {
+            decompressChunk(chunkIdx);
+        }
+    }
+
+    const double seconds = timer.Passed();
+    CATBOOST_INFO_LOG << "Decompressed " << chunkInfos.size() << " quantized pool chunks (" << codec.Name() << "): "
+        << compressedSize << " -> " << decompressedSize << " bytes, compression ratio "
+        << (compressedSize ? (double)decompressedSize / compressedSize : 1.0) << ", "
+        << (seconds > 0 ? decompressedSize / seconds / (1 << 20) : 0.0) << " MiB/s" << Endl;
+
+    return TBlob::FromBuffer(decompressed);
+}
+
+static void CollectChunks(
+    const TConstArrayRef<char> blob,
+    NPar::TLocalExecutor* const localExecutor,
+    NCB::TQuantizedPool& pool) {
+
+    ui32 version = 0;
+    const auto chunksOffsetByReading = [blob, &version] {
         TMemoryInput slave(blob.data(), blob.size());
         TCountingInput input(&slave);
-        ReadHeader(&input);
+        version = ReadHeader(&input);
         return input.Counter();
     }();
     const auto epilogOffsets = ReadEpilogOffsets(blob);
@@ -483,23 +648,27 @@ static void CollectChunks(const TConstArrayRef<char> blob, NCB::TQuantizedPool&
         quantizationSchemaSize);
     CB_ENSURE(quantizationSchemaParsed);
 
-    TMemoryInput epilog(
-        blob.data() + epilogOffsets.FeatureCountOffset,
-        blob.size() - epilogOffsets.FeatureCountOffset - MagicEndSize - sizeof(ui64) + 4);
-
     TVector<TVector<NCB::TQuantizedPool::TChunkDescription>> stringColumnChunks;
     THashMap<ui32, EColumn> stringColumnIndexToColumnType;
 
-    ui32 featureCount;
-    ReadLittleEndian(&featureCount, &epilog);
-    for (ui32 i = 0; i < featureCount; ++i) {
-        ui32 featureIndex;
-        ReadLittleEndian(&featureIndex, &epilog);
-
-        CB_ENSURE(!pool.ColumnIndexToLocalIndex.contains(featureIndex),
-            "Quantized pool should have unique feature indices, but " <<
-            LabeledOutput(featureIndex) << " is repeated.");
+    CB_ENSURE(
+        poolMetainfo.HasChunkCodec() == (version == CompressedChunksVersion),
+        "Quantized pool format version " << version << " does not match chunk codec "
+        << (poolMetainfo.HasChunkCodec() ? poolMetainfo.GetChunkCodec() : TString("(none)")));
+
+    auto columnChunkInfos = ReadColumnChunkInfos(blob, epilogOffsets);
+    TConstArrayRef<char> chunksData = blob;
+    if (poolMetainfo.HasChunkCodec()) {
+        pool.ChunkCodec = poolMetainfo.GetChunkCodec();
+        pool.Blobs.push_back(DecompressChunks(
+            *NBlockCodecs::Codec(pool.ChunkCodec),
+            blob,
+            &columnChunkInfos,
+            localExecutor));
+        chunksData = {pool.Blobs.back().AsCharPtr(), pool.Blobs.back().Size()};
+    }
 
+    for (const auto& [featureIndex, chunkInfos] : columnChunkInfos) {
         ui32 localFeatureIndex;
         const bool isFakeColumn = NCB::NQuantizationSchemaDetail::IsFakeIndex(featureIndex, poolMetainfo);
         if (!isFakeColumn) {
@@ -522,32 +691,12 @@ static void CollectChunks(const TConstArrayRef<char> blob, NCB::TQuantizedPool&
         }
         auto& chunks = isFakeColumn ? stringColumnChunks.back() : pool.Chunks[localFeatureIndex];
 
-        ui32 chunkCount;
-        ReadLittleEndian(&chunkCount, &epilog);
-        ui32 chunkSize;
-        ui64 chunkOffset;
-        ui32 docOffset;
-        ui32 docsInChunkCount;
-        const size_t featureEpilogBytes = chunkCount * (sizeof(chunkSize) + sizeof(chunkOffset) + sizeof(docOffset) + sizeof(docsInChunkCount));
-        TVector<ui8> featureEpilog(featureEpilogBytes);
-        CB_ENSURE(featureEpilogBytes == epilog.Load(featureEpilog.data(), featureEpilogBytes));
-        const auto* featureEpilogPtr = featureEpilog.data();
-        for (ui32 chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
-            ReadLittleEndian(&chunkSize, &featureEpilogPtr);
-
-            ReadLittleEndian(&chunkOffset, &featureEpilogPtr);
-            CB_ENSURE(chunkOffset >= epilogOffsets.ChunksOffset);
-            CB_ENSURE(chunkOffset < blob.size());
-
-            ReadLittleEndian(&docOffset, &featureEpilogPtr);
-
-            ReadLittleEndian(&docsInChunkCount, &featureEpilogPtr);
-
-            const TConstArrayRef<char> chunkBlob{blob.data() + chunkOffset, chunkSize};
+        for (const auto& chunkInfo : chunkInfos) {
+            const TConstArrayRef<char> chunkBlob{chunksData.data() + chunkInfo.Offset, chunkInfo.Size};
             // TODO(yazevnul): validate flatbuffer, including document count
             const auto* const chunk = flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(chunkBlob.data());
 
-            chunks.emplace_back(docOffset, docsInChunkCount, chunk);
+            chunks.emplace_back(chunkInfo.DocumentOffset, chunkInfo.DocumentsInChunkCount, chunk);
         }
     }
 
@@ -585,12 +734,16 @@ NCB::TQuantizedPool NCB::LoadQuantizedPool(
 
     // TODO(yazevnul): optionally precharge pool
 
-    const TConstArrayRef<char> blobView{
+    const auto blobView = GetLastCompleteVersion({
         pool.Blobs.back().AsCharPtr(),
-        pool.Blobs.back().Size()};
+        pool.Blobs.back().Size()});
 
     ValidatePoolPart(blobView);
-    CollectChunks(blobView, pool);
+    CollectChunks(blobView, params.LocalExecutor, pool);
+    if (!pool.ChunkCodec.empty()) {
+        // chunks are decompressed into a separate blob, file is not needed anymore
+        pool.Blobs.erase(pool.Blobs.begin());
+    }
 
     return pool;
 }
@@ -675,7 +828,7 @@ static NCB::TQuantizedPoolDigest GetQuantizedPoolDigest(
 
 NCB::TQuantizedPoolDigest NCB::CalculateQuantizedPoolDigest(const TStringBuf path) {
     const auto file = TBlob::FromFile(TString(path));
-    const TConstArrayRef<char> blob(file.AsCharPtr(), file.Size());
+    const auto blob = GetLastCompleteVersion({file.AsCharPtr(), file.Size()});
     const auto chunksOffsetByReading = [blob] {
         TMemoryInput slave(blob.data(), blob.size());
         TCountingInput input(&slave);
@@ -705,7 +858,7 @@ NCB::TQuantizedPoolDigest NCB::CalculateQuantizedPoolDigest(const TStringBuf pat
 
 NCB::NIdl::TPoolQuantizationSchema NCB::LoadQuantizationSchemaFromPool(const TStringBuf path) {
     const auto file = TBlob::FromFile(TString(path));
-    const TConstArrayRef<char> blob(file.AsCharPtr(), file.Size());
+    const auto blob = GetLastCompleteVersion({file.AsCharPtr(), file.Size()});
     const auto chunksOffsetByReading = [blob] {
         TMemoryInput slave(blob.data(), blob.size());
         TCountingInput input(&slave);
@@ -728,7 +881,7 @@ NCB::NIdl::TPoolQuantizationSchema NCB::LoadQuantizationSchemaFromPool(const TSt
 
 NCB::NIdl::TPoolMetainfo NCB::LoadPoolMetainfo(const TStringBuf path) {
     const auto file = TBlob::FromFile(TString(path));
-    const TConstArrayRef<char> blob(file.AsCharPtr(), file.Size());
+    const auto blob = GetLastCompleteVersion({file.AsCharPtr(), file.Size()});
     const auto chunksOffsetByReading = [blob] {
         TMemoryInput slave(blob.data(), blob.size());
         TCountingInput input(&slave);
@@ -748,3 +901,148 @@ NCB::NIdl::TPoolMetainfo NCB::LoadPoolMetainfo(const TStringBuf path) {
 
     return poolMetainfo;
 }
+
+static void CheckAppendedColumns(const TPoolMetainfo& poolMetainfo, const TPoolMetainfo& appendedMetainfo) {
+    CB_ENSURE(
+        poolMetainfo.GetColumnIndexToType().size() == appendedMetainfo.GetColumnIndexToType().size(),
+        "appended documents have different number of columns "
+        LabeledOutput(poolMetainfo.GetColumnIndexToType().size(), appendedMetainfo.GetColumnIndexToType().size()));
+    for (const auto [columnIndex, columnType] : poolMetainfo.GetColumnIndexToType()) {
+        const auto it = appendedMetainfo.GetColumnIndexToType().find(columnIndex);
+        CB_ENSURE(
+            it != appendedMetainfo.GetColumnIndexToType().end() && it->second == columnType,
+            "appended documents have different type of column " << columnIndex);
+    }
+    CB_ENSURE(
+        std::equal(
+            poolMetainfo.GetIgnoredColumnIndices().begin(),
+            poolMetainfo.GetIgnoredColumnIndices().end(),
+            appendedMetainfo.GetIgnoredColumnIndices().begin(),
+            appendedMetainfo.GetIgnoredColumnIndices().end()),
+        "appended documents have different ignored columns");
+}
+
+static void CheckAppendedQuantizationSchema(
+    const TPoolQuantizationSchema& poolSchema,
+    const TPoolQuantizationSchema& appendedSchema) {
+
+    CB_ENSURE(
+        poolSchema.GetFeatureIndexToSchema().size() == appendedSchema.GetFeatureIndexToSchema().size(),
+        "appended documents have different number of quantized features "
+        LabeledOutput(poolSchema.GetFeatureIndexToSchema().size(), appendedSchema.GetFeatureIndexToSchema().size()));
+    for (const auto& [featureIndex, featureSchema] : poolSchema.GetFeatureIndexToSchema()) {
+        const auto it = appendedSchema.GetFeatureIndexToSchema().find(featureIndex);
+        CB_ENSURE(
+            it != appendedSchema.GetFeatureIndexToSchema().end(),
+            "feature " << featureIndex << " is not quantized in appended documents");
+        CB_ENSURE(
+            featureSchema.GetNanMode() == it->second.GetNanMode() && std::equal(
+                featureSchema.GetBorders().begin(),
+                featureSchema.GetBorders().end(),
+                it->second.GetBorders().begin(),
+                it->second.GetBorders().end()),
+            "appended documents are quantized with different borders of feature " << featureIndex);
+    }
+    CB_ENSURE(
+        std::equal(
+            poolSchema.GetClassNames().begin(),
+            poolSchema.GetClassNames().end(),
+            appendedSchema.GetClassNames().begin(),
+            appendedSchema.GetClassNames().end()),
+        "appended documents have different class names");
+}
+
+void NCB::AppendQuantizedPool(const TQuantizedPool& pool, const TStringBuf path) {
+    CB_ENSURE(!pool.HasStringColumns, "appending documents with string ids is not supported");
+
+    TPoolMetainfo poolMetainfo;
+    TPoolQuantizationSchema quantizationSchema;
+    TColumnChunkInfos columnChunkInfos;
+    ui64 chunksOffset = 0;
+    ui64 versionSize = 0;
+    {
+        const auto file = TBlob::FromFile(TString(path));
+        const auto blob = GetLastCompleteVersion({file.AsCharPtr(), file.Size()});
+        const auto epilogOffsets = ReadEpilogOffsets(blob);
+
+        const auto poolMetainfoSize = LittleToHost(ReadUnaligned<ui32>(
+            blob.data() + epilogOffsets.PoolMetainfoSizeOffset));
+        const auto poolMetainfoParsed = poolMetainfo.ParseFromArray(
+            blob.data() + epilogOffsets.PoolMetainfoSizeOffset + sizeof(ui32),
+            poolMetainfoSize);
+        CB_ENSURE(poolMetainfoParsed);
+
+        const auto quantizationSchemaSize = LittleToHost(ReadUnaligned<ui32>(
+            blob.data() + epilogOffsets.QuantizationSchemaSizeOffset));
+        const auto quantizationSchemaParsed = quantizationSchema.ParseFromArray(
+            blob.data() + epilogOffsets.QuantizationSchemaSizeOffset + sizeof(ui32),
+            quantizationSchemaSize);
+        CB_ENSURE(quantizationSchemaParsed);
+
+        columnChunkInfos = ReadColumnChunkInfos(blob, epilogOffsets);
+        chunksOffset = epilogOffsets.ChunksOffset;
+        versionSize = blob.size();
+    }
+
+    for (const auto& [columnIndex, chunkInfos] : columnChunkInfos) {
+        CB_ENSURE(
+            !NCB::NQuantizationSchemaDetail::IsFakeIndex(columnIndex, poolMetainfo),
+            "appending to quantized pool with string ids is not supported");
+        CB_ENSURE(
+            pool.ColumnIndexToLocalIndex.contains(columnIndex),
+            "column " << columnIndex << " is missing in appended documents");
+    }
+    CB_ENSURE(
+        columnChunkInfos.size() == pool.ColumnIndexToLocalIndex.size(),
+        "appended documents have columns missing in quantized pool");
+    CheckAppendedColumns(
+        poolMetainfo,
+        MakePoolMetainfo(
+            pool.ColumnIndexToLocalIndex,
+            pool.ColumnTypes,
+            pool.ColumnNames,
+            pool.DocumentCount,
+            pool.IgnoredColumnIndices));
+    CheckAppendedQuantizationSchema(quantizationSchema, pool.QuantizationSchema);
+
+    const ui64 documentOffset = poolMetainfo.GetDocumentCount();
+    const ui64 documentCount = documentOffset + pool.DocumentCount;
+    CB_ENSURE(documentCount <= Max<ui32>(), "too many documents in quantized pool " << LabeledOutput(documentCount));
+
+    TFile file(TString(path), OpenExisting | WrOnly);
+    file.Resize(versionSize); // drop the tail of a failed append, if any
+    file.Seek(versionSize, sSet);
+    TFileOutput fileOutput(file);
+
+    const ui64 baseOffset = RoundUpTo<ui64>(versionSize, 16);
+    for (ui64 offset = versionSize; offset < baseOffset; ++offset) {
+        fileOutput.Write('\0');
+    }
+    TCountingOutput output(&fileOutput);
+    {
+        // appended chunks are stored in the same way as existing ones
+        const auto* const codec = poolMetainfo.HasChunkCodec()
+            ? NBlockCodecs::Codec(poolMetainfo.GetChunkCodec())
+            : nullptr;
+        flatbuffers::FlatBufferBuilder builder;
+        TBuffer compressedChunk;
+        for (auto& [columnIndex, chunkInfos] : columnChunkInfos) {
+            const auto localIndex = pool.ColumnIndexToLocalIndex.at(columnIndex);
+            for (auto chunk : pool.Chunks[localIndex]) {
+                chunk.DocumentOffset += documentOffset;
+                WriteChunk(chunk, codec, &output, &chunkInfos, &builder, &compressedChunk);
+                chunkInfos.back().Offset += baseOffset;
+            }
+        }
+    }
+
+    poolMetainfo.SetDocumentCount(documentCount);
+    WriteEpilog(chunksOffset, poolMetainfo, quantizationSchema, columnChunkInfos, baseOffset, &output);
+
+    // new version becomes visible only after everything else is on disk
+    fileOutput.Flush();
+    file.Flush();
+    output.Write(MagicEnd, MagicEndSize);
+    fileOutput.Finish();
+    file.Flush();
+}
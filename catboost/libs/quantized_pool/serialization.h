@@ -1,5 +1,7 @@
 #pragma once
 
+#include <library/threading/local_executor/fwd.h>
+
 #include <util/generic/fwd.h>
 #include <util/stream/fwd.h>
 
@@ -14,14 +16,25 @@ namespace NCB {
 }
 
 namespace NCB {
+    // Chunks are compressed with `pool.ChunkCodec` if it is set.
     void SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* output);
 
+    // Append documents of `pool` to file saved by `SaveQuantizedPool`. Documents must be quantized
+    // with the same quantization schema, chunks are compressed with the codec of existing chunks.
+    // Existing data is not rewritten: new chunks and updated chunk tables are written to the end
+    // of file, so readers see either the previous or the new version.
+    void AppendQuantizedPool(const TQuantizedPool& pool, TStringBuf path);
+
     struct TLoadQuantizedPoolParameters {
         bool LockMemory = true;
         bool Precharge = true;
+        // compressed chunks are decompressed in parallel if set
+        NPar::TLocalExecutor* LocalExecutor = nullptr;
     };
 
     // Load quantized pool saved by `SaveQuantizedPool` from file.
+    // Raw chunks are used directly from mapped file, compressed chunks are decompressed into
+    // memory.
     TQuantizedPool LoadQuantizedPool(TStringBuf path, const TLoadQuantizedPoolParameters& params);
 
     NIdl::TPoolQuantizationSchema LoadQuantizationSchemaFromPool(TStringBuf path);
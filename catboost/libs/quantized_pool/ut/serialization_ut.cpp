@@ -2,14 +2,18 @@
 #include "print.h"
 #include "serialization.h"
 
+#include <library/threading/local_executor/local_executor.h>
 #include <library/unittest/registar.h>
 
 #include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 #include <contrib/libs/protobuf/util/message_differencer.h>
 
 #include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
+#include <catboost/idl/pool/proto/metainfo.pb.h>
 #include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/helpers/exception.h>
 
+#include <util/digest/numeric.h>
 #include <util/folder/dirut.h>
 #include <util/folder/path.h>
 #include <util/generic/algorithm.h>
@@ -21,9 +25,19 @@
 #include <util/stream/input.h>
 #include <util/stream/length.h>
 #include <util/stream/output.h>
+#include <util/system/byteorder.h>
+#include <util/system/file.h>
 #include <util/system/fstat.h>
+#include <util/system/unaligned_mem.h>
 
 using NCB::NIdl::TFeatureQuantizationSchema;
+
+static const size_t FormatVersionOffset = sizeof("CatboostQuantizedPool");  // magic with terminating zero
+
+static ui32 ReadFormatVersion(const TFsPath& path) {
+    const auto blob = TBlob::FromFile(path.GetPath());
+    return LittleToHost(ReadUnaligned<ui32>(blob.AsCharPtr() + FormatVersionOffset));
+}
 using NCB::NIdl::TPoolQuantizationSchema;
 
 static TPoolQuantizationSchema MakeQuantizationSchema() {
@@ -154,6 +168,69 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         UNIT_ASSERT_VALUES_EQUAL(loadedPoolAsText, poolAsText);
     }
 
+    Y_UNIT_TEST(TestSerializeDeserializeCompressed) {
+        auto pool = MakeQuantizedPool();
+        pool.ChunkCodec = "lz4";
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+
+        {
+            TFileOutput output(path.GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+        NCB::AppendQuantizedPool(pool, path.GetPath());
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(1);
+        const auto loadedPool = NCB::LoadQuantizedPool(path.GetPath(), {false, false, &localExecutor});
+        UNIT_ASSERT_VALUES_EQUAL(loadedPool.ChunkCodec, pool.ChunkCodec);
+        UNIT_ASSERT_VALUES_EQUAL(loadedPool.DocumentCount, 2 * pool.DocumentCount);
+
+        for (const auto [columnIndex, localIndex] : pool.ColumnIndexToLocalIndex) {
+            const auto& chunks = pool.Chunks[localIndex];
+            const auto& loadedChunks = loadedPool.Chunks[loadedPool.ColumnIndexToLocalIndex.at(columnIndex)];
+            UNIT_ASSERT_VALUES_EQUAL(loadedChunks.size(), 2 * chunks.size());
+            for (size_t i = 0; i < loadedChunks.size(); ++i) {
+                const auto& chunk = chunks[i % chunks.size()];
+                UNIT_ASSERT_VALUES_EQUAL(loadedChunks[i].Chunk->BitsPerDocument(), chunk.Chunk->BitsPerDocument());
+                UNIT_ASSERT(std::equal(
+                    loadedChunks[i].Chunk->Quants()->begin(),
+                    loadedChunks[i].Chunk->Quants()->end(),
+                    chunk.Chunk->Quants()->begin(),
+                    chunk.Chunk->Quants()->end()));
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestFormatVersion) {
+        auto pool = MakeQuantizedPool();
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+
+        {
+            TFileOutput output(path.GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+        NCB::AppendQuantizedPool(pool, path.GetPath());
+        UNIT_ASSERT_VALUES_EQUAL(ReadFormatVersion(path), 1);
+
+        pool.ChunkCodec = "lz4";
+        {
+            TFileOutput output(path.GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+        NCB::AppendQuantizedPool(pool, path.GetPath());
+        UNIT_ASSERT_VALUES_EQUAL(ReadFormatVersion(path), 2);
+        {
+            // version 1 header with compressed chunks
+            TFile file(path.GetPath(), OpenExisting | RdWr);
+            file.Seek(FormatVersionOffset, sSet);
+            const ui32 version = HostToLittle(ui32(1));
+            const ui32 versionHash = HostToLittle(IntHash(ui32(1)));
+            file.Write(&version, sizeof(version));
+            file.Write(&versionHash, sizeof(versionHash));
+        }
+        UNIT_ASSERT_EXCEPTION(NCB::LoadQuantizedPool(path.GetPath(), {false, false}), TCatBoostException);
+    }
+
     Y_UNIT_TEST(TestLoadQuantizationSchema) {
         const auto pool = MakeQuantizedPool();
         const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
@@ -169,6 +246,77 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         TString diff;
         UNIT_ASSERT_C(IsEqual(expectedQuantizationSchema, quantizationSchema, &diff), diff.data());
     }
+
+    Y_UNIT_TEST(TestAppend) {
+        const auto pool = MakeQuantizedPool();
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+
+        {
+            TFileOutput output(path.GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+        NCB::AppendQuantizedPool(pool, path.GetPath());
+        NCB::AppendQuantizedPool(pool, path.GetPath());
+
+        const auto loadedPool = NCB::LoadQuantizedPool(path.GetPath(), {false, false});
+        UNIT_ASSERT_VALUES_EQUAL(loadedPool.DocumentCount, 3 * pool.DocumentCount);
+        for (const auto [columnIndex, localIndex] : pool.ColumnIndexToLocalIndex) {
+            const auto& chunks = pool.Chunks[localIndex];
+            const auto& loadedChunks = loadedPool.Chunks[loadedPool.ColumnIndexToLocalIndex.at(columnIndex)];
+            UNIT_ASSERT_VALUES_EQUAL(loadedChunks.size(), 3 * chunks.size());
+            for (size_t i = 0; i < loadedChunks.size(); ++i) {
+                const auto& chunk = chunks[i % chunks.size()];
+                UNIT_ASSERT_VALUES_EQUAL(
+                    loadedChunks[i].DocumentOffset,
+                    chunk.DocumentOffset + i / chunks.size() * pool.DocumentCount);
+                UNIT_ASSERT_VALUES_EQUAL(loadedChunks[i].DocumentCount, chunk.DocumentCount);
+                UNIT_ASSERT(std::equal(
+                    loadedChunks[i].Chunk->Quants()->begin(),
+                    loadedChunks[i].Chunk->Quants()->end(),
+                    chunk.Chunk->Quants()->begin(),
+                    chunk.Chunk->Quants()->end()));
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestLoadInterruptedAppend) {
+        const auto pool = MakeQuantizedPool();
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+
+        {
+            TFileOutput output(path.GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+        const auto poolSize = GetFileLength(path.GetPath());
+        NCB::AppendQuantizedPool(pool, path.GetPath());
+        {
+            // emulate append that has not written the end of the new version yet
+            TFile file(path.GetPath(), OpenExisting | WrOnly);
+            file.Resize(GetFileLength(path.GetPath()) - 1);
+        }
+
+        const auto loadedPool = NCB::LoadQuantizedPool(path.GetPath(), {false, false});
+        UNIT_ASSERT_VALUES_EQUAL(QuantizedPoolToString(loadedPool), QuantizedPoolToString(pool));
+
+        // next append replaces the unfinished one
+        NCB::AppendQuantizedPool(pool, path.GetPath());
+        UNIT_ASSERT_VALUES_EQUAL(NCB::LoadPoolMetainfo(path.GetPath()).GetDocumentCount(), 2 * pool.DocumentCount);
+        UNIT_ASSERT(GetFileLength(path.GetPath()) > poolSize);
+    }
+
+    Y_UNIT_TEST(TestAppendWithDifferentSchema) {
+        const auto pool = MakeQuantizedPool();
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+
+        {
+            TFileOutput output(path.GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+
+        auto appendedPool = MakeQuantizedPool();
+        appendedPool.QuantizationSchema.MutableFeatureIndexToSchema()->at(0).AddBorders(1.0);
+        UNIT_ASSERT_EXCEPTION(NCB::AppendQuantizedPool(appendedPool, path.GetPath()), TCatBoostException);
+    }
 }
 
 Y_UNIT_TEST_SUITE(DigestTests) {
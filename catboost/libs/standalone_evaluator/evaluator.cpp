@@ -48,15 +48,34 @@ namespace NCatboostStandalone {
         auto treeSplitsPtr = ObliviousTrees->TreeSplits()->data();
         const auto treeCount =  ObliviousTrees->TreeSizes()->size();
         auto leafValuesPtr = ObliviousTrees->LeafValues()->data();
-        for (size_t treeId = 0; treeId < treeCount; ++treeId) {
-            const size_t treeSize = ObliviousTrees->TreeSizes()->Get(treeId);
-            size_t index{};
-            for (size_t depth = 0; depth < treeSize; ++depth) {
-                index |= (binaryFeatures[treeSplitsPtr[depth]] << depth);
+        const auto stepNodes = ObliviousTrees->NonSymmetricStepNodes();
+        if (stepNodes != nullptr && stepNodes->size() != 0) {
+            // non-symmetric trees: nodes of each tree are laid out in breadth-first order
+            auto nodeIdToLeafIdPtr = ObliviousTrees->NonSymmetricNodeIdToLeafId()->data();
+            size_t treeStart = 0;
+            for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+                const size_t treeSize = ObliviousTrees->TreeSizes()->Get(treeId);
+                size_t nodeIdx = 0;
+                for (auto stepNode = stepNodes->Get(treeStart); stepNode->LeftSubtreeDiff() != 0 || stepNode->RightSubtreeDiff() != 0; stepNode = stepNodes->Get(treeStart + nodeIdx)) {
+                    nodeIdx += binaryFeatures[treeSplitsPtr[nodeIdx]] ? stepNode->RightSubtreeDiff() : stepNode->LeftSubtreeDiff();
+                }
+                result += leafValuesPtr[nodeIdToLeafIdPtr[nodeIdx]];
+                treeSplitsPtr += treeSize;
+                nodeIdToLeafIdPtr += treeSize;
+                treeStart += treeSize;
+                leafValuesPtr += (treeSize + 1) / 2;
+            }
+        } else {
+            for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+                const size_t treeSize = ObliviousTrees->TreeSizes()->Get(treeId);
+                size_t index{};
+                for (size_t depth = 0; depth < treeSize; ++depth) {
+                    index |= (binaryFeatures[treeSplitsPtr[depth]] << depth);
+                }
+                result += leafValuesPtr[index];
+                treeSplitsPtr += treeSize;
+                leafValuesPtr += (1 << treeSize);
             }
-            result += leafValuesPtr[index];
-            treeSplitsPtr += treeSize;
-            leafValuesPtr += (1 << treeSize);
         }
         switch(predictionType) {
         case EPredictionType::RawValue:
@@ -0,0 +1,472 @@
+#include <catboost/libs/algo/calc_score_cache.h>
+#include <catboost/libs/algo/error_functions.h>
+#include <catboost/libs/algo/helpers.h>
+#include <catboost/libs/algo/learn_context.h>
+#include <catboost/libs/algo/online_ctr.h>
+#include <catboost/libs/algo/score_calcer.h>
+#include <catboost/libs/algo/split.h>
+#include <catboost/libs/algo/tensor_search_helpers.h>
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_util/path_with_scheme.h>
+#include <catboost/libs/labels/label_converter.h>
+#include <catboost/libs/metrics/auc.h>
+#include <catboost/libs/metrics/sample.h>
+#include <catboost/libs/options/catboost_options.h>
+#include <catboost/libs/options/load_options.h>
+#include <catboost/libs/options/output_file_options.h>
+#include <catboost/libs/options/plain_options_helper.h>
+#include <catboost/libs/train_lib/data.h>
+
+#include <library/json/json_value.h>
+#include <library/testing/benchmark/bench.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/singleton.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+/*
+ * Training hot paths on synthetic binary classification data, each benchmark for a small (10K objects)
+ * and a large (1M objects) dataset. Data is quantized and folds are built once per dataset size,
+ * so that only the benchmarked stage is measured. CalcStatsAndScoresSparse* compare scoring of sparse
+ * one-hot like features with and without exclusive features bundling.
+ * Model evaluation is benchmarked in catboost/libs/model/benchmark.
+ */
+
+using namespace NCB;
+
+namespace {
+    constexpr int ThreadCount = 4;
+    constexpr ui32 FloatFeatureCount = 32;
+    constexpr ui32 CatFeatureCount = 2;
+    constexpr ui32 CatFeatureUniqueValuesCount = 1000;
+    constexpr ui32 SparseFloatFeatureCount = 64;
+
+    // depth of the tree level scores are calculated for
+    constexpr int ScoreDepth = 4;
+
+    NJson::TJsonValue MakeBenchmarkParams() {
+        NJson::TJsonValue params;
+        params["loss_function"] = "Logloss";
+        params["boosting_type"] = "Plain";
+        params["bootstrap_type"] = "No";
+        params["thread_count"] = ThreadCount;
+        params["random_seed"] = 0;
+        params["allow_writing_files"] = false;
+        return params;
+    }
+
+    struct TBenchmarkExecutor {
+        NPar::TLocalExecutor LocalExecutor;
+
+        TBenchmarkExecutor() {
+            LocalExecutor.RunAdditionalThreads(ThreadCount - 1);
+        }
+    };
+
+    // quantized data and learn context with derivatives calculated for the first fold
+    struct TLearnContextBenchmarkData {
+        NPar::TLocalExecutor& LocalExecutor = Singleton<TBenchmarkExecutor>()->LocalExecutor;
+        TTrainingForCPUDataProviders Data;
+        THolder<TLearnContext> Ctx;
+        THolder<IDerCalcer> Error;
+        TVector<TIndexType> Indices;
+
+    protected:
+        void Init(TDataProviders dataProviders, const NJson::TJsonValue& plainParams, TReallyFastRng32* rng) {
+            const ui32 objectCount = dataProviders.Learn->GetObjectCount();
+
+            NJson::TJsonValue trainOptionsJson;
+            NJson::TJsonValue outputOptionsJson;
+            NCatboostOptions::PlainJsonToOptions(plainParams, &trainOptionsJson, &outputOptionsJson);
+
+            NCatboostOptions::TCatBoostOptions params = NCatboostOptions::LoadOptions(trainOptionsJson);
+            NCatboostOptions::TOutputFilesOptions outputOptions;
+            outputOptions.Load(outputOptionsJson);
+
+            TLabelConverter labelConverter;
+            TRestorableFastRng64 rand(0);
+            Data = GetTrainingData(
+                std::move(dataProviders),
+                /*bordersFile*/ Nothing(),
+                /*ensureConsecutiveLearnFeaturesDataForCpu*/ true,
+                /*allowWriteFiles*/ false,
+                /*quantizedFeaturesInfo*/ nullptr,
+                &params,
+                &labelConverter,
+                &LocalExecutor,
+                &rand
+            ).Cast<TQuantizedForCPUObjectsDataProvider>();
+
+            Ctx = MakeHolder<TLearnContext>(
+                params,
+                /*objectiveDescriptor*/ Nothing(),
+                /*evalMetricDescriptor*/ Nothing(),
+                outputOptions,
+                Data.Learn->MetaInfo.FeaturesLayout,
+                /*initRand*/ Nothing(),
+                &LocalExecutor
+            );
+            const auto& quantizedFeaturesInfo = *Data.Learn->ObjectsData->GetQuantizedFeaturesInfo();
+            Ctx->LearnProgress.FloatFeatures = CreateFloatFeatures(quantizedFeaturesInfo);
+            Ctx->LearnProgress.CatFeatures = CreateCatFeatures(quantizedFeaturesInfo);
+            Ctx->InitContext(Data);
+
+            Ctx->SampledDocs.Create(
+                Ctx->LearnProgress.Folds,
+                /*isPairwiseScoring*/ false,
+                static_cast<int>(Ctx->Params.ObliviousTreeOptions->DevScoreCalcObjBlockSize),
+                GetBernoulliSampleRate(Ctx->Params.ObliviousTreeOptions->BootstrapConfig)
+            );
+
+            Error = BuildError(Ctx->Params, Nothing());
+
+            TFold* fold = &Ctx->LearnProgress.Folds[0];
+            CalcWeightedDerivatives(*Error, /*bodyTailIdx*/ 0, Ctx->Params, /*randomSeed*/ 0, fold, &LocalExecutor);
+
+            // objects are distributed between leaves of the ScoreDepth tree level at random
+            Indices.yresize(objectCount);
+            for (auto& index : Indices) {
+                index = rng->Uniform(1u << ScoreDepth);
+            }
+            Bootstrap(Ctx->Params, Indices, fold, &Ctx->SampledDocs, &LocalExecutor, &Ctx->Rand);
+        }
+    };
+
+    template <ui32 ObjectCount>
+    struct TTrainingBenchmarkData : public TLearnContextBenchmarkData {
+        TTrainingBenchmarkData() {
+            TReallyFastRng32 rng(0);
+            TVector<TVector<float>> floatFeatures(FloatFeatureCount, TVector<float>(ObjectCount));
+            TVector<TVector<TString>> catFeatures(CatFeatureCount, TVector<TString>(ObjectCount));
+            TVector<float> target(ObjectCount);
+            for (auto objectIdx : xrange(ObjectCount)) {
+                for (auto featureIdx : xrange(FloatFeatureCount)) {
+                    floatFeatures[featureIdx][objectIdx] = rng.GenRandReal1();
+                }
+                for (auto featureIdx : xrange(CatFeatureCount)) {
+                    catFeatures[featureIdx][objectIdx] = ToString(rng.Uniform(CatFeatureUniqueValuesCount));
+                }
+                const float noise = 0.5f * rng.GenRandReal1();
+                target[objectIdx] = floatFeatures[0][objectIdx] + floatFeatures[1][objectIdx] + noise > 1.25f;
+            }
+
+            TVector<ui32> catFeatureIndices;
+            for (auto featureIdx : xrange(CatFeatureCount)) {
+                catFeatureIndices.push_back(FloatFeatureCount + featureIdx);
+            }
+
+            TDataProviders dataProviders;
+            dataProviders.Learn = CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.HasTarget = true;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        FloatFeatureCount + CatFeatureCount,
+                        catFeatureIndices,
+                        TVector<TString>{},
+                        nullptr);
+
+                    visitor->Start(metaInfo, ObjectCount, EObjectsOrder::Undefined, {});
+
+                    for (auto featureIdx : xrange(FloatFeatureCount)) {
+                        visitor->AddFloatFeature(
+                            featureIdx,
+                            TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(floatFeatures[featureIdx]))
+                        );
+                    }
+                    for (auto featureIdx : xrange(CatFeatureCount)) {
+                        visitor->AddCatFeature(catFeatureIndices[featureIdx], MakeConstArrayRef(catFeatures[featureIdx]));
+                    }
+                    visitor->AddTarget(target);
+
+                    visitor->Finish();
+                }
+            );
+
+            Init(std::move(dataProviders), MakeBenchmarkParams(), &rng);
+        }
+    };
+
+    // one-hot like data: each object has a non-default value of exactly one float feature
+    template <ui32 ObjectCount, bool ExclusiveFeaturesBundling>
+    struct TSparseTrainingBenchmarkData : public TLearnContextBenchmarkData {
+        TSparseTrainingBenchmarkData() {
+            TReallyFastRng32 rng(0);
+            TVector<TVector<float>> floatFeatures(SparseFloatFeatureCount, TVector<float>(ObjectCount, 0.0f));
+            TVector<float> target(ObjectCount);
+            for (auto objectIdx : xrange(ObjectCount)) {
+                const ui32 featureIdx = rng.Uniform(SparseFloatFeatureCount);
+                floatFeatures[featureIdx][objectIdx] = 1.0f + rng.GenRandReal1();
+                const float noise = 0.5f * rng.GenRandReal1();
+                target[objectIdx] = (featureIdx % 2) * floatFeatures[featureIdx][objectIdx] + noise > 1.0f;
+            }
+
+            TDataProviders dataProviders;
+            dataProviders.Learn = CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.HasTarget = true;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        SparseFloatFeatureCount,
+                        TVector<ui32>{},
+                        TVector<TString>{},
+                        nullptr);
+
+                    visitor->Start(metaInfo, ObjectCount, EObjectsOrder::Undefined, {});
+
+                    for (auto featureIdx : xrange(SparseFloatFeatureCount)) {
+                        visitor->AddFloatFeature(
+                            featureIdx,
+                            TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(floatFeatures[featureIdx]))
+                        );
+                    }
+                    visitor->AddTarget(target);
+
+                    visitor->Finish();
+                }
+            );
+
+            NJson::TJsonValue params = MakeBenchmarkParams();
+            // 8 features with 32 bins fit in one bundle
+            params["border_count"] = 31;
+            params["dev_exclusive_features_bundling"] = ExclusiveFeaturesBundling;
+            Init(std::move(dataProviders), params, &rng);
+        }
+    };
+
+    template <ui32 ObjectCount>
+    struct TAucBenchmarkData {
+        TVector<NMetrics::TSample> Samples;
+
+        TAucBenchmarkData() {
+            TReallyFastRng32 rng(0);
+            Samples.reserve(ObjectCount);
+            for (auto objectIdx : xrange(ObjectCount)) {
+                Y_UNUSED(objectIdx);
+                const double target = rng.Uniform(2);
+                Samples.emplace_back(target, target + 2 * rng.GenRandReal1(), rng.GenRandReal1());
+            }
+        }
+    };
+
+    template <ui32 ObjectCount>
+    struct TDsvBenchmarkData {
+        TTempFile File;
+
+        TDsvBenchmarkData()
+            : File(MakeTempName())
+        {
+            TReallyFastRng32 rng(0);
+            TOFStream out(File.Name());
+            for (auto objectIdx : xrange(ObjectCount)) {
+                Y_UNUSED(objectIdx);
+                out << rng.Uniform(2);
+                for (auto featureIdx : xrange(FloatFeatureCount)) {
+                    Y_UNUSED(featureIdx);
+                    out << '\t' << rng.GenRandReal1();
+                }
+                out << '\n';
+            }
+        }
+    };
+}
+
+template <ui32 ObjectCount>
+static void BenchmarkCalcWeightedDerivatives(const NBench::NCpu::TParams& iface) {
+    auto& data = *Singleton<TTrainingBenchmarkData<ObjectCount>>();
+    TFold* fold = &data.Ctx->LearnProgress.Folds[0];
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        CalcWeightedDerivatives(*data.Error, /*bodyTailIdx*/ 0, data.Ctx->Params, iteration, fold, &data.LocalExecutor);
+        Y_DO_NOT_OPTIMIZE_AWAY(fold->BodyTailArr[0].WeightedDerivatives[0].data());
+    }
+}
+
+template <ui32 ObjectCount>
+static void BenchmarkCalcStatsAndScores(const NBench::NCpu::TParams& iface) {
+    auto& data = *Singleton<TTrainingBenchmarkData<ObjectCount>>();
+    auto& ctx = *data.Ctx;
+    TFold* fold = &ctx.LearnProgress.Folds[0];
+    const TFlatPairsInfo pairs;
+    TVector<TScoreBin> scoreBins;
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        TSplitCandidate splitCandidate;
+        splitCandidate.FeatureIdx = iteration % FloatFeatureCount;
+        splitCandidate.Type = ESplitType::FloatFeature;
+
+        CalcStatsAndScores(
+            *data.Data.Learn->ObjectsData,
+            fold->GetAllCtrs(),
+            ctx.SampledDocs,
+            ctx.SmallestSplitSideDocs,
+            fold,
+            pairs,
+            ctx.Params,
+            TSplitEnsemble(std::move(splitCandidate)),
+            ScoreDepth,
+            /*useTreeLevelCaching*/ false,
+            &data.LocalExecutor,
+            &ctx.PrevTreeLevelStats,
+            /*stats3d*/ nullptr,
+            /*pairwiseStats*/ nullptr,
+            &scoreBins);
+        Y_DO_NOT_OPTIMIZE_AWAY(scoreBins.data());
+    }
+}
+
+// scores all float feature candidates of a tree level, candidates are built as in greedy_tensor_search
+template <class TData>
+static void BenchmarkCalcStatsAndScoresForSparseFeatures(const NBench::NCpu::TParams& iface) {
+    auto& data = *Singleton<TData>();
+    auto& ctx = *data.Ctx;
+    const auto& objectsData = *data.Data.Learn->ObjectsData;
+    TFold* fold = &ctx.LearnProgress.Folds[0];
+    const TFlatPairsInfo pairs;
+
+    TVector<TSplitEnsemble> splitEnsembles;
+    for (auto bundleIdx : xrange(SafeIntegerCast<ui32>(objectsData.GetExclusiveFeatureBundlesSize()))) {
+        splitEnsembles.emplace_back(TExclusiveFeaturesBundleRef{bundleIdx});
+    }
+    for (auto featureIdx : xrange(SparseFloatFeatureCount)) {
+        const TFloatFeatureIdx floatFeatureIdx(featureIdx);
+        if (objectsData.GetFloatFeatureToExclusiveBundleIndex(floatFeatureIdx) ||
+            objectsData.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx))
+        {
+            continue;
+        }
+        TSplitCandidate splitCandidate;
+        splitCandidate.FeatureIdx = featureIdx;
+        splitCandidate.Type = ESplitType::FloatFeature;
+        splitEnsembles.emplace_back(std::move(splitCandidate));
+    }
+
+    TVector<TScoreBin> scoreBins;
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        for (const auto& splitEnsemble : splitEnsembles) {
+            CalcStatsAndScores(
+                objectsData,
+                fold->GetAllCtrs(),
+                ctx.SampledDocs,
+                ctx.SmallestSplitSideDocs,
+                fold,
+                pairs,
+                ctx.Params,
+                splitEnsemble,
+                ScoreDepth,
+                /*useTreeLevelCaching*/ false,
+                &data.LocalExecutor,
+                &ctx.PrevTreeLevelStats,
+                /*stats3d*/ nullptr,
+                /*pairwiseStats*/ nullptr,
+                &scoreBins);
+            Y_DO_NOT_OPTIMIZE_AWAY(scoreBins.data());
+        }
+    }
+}
+
+template <ui32 ObjectCount>
+static void BenchmarkComputeOnlineCTRs(const NBench::NCpu::TParams& iface) {
+    auto& data = *Singleton<TTrainingBenchmarkData<ObjectCount>>();
+    const TFold& fold = data.Ctx->LearnProgress.Folds[0];
+    TOnlineCTR ctr;
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        TProjection projection;
+        projection.AddCatFeature(iteration % CatFeatureCount);
+        ComputeOnlineCTRs(data.Data, fold, projection, data.Ctx.Get(), &ctr);
+        Y_DO_NOT_OPTIMIZE_AWAY(ctr.Feature.data());
+    }
+}
+
+template <ui32 ObjectCount>
+static void BenchmarkCalcAUC(const NBench::NCpu::TParams& iface) {
+    const auto& data = *Singleton<TAucBenchmarkData<ObjectCount>>();
+    auto& localExecutor = Singleton<TBenchmarkExecutor>()->LocalExecutor;
+    TVector<NMetrics::TSample> samples;
+    TVector<NMetrics::TSample> sortBuffer;
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        // CalcAUC reorders samples
+        samples = data.Samples;
+        Y_DO_NOT_OPTIMIZE_AWAY(CalcAUC(&samples, &sortBuffer, &localExecutor));
+    }
+}
+
+template <ui32 ObjectCount>
+static void BenchmarkReadDsv(const NBench::NCpu::TParams& iface) {
+    const auto& data = *Singleton<TDsvBenchmarkData<ObjectCount>>();
+    auto& localExecutor = Singleton<TBenchmarkExecutor>()->LocalExecutor;
+    for (size_t iteration = 0; iteration < iface.Iterations(); ++iteration) {
+        const TDataProviderPtr dataProvider = ReadDataset(
+            TPathWithScheme(data.File.Name(), "dsv"),
+            TPathWithScheme(),
+            TPathWithScheme(),
+            NCatboostOptions::TDsvPoolFormatParams(),
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Undefined,
+            &localExecutor);
+        Y_DO_NOT_OPTIMIZE_AWAY(dataProvider.Get());
+    }
+}
+
+Y_CPU_BENCHMARK(CalcWeightedDerivatives10K, iface) {
+    BenchmarkCalcWeightedDerivatives<10000>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcWeightedDerivatives1M, iface) {
+    BenchmarkCalcWeightedDerivatives<1000000>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcStatsAndScores10K, iface) {
+    BenchmarkCalcStatsAndScores<10000>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcStatsAndScores1M, iface) {
+    BenchmarkCalcStatsAndScores<1000000>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcStatsAndScoresSparse10K, iface) {
+    BenchmarkCalcStatsAndScoresForSparseFeatures<TSparseTrainingBenchmarkData<10000, false>>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcStatsAndScoresSparse1M, iface) {
+    BenchmarkCalcStatsAndScoresForSparseFeatures<TSparseTrainingBenchmarkData<1000000, false>>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcStatsAndScoresSparseBundled10K, iface) {
+    BenchmarkCalcStatsAndScoresForSparseFeatures<TSparseTrainingBenchmarkData<10000, true>>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcStatsAndScoresSparseBundled1M, iface) {
+    BenchmarkCalcStatsAndScoresForSparseFeatures<TSparseTrainingBenchmarkData<1000000, true>>(iface);
+}
+
+Y_CPU_BENCHMARK(ComputeOnlineCTRs10K, iface) {
+    BenchmarkComputeOnlineCTRs<10000>(iface);
+}
+
+Y_CPU_BENCHMARK(ComputeOnlineCTRs1M, iface) {
+    BenchmarkComputeOnlineCTRs<1000000>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcAUC10K, iface) {
+    BenchmarkCalcAUC<10000>(iface);
+}
+
+Y_CPU_BENCHMARK(CalcAUC1M, iface) {
+    BenchmarkCalcAUC<1000000>(iface);
+}
+
+Y_CPU_BENCHMARK(ReadDsv10K, iface) {
+    BenchmarkReadDsv<10000>(iface);
+}
+
+Y_CPU_BENCHMARK(ReadDsv1M, iface) {
+    BenchmarkReadDsv<1000000>(iface);
+}
@@ -96,6 +96,8 @@ namespace NCB {
             TQuantizationOptions quantizationOptions;
             if (params->GetTaskType() == ETaskType::CPU) {
                 quantizationOptions.GpuCompatibleFormat = false;
+                quantizationOptions.BundleExclusiveFeaturesForCpu
+                    = params->DataProcessingOptions->DevExclusiveFeaturesBundling.Get();
             } else {
                 Y_ASSERT(params->GetTaskType() == ETaskType::GPU);
 
@@ -110,6 +112,8 @@ namespace NCB {
             quantizationOptions.CpuRamLimit
                 = ParseMemorySizeDescription(params->SystemOptions->CpuUsedRamLimit.Get());
             quantizationOptions.AllowWriteFiles = allowWriteFiles;
+            quantizationOptions.QuantileSketchKForBuildBorders
+                = params->DataProcessingOptions->DevBorderSelectionSketchSize.Get();
 
             if (!quantizedFeaturesInfo) {
                 quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
@@ -1,5 +1,6 @@
 #include "preprocess.h"
 
+#include <catboost/libs/algo/learn_context.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/permutation.h>
 #include <catboost/libs/helpers/progress_helper.h>
@@ -52,7 +53,11 @@ void UpdateUndefinedRandomSeed(ETaskType taskType,
         TString serializedTrainParams;
         NJson::TJsonValue restoredJsonParams;
         try {
-            TProgressHelper(ToString(taskType)).CheckedLoad(snapshotFilename, [&](TIFStream* inputStream) {
+            // all CPU progress layouts start with the same fields
+            const bool isCpu = taskType == ETaskType::CPU;
+            const TString progressLabel = isCpu ? GetCpuProgressLabel() : ToString(taskType);
+            const TVector<TString> legacyProgressLabels = isCpu ? TVector<TString>{GetCpuLegacyProgressLabel()} : TVector<TString>();
+            TProgressHelper(progressLabel).CheckedLoad(snapshotFilename, legacyProgressLabels, [&](TIFStream* inputStream, const TString&) {
                 paramsLoader(inputStream, serializedTrainParams);
             });
             ReadJsonTree(serializedTrainParams, &restoredJsonParams);
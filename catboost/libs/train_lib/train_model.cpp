@@ -32,9 +32,11 @@
 #include <catboost/libs/pairs/util.h>
 #include <catboost/libs/target/classification_target_helper.h>
 
+#include <library/chromium_trace/interface.h>
 #include <library/grid_creator/binarization.h>
 #include <library/json/json_prettifier.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/mapfindptr.h>
 #include <util/generic/scope.h>
 #include <util/generic/vector.h>
@@ -54,7 +56,7 @@ static void ShrinkModel(int itCount, const TCtrHelper& ctrsHelper, TLearnProgres
     progress->TreeStats.resize(itCount);
     progress->UsedCtrSplits.clear();
     for (const auto& tree: progress->TreeStruct) {
-        for (const auto& split: tree.GetCtrSplits()) {
+        for (const auto& split: GetCtrSplits(tree)) {
             TProjection projection = split.Projection;
             ECtrType ctrType = ctrsHelper.GetCtrInfo(projection)[split.CtrIdx].Type;
             progress->UsedCtrSplits.insert(std::make_pair(ctrType, projection));
@@ -69,6 +71,8 @@ static TDataProviders LoadPools(
     NPar::TLocalExecutor* const executor,
     TProfileInfo* profile
 ) {
+    CHROMIUM_TRACE_SCOPE("Load pools");
+
     const auto& cvParams = loadOptions.CvParams;
     const bool cvMode = cvParams.FoldCount != 0;
     CB_ENSURE(
@@ -289,9 +293,16 @@ static void InitializeSamplingStructures(
             CountNonCtrBuckets(
                 *data.Learn->ObjectsData->GetQuantizedFeaturesInfo(),
                 ctx->Params.CatFeatureParams->OneHotMaxSize),
-            static_cast<int>(ctx->Params.ObliviousTreeOptions->MaxDepth)
+            static_cast<int>(ctx->Params.ObliviousTreeOptions->MaxDepth),
+            ctx->Params.ObliviousTreeOptions->DevCompactScoreCache
         );
     }
+    if (ctx->Params.ObliviousTreeOptions->GrowingPolicy != EGrowingPolicy::ObliviousTree) {
+        if (ctx->ReuseLeafStats()) {
+            ctx->SmallestSplitSideDocs.Create(ctx->LearnProgress.Folds, isPairwiseScoring, defaultCalcStatsObjBlockSize);
+        }
+        ctx->NewLeavesDocs.Create(ctx->LearnProgress.Folds, isPairwiseScoring, defaultCalcStatsObjBlockSize);
+    }
     ctx->SampledDocs.Create(
         ctx->LearnProgress.Folds,
         isPairwiseScoring,
@@ -326,8 +337,8 @@ static void Train(
     TMetricsData metricsData;
     InitializeAndCheckMetricData(data, forceCalcEvalMetricOnEveryIteration, *ctx, &metricsData);
 
-    if (ctx->TryLoadProgress() && ctx->Params.SystemOptions->IsMaster()) {
-        MapRestoreApproxFromTreeStruct(ctx);
+    if (ctx->TryLoadProgress(data) && ctx->Params.SystemOptions->IsMaster()) {
+        MapRestoreApproxFromTreeStruct(data, ctx);
     }
 
     TLoggingData loggingData;
@@ -354,6 +365,8 @@ static void Train(
             break;
         }
 
+        CHROMIUM_TRACE_SCOPE("Iteration");
+
         profile.StartNextIteration();
 
         if (timer.Passed() > ctx->OutputOptions.GetSnapshotSaveInterval()) {
@@ -389,6 +402,11 @@ static void Train(
         }
 
         profile.FinishIteration();
+        if (ctx->OnlineCtrCache.HasSizeLimit()) {
+            for (const auto& [name, value] : ctx->OnlineCtrCache.GetCounters()) {
+                profile.SetCounter(name, value);
+            }
+        }
 
         TProfileResults profileResults = profile.GetProfileResults();
         ctx->LearnProgress.MetricsAndTimeHistory.TimeHistory.push_back(TTimeInfo(profileResults));
@@ -493,6 +511,10 @@ namespace {
             NCatboostOptions::TCatBoostOptions updatedParams(NCatboostOptions::LoadOptions(jsonParams));
             NCatboostOptions::TOutputFilesOptions updatedOutputOptions = outputOptions;
 
+            if (!updatedParams.SystemOptions->IsSingleHost()) {
+                // ordered boosting is not implemented for distributed training, don't select it by default
+                updatedParams.BoostingOptions->BoostingType.SetDefault(EBoostingType::Plain);
+            }
             SetDataDependentDefaults(
                 trainingDataForCpu.Learn->GetObjectCount(),
                 /*hasLearnTarget*/ trainingDataForCpu.Learn->MetaInfo.HasTarget,
@@ -534,8 +556,15 @@ namespace {
             const auto& systemOptions = ctx.Params.SystemOptions;
             if (!systemOptions->IsSingleHost()) { // send target, weights, baseline (if present), binarized features to workers and ask them to create plain folds
                 InitializeMaster(&ctx);
-                CB_ENSURE(IsPlainMode(ctx.Params.BoostingOptions->BoostingType), "Distributed training requires plain boosting");
-                CB_ENSURE(!ctx.Layout->GetCatFeatureCount(), "Distributed training doesn't support categorical features");
+                CB_ENSURE(
+                    IsPlainMode(ctx.Params.BoostingOptions->BoostingType),
+                    "Distributed training doesn't support ordered boosting, use boosting_type=Plain");
+                CB_ENSURE(
+                    ctx.Params.CatFeatureParams->CtrLeafCountLimit.Get() == Max<ui64>(),
+                    "Distributed training doesn't support ctr_leaf_count_limit");
+                CB_ENSURE(
+                    !ctx.OnlineCtrCache.HasSizeLimit(),
+                    "Distributed training doesn't support online_ctr_cache_size");
                 MapBuildPlainFold(trainingDataForCpu.Learn, &ctx);
             }
             TVector<TVector<double>> oneRawValues(ctx.LearnProgress.ApproxDimension);
@@ -575,16 +604,33 @@ namespace {
             THashMap<TFeatureCombination, TProjection> featureCombinationToProjectionMap;
             {
                 TObliviousTreeBuilder builder(ctx.LearnProgress.FloatFeatures, ctx.LearnProgress.CatFeatures, ctx.LearnProgress.ApproxDimension);
-                for (size_t treeId = 0; treeId < ctx.LearnProgress.TreeStruct.size(); ++treeId) {
+                const auto getModelSplits = [&] (TConstArrayRef<TSplit> splits) {
                     TVector<TModelSplit> modelSplits;
-                    for (const auto& split : ctx.LearnProgress.TreeStruct[treeId].Splits) {
+                    for (const auto& split : splits) {
                         auto modelSplit = split.GetModelSplit(ctx, perfectHashedToHashedCatValuesMap);
                         modelSplits.push_back(modelSplit);
                         if (modelSplit.Type == ESplitType::OnlineCtr) {
                             featureCombinationToProjectionMap[modelSplit.OnlineCtr.Ctr.Base.Projection] = split.Ctr.Projection;
                         }
                     }
-                    builder.AddTree(modelSplits, ctx.LearnProgress.LeafValues[treeId], ctx.LearnProgress.TreeStats[treeId].LeafWeightsSum);
+                    return modelSplits;
+                };
+                for (size_t treeId = 0; treeId < ctx.LearnProgress.TreeStruct.size(); ++treeId) {
+                    const auto& treeStruct = ctx.LearnProgress.TreeStruct[treeId];
+                    const auto& leafValues = ctx.LearnProgress.LeafValues[treeId];
+                    const auto& leafWeights = ctx.LearnProgress.TreeStats[treeId].LeafWeightsSum;
+                    if (HoldsAlternative<TSplitTree>(treeStruct)) {
+                        builder.AddTree(getModelSplits(Get<TSplitTree>(treeStruct).Splits), leafValues, leafWeights);
+                    } else {
+                        const auto& nodes = Get<TNonSymmetricTreeStructure>(treeStruct).Nodes;
+                        TVector<TSplit> nodeSplits;
+                        TVector<std::pair<int, int>> nodeChildren;
+                        for (const auto& node : nodes) {
+                            nodeSplits.push_back(node.Split);
+                            nodeChildren.emplace_back(node.Left, node.Right);
+                        }
+                        builder.AddNonSymmetricTree(getModelSplits(nodeSplits), nodeChildren, leafValues, leafWeights);
+                    }
                 }
                 obliviousTrees = builder.Build();
             }
@@ -801,6 +847,33 @@ static void TrainModel(
 }
 
 
+// trace spans are written to the file while the returned sink is alive
+static THolder<NChromiumTrace::TGlobalJsonFileSink> CreateTraceSink(
+    const NCatboostOptions::TOutputFilesOptions& outputOptions
+) {
+    const TString traceFile = outputOptions.CreateTraceFullPath();
+    if (!outputOptions.AllowWriteFiles() || traceFile.empty()) {
+        return nullptr;
+    }
+    if (outputOptions.GetTrainDir()) {
+        TFsPath dirPath(outputOptions.GetTrainDir());
+        if (!dirPath.Exists()) {
+            dirPath.MkDirs();
+        }
+    }
+    return MakeHolder<NChromiumTrace::TGlobalJsonFileSink>(traceFile);
+}
+
+static void RunExecutorThreads(const NCatboostOptions::TSystemOptions& systemOptions, NPar::TLocalExecutor* executor) {
+    if (systemOptions.WorkStealing.GetUnchecked()) {
+        executor->SetRangeScheduling(NPar::TLocalExecutor::ERangeScheduling::WorkStealing);
+    }
+    // must be set before threads are started
+    executor->SetThreadPinning(systemOptions.ThreadPinning.GetUnchecked());
+    executor->RunAdditionalThreads(systemOptions.NumThreads.Get() - 1);
+}
+
+
 void TrainModel(
     const NCatboostOptions::TPoolLoadParams& loadOptions,
     const NCatboostOptions::TOutputFilesOptions& outputOptions,
@@ -811,6 +884,8 @@ void TrainModel(
 
     TSetLogging inThisScope(catBoostOptions.LoggingLevel);
 
+    const auto traceSink = CreateTraceSink(outputOptions);
+
     TProfileInfo profile;
 
     CB_ENSURE(
@@ -819,7 +894,7 @@ void TrainModel(
     );
 
     NPar::TLocalExecutor executor;
-    executor.RunAdditionalThreads(catBoostOptions.SystemOptions.Get().NumThreads.Get() - 1);
+    RunExecutorThreads(catBoostOptions.SystemOptions.Get(), &executor);
 
     TDataProviders pools = LoadPools(
         loadOptions,
@@ -1064,7 +1139,7 @@ void ModelBasedEval(
     );
 
     NPar::TLocalExecutor executor;
-    executor.RunAdditionalThreads(catBoostOptions.SystemOptions.Get().NumThreads.Get() - 1);
+    RunExecutorThreads(catBoostOptions.SystemOptions.Get(), &executor);
 
     TDataProviders pools = LoadPools(
         loadOptions,
@@ -1128,9 +1203,10 @@ void TrainModel(
     NCatboostOptions::TOutputFilesOptions outputOptions;
     outputOptions.Load(outputFilesOptionsJson);
 
+    const auto traceSink = CreateTraceSink(outputOptions);
+
     NPar::TLocalExecutor executor;
-    executor.RunAdditionalThreads(
-        NCatboostOptions::LoadOptions(trainOptionsJson).SystemOptions.Get().NumThreads.Get() - 1);
+    RunExecutorThreads(NCatboostOptions::LoadOptions(trainOptionsJson).SystemOptions.Get(), &executor);
 
     TrainModel(
         trainOptionsJson,
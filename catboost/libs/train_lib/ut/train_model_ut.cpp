@@ -1,6 +1,10 @@
 #include <catboost/libs/data_new/data_provider_builders.h>
 #include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/libs/labels/label_converter.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/options/catboost_options.h>
+#include <catboost/libs/options/plain_options_helper.h>
+#include <catboost/libs/train_lib/data.h>
 #include <catboost/libs/train_lib/train_model.h>
 #include <catboost/libs/ut_helpers/data_provider.h>
 
@@ -212,4 +216,199 @@ Y_UNIT_TEST_SUITE(TrainModelTests) {
 
         UNIT_ASSERT_VALUES_UNEQUAL(predictions[0][0], predictions[1][0]);
     }
+
+    Y_UNIT_TEST(TrainWithNonSymmetricTrees) {
+        // Model built from non-symmetric trees must give the same predictions as the ones
+        // calculated during training.
+
+        const ui64 seed = 20190703;
+        const ui32 objectCount = 200;
+        const ui32 numericFeatureCount = 4;
+
+        for (TStringBuf growingPolicy : {"Lossguide", "Levelwise"}) {
+            TTempDir trainDir;
+
+            TVector<TVector<float>> factors(numericFeatureCount);
+            ResizeRank2(numericFeatureCount, objectCount, factors);
+
+            TVector<float> target(objectCount);
+
+            TFastRng<ui64> prng(seed);
+            FillWithRandom(factors, prng);
+            FillWithRandom(target, prng);
+
+            const TVector<TVector<float>> learnFactors = factors;
+
+            TDataProviders dataProviders;
+            dataProviders.Learn = CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.HasTarget = true;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        numericFeatureCount,
+                        TVector<ui32>{},
+                        TVector<TString>{},
+                        nullptr);
+
+                    visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+                    for (auto featureIdx : xrange(numericFeatureCount)) {
+                        visitor->AddFloatFeature(
+                            featureIdx,
+                            TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(factors[featureIdx]))
+                        );
+                    }
+                    visitor->AddTarget(target);
+
+                    visitor->Finish();
+                }
+            );
+            dataProviders.Test.push_back(dataProviders.Learn);
+
+            TFullModel model;
+            TEvalResult evalResult;
+            NJson::TJsonValue params;
+            params.InsertValue("iterations", 10);
+            params.InsertValue("random_seed", 1);
+            params.InsertValue("train_dir", trainDir.Name());
+            params.InsertValue("boosting_type", "Plain");
+            params.InsertValue("use_best_model", false);
+            params.InsertValue("growing_policy", growingPolicy);
+            params.InsertValue("depth", 4);
+            if (growingPolicy == "Lossguide") {
+                params.InsertValue("max_leaves_count", 8);
+            }
+            TrainModel(
+                params,
+                nullptr,
+                {},
+                {},
+                std::move(dataProviders),
+                "",
+                &model,
+                {&evalResult}
+            );
+
+            const auto& rawValues = evalResult.GetRawValuesConstRef()[0][0];
+            UNIT_ASSERT_VALUES_EQUAL(rawValues.size(), objectCount);
+            for (auto objectIdx : xrange(objectCount)) {
+                TVector<float> object(numericFeatureCount);
+                for (auto featureIdx : xrange(numericFeatureCount)) {
+                    object[featureIdx] = learnFactors[featureIdx][objectIdx];
+                }
+                double prediction[1];
+                model.Calc(object, {}, prediction);
+                UNIT_ASSERT_DOUBLES_EQUAL(prediction[0], rawValues[objectIdx], 1e-6);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TrainWithExclusiveFeaturesBundling) {
+        // Bundles of exclusive features give the same splits as separate features, so models must be
+        // the same up to floating point rounding of derived histograms.
+
+        const ui64 seed = 20191018;
+        const ui32 objectCount = 2000;
+        const ui32 numericFeatureCount = 24;
+
+        // one-hot like data: each object has a non-default value of exactly one feature
+        TVector<TVector<float>> factors(numericFeatureCount, TVector<float>(objectCount, 0.0f));
+        TVector<float> target(objectCount);
+        {
+            TFastRng<ui64> prng(seed);
+            for (auto objectIdx : xrange(objectCount)) {
+                const ui32 featureIdx = prng.Uniform(numericFeatureCount);
+                factors[featureIdx][objectIdx] = 1.0f + prng.GenRandReal1();
+                target[objectIdx] = (featureIdx % 3) * factors[featureIdx][objectIdx] + 0.1f * prng.GenRandReal1();
+            }
+        }
+
+        const auto makeDataProviders = [&] () {
+            TDataProviders dataProviders;
+            dataProviders.Learn = CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    TDataMetaInfo metaInfo;
+                    metaInfo.HasTarget = true;
+                    metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                        numericFeatureCount,
+                        TVector<ui32>{},
+                        TVector<TString>{},
+                        nullptr);
+
+                    visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+                    for (auto featureIdx : xrange(numericFeatureCount)) {
+                        visitor->AddFloatFeature(
+                            featureIdx,
+                            TMaybeOwningConstArrayHolder<float>::CreateOwning(TVector<float>(factors[featureIdx]))
+                        );
+                    }
+                    visitor->AddTarget(target);
+
+                    visitor->Finish();
+                }
+            );
+            dataProviders.Test.push_back(dataProviders.Learn);
+            return dataProviders;
+        };
+
+        TTempDir trainDir;
+        const auto makeParams = [&] (bool exclusiveFeaturesBundling) {
+            NJson::TJsonValue params;
+            params.InsertValue("iterations", 20);
+            params.InsertValue("random_seed", 1);
+            params.InsertValue("train_dir", trainDir.Name());
+            params.InsertValue("boosting_type", "Plain");
+            params.InsertValue("border_count", 31);
+            params.InsertValue("dev_exclusive_features_bundling", exclusiveFeaturesBundling);
+            return params;
+        };
+
+        // check that features are really bundled
+        {
+            NJson::TJsonValue trainOptionsJson;
+            NJson::TJsonValue outputOptionsJson;
+            NCatboostOptions::PlainJsonToOptions(makeParams(true), &trainOptionsJson, &outputOptionsJson);
+            NCatboostOptions::TCatBoostOptions catBoostOptions = NCatboostOptions::LoadOptions(trainOptionsJson);
+
+            NPar::TLocalExecutor localExecutor;
+            TLabelConverter labelConverter;
+            TRestorableFastRng64 rand(0);
+            const auto trainingData = GetTrainingData(
+                makeDataProviders(),
+                /*bordersFile*/ Nothing(),
+                /*ensureConsecutiveLearnFeaturesDataForCpu*/ true,
+                /*allowWriteFiles*/ false,
+                /*quantizedFeaturesInfo*/ nullptr,
+                &catBoostOptions,
+                &labelConverter,
+                &localExecutor,
+                &rand
+            ).Cast<TQuantizedForCPUObjectsDataProvider>();
+            UNIT_ASSERT(trainingData.Learn->ObjectsData->GetExclusiveFeatureBundlesSize() > 0);
+        }
+
+        TFullModel models[2];
+        TEvalResult evalResults[2];
+        for (auto exclusiveFeaturesBundling : {false, true}) {
+            TrainModel(
+                makeParams(exclusiveFeaturesBundling),
+                nullptr,
+                {},
+                {},
+                makeDataProviders(),
+                "",
+                &models[exclusiveFeaturesBundling],
+                {&evalResults[exclusiveFeaturesBundling]}
+            );
+        }
+
+        UNIT_ASSERT_EQUAL(models[0].ObliviousTrees.TreeSplits, models[1].ObliviousTrees.TreeSplits);
+        const auto& rawValues = evalResults[0].GetRawValuesConstRef()[0][0];
+        const auto& bundledRawValues = evalResults[1].GetRawValuesConstRef()[0][0];
+        UNIT_ASSERT_VALUES_EQUAL(rawValues.size(), bundledRawValues.size());
+        for (auto objectIdx : xrange(rawValues.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(rawValues[objectIdx], bundledRawValues[objectIdx], 1e-6);
+        }
+    }
 }
@@ -623,6 +623,32 @@ def test_pairwise_reproducibility(loss_function):
     assert filecmp.cmp(eval_1, eval_4)
 
 
+@pytest.mark.parametrize('thread_options', [['--work-stealing'], ['--thread-pinning'], ['--work-stealing', '--thread-pinning']],
+                         ids=['work_stealing', 'thread_pinning', 'work_stealing_and_thread_pinning'])
+def test_executor_scheduling_reproducibility(thread_options):
+
+    def run_catboost(extra_options, eval_path):
+        cmd = [
+            CATBOOST_PATH,
+            'fit',
+            '--use-best-model', 'false',
+            '--loss-function', 'Logloss',
+            '-f', data_file('adult', 'train_small'),
+            '-t', data_file('adult', 'test_small'),
+            '--column-description', data_file('adult', 'train.cd'),
+            '-i', '20',
+            '-T', '4',
+            '--eval-file', eval_path,
+        ] + extra_options
+        yatest.common.execute(cmd)
+
+    eval_default = yatest.common.test_output_path('test_default.eval')
+    run_catboost([], eval_default)
+    eval_scheduled = yatest.common.test_output_path('test_scheduled.eval')
+    run_catboost(thread_options, eval_scheduled)
+    assert filecmp.cmp(eval_default, eval_scheduled)
+
+
 @pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
@@ -3478,6 +3504,36 @@ def test_plain(boosting_type, dev_score_calc_obj_block_size):
     return [local_canonical_file(output_eval_path)]
 
 
+@pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
+def test_compact_score_cache(boosting_type):
+    def run_catboost(eval_path, other_options=()):
+        cmd = (
+            CATBOOST_PATH,
+            'fit',
+            '--use-best-model', 'false',
+            '--loss-function', 'Logloss',
+            '-f', data_file('adult', 'train_small'),
+            '-t', data_file('adult', 'test_small'),
+            '--column-description', data_file('adult', 'train.cd'),
+            '--boosting-type', boosting_type,
+            '-i', '20',
+            '-w', '0.03',
+            '-T', '4',
+            '--eval-file', eval_path,
+        ) + other_options
+        yatest.common.execute(cmd)
+
+    eval_path = yatest.common.test_output_path('test.eval')
+    run_catboost(eval_path)
+
+    compact_eval_path = yatest.common.test_output_path('test_compact.eval')
+    run_catboost(compact_eval_path, ('--dev-compact-score-cache',))
+
+    eval = np.loadtxt(eval_path, dtype='float', delimiter='\t', skiprows=1)
+    compact_eval = np.loadtxt(compact_eval_path, dtype='float', delimiter='\t', skiprows=1)
+    assert(np.allclose(eval, compact_eval, rtol=1e-3))
+
+
 @pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
@@ -3890,6 +3946,23 @@ def test_dist_train_multiclass_weight(dev_score_calc_obj_block_size):
         dev_score_calc_obj_block_size=dev_score_calc_obj_block_size)))]
 
 
+@pytest.mark.parametrize(
+    'dev_score_calc_obj_block_size',
+    SCORE_CALC_OBJ_BLOCK_SIZES,
+    ids=SCORE_CALC_OBJ_BLOCK_SIZES_IDS
+)
+def test_dist_train_with_cat_features(dev_score_calc_obj_block_size):
+    # categorical features with online ctrs and their combinations, compared with single host training
+    run_dist_train(make_deterministic_train_cmd(
+        loss_function='Logloss',
+        pool='adult',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        dev_score_calc_obj_block_size=dev_score_calc_obj_block_size,
+        other_options=('--random-seed', '0', '--one-hot-max-size', '2', '--max-ctr-complexity', '2')))
+
+
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
     SCORE_CALC_OBJ_BLOCK_SIZES,
@@ -5437,6 +5510,98 @@ def test_snapshot_with_different_params():
     assert False
 
 
+def test_snapshot_with_appended_learn_objects():
+    with open(data_file('adult', 'train_small')) as f:
+        learn_lines = f.readlines()
+    prefix_learn_path = yatest.common.test_output_path('prefix_train')
+    with open(prefix_learn_path, 'w') as f:
+        f.writelines(learn_lines[:len(learn_lines) // 2])
+    full_learn_path = yatest.common.test_output_path('full_train')
+    with open(full_learn_path, 'w') as f:
+        f.writelines(learn_lines)
+
+    cmd = [
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'Logloss',
+        '--boosting-type', 'Plain',
+        '--use-best-model', 'false',
+        '-t', data_file('adult', 'test_small'),
+        '--column-description', data_file('adult', 'train.cd'),
+        '-T', '4',
+    ]
+    # quantization of saved learn objects must not change when objects are appended
+    borders_path = yatest.common.test_output_path('borders.tsv')
+    yatest.common.execute(cmd + ['-f', full_learn_path, '-i', '1', '--output-borders-file', borders_path])
+    cmd += ['--input-borders-file', borders_path]
+
+    snapshot_path = yatest.common.test_output_path('snapshot.cbp')
+    prefix_model_path = yatest.common.test_output_path('prefix_model.bin')
+    yatest.common.execute(
+        cmd + ['-f', prefix_learn_path, '-i', '10', '-m', prefix_model_path, '--snapshot-file', snapshot_path]
+    )
+
+    model_path = yatest.common.test_output_path('model.bin')
+    fit_eval_path = yatest.common.test_output_path('fit_test.eval')
+    train_dir = yatest.common.test_output_path('train_dir')
+    log_path = yatest.common.test_output_path('fit.log')
+    with open(log_path, 'w') as log:
+        yatest.common.execute(
+            cmd + [
+                '-f', full_learn_path,
+                '-i', '20',
+                '-m', model_path,
+                '--eval-file', fit_eval_path,
+                '--snapshot-file', snapshot_path,
+                '--train-dir', train_dir,
+            ],
+            stdout=log
+        )
+    with open(log_path) as log:
+        assert 'learn objects were appended' in log.read()
+
+    def calc(model_path, eval_path, tree_count_limit=None):
+        calc_cmd = [
+            CATBOOST_PATH,
+            'calc',
+            '--input-path', data_file('adult', 'test_small'),
+            '--column-description', data_file('train_notarget.cd'),
+            '-m', model_path,
+            '--output-path', eval_path,
+        ]
+        if tree_count_limit is not None:
+            calc_cmd += ['--tree-count-limit', str(tree_count_limit)]
+        yatest.common.execute(calc_cmd)
+
+    # trees from snapshot are kept
+    prefix_calc_eval_path = yatest.common.test_output_path('prefix_calc_test.eval')
+    calc(prefix_model_path, prefix_calc_eval_path)
+    first_trees_calc_eval_path = yatest.common.test_output_path('first_trees_calc_test.eval')
+    calc(model_path, first_trees_calc_eval_path, tree_count_limit=10)
+    assert filecmp.cmp(prefix_calc_eval_path, first_trees_calc_eval_path)
+
+    # approxes restored from snapshot trees are the ones of the model applied to the data with appended objects
+    calc_eval_path = yatest.common.test_output_path('calc_test.eval')
+    calc(model_path, calc_eval_path)
+    assert compare_evals_with_precision(fit_eval_path, calc_eval_path, rtol=1e-6)
+
+    # the same for learn objects in folds built for the data with appended objects
+    learn_eval_metrics_path = yatest.common.test_output_path('learn_eval_metrics.tsv')
+    yatest.common.execute((
+        CATBOOST_PATH,
+        'eval-metrics',
+        '--metrics', 'Logloss',
+        '--input-path', full_learn_path,
+        '--column-description', data_file('adult', 'train.cd'),
+        '-m', model_path,
+        '-o', learn_eval_metrics_path,
+        '--eval-period', '1',
+    ))
+    fit_learn_metric = np.loadtxt(os.path.join(train_dir, 'learn_error.tsv'), skiprows=1)[-1, 1]
+    learn_metric = np.loadtxt(learn_eval_metrics_path, skiprows=1)[-1, 1]
+    assert np.isclose(fit_learn_metric, learn_metric, rtol=1e-6)
+
+
 @pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
 @pytest.mark.parametrize('leaf_estimation_method', LEAF_ESTIMATION_METHOD)
 @pytest.mark.parametrize(
@@ -6358,3 +6523,50 @@ def test_mvs_bootstrap_head_frac(boosting_type):
         assert (filecmp.cmp(ref_eval_path, eval_path) is False)
 
     return [local_canonical_file(ref_eval_path)]
+
+
+def test_trace_file():
+    def fit(train_dir, allow_writing_files):
+        cmd = [
+            CATBOOST_PATH,
+            'fit',
+            '--use-best-model', 'false',
+            '--allow-writing-files', allow_writing_files,
+            '--loss-function', 'Logloss',
+            '--boosting-type', 'Plain',
+            '-f', data_file('adult', 'train_small'),
+            '-t', data_file('adult', 'test_small'),
+            '--column-description', data_file('adult', 'train.cd'),
+            '-i', '10',
+            '-w', '0.03',
+            '-T', '4',
+            '-m', yatest.common.test_output_path('model.bin'),
+            '--train-dir', train_dir,
+            '--trace-file', 'trace.json',
+        ]
+        yatest.common.execute(cmd)
+
+    train_dir = yatest.common.test_output_path('train_dir')
+    fit(train_dir, 'true')
+
+    with open(os.path.join(train_dir, 'trace.json')) as trace_file:
+        events = json.load(trace_file)
+
+    span_names = set(event['name'] for event in events if event['ph'] == 'X')
+    for span_name in (
+        'Load pools',
+        'Quantize',
+        'Build plain fold',
+        'Compute online CTRs',
+        'Calc derivatives',
+        'Calc stats and scores',
+        'Calc leaf values',
+        'Eval metric block',
+        'Iteration',
+    ):
+        assert span_name in span_names
+    assert len(set(event['tid'] for event in events if event['ph'] == 'X')) > 1
+
+    no_writing_train_dir = yatest.common.test_output_path('no_writing_train_dir')
+    fit(no_writing_train_dir, 'false')
+    assert not os.path.exists(no_writing_train_dir)
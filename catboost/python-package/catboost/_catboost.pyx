@@ -687,6 +687,26 @@ cdef extern from "catboost/libs/algo/apply.h":
         int threadCount
     ) nogil except +ProcessException
 
+    cdef TVector[TVector[double]] ApplyModelMultiOnFeatureRows(
+        const TFullModel& model,
+        TConstArrayRef[TConstArrayRef[float]] floatFeatures,
+        TConstArrayRef[TConstArrayRef[int]] catFeatures,
+        const EPredictionType predictionType,
+        int begin,
+        int end,
+        int threadCount
+    ) nogil except +ProcessException
+
+    cdef TVector[TVector[double]] ApplyModelMultiOnFeatureRows(
+        const TFullModel& model,
+        TConstArrayRef[TConstArrayRef[float]] floatFeatures,
+        TConstArrayRef[TVector[TStringBuf]] catFeatures,
+        const EPredictionType predictionType,
+        int begin,
+        int end,
+        int threadCount
+    ) nogil except +ProcessException
+
 cdef extern from "catboost/libs/algo/helpers.h":
     cdef void ConfigureMalloc() nogil except *
 
@@ -2452,6 +2472,97 @@ cdef class _CatBoost:
             )
         return _convert_to_visible_labels(predictionType, pred, thread_count, self.__model)
 
+    cpdef _base_predict_on_arrays(self, float_features, cat_features, str prediction_type, int ntree_start,
+                                  int ntree_end, int thread_count, bool_t multi):
+        """
+        Predict on feature matrices without creating a pool.
+        float_features rows are used without copying if array is C-contiguous float32.
+        cat_features are either hashes (integer array) or strings, None if model has no categorical features.
+        Returns the same as _base_predict_multi if multi is True and the same as _base_predict otherwise.
+        """
+        cdef EPredictionType predictionType = PyPredictionType(prediction_type).predictionType
+        thread_count = UpdateThreadCount(thread_count)
+
+        float_features = np.ascontiguousarray(float_features, dtype=np.float32)
+        if float_features.ndim == 1:
+            float_features = float_features.reshape(1, -1)
+        if float_features.ndim != 2:
+            raise CatBoostError('float_features must be 1 or 2 dimensional array')
+        cdef const np.float32_t[:, ::1] float_values = float_features
+        cdef size_t doc_count = float_values.shape[0]
+        cdef size_t float_feature_count = float_values.shape[1]
+
+        cdef TVector[TConstArrayRef[float]] float_rows
+        cdef TVector[TConstArrayRef[int]] cat_hash_rows
+        cdef TVector[TString] cat_strings
+        cdef TVector[TVector[TStringBuf]] cat_string_rows
+        cdef const np.int32_t[:, ::1] cat_hashes
+        cdef size_t cat_feature_count = 0
+        cdef size_t doc_idx
+        cdef size_t feature_idx
+        cdef bool_t is_hashed_cat_features = True
+
+        float_rows.reserve(doc_count)
+        for doc_idx in range(doc_count):
+            float_rows.push_back(
+                TConstArrayRef[float](&float_values[doc_idx, 0], float_feature_count)
+                if float_feature_count > 0
+                else TConstArrayRef[float]()
+            )
+
+        if cat_features is not None:
+            cat_features = np.asarray(cat_features)
+            if cat_features.ndim == 1:
+                cat_features = cat_features.reshape(1, -1)
+            if cat_features.ndim != 2 or <size_t>cat_features.shape[0] != doc_count:
+                raise CatBoostError('cat_features must be 2 dimensional array with the same number of rows as float_features')
+            cat_feature_count = cat_features.shape[1]
+            is_hashed_cat_features = cat_features.dtype.kind in 'iu'
+            if is_hashed_cat_features:
+                cat_features = np.ascontiguousarray(cat_features.astype(np.uint32, copy=False)).view(np.int32)
+                cat_hashes = cat_features
+                cat_hash_rows.reserve(doc_count)
+                for doc_idx in range(doc_count):
+                    cat_hash_rows.push_back(
+                        TConstArrayRef[int](&cat_hashes[doc_idx, 0], cat_feature_count)
+                        if cat_feature_count > 0
+                        else TConstArrayRef[int]()
+                    )
+            else:
+                cat_strings.reserve(doc_count * cat_feature_count)
+                cat_string_rows.resize(doc_count)
+                for doc_idx in range(doc_count):
+                    cat_string_rows[doc_idx].reserve(cat_feature_count)
+                    for feature_idx in range(cat_feature_count):
+                        cat_strings.push_back(to_arcadia_string(cat_features[doc_idx, feature_idx]))
+                        cat_string_rows[doc_idx].push_back(TStringBuf(cat_strings.back().data(), cat_strings.back().size()))
+
+        cdef TVector[TVector[double]] pred
+        with nogil:
+            if is_hashed_cat_features:
+                pred = ApplyModelMultiOnFeatureRows(
+                    dereference(self.__model),
+                    TConstArrayRef[TConstArrayRef[float]](float_rows.data(), float_rows.size()),
+                    TConstArrayRef[TConstArrayRef[int]](cat_hash_rows.data(), cat_hash_rows.size()),
+                    predictionType,
+                    ntree_start,
+                    ntree_end,
+                    thread_count
+                )
+            else:
+                pred = ApplyModelMultiOnFeatureRows(
+                    dereference(self.__model),
+                    TConstArrayRef[TConstArrayRef[float]](float_rows.data(), float_rows.size()),
+                    TConstArrayRef[TVector[TStringBuf]](cat_string_rows.data(), cat_string_rows.size()),
+                    predictionType,
+                    ntree_start,
+                    ntree_end,
+                    thread_count
+                )
+        if multi:
+            return _convert_to_visible_labels(predictionType, pred, thread_count, self.__model)
+        return _vector_of_double_to_np_array(pred[0])
+
     cpdef _staged_predict_iterator(self, _PoolBase pool, str prediction_type, int ntree_start, int ntree_end, int eval_period, int thread_count, verbose):
         thread_count = UpdateThreadCount(thread_count);
         stagedPredictIterator = _StagedPredictIterator(prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
@@ -3067,6 +3178,11 @@ cpdef is_regression_objective(loss_name):
     return IsRegressionObjective(to_arcadia_string(loss_name))
 
 
+cpdef _calc_cat_feature_hash(value):
+    cdef TString value_str = to_arcadia_string(value)
+    return CalcCatFeatureHash(TStringBuf(value_str.data(), value_str.size()))
+
+
 cpdef _check_train_params(dict params):
     params_to_check = params.copy()
     if 'cat_features' in params_to_check:
@@ -775,6 +775,9 @@ def _process_synonyms(params):
     if 'used_ram_limit' in params:
         params['used_ram_limit'] = str(params['used_ram_limit'])
 
+    if 'online_ctr_cache_size' in params:
+        params['online_ctr_cache_size'] = str(params['online_ctr_cache_size'])
+
 
 def _get_loss_function(params):
     if params is None:
@@ -911,6 +914,9 @@ class _CatBoostBase(object):
     def _base_predict_multi(self, pool, prediction_type, ntree_start, ntree_end, thread_count, verbose):
         return self._object._base_predict_multi(pool, prediction_type, ntree_start, ntree_end, thread_count, verbose)
 
+    def _base_predict_on_arrays(self, float_features, cat_features, prediction_type, ntree_start, ntree_end, thread_count, multi):
+        return self._object._base_predict_on_arrays(float_features, cat_features, prediction_type, ntree_start, ntree_end, thread_count, multi)
+
     def _staged_predict_iterator(self, pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose):
         return self._object._staged_predict_iterator(pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
 
@@ -1294,17 +1300,12 @@ class CatBoost(_CatBoostBase):
                          column_description, verbose_eval, metric_period, silent, early_stopping_rounds,
                          save_snapshot, snapshot_file, snapshot_interval)
 
-    def _predict(self, data, prediction_type, ntree_start, ntree_end, thread_count, verbose):
+    def _predict(self, data, prediction_type, ntree_start, ntree_end, thread_count, verbose, cat_data=None, on_arrays=False):
         verbose = verbose or self.get_param('verbose')
         if verbose is None:
             verbose = False
         if not self.is_fitted():
             raise CatBoostError("There is no trained model to use predict(). Use fit() to train model. Then use predict().")
-        if not isinstance(data, Pool):
-            data = Pool(
-                data=data,
-                cat_features=self._get_cat_feature_indices() if not isinstance(data, FeaturesData) else None
-            )
         if not isinstance(prediction_type, STRING_TYPES):
             raise CatBoostError("Invalid prediction_type type={}: must be str().".format(type(prediction_type)))
         if prediction_type not in ('Class', 'RawFormulaVal', 'Probability'):
@@ -1313,9 +1314,28 @@ class CatBoost(_CatBoostBase):
         loss_function_type = _get_loss_function(self._get_params())
 
         # TODO(kirillovs): very bad solution. user should be able to use custom multiclass losses
-        if loss_function_type is not None and (loss_function_type == 'MultiClass' or loss_function_type == 'MultiClassOneVsAll'):
-            return np.transpose(self._base_predict_multi(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
-        predictions = np.array(self._base_predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
+        is_multi = loss_function_type is not None and (loss_function_type == 'MultiClass' or loss_function_type == 'MultiClassOneVsAll')
+
+        # float matrices of models without categorical features are applied without creating a Pool
+        if on_arrays or (
+            isinstance(data, np.ndarray) and data.ndim == 2 and data.dtype in (np.float32, np.float64)
+            and len(self._get_cat_feature_indices()) == 0
+        ):
+            predictions = self._base_predict_on_arrays(data, cat_data, prediction_type, ntree_start, ntree_end, thread_count, is_multi)
+        else:
+            if not isinstance(data, Pool):
+                data = Pool(
+                    data=data,
+                    cat_features=self._get_cat_feature_indices() if not isinstance(data, FeaturesData) else None
+                )
+            if is_multi:
+                predictions = self._base_predict_multi(data, prediction_type, ntree_start, ntree_end, thread_count, verbose)
+            else:
+                predictions = self._base_predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose)
+
+        if is_multi:
+            return np.transpose(predictions)
+        predictions = np.array(predictions)
         if prediction_type == 'Probability':
             predictions = np.transpose([1 - predictions, predictions])
         return predictions
@@ -1357,6 +1377,49 @@ class CatBoost(_CatBoostBase):
         """
         return self._predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose)
 
+    def predict_on_arrays(self, float_features, cat_features=None, prediction_type='RawFormulaVal', ntree_start=0,
+                          ntree_end=0, thread_count=-1):
+        """
+        Predict on feature arrays without creating a Pool.
+        Intended for low latency prediction of small batches. C-contiguous float32 arrays are used without copying
+        and the GIL is released during model evaluation.
+
+        Parameters
+        ----------
+        float_features : numpy.array of shape (object_count, float_feature_count) or (float_feature_count,)
+            Values of float features in the order of model float features.
+            If model has no categorical features these are just all features.
+
+        cat_features : numpy.array of shape (object_count, cat_feature_count), optional (default=None)
+            Values of categorical features in the order of model categorical features.
+            Integer values are treated as hashes of categorical features values, other values are converted to strings.
+            Can be None if model has no categorical features.
+
+        prediction_type : string, optional (default='RawFormulaVal')
+            Can be:
+            - 'RawFormulaVal' : return raw value.
+            - 'Class' : return majority vote class.
+            - 'Probability' : return probability for every class.
+
+        ntree_start: int, optional (default=0)
+            Model is applyed on the interval [ntree_start, ntree_end) (zero-based indexing).
+
+        ntree_end: int, optional (default=0)
+            Model is applyed on the interval [ntree_start, ntree_end) (zero-based indexing).
+            If value equals to 0 this parameter is ignored and ntree_end equal to tree_count_.
+
+        thread_count : int (default=-1)
+            The number of threads to use when applying the model.
+            Threads are used only for big enough batches. This parameter doesn't affect results.
+            If -1, then the number of threads is set to the number of cores.
+
+        Returns
+        -------
+        prediction : numpy.array
+        """
+        return self._predict(float_features, prediction_type, ntree_start, ntree_end, thread_count, False,
+                             cat_data=cat_features, on_arrays=True)
+
     def _staged_predict(self, data, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose):
         verbose = verbose or self.get_param('verbose')
         if verbose is None:
@@ -1766,6 +1829,9 @@ class CatBoost(_CatBoostBase):
                 * coreml_model_version : string
                 * coreml_model_author : string
                 * coreml_model_license: string
+            Parameters for C++ export:
+                * cpp_fixed_tree_depth : bool - generate code specialized for the depth of trees,
+                    all trees must have the same depth, not supported for models with categorical features
         pool : catboost.Pool or list or numpy.array or pandas.DataFrame or pandas.Series or catboost.FeaturesData
             Training pool.
         """
@@ -2001,6 +2067,14 @@ class CatBoostClassifier(CatBoost):
         the Categ features to Num and the choice of a tree structure).
     allow_const_label : bool, [default=False]
         To allow the constant label value in dataset.
+    dev_exclusive_features_bundling : bool, [default=False]
+        CPU only. Store sparse float features that never have non-default values
+        for the same object together and select splits for them at once.
+        Speeds up training on wide sparse datasets.
+    dev_border_selection_sketch_size : int, [default=0]
+        Build borders for Median and GreedyLogSum border types from mergeable quantile
+        sketches of this size over all objects instead of sorting all feature values.
+        Bounds memory used for border selection on large datasets. 0 - disabled.
     classes_count : int, [default=None]
         The upper limit for the numeric class label.
         Defines the number of classes for multiclassification.
@@ -2050,6 +2124,20 @@ class CatBoostClassifier(CatBoost):
     used_ram_limit : string or number, [default=None]
         Set a limit on memory consumption (value like '1.2gb' or 1.2e9).
         WARNING: Currently this option affects CTR memory usage only.
+    online_ctr_cache_size : string or number, [default=None]
+        CPU only. Memory budget for online CTRs cached between iterations (value like '1.2gb' or 1.2e9).
+        When it is exceeded, the least recently (or frequently) used CTRs are evicted.
+    online_ctr_cache_policy : string, [default='LRU']
+        CPU only. Online CTR cache eviction policy, possible values:
+            - 'LRU'
+            - 'LFU'
+    online_ctr_cache_spill_dir : string, [default=None]
+        CPU only. Directory to spill evicted online CTRs to instead of dropping them.
+        Spilled CTRs are read back on the next use instead of being recalculated.
+    work_stealing : bool, [default=False]
+        CPU only. Split parallel loops into per-thread parts, idle threads steal work from other threads' parts.
+    thread_pinning : bool, [default=False]
+        CPU only. Pin worker threads to CPUs, socket by socket (Linux only).
     gpu_ram_part : float, [default=0.95]
         Fraction of the GPU RAM to use for training, a value from (0, 1].
     pinned_memory_size: int [default=None]
@@ -2059,6 +2147,10 @@ class CatBoostClassifier(CatBoost):
         If this flag is set to False, no files with different diagnostic info will be created during training.
         With this flag no snapshotting can be done. Plus visualisation will not
         work, because visualisation uses files that are created and updated during training.
+    trace_file : string, [default=None]
+        CPU only. File to write a timeline of data loading, quantization and training stages
+        in Chrome trace format (can be opened in about:tracing or Perfetto).
+        Relative paths are relative to train_dir. Ignored if allow_writing_files is False.
     final_ctr_computation_mode : string, [default='Default']
         Possible values:
             - 'Default' - Compute final ctrs for all pools.
@@ -2100,6 +2192,11 @@ class CatBoostClassifier(CatBoost):
         Used only for learning speed tuning.
         Changing this parameter can affect results due to numerical accuracy differences
 
+    dev_compact_score_cache : bool, [default=False]
+        CPU only. Store score statistics cached between tree levels in single precision
+        to halve memory usage and bandwidth.
+        Changing this parameter can affect results due to numerical accuracy differences
+
     max_depth : int, Synonym for depth.
 
     n_estimators : int, synonym for iterations.
@@ -2172,6 +2269,8 @@ class CatBoostClassifier(CatBoost):
         max_ctr_complexity=None,
         has_time=None,
         allow_const_label=None,
+        dev_exclusive_features_bundling=None,
+        dev_border_selection_sketch_size=None,
         classes_count=None,
         class_weights=None,
         class_names=None,
@@ -2189,9 +2288,15 @@ class CatBoostClassifier(CatBoost):
         snapshot_interval=None,
         fold_len_multiplier=None,
         used_ram_limit=None,
+        online_ctr_cache_size=None,
+        online_ctr_cache_policy=None,
+        online_ctr_cache_spill_dir=None,
+        work_stealing=None,
+        thread_pinning=None,
         gpu_ram_part=None,
         pinned_memory_size=None,
         allow_writing_files=None,
+        trace_file=None,
         final_ctr_computation_mode=None,
         approx_on_full_history=None,
         boosting_type=None,
@@ -2207,6 +2312,7 @@ class CatBoostClassifier(CatBoost):
         subsample=None,
         sampling_unit=None,
         dev_score_calc_obj_block_size=None,
+        dev_compact_score_cache=None,
         max_depth=None,
         n_estimators=None,
         num_boost_round=None,
@@ -2553,6 +2659,8 @@ class CatBoostRegressor(CatBoost):
         max_ctr_complexity=None,
         has_time=None,
         allow_const_label=None,
+        dev_exclusive_features_bundling=None,
+        dev_border_selection_sketch_size=None,
         one_hot_max_size=None,
         random_strength=None,
         name=None,
@@ -2566,9 +2674,15 @@ class CatBoostRegressor(CatBoost):
         snapshot_interval=None,
         fold_len_multiplier=None,
         used_ram_limit=None,
+        online_ctr_cache_size=None,
+        online_ctr_cache_policy=None,
+        online_ctr_cache_spill_dir=None,
+        work_stealing=None,
+        thread_pinning=None,
         gpu_ram_part=None,
         pinned_memory_size=None,
         allow_writing_files=None,
+        trace_file=None,
         final_ctr_computation_mode=None,
         approx_on_full_history=None,
         boosting_type=None,
@@ -2584,6 +2698,7 @@ class CatBoostRegressor(CatBoost):
         subsample=None,
         sampling_unit=None,
         dev_score_calc_obj_block_size=None,
+        dev_compact_score_cache=None,
         max_depth=None,
         n_estimators=None,
         num_boost_round=None,
@@ -106,6 +106,23 @@ def reset_trace_backend(filename):
     get_catboost_bin_module()._reset_trace_backend(filename)
 
 
+def calc_cat_feature_hash(value):
+    """
+    Calculate hash of categorical feature value as used by the model.
+    Hashes can be passed as cat_features to CatBoost.predict_on_arrays instead of strings.
+
+    Parameters
+    ----------
+    value : string or number
+        Categorical feature value. Numbers are converted to strings.
+
+    Returns
+    -------
+    hash : int
+    """
+    return get_catboost_bin_module()._calc_cat_feature_hash(value)
+
+
 def get_roc_curve(model, data, thread_count=-1):
     """
     Build points of ROC curve.
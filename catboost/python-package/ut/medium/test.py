@@ -20,7 +20,7 @@ from catboost import (
     sum_models,
     train,)
 from catboost.eval.catboost_evaluation import CatboostEvaluation
-from catboost.utils import eval_metric, create_cd, get_roc_curve, select_threshold
+from catboost.utils import eval_metric, create_cd, get_roc_curve, select_threshold, calc_cat_feature_hash
 import os.path
 from pandas import read_table, DataFrame, Series, Categorical
 from six import PY3
@@ -654,6 +654,38 @@ def test_raw_predict_equals_to_model_predict(task_type):
     assert np.all(np.isclose(model.get_test_eval(), pred, rtol=1.e-6))
 
 
+def test_predict_on_arrays_equals_to_predict_on_pool():
+    prng = np.random.RandomState(seed=20181219)
+    float_features = prng.rand(200, 5)
+    cat_features = prng.choice(['a', 'b', 'c'], size=(200, 2))
+    label = (float_features[:, 0] + (cat_features[:, 0] == 'a') > 1).astype(int)
+
+    float_model = CatBoostClassifier(iterations=10, thread_count=2)
+    float_model.fit(float_features, label)
+    pool = Pool(float_features)
+    for prediction_type in ('RawFormulaVal', 'Probability', 'Class'):
+        expected = float_model.predict(pool, prediction_type=prediction_type)
+        assert np.allclose(float_model.predict(float_features, prediction_type=prediction_type), expected)
+        assert np.allclose(float_model.predict(float_features.astype(np.float32), prediction_type=prediction_type), expected)
+        assert np.allclose(float_model.predict_on_arrays(float_features, prediction_type=prediction_type), expected)
+    assert np.allclose(float_model.predict_on_arrays(float_features[0]), float_model.predict(pool)[:1])
+
+    data = np.concatenate([float_features.astype(object), cat_features], axis=1)
+    cat_model = CatBoostClassifier(iterations=10, one_hot_max_size=1, thread_count=2)
+    cat_model.fit(data, label, cat_features=[5, 6])
+    expected = cat_model.predict(Pool(data, cat_features=[5, 6]), prediction_type='RawFormulaVal')
+    assert np.allclose(cat_model.predict_on_arrays(float_features, cat_features), expected)
+    cat_hashes = np.array([[calc_cat_feature_hash(value) for value in row] for row in cat_features], dtype=np.uint32)
+    assert np.allclose(cat_model.predict_on_arrays(float_features, cat_hashes), expected)
+
+    multi_label = (float_features[:, 0] * 3).astype(int)
+    multi_model = CatBoostClassifier(iterations=10, loss_function='MultiClass', thread_count=2)
+    multi_model.fit(float_features, multi_label)
+    for prediction_type in ('RawFormulaVal', 'Probability'):
+        expected = multi_model.predict(pool, prediction_type=prediction_type)
+        assert np.allclose(multi_model.predict_on_arrays(float_features, prediction_type=prediction_type), expected)
+
+
 def test_model_pickling(task_type):
     train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     test_pool = Pool(TEST_FILE, column_description=CD_FILE)
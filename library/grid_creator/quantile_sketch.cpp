@@ -0,0 +1,172 @@
+#include "quantile_sketch.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/generic/yexception.h>
+#include <util/generic/ymath.h>
+
+#include <cmath>
+#include <utility>
+
+using NSplitSelection::TQuantileSketch;
+
+static constexpr size_t MIN_LEVEL_CAPACITY = 2;
+static constexpr double LEVEL_CAPACITY_DECAY = 2.0 / 3.0;
+
+// enough for any ui64 count of added values
+static constexpr size_t MAX_LEVELS_COUNT = 64;
+
+TQuantileSketch::TQuantileSketch(ui32 k)
+    : K(k)
+    , Levels(1)
+    , CompactionOffsets(1, 0)
+{
+    Y_ENSURE(K >= MIN_LEVEL_CAPACITY, "Quantile sketch K (" << K << ") must be >= " << MIN_LEVEL_CAPACITY);
+    UpdateCapacity();
+}
+
+void TQuantileSketch::Add(float value) {
+    Y_ASSERT(!std::isnan(value));
+    if (Count) {
+        MinValue = Min(MinValue, value);
+        MaxValue = Max(MaxValue, value);
+    } else {
+        MinValue = value;
+        MaxValue = value;
+    }
+    ++Count;
+    Levels[0].push_back(value);
+    ++StoredValuesCount;
+    CompressIfNeeded();
+}
+
+void TQuantileSketch::Merge(const TQuantileSketch& rhs) {
+    Y_ENSURE(K == rhs.K, "Quantile sketches with different K (" << K << " and " << rhs.K << ") can't be merged");
+    if (!rhs.Count) {
+        return;
+    }
+    if (Count) {
+        MinValue = Min(MinValue, rhs.MinValue);
+        MaxValue = Max(MaxValue, rhs.MaxValue);
+    } else {
+        MinValue = rhs.MinValue;
+        MaxValue = rhs.MaxValue;
+    }
+    Count += rhs.Count;
+
+    if (rhs.Levels.size() > Levels.size()) {
+        Levels.resize(rhs.Levels.size());
+        CompactionOffsets.resize(rhs.Levels.size(), 0);
+        UpdateCapacity();
+    }
+    for (auto level : xrange(rhs.Levels.size())) {
+        Levels[level].insert(Levels[level].end(), rhs.Levels[level].begin(), rhs.Levels[level].end());
+        StoredValuesCount += rhs.Levels[level].size();
+    }
+    CompressIfNeeded();
+}
+
+TVector<float> TQuantileSketch::GetSortedSample() const {
+    TVector<std::pair<float, ui64>> weightedValues;
+    weightedValues.reserve(StoredValuesCount);
+    for (auto level : xrange(Levels.size())) {
+        for (auto value : Levels[level]) {
+            weightedValues.emplace_back(value, ui64(1) << level);
+        }
+    }
+    Sort(weightedValues.begin(), weightedValues.end());
+
+    const size_t sampleSize = weightedValues.size();
+
+    // i-th sample value is the value with rank (i + 1/2) * Count / sampleSize
+    TVector<float> sample;
+    sample.yresize(sampleSize);
+    size_t weightedIdx = 0;
+    ui64 rankBegin = 0;
+    for (auto i : xrange(sampleSize)) {
+        const ui64 rank = ((2 * ui64(i) + 1) * Count) / (2 * sampleSize);
+        while (rankBegin + weightedValues[weightedIdx].second <= rank) {
+            rankBegin += weightedValues[weightedIdx].second;
+            ++weightedIdx;
+        }
+        sample[i] = weightedValues[weightedIdx].first;
+    }
+    if (sampleSize) {
+        sample.front() = MinValue;
+        sample.back() = MaxValue;
+    }
+    return sample;
+}
+
+int TQuantileSketch::operator&(IBinSaver& binSaver) {
+    binSaver.AddMulti(K, Count, MinValue, MaxValue, Levels, CompactionOffsets);
+    if (binSaver.IsReading()) {
+        StoredValuesCount = 0;
+        for (const auto& levelValues : Levels) {
+            StoredValuesCount += levelValues.size();
+        }
+        UpdateCapacity();
+    }
+    return 0;
+}
+
+size_t TQuantileSketch::CalcMaxStoredValuesCount(ui32 k) {
+    // sum of k * LEVEL_CAPACITY_DECAY^depth is < 3 * k, each level capacity is rounded up by < MIN_LEVEL_CAPACITY
+    return 3 * size_t(k) + MIN_LEVEL_CAPACITY * MAX_LEVELS_COUNT;
+}
+
+size_t TQuantileSketch::CalcMaxMemoryUsage(ui32 k) {
+    const size_t maxStoredValuesCount = CalcMaxStoredValuesCount(k);
+
+    // Merge might temporarily double stored values, GetSortedSample needs weighted values and the result
+    return 2 * maxStoredValuesCount * sizeof(float)
+        + maxStoredValuesCount * (sizeof(std::pair<float, ui64>) + sizeof(float))
+        + MAX_LEVELS_COUNT * (sizeof(TVector<float>) + sizeof(ui8));
+}
+
+size_t TQuantileSketch::GetLevelCapacity(size_t level) const {
+    const size_t depth = Levels.size() - 1 - level;
+    return Max(MIN_LEVEL_CAPACITY, (size_t)std::ceil(K * std::pow(LEVEL_CAPACITY_DECAY, depth)));
+}
+
+void TQuantileSketch::UpdateCapacity() {
+    Capacity = 0;
+    for (auto level : xrange(Levels.size())) {
+        Capacity += GetLevelCapacity(level);
+    }
+}
+
+void TQuantileSketch::CompactLevel(size_t level) {
+    if (level + 1 == Levels.size()) {
+        Y_ENSURE(Levels.size() < MAX_LEVELS_COUNT, "Too many levels in quantile sketch");
+        Levels.emplace_back();
+        CompactionOffsets.push_back(0);
+        UpdateCapacity();
+    }
+
+    auto& values = Levels[level];
+    auto& nextLevelValues = Levels[level + 1];
+    Sort(values.begin(), values.end());
+
+    // if values count is odd the smallest value stays at this level
+    const size_t compactedBegin = values.size() % 2;
+    for (size_t i = compactedBegin + CompactionOffsets[level]; i < values.size(); i += 2) {
+        nextLevelValues.push_back(values[i]);
+    }
+    StoredValuesCount -= (values.size() - compactedBegin) / 2;
+    values.resize(compactedBegin);
+    CompactionOffsets[level] ^= 1;
+}
+
+void TQuantileSketch::CompressIfNeeded() {
+    while (StoredValuesCount > Capacity) {
+        // there's always a level that is not smaller than its capacity here
+        for (auto level : xrange(Levels.size())) {
+            if (Levels[level].size() >= GetLevelCapacity(level)) {
+                CompactLevel(level);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <library/binsaver/bin_saver.h>
+
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NSplitSelection {
+    /* Mergeable streaming quantile sketch (KLL-style compactor hierarchy).
+     *
+     * Values are added one by one to level 0, when the sketch is full some level is sorted and every second
+     * value of it is moved to the next level where each value represents twice as many source values.
+     * Level capacities decrease geometrically from the top level (with capacity K) down, so the sketch stores
+     * O(K) values and the rank error is O(1/K) of the total count independent of the number of added values.
+     *
+     * Sketches built over disjoint parts of data can be merged (e.g. per data block in parallel or
+     * from different hosts), the result does not depend on the thread count if parts and merge order are fixed.
+     * Compaction offsets alternate deterministically, so the sketch is reproducible for the same input.
+     */
+    class TQuantileSketch {
+    public:
+        static constexpr ui32 DefaultK = 2048;
+
+    public:
+        explicit TQuantileSketch(ui32 k = DefaultK);
+
+        // values must not be nans
+        void Add(float value);
+
+        // rhs must have the same K
+        void Merge(const TQuantileSketch& rhs);
+
+        // number of added values
+        ui64 GetCount() const {
+            return Count;
+        }
+
+        size_t GetStoredValuesCount() const {
+            return StoredValuesCount;
+        }
+
+        /* Sorted values with equal weights that approximate the distribution of added values.
+         * Contains exactly the added values if no compaction has happened, the min and max added values
+         * are always preserved. Size is GetStoredValuesCount().
+         */
+        TVector<float> GetSortedSample() const;
+
+        int operator&(IBinSaver& binSaver);
+
+        // upper bound for GetStoredValuesCount() for the sketch with parameter k
+        static size_t CalcMaxStoredValuesCount(ui32 k);
+
+        // upper bound for memory used by the sketch with parameter k including Merge and GetSortedSample
+        static size_t CalcMaxMemoryUsage(ui32 k);
+
+    private:
+        size_t GetLevelCapacity(size_t level) const;
+        void UpdateCapacity();
+        void CompactLevel(size_t level);
+        void CompressIfNeeded();
+
+    private:
+        ui32 K;
+        ui64 Count = 0;
+        float MinValue = 0.0f;
+        float MaxValue = 0.0f;
+
+        // values at level h represent 2^h source values each
+        TVector<TVector<float>> Levels;
+
+        // offset of values to keep at the next compaction of the level (alternates)
+        TVector<ui8> CompactionOffsets;
+
+        // derived from the data above
+        size_t StoredValuesCount = 0;
+        size_t Capacity = 0;
+    };
+}
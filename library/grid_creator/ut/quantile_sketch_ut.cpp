@@ -0,0 +1,130 @@
+#include <library/unittest/registar.h>
+
+#include <library/binsaver/mem_io.h>
+#include <library/grid_creator/quantile_sketch.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <cmath>
+
+using NSplitSelection::TQuantileSketch;
+
+static TVector<float> GenerateValues(size_t count, ui64 seed) {
+    TFastRng64 rng(seed);
+    TVector<float> values;
+    values.reserve(count);
+    for (auto i : xrange(count)) {
+        Y_UNUSED(i);
+        // many duplicates and a long tail
+        values.push_back(rng.GenRandReal1() < 0.3 ? 1.0f : float(exp(3 * rng.GenRandReal1())));
+    }
+    return values;
+}
+
+// max difference between the expected rank of each sample value and its actual rank in sortedValues
+static double CalcMaxRankError(const TVector<float>& sample, const TVector<float>& sortedValues) {
+    double maxError = 0.0;
+    for (auto i : xrange(sample.size())) {
+        const double expectedRank = (i + 0.5) / sample.size();
+        const double rankBegin = double(LowerBound(sortedValues.begin(), sortedValues.end(), sample[i]) - sortedValues.begin());
+        const double rankEnd = double(UpperBound(sortedValues.begin(), sortedValues.end(), sample[i]) - sortedValues.begin());
+        const double error = Max(
+            0.0,
+            Max(rankBegin / sortedValues.size() - expectedRank, expectedRank - rankEnd / sortedValues.size())
+        );
+        maxError = Max(maxError, error);
+    }
+    return maxError;
+}
+
+Y_UNIT_TEST_SUITE(QuantileSketchTests) {
+    Y_UNIT_TEST(TestExactWithoutCompaction) {
+        TQuantileSketch sketch(64);
+        const TVector<float> values = {3.0f, -1.0f, 2.0f, 2.0f, 0.5f};
+        for (auto value : values) {
+            sketch.Add(value);
+        }
+
+        TVector<float> expectedSample = values;
+        Sort(expectedSample);
+
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), values.size());
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetSortedSample(), expectedSample);
+    }
+
+    Y_UNIT_TEST(TestEmpty) {
+        TQuantileSketch sketch;
+        sketch.Merge(TQuantileSketch());
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), 0);
+        UNIT_ASSERT(sketch.GetSortedSample().empty());
+    }
+
+    Y_UNIT_TEST(TestAccuracy) {
+        const ui32 k = 256;
+        TVector<float> values = GenerateValues(1000000, 0);
+
+        TQuantileSketch sketch(k);
+        for (auto value : values) {
+            sketch.Add(value);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), values.size());
+        UNIT_ASSERT(sketch.GetStoredValuesCount() <= TQuantileSketch::CalcMaxStoredValuesCount(k));
+
+        const TVector<float> sample = sketch.GetSortedSample();
+        UNIT_ASSERT_VALUES_EQUAL(sample.size(), sketch.GetStoredValuesCount());
+        UNIT_ASSERT(IsSorted(sample.begin(), sample.end()));
+
+        Sort(values);
+        UNIT_ASSERT_VALUES_EQUAL(sample.front(), values.front());
+        UNIT_ASSERT_VALUES_EQUAL(sample.back(), values.back());
+        UNIT_ASSERT(CalcMaxRankError(sample, values) < 0.02);
+    }
+
+    Y_UNIT_TEST(TestMerge) {
+        const ui32 k = 256;
+        const size_t partCount = 7;
+        TVector<float> values;
+
+        TQuantileSketch sketch(k);
+        for (auto partIdx : xrange(partCount)) {
+            const TVector<float> partValues = GenerateValues(50000 * (partIdx + 1), partIdx);
+            TQuantileSketch partSketch(k);
+            for (auto value : partValues) {
+                partSketch.Add(value);
+            }
+            sketch.Merge(partSketch);
+            values.insert(values.end(), partValues.begin(), partValues.end());
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), values.size());
+        UNIT_ASSERT(sketch.GetStoredValuesCount() <= TQuantileSketch::CalcMaxStoredValuesCount(k));
+
+        Sort(values);
+        UNIT_ASSERT(CalcMaxRankError(sketch.GetSortedSample(), values) < 0.02);
+
+        UNIT_ASSERT_EXCEPTION(sketch.Merge(TQuantileSketch(k + 1)), yexception);
+    }
+
+    Y_UNIT_TEST(TestSerialization) {
+        TQuantileSketch sketch(32);
+        for (auto value : GenerateValues(10000, 1)) {
+            sketch.Add(value);
+        }
+
+        TVector<char> buffer;
+        SerializeToMem(&buffer, sketch);
+
+        TQuantileSketch loadedSketch;
+        SerializeFromMem(&buffer, loadedSketch);
+
+        UNIT_ASSERT_VALUES_EQUAL(loadedSketch.GetCount(), sketch.GetCount());
+        UNIT_ASSERT_VALUES_EQUAL(loadedSketch.GetStoredValuesCount(), sketch.GetStoredValuesCount());
+        UNIT_ASSERT_VALUES_EQUAL(loadedSketch.GetSortedSample(), sketch.GetSortedSample());
+
+        // loaded sketch can be updated further
+        loadedSketch.Merge(sketch);
+        UNIT_ASSERT_VALUES_EQUAL(loadedSketch.GetCount(), 2 * sketch.GetCount());
+    }
+}
@@ -0,0 +1,74 @@
+#include <library/threading/local_executor/local_executor.h>
+#include <library/testing/benchmark/bench.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+// Scaling of range execution for both range scheduling modes. Tasks have uneven cost, so that
+// load balancing matters, and are small, so that scheduling overhead matters.
+
+namespace {
+    struct TTaskCosts {
+        static constexpr int RangeSize = 1 << 14;
+        TVector<ui32> Costs;
+        TTaskCosts()
+            : Costs(RangeSize)
+        {
+            TFastRng<ui64> prng{42};
+            for (auto& cost : Costs) {
+                cost = 1 + prng.Uniform(prng.Uniform(8) == 0 ? 2048 : 64);
+            }
+        }
+    };
+
+    template <NPar::TLocalExecutor::ERangeScheduling Scheduling, int ThreadCount, bool PinThreads>
+    struct TExecutorHolder {
+        NPar::TLocalExecutor Executor;
+        TExecutorHolder() {
+            Executor.SetRangeScheduling(Scheduling);
+            Executor.SetThreadPinning(PinThreads);
+            Executor.RunAdditionalThreads(ThreadCount - 1);
+        }
+    };
+
+    template <NPar::TLocalExecutor::ERangeScheduling Scheduling, int ThreadCount, bool PinThreads>
+    void ExecRanges(const NBench::NCpu::TParams& iface) {
+        auto& executor = Default<TExecutorHolder<Scheduling, ThreadCount, PinThreads>>().Executor;
+        const auto& costs = Default<TTaskCosts>().Costs;
+        TVector<ui64> results(costs.size());
+        for (const auto i : xrange(iface.Iterations())) {
+            Y_UNUSED(i);
+            executor.ExecRange([&](int id) {
+                ui64 value = id;
+                for (ui32 step = 0; step < costs[id]; ++step) {
+                    value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+                }
+                results[id] = value;
+            },
+                               0, costs.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+            Y_DO_NOT_OPTIMIZE_AWAY(results.data());
+        }
+    }
+}
+
+#define DEFINE_BENCHMARK(threadCount)                                                                                   \
+    Y_CPU_BENCHMARK(SharedCounter_##threadCount, iface) {                                                               \
+        ExecRanges<NPar::TLocalExecutor::ERangeScheduling::SharedCounter, threadCount, false>(iface);                   \
+    }                                                                                                                   \
+                                                                                                                        \
+    Y_CPU_BENCHMARK(WorkStealing_##threadCount, iface) {                                                                \
+        ExecRanges<NPar::TLocalExecutor::ERangeScheduling::WorkStealing, threadCount, false>(iface);                    \
+    }                                                                                                                   \
+                                                                                                                        \
+    Y_CPU_BENCHMARK(WorkStealingPinned_##threadCount, iface) {                                                          \
+        ExecRanges<NPar::TLocalExecutor::ERangeScheduling::WorkStealing, threadCount, true>(iface);                     \
+    }
+
+DEFINE_BENCHMARK(1)
+DEFINE_BENCHMARK(2)
+DEFINE_BENCHMARK(4)
+DEFINE_BENCHMARK(8)
+DEFINE_BENCHMARK(16)
+DEFINE_BENCHMARK(32)
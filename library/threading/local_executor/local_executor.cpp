@@ -2,7 +2,11 @@
 
 #include <library/threading/future/future.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/utility.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/string/strip.h>
 #include <util/system/atomic.h>
 #include <util/system/event.h>
 #include <util/system/thread.h>
@@ -12,6 +16,10 @@
 
 #include <utility>
 
+#ifdef _linux_
+#include <sched.h>
+#endif
+
 #ifdef _win_
 static void RegularYield() {
 }
@@ -82,11 +90,18 @@ namespace {
         }
     };
 
-    class TLocalRangeExecutor: public NPar::ILocallyExecutable {
-        TIntrusivePtr<NPar::ILocallyExecutable> Exec;
-        TAtomic Counter;
-        TAtomic WorkerCount;
-        int LastId;
+    // location of the current thread in the executor that owns it
+    struct TWorkerLocation {
+        const void* Executor; // owner executor implementation, nullptr if thread is not a worker
+        int Slot;   // 0-based index of worker thread
+        int Socket; // -1 if thread is not pinned
+    };
+
+    Y_POD_STATIC_THREAD(TWorkerLocation)
+    WorkerLocation;
+
+    class TRangeExecutorBase: public NPar::ILocallyExecutable {
+        TAtomic WorkerCount{0};
 
         void LocalExec(int) override {
             AtomicAdd(WorkerCount, 1);
@@ -97,15 +112,29 @@ namespace {
             AtomicAdd(WorkerCount, -1);
         }
 
+    public:
+        virtual bool DoSingleOp() = 0;
+        virtual int GetRangeSize() const = 0;
+
+        void WaitComplete() {
+            while (AtomicGet(WorkerCount) > 0)
+                RegularYield();
+        }
+    };
+
+    class TLocalRangeExecutor: public TRangeExecutorBase {
+        TIntrusivePtr<NPar::ILocallyExecutable> Exec;
+        TAtomic Counter;
+        int LastId;
+
     public:
         TLocalRangeExecutor(TIntrusivePtr<ILocallyExecutable> exec, int firstId, int lastId)
             : Exec(std::move(exec))
             , Counter(firstId)
-            , WorkerCount(0)
             , LastId(lastId)
         {
         }
-        bool DoSingleOp() {
+        bool DoSingleOp() override {
             TAtomic id = AtomicAdd(Counter, 1) - 1;
             if (id >= LastId)
                 return false;
@@ -113,15 +142,140 @@ namespace {
             RegularYield();
             return true;
         }
-        void WaitComplete() {
-            while (AtomicGet(WorkerCount) > 0)
-                RegularYield();
-        }
-        int GetRangeSize() const {
+        int GetRangeSize() const override {
             return Max<int>(LastId - Counter, 0);
         }
     };
 
+    // Range is split into contiguous parts, one per worker thread and one for the calling thread.
+    // Each thread processes its own part first and then steals tasks from other parts, parts of
+    // threads on the same socket are tried first.
+    class TWorkStealingRangeExecutor: public TRangeExecutorBase {
+        struct TPart {
+            TAtomic Counter;
+            int LastId;
+            int Socket;
+            char Padding[64 - sizeof(TAtomic) - 2 * sizeof(int)]; // counters of different parts are on different cache lines
+        };
+
+        TIntrusivePtr<NPar::ILocallyExecutable> Exec;
+        const void* Executor;
+        TVector<TPart> Parts;
+
+        int GetCurrentSlot() const {
+            const int workerPartCount = Parts.ysize() - 1;
+            // workers of other executors (e.g. when ExecRange is called from a task of another executor)
+            // are treated as the calling thread
+            if (WorkerLocation.Executor == Executor && workerPartCount > 0) {
+                return WorkerLocation.Slot % workerPartCount;
+            }
+            return workerPartCount;
+        }
+
+        bool DoPartOp(TPart& part) {
+            if (AtomicGet(part.Counter) >= part.LastId) {
+                return false;
+            }
+            TAtomic id = AtomicAdd(part.Counter, 1) - 1;
+            if (id >= part.LastId)
+                return false;
+            Exec->LocalExec(id);
+            RegularYield();
+            return true;
+        }
+
+    public:
+        // executor: implementation of executor that runs the range
+        // workerSockets: socket for each worker slot, -1 if unknown
+        TWorkStealingRangeExecutor(TIntrusivePtr<ILocallyExecutable> exec, int firstId, int lastId, const void* executor, const TVector<int>& workerSockets)
+            : Exec(std::move(exec))
+            , Executor(executor)
+        {
+            const int partCount = workerSockets.ysize() + 1;
+            const i64 rangeSize = lastId - firstId;
+            Parts.yresize(partCount);
+            for (int partIdx = 0; partIdx < partCount; ++partIdx) {
+                Parts[partIdx].Counter = firstId + rangeSize * partIdx / partCount;
+                Parts[partIdx].LastId = firstId + rangeSize * (partIdx + 1) / partCount;
+                Parts[partIdx].Socket = partIdx < workerSockets.ysize() ? workerSockets[partIdx] : -1;
+            }
+        }
+        bool DoSingleOp() override {
+            const int slot = GetCurrentSlot();
+            if (DoPartOp(Parts[slot])) {
+                return true;
+            }
+            const int socket = Parts[slot].Socket;
+            for (bool sameSocketPass : {true, false}) {
+                for (int i = 1; i < Parts.ysize(); ++i) {
+                    TPart& victim = Parts[(slot + i) % Parts.ysize()];
+                    const bool isSameSocket = socket < 0 || victim.Socket < 0 || victim.Socket == socket;
+                    if (isSameSocket == sameSocketPass && DoPartOp(victim)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+        int GetRangeSize() const override {
+            int rangeSize = 0;
+            for (const auto& part : Parts) {
+                rangeSize += Max<int>(part.LastId - AtomicGet(part.Counter), 0);
+            }
+            return rangeSize;
+        }
+    };
+
+    // cpus available to the process, ordered by socket
+    struct TCpuTopology {
+        TVector<int> Cpus;
+        TVector<int> Sockets; // [cpu index in Cpus]
+    };
+
+    TCpuTopology GetCpuTopology() {
+        TCpuTopology topology;
+#ifdef _linux_
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+            return topology;
+        }
+        TVector<std::pair<int, int>> socketAndCpu;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (!CPU_ISSET(cpu, &cpuSet)) {
+                continue;
+            }
+            int socket = 0;
+            try {
+                TFileInput input("/sys/devices/system/cpu/cpu" + ToString(cpu) + "/topology/physical_package_id");
+                TryFromString<int>(StripString(input.ReadAll()), socket);
+            } catch (...) {
+                // no topology information, assume single socket
+            }
+            socketAndCpu.emplace_back(socket, cpu);
+        }
+        StableSort(socketAndCpu.begin(), socketAndCpu.end());
+        for (const auto& [socket, cpu] : socketAndCpu) {
+            topology.Cpus.push_back(cpu);
+            topology.Sockets.push_back(socket);
+        }
+#endif
+        return topology;
+    }
+
+    // returns false if pinning is not supported
+    bool PinCurrentThread(int cpu) {
+#ifdef _linux_
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+        Y_UNUSED(cpu);
+        return false;
+#endif
+    }
+
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -138,6 +292,10 @@ public:
     TAtomic LPQueueSize{0};
     TAtomic ThreadId{0};
 
+    NPar::TLocalExecutor::ERangeScheduling RangeScheduling = NPar::TLocalExecutor::ERangeScheduling::SharedCounter;
+    bool PinThreads = false;
+    TCpuTopology CpuTopology; // inited if PinThreads
+
     Y_THREAD(int)
     CurrentTaskPriority;
     Y_THREAD(int)
@@ -146,7 +304,8 @@ public:
     static void* HostWorkerThread(void* p);
     bool GetJob(TSingleJob* job);
     void RunNewThread();
-    void LaunchRange(TIntrusivePtr<TLocalRangeExecutor> execRange, int queueSizeLimit,
+    TVector<int> GetWorkerSockets() const;
+    void LaunchRange(TIntrusivePtr<TRangeExecutorBase> execRange, int queueSizeLimit,
                      TAtomic* queueSize, TLockFreeQueue<TSingleJob>* jobQueue);
 
     TImpl() = default;
@@ -168,6 +327,15 @@ void* NPar::TLocalExecutor::TImpl::HostWorkerThread(void* p) {
     auto* const ctx = (TImpl*)p;
     TThread::CurrentThreadSetName("ParLocalExecutor");
     ctx->WorkerThreadId = AtomicAdd(ctx->ThreadId, 1);
+    WorkerLocation.Executor = ctx;
+    WorkerLocation.Slot = ctx->WorkerThreadId - 1;
+    WorkerLocation.Socket = -1;
+    if (ctx->PinThreads && !ctx->CpuTopology.Cpus.empty()) {
+        const int cpuIdx = WorkerLocation.Slot % ctx->CpuTopology.Cpus.ysize();
+        if (PinCurrentThread(ctx->CpuTopology.Cpus[cpuIdx])) {
+            WorkerLocation.Socket = ctx->CpuTopology.Sockets[cpuIdx];
+        }
+    }
     for (bool cont = true; cont;) {
         TSingleJob job;
         bool gotJob = false;
@@ -222,7 +390,17 @@ void NPar::TLocalExecutor::TImpl::RunNewThread() {
     thr.Detach();
 }
 
-void NPar::TLocalExecutor::TImpl::LaunchRange(TIntrusivePtr<TLocalRangeExecutor> rangeExec,
+TVector<int> NPar::TLocalExecutor::TImpl::GetWorkerSockets() const {
+    TVector<int> workerSockets(AtomicGet(ThreadCount), -1);
+    if (PinThreads && !CpuTopology.Cpus.empty()) {
+        for (int slot = 0; slot < workerSockets.ysize(); ++slot) {
+            workerSockets[slot] = CpuTopology.Sockets[slot % CpuTopology.Sockets.ysize()];
+        }
+    }
+    return workerSockets;
+}
+
+void NPar::TLocalExecutor::TImpl::LaunchRange(TIntrusivePtr<TRangeExecutorBase> rangeExec,
                                               int queueSizeLimit,
                                               TAtomic* queueSize,
                                               TLockFreeQueue<TSingleJob>* jobQueue) {
@@ -248,6 +426,22 @@ void NPar::TLocalExecutor::RunAdditionalThreads(int threadCount) {
         Impl_->RunNewThread();
 }
 
+void NPar::TLocalExecutor::SetRangeScheduling(ERangeScheduling rangeScheduling) {
+    Impl_->RangeScheduling = rangeScheduling;
+}
+
+NPar::TLocalExecutor::ERangeScheduling NPar::TLocalExecutor::GetRangeScheduling() const noexcept {
+    return Impl_->RangeScheduling;
+}
+
+void NPar::TLocalExecutor::SetThreadPinning(bool pinThreads) {
+    Y_VERIFY(AtomicGet(Impl_->ThreadCount) == 0, "SetThreadPinning() must be called before RunAdditionalThreads()");
+    Impl_->PinThreads = pinThreads;
+    if (pinThreads) {
+        Impl_->CpuTopology = GetCpuTopology();
+    }
+}
+
 void NPar::TLocalExecutor::Exec(TIntrusivePtr<ILocallyExecutable> exec, int id, int flags) {
     Y_ASSERT((flags & WAIT_COMPLETE) == 0); // unsupported
     int prior = Max<int>(Impl_->CurrentTaskPriority, flags & PRIORITY_MASK);
@@ -284,7 +478,12 @@ void NPar::TLocalExecutor::ExecRange(TIntrusivePtr<ILocallyExecutable> exec, int
         exec->LocalExec(firstId);
         return;
     }
-    auto rangeExec = MakeIntrusive<TLocalRangeExecutor>(std::move(exec), firstId, lastId);
+    TIntrusivePtr<TRangeExecutorBase> rangeExec;
+    if (Impl_->RangeScheduling == ERangeScheduling::WorkStealing) {
+        rangeExec = MakeIntrusive<TWorkStealingRangeExecutor>(std::move(exec), firstId, lastId, Impl_.Get(), Impl_->GetWorkerSockets());
+    } else {
+        rangeExec = MakeIntrusive<TLocalRangeExecutor>(std::move(exec), firstId, lastId);
+    }
     int queueSizeLimit = (flags & WAIT_COMPLETE) ? 10000 : -1;
     int prior = Max<int>(Impl_->CurrentTaskPriority, flags & PRIORITY_MASK);
     switch (prior) {
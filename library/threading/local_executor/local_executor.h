@@ -133,6 +133,26 @@ namespace NPar {
         // @param threadCount       Number of threads to add.
         void RunAdditionalThreads(int threadCount);
 
+        // Scheduling of tasks from ranges.
+        //
+        // `SharedCounter`  All threads take tasks from a single shared counter (default).
+        // `WorkStealing`   Range is split into contiguous parts, one per thread. Each thread executes
+        //                  tasks from its own part and then steals tasks from other parts, parts of
+        //                  threads pinned to the same socket are tried first.
+        enum class ERangeScheduling {
+            SharedCounter,
+            WorkStealing
+        };
+
+        void SetRangeScheduling(ERangeScheduling rangeScheduling);
+        ERangeScheduling GetRangeScheduling() const noexcept;
+
+        // Pin threads to available cpus one by one, socket by socket, so that adjacent range parts
+        // in `WorkStealing` mode are executed on the same socket. Linux only, does nothing elsewhere.
+        // Must be called before `RunAdditionalThreads`.
+        //
+        void SetThreadPinning(bool pinThreads);
+
         // Add task for further execution.
         //
         // @param exec          Task description.
@@ -4,6 +4,7 @@
 #include <library/unittest/registar.h>
 #include <util/system/mutex.h>
 #include <util/system/rwlock.h>
+#include <util/system/yield.h>
 #include <util/generic/algorithm.h>
 
 using namespace NPar;
@@ -324,3 +325,87 @@ Y_UNIT_TEST(NestedParallelExceptionsDoNotLeak) {
 }
 }
 ;
+
+Y_UNIT_TEST_SUITE(ExecRangeWorkStealing) {
+    void ExecRangeAndCheckEachIdOnce(int rangeSize, int threads, bool pinThreads, int flags) {
+        TLocalExecutor localExecutor;
+        localExecutor.SetRangeScheduling(TLocalExecutor::ERangeScheduling::WorkStealing);
+        localExecutor.SetThreadPinning(pinThreads);
+        localExecutor.RunAdditionalThreads(threads);
+        UNIT_ASSERT(localExecutor.GetRangeScheduling() == TLocalExecutor::ERangeScheduling::WorkStealing);
+
+        TVector<TAtomic> counts(rangeSize, 0);
+        TAtomic processed = 0;
+        localExecutor.ExecRange([&counts, &processed](int i) {
+            AtomicAdd(counts[i], 1);
+            AtomicAdd(processed, 1);
+        },
+                                0, rangeSize, flags);
+        while (AtomicGet(processed) < rangeSize) {
+            SchedYield();
+        }
+        for (int i = 0; i < rangeSize; ++i) {
+            UNIT_ASSERT_VALUES_EQUAL(AtomicGet(counts[i]), 1);
+        }
+    }
+
+    Y_UNIT_TEST(EachIdOnceSequential) {
+        ExecRangeAndCheckEachIdOnce(DefaultRangeSize, 0, false, TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    Y_UNIT_TEST(EachIdOnceWaitComplete) {
+        ExecRangeAndCheckEachIdOnce(DefaultRangeSize, DefaultThreadsCount, false, TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    Y_UNIT_TEST(EachIdOnceAsync) {
+        ExecRangeAndCheckEachIdOnce(DefaultRangeSize, DefaultThreadsCount, false, TLocalExecutor::MED_PRIORITY);
+    }
+
+    Y_UNIT_TEST(EachIdOnceSmallRange) {
+        ExecRangeAndCheckEachIdOnce(3, DefaultThreadsCount, false, TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    Y_UNIT_TEST(EachIdOncePinnedThreads) {
+        ExecRangeAndCheckEachIdOnce(DefaultRangeSize, 4, true, TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    Y_UNIT_TEST(NestedRanges) {
+        const int outerSize = 16;
+        const int innerSize = 100;
+        TLocalExecutor localExecutor;
+        localExecutor.SetRangeScheduling(TLocalExecutor::ERangeScheduling::WorkStealing);
+        localExecutor.RunAdditionalThreads(7);
+        TVector<TAtomic> counts(outerSize * innerSize, 0);
+        localExecutor.ExecRange([&](int outerId) {
+            localExecutor.ExecRange([&](int innerId) {
+                AtomicAdd(counts[outerId * innerSize + innerId], 1);
+            },
+                                    0, innerSize, TLocalExecutor::WAIT_COMPLETE);
+        },
+                                0, outerSize, TLocalExecutor::WAIT_COMPLETE);
+        for (const auto& count : counts) {
+            UNIT_ASSERT_VALUES_EQUAL(AtomicGet(count), 1);
+        }
+    }
+
+    Y_UNIT_TEST(RangesFromWorkersOfAnotherExecutor) {
+        const int outerSize = 16;
+        const int innerSize = 100;
+        TLocalExecutor outerExecutor;
+        outerExecutor.RunAdditionalThreads(7);
+        TLocalExecutor innerExecutor;
+        innerExecutor.SetRangeScheduling(TLocalExecutor::ERangeScheduling::WorkStealing);
+        innerExecutor.RunAdditionalThreads(1);
+        TVector<TAtomic> counts(outerSize * innerSize, 0);
+        outerExecutor.ExecRange([&](int outerId) {
+            innerExecutor.ExecRange([&](int innerId) {
+                AtomicAdd(counts[outerId * innerSize + innerId], 1);
+            },
+                                    0, innerSize, TLocalExecutor::WAIT_COMPLETE);
+        },
+                                0, outerSize, TLocalExecutor::WAIT_COMPLETE);
+        for (const auto& count : counts) {
+            UNIT_ASSERT_VALUES_EQUAL(AtomicGet(count), 1);
+        }
+    }
+}